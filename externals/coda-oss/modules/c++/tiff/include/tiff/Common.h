@@ -82,6 +82,10 @@ public:
             SRATIONAL,
             FLOAT,
             DOUBLE,
+            IFD,
+            LONG8 = 16,
+            SLONG8,
+            IFD8,
             MAX
         };
     };
@@ -159,7 +163,7 @@ public:
      *****************************************************************/
     static short sizeOf(unsigned short type)
     {
-        return mTypeSizes[type];
+        return type < Type::MAX ? mTypeSizes[type] : 0;
     }
 
 private:
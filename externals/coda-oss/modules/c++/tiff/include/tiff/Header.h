@@ -39,21 +39,24 @@ class Header : public io::Serializable
 public:
     enum ByteOrder { MM, II };
 
+    //! The TIFF identifiers
+    enum { TIFF_ID = 42, BIG_TIFF_ID = 43 };
+
     /**
      *****************************************************************
      * Constructor.  Allows the user to set the values in the header
      * and also provides resonable defaults.
      *
      * @param id
-     *   the TIFF identifier, always "42"
+     *   the TIFF identifier, "42" for TIFF or "43" for BigTIFF
      * @param byteOrder
      *   the byte order of the file "MM" for Big Endian, "II" 
      *   for Little Endian
      * @param ifdOffset
      *   the offset to the first IFD
      *****************************************************************/
-    Header(const unsigned short id = 42, const char byteOrder[2] = "  ",
-            const sys::Uint32_T ifdOffset = 8) :
+    Header(const unsigned short id = TIFF_ID, const char byteOrder[2] = "  ",
+            const sys::Uint64_T ifdOffset = 8) :
         mId(id), mIFDOffset(ifdOffset)
     {
         const bool isBigEndian = sys::isBigEndianSystem();
@@ -124,11 +127,35 @@ public:
      * @return
      *   the IFD offset
      *****************************************************************/
-    sys::Uint32_T getIFDOffset() const
+    sys::Uint64_T getIFDOffset() const
     {
         return mIFDOffset;
     }
 
+    /**
+     *****************************************************************
+     * Whether this is a BigTIFF header, whose offsets and value
+     * counts are 8 bytes rather than 4.
+     * @return
+     *   true for BigTIFF
+     *****************************************************************/
+    bool isBigTIFF() const
+    {
+        return mId == BIG_TIFF_ID;
+    }
+
+    /**
+     *****************************************************************
+     * Returns the size of a file offset, 8 bytes for BigTIFF and 4
+     * otherwise.
+     * @return
+     *   the size of a file offset
+     *****************************************************************/
+    unsigned short getOffsetSize() const
+    {
+        return isBigTIFF() ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T);
+    }
+
     ByteOrder getByteOrder() const
     {
         if (mByteOrder[0] == 'M' && mByteOrder[1] == 'M')
@@ -151,7 +178,7 @@ private:
     unsigned short mId;
 
     //! The IFD offset
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
     
     bool mDifferentByteOrdering;
     
@@ -197,6 +197,17 @@ public:
      *****************************************************************/
     void serialize(io::OutputStream& output);
 
+    /**
+     *****************************************************************
+     * Writes the complete IFD to the specified output stream, with
+     * 8 byte counts and offsets for BigTIFF.
+     * @param output
+     *   the output stream to write the IFD to
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
+     *****************************************************************/
+    void serialize(io::OutputStream& output, const bool bigTIFF);
+
     /**
      *****************************************************************
      * Reads the complete IFD from the specified input stream.
@@ -206,6 +217,8 @@ public:
      *****************************************************************/
     void deserialize(io::InputStream& input);
     void deserialize(io::InputStream& input, const bool reverseBytes);
+    void deserialize(io::InputStream& input, const bool reverseBytes,
+                     const bool bigTIFF);
 
     /**
      *****************************************************************
@@ -237,7 +250,7 @@ public:
      * @return 
      *   the calculated image size in bytes
      *****************************************************************/
-    sys::Uint32_T getImageSize() const;
+    sys::Uint64_T getImageSize() const;
 
     /**
      *****************************************************************
@@ -280,7 +293,7 @@ public:
      * @return
      *   the offset to write the next IFD offset to
      *****************************************************************/
-    sys::Uint32_T getNextIFDOffsetPosition()
+    sys::Uint64_T getNextIFDOffsetPosition()
     {
         return mNextIFDOffsetPosition;
     }
@@ -296,11 +309,13 @@ private:
      * @param offset
      *   the file offset that indicates the beginning position of 
      *   the IFD.
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
      * @return
      *   the highest overflow offset calculated, this marks the
      *   potential beginning of the next image.
      *****************************************************************/
-    sys::Uint32_T finalize(const sys::Uint32_T offset);
+    sys::Uint64_T finalize(const sys::Uint64_T offset, const bool bigTIFF);
 
     //! The IFD entries
     IFDType mIFD;
@@ -310,7 +325,7 @@ private:
     }
 
     //! Offset where the next IFD offset can be written to
-    sys::Uint32_T mNextIFDOffsetPosition = 0;
+    sys::Uint64_T mNextIFDOffsetPosition = 0;
 };
 
 } // End namespace.
@@ -124,6 +124,17 @@ public:
      *****************************************************************/
     void serialize(io::OutputStream& output);
 
+    /**
+     *****************************************************************
+     * Writes the IFD entry to the specified output stream, with the
+     * count and value offset 8 bytes long for BigTIFF.
+     * @param output
+     *   the output stream to write the entry to
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
+     *****************************************************************/
+    void serialize(io::OutputStream& output, const bool bigTIFF);
+
     /**
      *****************************************************************
      * Reads the IFD entry from the specified input stream.
@@ -133,6 +144,8 @@ public:
      *****************************************************************/
     void deserialize(io::InputStream& input);
     void deserialize(io::InputStream& input, const bool reverseBytes);
+    void deserialize(io::InputStream& input, const bool reverseBytes,
+                     const bool bigTIFF);
 
     /**
      *****************************************************************
@@ -199,7 +212,7 @@ public:
      * @return
      *  the value offset
      *****************************************************************/
-    sys::Uint32_T getOffset() const
+    sys::Uint64_T getOffset() const
     {
         return mOffset;
     }
@@ -228,6 +241,19 @@ public:
         return mValues;
     }
 
+    /**
+     *****************************************************************
+     * Returns the value at the specified index as an unsigned
+     * integer.  Handles BYTE, SHORT, LONG, IFD, LONG8 and IFD8
+     * entries, so offsets and sizes can be read whichever type the
+     * file used for them.
+     * @param index
+     *   the index that indicates which value to retrieve
+     * @return
+     *   the value at the specified index
+     *****************************************************************/
+    sys::Uint64_T getUnsignedValue(const sys::Uint32_T index) const;
+
     /**
      *****************************************************************
      * Returns the vector of values that are in the IFD entry.
@@ -347,6 +373,20 @@ public:
      *****************************************************************/
     sys::Uint32_T finalize(const sys::Uint32_T offset);
 
+    /**
+     *****************************************************************
+     * Same as above, with values of up to 8 bytes kept in the IFD
+     * entry and 64-bit offsets for BigTIFF.
+     * @param offset
+     *   the next free file offset that the values will can be
+     *   written to
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
+     * @return
+     *   the next free file offset
+     *****************************************************************/
+    sys::Uint64_T finalize(const sys::Uint64_T offset, const bool bigTIFF);
+
     /**
      *****************************************************************
      * According to the TIFF 6.0 spec, the size of an IFD entry is 12
@@ -363,6 +403,34 @@ public:
         return 12;
     }
 
+    /**
+     *****************************************************************
+     * Returns the size of the IFD entry, 20 bytes for BigTIFF, where
+     * the count and value offset are 8 bytes each, and 12 otherwise.
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
+     * @return
+     *   the size of an IFD entry
+     *****************************************************************/
+    static unsigned short sizeOf(const bool bigTIFF)
+    {
+        return bigTIFF ? 20 : sizeOf();
+    }
+
+    /**
+     *****************************************************************
+     * Returns the size of the value field of an IFD entry.  Values
+     * that fit are stored in it, and otherwise it holds their offset.
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
+     * @return
+     *   8 bytes for BigTIFF, 4 otherwise
+     *****************************************************************/
+    static unsigned short valueFieldSize(const bool bigTIFF)
+    {
+        return bigTIFF ? 8 : 4;
+    }
+
 private:
 
     /**
@@ -387,7 +455,7 @@ private:
     sys::Uint32_T mCount;
 
     //! The file offset to values for the IFD entry
-    sys::Uint32_T mOffset;
+    sys::Uint64_T mOffset;
 
     //! The name of the IFD entry (i.e. "ImageWidth")
     std::string mName;
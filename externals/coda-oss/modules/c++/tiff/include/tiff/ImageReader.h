@@ -23,6 +23,7 @@
 #ifndef __TIFF_IMAGE_READER_H__
 #define __TIFF_IMAGE_READER_H__
 
+#include <vector>
 #include <import/io.h>
 
 #include "tiff/IFDEntry.h"
@@ -51,9 +52,7 @@ public:
      *   the stream to read the TIFF image from
      *****************************************************************/
     ImageReader(io::FileInputStream *input) :
-        mIFD(), mStripByteCounts(nullptr), mStripOffsets(nullptr), mInput(input),
-                mNextOffset(0), mBytePosition(0), mStripIndex(0),
-                mElementSize(0), mReverseBytes(false)
+        mIFD(), mInput(input)
     {
     }
 
@@ -65,9 +64,14 @@ public:
     /**
      *****************************************************************
      * Processes the image from the file.  Reads the image's IFD
-     * and stores it for later use.
+     * and stores it for later use, and indexes the file offsets of
+     * its strips or tiles so any region can be read directly.
+     * @param reverseBytes
+     *   whether the file's byte order differs from the system's
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
      *****************************************************************/
-    void process(const bool reverseBytes = false);
+    void process(const bool reverseBytes = false, const bool bigTIFF = false);
 
     /**
      *****************************************************************
@@ -91,6 +95,46 @@ public:
      *****************************************************************/
     void getData(unsigned char *buffer, const sys::Uint32_T numElementsToRead);
 
+    /**
+     *****************************************************************
+     * Reads a region of the image into the specified buffer, in
+     * raster format.  Only the strips or tiles that overlap the
+     * region are read, each with one read.  The position used by
+     * getData() is not changed.
+     * @param buffer
+     *   the buffer to populate with numRows * numCols elements
+     * @param startRow
+     *   the first row of the region
+     * @param numRows
+     *   the number of rows in the region
+     * @param startCol
+     *   the first column of the region
+     * @param numCols
+     *   the number of columns in the region
+     *****************************************************************/
+    void getRegion(unsigned char *buffer,
+                   sys::Uint32_T startRow, sys::Uint32_T numRows,
+                   sys::Uint32_T startCol, sys::Uint32_T numCols);
+
+    /**
+     *****************************************************************
+     * Returns whether the image is tiled rather than stripped.
+     * @return
+     *   true if the image is tiled
+     *****************************************************************/
+    bool isTiled() const
+    {
+        return mTiled;
+    }
+
+    /**
+     *****************************************************************
+     * Returns whether the image is a reduced resolution version of
+     * another image in the file, such as an overview.
+     * @return
+     *   true if bit 0 of NewSubfileType is set
+     *****************************************************************/
+    bool isReducedResolution() const;
     /**
      *****************************************************************
      * Returns a pointer to the IFD for this image.
@@ -122,7 +166,7 @@ public:
      * @return
      *   the next IFD offset
      *****************************************************************/
-    sys::Uint32_T getNextOffset() const
+    sys::Uint64_T getNextOffset() const
     {
         return mNextOffset;
     }
@@ -131,53 +175,55 @@ private:
 
     /**
      *****************************************************************
-     * Reads the specified number of elements into the specified 
-     * buffer, in TIFF stripped format.  Converts the TIFF image from
-     * the TIFF stripped format into raster format.
-     * @param buffer
-     *   the buffer to populate with image data
-     * @param numElementsToRead
-     *   the number of elements (not bytes) to read from the image
-     *****************************************************************/
-    void getStripData(unsigned char *buffer, sys::Uint32_T numElementsToRead);
-
-    /**
-     *****************************************************************
-     * Reads the specified number of elements into the specified 
-     * buffer, in TIFF tiled format.  Converts the TIFF image from
-     * the TIFF tiled format into raster format.
+     * Reads the rows of one strip or tile that overlap a region.
      * @param buffer
-     *   the buffer to populate with image data
-     * @param numElementsToRead
-     *   the number of elements (not bytes) to read from the image
+     *   the region's buffer
+     * @param chunkIndex
+     *   the index of the strip or tile
+     * @param chunkRow
+     *   the image row of the chunk's first row
+     * @param chunkCol
+     *   the image column of the chunk's first column
+     * @param startRow, numRows, startCol, numCols
+     *   the region
      *****************************************************************/
-    void getTileData(unsigned char *buffer, sys::Uint32_T numElementsToRead);
+    void readChunk(unsigned char *buffer, size_t chunkIndex,
+                   sys::Uint64_T chunkRow, sys::Uint64_T chunkCol,
+                   sys::Uint64_T startRow, sys::Uint64_T numRows,
+                   sys::Uint64_T startCol, sys::Uint64_T numCols);
 
     //! Contains the IFD for this image.
     tiff::IFD mIFD;
 
-    //! A pointer to the "StripByteCounts" IFDEntry to make reading faster.
-    tiff::IFDEntry *mStripByteCounts;
-
-    //! A pointer to the "StripOffsets" IFDEntry to make reading faster.
-    tiff::IFDEntry *mStripOffsets;
-
     //! Points to the input file stream.
     io::FileInputStream *mInput;
 
     //! The offset to the next IFD.
-    sys::Uint32_T mNextOffset;
+    sys::Uint64_T mNextOffset = 0;
+
+    //! Used to keep track of the current read position in the image.
+    sys::Uint64_T mBytePosition = 0;
+
+    //! The file offset of each strip or tile
+    std::vector<sys::Uint64_T> mChunkOffsets;
+
+    //! The size in bytes of each strip or tile
+    std::vector<sys::Uint64_T> mChunkByteCounts;
+
+    //! The width of a tile, or of the image if it is stripped
+    sys::Uint32_T mChunkWidth = 0;
+
+    //! The length of a tile, or the number of rows in each strip
+    sys::Uint32_T mChunkLength = 0;
 
-    //! Used to keep track of the current read position in the file.
-    sys::Uint32_T mBytePosition;
-    
-    sys::Uint32_T mStripIndex;
+    //! Whether the image is tiled
+    bool mTiled = false;
 
     //! The element size of the image.
-    unsigned short mElementSize;
+    unsigned short mElementSize = 0;
 
     //! Whether to reverse bytes when reading.
-    bool mReverseBytes;
+    bool mReverseBytes = false;
 };
 
 } // End namespace.
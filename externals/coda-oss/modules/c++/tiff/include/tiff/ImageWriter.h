@@ -23,6 +23,7 @@
 #ifndef __TIFF_IMAGE_WRITER_H__
 #define __TIFF_IMAGE_WRITER_H__
 
+#include <vector>
 #include <import/io.h>
 
 #include "tiff/Common.h"
@@ -60,9 +61,17 @@ public:
      *   the output stream to write the image to
      * @param ifdOffset
      *   the offset to the beginning of the IFD for this image
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
+     * @param previous
+     *   the image before this one in the file, whose IFD links to
+     *   this one's, or NULL for the first image
      *****************************************************************/
-    ImageWriter(io::FileOutputStream *output, const sys::Uint32_T ifdOffset) :
-                mOutput(output), mIFDOffset(ifdOffset)
+    ImageWriter(io::FileOutputStream *output, const sys::Uint64_T ifdOffset,
+                const bool bigTIFF = false,
+                const ImageWriter* previous = nullptr) :
+                mOutput(output), mIFDOffset(ifdOffset), mBigTIFF(bigTIFF),
+                mPrevious(previous)
     {
     }
 
@@ -94,9 +103,35 @@ public:
         return &mIFD;
     }
 
-    //! Writes this image's IFD to the output stream.
+    /**
+     *****************************************************************
+     * Writes this image's IFD to the end of the output stream, and
+     * links it from the IFD of the image before it, which must have
+     * been written already.
+     *****************************************************************/
     void writeIFD();
 
+    /**
+     *****************************************************************
+     * Lays the image data out from the specified offset, rather than
+     * from wherever the stream is when the image is validated.  With
+     * getDataEnd(), this lets the data of several images be written
+     * side by side, as long as their IFDs are written, in order, once
+     * all of the data is in.  Must be called before validate().
+     * @param offset
+     *   the file offset of the first strip or tile
+     *****************************************************************/
+    void setDataOffset(const sys::Uint64_T offset);
+
+    /**
+     *****************************************************************
+     * Validates the image if it hasn't been, and returns the file
+     * offset just past its last strip or tile.
+     * @return
+     *   the end of the image data
+     *****************************************************************/
+    sys::Uint64_T getDataEnd();
+
     /**
      *****************************************************************
      * Returns the position to write the next IFD offset to.  When 
@@ -110,7 +145,7 @@ public:
      * @return
      *   the position to write the next IFD offset to
      *****************************************************************/
-    sys::Uint32_T getNextIFDOffset() const
+    sys::Uint64_T getNextIFDOffset() const
     {
         return mIFDOffset;
     }
@@ -144,6 +179,24 @@ public:
         mFormat = format;
     }
 
+    /**
+     *****************************************************************
+     * Tiles the image with tiles of the specified size, rather than
+     * sizing them from the ideal chunk size.  TIFF requires both
+     * dimensions to be multiples of 16.
+     * @param tileWidth
+     *   the width of a tile in elements
+     * @param tileLength
+     *   the length of a tile in lines
+     *****************************************************************/
+    void setTileSize(const sys::Uint32_T tileWidth,
+                     const sys::Uint32_T tileLength)
+    {
+        mFormat = TILED;
+        mTileWidth = tileWidth;
+        mTileLength = tileLength;
+    }
+
     /**
      *****************************************************************
      * Retrieves the current image format for the image.
@@ -182,10 +235,30 @@ private:
      *****************************************************************/
     void initTiles();
 
+    /**
+     *****************************************************************
+     * Adds an empty offset or byte count entry, LONG8 for BigTIFF
+     * and LONG otherwise.
+     * @param name
+     *   the name of the entry
+     * @return
+     *   the entry
+     *****************************************************************/
+    tiff::IFDEntry* addOffsetEntry(const std::string& name);
+
+    /**
+     *****************************************************************
+     * Adds an offset or byte count to an entry from addOffsetEntry().
+     * @param entry
+     *   the entry
+     * @param value
+     *   the offset or byte count
+     *****************************************************************/
+    void addOffsetValue(tiff::IFDEntry* entry, sys::Uint64_T value);
+
     /**
      *****************************************************************
      * Writes data to a file in stripped format.
-     *
      * @param buffer
      *   the buffer to write to the file
      * @param numElementsToWrite
@@ -196,8 +269,8 @@ private:
 
     /**
      *****************************************************************
-     * Writes data to a file in tiled format.
-     *
+     * Writes data to a file in tiled format.  Lines are buffered
+     * until a whole row of tiles can be written, one tile at a time.
      * @param buffer
      *   the buffer to write to the file
      * @param numElementsToWrite
@@ -206,35 +279,55 @@ private:
     void putTileData(const unsigned char *buffer,
                      sys::Uint32_T numElementsToWrite);
 
+    /**
+     *****************************************************************
+     * Writes the buffered row of tiles, padding the tiles past the
+     * right and bottom edges of the image with zeros.
+     * @param tileRow
+     *   the index of the row of tiles
+     * @param numLines
+     *   the number of buffered image lines
+     *****************************************************************/
+    void writeTileRow(sys::Uint64_T tileRow, sys::Uint64_T numLines);
+
     //! The TIFF IFD for this image
     tiff::IFD mIFD;
 
-    //! A pointer to the StripByteCounts entry, prevents frequent IFD access
-    tiff::IFDEntry* mStripByteCounts = nullptr;
-
-    //! A pointer to the TileOffsets entry, prevents frequent IFD access
-    tiff::IFDEntry *mTileOffsets = nullptr;
+    //! A pointer to the output stream
+    io::FileOutputStream *mOutput = nullptr;
 
-    //! A pointer to the TileWidth entry, prevents frequent IFD access
-    tiff::IFDEntry *mTileWidth = nullptr;
+    //! The position to write the next IFD to
+    sys::Uint64_T mIFDOffset;
 
-    //! A pointer to the TileLength entry, prevents frequent IFD access
-    tiff::IFDEntry *mTileLength = nullptr;
+    //! Whether the file is a BigTIFF
+    bool mBigTIFF = false;
 
-    //! A pointer to the TileByteCounts entry, prevents frequent IFD access
-    tiff::IFDEntry *mTileByteCounts = nullptr;
+    //! The image before this one in the file, if any
+    const ImageWriter* mPrevious = nullptr;
 
-    //! A pointer to the output stream
-    io::FileOutputStream *mOutput = nullptr;
+    //! Whether writeIFD() has been called
+    bool mIFDWritten = false;
 
-    //! The position to write the next IFD to
-    sys::Uint32_T mIFDOffset;
+    //! The offset of the first strip or tile, and just past the last
+    sys::Uint64_T mDataOffset = 0;
+    sys::Uint64_T mDataEnd = 0;
+    bool mDataOffsetSet = false;
 
     //! The ideal size of a tile
     sys::Uint32_T mIdealChunkSize = CHUNK_SIZE;
 
+    //! The size of a tile, computed from the ideal size if not set
+    sys::Uint32_T mTileWidth = 0;
+    sys::Uint32_T mTileLength = 0;
+
+    //! The file offset of each tile
+    std::vector<sys::Uint64_T> mTileOffsets;
+
+    //! The lines of the current row of tiles
+    std::vector<sys::byte> mTileRowBuffer;
+
     //! Used to determine the position in the image
-    sys::Uint32_T mBytePosition = 0;
+    sys::Uint64_T mBytePosition = 0;
 
     //! The image's element size.  Stored here to prevent frequent IFD access
     unsigned short mElementSize = 0;
@@ -126,6 +126,17 @@ struct FileReader
         return static_cast <sys::Uint32_T>(mImages.size());
     }
 
+    /**
+     *****************************************************************
+     * Returns whether the file is a BigTIFF.
+     * @return
+     *   true if the file is a BigTIFF
+     *****************************************************************/
+    bool isBigTIFF() const
+    {
+        return mHeader.isBigTIFF();
+    }
+
     
 private:
 
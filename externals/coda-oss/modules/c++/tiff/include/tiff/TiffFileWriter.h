@@ -111,15 +111,18 @@ struct FileWriter
      *****************************************************************
      * Writes the TIFF header to the file.  There is only one header
      * in a TIFF file regardless of how many images are in it.
+     * @param bigTIFF
+     *   whether to write a BigTIFF, with 64-bit offsets so the file
+     *   can be larger than 4 GB
      *****************************************************************/
-    void writeHeader();
+    void writeHeader(bool bigTIFF = false);
 
     FileWriter(const FileWriter&) = delete;
     FileWriter& operator=(const FileWriter&) = delete;
 
 private:
     //! The position to write the offset to the first IFD to
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
 
     //! The output stream
     io::FileOutputStream mOutput;
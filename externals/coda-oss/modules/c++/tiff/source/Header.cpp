@@ -23,28 +23,66 @@
 #include "tiff/Header.h"
 #include <sstream>
 #include <import/io.h>
+#include <import/except.h>
 
 // INCOMPLETE
 void tiff::Header::serialize(io::OutputStream& output)
 {
     output.write((sys::byte *)&mByteOrder, sizeof(mByteOrder));
     output.write((sys::byte *)&mId, sizeof(mId));
-    output.write((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
+
+    if (isBigTIFF())
+    {
+        // BigTIFF adds the size of an offset and a reserved zero before
+        // an 8 byte IFD offset.
+        const unsigned short offsetSize = sizeof(mIFDOffset);
+        const unsigned short reserved = 0;
+        output.write((sys::byte *)&offsetSize, sizeof(offsetSize));
+        output.write((sys::byte *)&reserved, sizeof(reserved));
+        output.write((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
+    }
+    else
+    {
+        const auto ifdOffset = static_cast<sys::Uint32_T>(mIFDOffset);
+        output.write((sys::byte *)&ifdOffset, sizeof(ifdOffset));
+    }
 }
 
 void tiff::Header::deserialize(io::InputStream& input)
 {
     input.read((sys::byte *)&mByteOrder, sizeof(mByteOrder));
     input.read((sys::byte *)&mId, sizeof(mId));
-    input.read((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
     
     mDifferentByteOrdering = sys::isBigEndianSystem() ? \
             getByteOrder() != tiff::Header::MM : getByteOrder() != tiff::Header::II;
     
     if (mDifferentByteOrdering)
-    {
         mId = sys::byteSwap(mId);
-        mIFDOffset = sys::byteSwap(mIFDOffset);
+
+    if (isBigTIFF())
+    {
+        unsigned short offsetSize;
+        unsigned short reserved;
+        input.read((sys::byte *)&offsetSize, sizeof(offsetSize));
+        input.read((sys::byte *)&reserved, sizeof(reserved));
+        input.read((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
+        if (mDifferentByteOrdering)
+        {
+            offsetSize = sys::byteSwap(offsetSize);
+            mIFDOffset = sys::byteSwap(mIFDOffset);
+        }
+
+        if (offsetSize != sizeof(mIFDOffset))
+            throw except::Exception(Ctxt(FmtX(
+                    "Unsupported BigTIFF offset size: %d", offsetSize)));
+    }
+    else
+    {
+        sys::Uint32_T ifdOffset;
+        input.read((sys::byte *)&ifdOffset, sizeof(ifdOffset));
+        if (mDifferentByteOrdering)
+            ifdOffset = sys::byteSwap(ifdOffset);
+        mIFDOffset = ifdOffset;
     }
 }
 
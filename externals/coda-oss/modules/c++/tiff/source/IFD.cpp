@@ -27,6 +27,8 @@
 #include "tiff/IFDEntry.h"
 #include "tiff/KnownTags.h"
 
+#include <limits>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <import/io.h>
@@ -106,20 +108,45 @@ void tiff::IFD::deserialize(io::InputStream& input)
 
 void tiff::IFD::deserialize(io::InputStream& input, const bool reverseBytes)
 {
-    unsigned short ifdEntryCount;
-    input.read((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
-    if (reverseBytes)
-        ifdEntryCount = sys::byteSwap(ifdEntryCount);
+    deserialize(input, reverseBytes, false);
+}
 
-    for (unsigned short i = 0; i < ifdEntryCount; i++)
+void tiff::IFD::deserialize(io::InputStream& input, const bool reverseBytes,
+                            const bool bigTIFF)
+{
+    sys::Uint64_T ifdEntryCount;
+    if (bigTIFF)
     {
-        tiff::IFDEntry *entry = new tiff::IFDEntry();
-        entry->deserialize(input, reverseBytes);
-        mIFD[entry->getTagID()] = entry;
+        input.read((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+        if (reverseBytes)
+            ifdEntryCount = sys::byteSwap(ifdEntryCount);
+    }
+    else
+    {
+        unsigned short shortCount;
+        input.read((sys::byte *)&shortCount, sizeof(shortCount));
+        if (reverseBytes)
+            shortCount = sys::byteSwap(shortCount);
+        ifdEntryCount = shortCount;
+    }
+
+    for (sys::Uint64_T i = 0; i < ifdEntryCount; i++)
+    {
+        std::unique_ptr<tiff::IFDEntry> entry(new tiff::IFDEntry());
+        entry->deserialize(input, reverseBytes, bigTIFF);
+
+        const auto tag = entry->getTagID();
+        delete mIFD[tag];
+        mIFD[tag] = entry.release();
     }
 }
 
 void tiff::IFD::serialize(io::OutputStream& output)
+{
+    serialize(output, false);
+}
+
+void tiff::IFD::serialize(io::OutputStream& output, const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable *>(&output);
@@ -129,26 +156,38 @@ void tiff::IFD::serialize(io::OutputStream& output)
     // Makes sure all data offsets are defined for each entry.
     // Keep the offset just past the end of the IFD.  This offset
     // is where the next potential image could be written.
-    const auto endOffset = finalize(static_cast<sys::Uint32_T>(seekable->tell()));
+    const auto endOffset = finalize(
+            static_cast<sys::Uint64_T>(seekable->tell()), bigTIFF);
+    if (!bigTIFF && endOffset > std::numeric_limits<sys::Uint32_T>::max())
+        throw except::Exception(Ctxt(
+                "IFD is past the 4 GB limit of TIFF; use BigTIFF"));
 
     // Write out IFD entry count.
-    const auto ifdEntryCount = static_cast<uint16_t>(mIFD.size());
-    output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    if (bigTIFF)
+    {
+        const auto ifdEntryCount = static_cast<sys::Uint64_T>(mIFD.size());
+        output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    }
+    else
+    {
+        const auto ifdEntryCount = static_cast<uint16_t>(mIFD.size());
+        output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    }
 
     // Write out each IFD entry.
     for (IFDType::const_iterator i = mIFD.begin(); i != mIFD.end(); ++i)
     {
         tiff::IFDEntry *entry = i->second;
-        entry->serialize(output);
+        entry->serialize(output, bigTIFF);
     }
 
     // Remember the current position in case there is another IFD after
     // this one.
-    mNextIFDOffsetPosition = static_cast<sys::Uint32_T>(seekable->tell());
+    mNextIFDOffsetPosition = static_cast<sys::Uint64_T>(seekable->tell());
 
     // Write out the default next IFD location.
-    sys::Uint32_T nextOffset = 0;
-    output.write((sys::byte *)&nextOffset, sizeof(sys::Uint32_T));
+    const sys::byte nextOffset[8] = {};
+    output.write(nextOffset, tiff::IFDEntry::valueFieldSize(bigTIFF));
 
     // Seek the end of the IFD, the next image can begin here.
     seekable->seek(endOffset, io::Seekable::START);
@@ -175,10 +214,7 @@ sys::Uint32_T tiff::IFD::getImageWidth() const
     if (!imageWidth)
         return 0;
 
-    if (imageWidth->getType() == tiff::Const::Type::LONG)
-        return *(tiff::GenericType<sys::Uint32_T> *)(*imageWidth)[0];
-
-    return *(tiff::GenericType<unsigned short> *)(*imageWidth)[0];
+    return static_cast<sys::Uint32_T>(imageWidth->getUnsignedValue(0));
 }
 
 sys::Uint32_T tiff::IFD::getImageLength() const
@@ -187,17 +223,14 @@ sys::Uint32_T tiff::IFD::getImageLength() const
     if (!imageLength)
         return 0;
 
-    if (imageLength->getType() == tiff::Const::Type::LONG)
-        return *(tiff::GenericType<sys::Uint32_T> *)(*imageLength)[0];
-
-    return *(tiff::GenericType<unsigned short> *)(*imageLength)[0];
+    return static_cast<sys::Uint32_T>(imageLength->getUnsignedValue(0));
 }
 
-sys::Uint32_T tiff::IFD::getImageSize() const
+sys::Uint64_T tiff::IFD::getImageSize() const
 {
-    sys::Uint32_T width = getImageWidth();
-    sys::Uint32_T length = getImageLength();
-    unsigned short elementSize = getElementSize();
+    const sys::Uint64_T width = getImageWidth();
+    const sys::Uint64_T length = getImageLength();
+    const unsigned short elementSize = getElementSize();
 
     return width * length * elementSize;
 }
@@ -226,21 +259,23 @@ unsigned short tiff::IFD::getElementSize() const
     return static_cast<unsigned short>(bytesPerSample * getNumBands());
 }
 
-sys::Uint32_T tiff::IFD::finalize(const sys::Uint32_T offset)
+sys::Uint64_T tiff::IFD::finalize(const sys::Uint64_T offset,
+                                 const bool bigTIFF)
 {
     // Find the beginning offset to extra IFD data.  The IFD length is
     // the size of an IFD entry multiplied by the number of entries, plus
-    // 4 bytes to hold the offset to the next IFD, and 2 bytes to hold the
-    // IFD entry count.
-    auto dataOffset = static_cast<sys::Uint32_T>(offset + sizeof(short) + (mIFD.size()
-            * tiff::IFDEntry::sizeOf()) + sizeof(sys::Uint32_T));
+    // the offset to the next IFD and the IFD entry count.  BigTIFF uses
+    // 8 bytes for both, TIFF 4 bytes for the offset and 2 for the count.
+    const sys::Uint64_T countSize = bigTIFF ? sizeof(sys::Uint64_T) : sizeof(short);
+    auto dataOffset = offset + countSize + (mIFD.size()
+            * tiff::IFDEntry::sizeOf(bigTIFF)) + tiff::IFDEntry::valueFieldSize(bigTIFF);
 
     for (IFDType::iterator i = mIFD.begin(); i != mIFD.end(); ++i)
     {
         // Send in the current offset.  If the value size of the IFD entry
         // requires that data be placed outside the IFD entry, the offset that
         // is returned will be adjusted to compensate for that data.
-        dataOffset = i->second->finalize(dataOffset);
+        dataOffset = i->second->finalize(dataOffset, bigTIFF);
     }
 
     return dataOffset;
@@ -20,8 +20,10 @@
  *
  */
 
+#include <limits>
 #include <string>
 #include <string.h>
+#include <vector>
 #include <sstream>
 #include <import/io.h>
 #include <import/except.h>
@@ -35,6 +37,11 @@
 
 
 void tiff::IFDEntry::serialize(io::OutputStream& output)
+{
+    serialize(output, false);
+}
+
+void tiff::IFDEntry::serialize(io::OutputStream& output, const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable *>(&output);
@@ -43,11 +50,21 @@ void tiff::IFDEntry::serialize(io::OutputStream& output)
 
     output.write((sys::byte *)&mTag, sizeof(mTag));
     output.write((sys::byte *)&mType, sizeof(mType));
-    output.write((sys::byte *)&mCount, sizeof(mCount));
+    if (bigTIFF)
+    {
+        const sys::Uint64_T count = mCount;
+        output.write((sys::byte *)&count, sizeof(count));
+    }
+    else
+    {
+        output.write((sys::byte *)&mCount, sizeof(mCount));
+    }
 
-    sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
+    const size_t fieldSize = valueFieldSize(bigTIFF);
+    const sys::Uint64_T size =
+            static_cast<sys::Uint64_T>(mCount) * tiff::Const::sizeOf(mType);
 
-    if (size > 4)
+    if (size > fieldSize)
     {
         // Keep the current position and jump to the write position.
         const auto current = seekable->tell();
@@ -62,20 +79,30 @@ void tiff::IFDEntry::serialize(io::OutputStream& output)
         seekable->seek(current, io::Seekable::START);
 
         // Write out the data offset.
-        output.write((sys::byte *)&mOffset, sizeof(mOffset));
+        if (bigTIFF)
+        {
+            output.write((sys::byte *)&mOffset, sizeof(mOffset));
+        }
+        else
+        {
+            const auto offset = static_cast<sys::Uint32_T>(mOffset);
+            output.write((sys::byte *)&offset, sizeof(offset));
+        }
     }
     else
     {
-        for (sys::Uint32_T i = 0; i < mCount; ++i)
+        // The values are kept in the entry, padded out to fill it.
+        size_t written = 0;
+        for (sys::Uint32_T i = 0; i < mValues.size(); ++i)
         {
-            // The value must take up four bytes.  If the number of bytes is
-            // less than four, duplicate the value until you hit 4 bytes in length.
-            const auto iterations = (4 / mCount) / mValues[i]->size();
-
-            for (size_t j = 0; j < iterations; ++j)
-                output.write((sys::byte *)mValues[i]->data(),
-                        mValues[i]->size());
+            output.write((sys::byte *)mValues[i]->data(),
+                    mValues[i]->size());
+            written += mValues[i]->size();
         }
+
+        const sys::byte padding[8] = {};
+        if (written < fieldSize)
+            output.write(padding, fieldSize - written);
     }
 }
 
@@ -85,6 +112,12 @@ void tiff::IFDEntry::deserialize(io::InputStream& input)
 }
 
 void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes)
+{
+    deserialize(input, reverseBytes, false);
+}
+
+void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes,
+                                 const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable*>(&input);
@@ -93,59 +126,92 @@ void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes
 
     input.read((char *)&mTag, sizeof(mTag));
     input.read((char *)&mType, sizeof(mType));
-    input.read((char *)&mCount, sizeof(mCount));
-    input.read((char *)&mOffset, sizeof(mOffset));
+
+    sys::Uint64_T count;
+    if (bigTIFF)
+    {
+        input.read((char *)&count, sizeof(count));
+        if (reverseBytes)
+            count = sys::byteSwap(count);
+    }
+    else
+    {
+        sys::Uint32_T count32;
+        input.read((char *)&count32, sizeof(count32));
+        if (reverseBytes)
+            count32 = sys::byteSwap(count32);
+        count = count32;
+    }
+
+    // The value field holds either the values or their offset.
+    const size_t fieldSize = valueFieldSize(bigTIFF);
+    unsigned char field[8] = {};
+    input.read((char *)field, fieldSize);
 
     if (reverseBytes)
     {
         mTag = sys::byteSwap(mTag);
         mType =  sys::byteSwap(mType);
-        mCount = sys::byteSwap(mCount);
-        mOffset = sys::byteSwap(mOffset);
     }
 
-    sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
+    if (count > std::numeric_limits<sys::Uint32_T>::max())
+        throw except::Exception(Ctxt(FmtX(
+                "Too many values for IFD entry %d", mTag)));
+    mCount = static_cast<sys::Uint32_T>(count);
 
-    if (size > 4)
+    // Rationals are two longs.
+    auto elementSize = tiff::Const::sizeOf(mType);
+    sys::Uint64_T numElements = mCount;
+    if (mType == tiff::Const::Type::RATIONAL ||
+        mType == tiff::Const::Type::SRATIONAL)
     {
+        elementSize /= 2;
+        numElements *= 2;
+    }
+
+    const sys::Uint64_T size =
+            static_cast<sys::Uint64_T>(mCount) * tiff::Const::sizeOf(mType);
+
+    if (size > fieldSize)
+    {
+        if (bigTIFF)
+        {
+            memcpy(&mOffset, field, sizeof(mOffset));
+            if (reverseBytes)
+                mOffset = sys::byteSwap(mOffset);
+        }
+        else
+        {
+            sys::Uint32_T offset;
+            memcpy(&offset, field, sizeof(offset));
+            if (reverseBytes)
+                offset = sys::byteSwap(offset);
+            mOffset = offset;
+        }
+
         // Keep the current position and jump to the read position.
         const auto current = seekable->tell();
         seekable->seek(mOffset, io::Seekable::START);
 
         // Read in the value(s);
-        sys::byte *buffer = new sys::byte[size];
-
-        input.read(buffer, size);
-        if (reverseBytes)
-        {
-            auto elementSize = tiff::Const::sizeOf(mType);
-            sys::Uint32_T numElements = mCount;
-            if (mType == tiff::Const::Type::RATIONAL && mType
-                    == tiff::Const::Type::SRATIONAL)
-            {
-                elementSize = tiff::Const::sizeOf(mType) / 2;
-                numElements = mCount * 2;
-            }
-            if (elementSize > 1)
-                sys::byteSwap(buffer, static_cast<unsigned short>(elementSize), numElements);
-        }
+        std::vector<sys::byte> buffer(static_cast<size_t>(size));
+        input.read(buffer.data(), buffer.size());
+        if (reverseBytes && elementSize > 1)
+            sys::byteSwap(buffer.data(), static_cast<unsigned short>(elementSize),
+                          static_cast<size_t>(numElements));
 
-        parseValues((const unsigned char *)buffer);
-        delete[] buffer;
+        parseValues((const unsigned char *)buffer.data());
 
         // Reset the cursor position.
         seekable->seek(current, io::Seekable::START);
     }
     else
     {
-        if (reverseBytes)
-        {
-            // Re-reverse because a value may be less than 4 bytes.
-            mOffset = sys::byteSwap(mOffset);
-            const auto elementSize = tiff::Const::sizeOf(mType);
-            sys::byteSwap((sys::byte*)&mOffset, elementSize, sizeof(mOffset) / elementSize);
-        }
-        parseValues((unsigned char *)&mOffset);
+        mOffset = 0;
+        if (reverseBytes && elementSize > 1)
+            sys::byteSwap((sys::byte*)field, static_cast<unsigned short>(elementSize),
+                          static_cast<size_t>(numElements));
+        parseValues(field);
     }
 
     //try to retrieve the name as well
@@ -219,12 +285,41 @@ void tiff::IFDEntry::parseValues(const unsigned char *buffer)
     }
 }
 
+sys::Uint64_T tiff::IFDEntry::getUnsignedValue(const sys::Uint32_T index) const
+{
+    const tiff::TypeInterface* const value = mValues.at(index);
+    switch (mType)
+    {
+    case tiff::Const::Type::BYTE:
+        return *(const tiff::GenericType<unsigned char> *)value;
+    case tiff::Const::Type::SHORT:
+        return *(const tiff::GenericType<unsigned short> *)value;
+    case tiff::Const::Type::LONG:
+    case tiff::Const::Type::IFD:
+        return *(const tiff::GenericType<sys::Uint32_T> *)value;
+    case tiff::Const::Type::LONG8:
+    case tiff::Const::Type::IFD8:
+        return *(const tiff::GenericType<sys::Uint64_T> *)value;
+    default:
+        throw except::Exception(Ctxt(FmtX(
+                "IFD entry %d is not an unsigned integer", mTag)));
+    }
+}
+
 sys::Uint32_T tiff::IFDEntry::finalize(const sys::Uint32_T offset)
+{
+    return static_cast<sys::Uint32_T>(
+            finalize(static_cast<sys::Uint64_T>(offset), false));
+}
+
+sys::Uint64_T tiff::IFDEntry::finalize(const sys::Uint64_T offset,
+                                       const bool bigTIFF)
 {
     mCount = static_cast<sys::Uint32_T>(mValues.size());
 
-    sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
-    if (size > 4)
+    const sys::Uint64_T size =
+            static_cast<sys::Uint64_T>(mCount) * tiff::Const::sizeOf(mType);
+    if (size > valueFieldSize(bigTIFF))
     {
         mOffset = offset;
         return offset + size;
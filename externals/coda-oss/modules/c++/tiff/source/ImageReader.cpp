@@ -22,28 +22,83 @@
 
 #include "tiff/ImageReader.h"
 
+#include <string.h>
+#include <algorithm>
 #include <sstream>
+#include <vector>
 #include <import/io.h>
 #include <import/except.h>
 #include "tiff/Common.h"
 #include "tiff/GenericType.h"
 #include "tiff/IFDEntry.h"
 
-void tiff::ImageReader::process(const bool reverseBytes)
+void tiff::ImageReader::process(const bool reverseBytes, const bool bigTIFF)
 {
     mReverseBytes = reverseBytes;
 
-    mIFD.deserialize(*mInput, mReverseBytes);
+    mIFD.deserialize(*mInput, mReverseBytes, bigTIFF);
 
-    mInput->read((sys::byte *)&mNextOffset, sizeof(mNextOffset));
-    if (mReverseBytes)
-        mNextOffset = sys::byteSwap(mNextOffset);
+    if (bigTIFF)
+    {
+        mInput->read((sys::byte *)&mNextOffset, sizeof(mNextOffset));
+        if (mReverseBytes)
+            mNextOffset = sys::byteSwap(mNextOffset);
+    }
+    else
+    {
+        sys::Uint32_T nextOffset;
+        mInput->read((sys::byte *)&nextOffset, sizeof(nextOffset));
+        if (mReverseBytes)
+            nextOffset = sys::byteSwap(nextOffset);
+        mNextOffset = nextOffset;
+    }
 
     // Done here to lower the number of calls to it later.
     mElementSize = mIFD.getElementSize();
 
-    mStripByteCounts = mIFD["StripByteCounts"];
-    mStripOffsets = mIFD["StripOffsets"];
+    // Index the strips or tiles so regions can go straight to them.
+    const tiff::IFDEntry* offsets = mIFD["TileOffsets"];
+    const tiff::IFDEntry* byteCounts = mIFD["TileByteCounts"];
+    mTiled = offsets != nullptr;
+    if (mTiled)
+    {
+        const tiff::IFDEntry* const tileWidth = mIFD["TileWidth"];
+        const tiff::IFDEntry* const tileLength = mIFD["TileLength"];
+        if (!tileWidth || !tileLength)
+            throw except::Exception(Ctxt("Tiled image has no tile size"));
+
+        mChunkWidth = static_cast<sys::Uint32_T>(tileWidth->getUnsignedValue(0));
+        mChunkLength = static_cast<sys::Uint32_T>(tileLength->getUnsignedValue(0));
+    }
+    else
+    {
+        offsets = mIFD["StripOffsets"];
+        byteCounts = mIFD["StripByteCounts"];
+
+        // A missing RowsPerStrip means the image is one strip.
+        const tiff::IFDEntry* const rowsPerStrip = mIFD["RowsPerStrip"];
+        mChunkWidth = mIFD.getImageWidth();
+        mChunkLength = rowsPerStrip ?
+                static_cast<sys::Uint32_T>(rowsPerStrip->getUnsignedValue(0)) :
+                mIFD.getImageLength();
+        mChunkLength = std::min(mChunkLength, mIFD.getImageLength());
+    }
+
+    mChunkOffsets.clear();
+    mChunkByteCounts.clear();
+    if (offsets && byteCounts)
+    {
+        if (offsets->getCount() != byteCounts->getCount())
+            throw except::Exception(Ctxt("Offset and byte counts don't match"));
+
+        mChunkOffsets.resize(offsets->getCount());
+        mChunkByteCounts.resize(byteCounts->getCount());
+        for (sys::Uint32_T i = 0; i < offsets->getCount(); ++i)
+        {
+            mChunkOffsets[i] = offsets->getUnsignedValue(i);
+            mChunkByteCounts[i] = byteCounts->getUnsignedValue(i);
+        }
+    }
 }
 
 void tiff::ImageReader::print(io::OutputStream &output) const
@@ -56,8 +111,56 @@ void tiff::ImageReader::print(io::OutputStream &output) const
     output.write(message.str());
 }
 
+bool tiff::ImageReader::isReducedResolution() const
+{
+    const tiff::IFDEntry* const subfileType = mIFD["NewSubfileType"];
+    return subfileType && (subfileType->getUnsignedValue(0) & 1);
+}
+
 void tiff::ImageReader::getData(unsigned char *buffer,
         const sys::Uint32_T numElementsToRead)
+{
+    const sys::Uint64_T width = mIFD.getImageWidth();
+    const sys::Uint64_T rowBytes = width * mElementSize;
+    if (rowBytes == 0)
+        throw except::Exception(Ctxt("Image has no columns"));
+
+    sys::Uint64_T numBytesToRead =
+            static_cast<sys::Uint64_T>(numElementsToRead) * mElementSize;
+    if (mBytePosition + numBytesToRead > mIFD.getImageSize())
+        throw except::Exception(Ctxt("Read past the end of the image"));
+
+    // Read a partial row, as many whole rows as possible, then
+    // another partial row.
+    while (numBytesToRead)
+    {
+        const sys::Uint64_T row = mBytePosition / rowBytes;
+        const sys::Uint64_T column = (mBytePosition % rowBytes) / mElementSize;
+
+        sys::Uint64_T numRows = 1;
+        sys::Uint64_T numCols = std::min(width - column,
+                                         numBytesToRead / mElementSize);
+        if (column == 0 && numBytesToRead >= rowBytes)
+        {
+            numRows = numBytesToRead / rowBytes;
+            numCols = width;
+        }
+
+        getRegion(buffer, static_cast<sys::Uint32_T>(row),
+                  static_cast<sys::Uint32_T>(numRows),
+                  static_cast<sys::Uint32_T>(column),
+                  static_cast<sys::Uint32_T>(numCols));
+
+        const sys::Uint64_T numBytes = numRows * numCols * mElementSize;
+        buffer += numBytes;
+        mBytePosition += numBytes;
+        numBytesToRead -= numBytes;
+    }
+}
+
+void tiff::ImageReader::getRegion(unsigned char *buffer,
+                                  sys::Uint32_T startRow, sys::Uint32_T numRows,
+                                  sys::Uint32_T startCol, sys::Uint32_T numCols)
 {
     //see if it is uncompressed
     tiff::IFDEntry *compression = mIFD["Compression"];
@@ -67,149 +170,114 @@ void tiff::ImageReader::getData(unsigned char *buffer,
         if (c != tiff::Const::CompressionType::NO_COMPRESSION)
             throw except::Exception(Ctxt(FmtX("Unsupported compression type: %d", c)));
     }
-    
-    if (mIFD["StripOffsets"])
-        getStripData(buffer, numElementsToRead);
-    else if (mIFD["TileOffsets"])
-        getTileData(buffer, numElementsToRead);
-    else
-        throw except::Exception(Ctxt("Unsupported TIFF file format"));
 
-    if (mReverseBytes)
-        sys::byteSwap((sys::byte*)buffer, mElementSize, numElementsToRead);
-}
-
-void tiff::ImageReader::getStripData(unsigned char *buffer,
-        sys::Uint32_T numElementsToRead)
-{
-    sys::Uint32_T bufferOffset = 0;
-    
-    //figure out how far we are in the current strip
-    sys::Uint32_T stripOffset = 0;
-    for (sys::Uint32_T i = 0; i < mStripIndex; ++i)
-        stripOffset += *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[i];
-    sys::Uint32_T stripPosition = mBytePosition - stripOffset;
-    
-    //how many bytes do we need to read?
-    sys::Uint32_T numBytesToRead = numElementsToRead * mElementSize;
+    if (mChunkOffsets.empty() || mChunkWidth == 0 || mChunkLength == 0)
+        throw except::Exception(Ctxt("Unsupported TIFF file format"));
 
-    while (numBytesToRead)
+    const sys::Uint64_T imageWidth = mIFD.getImageWidth();
+    const sys::Uint64_T imageLength = mIFD.getImageLength();
+    const sys::Uint64_T endRow = static_cast<sys::Uint64_T>(startRow) + numRows;
+    const sys::Uint64_T endCol = static_cast<sys::Uint64_T>(startCol) + numCols;
+    if (endRow > imageLength || endCol > imageWidth)
+        throw except::Exception(Ctxt("Region is outside of the image"));
+
+    if (numRows == 0 || numCols == 0)
+        return;
+
+    // Strips are one chunk across
+    const sys::Uint64_T chunksAcross =
+            (imageWidth + mChunkWidth - 1) / mChunkWidth;
+    const sys::Uint64_T firstChunkRow = startRow / mChunkLength;
+    const sys::Uint64_T lastChunkRow = (endRow - 1) / mChunkLength;
+    const sys::Uint64_T firstChunkCol = startCol / mChunkWidth;
+    const sys::Uint64_T lastChunkCol = (endCol - 1) / mChunkWidth;
+
+    for (sys::Uint64_T chunkRow = firstChunkRow; chunkRow <= lastChunkRow;
+            ++chunkRow)
     {
-        if (mStripIndex >= mStripOffsets->getCount())
-            throw except::Exception(Ctxt("Invalid strip offset index"));
-
-        sys::Uint32_T stripSize = *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[mStripIndex];
-
-        // Calculate what remains to be read in the current strip.
-        sys::Uint32_T remainingBytesInStrip = stripSize - stripPosition;
-
-        // Seek to the strip offset plus the last read position.
-        sys::Uint32_T seekPos = (*(tiff::GenericType<sys::Uint32_T> *)(*mStripOffsets)[mStripIndex]) + stripPosition;
-
-        
-        sys::Uint32_T thisRead = numBytesToRead;
-        
-        // If the total number of bytes to read exceeds the bytes remaining
-        // in the current strip, just read what can be read from the current strip.
-        if (numBytesToRead > remainingBytesInStrip)
+        for (sys::Uint64_T chunkCol = firstChunkCol;
+                chunkCol <= lastChunkCol; ++chunkCol)
         {
-            thisRead = remainingBytesInStrip;
-            mStripIndex++; //increment the strip index for next time
+            readChunk(buffer,
+                      static_cast<size_t>(chunkRow * chunksAcross + chunkCol),
+                      chunkRow * mChunkLength, chunkCol * mChunkWidth,
+                      startRow, numRows, startCol, numCols);
         }
-        
-        // Go to the offset, and read.
-        mInput->seek(seekPos, io::Seekable::START);
-        mInput->read((sys::byte *)buffer + bufferOffset, thisRead);
-
-        // Update the tile position in bytes.
-        mBytePosition += thisRead;
-
-        // Decrement the number of elements remaining to read.
-        numBytesToRead -= thisRead;
-        bufferOffset += thisRead;
+    }
 
-        //reset to 0
-        stripPosition = 0;
+    if (mReverseBytes)
+    {
+        // Swap each sample
+        const unsigned short numBands = mIFD.getNumBands();
+        const unsigned short sampleSize = mElementSize / numBands;
+        if (sampleSize > 1)
+        {
+            sys::byteSwap((sys::byte*)buffer, sampleSize,
+                          static_cast<size_t>(numRows) * numCols * numBands);
+        }
     }
 }
 
-void tiff::ImageReader::getTileData(unsigned char*buffer,
-        sys::Uint32_T numElementsToRead)
+void tiff::ImageReader::readChunk(unsigned char *buffer, size_t chunkIndex,
+                                  sys::Uint64_T chunkRow, sys::Uint64_T chunkCol,
+                                  sys::Uint64_T startRow, sys::Uint64_T numRows,
+                                  sys::Uint64_T startCol, sys::Uint64_T numCols)
 {
-    // Get the image width and length.
-    sys::Uint32_T imageElemWidth = mIFD.getImageWidth();
-    sys::Uint32_T imageByteWidth = imageElemWidth * mElementSize;
-
-    // Get the tile width.
-    tiff::IFDEntry *tileWidth = mIFD["TileWidth"];
-    sys::Uint32_T tileElemWidth = 0;
-    if (tileWidth->getType() == tiff::Const::Type::LONG)
-        tileElemWidth = *(tiff::GenericType<sys::Uint32_T> *)(*tileWidth)[0];
-    else
-        tileElemWidth = *(tiff::GenericType<unsigned short> *)(*tileWidth)[0];
-    sys::Uint32_T tileByteWidth = tileElemWidth * mElementSize;
-
-    // Get the tile length.
-    tiff::IFDEntry *tileLength = mIFD["TileLength"];
-    sys::Uint32_T tileElemLength = 0;
-    if (tileLength->getType() == tiff::Const::Type::LONG)
-        tileElemLength = *(tiff::GenericType<sys::Uint32_T> *)(*tileLength)[0];
-    else
-        tileElemLength = *(tiff::GenericType<unsigned short> *)(*tileLength)[0];
-
-    // Compute the number of tiles wide the image is.
-    sys::Uint32_T tilesAcross = (imageElemWidth + tileElemWidth - 1)
-            / tileElemWidth;
-
-    // Determine how many bytes were used to pad the right edge.
-    sys::Uint32_T widthPadding = (tileByteWidth * tilesAcross) - imageByteWidth;
-    sys::Uint32_T bufferOffset = 0;
-
-    while (numElementsToRead)
+    if (chunkIndex >= mChunkOffsets.size())
+        throw except::Exception(Ctxt("Invalid strip or tile index"));
+
+    // The part of the chunk inside the region, in chunk coordinates
+    const sys::Uint64_T firstRow = std::max(startRow, chunkRow) - chunkRow;
+    const sys::Uint64_T lastRow =
+            std::min(startRow + numRows, chunkRow + mChunkLength) - chunkRow;
+    const sys::Uint64_T firstCol = std::max(startCol, chunkCol) - chunkCol;
+    const sys::Uint64_T lastCol =
+            std::min(startCol + numCols, chunkCol + mChunkWidth) - chunkCol;
+
+    const sys::Uint64_T chunkRowBytes =
+            static_cast<sys::Uint64_T>(mChunkWidth) * mElementSize;
+    const size_t copyBytes = static_cast<size_t>((lastCol - firstCol) * mElementSize);
+    const size_t regionRowBytes = static_cast<size_t>(numCols * mElementSize);
+    unsigned char* dest = buffer
+            + (chunkRow + firstRow - startRow) * regionRowBytes
+            + (chunkCol + firstCol - startCol) * mElementSize;
+
+    // A sparse chunk has no data, and is all zeros.
+    if (mChunkByteCounts[chunkIndex] == 0)
     {
-        sys::Uint32_T bytesToRead = mElementSize * numElementsToRead;
-
-        // Compute the row in image, row in tile, and tile row.
-        sys::Uint32_T row = mBytePosition / imageByteWidth;
-        sys::Uint32_T tileRow = row / tileElemLength;
-        sys::Uint32_T rowInTile = row % tileElemLength;
-
-        // Compute the column in image, column in tile, and tile column.
-        sys::Uint32_T column = mBytePosition - (row * imageByteWidth);
-        sys::Uint32_T tileColumn = column / tileByteWidth;
-        sys::Uint32_T colInTile = column % tileByteWidth;
-
-        // Compute the 1D tile index from the tile row and tile column.
-        sys::Uint32_T tileIndex = (tileRow * tilesAcross) + tileColumn;
-
-        sys::Uint32_T paddedBytes = ((tileColumn + 1) / tilesAcross)
-                * widthPadding;
-
-        sys::Uint32_T remainingBytesThisLine = tileByteWidth - (paddedBytes
-                + (column % tileByteWidth));
-
-        // If the total number of bytes to read exceeds the bytes remaining
-        // in the current line of the current tile, just read what can be 
-        // read from the current tile.
-        if (bytesToRead> remainingBytesThisLine)
-            bytesToRead = remainingBytesThisLine;
-
-        // Seek to the tile offset plus the last read position.
-        tiff::IFDEntry *tileOffsets = mIFD["TileOffsets"];
-        sys::Uint32_T seekPos = (*(tiff::GenericType<sys::Uint32_T> *)(*tileOffsets)[tileIndex]) + (rowInTile * tileByteWidth)
-                + colInTile;
-
-        // Go to the offset.
-        mInput->seek(seekPos, io::Seekable::START);
-
-        // Read the data.
-        mInput->read((sys::byte *)buffer + bufferOffset, bytesToRead);
+        for (sys::Uint64_T row = firstRow; row < lastRow; ++row)
+        {
+            memset(dest, 0, copyBytes);
+            dest += regionRowBytes;
+        }
+        return;
+    }
 
-        // Update the strip position in bytes.
-        mBytePosition += bytesToRead;
+    // One read, from the first byte needed to the last
+    const sys::Uint64_T begin = firstRow * chunkRowBytes + firstCol * mElementSize;
+    const sys::Uint64_T end = (lastRow - 1) * chunkRowBytes + lastCol * mElementSize;
+    if (end > mChunkByteCounts[chunkIndex])
+        throw except::Exception(Ctxt(FmtX(
+                "Strip or tile %d is too small", chunkIndex)));
+
+    mInput->seek(static_cast<sys::Off_T>(mChunkOffsets[chunkIndex] + begin),
+                 io::Seekable::START);
+    // Read straight into the region when the bytes are laid out the same
+    const bool contiguous = lastRow - firstRow == 1 ||
+            (copyBytes == chunkRowBytes && copyBytes == regionRowBytes);
+    if (contiguous)
+    {
+        mInput->read((sys::byte *)dest, static_cast<size_t>(end - begin));
+        return;
+    }
 
-        // Decrement the number of elements remaining to read.
-        bufferOffset += bytesToRead;
-        numElementsToRead -= (bytesToRead / mElementSize);
+    std::vector<sys::byte> scratch(static_cast<size_t>(end - begin));
+    mInput->read(scratch.data(), scratch.size());
+    const sys::byte* src = scratch.data();
+    for (sys::Uint64_T row = firstRow; row < lastRow; ++row)
+    {
+        memcpy(dest, src, copyBytes);
+        dest += regionRowBytes;
+        src += chunkRowBytes;
     }
 }
@@ -22,6 +22,9 @@
 
 #include "tiff/ImageWriter.h"
 
+#include <string.h>
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <cmath>
 #include <import/except.h>
@@ -29,6 +32,8 @@
 #include "tiff/Common.h"
 #include "tiff/GenericType.h"
 #include "tiff/IFDEntry.h"
+#include "tiff/KnownTags.h"
+#include "tiff/TypeFactory.h"
 
 const unsigned short tiff::ImageWriter::CHUNK_SIZE = 8192;
 
@@ -49,22 +54,64 @@ void tiff::ImageWriter::putData(const unsigned char *buffer,
 
 void tiff::ImageWriter::writeIFD()
 {
-    // Retain the current file offset.
-    const auto offset = mOutput->tell();
+    // The IFD before this one says where its link to this one goes
+    if (mPrevious)
+    {
+        if (!mPrevious->mIFDWritten)
+            throw except::Exception(Ctxt(
+                    "The IFD of the previous image must be written first"));
+        mIFDOffset = mPrevious->getNextIFDOffset();
+    }
+
+    // The IFD goes after all of the image data, which isn't necessarily
+    // where the last write left off when images are written side by side.
+    const auto offset = mOutput->seek(0, io::Seekable::END);
 
     // Seek to the position to write the current offset to.
-    mOutput->seek(mIFDOffset, io::Seekable::START);
+    mOutput->seek(static_cast<sys::Off_T>(mIFDOffset), io::Seekable::START);
 
-    // Write the current offset.
-    mOutput->write((sys::byte *)&offset, sizeof(offset));
+    // Write the current offset, as wide as the file's offsets.
+    if (mBigTIFF)
+    {
+        const auto ifdOffset = static_cast<sys::Uint64_T>(offset);
+        mOutput->write((sys::byte *)&ifdOffset, sizeof(ifdOffset));
+    }
+    else
+    {
+        if (static_cast<sys::Uint64_T>(offset) >
+            std::numeric_limits<sys::Uint32_T>::max())
+        {
+            throw except::Exception(Ctxt(
+                    "IFD is past the 4 GB limit of TIFF; use BigTIFF"));
+        }
+        const auto ifdOffset = static_cast<sys::Uint32_T>(offset);
+        mOutput->write((sys::byte *)&ifdOffset, sizeof(ifdOffset));
+    }
 
     // Reseek to the current offset and write out the IFD.
     mOutput->seek(offset, io::Seekable::START);
-    mIFD.serialize(*mOutput);
+    mIFD.serialize(*mOutput, mBigTIFF);
 
     // Keep the position in the file that the offset to the next
     // IFD can be written to, in case there is another IFD.
     mIFDOffset = mIFD.getNextIFDOffsetPosition();
+    mIFDWritten = true;
+}
+
+void tiff::ImageWriter::setDataOffset(const sys::Uint64_T offset)
+{
+    if (mValidated)
+        throw except::Exception(Ctxt(
+                "The image data is already laid out"));
+
+    mDataOffset = offset;
+    mDataOffsetSet = true;
+}
+
+sys::Uint64_T tiff::ImageWriter::getDataEnd()
+{
+    validate();
+    return mDataEnd;
 }
 
 void tiff::ImageWriter::validate()
@@ -203,6 +250,9 @@ void tiff::ImageWriter::validate()
 
     mElementSize = mIFD.getElementSize();
 
+    if (!mDataOffsetSet)
+        mDataOffset = static_cast<sys::Uint64_T>(mOutput->tell());
+
     if (mFormat == TILED)
         initTiles();
     else
@@ -228,260 +278,207 @@ void tiff::ImageWriter::validate()
     mValidated = true;
 }
 
-void tiff::ImageWriter::initTiles()
+tiff::IFDEntry* tiff::ImageWriter::addOffsetEntry(const std::string& name)
 {
-    sys::Uint32_T root = (sys::Uint32_T)sqrt((double)mIdealChunkSize
-            / (double)mIFD.getElementSize());
-    sys::Uint32_T ceiling = (sys::Uint32_T)ceil(((double)root) / 16);
-    sys::Uint32_T tileSize = ceiling * 16;
-
-    mIFD.addEntry("TileWidth", (sys::Uint32_T) tileSize);
-    mIFD.addEntry("TileLength", (sys::Uint32_T) tileSize);
-
-    auto fileOffset = mOutput->tell();
-    sys::Uint32_T tilesAcross = (mIFD.getImageWidth() + tileSize - 1)
-            / tileSize;
-    sys::Uint32_T tilesDown = (mIFD.getImageLength() + tileSize - 1) / tileSize;
+    if (mBigTIFF)
+    {
+        const tiff::IFDEntry* const mapEntry =
+                tiff::KnownTagsRegistry::getInstance()[name];
+        const tiff::IFDEntry entry(mapEntry->getTagID(),
+                                   tiff::Const::Type::LONG8, name);
+        mIFD.addEntry(&entry);
+    }
+    else
+    {
+        mIFD.addEntry(name);
+    }
+    return mIFD[name];
+}
 
-    unsigned short elementSize = mIFD.getElementSize();
+void tiff::ImageWriter::addOffsetValue(tiff::IFDEntry* entry,
+                                       sys::Uint64_T value)
+{
+    if (mBigTIFF)
+    {
+        entry->addValue(tiff::TypeFactory::create(
+                (unsigned char *)&value, tiff::Const::Type::LONG8));
+        return;
+    }
 
-    mIFD.addEntry("TileByteCounts");
-    mIFD.addEntry("TileOffsets");
-    for (sys::Uint32_T y = 0; y < tilesDown; ++y)
+    if (value > std::numeric_limits<sys::Uint32_T>::max())
     {
-        for (sys::Uint32_T x = 0; x < tilesAcross; ++x)
-        {
-            sys::Uint32_T byteCount = tileSize * tileSize * elementSize;
-            mIFD.addEntryValue("TileOffsets", (sys::Uint32_T) fileOffset);
-            mIFD.addEntryValue("TileByteCounts", (sys::Uint32_T) byteCount);
-            fileOffset += byteCount;
-        }
+        throw except::Exception(Ctxt(
+                "Image data is past the 4 GB limit of TIFF; use BigTIFF"));
     }
+    const auto value32 = static_cast<sys::Uint32_T>(value);
+    entry->addValue(tiff::TypeFactory::create(
+            (unsigned char *)&value32, tiff::Const::Type::LONG));
+}
 
-    mTileOffsets = mIFD["TileOffsets"];
-    mTileWidth = mIFD["TileWidth"];
-    mTileLength = mIFD["TileLength"];
-    mTileByteCounts = mIFD["TileByteCounts"];
+void tiff::ImageWriter::initTiles()
+{
+    if (mTileWidth == 0 || mTileLength == 0)
+    {
+        sys::Uint32_T root = (sys::Uint32_T)sqrt((double)mIdealChunkSize
+                / (double)mIFD.getElementSize());
+        sys::Uint32_T ceiling = (sys::Uint32_T)ceil(((double)root) / 16);
+        mTileWidth = mTileLength = ceiling * 16;
+    }
+    if (mTileWidth % 16 || mTileLength % 16)
+        throw except::Exception(Ctxt("Tile sizes must be multiples of 16"));
+
+    mIFD.addEntry("TileWidth", (sys::Uint32_T) mTileWidth);
+    mIFD.addEntry("TileLength", (sys::Uint32_T) mTileLength);
+
+    sys::Uint64_T fileOffset = mDataOffset;
+    const sys::Uint64_T tilesAcross =
+            (mIFD.getImageWidth() + mTileWidth - 1) / mTileWidth;
+    const sys::Uint64_T tilesDown =
+            (mIFD.getImageLength() + mTileLength - 1) / mTileLength;
+    const sys::Uint64_T byteCount = static_cast<sys::Uint64_T>(mTileWidth)
+            * mTileLength * mIFD.getElementSize();
+
+    // Every tile is full size, so they're laid out one after another.
+    tiff::IFDEntry* const tileByteCounts = addOffsetEntry("TileByteCounts");
+    tiff::IFDEntry* const tileOffsets = addOffsetEntry("TileOffsets");
+    mTileOffsets.clear();
+    for (sys::Uint64_T tile = 0; tile < tilesAcross * tilesDown; ++tile)
+    {
+        addOffsetValue(tileOffsets, fileOffset);
+        addOffsetValue(tileByteCounts, byteCount);
+        mTileOffsets.push_back(fileOffset);
+        fileOffset += byteCount;
+    }
+    mDataEnd = fileOffset;
 }
 
 void tiff::ImageWriter::initStrips()
 {
-    sys::Uint32_T bytesPerLine = mIFD.getImageWidth() * mIFD.getElementSize();
+    const sys::Uint64_T bytesPerLine =
+            static_cast<sys::Uint64_T>(mIFD.getImageWidth()) * mIFD.getElementSize();
 
-    sys::Uint32_T stripByteCount = 0;
+    sys::Uint64_T stripByteCount = 0;
     sys::Uint32_T rowsPerStrip = 1;
     if (bytesPerLine > mIdealChunkSize)
         stripByteCount = bytesPerLine;
     else
     {
-        rowsPerStrip = (mIdealChunkSize + (mIdealChunkSize >> 1))
-                / bytesPerLine;
+        rowsPerStrip = static_cast<sys::Uint32_T>(
+                (mIdealChunkSize + (mIdealChunkSize >> 1)) / bytesPerLine);
         stripByteCount = bytesPerLine * rowsPerStrip;
     }
 
     mIFD.addEntry("RowsPerStrip", rowsPerStrip);
 
-    sys::Uint32_T length = mIFD.getImageLength();
-    sys::Uint32_T stripsPerImage =
-            (sys::Uint32_T)floor(static_cast<double>(length + rowsPerStrip - 1)
-                    / static_cast<double>(rowsPerStrip));
+    const sys::Uint64_T length = mIFD.getImageLength();
+    const sys::Uint64_T stripsPerImage =
+            (length + rowsPerStrip - 1) / rowsPerStrip;
 
-    auto offset = mOutput->tell();
+    sys::Uint64_T offset = mDataOffset;
+    mDataEnd = mDataOffset + mIFD.getImageSize();
 
     // Add counts and offsets for all but the last strip.
-    mIFD.addEntry("StripOffsets");
-    mIFD.addEntry("StripByteCounts");
-    for (sys::Uint32_T i = 0; i < stripsPerImage - 1; ++i)
+    tiff::IFDEntry* const stripOffsets = addOffsetEntry("StripOffsets");
+    tiff::IFDEntry* const stripByteCounts = addOffsetEntry("StripByteCounts");
+    for (sys::Uint64_T i = 0; i < stripsPerImage - 1; ++i)
     {
-        mIFD.addEntryValue("StripOffsets", (sys::Uint32_T) offset);
-        mIFD.addEntryValue("StripByteCounts", (sys::Uint32_T) stripByteCount);
+        addOffsetValue(stripOffsets, offset);
+        addOffsetValue(stripByteCounts, stripByteCount);
         offset += stripByteCount;
     }
 
     // Add the last offset.
-    mIFD.addEntryValue("StripOffsets", (sys::Uint32_T) offset);
+    addOffsetValue(stripOffsets, offset);
 
     // The last byte count can be less than the previous counts.  This occurs
     // (for example) if RowsPerStrip is even, and ImageLength is odd.
-    sys::Uint32_T remainingBytes = mIFD.getImageSize() - ((stripsPerImage - 1)
+    const sys::Uint64_T remainingBytes = mIFD.getImageSize() - ((stripsPerImage - 1)
             * stripByteCount);
 
     // Add the last byteCount.
-    mIFD.addEntryValue("StripByteCounts", remainingBytes);
-    mStripByteCounts = mIFD["StripByteCounts"];
+    addOffsetValue(stripByteCounts, remainingBytes);
 }
 
 void tiff::ImageWriter::putTileData(const unsigned char *buffer,
                                     sys::Uint32_T numElementsToWrite)
 {
-    sys::Uint32_T imageElemWidth = mIFD.getImageWidth();
-    sys::Uint32_T imageByteWidth = imageElemWidth * mElementSize;
-
-    sys::Uint32_T tileElemWidth = *(tiff::GenericType<sys::Uint32_T> *)(*mTileWidth)[0];
-    sys::Uint32_T tileByteWidth = tileElemWidth * mElementSize;
-
-    const auto tileElemLength = *(tiff::GenericType<sys::Uint32_T> *)(*mTileLength)[0];
-
-    // Compute the number of tiles wide the image is.
-    sys::Uint32_T tilesAcross = (imageElemWidth + tileElemWidth - 1)
-            / tileElemWidth;
-
-    // Determine how many bytes were used to pad the right edge.
-    sys::Uint32_T widthPadding = (tileByteWidth * tilesAcross) - imageByteWidth;
-    sys::Uint32_T globalReadOffset = 0;
-    sys::Uint32_T tempBytePosition = mBytePosition;
-    sys::Uint32_T numBytesToWrite = numElementsToWrite * mElementSize;
-    sys::Uint32_T currentNumBytesRead = 0;
-    sys::Uint32_T remainingElementsToWrite = numElementsToWrite;
-    while (remainingElementsToWrite)
+    const sys::Uint64_T imageSize = mIFD.getImageSize();
+    const sys::Uint64_T lineBytes =
+            static_cast<sys::Uint64_T>(mIFD.getImageWidth()) * mElementSize;
+    const sys::Uint64_T tileRowBytes = lineBytes * mTileLength;
+    mTileRowBuffer.resize(static_cast<size_t>(tileRowBytes));
+
+    sys::Uint64_T numBytesToWrite =
+            static_cast<sys::Uint64_T>(numElementsToWrite) * mElementSize;
+    if (mBytePosition + numBytesToWrite > imageSize)
+        throw except::Exception(Ctxt("Write past the end of the image"));
+
+    while (numBytesToWrite)
     {
-        if (((mBytePosition + currentNumBytesRead) / imageByteWidth)
-                / tileElemLength > (tempBytePosition / imageByteWidth)
-                / tileElemLength)
-        {
-            tempBytePosition = mBytePosition + currentNumBytesRead;
-            globalReadOffset = currentNumBytesRead;
-        }
-
-        // Compute the row and tile row.
-        sys::Uint32_T row = tempBytePosition / imageByteWidth;
-        sys::Uint32_T tileRow = row / tileElemLength;
-
-        // Compute the column and tile column.
-        sys::Uint32_T column = tempBytePosition - (row * imageByteWidth);
-        sys::Uint32_T tileColumn = column / tileByteWidth;
-
-        // Compute the 1D tile index from the tile row and tile column.
-        sys::Uint32_T tileIndex = (tileRow * tilesAcross) + tileColumn;
-
-        sys::Uint32_T tileByteCount = *(tiff::GenericType<sys::Uint32_T> *)(*mTileByteCounts)[tileIndex];
-
-        sys::Uint32_T rowInTile = row % tileElemLength;
-        sys::Uint32_T paddedBytes = ((tileColumn + 1) / tilesAcross)
-                * widthPadding;
-
-        sys::Uint32_T remainingBytesInTile = tileByteCount - (tileElemLength
-                * paddedBytes) - (rowInTile * (tileByteWidth - paddedBytes)
-                + (column % tileByteWidth));
-
-        tempBytePosition += tileByteWidth - (paddedBytes + (column
-                % tileByteWidth));
-
-        sys::byte *copyBuffer = new sys::byte[tileByteWidth * tileElemLength];
-        memset(copyBuffer, 0, tileByteWidth * tileElemLength);
-        sys::Uint32_T copyOffset = 0;
-        sys::Uint32_T readOffset = 0;
-        sys::Uint32_T tempColumn = column;
-        unsigned short iteration = 0;
-        while (readOffset < numBytesToWrite)
-        {
-            sys::Uint32_T remainingBytesThisLine = tileByteWidth - (paddedBytes
-                    + (tempColumn % tileByteWidth));
-
-            sys::Uint32_T numBytesToCopy = remainingBytesThisLine;
-
-            if (!remainingBytesInTile)
-                break;
-
-            if (iteration == 0)
-            {
-                iteration++;
-                readOffset = globalReadOffset;
-                globalReadOffset += numBytesToCopy;
-            }
-
-            if (numBytesToCopy > numBytesToWrite - readOffset)
-                numBytesToCopy = numBytesToWrite - readOffset;
-
-            if (paddedBytes)
-            {
-                if (((tempColumn % tileByteWidth) + numBytesToCopy)
-                        / (tileByteWidth - paddedBytes) == 0)
-                    paddedBytes = 0;
-            }
-
-            memcpy(copyBuffer + copyOffset, buffer + readOffset, numBytesToCopy);
-            copyOffset += (numBytesToCopy + paddedBytes);
-            readOffset += (imageByteWidth - (tempColumn % tileByteWidth));
-            tempColumn -= (tempColumn % tileByteWidth);
-            remainingBytesInTile -= numBytesToCopy;
-            remainingElementsToWrite -= (numBytesToCopy / mElementSize);
-            currentNumBytesRead += numBytesToCopy;
-        }
-
-        sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[tileIndex];
-        seekPos += (row % tileElemLength) * tileByteWidth;
-        seekPos += (column % tileByteWidth);
-        mOutput->seek(seekPos, io::Seekable::START);
-        mOutput->write(copyBuffer, copyOffset);
-        delete [] copyBuffer;
+        // Buffer lines until the row of tiles is complete
+        const sys::Uint64_T tileRow = mBytePosition / tileRowBytes;
+        const sys::Uint64_T position = mBytePosition % tileRowBytes;
+        const sys::Uint64_T numBytes =
+                std::min(numBytesToWrite, tileRowBytes - position);
+        memcpy(mTileRowBuffer.data() + position, buffer,
+               static_cast<size_t>(numBytes));
+
+        buffer += numBytes;
+        numBytesToWrite -= numBytes;
+        mBytePosition += numBytes;
+
+        if (position + numBytes == tileRowBytes)
+            writeTileRow(tileRow, mTileLength);
+        else if (mBytePosition == imageSize)
+            writeTileRow(tileRow, (position + numBytes) / lineBytes);
     }
+}
 
-    mBytePosition += numBytesToWrite;
-
-    // All of the real data is in, just have to pad the bottom of the file.
-    if (mBytePosition == mIFD.getImageSize())
+void tiff::ImageWriter::writeTileRow(sys::Uint64_T tileRow,
+                                     sys::Uint64_T numLines)
+{
+    const sys::Uint64_T lineBytes =
+            static_cast<sys::Uint64_T>(mIFD.getImageWidth()) * mElementSize;
+    const sys::Uint64_T tileLineBytes =
+            static_cast<sys::Uint64_T>(mTileWidth) * mElementSize;
+    const sys::Uint64_T tilesAcross = (lineBytes + tileLineBytes - 1)
+            / tileLineBytes;
+
+    std::vector<sys::byte> tile(static_cast<size_t>(tileLineBytes * mTileLength));
+    for (sys::Uint64_T tileCol = 0; tileCol < tilesAcross; ++tileCol)
     {
-        sys::Uint32_T imageElemLength = mIFD.getImageLength();
-        sys::Uint32_T tilesDown = (imageElemLength + tileElemLength - 1)
-                / tileElemLength;
-        sys::Uint32_T startIndex = (tilesDown - 1) * tilesAcross;
-        sys::Uint32_T paddingStartLine = imageElemLength % tileElemLength;
-        if (paddingStartLine)
-        {
-            sys::Uint32_T paddedLines = tileElemLength - paddingStartLine;
-
-            sys::byte *padBuffer = new sys::byte[paddedLines * tileByteWidth];
-            memset(padBuffer, 0, paddedLines * tileByteWidth);
-
-            for (sys::Uint32_T i = 0; i < tilesAcross; ++i)
-            {
-                sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[startIndex + i];
-                seekPos += paddingStartLine * tileByteWidth;
-                mOutput->seek(seekPos, io::Seekable::START);
-                mOutput->write(padBuffer, paddedLines * tileByteWidth);
-            }
-
-            delete [] padBuffer;
-        }
+        // The last tile across is only partly in the image
+        const sys::Uint64_T start = tileCol * tileLineBytes;
+        const size_t numBytes = static_cast<size_t>(
+                std::min(tileLineBytes, lineBytes - start));
 
-        // If no padding, seek the end of the image.  This is so that 
-        // when the IFD is written, it doesn't try to write it into the
-        // middle of the file.  This is a patch and a better solution
-        // should probably be found.
-        else
+        std::fill(tile.begin(), tile.end(), static_cast<sys::byte>(0));
+        for (sys::Uint64_T line = 0; line < numLines; ++line)
         {
-            auto lastTileIndex = static_cast<sys::Uint32_T>(mTileOffsets->getValues().size() - 1);
-            sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[lastTileIndex];
-            seekPos += *(tiff::GenericType<sys::Uint32_T> *)(*mTileByteCounts)[lastTileIndex];
-            mOutput->seek(seekPos, io::Seekable::START);
+            memcpy(&tile[static_cast<size_t>(line * tileLineBytes)],
+                   &mTileRowBuffer[static_cast<size_t>(line * lineBytes + start)],
+                   numBytes);
         }
+
+        const size_t tileIndex = static_cast<size_t>(tileRow * tilesAcross + tileCol);
+        mOutput->seek(static_cast<sys::Off_T>(mTileOffsets[tileIndex]),
+                      io::Seekable::START);
+        mOutput->write(tile.data(), tile.size());
     }
 }
 
 void tiff::ImageWriter::putStripData(const unsigned char *buffer,
                                      sys::Uint32_T numElementsToWrite)
 {
-    sys::Uint32_T stripSize = *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[0];
-    sys::Uint32_T bufferIndex = 0;
-
-    while (numElementsToWrite)
-    {
-        sys::Uint32_T bytesToWrite = mElementSize * numElementsToWrite;
-        sys::Uint32_T stripIndex = mBytePosition / stripSize;
-        sys::Uint32_T stripPosition = mBytePosition % stripSize;
-
-        // Calculate what remains to be written in the current strip.
-        sys::Uint32_T remainingBytesInStrip =
-                (*(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[stripIndex]) - stripPosition;
-
-        if (bytesToWrite > remainingBytesInStrip)
-            bytesToWrite = remainingBytesInStrip;
-
-        mOutput->write((sys::byte *)buffer + bufferIndex, bytesToWrite);
-        bufferIndex += bytesToWrite;
-
-        numElementsToWrite -= (bytesToWrite / mElementSize);
-        mBytePosition += bytesToWrite;
-    }
+    // Strips are contiguous, so the data is written as it comes.  Other
+    // images may have been written to in between.
+    const sys::Uint64_T numBytesToWrite =
+            static_cast<sys::Uint64_T>(numElementsToWrite) * mElementSize;
+    if (mBytePosition + numBytesToWrite > mIFD.getImageSize())
+        throw except::Exception(Ctxt("Write past the end of the image"));
+
+    mOutput->seek(static_cast<sys::Off_T>(mDataOffset + mBytePosition),
+                  io::Seekable::START);
+    mOutput->write((sys::byte *)buffer, static_cast<size_t>(numBytesToWrite));
+    mBytePosition += numBytesToWrite;
 }
@@ -50,13 +50,13 @@ void tiff::FileReader::openFile(const std::string& fileName)
     mHeader.deserialize(mInput);
     
     mReverseBytes = mHeader.isDifferentByteOrdering();
-    sys::Uint32_T offset = mHeader.getIFDOffset();
+    sys::Uint64_T offset = mHeader.getIFDOffset();
     while (offset != 0)
     {
         tiff::ImageReader *imageReader = new tiff::ImageReader(&mInput);
 
-        mInput.seek(offset, io::Seekable::START);
-        imageReader->process(mReverseBytes);
+        mInput.seek(static_cast<sys::Off_T>(offset), io::Seekable::START);
+        imageReader->process(mReverseBytes, mHeader.isBigTIFF());
         mImages.push_back(imageReader);
 
         offset = imageReader->getNextOffset();
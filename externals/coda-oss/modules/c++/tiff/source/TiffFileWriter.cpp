@@ -92,21 +92,25 @@ void tiff::FileWriter::putData(const unsigned char *buffer,
 
 tiff::ImageWriter *tiff::FileWriter::addImage()
 {
-    if (!mImages.empty())
-        mIFDOffset = mImages.back()->getNextIFDOffset();
-
-    auto image = coda_oss::make_unique<tiff::ImageWriter>(&mOutput, mIFDOffset);
+    // Images after the first link from the image before them when their
+    // IFDs are written, so more than one can be in progress at a time.
+    const tiff::ImageWriter* const previous =
+            mImages.empty() ? nullptr : mImages.back();
+    auto image = coda_oss::make_unique<tiff::ImageWriter>(&mOutput, mIFDOffset,
+                                                          mHeader.isBigTIFF(),
+                                                          previous);
     mImages.push_back(image.get());
     tiff::ImageWriter* const writer = image.release();
 
     return writer;
 }
 
-void tiff::FileWriter::writeHeader()
+void tiff::FileWriter::writeHeader(bool bigTIFF)
 {
+    mHeader = bigTIFF ? tiff::Header(tiff::Header::BIG_TIFF_ID) : tiff::Header();
     mHeader.serialize(mOutput);
 
     // Have to rewind a few bytes to write out the actual IFD offset.
-    mIFDOffset = static_cast <sys::Uint32_T>(mOutput.tell());
-    mIFDOffset -= (int)sizeof(sys::Uint32_T);
+    mIFDOffset = static_cast <sys::Uint64_T>(mOutput.tell());
+    mIFDOffset -= mHeader.getOffsetSize();
 }
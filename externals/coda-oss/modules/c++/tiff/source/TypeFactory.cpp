@@ -69,6 +69,16 @@ tiff::TypeInterface *tiff::TypeFactory::create(const unsigned char *data,
     case tiff::Const::Type::DOUBLE:
         tiffType = new tiff::GenericType<double>(data);
         break;
+    case tiff::Const::Type::IFD:
+        tiffType = new tiff::GenericType<sys::Uint32_T>(data);
+        break;
+    case tiff::Const::Type::LONG8:
+    case tiff::Const::Type::IFD8:
+        tiffType = new tiff::GenericType<sys::Uint64_T>(data);
+        break;
+    case tiff::Const::Type::SLONG8:
+        tiffType = new tiff::GenericType<sys::Int64_T>(data);
+        break;
     default:
         throw except::Exception(Ctxt("Unsupported Type"));
     }
@@ -0,0 +1,281 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <io/ByteStream.h>
+#include <io/TempFile.h>
+#include <tiff/Header.h>
+#include <tiff/TiffFileReader.h>
+#include <tiff/TiffFileWriter.h>
+#include "TestCase.h"
+
+namespace
+{
+const sys::Uint32_T NUM_ROWS = 45;
+const sys::Uint32_T NUM_COLS = 70;
+
+std::vector<unsigned short> makePixels(sys::Uint32_T numRows,
+                                       sys::Uint32_T numCols)
+{
+    std::vector<unsigned short> pixels(numRows * numCols);
+    for (size_t ii = 0; ii < pixels.size(); ++ii)
+    {
+        pixels[ii] = static_cast<unsigned short>(ii * 7 + 3);
+    }
+    return pixels;
+}
+
+void addImage(tiff::FileWriter& writer,
+              const std::vector<unsigned short>& pixels,
+              sys::Uint32_T numRows, sys::Uint32_T numCols,
+              bool tiled, bool reducedResolution)
+{
+    tiff::ImageWriter* const imageWriter = writer.addImage();
+    tiff::IFD* const ifd = imageWriter->getIFD();
+    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, numCols);
+    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, numRows);
+    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE, (unsigned short) 16);
+    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION,
+                  (unsigned short) tiff::Const::PhotoInterpType::BLACK_IS_ZERO);
+    if (reducedResolution)
+    {
+        ifd->addEntry("NewSubfileType", (sys::Uint32_T) 1);
+    }
+    if (tiled)
+    {
+        imageWriter->setTileSize(32, 16);
+    }
+
+    // Odd sized writes, so lines and tiles are split between them
+    const sys::Uint32_T numElements = numRows * numCols;
+    for (sys::Uint32_T ii = 0; ii < numElements; ii += 37)
+    {
+        const sys::Uint32_T count = std::min<sys::Uint32_T>(37, numElements - ii);
+        imageWriter->putData(
+                reinterpret_cast<const unsigned char*>(&pixels[ii]), count);
+    }
+    imageWriter->writeIFD();
+}
+
+void writeFile(const std::string& pathname,
+               const std::vector<unsigned short>& pixels,
+               bool bigTIFF, bool tiled)
+{
+    tiff::FileWriter writer(pathname);
+    writer.writeHeader(bigTIFF);
+    addImage(writer, pixels, NUM_ROWS, NUM_COLS, tiled, false);
+    writer.close();
+}
+
+void checkRegion(const std::string& testName,
+                 tiff::ImageReader& reader,
+                 const std::vector<unsigned short>& pixels,
+                 sys::Uint32_T startRow, sys::Uint32_T numRows,
+                 sys::Uint32_T startCol, sys::Uint32_T numCols)
+{
+    std::vector<unsigned short> region(numRows * numCols);
+    reader.getRegion(reinterpret_cast<unsigned char*>(region.data()),
+                     startRow, numRows, startCol, numCols);
+    for (sys::Uint32_T row = 0; row < numRows; ++row)
+    {
+        for (sys::Uint32_T col = 0; col < numCols; ++col)
+        {
+            TEST_ASSERT_EQ(region[row * numCols + col],
+                           pixels[(startRow + row) * NUM_COLS + startCol + col]);
+        }
+    }
+}
+
+void checkFile(const std::string& testName, bool bigTIFF, bool tiled)
+{
+    const io::TempFile tempFile;
+    const std::vector<unsigned short> pixels = makePixels(NUM_ROWS, NUM_COLS);
+    writeFile(tempFile.pathname(), pixels, bigTIFF, tiled);
+
+    tiff::FileReader reader(tempFile.pathname());
+    TEST_ASSERT_EQ(reader.isBigTIFF(), bigTIFF);
+    TEST_ASSERT_EQ(reader.getImageCount(), static_cast<sys::Uint32_T>(1));
+    tiff::ImageReader& imageReader = *reader[0];
+    TEST_ASSERT_EQ(imageReader.isTiled(), tiled);
+    TEST_ASSERT(!imageReader.isReducedResolution());
+
+    // Sequential reads, split across lines
+    std::vector<unsigned short> image(pixels.size());
+    imageReader.getData(reinterpret_cast<unsigned char*>(image.data()), 50);
+    imageReader.getData(reinterpret_cast<unsigned char*>(&image[50]),
+                        static_cast<sys::Uint32_T>(image.size() - 50));
+    TEST_ASSERT(image == pixels);
+
+    // Regions inside one tile, across tiles and at the edges
+    checkRegion(testName, imageReader, pixels, 0, NUM_ROWS, 0, NUM_COLS);
+    checkRegion(testName, imageReader, pixels, 3, 5, 4, 9);
+    checkRegion(testName, imageReader, pixels, 10, 20, 25, 40);
+    checkRegion(testName, imageReader, pixels, NUM_ROWS - 1, 1, 0, NUM_COLS);
+    checkRegion(testName, imageReader, pixels, 30, 15, 64, 6);
+
+    TEST_EXCEPTION(imageReader.getRegion(
+            reinterpret_cast<unsigned char*>(image.data()), 40, 6, 0, 1));
+}
+}
+
+TEST_CASE(testHeader)
+{
+    for (const auto id : { tiff::Header::TIFF_ID, tiff::Header::BIG_TIFF_ID })
+    {
+        tiff::Header header(static_cast<unsigned short>(id), "  ", 1234);
+        io::ByteStream stream;
+        header.serialize(stream);
+        TEST_ASSERT_EQ(stream.tell(),
+                       static_cast<sys::Off_T>(id == tiff::Header::BIG_TIFF_ID ? 16 : 8));
+        stream.seek(0, io::Seekable::START);
+
+        tiff::Header readHeader;
+        readHeader.deserialize(stream);
+        TEST_ASSERT_EQ(readHeader.isBigTIFF(), id == tiff::Header::BIG_TIFF_ID);
+        TEST_ASSERT_EQ(readHeader.getIFDOffset(), static_cast<sys::Uint64_T>(1234));
+        TEST_ASSERT_EQ(readHeader.getOffsetSize(), header.getOffsetSize());
+    }
+}
+
+TEST_CASE(testStripped)
+{
+    checkFile(testName, false, false);
+}
+
+TEST_CASE(testTiled)
+{
+    checkFile(testName, false, true);
+}
+
+TEST_CASE(testBigTIFFStripped)
+{
+    checkFile(testName, true, false);
+}
+
+TEST_CASE(testBigTIFFTiled)
+{
+    checkFile(testName, true, true);
+}
+
+TEST_CASE(testReducedResolution)
+{
+    const io::TempFile tempFile;
+    const std::vector<unsigned short> pixels = makePixels(NUM_ROWS, NUM_COLS);
+    const std::vector<unsigned short> overview = makePixels(23, 35);
+    {
+        tiff::FileWriter writer(tempFile.pathname());
+        writer.writeHeader(true);
+        addImage(writer, pixels, NUM_ROWS, NUM_COLS, true, false);
+        addImage(writer, overview, 23, 35, true, true);
+        writer.close();
+    }
+
+    tiff::FileReader reader(tempFile.pathname());
+    TEST_ASSERT_EQ(reader.getImageCount(), static_cast<sys::Uint32_T>(2));
+    TEST_ASSERT(!reader[0]->isReducedResolution());
+    TEST_ASSERT(reader[1]->isReducedResolution());
+    TEST_ASSERT_EQ(reader[1]->getIFD()->getImageWidth(),
+                   static_cast<sys::Uint32_T>(35));
+
+    std::vector<unsigned short> image(overview.size());
+    reader[1]->getRegion(reinterpret_cast<unsigned char*>(image.data()),
+                         0, 23, 0, 35);
+    TEST_ASSERT(image == overview);
+}
+
+TEST_CASE(testSideBySide)
+{
+    // An image and its overview written a line at a time, in turns, with
+    // their IFDs written once all of the data is in
+    for (int tiled = 0; tiled < 2; ++tiled)
+    {
+        const io::TempFile tempFile;
+        const std::vector<unsigned short> pixels =
+                makePixels(NUM_ROWS, NUM_COLS);
+        const std::vector<unsigned short> overview = makePixels(23, 35);
+        {
+            tiff::FileWriter writer(tempFile.pathname());
+            writer.writeHeader();
+            tiff::ImageWriter* const imageWriters[] = {
+                    writer.addImage(), writer.addImage() };
+            const sys::Uint32_T numRows[] = { NUM_ROWS, 23 };
+            const sys::Uint32_T numCols[] = { NUM_COLS, 35 };
+            for (size_t ii = 0; ii < 2; ++ii)
+            {
+                tiff::IFD* const ifd = imageWriters[ii]->getIFD();
+                ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, numCols[ii]);
+                ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, numRows[ii]);
+                ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE,
+                              (unsigned short) 16);
+                ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION,
+                              (unsigned short) tiff::Const::PhotoInterpType::BLACK_IS_ZERO);
+                if (tiled)
+                {
+                    imageWriters[ii]->setTileSize(32, 16);
+                }
+            }
+            imageWriters[1]->setDataOffset(imageWriters[0]->getDataEnd());
+
+            // The overview's IFD links from the image's
+            TEST_EXCEPTION(imageWriters[1]->writeIFD());
+
+            for (sys::Uint32_T row = 0; row < NUM_ROWS; ++row)
+            {
+                imageWriters[0]->putData(reinterpret_cast<const unsigned char*>(
+                        &pixels[row * NUM_COLS]), NUM_COLS);
+                if (row % 2 == 0)
+                {
+                    imageWriters[1]->putData(
+                            reinterpret_cast<const unsigned char*>(
+                                    &overview[row / 2 * 35]), 35);
+                }
+            }
+            imageWriters[0]->writeIFD();
+            imageWriters[1]->writeIFD();
+            writer.close();
+        }
+
+        tiff::FileReader reader(tempFile.pathname());
+        TEST_ASSERT_EQ(reader.getImageCount(), static_cast<sys::Uint32_T>(2));
+        std::vector<unsigned short> image(pixels.size());
+        reader[0]->getData(reinterpret_cast<unsigned char*>(image.data()),
+                           static_cast<sys::Uint32_T>(image.size()));
+        TEST_ASSERT(image == pixels);
+
+        image.resize(overview.size());
+        reader[1]->getRegion(reinterpret_cast<unsigned char*>(image.data()),
+                             0, 23, 0, 35);
+        TEST_ASSERT(image == overview);
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testHeader);
+    TEST_CHECK(testStripped);
+    TEST_CHECK(testTiled);
+    TEST_CHECK(testBigTIFFStripped);
+    TEST_CHECK(testBigTIFFTiled);
+    TEST_CHECK(testReducedResolution);
+    TEST_CHECK(testSideBySide);
+    )
@@ -32,6 +32,7 @@
 
 #include "nitf/coda-oss.hpp"
 
+#include "nitf/AsyncIO.hpp"
 #include "nitf/BandInfo.hpp"
 #include "nitf/BandSource.hpp"
 #include "nitf/BlockingInfo.hpp"
@@ -39,6 +40,7 @@
 #include "nitf/BufferedWriter.hpp"
 #include "nitf/ByteProvider.hpp"
 #include "nitf/ComponentInfo.hpp"
+#include "nitf/CompressedBlockSpill.hpp"
 #include "nitf/CompressedByteProvider.hpp"
 #include "nitf/DataSource.hpp"
 #include "nitf/DateTime.hpp"
@@ -69,6 +71,7 @@
 #include "nitf/LabelSubheader.hpp"
 #include "nitf/List.hpp"
 #include "nitf/LookupTable.hpp"
+#include "nitf/MMapIO.hpp"
 #include "nitf/MemoryIO.hpp"
 #include "nitf/NITFBufferList.hpp"
 #include "nitf/NITFException.hpp"
@@ -0,0 +1,68 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __NITF_ASYNC_IO_HPP__
+#define __NITF_ASYNC_IO_HPP__
+
+#include <stdint.h>
+
+#include <string>
+
+#include "nitf/NITFException.hpp"
+#include "nitf/System.hpp"
+#include "nitf/IOInterface.hpp"
+
+/*!
+ * \file AsyncIO.hpp
+ * \brief Contains wrapper implementation for AsyncIOAdapter
+ */
+
+namespace nitf
+{
+
+/*!
+ *  \class AsyncIO
+ *  \brief The C++ wrapper of the nitf_AsyncIOAdapter
+ *
+ *  A read-only IOInterface that reads batches concurrently.  ImageReader
+ *  hands it every read for a sub-window of an uncompressed image at once,
+ *  so on storage that services requests in parallel (SSDs, network file
+ *  systems) the reads overlap instead of waiting on each other.
+ */
+class AsyncIO : public IOInterface
+{
+public:
+    /*!
+     *  \param pathname File to read
+     *  \param numThreads Number of reads to have in flight at once; 0 for
+     *  NITF_ASYNC_IO_DEFAULT_THREADS
+     */
+    explicit AsyncIO(const std::string& pathname, uint32_t numThreads = 0);
+
+private:
+    static
+    nitf_IOInterface* create(const std::string& pathname,
+                             uint32_t numThreads);
+};
+
+}
+#endif
@@ -29,6 +29,8 @@
 #include <std/span>
 #include <std/cstddef>
 
+#include <types/Range.h>
+
 #include <nitf/coda-oss.hpp>
 #include <nitf/System.hpp>
 #include <nitf/Record.hpp>
@@ -239,6 +241,40 @@ struct NITRO_NITFCPP_API ByteProvider
                           nitf::Off& fileOffset,
                           NITFBufferList& buffers) const;
 
+    //! One AOI for the batch form of getBytes()
+    struct RowRange final
+    {
+        //! The pixels, as for the single AOI form of getBytes()
+        const void* imageData = nullptr;
+
+        //! The global start row
+        size_t startRow = 0;
+
+        size_t numRows = 0;
+    };
+
+    /*!
+     * Calls getBytes() for each AOI.  The buffer lists are reused from call
+     * to call, so a caller that keeps the output vectors around doesn't
+     * allocate once they've grown to size.  Like the single AOI form, this
+     * is const and may be called from several threads at once (each with
+     * its own outputs).
+     *
+     * \param rowRanges The AOIs.  These are independent of each other.
+     * \param[out] fileOffsets The file offset for each AOI
+     * \param[out] buffers The buffers for each AOI
+     */
+    void getBytes(const std::vector<RowRange>& rowRanges,
+                  std::vector<nitf::Off>& fileOffsets,
+                  std::vector<NITFBufferList>& buffers) const;
+
+    /*!
+     * \param row A global row
+     *
+     * \return The image segment containing it
+     */
+    size_t getSegment(size_t row) const;
+
     /*!
      * \return ImageBlocker with settings in sync with how the image will be
      * blocked in the NITF
@@ -321,6 +357,12 @@ protected:
                        size_t startGlobalRowToWrite,
                        size_t numRowsToWrite) const;
 
+    /*!
+     * \return The image segments [startRow, startRow + numRows) overlaps,
+     * found by a binary search of the segment index
+     */
+    types::Range findSegments(size_t startRow, size_t numRows) const noexcept;
+
     void initializeImpl(
             const Record& record,
             const std::vector<PtrAndLength>& desData,
@@ -366,6 +408,10 @@ protected:
 
     std::vector<SegmentInfo> mImageSegmentInfo; // Per segment
 
+    // Segment index: the end row of each segment, built once the layout is
+    // known and never changed after
+    std::vector<size_t> mSegmentEndRows; // Per segment
+
     std::vector<sys::byte> mFileHeader;
     std::vector<std::vector<sys::byte> > mImageSubheaders; // Per segment
 
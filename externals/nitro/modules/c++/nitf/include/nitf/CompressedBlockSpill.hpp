@@ -0,0 +1,281 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __NITF_COMPRESSED_BLOCK_SPILL_HPP__
+#define __NITF_COMPRESSED_BLOCK_SPILL_HPP__
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <types/Range.h>
+
+#include <nitf/coda-oss.hpp>
+#include <nitf/ByteProvider.hpp>
+#include <nitf/IOHandle.hpp>
+#include <nitf/Record.hpp>
+#include <nitf/System.hpp>
+
+/*!
+ * \file CompressedBlockSpill.hpp
+ * \brief Writes a compressed NITF from several workers without compressing
+ * anything twice
+ *
+ * CompressedByteProvider can't place a single byte until it knows the
+ * compressed size of every block.  When the image is compressed by several
+ * workers (threads, processes or cluster nodes) the write is done in two
+ * phases:
+ *
+ * 1. Each worker is given rows of the image on block boundaries (see
+ *    CompressedWriteLayout::partitionRows()).  It compresses its blocks,
+ *    appending each to a local CompressedBlockSpill, and sends the spill's
+ *    CompressedSpillManifest (a few numbers per block) to the coordinator.
+ * 2. The coordinator merges the manifests with
+ *    CompressedWriteLayout::getBytesPerBlock(), which is exactly what a
+ *    CompressedByteProvider (or six's CompressedSIDDByteProvider) needs,
+ *    and creates the output file with CompressedWriteLayout::createFile().
+ *    The block sizes go back to the workers, each of which builds the same
+ *    provider from the same record and calls
+ *    CompressedBlockSpill::writeToFile() to copy its bytes, plus whichever
+ *    headers fall in its rows, into the file at their final offsets.
+ *
+ * The workers' writes don't overlap, so they can run at the same time as
+ * long as each opens the output file itself.
+ */
+
+namespace nitf
+{
+/*!
+ * \struct CompressedSpillManifest
+ * \brief What a worker reports after compressing its rows
+ */
+struct NITRO_NITFCPP_API CompressedSpillManifest final
+{
+    //! First global row the worker compressed
+    size_t startRow = 0;
+
+    //! Number of rows the worker compressed
+    size_t numRows = 0;
+
+    /*!
+     * Compressed size of each block in the rows, in bytes, in the order
+     * they were added to the spill (segment by segment, then row-major
+     * within each segment)
+     */
+    std::vector<size_t> bytesPerBlock;
+};
+
+/*!
+ * \class CompressedWriteLayout
+ * \brief The block layout of a compressed NITF, as CompressedByteProvider
+ * will see it
+ *
+ * This only depends on the record and the blocking, so a coordinator and
+ * its workers can each construct their own.  The same restrictions as
+ * ByteProvider apply: the image segments are vertically stacked and have the
+ * same number of columns.
+ */
+class NITRO_NITFCPP_API CompressedWriteLayout final
+{
+public:
+    //! A row of blocks in one image segment
+    struct BlockRow final
+    {
+        size_t segment = 0;
+
+        //! First global row of pixels
+        size_t startRow = 0;
+
+        //! Number of rows of pixels (the last block row may be short)
+        size_t numRows = 0;
+
+        //! Index of the first block in its segment
+        size_t firstBlock = 0;
+
+        size_t numBlocks = 0;
+    };
+
+    /*!
+     * \param record Pre-populated NITF record, as it will be passed to the
+     * CompressedByteProvider
+     * \param numRowsPerBlock The number of rows per block.  Defaults to no
+     * blocking.
+     * \param numColsPerBlock The number of columns per block.  Defaults to no
+     * blocking.
+     */
+    CompressedWriteLayout(const Record& record,
+                          size_t numRowsPerBlock = 0,
+                          size_t numColsPerBlock = 0);
+
+    //! \return The total number of rows in all the image segments
+    size_t getNumRows() const noexcept
+    {
+        return mNumRows;
+    }
+
+    //! \return The number of blocks in each image segment
+    const std::vector<size_t>& getNumBlocks() const noexcept
+    {
+        return mNumBlocks;
+    }
+
+    /*!
+     * Splits the image into row ranges of roughly equal numbers of block
+     * rows, one per worker.  Every range starts on a block row.
+     *
+     * \param numParts Maximum number of ranges.  There will be fewer if the
+     * image doesn't have that many block rows.
+     *
+     * \return The ranges of global rows, in order
+     */
+    std::vector<types::Range> partitionRows(size_t numParts) const;
+
+    /*!
+     * \return The block rows making up [startRow, startRow + numRows)
+     *
+     * \throw except::Exception if the rows don't start and end on block
+     * row boundaries
+     */
+    std::vector<BlockRow> getBlockRows(size_t startRow, size_t numRows) const;
+
+    /*!
+     * Merges the workers' manifests into the block sizes for the
+     * CompressedByteProvider.
+     *
+     * \param manifests One per worker, in any order
+     *
+     * \return The compressed size of each block, per image segment
+     *
+     * \throw except::Exception if the manifests miss or overlap any rows or
+     * have the wrong number of blocks
+     */
+    std::vector<std::vector<size_t> > getBytesPerBlock(
+            const std::vector<CompressedSpillManifest>& manifests) const;
+
+    /*!
+     * Creates (or truncates) the output file at its final size, so workers
+     * can open it and write their parts in any order
+     *
+     * \param pathname Output file
+     * \param provider Provider built from the merged block sizes
+     */
+    static void createFile(const std::string& pathname,
+                           const ByteProvider& provider);
+
+private:
+    size_t findBlockRow(size_t row) const;
+
+    size_t mNumRows = 0;
+    std::vector<size_t> mNumBlocks; // Per segment
+    std::vector<BlockRow> mBlockRows; // In image order
+};
+
+/*!
+ * \class CompressedBlockSpill
+ * \brief A worker's compressed blocks, held in a local file between the two
+ * phases of the write
+ *
+ * Only one block row is held in memory at a time when copying to the
+ * output.  The spill file is removed when this is destroyed.
+ */
+class NITRO_NITFCPP_API CompressedBlockSpill final
+{
+public:
+    /*!
+     * \param layout The image's layout
+     * \param startRow First global row this worker compresses.  Must be on
+     * a block row.
+     * \param numRows Number of rows this worker compresses.  Must end on a
+     * block row or the end of an image segment.
+     * \param spillPathname Local file to hold the compressed blocks.  This is
+     * created or truncated.
+     */
+    CompressedBlockSpill(const CompressedWriteLayout& layout,
+                         size_t startRow,
+                         size_t numRows,
+                         const std::string& spillPathname);
+
+    //! Removes the spill file, ignoring any errors
+    ~CompressedBlockSpill();
+
+    CompressedBlockSpill(const CompressedBlockSpill&) = delete;
+    CompressedBlockSpill& operator=(const CompressedBlockSpill&) = delete;
+
+    /*!
+     * Appends the next compressed block.  Blocks are added in the order
+     * CompressedByteProvider expects them: segment by segment, then
+     * row-major within each segment.
+     *
+     * \param data Compressed bytes of the block
+     * \param numBytes Number of compressed bytes
+     */
+    void addBlock(const void* data, size_t numBytes);
+
+    //! \return The number of blocks the rows still need
+    size_t getNumBlocksRemaining() const noexcept
+    {
+        return mNumBlocks - mManifest.bytesPerBlock.size();
+    }
+
+    /*!
+     * Finishes the spill file.  Call this once every block is added.
+     *
+     * \return What to send to the coordinator
+     *
+     * \throw except::Exception if blocks are missing
+     */
+    const CompressedSpillManifest& getManifest();
+
+    /*!
+     * Copies the spilled blocks, and any headers and DES that fall in this
+     * worker's rows, into the output file.
+     *
+     * \param provider Provider built from the merged block sizes
+     * \param output The output file, already sized by
+     * CompressedWriteLayout::createFile().  Only this worker's bytes are
+     * written.
+     */
+    void writeToFile(const ByteProvider& provider, IOInterface& output);
+
+    /*!
+     * As above but opens the output file itself, so workers can call this
+     * concurrently
+     *
+     * \param provider Provider built from the merged block sizes
+     * \param outputPathname The output file, already sized by
+     * CompressedWriteLayout::createFile()
+     */
+    void writeToFile(const ByteProvider& provider,
+                     const std::string& outputPathname);
+
+private:
+    const std::string mSpillPathname;
+    const std::vector<CompressedWriteLayout::BlockRow> mBlockRows;
+    size_t mNumBlocks = 0;
+    std::unique_ptr<IOHandle> mSpill;
+    CompressedSpillManifest mManifest;
+    bool mFinished = false;
+};
+}
+
+#endif
@@ -143,6 +143,9 @@ struct NITRO_NITFCPP_API CompressedByteProvider : public ByteProvider
                           nitf::Off& fileOffset,
                           NITFBufferList& buffers) const override;
 
+    //! The batch form of getBytes()
+    using ByteProvider::getBytes;
+
 protected:
     /*!
      * Default constructor.  Expectation is that if an inheriting class uses
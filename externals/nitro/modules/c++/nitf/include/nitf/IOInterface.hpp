@@ -72,6 +72,12 @@ public:
 
     void read(void* buf, size_t size);
 
+    /*!
+     *  Read each request, in any order.  The file position is unspecified
+     *  afterwards.
+     */
+    void readBatch(nitf_IORequest* requests, size_t count);
+
     void write(const void* buf, size_t size);
 
     bool canSeek() const;
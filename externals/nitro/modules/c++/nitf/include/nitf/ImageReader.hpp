@@ -141,6 +141,16 @@ public:
     }
     BufferList<std::byte> read(const nitf::SubWindow& subWindow, size_t nbpp);
 
+    /*!
+     *  Get the pixels of a sub-window without copying them.  This only
+     *  works when the reader's input is a MMapIO and the pixels are stored
+     *  exactly as read() would return them; see nitf_ImageIO_readDirect.
+     *  \param  subWindow  The sub-window to read (one band)
+     *  \return The pixels, valid until the input is closed, or nullptr if
+     *          read() must be used instead
+     */
+    const uint8_t* readDirect(const nitf::SubWindow& subWindow);
+
     /*!
      *  Read a block directly from file
      *  \param blockNumber
@@ -151,6 +161,17 @@ public:
     const uint8_t* readBlock(uint32_t blockNumber, 
                                  uint64_t* blockSize);
 
+    /*!
+     *  Get a block without copying it.  This only works when the reader's
+     *  input is a MMapIO and the image is uncompressed; see
+     *  nitf_ImageIO_readBlockMapped.
+     *  \param blockNumber
+     *  \param blockSize  Returns block size
+     *  \return The block, valid until the input is closed, or nullptr if
+     *          readBlock() must be used instead
+     */
+    const uint8_t* readBlockMapped(uint32_t blockNumber, uint64_t* blockSize);
+
     //!  Set read caching
     void setReadCaching();
 
@@ -0,0 +1,75 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __NITF_MMAP_IO_HPP__
+#define __NITF_MMAP_IO_HPP__
+
+#include <string>
+
+#include "nitf/NITFException.hpp"
+#include "nitf/System.hpp"
+#include "nitf/IOInterface.hpp"
+
+/*!
+ * \file MMapIO.hpp
+ * \brief Contains wrapper implementation for MMapAdapter
+ */
+
+namespace nitf
+{
+
+/*!
+ *  \class MMapIO
+ *  \brief The C++ wrapper of the nitf_MMapAdapter
+ *
+ *  A read-only IOInterface over a memory mapped file.  ImageReader can
+ *  hand out pointers straight into the mapping (see
+ *  ImageReader::readDirect() and ImageReader::readBlockMapped()), so
+ *  uncompressed pixels that need no byte swapping are never copied.
+ */
+class MMapIO : public IOInterface
+{
+public:
+    explicit MMapIO(const std::string& pathname);
+
+    /*!
+     *  \return 'size' bytes at 'offset' in the file, valid until this is
+     *  closed.  This doesn't move the file position.
+     */
+    const void* getData(nitf::Off offset, size_t size) const;
+
+    /*!
+     *  Tell the OS how part of the file will be accessed: sequentially
+     *  for a single pass over the image, or randomly for chipping.
+     *  \param advice How the bytes will be accessed
+     *  \param offset Start of the bytes
+     *  \param size Number of bytes; 0 means through the end of the file
+     */
+    void advise(nitf_MMapAdvice advice, nitf::Off offset = 0, size_t size = 0);
+
+private:
+    static
+    nitf_IOInterface* create(const std::string& pathname);
+};
+
+}
+#endif
@@ -87,6 +87,14 @@ struct NITRO_NITFCPP_API Reader : public nitf::Object<nitf_Reader, ReaderDestruc
      */
     static nitf::Version getNITFVersion(const nitf::IOInterface& io);
 
+    /*!
+     *  Set whether extension TREs are parsed by their plug-ins on read.
+     *  If not, they're kept as raw bytes, which is much faster when only
+     *  the subheaders are needed.  DES subheader fields are always parsed.
+     *  \param parseTREs  Whether to parse extension TREs (the default)
+     */
+    void setParseTREs(bool parseTREs);
+
     /*!
      *  This is the preferred method for reading a NITF 2.1 file.
      *  \param io  The IO handle
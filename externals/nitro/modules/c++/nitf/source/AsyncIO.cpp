@@ -0,0 +1,45 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <nitf/AsyncIO.hpp>
+
+namespace nitf
+{
+nitf_IOInterface* AsyncIO::create(const std::string& pathname,
+                                  uint32_t numThreads)
+{
+    nitf_Error error{};
+    nitf_IOInterface* const ioInterface =
+            nitf_AsyncIOAdapter_open(pathname.c_str(), numThreads, &error);
+    if (!ioInterface)
+    {
+        throw nitf::NITFException(&error);
+    }
+    return ioInterface;
+}
+
+AsyncIO::AsyncIO(const std::string& pathname, uint32_t numThreads) :
+    IOInterface(create(pathname, numThreads))
+{
+    setManaged(false);
+}
+}
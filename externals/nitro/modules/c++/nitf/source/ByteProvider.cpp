@@ -98,6 +98,13 @@ void ByteProvider::initializeImpl_(const Record& record,
     getFileLayout(record, desData);
     mOverallNumRowsPerBlock = numRowsPerBlock;
 
+    // Index the segments by end row so AOIs can be placed by binary search
+    mSegmentEndRows.resize(mImageSegmentInfo.size());
+    for (size_t ii = 0; ii < mImageSegmentInfo.size(); ++ii)
+    {
+        mSegmentEndRows[ii] = mImageSegmentInfo[ii].endRow();
+    }
+
     size_t numColsWithPad = 0;
     if (numColsPerBlock != 0)
     {
@@ -396,6 +403,40 @@ mem::auto_ptr<const ImageBlocker> ByteProvider::getImageBlocker() const
     return mem::auto_ptr<const ImageBlocker>(blocker.release());
 }
 
+types::Range ByteProvider::findSegments(size_t startRow,
+                                        size_t numRows) const noexcept
+{
+    if (numRows == 0)
+    {
+        return types::Range();
+    }
+
+    // First segment ending after the start row, through the first segment
+    // ending at or after the end row
+    const auto first = std::upper_bound(mSegmentEndRows.begin(),
+                                        mSegmentEndRows.end(),
+                                        startRow);
+    auto end = std::lower_bound(first, mSegmentEndRows.end(),
+                                startRow + numRows);
+    if (end != mSegmentEndRows.end())
+    {
+        ++end;
+    }
+    return types::Range(first - mSegmentEndRows.begin(), end - first);
+}
+
+size_t ByteProvider::getSegment(size_t row) const
+{
+    const types::Range segments = findSegments(row, 1);
+    if (segments.empty())
+    {
+        std::ostringstream ostr;
+        ostr << "Row " << row << " is past the last image segment";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    return segments.mStartElement;
+}
+
 void ByteProvider::checkBlocking(size_t seg,
                                  size_t startGlobalRowToWrite,
                                  size_t numRowsToWrite) const
@@ -567,7 +608,9 @@ nitf::Off ByteProvider::getNumBytes(size_t startRow, size_t numRows) const
     nitf::Off numBytes(0);
     const size_t imageDataEndRow = startRow + numRows;
 
-    for (size_t seg = 0; seg < mImageSegmentInfo.size(); ++seg)
+    const types::Range segments = findSegments(startRow, numRows);
+    for (size_t seg = segments.mStartElement; seg < segments.endElement();
+         ++seg)
     {
         // See if we're in this segment
         const SegmentInfo& imageSegmentInfo(mImageSegmentInfo[seg]);
@@ -602,7 +645,9 @@ void ByteProvider::getBytes(const void* imageData,
     const size_t imageDataEndRow = startRow + numRows;
     size_t numPadRowsSoFar(0);
 
-    for (size_t seg = 0; seg < mImageSegmentInfo.size(); ++seg)
+    const types::Range segments = findSegments(startRow, numRows);
+    for (size_t seg = segments.mStartElement; seg < segments.endElement();
+         ++seg)
     {
         // See if we're in this segment
         const SegmentInfo& imageSegmentInfo(mImageSegmentInfo[seg]);
@@ -631,6 +676,20 @@ void ByteProvider::getBytes(const void* imageData,
 }
 }
 
+void nitf::ByteProvider::getBytes(const std::vector<RowRange>& rowRanges,
+                                  std::vector<nitf::Off>& fileOffsets,
+                                  std::vector<NITFBufferList>& buffers) const
+{
+    fileOffsets.resize(rowRanges.size());
+    buffers.resize(rowRanges.size());
+    for (size_t ii = 0; ii < rowRanges.size(); ++ii)
+    {
+        const RowRange& rowRange = rowRanges[ii];
+        getBytes(rowRange.imageData, rowRange.startRow, rowRange.numRows,
+                 fileOffsets[ii], buffers[ii]);
+    }
+}
+
 static std::span<const std::byte> make_span(const std::vector<sys::byte>& v) noexcept
 {
     const void* const pData = v.data();
@@ -0,0 +1,387 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nitf/CompressedBlockSpill.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include <except/Exception.h>
+#include <sys/OS.h>
+#include <std/cstddef>
+
+#include <nitf/ImageBlocker.hpp>
+#include <nitf/ImageSegment.hpp>
+#include <nitf/ImageSubheader.hpp>
+#include <nitf/NITFBufferList.hpp>
+
+#undef min
+#undef max
+
+namespace nitf
+{
+CompressedWriteLayout::CompressedWriteLayout(const Record& record,
+                                             size_t numRowsPerBlock,
+                                             size_t numColsPerBlock)
+{
+    const size_t numImages = record.getNumImages();
+    if (numImages == 0)
+    {
+        throw except::Exception(Ctxt("Record has no image segments"));
+    }
+
+    std::vector<size_t> numRowsPerSegment(numImages);
+    size_t numCols = 0;
+    for (size_t ii = 0; ii < numImages; ++ii)
+    {
+        nitf::ImageSegment imageSegment = record.getImages()[ii];
+        nitf::ImageSubheader subheader = imageSegment.getSubheader();
+        numRowsPerSegment[ii] = subheader.getNumRows();
+
+        const size_t segmentNumCols = subheader.getNumCols();
+        if (ii == 0)
+        {
+            numCols = segmentNumCols;
+        }
+        else if (segmentNumCols != numCols)
+        {
+            std::ostringstream ostr;
+            ostr << "First image segment had " << numCols
+                 << " columns but image segment " << ii << " has "
+                 << segmentNumCols;
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+        mNumRows += numRowsPerSegment[ii];
+    }
+
+    // Same blocking as ByteProvider: no blocking means one block per segment
+    const ImageBlocker blocker(
+            numRowsPerSegment,
+            numCols,
+            (numRowsPerBlock == 0) ? mNumRows : numRowsPerBlock,
+            (numColsPerBlock == 0) ? numCols : numColsPerBlock);
+
+    const size_t numBlocksPerRow = blocker.getNumColsOfBlocks();
+    const std::vector<size_t> rowsPerBlock = blocker.getNumRowsPerBlock();
+    mNumBlocks.resize(numImages);
+    for (size_t seg = 0; seg < numImages; ++seg)
+    {
+        const size_t numBlockRows = blocker.getNumRowsOfBlocks(seg);
+        mNumBlocks[seg] = numBlockRows * numBlocksPerRow;
+
+        for (size_t ii = 0; ii < numBlockRows; ++ii)
+        {
+            BlockRow blockRow;
+            blockRow.segment = seg;
+            blockRow.startRow = blocker.getStartRow(seg) +
+                    ii * rowsPerBlock[seg];
+            blockRow.numRows = std::min(rowsPerBlock[seg],
+                                        numRowsPerSegment[seg] -
+                                                ii * rowsPerBlock[seg]);
+            blockRow.firstBlock = ii * numBlocksPerRow;
+            blockRow.numBlocks = numBlocksPerRow;
+            mBlockRows.push_back(blockRow);
+        }
+    }
+}
+
+std::vector<types::Range>
+CompressedWriteLayout::partitionRows(size_t numParts) const
+{
+    if (numParts == 0)
+    {
+        throw except::Exception(Ctxt("Must have at least one part"));
+    }
+
+    const size_t numBlockRows = mBlockRows.size();
+    numParts = std::min(numParts, numBlockRows);
+
+    std::vector<types::Range> parts(numParts);
+    for (size_t ii = 0; ii < numParts; ++ii)
+    {
+        const BlockRow& first = mBlockRows[ii * numBlockRows / numParts];
+        const BlockRow& last =
+                mBlockRows[(ii + 1) * numBlockRows / numParts - 1];
+        parts[ii] = types::Range(first.startRow,
+                                 last.startRow + last.numRows -
+                                         first.startRow);
+    }
+    return parts;
+}
+
+size_t CompressedWriteLayout::findBlockRow(size_t row) const
+{
+    const auto next = std::upper_bound(
+            mBlockRows.begin(), mBlockRows.end(), row,
+            [](size_t lhs, const BlockRow& rhs)
+            {
+                return lhs < rhs.startRow;
+            });
+    if (row >= mNumRows || next == mBlockRows.begin() ||
+        (next - 1)->startRow != row)
+    {
+        std::ostringstream ostr;
+        ostr << "Row " << row << " is not the start of a block row (image "
+             << "has " << mNumRows << " rows)";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    return (next - 1) - mBlockRows.begin();
+}
+
+std::vector<CompressedWriteLayout::BlockRow>
+CompressedWriteLayout::getBlockRows(size_t startRow, size_t numRows) const
+{
+    if (numRows == 0)
+    {
+        throw except::Exception(Ctxt("Must have at least one row"));
+    }
+
+    const size_t endRow = startRow + numRows;
+    std::vector<BlockRow> blockRows;
+    for (size_t ii = findBlockRow(startRow);
+         ii < mBlockRows.size() && mBlockRows[ii].startRow < endRow;
+         ++ii)
+    {
+        const BlockRow& blockRow = mBlockRows[ii];
+        if (blockRow.startRow + blockRow.numRows > endRow)
+        {
+            std::ostringstream ostr;
+            ostr << "Rows [" << startRow << ", " << endRow << ") end part "
+                 << "way through the block row starting at row "
+                 << blockRow.startRow;
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+        blockRows.push_back(blockRow);
+    }
+
+    if (endRow > mNumRows)
+    {
+        std::ostringstream ostr;
+        ostr << "Rows [" << startRow << ", " << endRow << ") go past the "
+             << "end of the image (" << mNumRows << " rows)";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    return blockRows;
+}
+
+std::vector<std::vector<size_t> > CompressedWriteLayout::getBytesPerBlock(
+        const std::vector<CompressedSpillManifest>& manifests) const
+{
+    std::vector<std::vector<size_t> > bytesPerBlock(mNumBlocks.size());
+    for (size_t seg = 0; seg < mNumBlocks.size(); ++seg)
+    {
+        bytesPerBlock[seg].resize(mNumBlocks[seg]);
+    }
+
+    std::vector<bool> haveBlockRow(mBlockRows.size(), false);
+    for (const auto& manifest : manifests)
+    {
+        const std::vector<BlockRow> blockRows =
+                getBlockRows(manifest.startRow, manifest.numRows);
+
+        size_t numBlocks = 0;
+        for (const auto& blockRow : blockRows)
+        {
+            numBlocks += blockRow.numBlocks;
+        }
+        if (numBlocks != manifest.bytesPerBlock.size())
+        {
+            std::ostringstream ostr;
+            ostr << "Rows [" << manifest.startRow << ", "
+                 << (manifest.startRow + manifest.numRows) << ") have "
+                 << numBlocks << " blocks but the manifest has "
+                 << manifest.bytesPerBlock.size();
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+
+        size_t block = 0;
+        size_t index = findBlockRow(manifest.startRow);
+        for (const auto& blockRow : blockRows)
+        {
+            if (haveBlockRow[index])
+            {
+                std::ostringstream ostr;
+                ostr << "More than one manifest has the block row starting "
+                     << "at row " << blockRow.startRow;
+                throw except::Exception(Ctxt(ostr.str()));
+            }
+            haveBlockRow[index++] = true;
+
+            std::copy(manifest.bytesPerBlock.begin() + block,
+                      manifest.bytesPerBlock.begin() + block +
+                              blockRow.numBlocks,
+                      bytesPerBlock[blockRow.segment].begin() +
+                              blockRow.firstBlock);
+            block += blockRow.numBlocks;
+        }
+    }
+
+    for (size_t ii = 0; ii < mBlockRows.size(); ++ii)
+    {
+        if (!haveBlockRow[ii])
+        {
+            std::ostringstream ostr;
+            ostr << "No manifest has the block row starting at row "
+                 << mBlockRows[ii].startRow;
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+    }
+    return bytesPerBlock;
+}
+
+void CompressedWriteLayout::createFile(const std::string& pathname,
+                                       const ByteProvider& provider)
+{
+    IOHandle output(pathname, NITF_ACCESS_WRITEONLY, NITF_CREATE);
+    const nitf::Off numBytes = provider.getFileNumBytes();
+    if (numBytes > 0)
+    {
+        const char zero = 0;
+        output.seek(numBytes - 1, NITF_SEEK_SET);
+        output.write(&zero, 1);
+    }
+    output.close();
+}
+
+CompressedBlockSpill::CompressedBlockSpill(
+        const CompressedWriteLayout& layout,
+        size_t startRow,
+        size_t numRows,
+        const std::string& spillPathname) :
+    mSpillPathname(spillPathname),
+    mBlockRows(layout.getBlockRows(startRow, numRows)),
+    mSpill(new IOHandle(spillPathname, NITF_ACCESS_WRITEONLY, NITF_CREATE))
+{
+    for (const auto& blockRow : mBlockRows)
+    {
+        mNumBlocks += blockRow.numBlocks;
+    }
+    mManifest.startRow = startRow;
+    mManifest.numRows = numRows;
+    mManifest.bytesPerBlock.reserve(mNumBlocks);
+}
+
+CompressedBlockSpill::~CompressedBlockSpill()
+{
+    try
+    {
+        mSpill.reset();
+
+        sys::OS os;
+        if (os.exists(mSpillPathname))
+        {
+            os.remove(mSpillPathname);
+        }
+    }
+    catch (...)
+    {
+    }
+}
+
+void CompressedBlockSpill::addBlock(const void* data, size_t numBytes)
+{
+    if (mFinished || getNumBlocksRemaining() == 0)
+    {
+        std::ostringstream ostr;
+        ostr << "Rows [" << mManifest.startRow << ", "
+             << (mManifest.startRow + mManifest.numRows) << ") only have "
+             << mNumBlocks << " blocks";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    if (numBytes != 0)
+    {
+        mSpill->write(data, numBytes);
+    }
+    mManifest.bytesPerBlock.push_back(numBytes);
+}
+
+const CompressedSpillManifest& CompressedBlockSpill::getManifest()
+{
+    if (!mFinished)
+    {
+        if (getNumBlocksRemaining() != 0)
+        {
+            std::ostringstream ostr;
+            ostr << "Rows [" << mManifest.startRow << ", "
+                 << (mManifest.startRow + mManifest.numRows) << ") are "
+                 << "missing " << getNumBlocksRemaining() << " of their "
+                 << mNumBlocks << " blocks";
+            throw except::Exception(Ctxt(ostr.str()));
+        }
+
+        mSpill->close();
+        mSpill.reset();
+        mFinished = true;
+    }
+    return mManifest;
+}
+
+void CompressedBlockSpill::writeToFile(const ByteProvider& provider,
+                                       IOInterface& output)
+{
+    getManifest();
+
+    IOHandle spill(mSpillPathname);
+    std::vector<std::byte> blockRowData;
+    nitf::NITFBufferList buffers;
+    size_t block = 0;
+    for (const auto& blockRow : mBlockRows)
+    {
+        size_t numBytes = 0;
+        for (size_t ii = 0; ii < blockRow.numBlocks; ++ii)
+        {
+            numBytes += mManifest.bytesPerBlock[block++];
+        }
+
+        // getBytes() wants a non-null pointer even for empty blocks
+        blockRowData.resize(std::max<size_t>(numBytes, 1));
+        if (numBytes != 0)
+        {
+            spill.read(blockRowData.data(), numBytes);
+        }
+
+        nitf::Off fileOffset;
+        provider.getBytes(blockRowData.data(), blockRow.startRow,
+                          blockRow.numRows, fileOffset, buffers);
+
+        output.seek(fileOffset, NITF_SEEK_SET);
+        for (const auto& buffer : buffers.mBuffers)
+        {
+            if (buffer.mNumBytes != 0)
+            {
+                output.write(buffer.mData, buffer.mNumBytes);
+            }
+        }
+    }
+}
+
+void CompressedBlockSpill::writeToFile(const ByteProvider& provider,
+                                       const std::string& outputPathname)
+{
+    // Read/write so the file isn't truncated
+    IOHandle output(outputPathname, NITF_ACCESS_READWRITE,
+                    NITF_OPEN_EXISTING);
+    writeToFile(provider, output);
+    output.close();
+}
+}
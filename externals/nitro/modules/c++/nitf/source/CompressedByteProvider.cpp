@@ -246,7 +246,9 @@ nitf::Off CompressedByteProvider::getNumBytes(size_t startRow, size_t numRows) c
     nitf::Off numBytes(0);
     const size_t imageDataEndRow = startRow + numRows;
 
-    for (size_t seg = 0; seg < mImageSegmentInfo.size(); ++seg)
+    const types::Range segments = findSegments(startRow, numRows);
+    for (size_t seg = segments.mStartElement; seg < segments.endElement();
+         ++seg)
     {
         // See if we're in this segment
         const SegmentInfo& imageSegmentInfo(mImageSegmentInfo[seg]);
@@ -280,7 +282,9 @@ void CompressedByteProvider::getBytes(
     fileOffset = std::numeric_limits<nitf::Off>::max();
     buffers.clear();
 
-    for (size_t seg = 0; seg < mImageSegmentInfo.size(); ++seg)
+    const types::Range segments = findSegments(startRow, numRows);
+    for (size_t seg = segments.mStartElement; seg < segments.endElement();
+         ++seg)
     {
         // See if we're in this segment
         const SegmentInfo& imageSegmentInfo(mImageSegmentInfo[seg]);
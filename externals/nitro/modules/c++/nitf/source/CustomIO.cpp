@@ -60,7 +60,8 @@ nitf_IOInterface* CustomIO::createInterface(CustomIO* me) noexcept
         &CustomIO::adapterGetSize,
         &CustomIO::adapterGetMode,
         &CustomIO::adapterClose,
-        &CustomIO::adapterDestruct
+        &CustomIO::adapterDestruct,
+        nullptr
     };
 
     #ifdef _MSC_VER
@@ -55,6 +55,13 @@ void nitf::IOInterface::read(void* buf, size_t size)
         throw nitf::NITFException(&error);
 }
 
+void nitf::IOInterface::readBatch(nitf_IORequest* requests, size_t count)
+{
+    if (!nitf_IOInterface_readBatch(getNativeOrThrow(), requests, count,
+                                    &error))
+        throw nitf::NITFException(&error);
+}
+
 void nitf::IOInterface::write(const void* buf, size_t size)
 {
     nitf_IOInterface *io = getNativeOrThrow();
@@ -67,6 +67,14 @@ void ImageReader::read(const nitf::SubWindow & subWindow, uint8_t** user, int *
         throw nitf::NITFException(&error);
 }
 
+const uint8_t* ImageReader::readDirect(const nitf::SubWindow& subWindow)
+{
+    const uint8_t* data = nullptr;
+    if (!nitf_ImageReader_readDirect(getNativeOrThrow(), subWindow.getNative(), &data, &error))
+        throw nitf::NITFException(&error);
+    return data;
+}
+
 const uint8_t* ImageReader::readBlock(uint32_t blockNumber, uint64_t* blockSize)
 {
     const uint8_t* const x = nitf_ImageReader_readBlock(
@@ -76,6 +84,14 @@ const uint8_t* ImageReader::readBlock(uint32_t blockNumber, uint64_t* blockSize)
     return x;
 }
 
+const uint8_t* ImageReader::readBlockMapped(uint32_t blockNumber, uint64_t* blockSize)
+{
+    const uint8_t* block = nullptr;
+    if (!nitf_ImageReader_readBlockMapped(getNativeOrThrow(), blockNumber, &block, blockSize, &error))
+        throw nitf::NITFException(&error);
+    return block;
+}
+
 void ImageReader::setReadCaching()
 {
     nitf_ImageReader_setReadCaching(getNativeOrThrow());
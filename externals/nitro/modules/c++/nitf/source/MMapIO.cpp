@@ -0,0 +1,64 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <nitf/MMapIO.hpp>
+
+namespace nitf
+{
+nitf_IOInterface* MMapIO::create(const std::string& pathname)
+{
+    nitf_Error error{};
+    nitf_IOInterface* const ioInterface =
+            nitf_MMapAdapter_open(pathname.c_str(), &error);
+    if (!ioInterface)
+    {
+        throw nitf::NITFException(&error);
+    }
+    return ioInterface;
+}
+
+MMapIO::MMapIO(const std::string& pathname) :
+    IOInterface(create(pathname))
+{
+    setManaged(false);
+}
+
+const void* MMapIO::getData(nitf::Off offset, size_t size) const
+{
+    const void* const data = nitf_MMapAdapter_getData(
+            getNativeOrThrow(), offset, size, &error);
+    if (!data)
+    {
+        throw nitf::NITFException(&error);
+    }
+    return data;
+}
+
+void MMapIO::advise(nitf_MMapAdvice advice, nitf::Off offset, size_t size)
+{
+    if (!nitf_MMapAdapter_advise(getNativeOrThrow(), offset, size, advice,
+                                 &error))
+    {
+        throw nitf::NITFException(&error);
+    }
+}
+}
@@ -77,6 +77,12 @@ nitf::Version Reader::getNITFVersion(const IOInterface& io)
     return nitf_Reader_getNITFVersionIO(io.getNativeOrThrow());
 }
 
+void Reader::setParseTREs(bool parseTREs)
+{
+    nitf_Reader_setParseTREs(getNativeOrThrow(),
+                             parseTREs ? 1 : 0);
+}
+
 nitf::Record Reader::read(nitf::IOHandle & io)
 {
     return readIO(io);
@@ -0,0 +1,260 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Times the per-call overhead of ByteProvider::getBytes() for small row
+// ranges of a many-segment NITF: one call at a time with a new buffer list
+// each call, one call at a time reusing the buffer list, the batch form, and
+// the batch form from several threads at once.  Checks that every form places
+// the bytes the same way.
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <import/cli.h>
+#include <import/nitf.hpp>
+#include <sys/StopWatch.h>
+
+namespace
+{
+nitf::Record createRecord(size_t numSegments, size_t numRows, size_t numCols)
+{
+    nitf::Record record;
+    for (size_t ii = 0; ii < numSegments; ++ii)
+    {
+        nitf::ImageSegment segment = record.newImageSegment();
+        nitf::ImageSubheader header = segment.getSubheader();
+        header.getImageId().set("BENCH");
+
+        std::vector<nitf::BandInfo> bands{ { nitf::Representation::M,
+                                             nitf::Subcategory::None,
+                                             "N", "   " } };
+        header.setPixelInformation(nitf::PixelValueType::Integer, 8, 8, "R",
+                                   nitf::ImageRepresentation::MONO, "VIS",
+                                   bands);
+        header.setBlocking(static_cast<uint32_t>(numRows),
+                           static_cast<uint32_t>(numCols),
+                           static_cast<uint32_t>(numRows),
+                           static_cast<uint32_t>(numCols),
+                           nitf::BlockingMode::Block);
+    }
+    return record;
+}
+
+// Nanoseconds per row range
+double toNanoseconds(double milliseconds, size_t numCalls)
+{
+    return milliseconds * 1.0e6 / static_cast<double>(numCalls);
+}
+
+struct Result final
+{
+    std::vector<nitf::Off> fileOffsets;
+    std::vector<size_t> numBuffers;
+
+    void add(nitf::Off fileOffset, const nitf::NITFBufferList& buffers)
+    {
+        fileOffsets.push_back(fileOffset);
+        numBuffers.push_back(buffers.mBuffers.size());
+    }
+
+    bool operator==(const Result& rhs) const
+    {
+        return fileOffsets == rhs.fileOffsets && numBuffers == rhs.numBuffers;
+    }
+};
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Benchmark ByteProvider::getBytes() per-call overhead");
+        parser.addArgument("--segments", "Number of image segments",
+                           cli::STORE, "segments", "NUM")->setDefault(200);
+        parser.addArgument("--rows", "Rows per image segment", cli::STORE,
+                           "rows", "NUM")->setDefault(64);
+        parser.addArgument("--cols", "Columns", cli::STORE, "cols",
+                           "NUM")->setDefault(256);
+        parser.addArgument("--rows-per-call", "Rows in each range",
+                           cli::STORE, "rowsPerCall", "NUM")->setDefault(1);
+        parser.addArgument("-i --iterations",
+                           "Number of passes over the image", cli::STORE,
+                           "iterations", "NUM")->setDefault(20);
+        parser.addArgument("-t --threads", "Threads for the threaded batch",
+                           cli::STORE, "threads", "NUM")->setDefault(4);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+        const size_t numSegments = options->get<size_t>("segments");
+        const size_t numRows = options->get<size_t>("rows");
+        const size_t numCols = options->get<size_t>("cols");
+        const size_t rowsPerCall =
+                std::max<size_t>(options->get<size_t>("rowsPerCall"), 1);
+        const size_t numIterations = options->get<size_t>("iterations");
+        const size_t numThreads =
+                std::max<size_t>(options->get<size_t>("threads"), 1);
+
+        nitf::Record record = createRecord(numSegments, numRows, numCols);
+        const nitf::ByteProvider provider(record);
+
+        const std::vector<std::byte> image(rowsPerCall * numCols);
+        std::vector<nitf::ByteProvider::RowRange> rowRanges;
+        const size_t totalNumRows = numSegments * numRows;
+        for (size_t row = 0; row < totalNumRows; row += rowsPerCall)
+        {
+            nitf::ByteProvider::RowRange rowRange;
+            rowRange.imageData = image.data();
+            rowRange.startRow = row;
+            rowRange.numRows = std::min(rowsPerCall, totalNumRows - row);
+            rowRanges.push_back(rowRange);
+        }
+        const size_t numCalls = rowRanges.size() * numIterations;
+
+        // One at a time, new buffer list each call
+        Result singleResult;
+        sys::RealTimeStopWatch sw;
+        sw.start();
+        for (size_t ii = 0; ii < numIterations; ++ii)
+        {
+            for (const auto& rowRange : rowRanges)
+            {
+                nitf::Off fileOffset;
+                nitf::NITFBufferList buffers;
+                provider.getBytes(rowRange.imageData, rowRange.startRow,
+                                  rowRange.numRows, fileOffset, buffers);
+                if (ii == 0)
+                {
+                    singleResult.add(fileOffset, buffers);
+                }
+            }
+        }
+        const double singleTime = sw.stop();
+
+        // One at a time, reusing the buffer list
+        sw.clear();
+        sw.start();
+        nitf::NITFBufferList reusedBuffers;
+        for (size_t ii = 0; ii < numIterations; ++ii)
+        {
+            for (const auto& rowRange : rowRanges)
+            {
+                nitf::Off fileOffset;
+                provider.getBytes(rowRange.imageData, rowRange.startRow,
+                                  rowRange.numRows, fileOffset, reusedBuffers);
+            }
+        }
+        const double reusedTime = sw.stop();
+
+        // Batch
+        std::vector<nitf::Off> fileOffsets;
+        std::vector<nitf::NITFBufferList> batchBuffers;
+        sw.clear();
+        sw.start();
+        for (size_t ii = 0; ii < numIterations; ++ii)
+        {
+            provider.getBytes(rowRanges, fileOffsets, batchBuffers);
+        }
+        const double batchTime = sw.stop();
+
+        Result batchResult;
+        for (size_t ii = 0; ii < fileOffsets.size(); ++ii)
+        {
+            batchResult.add(fileOffsets[ii], batchBuffers[ii]);
+        }
+
+        // Batch, with the ranges split between threads
+        std::vector<Result> threadResults(numThreads);
+        sw.clear();
+        sw.start();
+        std::vector<std::thread> threads;
+        for (size_t tt = 0; tt < numThreads; ++tt)
+        {
+            threads.emplace_back([&, tt]()
+            {
+                const size_t first = tt * rowRanges.size() / numThreads;
+                const size_t end = (tt + 1) * rowRanges.size() / numThreads;
+                const std::vector<nitf::ByteProvider::RowRange> myRanges(
+                        rowRanges.begin() + first, rowRanges.begin() + end);
+                std::vector<nitf::Off> myOffsets;
+                std::vector<nitf::NITFBufferList> myBuffers;
+                for (size_t ii = 0; ii < numIterations; ++ii)
+                {
+                    provider.getBytes(myRanges, myOffsets, myBuffers);
+                }
+                for (size_t ii = 0; ii < myOffsets.size(); ++ii)
+                {
+                    threadResults[tt].add(myOffsets[ii], myBuffers[ii]);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        const double threadedTime = sw.stop();
+
+        Result threadedResult;
+        for (const auto& result : threadResults)
+        {
+            threadedResult.fileOffsets.insert(threadedResult.fileOffsets.end(),
+                                              result.fileOffsets.begin(),
+                                              result.fileOffsets.end());
+            threadedResult.numBuffers.insert(threadedResult.numBuffers.end(),
+                                             result.numBuffers.begin(),
+                                             result.numBuffers.end());
+        }
+
+        std::cout << numSegments << " segments, " << rowRanges.size()
+                  << " ranges of " << rowsPerCall << " rows, "
+                  << numIterations << " passes\n"
+                  << "    Single, new buffer list: "
+                  << toNanoseconds(singleTime, numCalls) << " ns/range\n"
+                  << "    Single, reused buffer list: "
+                  << toNanoseconds(reusedTime, numCalls) << " ns/range\n"
+                  << "    Batch: " << toNanoseconds(batchTime, numCalls)
+                  << " ns/range\n"
+                  << "    Batch on " << numThreads << " threads: "
+                  << toNanoseconds(threadedTime, numCalls)
+                  << " ns/range (wall clock)\n";
+
+        if (!(batchResult == singleResult) ||
+            !(threadedResult == singleResult))
+        {
+            std::cerr << "Batch results don't match single calls\n";
+            return 1;
+        }
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
@@ -0,0 +1,247 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Checks the batch form of ByteProvider::getBytes() against one call per
+// range, and the segment lookup it's built on
+
+#include <string.h>
+
+#include <limits>
+#include <vector>
+#include <std/cstddef>
+
+#include <nitf/ByteProvider.hpp>
+#include <nitf/DESegment.hpp>
+#include <nitf/DESubheader.hpp>
+#include <nitf/ImageSegment.hpp>
+#include <nitf/ImageSubheader.hpp>
+#include <nitf/Record.hpp>
+
+#include "TestCase.h"
+
+namespace
+{
+// Three segments of different heights, then a DES
+const size_t NUM_ROWS_PER_SEGMENT[] = { 5, 7, 4 };
+const size_t NUM_ROWS = 16;
+const size_t NUM_COLS = 6;
+const char DES_DATA[] = "byte provider DES";
+
+nitf::Record createRecord()
+{
+    nitf::Record record;
+    record.getHeader().getFileTitle().set("byte provider");
+
+    for (const auto numRows : NUM_ROWS_PER_SEGMENT)
+    {
+        nitf::ImageSegment segment = record.newImageSegment();
+        nitf::ImageSubheader header = segment.getSubheader();
+        header.getImageId().set("NITRO-TEST");
+
+        std::vector<nitf::BandInfo> bands{ { nitf::Representation::M,
+                                             nitf::Subcategory::None,
+                                             "N", "   " } };
+        header.setPixelInformation(nitf::PixelValueType::Integer, 8, 8, "R",
+                                   nitf::ImageRepresentation::MONO, "VIS",
+                                   bands);
+        header.setBlocking(static_cast<uint32_t>(numRows),
+                           static_cast<uint32_t>(NUM_COLS),
+                           static_cast<uint32_t>(numRows),
+                           static_cast<uint32_t>(NUM_COLS),
+                           nitf::BlockingMode::Block);
+    }
+
+    nitf::DESegment des = record.newDataExtensionSegment();
+    des.getSubheader().getFilePartType().set("DE");
+    des.getSubheader().getTypeID().set("NITRO_TEST");
+    des.getSubheader().getVersion().set("01");
+    des.getSubheader().getSecurityClass().set("U");
+    return record;
+}
+
+std::vector<nitf::ByteProvider::PtrAndLength> getDESData()
+{
+    return { { DES_DATA, strlen(DES_DATA) } };
+}
+
+nitf::ByteProvider::RowRange makeRowRange(const std::vector<std::byte>& image,
+                                          size_t startRow,
+                                          size_t numRows)
+{
+    nitf::ByteProvider::RowRange rowRange;
+    rowRange.imageData = image.data() + startRow * NUM_COLS;
+    rowRange.startRow = startRow;
+    rowRange.numRows = numRows;
+    return rowRange;
+}
+
+bool sameBuffers(const nitf::NITFBufferList& lhs,
+                 const nitf::NITFBufferList& rhs)
+{
+    if (lhs.mBuffers.size() != rhs.mBuffers.size())
+    {
+        return false;
+    }
+    for (size_t ii = 0; ii < lhs.mBuffers.size(); ++ii)
+    {
+        if (lhs.mBuffers[ii].mData != rhs.mBuffers[ii].mData ||
+            lhs.mBuffers[ii].mNumBytes != rhs.mBuffers[ii].mNumBytes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t countBytes(const nitf::NITFBufferList& buffers)
+{
+    size_t numBytes = 0;
+    for (const auto& buffer : buffers.mBuffers)
+    {
+        numBytes += buffer.mNumBytes;
+    }
+    return numBytes;
+}
+}
+
+TEST_CASE(testBatchMatchesSingle)
+{
+    nitf::Record record = createRecord();
+    const nitf::ByteProvider provider(record, getDESData());
+    const std::vector<std::byte> image(NUM_ROWS * NUM_COLS);
+
+    const std::vector<nitf::ByteProvider::RowRange> rowRanges{
+            makeRowRange(image, 0, NUM_ROWS), // Everything
+            makeRowRange(image, 1, 3),        // Inside the first segment
+            makeRowRange(image, 3, 11),       // Across all three segments
+            makeRowRange(image, 4, 2),        // Across the first boundary
+            makeRowRange(image, 5, 1),        // First row of a segment
+            makeRowRange(image, 11, 1),       // Last row of a segment
+            makeRowRange(image, 0, 0),        // Empty, at the start
+            makeRowRange(image, 5, 0),        // Empty, on a boundary
+            makeRowRange(image, NUM_ROWS, 0), // Empty, past the end
+            makeRowRange(image, NUM_ROWS - 1, 1) }; // Last row, then the DES
+
+    std::vector<nitf::Off> fileOffsets;
+    std::vector<nitf::NITFBufferList> buffers;
+    provider.getBytes(rowRanges, fileOffsets, buffers);
+    TEST_ASSERT_EQ(fileOffsets.size(), rowRanges.size());
+    TEST_ASSERT_EQ(buffers.size(), rowRanges.size());
+
+    for (size_t ii = 0; ii < rowRanges.size(); ++ii)
+    {
+        const auto& rowRange = rowRanges[ii];
+        nitf::Off fileOffset;
+        nitf::NITFBufferList singleBuffers;
+        provider.getBytes(rowRange.imageData, rowRange.startRow,
+                          rowRange.numRows, fileOffset, singleBuffers);
+
+        TEST_ASSERT_EQ(fileOffsets[ii], fileOffset);
+        TEST_ASSERT(sameBuffers(buffers[ii], singleBuffers));
+        TEST_ASSERT_EQ(static_cast<nitf::Off>(countBytes(buffers[ii])),
+                       provider.getNumBytes(rowRange.startRow,
+                                            rowRange.numRows));
+    }
+
+    // The whole image is the whole file
+    TEST_ASSERT_EQ(fileOffsets[0], static_cast<nitf::Off>(0));
+    TEST_ASSERT_EQ(static_cast<nitf::Off>(countBytes(buffers[0])),
+                   provider.getFileNumBytes());
+
+    // Crossing a boundary picks up the next image subheader
+    TEST_ASSERT_EQ(buffers[3].mBuffers.size(), static_cast<size_t>(3));
+    TEST_ASSERT_EQ(buffers[3].mBuffers[1].mData,
+                   provider.getImageSubheaders()[1].data());
+
+    // Empty ranges give nothing to write
+    for (size_t ii = 6; ii < 9; ++ii)
+    {
+        TEST_ASSERT(buffers[ii].empty());
+        TEST_ASSERT_EQ(fileOffsets[ii],
+                       std::numeric_limits<nitf::Off>::max());
+    }
+
+    // The last row is followed by the DES, which ends the file
+    const auto& lastRow = buffers.back();
+    TEST_ASSERT_EQ(lastRow.mBuffers.size(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(lastRow.mBuffers[1].mData,
+                   provider.getDesSubheaderAndData().data());
+    TEST_ASSERT_EQ(fileOffsets.back() +
+                           static_cast<nitf::Off>(countBytes(lastRow)),
+                   provider.getFileNumBytes());
+}
+
+TEST_CASE(testBatchReusesOutputs)
+{
+    nitf::Record record = createRecord();
+    const nitf::ByteProvider provider(record, getDESData());
+    const std::vector<std::byte> image(NUM_ROWS * NUM_COLS);
+
+    std::vector<nitf::ByteProvider::RowRange> rowRanges;
+    for (size_t row = 0; row < NUM_ROWS; ++row)
+    {
+        rowRanges.push_back(makeRowRange(image, row, 1));
+    }
+    std::vector<nitf::Off> fileOffsets;
+    std::vector<nitf::NITFBufferList> buffers;
+    provider.getBytes(rowRanges, fileOffsets, buffers);
+
+    // A smaller batch into the same outputs leaves nothing behind
+    const std::vector<nitf::ByteProvider::RowRange> fewerRanges{
+            makeRowRange(image, 6, 2), makeRowRange(image, 2, 0) };
+    provider.getBytes(fewerRanges, fileOffsets, buffers);
+    TEST_ASSERT_EQ(fileOffsets.size(), fewerRanges.size());
+    TEST_ASSERT_EQ(buffers.size(), fewerRanges.size());
+    TEST_ASSERT_EQ(buffers[0].mBuffers.size(), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(buffers[0].mBuffers[0].mData, fewerRanges[0].imageData);
+    TEST_ASSERT_EQ(buffers[0].mBuffers[0].mNumBytes, 2 * NUM_COLS);
+    TEST_ASSERT(buffers[1].empty());
+
+    provider.getBytes({}, fileOffsets, buffers);
+    TEST_ASSERT(fileOffsets.empty());
+    TEST_ASSERT(buffers.empty());
+}
+
+TEST_CASE(testGetSegment)
+{
+    nitf::Record record = createRecord();
+    const nitf::ByteProvider provider(record, getDESData());
+
+    TEST_ASSERT_EQ(provider.getSegment(0), static_cast<size_t>(0));
+    TEST_ASSERT_EQ(provider.getSegment(4), static_cast<size_t>(0));
+    TEST_ASSERT_EQ(provider.getSegment(5), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(provider.getSegment(11), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(provider.getSegment(12), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(provider.getSegment(NUM_ROWS - 1), static_cast<size_t>(2));
+
+    TEST_EXCEPTION(provider.getSegment(NUM_ROWS));
+    TEST_EXCEPTION(provider.getSegment(NUM_ROWS + 100));
+}
+
+TEST_MAIN(
+    (void)argc;
+    (void)argv;
+
+    TEST_CHECK(testBatchMatchesSingle);
+    TEST_CHECK(testBatchReusesOutputs);
+    TEST_CHECK(testGetSegment);
+    )
@@ -0,0 +1,340 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Simulates a distributed compressed write with a thread per worker and
+// checks the result matches writing every block through a single
+// CompressedByteProvider
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <std/cstddef>
+
+#include <sys/OS.h>
+
+#include <nitf/CompressedBlockSpill.hpp>
+#include <nitf/CompressedByteProvider.hpp>
+#include <nitf/IOHandle.hpp>
+#include <nitf/ImageSegment.hpp>
+#include <nitf/ImageSubheader.hpp>
+#include <nitf/Record.hpp>
+
+#include "TestCase.h"
+
+namespace
+{
+// Three segments of 40, 40 and 23 rows, with partial blocks down and across
+const size_t NUM_ROWS_PER_SEGMENT[] = { 40, 40, 23 };
+const size_t NUM_COLS = 56;
+const size_t NUM_ROWS_PER_BLOCK = 15;
+const size_t NUM_COLS_PER_BLOCK = 20;
+
+nitf::Record createRecord()
+{
+    nitf::Record record;
+    record.getHeader().getFileTitle().set("compressed block spill");
+
+    for (const auto numRows : NUM_ROWS_PER_SEGMENT)
+    {
+        nitf::ImageSegment segment = record.newImageSegment();
+        nitf::ImageSubheader header = segment.getSubheader();
+        header.getImageId().set("NITRO-TEST");
+        header.getImageCompression().set("C8");
+        header.getCompressionRate().set("N045");
+
+        std::vector<nitf::BandInfo> bands{ { nitf::Representation::M,
+                                             nitf::Subcategory::None,
+                                             "N", "   " } };
+        header.setPixelInformation(nitf::PixelValueType::Integer, 8, 8, "R",
+                                   nitf::ImageRepresentation::MONO, "VIS",
+                                   bands);
+        header.setBlocking(static_cast<uint32_t>(numRows),
+                           static_cast<uint32_t>(NUM_COLS),
+                           static_cast<uint32_t>(NUM_ROWS_PER_BLOCK),
+                           static_cast<uint32_t>(NUM_COLS_PER_BLOCK),
+                           nitf::BlockingMode::Block);
+    }
+    return record;
+}
+
+// Stands in for a real compressor: every block gets a different size
+std::vector<std::byte> compressBlock(size_t segment, size_t block)
+{
+    std::vector<std::byte> bytes(17 + (segment * 131 + block * 71) % 97);
+    for (size_t ii = 0; ii < bytes.size(); ++ii)
+    {
+        bytes[ii] = static_cast<std::byte>(segment * 37 + block * 11 + ii);
+    }
+    return bytes;
+}
+
+std::vector<std::vector<size_t> > getExpectedBytesPerBlock(
+        const nitf::CompressedWriteLayout& layout)
+{
+    std::vector<std::vector<size_t> > bytesPerBlock(
+            layout.getNumBlocks().size());
+    for (size_t seg = 0; seg < bytesPerBlock.size(); ++seg)
+    {
+        for (size_t block = 0; block < layout.getNumBlocks()[seg]; ++block)
+        {
+            bytesPerBlock[seg].push_back(compressBlock(seg, block).size());
+        }
+    }
+    return bytesPerBlock;
+}
+
+// Every block through one provider in one call
+std::vector<std::byte> writeSerially(
+        nitf::Record& record,
+        const std::vector<std::vector<size_t> >& bytesPerBlock,
+        size_t numRows)
+{
+    const nitf::CompressedByteProvider provider(
+            record, bytesPerBlock,
+            std::vector<nitf::ByteProvider::PtrAndLength>(),
+            NUM_ROWS_PER_BLOCK, NUM_COLS_PER_BLOCK);
+
+    std::vector<std::byte> blocks;
+    for (size_t seg = 0; seg < bytesPerBlock.size(); ++seg)
+    {
+        for (size_t block = 0; block < bytesPerBlock[seg].size(); ++block)
+        {
+            const std::vector<std::byte> compressed =
+                    compressBlock(seg, block);
+            blocks.insert(blocks.end(), compressed.begin(), compressed.end());
+        }
+    }
+
+    nitf::Off fileOffset;
+    nitf::NITFBufferList buffers;
+    provider.getBytes(blocks.data(), 0, numRows, fileOffset, buffers);
+
+    std::vector<std::byte> file(
+            static_cast<size_t>(provider.getFileNumBytes()));
+    for (const auto& buffer : buffers.mBuffers)
+    {
+        memcpy(&file[static_cast<size_t>(fileOffset)], buffer.mData,
+               buffer.mNumBytes);
+        fileOffset += buffer.mNumBytes;
+    }
+    return file;
+}
+
+void compressRows(const nitf::CompressedWriteLayout& layout,
+                  const types::Range& rows,
+                  nitf::CompressedBlockSpill& spill)
+{
+    for (const auto& blockRow :
+         layout.getBlockRows(rows.mStartElement, rows.mNumElements))
+    {
+        for (size_t ii = 0; ii < blockRow.numBlocks; ++ii)
+        {
+            const std::vector<std::byte> compressed =
+                    compressBlock(blockRow.segment, blockRow.firstBlock + ii);
+            spill.addBlock(compressed.data(), compressed.size());
+        }
+    }
+}
+
+std::vector<std::byte> readFile(const std::string& pathname)
+{
+    nitf::IOHandle input(pathname);
+    std::vector<std::byte> bytes(static_cast<size_t>(input.getSize()));
+    input.read(bytes.data(), bytes.size());
+    return bytes;
+}
+
+struct EnsureFileCleanup final
+{
+    EnsureFileCleanup(const std::string& pathname) : mPathname(pathname)
+    {
+    }
+
+    ~EnsureFileCleanup()
+    {
+        try
+        {
+            sys::OS os;
+            if (os.exists(mPathname))
+            {
+                os.remove(mPathname);
+            }
+        }
+        catch (...)
+        {
+        }
+    }
+
+    const std::string mPathname;
+};
+}
+
+TEST_CASE(testLayout)
+{
+    nitf::Record record = createRecord();
+    const nitf::CompressedWriteLayout layout(record, NUM_ROWS_PER_BLOCK,
+                                             NUM_COLS_PER_BLOCK);
+    TEST_ASSERT_EQ(layout.getNumRows(), static_cast<size_t>(103));
+
+    // 3 block rows in each 40 row segment and 2 in the last, 3 blocks across
+    TEST_ASSERT_EQ(layout.getNumBlocks().size(), static_cast<size_t>(3));
+    TEST_ASSERT_EQ(layout.getNumBlocks()[0], static_cast<size_t>(9));
+    TEST_ASSERT_EQ(layout.getNumBlocks()[2], static_cast<size_t>(6));
+
+    const std::vector<types::Range> parts = layout.partitionRows(3);
+    TEST_ASSERT_EQ(parts.size(), static_cast<size_t>(3));
+    TEST_ASSERT_EQ(parts[0].mStartElement, static_cast<size_t>(0));
+    TEST_ASSERT_EQ(parts[1].mStartElement, static_cast<size_t>(30));
+    TEST_ASSERT_EQ(parts[2].mStartElement, static_cast<size_t>(70));
+    TEST_ASSERT_EQ(parts[2].endElement(), static_cast<size_t>(103));
+
+    // More workers than block rows
+    TEST_ASSERT_EQ(layout.partitionRows(100).size(), static_cast<size_t>(8));
+
+    // Rows must start and end on block rows
+    TEST_EXCEPTION(layout.getBlockRows(1, 14));
+    TEST_EXCEPTION(layout.getBlockRows(0, 14));
+    TEST_EXCEPTION(layout.getBlockRows(0, 104));
+    TEST_ASSERT_EQ(layout.getBlockRows(30, 25).size(), static_cast<size_t>(2));
+}
+
+TEST_CASE(testManifestsMustCoverImage)
+{
+    nitf::Record record = createRecord();
+    const nitf::CompressedWriteLayout layout(record, NUM_ROWS_PER_BLOCK,
+                                             NUM_COLS_PER_BLOCK);
+    const std::vector<types::Range> parts = layout.partitionRows(2);
+
+    std::vector<nitf::CompressedSpillManifest> manifests(parts.size());
+    for (size_t ii = 0; ii < parts.size(); ++ii)
+    {
+        const std::string spillPathname =
+                "test_spill_" + std::to_string(ii) + ".bin";
+        nitf::CompressedBlockSpill spill(layout, parts[ii].mStartElement,
+                                         parts[ii].mNumElements,
+                                         spillPathname);
+        TEST_EXCEPTION(spill.getManifest());
+        compressRows(layout, parts[ii], spill);
+        TEST_EXCEPTION(spill.addBlock("x", 1));
+        manifests[ii] = spill.getManifest();
+    }
+    TEST_ASSERT_TRUE(layout.getBytesPerBlock(manifests) ==
+                     getExpectedBytesPerBlock(layout));
+
+    // Missing rows
+    TEST_EXCEPTION(layout.getBytesPerBlock(
+            std::vector<nitf::CompressedSpillManifest>(1, manifests[0])));
+
+    // Overlapping rows
+    std::vector<nitf::CompressedSpillManifest> overlapping(manifests);
+    overlapping.push_back(manifests[1]);
+    TEST_EXCEPTION(layout.getBytesPerBlock(overlapping));
+
+    // Wrong number of blocks
+    manifests[1].bytesPerBlock.pop_back();
+    TEST_EXCEPTION(layout.getBytesPerBlock(manifests));
+}
+
+TEST_CASE(testDistributedWrite)
+{
+    nitf::Record record = createRecord();
+    const nitf::CompressedWriteLayout layout(record, NUM_ROWS_PER_BLOCK,
+                                             NUM_COLS_PER_BLOCK);
+    const std::vector<std::byte> expected = writeSerially(
+            record, getExpectedBytesPerBlock(layout), layout.getNumRows());
+
+    const std::string outputPathname = "test_compressed_block_spill.ntf";
+    const EnsureFileCleanup outputCleanup(outputPathname);
+
+    for (const size_t numWorkers : { 1, 2, 3, 8 })
+    {
+        const std::vector<types::Range> parts =
+                layout.partitionRows(numWorkers);
+
+        // Phase 1: each worker compresses its rows to its own spill file
+        std::vector<std::unique_ptr<nitf::CompressedBlockSpill> > spills;
+        for (size_t ii = 0; ii < parts.size(); ++ii)
+        {
+            spills.emplace_back(new nitf::CompressedBlockSpill(
+                    layout, parts[ii].mStartElement, parts[ii].mNumElements,
+                    "test_spill_" + std::to_string(ii) + ".bin"));
+        }
+
+        std::vector<nitf::CompressedSpillManifest> manifests(parts.size());
+        std::vector<std::thread> workers;
+        for (size_t ii = 0; ii < parts.size(); ++ii)
+        {
+            workers.emplace_back([&, ii]()
+            {
+                compressRows(layout, parts[ii], *spills[ii]);
+                manifests[ii] = spills[ii]->getManifest();
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        // The coordinator lays out the file
+        const std::vector<std::vector<size_t> > bytesPerBlock =
+                layout.getBytesPerBlock(manifests);
+        const nitf::CompressedByteProvider provider(
+                record, bytesPerBlock,
+                std::vector<nitf::ByteProvider::PtrAndLength>(),
+                NUM_ROWS_PER_BLOCK, NUM_COLS_PER_BLOCK);
+        nitf::CompressedWriteLayout::createFile(outputPathname, provider);
+
+        // Phase 2: workers write their bytes in place, in any order
+        workers.clear();
+        for (size_t ii = parts.size(); ii > 0; --ii)
+        {
+            workers.emplace_back([&, ii]()
+            {
+                spills[ii - 1]->writeToFile(provider, outputPathname);
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        const std::vector<std::byte> actual = readFile(outputPathname);
+        TEST_ASSERT_EQ(actual.size(), expected.size());
+        TEST_ASSERT_TRUE(actual == expected);
+
+        // Spill files go with the spills
+        spills.clear();
+        TEST_ASSERT_TRUE(!sys::OS().exists("test_spill_0.bin"));
+    }
+}
+
+TEST_MAIN(
+    (void)argc;
+    (void)argv;
+
+    TEST_CHECK(testLayout);
+    TEST_CHECK(testManifestsMustCoverImage);
+    TEST_CHECK(testDistributedWrite);
+    )
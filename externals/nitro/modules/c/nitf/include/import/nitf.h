@@ -59,6 +59,7 @@
 #include "nitf/SubWindow.h"
 #include "nitf/System.h"
 #include "nitf/TRE.h"
+#include "nitf/TREParser.h"
 #include "nitf/TREUtils.h"
 #include "nitf/TextSegment.h"
 #include "nitf/TextSubheader.h"
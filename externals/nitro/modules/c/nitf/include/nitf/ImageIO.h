@@ -773,6 +773,40 @@ NITFPROT(NITF_BOOL) nitf_ImageIO_read(nitf_ImageIO * nitf,
                                       nitf_Error * error
                                      );
 
+/*!
+  \brief nitf_ImageIO_readDirect - Get a sub-window without copying it
+
+  \b nitf_ImageIO_readDirect returns a pointer straight to the pixels of a
+  sub-window in a memory mapped file (see nitf_MMapAdapter_open), when they
+  are stored exactly as nitf_ImageIO_read would return them. That is, when:
+
+    The interface is memory mapped
+    One band is requested, and the image has one band (or is IQ or RGB
+    pixel interleaved, which is read as one band)
+    The image is uncompressed (IC=NC) and there's no down-sampling
+    The pixels need no byte swapping or sign extension
+    Each block spans the full width of the image, the blocks are back to
+    back in the file, and the request is either full rows or one row
+
+  Otherwise the returned pointer is NULL, and the caller should fall back
+  to nitf_ImageIO_read. The pixels are valid until the interface is closed
+  and must not be modified.
+
+  \param nitf The associated nitf_ImageIO object
+  \param io The IO interface
+  \param subWindow Sub-window to read
+  \param data [out] The pixels, or NULL if they can't be read directly
+  \param error [out] Error object
+  \return Returns FALSE on error
+*/
+
+NITFPROT(NITF_BOOL) nitf_ImageIO_readDirect(nitf_ImageIO * nitf,
+                                            nitf_IOInterface* io,
+                                            nitf_SubWindow * subWindow,
+                                            const uint8_t ** data,
+                                            nitf_Error * error
+                                           );
+
 /*!
   \brief  nitf_ImageIO_pixelSize - Return the pixel size
 
@@ -865,6 +899,24 @@ NITFPROT(void) nitf_ImageIO_setReadCaching
     nitf_ImageIO * nitf      /*!< Object to modify */
 );
 
+/*!
+  \brief nitf_ImageIO_setVectorization - Enable/disable vector unformat and
+  unpack functions
+
+  Vector (SSE2, AVX2 or NEON) versions of the byte swap, shift and sign
+  extension unformat functions and of the band interleaved by pixel unpack
+  functions are used by default when the processor supports them. Disabling
+  them selects the scalar functions, which produce identical results.
+
+  \return Returns the current enable/disable state
+*/
+
+NITFPROT(int) nitf_ImageIO_setVectorization
+(
+    nitf_ImageIO * nitf,      /*!< Object to modify */
+    int enable               /*!< Enable vector functions if true */
+);
+
 /*!
   \brief nitf_BlockingInfo_print - Print blocking information
 
@@ -909,6 +961,31 @@ NITFPROT(uint8_t*) nitf_ImageIO_readBlockDirect(nitf_ImageIO* nitf,
                                                    uint64_t* blockSize,
                                                    nitf_Error * error);
 
+/*!
+  \brief nitf_ImageIO_readBlockMapped - Get a block without copying it
+
+  \b nitf_ImageIO_readBlockMapped returns a pointer straight to a block in a
+  memory mapped file (see nitf_MMapAdapter_open), when the image is
+  uncompressed and its blocks are stored as nitf_ImageIO_readBlockDirect
+  would return them.  Otherwise the returned pointer is NULL, and the caller
+  should fall back to nitf_ImageIO_readBlockDirect.  The block is valid until
+  the interface is closed and must not be modified.
+
+  \param nitf         Image handle
+  \param io           IO handle
+  \param blockNumber  The block to read
+  \param block        [out] The block, or NULL if it can't be read directly
+  \param blockSize    [out] The block size, when a block is returned
+  \param error        [out] Error object
+  \return Returns FALSE on error
+ */
+NITFPROT(NITF_BOOL) nitf_ImageIO_readBlockMapped(nitf_ImageIO* nitf,
+                                                 nitf_IOInterface* io,
+                                                 uint32_t blockNumber,
+                                                 const uint8_t** block,
+                                                 uint64_t* blockSize,
+                                                 nitf_Error * error);
+
 /*!
   \brief nitf_ImageIO_writeBlockDirect - Write a block of data without manipulation
 
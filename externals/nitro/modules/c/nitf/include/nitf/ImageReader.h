@@ -61,6 +61,16 @@ NITFAPI(NITF_BOOL) nitf_ImageReader_read(nitf_ImageReader * imageReader,
         uint8_t ** user,
         int *padded, nitf_Error * error);
 
+/*!
+ *  Get a pointer straight to the pixels of a sub-window, when the input is
+ *  memory mapped and no copy is needed.  Otherwise 'data' is set to NULL;
+ *  use nitf_ImageReader_read instead.  See nitf_ImageIO_readDirect.
+ */
+NITFAPI(NITF_BOOL) nitf_ImageReader_readDirect(nitf_ImageReader * imageReader,
+                                               nitf_SubWindow * subWindow,
+                                               const uint8_t ** data,
+                                               nitf_Error * error);
+
 /**
    Read a block directly from file
  */
@@ -69,6 +79,17 @@ NITFAPI(uint8_t*) nitf_ImageReader_readBlock(nitf_ImageReader * imageReader,
                                                 uint64_t* blockSize,
                                                 nitf_Error * error);
 
+/*!
+ *  Get a pointer straight to a block, when the input is memory mapped and
+ *  no copy is needed.  Otherwise 'block' is set to NULL; use
+ *  nitf_ImageReader_readBlock instead.  See nitf_ImageIO_readBlockMapped.
+ */
+NITFAPI(NITF_BOOL) nitf_ImageReader_readBlockMapped(nitf_ImageReader * imageReader,
+                                                    uint32_t blockNumber,
+                                                    const uint8_t ** block,
+                                                    uint64_t* blockSize,
+                                                    nitf_Error * error);
+
 /*!
  *  TODO: Add documentation
  */
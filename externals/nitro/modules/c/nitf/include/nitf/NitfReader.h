@@ -50,6 +50,7 @@ typedef struct _nitf_Reader
     nitf_IOInterface* input;
     nitf_Record *record;
     NITF_BOOL ownInput;
+    NITF_BOOL parseTREs;
 
 }
 nitf_Reader;
@@ -70,6 +71,20 @@ NITFAPI(nitf_Reader *) nitf_Reader_construct(nitf_Error * error);
  */
 NITFAPI(void) nitf_Reader_destruct(nitf_Reader ** reader);
 
+/*!
+ *  Set whether extension TREs (those in the file, image and other
+ *  subheaders) are parsed by their plug-in handlers when the file is read.
+ *  If not, each is read with the default handler, which keeps the raw
+ *  bytes without looking them up in the plug-in registry.  This is much
+ *  cheaper when only the subheaders themselves are needed.  The default
+ *  is to parse.  DES subheader fields are always parsed.
+ *
+ *  \param reader The reader object
+ *  \param parseTREs Whether to parse extension TREs
+ */
+NITFAPI(void) nitf_Reader_setParseTREs(nitf_Reader* reader,
+                                       NITF_BOOL parseTREs);
+
 /*!
  *  This is the method for reading information from a NITF (or NSIF).  It
  *  reads all of the support data, including TREs, which it parses
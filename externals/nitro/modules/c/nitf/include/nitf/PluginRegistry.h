@@ -36,6 +36,15 @@
 /*  The environment variable for the plugin path  */
 #   define NITF_PLUGIN_PATH "NITF_PLUGIN_PATH"
 
+/*
+ *  The environment variable that picks when plugins are loaded:
+ *  "eager" loads every plugin in the path when the registry is created,
+ *  "lazy" only lists them, and loads each the first time it is needed.
+ *  The default is eager, unless the library was built with the static
+ *  TRE registry (NITF_STATIC_TRE_REGISTRY).
+ */
+#   define NITF_PLUGIN_LOAD_MODE "NITF_PLUGIN_LOAD_MODE"
+
 NITF_CXX_GUARD
 
 /*!
@@ -65,12 +74,40 @@ typedef struct _protected_nitf_PluginRegistry
 
     nitf_List* dsos;
 
+    /*  In lazy mode, plugins that were found but not yet loaded  */
+    NITF_BOOL lazyLoad;
+    nitf_List* deferredPlugins;
+
 }
 nitf_PluginRegistry;
 #if _MSC_VER
 #pragma warning(pop)
 #endif
 
+/*!
+ *  A TRE handler compiled into the library.  When the library is built with
+ *  NITF_STATIC_TRE_REGISTRY, the TREs in shared/ are built in, and a table of
+ *  these, sorted by name at build time, is searched for any tag that no
+ *  plugin or registered handler handles.  Each handler is initialized the
+ *  first time its tag is looked up.
+ */
+typedef struct _nitf_StaticTREHandler
+{
+    /*  The plugin name, with any spaces in the tag replaced by '_'  */
+    const char* name;
+    NITF_PLUGIN_INIT_FUNCTION init;
+    NITF_PLUGIN_TRE_HANDLER_FUNCTION handler;
+}
+nitf_StaticTREHandler;
+
+/*!
+ *  \param numHandlers The number of handlers in the table
+ *  \return The static TRE handlers, sorted by name with strcmp(), or NULL if
+ *  the library was built without them
+ */
+NITFPROT(const nitf_StaticTREHandler*)
+nitf_PluginRegistry_getStaticTREHandlers(size_t* numHandlers);
+
 /*!
  *  Since 3/14/2004, this object is a singleton.  If you wish to
  *  create it, you must call this function.  This method checks
@@ -104,7 +141,9 @@ nitf_PluginRegistry_getInstanceLog(nitf_Error* error, FILE* log);
  *  Load the plugin registry.  This will walk the DLL path and search
  *  for plugins.  All DSOs are loaded, and queried for their purpose.
  *  Once this has occurred the object will be in memory, and will be
- *  deletable at nitf_PluginRegistry_unload() time.  Since this is normally
+ *  deletable at nitf_PluginRegistry_unload() time.  In lazy mode (see
+ *  NITF_PLUGIN_LOAD_MODE) the DSOs are only listed here, and each is
+ *  loaded when a handler it might provide is first looked up.  Since this is normally
  *  called implicitly, if you use this method, you will need to synchronize
  *  any code that is threaded if you plan on calling these between threads.
  *
@@ -153,7 +192,8 @@ nitf_PluginRegistry_registerDecompressionHandler(
  *  This will walk the DLL path and search
  *  for plugins.  All DSOs are loaded, and queried for their purpose.
  *  Once this has occurred the object will be in memory, and will be
- *  deletable at nitf_PluginRegistry_unload() time.
+ *  deletable at nitf_PluginRegistry_unload() time.  In lazy mode the DSOs
+ *  are loaded when first needed instead.
  *  This call is thread safe.
  *
  *  \param dirName   The directory to read from and load
@@ -222,6 +262,11 @@ nitf_PluginRegistry_unload(nitf_PluginRegistry * reg, nitf_Error * error);
  *  will return it, unless an error occurred, in which case, it sets
  *  had_error to 1.
  *
+ *  A tag no loaded plugin handles is looked for in the static TRE
+ *  registry, if there is one, and then, in lazy mode, in the plugin named
+ *  after the tag and finally in every plugin not yet loaded.  This call is
+ *  thread safe.
+ *
  *  \param reg This is the registry
  *  \param ident  This is the ID of the tre (the plugin will have same name)
  *  \param had_error If an error occured, this will be 1, otherwise it is 0
@@ -243,6 +288,11 @@ nitf_PluginRegistry_retrieveTREHandler(nitf_PluginRegistry * reg,
  *  will return it, unless an error occurred, in which case, it sets
  *  had_error to 1.
  *
+ *  A tag no loaded plugin handles is looked for in the static TRE
+ *  registry, if there is one, and then, in lazy mode, in the plugin named
+ *  after the tag and finally in every plugin not yet loaded.  This call is
+ *  thread safe.
+ *
  *  \param reg This is the registry
  *  \param ident  This is the ID (e.g., C8)
  *  \param had_error If an error occured, this will be 1, otherwise it is 0
@@ -260,11 +260,14 @@ typedef NRT_IO_INTERFACE_GET_SIZE       NITF_IO_INTERFACE_GET_SIZE;
 typedef NRT_IO_INTERFACE_GET_MODE       NITF_IO_INTERFACE_GET_MODE;
 typedef NRT_IO_INTERFACE_CLOSE          NITF_IO_INTERFACE_CLOSE;
 typedef NRT_IO_INTERFACE_DESTRUCT       NITF_IO_INTERFACE_DESTRUCT;
+typedef NRT_IO_INTERFACE_READ_BATCH     NITF_IO_INTERFACE_READ_BATCH;
+typedef nrt_IORequest                   nitf_IORequest;
 
 typedef nrt_IIOInterface                nitf_IIOInterface;
 typedef nrt_IOInterface                 nitf_IOInterface;
 
 #define nitf_IOInterface_read           nrt_IOInterface_read
+#define nitf_IOInterface_readBatch      nrt_IOInterface_readBatch
 #define nitf_IOInterface_write          nrt_IOInterface_write
 #define nitf_IOInterface_canSeek        nrt_IOInterface_canSeek
 #define nitf_IOInterface_seek           nrt_IOInterface_seek
@@ -276,6 +279,17 @@ typedef nrt_IOInterface                 nitf_IOInterface;
 #define nitf_IOHandleAdapter_construct  nrt_IOHandleAdapter_construct
 #define nitf_IOHandleAdapter_open       nrt_IOHandleAdapter_open
 #define nitf_BufferAdapter_construct    nrt_BufferAdapter_construct
+#define nitf_MMapAdapter_open           nrt_MMapAdapter_open
+#define nitf_MMapAdapter_isMapped       nrt_MMapAdapter_isMapped
+#define nitf_MMapAdapter_getData        nrt_MMapAdapter_getData
+#define nitf_MMapAdapter_advise         nrt_MMapAdapter_advise
+typedef nrt_MMapAdvice                  nitf_MMapAdvice;
+#define NITF_MMAP_NORMAL                NRT_MMAP_NORMAL
+#define NITF_MMAP_SEQUENTIAL            NRT_MMAP_SEQUENTIAL
+#define NITF_MMAP_RANDOM                NRT_MMAP_RANDOM
+#define NITF_MMAP_WILLNEED              NRT_MMAP_WILLNEED
+#define nitf_AsyncIOAdapter_open        nrt_AsyncIOAdapter_open
+#define NITF_ASYNC_IO_DEFAULT_THREADS   NRT_ASYNC_IO_DEFAULT_THREADS
 
 
 /******************************************************************************/
@@ -0,0 +1,119 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program;
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __NITF_TRE_PARSER_H__
+#define __NITF_TRE_PARSER_H__
+
+#include "nitf/TRE.h"
+#include "nitf/TREDescription.h"
+#include "nitf/TREPrivateData.h"
+
+NITF_CXX_GUARD
+
+/*!
+ *  \file
+ *  \brief A TRE description compiled for parsing
+ *
+ *  nitf_TREUtils_parse() walks the description with a nitf_TRECursor,
+ *  which re-reads the loop and condition labels, re-splits the length
+ *  expressions and re-formats every field's tag for each field it reads.
+ *  A nitf_TREParser does that work once per description: each entry
+ *  becomes an instruction with its jumps, constants, expression tokens and
+ *  field references resolved.  Parsing with it gives the same fields, keys,
+ *  order and errors as nitf_TREUtils_parse().
+ *
+ *  The fields are still individually allocated, because the TRE owns them
+ *  and frees them one at a time.  Keys and lookups needed only during the
+ *  parse come from an arena that is freed when it finishes.
+ */
+typedef struct _nitf_TREParser nitf_TREParser;
+
+/*!
+ *  Compile a description
+ *
+ *  \param description The description, ending with NITF_END.  It must
+ *  outlive the parser.
+ *  \param error Populated on failure
+ *  \return The parser, or NULL if the description uses something the
+ *  parser doesn't model (for example unbalanced loops or ifs, loops nested
+ *  more than NITF_INT_STACK_DEPTH deep, or a malformed expression).  Those
+ *  descriptions should be parsed with nitf_TREUtils_parse().
+ */
+NITFAPI(nitf_TREParser*)
+nitf_TREParser_construct(const nitf_TREDescription* description,
+                         nitf_Error* error);
+
+NITFAPI(void) nitf_TREParser_destruct(nitf_TREParser** parser);
+
+/*!
+ *  Parse a TRE's data into its fields.  This is a drop-in replacement for
+ *  nitf_TREUtils_parse() when tre->priv's description is the one the
+ *  parser was built from.  It is safe to use one parser from several
+ *  threads at once.
+ *
+ *  \param parser The compiled description
+ *  \param tre The TRE, with its nitf_TREPrivateData length and description
+ *  set.  Any fields it has are replaced.
+ *  \param bufptr The TRE data
+ *  \param error Populated on failure
+ *  \return 1 on success, 0 on failure
+ */
+NITFAPI(int) nitf_TREParser_parse(const nitf_TREParser* parser,
+                                  nitf_TRE* tre,
+                                  char* bufptr,
+                                  nitf_Error* error);
+
+/*!
+ *  Get the parser for a description, compiling it the first time.  This is
+ *  meant for descriptions that live as long as the process, such as those
+ *  in a nitf_TREDescriptionSet.  A description freed sooner has to be
+ *  passed to nitf_TREParser_evict() first.  This call is thread safe.
+ *
+ *  \param description The description
+ *  \return The parser, or NULL if the description can't be compiled
+ */
+NITFAPI(const nitf_TREParser*)
+nitf_TREParser_get(const nitf_TREDescription* description);
+
+/*!
+ *  Destroy the parser nitf_TREParser_get() made for a description, if
+ *  there is one.  Call this before freeing or changing a description that
+ *  has been used to read TREs, since the cache is keyed by its address.
+ *  No TRE may be reading with the description at the time.  This call is
+ *  thread safe.
+ *
+ *  \param description The description
+ */
+NITFAPI(void) nitf_TREParser_evict(const nitf_TREDescription* description);
+
+/*!
+ *  Destroy the parsers nitf_TREParser_get() has made.  The cache is keyed
+ *  by description address, so this has to be called before the plugins
+ *  that declare those descriptions are unloaded;
+ *  nitf_PluginRegistry_unload() does it.  Parsers returned before the call
+ *  must not be used after it.
+ */
+NITFPROT(void) nitf_TREParser_clearCache(void);
+
+NITF_CXX_ENDGUARD
+
+#endif
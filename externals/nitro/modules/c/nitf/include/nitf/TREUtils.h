@@ -70,6 +70,24 @@ NITFAPI(int) nitf_TREUtils_parse(nitf_TRE * tre,
                                  char *bufptr,
                                  nitf_Error * error);
 
+/*!
+ *  Fill in a handler that reads, writes and edits TREs from a description
+ *  set.  The handler keeps a pointer to 'set', so the set and the
+ *  descriptions in it must outlive the handler.
+ *
+ *  Each description is compiled into a nitf_TREParser the first time a
+ *  TRE is read with it, and the parser is cached by the description's
+ *  address for the life of the process.  A description that is freed (or
+ *  changed) while the process goes on running must first be passed to
+ *  nitf_TREParser_evict(), so a description allocated later at the same
+ *  address doesn't get its parser.  The descriptions of plugins are
+ *  evicted when the plugins are unloaded.
+ *
+ *  \param set The descriptions, tried in order when reading
+ *  \param handler The handler to fill in
+ *  \param error Unused
+ *  \return handler
+ */
 NITFAPI(nitf_TREHandler*)
     nitf_TREUtils_createBasicHandler(nitf_TREDescriptionSet* set,
                                      nitf_TREHandler *handler,
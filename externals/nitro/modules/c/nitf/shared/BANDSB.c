@@ -184,7 +184,6 @@ static nitf_TREDescription description[] = {
     {NITF_BCS_N, 20, "Auxiliary Parameter ASCII Value",                     "APA" },
     {NITF_ENDIF, 0, NULL, NULL},
 
-    {NITF_ENDLOOP, 0, NULL, NULL },
     {NITF_ENDLOOP, 0, NULL, NULL },
 
     {NITF_ENDIF, 0, NULL, NULL},
@@ -61,16 +61,25 @@ NITFPRIV(NITF_BOOL) DirectBlockSource_read(NITF_DATA * data, void *buf,
                                            nitf_Error * error)
 {
     DirectBlockSourceImpl *directBlockSource = toDirectBlockSource(data, error);
-    const void* block;
+    const uint8_t* block;
     uint64_t blockSize;
 
     if (!directBlockSource)
         return NITF_FAILURE;
 
-    block = nitf_ImageIO_readBlockDirect(directBlockSource->imageReader->imageDeblocker,
-                                         directBlockSource->imageReader->input,
-                                         directBlockSource->blockNumber++,
-                                         &blockSize, error);
+    /* The block is only read here, so a mapped one needn't be copied first */
+    if (!nitf_ImageIO_readBlockMapped(directBlockSource->imageReader->imageDeblocker,
+                                      directBlockSource->imageReader->input,
+                                      directBlockSource->blockNumber,
+                                      &block, &blockSize, error))
+        return NITF_FAILURE;
+
+    if (!block)
+        block = nitf_ImageIO_readBlockDirect(directBlockSource->imageReader->imageDeblocker,
+                                             directBlockSource->imageReader->input,
+                                             directBlockSource->blockNumber,
+                                             &blockSize, error);
+    directBlockSource->blockNumber++;
     if(!block)
         return NITF_FAILURE;
 
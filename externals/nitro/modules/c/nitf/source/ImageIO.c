@@ -24,6 +24,32 @@
 
 #include "nitf/ImageIO.h"
 
+/*
+ *  Vector unformat and unpack functions. SSE2 is part of every x86-64 target
+ *  and NEON of every AArch64 one, so both are selected at compile time. AVX2
+ *  is compiled with a function target attribute and is only used when the
+ *  processor reports it at run time.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NITF_IMAGE_IO_SSE2
+#include <emmintrin.h>
+#if defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define NITF_IMAGE_IO_AVX2
+#define NITF_IMAGE_IO_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define NITF_IMAGE_IO_AVX2
+#define NITF_IMAGE_IO_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define NITF_IMAGE_IO_NEON
+#include <arm_neon.h>
+#endif
+
 
 /*!
   \file
@@ -525,6 +551,7 @@ typedef struct
     _NITF_IMAGE_IO_PAD_SCAN_FUNC padScanner; /*! Scans for pad pixels in write */
     /*! Total blocks written to disk */
     int64_t totalBlocksWritten;
+    int vectorFlag;             /*!< Use vector unformat/unpack if TRUE */
 } _nitf_ImageIO;
 
 /*!
@@ -1130,6 +1157,27 @@ by the user.
 /*!< nitf_ImageIO object */
 NITFPRIV(void) nitf_ImageIO_setUnpack(_nitf_ImageIO * nitf);
 
+/*!
+  \brief nitf_ImageIO_setVector - Select vector unformat and unpack functions
+
+  nitf_ImageIO_setVector replaces the unformat and unpack functions in the
+  vtbl field of the nitf argument with their vector equivalents for the
+  instruction set the processor supports, or with the scalar versions if
+  the vectorFlag field is FALSE. This function must be called whenever
+  either function is reset.
+
+  \b Note:
+
+This is an internal function and is not intended to be called directly
+by the user.
+
+\return None
+
+*/
+
+/*!< nitf_ImageIO object */
+NITFPRIV(void) nitf_ImageIO_setVector(_nitf_ImageIO * nitf);
+
 /*!
   \brief nitf_ImageIO_allocBlockArray -  Allocate the IO control structure's
   block array.
@@ -1844,6 +1892,37 @@ I/O error
 NITFPRIV(int) nitf_ImageIO_readRequest(_nitf_ImageIOControl * cntl, nitf_IOInterface* io, nitf_Error * error    /*!< Error object */
                                       );
 
+/*!
+  \brief nitf_ImageIO_readRequestBatch - Do the read request as one batch
+  of reads
+
+  nitf_ImageIO_readRequestBatch is nitf_ImageIO_readRequest for requests
+  that read straight into the user's buffer (uncompressed, no unpacking).
+  Each row segment's read is independent of the others, so the reads for
+  the whole sub-window are gathered and handed to the IO interface at once
+  with nitf_IOInterface_readBatch. An interface that does concurrent I/O
+  then has every read in flight together and completes them in any order.
+  Segments that are adjacent in both the file and the buffer, like the rows
+  of a block that is as wide as the sub-window, are merged into one read.
+
+  \b Note:
+
+  This is an internal function and is not intended to be called
+directly by the user.
+
+On error, FALSE is returned and error is set.
+
+Possible errors include:
+
+Memory allocation error
+I/O error
+*/
+
+/*!< The control structure */
+/*!< I/O handle */
+NITFPRIV(int) nitf_ImageIO_readRequestBatch(_nitf_ImageIOControl * cntl, nitf_IOInterface* io, nitf_Error * error    /*!< Error object */
+                                           );
+
 /*!
   \brief nitf_ImageIO_readRequestDownSample - Do the read request with
   down-smapling
@@ -3155,6 +3234,7 @@ NITFPROT(nitf_ImageIO *) nitf_ImageIO_construct(
     }
     /* Initialize all fields to zero */
     memset(nitf, 0, sizeof(_nitf_ImageIO));
+    nitf->vectorFlag = 1;
 
     /*   Adjust block column and row counts for 2500C  */
     if ((nBlocksPerColumn == 1) && (numRowsPerBlock == 0))
@@ -3246,6 +3326,7 @@ NITFPROT(nitf_ImageIO *) nitf_ImageIO_construct(
     }
 
     nitf_ImageIO_setUnpack(nitf);
+    nitf_ImageIO_setVector(nitf);
     nitf_ImageIO_setIO(nitf);
 
     /* Call the compressor open function if the compressor is not NULL */
@@ -3492,6 +3573,94 @@ NITFPROT(NITF_BOOL) nitf_ImageIO_read(nitf_ImageIO * nitf,
 }
 
 
+NITFPROT(NITF_BOOL) nitf_ImageIO_readDirect(nitf_ImageIO * nitf,
+                                            nitf_IOInterface* io,
+                                            nitf_SubWindow * subWindow,
+                                            const uint8_t ** data,
+                                            nitf_Error * error)
+{
+    _nitf_ImageIO *nitfI;       /* Internal version of nitf */
+    int all;                    /* Full image read flag */
+    nitf_BlockingInfo *blockInfo; /* For get blocking info call */
+    size_t rowBytes;            /* Bytes in one row of a block */
+    uint32_t firstBlock;        /* First block row in the request */
+    uint32_t lastBlock;         /* Last block row in the request */
+    uint32_t block;             /* Current block row */
+    uint64_t offset;            /* Offset of the request in the image data */
+    size_t count;               /* Size of the request in bytes */
+
+    nitfI = (_nitf_ImageIO *) nitf;
+    *data = NULL;
+
+    if (!nitf_MMapAdapter_isMapped(io))
+        return NITF_SUCCESS;
+
+    if ((nitfI->writeControl != NULL) || (nitfI->readControl != NULL))
+    {
+        nitf_Error_initf(error, NITF_CTXT, NITF_ERR_MEMORY,
+                         "I/O operation in progress");
+        return NITF_FAILURE;
+    }
+
+    /* *possibly* revert the optimized modes */
+    nitf_ImageIO_revertOptimizedModes(nitfI, subWindow->numBands);
+
+    blockInfo = nitf_ImageIO_getBlockingInfo(nitf, io, error);
+    if (blockInfo == NULL)
+        return NITF_FAILURE;
+
+    /* Not needed */
+    nitf_BlockingInfo_destruct(&blockInfo);
+
+    if (!nitf_ImageIO_checkSubWindow(nitfI, subWindow, &all, error))
+        return NITF_FAILURE;
+
+    /*
+     *  The pixels must be stored exactly as they would be returned: one
+     *  band (or an optimized IQ or RGB pixel), uncompressed and unmasked,
+     *  whole bytes that need no swapping or sign extension, and blocks
+     *  that span full rows.  The optimized modes count as one band.
+     */
+    if ((subWindow->numBands != 1) || (nitfI->numBands != 1)
+        || ((subWindow->downsampler != NULL)
+            && ((subWindow->downsampler->rowSkip != 1)
+                || (subWindow->downsampler->colSkip != 1)))
+        || (nitfI->compression != NITF_IMAGE_IO_COMPRESSION_NC)
+        || (nitfI->pixel.type == NITF_IMAGE_IO_PIXEL_TYPE_B)
+        || (nitfI->pixel.type == NITF_IMAGE_IO_PIXEL_TYPE_12)
+        || (nitfI->vtbl.unformat != NULL)
+        || (nitfI->nBlocksPerRow != 1))
+        return NITF_SUCCESS;
+
+    /* Partial rows are only contiguous if there's just one of them */
+    if ((subWindow->numRows != 1)
+        && ((subWindow->startCol != 0)
+            || (subWindow->numCols != nitfI->numColumnsPerBlock)))
+        return NITF_SUCCESS;
+
+    /* The blocks must be back to back in the file */
+    rowBytes = (size_t) nitfI->numColumnsPerBlock * nitfI->pixel.bytes;
+    firstBlock = subWindow->startRow / nitfI->numRowsPerBlock;
+    lastBlock = (subWindow->startRow + subWindow->numRows - 1)
+        / nitfI->numRowsPerBlock;
+    for (block = firstBlock; block < lastBlock; block++)
+    {
+        if (nitfI->blockMask[block + 1]
+            != nitfI->blockMask[block] + nitfI->blockSize)
+            return NITF_SUCCESS;
+    }
+
+    offset = nitfI->pixelBase + nitfI->blockMask[firstBlock]
+        + (uint64_t) (subWindow->startRow % nitfI->numRowsPerBlock) * rowBytes
+        + (uint64_t) subWindow->startCol * nitfI->pixel.bytes;
+    count = (size_t) (subWindow->numRows - 1) * rowBytes
+        + (size_t) subWindow->numCols * nitfI->pixel.bytes;
+
+    *data = (const uint8_t *) nitf_MMapAdapter_getData(io, (nitf_Off) offset,
+                                                       count, error);
+    return *data != NULL;
+}
+
 NITFPROT(NITF_BOOL) nitf_ImageIO_writeDone(nitf_ImageIO * object,
                                            nitf_IOInterface* io,
                                            nitf_Error * error)
@@ -3975,6 +4144,19 @@ NITFPROT(void) nitf_ImageIO_setReadCaching(nitf_ImageIO * nitf)
     return;
 }
 
+NITFPROT(int) nitf_ImageIO_setVectorization(nitf_ImageIO * nitf, int enable)
+{
+    _nitf_ImageIO *initf;   /* Internal representation of object */
+    int saved;              /* Saved result */
+
+    initf = (_nitf_ImageIO *) nitf;
+    saved = initf->vectorFlag;
+    initf->vectorFlag = enable ? 1 : 0;
+    nitf_ImageIO_setVector(initf);
+
+    return saved;
+}
+
 /*=================== nitf_BlockingInfo_print ================================*/
 
 NITFPROT(void) nitf_BlockingInfo_print(nitf_BlockingInfo * info,
@@ -4052,10 +4234,11 @@ NITFPRIV(void) nitf_ImageIO_revertOptimizedModes(_nitf_ImageIO *nitfI, int numBa
                     break;
                 default:
                     /* No optimized mode */
-                    return;
+                    break;
             }
         }
     }
+    nitf_ImageIO_setVector(nitfI);
 }
 
 
@@ -6772,6 +6955,12 @@ NITFPRIV(int) nitf_ImageIO_readRequest(_nitf_ImageIOControl * cntl,
     numBands = cntl->numBandSubset;
     nBlockCols = cntl->nBlockIO / numBands;
 
+    if ((nitf->vtbl.reader == nitf_ImageIO_uncachedReader)
+            && (nitf->vtbl.unpack == NULL))
+    {
+        return nitf_ImageIO_readRequestBatch(cntl, io, error);
+    }
+
     for (col = 0; col < nBlockCols; col++)
     {
         for (row = 0; row < numRows; row++)
@@ -6833,6 +7022,140 @@ NITFPRIV(int) nitf_ImageIO_readRequest(_nitf_ImageIOControl * cntl,
     return 1;
 }
 
+NITFPRIV(int) nitf_ImageIO_readRequestBatch(_nitf_ImageIOControl * cntl,
+                                            nitf_IOInterface* io,
+                                            nitf_Error * error)
+{
+    _nitf_ImageIO *nitf;       /* Parent _nitf_ImageIO object */
+    uint32_t nBlockCols;    /* Number of block columns */
+    uint32_t numRows;       /* Number of rows in the requested sub-window */
+    uint32_t numBands;      /* Number of bands */
+    uint32_t col;           /* Block column index */
+    uint32_t row;           /* Current row in sub-window */
+    uint32_t band;          /* Current band in sub-window */
+    _nitf_ImageIOBlock *blockIO; /* The current block IO structure */
+    nitf_IORequest *requests;   /* The reads, in the order they're found */
+    nitf_IORequest *last;       /* The last read, if any */
+    size_t numRequests;         /* Number of reads */
+    size_t idx;                 /* Index into requests */
+    uint64_t offset;            /* File offset of this row segment */
+    uint8_t *buffer;            /* Where this row segment goes */
+    int ret;
+
+    nitf = cntl->nitf;
+    numRows = cntl->numRows;
+    numBands = cntl->numBandSubset;
+    nBlockCols = cntl->nBlockIO / numBands;
+
+    /* At most one read per row segment */
+    requests = (nitf_IORequest *) NITF_MALLOC(sizeof(nitf_IORequest) *
+            ((size_t)nBlockCols) * numRows * numBands);
+    if (requests == NULL)
+    {
+        nitf_Error_initf(error, NITF_CTXT, NITF_ERR_MEMORY,
+                         "Error allocating read requests: %s",
+                         NITF_STRERROR(NITF_ERRNO));
+        return NITF_FAILURE;
+    }
+    numRequests = 0;
+
+    /* Walk the row segments as nitf_ImageIO_readRequest does */
+    for (col = 0; col < nBlockCols; col++)
+    {
+        for (row = 0; row < numRows; row++)
+        {
+            for (band = 0; band < numBands; band++)
+            {
+                blockIO = &(cntl->blockIO[col][band]);
+                if (!blockIO->doIO)
+                {
+                    /* Nothing to read */
+                }
+                else if (blockIO->imageDataOffset == NITF_IMAGE_IO_NO_OFFSET)
+                {
+                    if (!nitf_ImageIO_readPad(blockIO, error))
+                    {
+                        NITF_FREE(requests);
+                        return NITF_FAILURE;
+                    }
+                    cntl->padded = 1;
+                }
+                else
+                {
+                    offset = nitf->pixelBase + blockIO->imageDataOffset +
+                        blockIO->blockOffset.mark;
+                    buffer = blockIO->rwBuffer.buffer +
+                        blockIO->rwBuffer.offset.mark;
+
+                    last = (numRequests > 0) ?
+                        &(requests[numRequests - 1]) : NULL;
+                    if ((last != NULL)
+                            && ((uint64_t) last->offset + last->size == offset)
+                            && ((uint8_t *) last->buf + last->size == buffer))
+                    {
+                        last->size += blockIO->readCount;
+                    }
+                    else
+                    {
+                        requests[numRequests].offset = (nitf_Off) offset;
+                        requests[numRequests].buf = buffer;
+                        requests[numRequests].size = blockIO->readCount;
+                        numRequests += 1;
+                    }
+
+                    if (blockIO->padMask[blockIO->number] !=
+                            NITF_IMAGE_IO_NO_OFFSET)
+                        cntl->padded = 1;
+                }
+
+                /*
+                 * Pad and skipped segments aren't read, so they can be
+                 * formatted now; the rest are formatted once read
+                 */
+                if ((nitf->vtbl.unformat != NULL)
+                        && (!blockIO->doIO || (blockIO->imageDataOffset
+                                == NITF_IMAGE_IO_NO_OFFSET)))
+                {
+                    (*(nitf->vtbl.unformat)) (blockIO->user.buffer +
+                        blockIO->user.offset.mark,
+                        blockIO->pixelCountDR,
+                        nitf->pixel.shift);
+                }
+
+                /* See nitf_ImageIO_readRequest */
+                if (row != numRows - 1)
+                {
+                    nitf_ImageIO_nextRow(blockIO, 0);
+                }
+
+                if (blockIO->rowsUntil == 0)
+                {
+                    blockIO->rowsUntil = nitf->numRowsPerBlock - 1;
+                }
+                else
+                {
+                    blockIO->rowsUntil -= 1;
+                }
+            }
+        }
+    }
+
+    ret = nitf_IOInterface_readBatch(io, requests, numRequests, error);
+    if (ret && (nitf->vtbl.unformat != NULL))
+    {
+        /* The user buffer is the read buffer */
+        for (idx = 0; idx < numRequests; idx++)
+        {
+            (*(nitf->vtbl.unformat)) ((uint8_t *) requests[idx].buf,
+                requests[idx].size / nitf->pixel.bytes,
+                nitf->pixel.shift);
+        }
+    }
+
+    NITF_FREE(requests);
+    return ret ? NITF_SUCCESS : NITF_FAILURE;
+}
+
 /* This function is used when FR != DR (down-Sampling) */
 NITFPRIV(int) nitf_ImageIO_readRequestDownSample(_nitf_ImageIOControl *
                                                  cntl,
@@ -7610,6 +7933,37 @@ NITFPROT(uint8_t*) nitf_ImageIO_readBlockDirect(nitf_ImageIO* nitf,
     return nitfI->blockControl.block;
 }
 
+NITFPROT(NITF_BOOL) nitf_ImageIO_readBlockMapped(nitf_ImageIO* nitf,
+                                                 nitf_IOInterface* io,
+                                                 uint32_t blockNumber,
+                                                 const uint8_t** block,
+                                                 uint64_t* blockSize,
+                                                 nitf_Error * error)
+{
+    _nitf_ImageIO *nitfI;        /* Associated ImageIO object */
+    uint64_t imageDataOffset;
+
+    nitfI = (_nitf_ImageIO*) nitf;
+    *block = NULL;
+
+    /* Only uncompressed blocks are stored as they're read */
+    if (!nitf_MMapAdapter_isMapped(io)
+        || (nitfI->pixel.type == NITF_IMAGE_IO_PIXEL_TYPE_B)
+        || (nitfI->pixel.type == NITF_IMAGE_IO_PIXEL_TYPE_12)
+        || !(nitfI->compression & NITF_IMAGE_IO_NO_COMPRESSION))
+        return NITF_SUCCESS;
+
+    imageDataOffset = nitfI->blockMask[blockNumber];
+    *block = (const uint8_t *) nitf_MMapAdapter_getData(
+            io, (nitf_Off) (nitfI->pixelBase + imageDataOffset),
+            nitfI->blockSize, error);
+    if (*block == NULL)
+        return NITF_FAILURE;
+
+    *blockSize = nitfI->blockSize;
+    return NITF_SUCCESS;
+}
+
 /*========================= End Direct Block Reading  ================================*/
 /*========================= Start Direct Block Writing  ================================*/
 
@@ -8255,7 +8609,7 @@ void nitf_ImageIO_unformatSwapExtend_2(uint8_t * buffer,
     uint8_t *bp8;            /* Buffer pointer, 8 bit */
     int16_t *bp16;           /* Buffer pointer, 16 bit */
     uint8_t tmp8;            /* Temp value, 8 bit */
-    uint16_t tmp16;          /* Temp value, 16 bit */
+    int16_t tmp16;           /* Temp value, 16 bit */
     size_t i;
 
     shift = (int16_t) shiftCount;
@@ -8283,14 +8637,14 @@ void nitf_ImageIO_unformatSwapExtend_4(uint8_t * buffer,
     uint8_t *bp8;            /* Buffer pointer, 8 bit */
     int32_t *bp32;           /* Buffer pointer, 32 bit */
     uint8_t tmp8;            /* Temp value, 8 bit */
-    uint8_t tmp32;           /* Temp value, 32 bit */
+    int32_t tmp32;           /* Temp value, 32 bit */
     size_t i;
 
     shift = (int32_t) shiftCount;
     bp32 = (int32_t *) buffer;
     for (i = 0; i < count; i++)
     {
-        bp8 = (uint8_t *) (bp32++);
+        bp8 = (uint8_t *) bp32;
 
         tmp8 = bp8[0];
         bp8[0] = bp8[3];
@@ -8299,7 +8653,7 @@ void nitf_ImageIO_unformatSwapExtend_4(uint8_t * buffer,
         bp8[1] = bp8[2];
         bp8[2] = tmp8;
 
-        tmp32 = (uint8_t)(*bp32 << shift);
+        tmp32 = *bp32 << shift;
         *(bp32++) = tmp32 >> shift;
     }
 
@@ -8316,7 +8670,7 @@ void nitf_ImageIO_unformatSwapExtend_8(uint8_t * buffer,
     uint8_t *bp8;            /* Buffer pointer, 8 bit */
     int64_t *bp64;           /* Buffer pointer, 64 bit */
     uint8_t tmp8;            /* Temp value, 8 bit */
-    uint64_t tmp64;          /* Temp value, 64 bit */
+    int64_t tmp64;           /* Temp value, 64 bit */
     size_t i;
 
     shift = (int64_t) shiftCount;
@@ -8695,6 +9049,681 @@ void nitf_ImageIO_unpack_P_16(_nitf_ImageIOBlock * blockIO,
     return;
 }
 
+/*========================= Vector unformat and unpack =======================*/
+
+/*
+ *  The vector unformat functions are generated by the macros below, one per
+ *  instruction set. Each transforms as many whole vectors as the buffer holds
+ *  and hands the remainder to the scalar function it replaces. The "expr"
+ *  argument transforms the vector "v" using the shift count "s".
+ *
+ *  The complex swaps reuse the swap of the component size. Arithmetic shifts
+ *  of 8 byte pixels have no SSE2 or AVX2 instruction and stay scalar there.
+ */
+
+#ifdef NITF_IMAGE_IO_SSE2
+
+#define NITF_IMAGE_IO_SSE2_SWAP2(v) \
+    _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8))
+
+#define NITF_IMAGE_IO_SSE2_SWAP4(v)                                       \
+    _mm_shufflehi_epi16(_mm_shufflelo_epi16(NITF_IMAGE_IO_SSE2_SWAP2(v),  \
+                                            _MM_SHUFFLE(2, 3, 0, 1)),     \
+                        _MM_SHUFFLE(2, 3, 0, 1))
+
+#define NITF_IMAGE_IO_SSE2_SWAP8(v)                                       \
+    _mm_shufflehi_epi16(_mm_shufflelo_epi16(NITF_IMAGE_IO_SSE2_SWAP2(v),  \
+                                            _MM_SHUFFLE(0, 1, 2, 3)),     \
+                        _MM_SHUFFLE(0, 1, 2, 3))
+
+#define NITF_IMAGE_IO_SSE2_UNFORMAT(name, bytes, scalar, expr)             \
+NITFPRIV(void) name(uint8_t * buffer, size_t count, uint32_t shiftCount)   \
+{                                                                          \
+    const __m128i s = _mm_cvtsi32_si128((int) shiftCount);                 \
+    const size_t step = 16 / (bytes);                                      \
+    size_t i;                                                              \
+                                                                           \
+    (void)s;                                                               \
+    for (i = 0; i + step <= count; i += step)                              \
+    {                                                                      \
+        __m128i *p = (__m128i *) (buffer + i * (bytes));                   \
+        const __m128i v = _mm_loadu_si128(p);                              \
+        _mm_storeu_si128(p, expr);                                         \
+    }                                                                      \
+    scalar(buffer + i * (bytes), count - i, shiftCount);                   \
+}
+
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapOnly_2, 2,
+        nitf_ImageIO_swapOnly_2, NITF_IMAGE_IO_SSE2_SWAP2(v))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapOnly_4, 4,
+        nitf_ImageIO_swapOnly_4, NITF_IMAGE_IO_SSE2_SWAP4(v))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapOnly_8, 8,
+        nitf_ImageIO_swapOnly_8, NITF_IMAGE_IO_SSE2_SWAP8(v))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapOnly_4c, 4,
+        nitf_ImageIO_swapOnly_4c, NITF_IMAGE_IO_SSE2_SWAP2(v))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapOnly_8c, 8,
+        nitf_ImageIO_swapOnly_8c, NITF_IMAGE_IO_SSE2_SWAP4(v))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapOnly_16c, 16,
+        nitf_ImageIO_swapOnly_16c, NITF_IMAGE_IO_SSE2_SWAP8(v))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2Shift_2, 2,
+        nitf_ImageIO_unformatShift_2, _mm_sra_epi16(v, s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2Shift_4, 4,
+        nitf_ImageIO_unformatShift_4, _mm_sra_epi32(v, s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2UShift_2, 2,
+        nitf_ImageIO_unformatUShift_2, _mm_srl_epi16(v, s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2UShift_4, 4,
+        nitf_ImageIO_unformatUShift_4, _mm_srl_epi32(v, s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2UShift_8, 8,
+        nitf_ImageIO_unformatUShift_8, _mm_srl_epi64(v, s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2Extend_2, 2,
+        nitf_ImageIO_unformatExtend_2,
+        _mm_sra_epi16(_mm_sll_epi16(v, s), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2Extend_4, 4,
+        nitf_ImageIO_unformatExtend_4,
+        _mm_sra_epi32(_mm_sll_epi32(v, s), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapShift_2, 2,
+        nitf_ImageIO_unformatSwapShift_2,
+        _mm_sra_epi16(NITF_IMAGE_IO_SSE2_SWAP2(v), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapShift_4, 4,
+        nitf_ImageIO_unformatSwapShift_4,
+        _mm_sra_epi32(NITF_IMAGE_IO_SSE2_SWAP4(v), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapUShift_2, 2,
+        nitf_ImageIO_unformatSwapUShift_2,
+        _mm_srl_epi16(NITF_IMAGE_IO_SSE2_SWAP2(v), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapUShift_4, 4,
+        nitf_ImageIO_unformatSwapUShift_4,
+        _mm_srl_epi32(NITF_IMAGE_IO_SSE2_SWAP4(v), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapUShift_8, 8,
+        nitf_ImageIO_unformatSwapUShift_8,
+        _mm_srl_epi64(NITF_IMAGE_IO_SSE2_SWAP8(v), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapExtend_2, 2,
+        nitf_ImageIO_unformatSwapExtend_2,
+        _mm_sra_epi16(_mm_sll_epi16(NITF_IMAGE_IO_SSE2_SWAP2(v), s), s))
+NITF_IMAGE_IO_SSE2_UNFORMAT(nitf_ImageIO_sse2SwapExtend_4, 4,
+        nitf_ImageIO_unformatSwapExtend_4,
+        _mm_sra_epi32(_mm_sll_epi32(NITF_IMAGE_IO_SSE2_SWAP4(v), s), s))
+
+/*
+ *  The SSE2 unpack functions handle the common two band (I/Q) case and the
+ *  four band byte case. Vectors stop short of the last pixel so that no load
+ *  reaches past the end of the pixel data.
+ */
+
+NITFPRIV(void) nitf_ImageIO_sse2Unpack_P_1(_nitf_ImageIOBlock * blockIO,
+                                           nitf_Error * error)
+{
+    const uint32_t skip = blockIO->cntl->nitf->numBands;
+    const uint32_t bandOffset = blockIO->cntl->bandSubset[0];
+    const size_t count = blockIO->pixelCountFR;
+    const uint8_t *src = (const uint8_t *) (blockIO->rwBuffer.buffer
+                                            + blockIO->rwBuffer.offset.mark
+                                            + bandOffset);
+    uint8_t *dst = (uint8_t *) (blockIO->unpacked.buffer
+                                + blockIO->unpacked.offset.mark);
+    size_t i = 0;
+
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    if (skip == 2)
+    {
+        const __m128i mask = _mm_set1_epi16(0x00FF);
+        for (; i + 16 < count; i += 16)
+        {
+            const __m128i a =
+                _mm_loadu_si128((const __m128i *) (src + 2 * i));
+            const __m128i b =
+                _mm_loadu_si128((const __m128i *) (src + 2 * i + 16));
+            _mm_storeu_si128((__m128i *) (dst + i),
+                             _mm_packus_epi16(_mm_and_si128(a, mask),
+                                              _mm_and_si128(b, mask)));
+        }
+    }
+    else if (skip == 4)
+    {
+        const __m128i mask = _mm_set1_epi32(0x000000FF);
+        for (; i + 16 < count; i += 16)
+        {
+            const __m128i *p = (const __m128i *) (src + 4 * i);
+            const __m128i ab =
+                _mm_packs_epi32(_mm_and_si128(_mm_loadu_si128(p), mask),
+                                _mm_and_si128(_mm_loadu_si128(p + 1), mask));
+            const __m128i cd =
+                _mm_packs_epi32(_mm_and_si128(_mm_loadu_si128(p + 2), mask),
+                                _mm_and_si128(_mm_loadu_si128(p + 3), mask));
+            _mm_storeu_si128((__m128i *) (dst + i),
+                             _mm_packus_epi16(ab, cd));
+        }
+    }
+
+    for (; i < count; i++)
+        dst[i] = src[i * skip];
+    return;
+}
+
+
+NITFPRIV(void) nitf_ImageIO_sse2Unpack_P_2(_nitf_ImageIOBlock * blockIO,
+                                           nitf_Error * error)
+{
+    const uint32_t skip = blockIO->cntl->nitf->numBands;
+    const uint32_t bandOffset = blockIO->cntl->bandSubset[0] * 2;
+    const size_t count = blockIO->pixelCountFR;
+    const uint16_t *src = (const uint16_t *) (blockIO->rwBuffer.buffer
+                                              + blockIO->rwBuffer.offset.mark
+                                              + bandOffset);
+    uint16_t *dst = (uint16_t *) (blockIO->unpacked.buffer
+                                  + blockIO->unpacked.offset.mark);
+    size_t i = 0;
+
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    if (skip == 2)
+    {
+        /* Sign extend the low half of each pair so the pack is exact */
+        for (; i + 8 < count; i += 8)
+        {
+            const __m128i a =
+                _mm_loadu_si128((const __m128i *) (src + 2 * i));
+            const __m128i b =
+                _mm_loadu_si128((const __m128i *) (src + 2 * i + 8));
+            _mm_storeu_si128((__m128i *) (dst + i),
+                _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                _mm_srai_epi32(_mm_slli_epi32(b, 16), 16)));
+        }
+    }
+
+    for (; i < count; i++)
+        dst[i] = src[i * skip];
+    return;
+}
+
+
+NITFPRIV(void) nitf_ImageIO_sse2Unpack_P_4(_nitf_ImageIOBlock * blockIO,
+                                           nitf_Error * error)
+{
+    const uint32_t skip = blockIO->cntl->nitf->numBands;
+    const uint32_t bandOffset = blockIO->cntl->bandSubset[0] * 4;
+    const size_t count = blockIO->pixelCountFR;
+    const uint32_t *src = (const uint32_t *) (blockIO->rwBuffer.buffer
+                                              + blockIO->rwBuffer.offset.mark
+                                              + bandOffset);
+    uint32_t *dst = (uint32_t *) (blockIO->unpacked.buffer
+                                  + blockIO->unpacked.offset.mark);
+    size_t i = 0;
+
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    if (skip == 2)
+    {
+        for (; i + 4 < count; i += 4)
+        {
+            const __m128i a = _mm_shuffle_epi32(
+                _mm_loadu_si128((const __m128i *) (src + 2 * i)),
+                _MM_SHUFFLE(3, 1, 2, 0));
+            const __m128i b = _mm_shuffle_epi32(
+                _mm_loadu_si128((const __m128i *) (src + 2 * i + 4)),
+                _MM_SHUFFLE(3, 1, 2, 0));
+            _mm_storeu_si128((__m128i *) (dst + i),
+                             _mm_unpacklo_epi64(a, b));
+        }
+    }
+
+    for (; i < count; i++)
+        dst[i] = src[i * skip];
+    return;
+}
+
+
+NITFPRIV(void) nitf_ImageIO_sse2Unpack_P_8(_nitf_ImageIOBlock * blockIO,
+                                           nitf_Error * error)
+{
+    const uint32_t skip = blockIO->cntl->nitf->numBands;
+    const uint32_t bandOffset = blockIO->cntl->bandSubset[0] * 8;
+    const size_t count = blockIO->pixelCountFR;
+    const uint64_t *src = (const uint64_t *) (blockIO->rwBuffer.buffer
+                                              + blockIO->rwBuffer.offset.mark
+                                              + bandOffset);
+    uint64_t *dst = (uint64_t *) (blockIO->unpacked.buffer
+                                  + blockIO->unpacked.offset.mark);
+    size_t i = 0;
+
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    if (skip == 2)
+    {
+        for (; i + 2 < count; i += 2)
+        {
+            _mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi64(
+                _mm_loadu_si128((const __m128i *) (src + 2 * i)),
+                _mm_loadu_si128((const __m128i *) (src + 2 * i + 2))));
+        }
+    }
+
+    for (; i < count; i++)
+        dst[i] = src[i * skip];
+    return;
+}
+
+#endif /* NITF_IMAGE_IO_SSE2 */
+
+#ifdef NITF_IMAGE_IO_AVX2
+
+#define NITF_IMAGE_IO_AVX2_SWAP(v, b0, b1, b2, b3, b4, b5, b6, b7)         \
+    _mm256_shuffle_epi8(v, _mm256_setr_epi8(                               \
+        b0, b1, b2, b3, b4, b5, b6, b7,                                    \
+        b0 + 8, b1 + 8, b2 + 8, b3 + 8, b4 + 8, b5 + 8, b6 + 8, b7 + 8,    \
+        b0, b1, b2, b3, b4, b5, b6, b7,                                    \
+        b0 + 8, b1 + 8, b2 + 8, b3 + 8, b4 + 8, b5 + 8, b6 + 8, b7 + 8))
+
+#define NITF_IMAGE_IO_AVX2_SWAP2(v) \
+    NITF_IMAGE_IO_AVX2_SWAP(v, 1, 0, 3, 2, 5, 4, 7, 6)
+
+#define NITF_IMAGE_IO_AVX2_SWAP4(v) \
+    NITF_IMAGE_IO_AVX2_SWAP(v, 3, 2, 1, 0, 7, 6, 5, 4)
+
+#define NITF_IMAGE_IO_AVX2_SWAP8(v) \
+    NITF_IMAGE_IO_AVX2_SWAP(v, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define NITF_IMAGE_IO_AVX2_UNFORMAT(name, bytes, scalar, expr)             \
+NITF_IMAGE_IO_AVX2_TARGET                                                  \
+NITFPRIV(void) name(uint8_t * buffer, size_t count, uint32_t shiftCount)   \
+{                                                                          \
+    const __m128i s = _mm_cvtsi32_si128((int) shiftCount);                 \
+    const size_t step = 32 / (bytes);                                      \
+    size_t i;                                                              \
+                                                                           \
+    (void)s;                                                               \
+    for (i = 0; i + step <= count; i += step)                              \
+    {                                                                      \
+        __m256i *p = (__m256i *) (buffer + i * (bytes));                   \
+        const __m256i v = _mm256_loadu_si256(p);                           \
+        _mm256_storeu_si256(p, expr);                                      \
+    }                                                                      \
+    scalar(buffer + i * (bytes), count - i, shiftCount);                   \
+}
+
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapOnly_2, 2,
+        nitf_ImageIO_swapOnly_2, NITF_IMAGE_IO_AVX2_SWAP2(v))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapOnly_4, 4,
+        nitf_ImageIO_swapOnly_4, NITF_IMAGE_IO_AVX2_SWAP4(v))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapOnly_8, 8,
+        nitf_ImageIO_swapOnly_8, NITF_IMAGE_IO_AVX2_SWAP8(v))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapOnly_4c, 4,
+        nitf_ImageIO_swapOnly_4c, NITF_IMAGE_IO_AVX2_SWAP2(v))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapOnly_8c, 8,
+        nitf_ImageIO_swapOnly_8c, NITF_IMAGE_IO_AVX2_SWAP4(v))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapOnly_16c, 16,
+        nitf_ImageIO_swapOnly_16c, NITF_IMAGE_IO_AVX2_SWAP8(v))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2Shift_2, 2,
+        nitf_ImageIO_unformatShift_2, _mm256_sra_epi16(v, s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2Shift_4, 4,
+        nitf_ImageIO_unformatShift_4, _mm256_sra_epi32(v, s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2UShift_2, 2,
+        nitf_ImageIO_unformatUShift_2, _mm256_srl_epi16(v, s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2UShift_4, 4,
+        nitf_ImageIO_unformatUShift_4, _mm256_srl_epi32(v, s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2UShift_8, 8,
+        nitf_ImageIO_unformatUShift_8, _mm256_srl_epi64(v, s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2Extend_2, 2,
+        nitf_ImageIO_unformatExtend_2,
+        _mm256_sra_epi16(_mm256_sll_epi16(v, s), s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2Extend_4, 4,
+        nitf_ImageIO_unformatExtend_4,
+        _mm256_sra_epi32(_mm256_sll_epi32(v, s), s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapShift_2, 2,
+        nitf_ImageIO_unformatSwapShift_2,
+        _mm256_sra_epi16(NITF_IMAGE_IO_AVX2_SWAP2(v), s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapShift_4, 4,
+        nitf_ImageIO_unformatSwapShift_4,
+        _mm256_sra_epi32(NITF_IMAGE_IO_AVX2_SWAP4(v), s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapUShift_2, 2,
+        nitf_ImageIO_unformatSwapUShift_2,
+        _mm256_srl_epi16(NITF_IMAGE_IO_AVX2_SWAP2(v), s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapUShift_4, 4,
+        nitf_ImageIO_unformatSwapUShift_4,
+        _mm256_srl_epi32(NITF_IMAGE_IO_AVX2_SWAP4(v), s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapUShift_8, 8,
+        nitf_ImageIO_unformatSwapUShift_8,
+        _mm256_srl_epi64(NITF_IMAGE_IO_AVX2_SWAP8(v), s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapExtend_2, 2,
+        nitf_ImageIO_unformatSwapExtend_2,
+        _mm256_sra_epi16(_mm256_sll_epi16(NITF_IMAGE_IO_AVX2_SWAP2(v), s),
+                         s))
+NITF_IMAGE_IO_AVX2_UNFORMAT(nitf_ImageIO_avx2SwapExtend_4, 4,
+        nitf_ImageIO_unformatSwapExtend_4,
+        _mm256_sra_epi32(_mm256_sll_epi32(NITF_IMAGE_IO_AVX2_SWAP4(v), s),
+                         s))
+
+/* AVX2 shuffles don't cross 128 bit lanes, so unpacking stays with SSE2 */
+
+NITFPRIV(int) nitf_ImageIO_haveAVX2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return 0;
+
+    /* The OS must save the YMM registers (OSXSAVE, AVX and XCR0) */
+    __cpuid(info, 1);
+    if ((info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6)
+        return 0;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & 0x20) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif /* NITF_IMAGE_IO_AVX2 */
+
+#ifdef NITF_IMAGE_IO_NEON
+
+/* NEON shifts right by shifting left a negative count */
+#define NITF_IMAGE_IO_NEON_SHL(v, t, n, count)                             \
+    vreinterpretq_u8_##t##n(vshlq_##t##n(vreinterpretq_##t##n##_u8(v),     \
+                                         vdupq_n_s##n((int##n##_t) (count))))
+
+#define NITF_IMAGE_IO_NEON_EXTEND(v, n, count)                             \
+    NITF_IMAGE_IO_NEON_SHL(NITF_IMAGE_IO_NEON_SHL(v, s, n, count),         \
+                           s, n, -(count))
+
+#define NITF_IMAGE_IO_NEON_UNFORMAT(name, bytes, scalar, expr)             \
+NITFPRIV(void) name(uint8_t * buffer, size_t count, uint32_t shiftCount)   \
+{                                                                          \
+    const int shift = (int) shiftCount;                                    \
+    const size_t step = 16 / (bytes);                                      \
+    size_t i;                                                              \
+                                                                           \
+    (void)shift;                                                           \
+    for (i = 0; i + step <= count; i += step)                              \
+    {                                                                      \
+        uint8_t *p = buffer + i * (bytes);                                 \
+        const uint8x16_t v = vld1q_u8(p);                                  \
+        vst1q_u8(p, expr);                                                 \
+    }                                                                      \
+    scalar(buffer + i * (bytes), count - i, shiftCount);                   \
+}
+
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapOnly_2, 2,
+        nitf_ImageIO_swapOnly_2, vrev16q_u8(v))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapOnly_4, 4,
+        nitf_ImageIO_swapOnly_4, vrev32q_u8(v))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapOnly_8, 8,
+        nitf_ImageIO_swapOnly_8, vrev64q_u8(v))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapOnly_4c, 4,
+        nitf_ImageIO_swapOnly_4c, vrev16q_u8(v))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapOnly_8c, 8,
+        nitf_ImageIO_swapOnly_8c, vrev32q_u8(v))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapOnly_16c, 16,
+        nitf_ImageIO_swapOnly_16c, vrev64q_u8(v))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonShift_2, 2,
+        nitf_ImageIO_unformatShift_2,
+        NITF_IMAGE_IO_NEON_SHL(v, s, 16, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonShift_4, 4,
+        nitf_ImageIO_unformatShift_4,
+        NITF_IMAGE_IO_NEON_SHL(v, s, 32, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonShift_8, 8,
+        nitf_ImageIO_unformatShift_8,
+        NITF_IMAGE_IO_NEON_SHL(v, s, 64, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonUShift_2, 2,
+        nitf_ImageIO_unformatUShift_2,
+        NITF_IMAGE_IO_NEON_SHL(v, u, 16, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonUShift_4, 4,
+        nitf_ImageIO_unformatUShift_4,
+        NITF_IMAGE_IO_NEON_SHL(v, u, 32, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonUShift_8, 8,
+        nitf_ImageIO_unformatUShift_8,
+        NITF_IMAGE_IO_NEON_SHL(v, u, 64, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonExtend_2, 2,
+        nitf_ImageIO_unformatExtend_2,
+        NITF_IMAGE_IO_NEON_EXTEND(v, 16, shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonExtend_4, 4,
+        nitf_ImageIO_unformatExtend_4,
+        NITF_IMAGE_IO_NEON_EXTEND(v, 32, shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonExtend_8, 8,
+        nitf_ImageIO_unformatExtend_8,
+        NITF_IMAGE_IO_NEON_EXTEND(v, 64, shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapShift_2, 2,
+        nitf_ImageIO_unformatSwapShift_2,
+        NITF_IMAGE_IO_NEON_SHL(vrev16q_u8(v), s, 16, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapShift_4, 4,
+        nitf_ImageIO_unformatSwapShift_4,
+        NITF_IMAGE_IO_NEON_SHL(vrev32q_u8(v), s, 32, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapShift_8, 8,
+        nitf_ImageIO_unformatSwapShift_8,
+        NITF_IMAGE_IO_NEON_SHL(vrev64q_u8(v), s, 64, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapUShift_2, 2,
+        nitf_ImageIO_unformatSwapUShift_2,
+        NITF_IMAGE_IO_NEON_SHL(vrev16q_u8(v), u, 16, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapUShift_4, 4,
+        nitf_ImageIO_unformatSwapUShift_4,
+        NITF_IMAGE_IO_NEON_SHL(vrev32q_u8(v), u, 32, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapUShift_8, 8,
+        nitf_ImageIO_unformatSwapUShift_8,
+        NITF_IMAGE_IO_NEON_SHL(vrev64q_u8(v), u, 64, -shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapExtend_2, 2,
+        nitf_ImageIO_unformatSwapExtend_2,
+        NITF_IMAGE_IO_NEON_EXTEND(vrev16q_u8(v), 16, shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapExtend_4, 4,
+        nitf_ImageIO_unformatSwapExtend_4,
+        NITF_IMAGE_IO_NEON_EXTEND(vrev32q_u8(v), 32, shift))
+NITF_IMAGE_IO_NEON_UNFORMAT(nitf_ImageIO_neonSwapExtend_8, 8,
+        nitf_ImageIO_unformatSwapExtend_8,
+        NITF_IMAGE_IO_NEON_EXTEND(vrev64q_u8(v), 64, shift))
+
+/*
+ *  The NEON structure loads deinterleave two, three or four bands directly.
+ *  As with SSE2, vectors stop short of the last pixel.
+ */
+
+#define NITF_IMAGE_IO_NEON_UNPACK(name, type, bytes, suffix)               \
+NITFPRIV(void) name(_nitf_ImageIOBlock * blockIO, nitf_Error * error)      \
+{                                                                          \
+    const uint32_t skip = blockIO->cntl->nitf->numBands;                   \
+    const uint32_t bandOffset = blockIO->cntl->bandSubset[0] * (bytes);    \
+    const size_t count = blockIO->pixelCountFR;                            \
+    const size_t step = 16 / (bytes);                                      \
+    const type *src = (const type *) (blockIO->rwBuffer.buffer             \
+                                      + blockIO->rwBuffer.offset.mark      \
+                                      + bandOffset);                       \
+    type *dst = (type *) (blockIO->unpacked.buffer                         \
+                          + blockIO->unpacked.offset.mark);                \
+    size_t i = 0;                                                          \
+                                                                           \
+    (void)error;                                                           \
+    if (skip == 2)                                                         \
+        for (; i + step < count; i += step)                                \
+            vst1q_##suffix(dst + i, vld2q_##suffix(src + 2 * i).val[0]);   \
+    else if (skip == 3)                                                    \
+        for (; i + step < count; i += step)                                \
+            vst1q_##suffix(dst + i, vld3q_##suffix(src + 3 * i).val[0]);   \
+    else if (skip == 4)                                                    \
+        for (; i + step < count; i += step)                                \
+            vst1q_##suffix(dst + i, vld4q_##suffix(src + 4 * i).val[0]);   \
+                                                                           \
+    for (; i < count; i++)                                                 \
+        dst[i] = src[i * skip];                                            \
+}
+
+NITF_IMAGE_IO_NEON_UNPACK(nitf_ImageIO_neonUnpack_P_1, uint8_t, 1, u8)
+NITF_IMAGE_IO_NEON_UNPACK(nitf_ImageIO_neonUnpack_P_2, uint16_t, 2, u16)
+NITF_IMAGE_IO_NEON_UNPACK(nitf_ImageIO_neonUnpack_P_4, uint32_t, 4, u32)
+
+#endif /* NITF_IMAGE_IO_NEON */
+
+/*
+ *  Instruction sets, used as indexes into the function tables below. Each
+ *  table row holds a scalar function followed by its vector equivalents, NULL
+ *  where an instruction set has none.
+ */
+
+#define NITF_IMAGE_IO_VECTOR_NONE 0
+#define NITF_IMAGE_IO_VECTOR_SSE2 1
+#define NITF_IMAGE_IO_VECTOR_AVX2 2
+#define NITF_IMAGE_IO_VECTOR_NEON 3
+#define NITF_IMAGE_IO_VECTOR_COUNT 4
+
+#ifdef NITF_IMAGE_IO_SSE2
+#define NITF_IMAGE_IO_SSE2_FUNC(name) nitf_ImageIO_sse2##name
+#else
+#define NITF_IMAGE_IO_SSE2_FUNC(name) NULL
+#endif
+
+#ifdef NITF_IMAGE_IO_AVX2
+#define NITF_IMAGE_IO_AVX2_FUNC(name) nitf_ImageIO_avx2##name
+#else
+#define NITF_IMAGE_IO_AVX2_FUNC(name) NULL
+#endif
+
+#ifdef NITF_IMAGE_IO_NEON
+#define NITF_IMAGE_IO_NEON_FUNC(name) nitf_ImageIO_neon##name
+#else
+#define NITF_IMAGE_IO_NEON_FUNC(name) NULL
+#endif
+
+#define NITF_IMAGE_IO_VECTOR_ROW(scalar, name)                             \
+    { { scalar, NITF_IMAGE_IO_SSE2_FUNC(name),                            \
+        NITF_IMAGE_IO_AVX2_FUNC(name), NITF_IMAGE_IO_NEON_FUNC(name) } }
+
+#define NITF_IMAGE_IO_NEON_ROW(scalar, name)                               \
+    { { scalar, NULL, NULL, NITF_IMAGE_IO_NEON_FUNC(name) } }
+
+typedef struct
+{
+    _NITF_IMAGE_IO_UNFORMAT_FUNC funcs[NITF_IMAGE_IO_VECTOR_COUNT];
+}
+_nitf_ImageIOVectorUnformat;
+
+typedef struct
+{
+    _NITF_IMAGE_IO_PACK_FUNC funcs[NITF_IMAGE_IO_VECTOR_COUNT];
+}
+_nitf_ImageIOVectorUnpack;
+
+static const _nitf_ImageIOVectorUnformat VECTOR_UNFORMAT_TABLE[] =
+{
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_swapOnly_2, SwapOnly_2),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_swapOnly_4, SwapOnly_4),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_swapOnly_8, SwapOnly_8),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_swapOnly_4c, SwapOnly_4c),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_swapOnly_8c, SwapOnly_8c),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_swapOnly_16c, SwapOnly_16c),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatShift_2, Shift_2),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatShift_4, Shift_4),
+    NITF_IMAGE_IO_NEON_ROW(nitf_ImageIO_unformatShift_8, Shift_8),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatUShift_2, UShift_2),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatUShift_4, UShift_4),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatUShift_8, UShift_8),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatExtend_2, Extend_2),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatExtend_4, Extend_4),
+    NITF_IMAGE_IO_NEON_ROW(nitf_ImageIO_unformatExtend_8, Extend_8),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatSwapShift_2, SwapShift_2),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatSwapShift_4, SwapShift_4),
+    NITF_IMAGE_IO_NEON_ROW(nitf_ImageIO_unformatSwapShift_8, SwapShift_8),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatSwapUShift_2,
+                             SwapUShift_2),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatSwapUShift_4,
+                             SwapUShift_4),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatSwapUShift_8,
+                             SwapUShift_8),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatSwapExtend_2,
+                             SwapExtend_2),
+    NITF_IMAGE_IO_VECTOR_ROW(nitf_ImageIO_unformatSwapExtend_4,
+                             SwapExtend_4),
+    NITF_IMAGE_IO_NEON_ROW(nitf_ImageIO_unformatSwapExtend_8, SwapExtend_8)
+};
+
+static const _nitf_ImageIOVectorUnpack VECTOR_UNPACK_TABLE[] =
+{
+    { { nitf_ImageIO_unpack_P_1, NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_1),
+        NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_1),
+        NITF_IMAGE_IO_NEON_FUNC(Unpack_P_1) } },
+    { { nitf_ImageIO_unpack_P_2, NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_2),
+        NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_2),
+        NITF_IMAGE_IO_NEON_FUNC(Unpack_P_2) } },
+    { { nitf_ImageIO_unpack_P_4, NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_4),
+        NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_4),
+        NITF_IMAGE_IO_NEON_FUNC(Unpack_P_4) } },
+    { { nitf_ImageIO_unpack_P_8, NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_8),
+        NITF_IMAGE_IO_SSE2_FUNC(Unpack_P_8), NULL } }
+};
+
+NITFPRIV(int) nitf_ImageIO_vectorSet(void)
+{
+#if defined(NITF_IMAGE_IO_NEON)
+    return NITF_IMAGE_IO_VECTOR_NEON;
+#elif defined(NITF_IMAGE_IO_AVX2)
+    static int vectorSet = -1;  /* Same answer in every thread */
+
+    if (vectorSet < 0)
+        vectorSet = nitf_ImageIO_haveAVX2() ?
+            NITF_IMAGE_IO_VECTOR_AVX2 : NITF_IMAGE_IO_VECTOR_SSE2;
+    return vectorSet;
+#elif defined(NITF_IMAGE_IO_SSE2)
+    return NITF_IMAGE_IO_VECTOR_SSE2;
+#else
+    return NITF_IMAGE_IO_VECTOR_NONE;
+#endif
+}
+
+NITFPRIV(void) nitf_ImageIO_setVector(_nitf_ImageIO * nitf)
+{
+    const int vectorSet = nitf->vectorFlag ?
+        nitf_ImageIO_vectorSet() : NITF_IMAGE_IO_VECTOR_NONE;
+    size_t i;
+    int j;
+
+    if (nitf->vtbl.unformat != NULL)
+    {
+        for (i = 0; i < sizeof(VECTOR_UNFORMAT_TABLE) /
+                        sizeof(VECTOR_UNFORMAT_TABLE[0]); i++)
+        {
+            const _nitf_ImageIOVectorUnformat *row = VECTOR_UNFORMAT_TABLE + i;
+            for (j = 0; j < NITF_IMAGE_IO_VECTOR_COUNT; j++)
+            {
+                if (nitf->vtbl.unformat == row->funcs[j])
+                {
+                    nitf->vtbl.unformat = (row->funcs[vectorSet] != NULL) ?
+                        row->funcs[vectorSet] : row->funcs[0];
+                    break;
+                }
+            }
+            if (j < NITF_IMAGE_IO_VECTOR_COUNT)
+                break;
+        }
+    }
+
+    if (nitf->vtbl.unpack != NULL)
+    {
+        for (i = 0; i < sizeof(VECTOR_UNPACK_TABLE) /
+                        sizeof(VECTOR_UNPACK_TABLE[0]); i++)
+        {
+            const _nitf_ImageIOVectorUnpack *row = VECTOR_UNPACK_TABLE + i;
+            for (j = 0; j < NITF_IMAGE_IO_VECTOR_COUNT; j++)
+            {
+                if (nitf->vtbl.unpack == row->funcs[j])
+                {
+                    nitf->vtbl.unpack = (row->funcs[vectorSet] != NULL) ?
+                        row->funcs[vectorSet] : row->funcs[0];
+                    break;
+                }
+            }
+            if (j < NITF_IMAGE_IO_VECTOR_COUNT)
+                break;
+        }
+    }
+
+    return;
+}
+
+
 void nitf_ImageIO_pack_P_1(_nitf_ImageIOBlock * blockIO, nitf_Error * error)
 {
     uint8_t *src;            /* Source buffer */
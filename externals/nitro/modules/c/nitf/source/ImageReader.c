@@ -41,10 +41,18 @@ NITFAPI(NITF_BOOL) nitf_ImageReader_read(nitf_ImageReader * imageReader,
                                          subWindow, user, padded, error);
 }
 
-NITFAPI(uint8_t*) nitf_ImageReader_readBlock(nitf_ImageReader * imageReader,
-                                                uint32_t blockNumber,
-                                                uint64_t* blockSize,
-                                                nitf_Error * error)
+NITFAPI(NITF_BOOL) nitf_ImageReader_readDirect(nitf_ImageReader * imageReader,
+                                               nitf_SubWindow * subWindow,
+                                               const uint8_t ** data,
+                                               nitf_Error * error)
+{
+    return nitf_ImageIO_readDirect(imageReader->imageDeblocker,
+                                   imageReader->input,
+                                   subWindow, data, error);
+}
+
+NITFPRIV(NITF_BOOL) setupDirectBlockRead(nitf_ImageReader * imageReader,
+                                         nitf_Error * error)
 {
     if(!imageReader->directBlockRead)
     {
@@ -52,10 +60,20 @@ NITFAPI(uint8_t*) nitf_ImageReader_readBlock(nitf_ImageReader * imageReader,
                                               imageReader->input,
                                               1,
                                               error))
-            return NULL;
+            return NITF_FAILURE;
 
         imageReader->directBlockRead = 1;
     }
+    return NITF_SUCCESS;
+}
+
+NITFAPI(uint8_t*) nitf_ImageReader_readBlock(nitf_ImageReader * imageReader,
+                                                uint32_t blockNumber,
+                                                uint64_t* blockSize,
+                                                nitf_Error * error)
+{
+    if (!setupDirectBlockRead(imageReader, error))
+        return NULL;
 
     return nitf_ImageIO_readBlockDirect(imageReader->imageDeblocker,
                                         imageReader->input,
@@ -64,6 +82,24 @@ NITFAPI(uint8_t*) nitf_ImageReader_readBlock(nitf_ImageReader * imageReader,
                                         error);
 }
 
+NITFAPI(NITF_BOOL) nitf_ImageReader_readBlockMapped(nitf_ImageReader * imageReader,
+                                                    uint32_t blockNumber,
+                                                    const uint8_t ** block,
+                                                    uint64_t* blockSize,
+                                                    nitf_Error * error)
+{
+    *block = NULL;
+    if (!setupDirectBlockRead(imageReader, error))
+        return NITF_FAILURE;
+
+    return nitf_ImageIO_readBlockMapped(imageReader->imageDeblocker,
+                                        imageReader->input,
+                                        blockNumber,
+                                        block,
+                                        blockSize,
+                                        error);
+}
+
 NITFAPI(void) nitf_ImageReader_destruct(nitf_ImageReader ** imageReader)
 {
     if (*imageReader)
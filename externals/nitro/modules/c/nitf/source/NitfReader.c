@@ -456,12 +456,19 @@ NITFAPI(nitf_Reader*) nitf_Reader_construct(nitf_Error* error)
     reader->record = NULL;
     reader->input = NULL;
     reader->ownInput = 0;
+    reader->parseTREs = 1;
     resetIOInterface(reader);
 
     /*  Return our results  */
     return reader;
 }
 
+NITFAPI(void) nitf_Reader_setParseTREs(nitf_Reader* reader,
+                                       NITF_BOOL parseTREs)
+{
+    reader->parseTREs = parseTREs;
+}
+
 NITFAPI(void) nitf_Reader_destruct(nitf_Reader** reader)
 {
     /*  If the reader has already been destructed, or was never  */
@@ -1315,8 +1322,19 @@ readTRE(nitf_Reader* reader, nitf_Extensions* ext, nitf_Error* error)
     if (!tre)
         goto CATCH_ERROR;
 
-    if (!handleTRE(reader, length, tre, error))
-        goto CATCH_ERROR;
+    if (reader->parseTREs)
+    {
+        if (!handleTRE(reader, length, tre, error))
+            goto CATCH_ERROR;
+    }
+    else
+    {
+        /* keep the raw bytes; no need to look for a plug-in */
+        tre->handler = nitf_DefaultTRE_handler(error);
+        if (!tre->handler->read(
+                    reader->input, length, tre, reader->record, error))
+            goto CATCH_ERROR;
+    }
 
     /*  Insert the tre into the data store  */
     if (!nitf_Extensions_appendTRE(ext, tre, error))
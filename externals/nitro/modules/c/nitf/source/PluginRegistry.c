@@ -21,6 +21,7 @@
  */
 
 #include "nitf/PluginRegistry.h"
+#include "nitf/TREParser.h"
 
 NITFPRIV(nitf_PluginRegistry*) implicitConstruct(nitf_Error* error, FILE* log);
 NITFPRIV(void) implicitDestruct(nitf_PluginRegistry** reg);
@@ -30,6 +31,7 @@ insertCreator(nitf_DLL* dso,
               nitf_HashTable* handlers,
               const char* ident,
               const char* suffix,
+              NITF_BOOL keepExisting,
               nitf_Error* error);
 
 static nitf_Mutex __PluginRegistryLock = NITF_MUTEX_INIT;
@@ -131,6 +133,7 @@ NITFPRIV(NITF_BOOL)
 insertPlugin(nitf_PluginRegistry* reg,
              const char** ident,
              nitf_DLL* dll,
+             NITF_BOOL keepExisting,
              nitf_Error* error)
 {
     nitf_HashTable* hash = NULL;
@@ -177,7 +180,7 @@ insertPlugin(nitf_PluginRegistry* reg,
             break;
 
         /* no more */
-        ok = insertCreator(dll, hash, key, suffix, error);
+        ok = insertCreator(dll, hash, key, suffix, keepExisting, error);
         if (!ok)
         {
             return NITF_FAILURE;
@@ -203,6 +206,7 @@ NITFPRIV(nitf_PluginRegistry*) implicitConstruct(nitf_Error* error, FILE* log)
 {
     size_t pathLen;
     const char* pluginEnvVar;
+    const char* pluginLoadMode;
 
     /*  Create the registry object  */
     nitf_PluginRegistry* reg =
@@ -223,6 +227,7 @@ NITFPRIV(nitf_PluginRegistry*) implicitConstruct(nitf_Error* error, FILE* log)
     reg->treHandlers = NULL;
     reg->decompressionHandlers = NULL;
     reg->dsos = NULL;
+    reg->deferredPlugins = NULL;
 
     reg->dsos = nitf_List_construct(error);
     if (!reg->dsos)
@@ -231,6 +236,32 @@ NITFPRIV(nitf_PluginRegistry*) implicitConstruct(nitf_Error* error, FILE* log)
         return NULL;
     }
 
+    reg->deferredPlugins = nitf_List_construct(error);
+    if (!reg->deferredPlugins)
+    {
+        implicitDestruct(&reg);
+        return NULL;
+    }
+
+    /*  Without a mode, load lazily only if the TREs are built in  */
+    pluginLoadMode = getenv(NITF_PLUGIN_LOAD_MODE);
+    if (pluginLoadMode && strcmp(pluginLoadMode, "lazy") == 0)
+    {
+        reg->lazyLoad = NRT_TRUE;
+    }
+    else if (pluginLoadMode && strcmp(pluginLoadMode, "eager") == 0)
+    {
+        reg->lazyLoad = NRT_FALSE;
+    }
+    else
+    {
+#ifdef NITF_STATIC_TRE_REGISTRY
+        reg->lazyLoad = NRT_TRUE;
+#else
+        reg->lazyLoad = NRT_FALSE;
+#endif
+    }
+
     /*  Construct our hash object  */
     reg->treHandlers = nitf_HashTable_construct(NITF_TRE_HASH_SIZE, error);
 
@@ -289,6 +320,7 @@ NITFPRIV(nitf_PluginRegistry*) implicitConstruct(nitf_Error* error, FILE* log)
         }
         else
         {
+#ifndef NITF_STATIC_TRE_REGISTRY
             if (log != NULL)
             {
                 fprintf(log,
@@ -297,6 +329,10 @@ NITFPRIV(nitf_PluginRegistry*) implicitConstruct(nitf_Error* error, FILE* log)
                     "%s, or by building the library from source\n",
                     NITF_PLUGIN_PATH);
             }
+#else
+            /*  The TREs are built in, so a missing path isn't a problem  */
+            (void)log;
+#endif
             return reg;
         }
     }
@@ -354,6 +390,14 @@ NITFPRIV(void) implicitDestruct(nitf_PluginRegistry** reg)
     {
         if ((*reg)->dsos)
             nitf_List_destruct(&(*reg)->dsos);
+        if ((*reg)->deferredPlugins)
+        {
+            while (!nitf_List_isEmpty((*reg)->deferredPlugins))
+            {
+                NITF_FREE(nitf_List_popFront((*reg)->deferredPlugins));
+            }
+            nitf_List_destruct(&(*reg)->deferredPlugins);
+        }
 
         if ((*reg)->treHandlers)
             nitf_HashTable_destruct(&(*reg)->treHandlers);
@@ -462,6 +506,9 @@ nitf_PluginRegistry_unload(nitf_PluginRegistry* reg, nitf_Error* error)
     /*  Pop the front off, until the list is empty  */
     nitf_List* l = reg->dsos;
     NITF_BOOL success = NITF_SUCCESS;
+
+    /*  The cached TRE parsers point into the plugins' descriptions  */
+    nitf_TREParser_clearCache();
     while (!nitf_List_isEmpty(l))
     {
         nitf_DLL* dso = (nitf_DLL*)nitf_List_popFront(l);
@@ -470,15 +517,21 @@ nitf_PluginRegistry_unload(nitf_PluginRegistry* reg, nitf_Error* error)
     return success;
 }
 
-NITFAPI(NITF_BOOL)
-nitf_PluginRegistry_loadPlugin(const char* fullName, nitf_Error* error)
+/*
+ *  Loads one DSO and inserts its handlers.  With keepExisting, identifiers
+ *  that already have a handler keep it, so that a plugin loaded late can't
+ *  replace a handler that was registered (or used) before it.
+ */
+NITFPRIV(NITF_BOOL) loadPlugin(nitf_PluginRegistry* reg,
+                               const char* fullName,
+                               NITF_BOOL keepExisting,
+                               nitf_Error* error)
 {
     /*  For now, the key is the dll name minus the extension  */
     char keyName[NITF_MAX_PATH] = "";
     int ok;
     nitf_DLL* dll;
     const char** ident;
-    nitf_PluginRegistry* reg = nitf_PluginRegistry_getInstance(error);
 
     /*  Construct the DLL object  */
     dll = nitf_DLL_construct(error);
@@ -504,7 +557,7 @@ nitf_PluginRegistry_loadPlugin(const char* fullName, nitf_Error* error)
     if (ident)
     {
         /*  I expect to have problems with this now and then  */
-        ok = insertPlugin(reg, ident, dll, error);
+        ok = insertPlugin(reg, ident, dll, keepExisting, error);
 
         /*  If insertion failed, take our toys and leave  */
         if (!ok)
@@ -519,6 +572,191 @@ nitf_PluginRegistry_loadPlugin(const char* fullName, nitf_Error* error)
     return NITF_FAILURE;
 }
 
+NITFAPI(NITF_BOOL)
+nitf_PluginRegistry_loadPlugin(const char* fullName, nitf_Error* error)
+{
+    nitf_PluginRegistry* reg = nitf_PluginRegistry_getInstance(error);
+    if (!reg)
+    {
+        return NITF_FAILURE;
+    }
+    return loadPlugin(reg, fullName, NRT_FALSE, error);
+}
+
+/*
+ *  Remembers a DSO to load when it is first needed (lazy mode)
+ */
+NITFPRIV(NITF_BOOL) deferPlugin(nitf_PluginRegistry* reg,
+                                const char* fullName,
+                                nitf_Error* error)
+{
+    const size_t size = strlen(fullName) + 1;
+    char* copy = (char*)NITF_MALLOC(size);
+    if (!copy)
+    {
+        nitf_Error_init(error,
+                        NITF_STRERROR(NITF_ERRNO),
+                        NITF_CTXT,
+                        NITF_ERR_MEMORY);
+        return NITF_FAILURE;
+    }
+    memcpy(copy, fullName, size);
+
+    if (!nitf_List_pushBack(reg->deferredPlugins, copy, error))
+    {
+        NITF_FREE(copy);
+        return NITF_FAILURE;
+    }
+    return NITF_SUCCESS;
+}
+
+/*
+ *  Loads the deferred DSO whose name (minus the extension) is pluginName, if
+ *  there is one.  The registry lock must be held.
+ */
+NITFPRIV(void) loadDeferredPlugin(nitf_PluginRegistry* reg,
+                                  const char* pluginName)
+{
+    nitf_ListIterator iter = nitf_List_begin(reg->deferredPlugins);
+    nitf_ListIterator end = nitf_List_end(reg->deferredPlugins);
+
+    while (nitf_ListIterator_notEqualTo(&iter, &end))
+    {
+        char keyName[NITF_MAX_PATH] = "";
+        char* fullName = (char*)nitf_ListIterator_get(&iter);
+        nitf_Utils_baseName(keyName, fullName, NITF_DLL_EXTENSION);
+        if (strcmp(keyName, pluginName) == 0)
+        {
+            nitf_Error error;
+            nitf_List_remove(reg->deferredPlugins, &iter);
+            if (!loadPlugin(reg, fullName, NRT_TRUE, &error))
+            {
+#ifdef NITF_DEBUG_PLUGIN_REG
+                printf("Warning: plugin [%s] failed to load!\n", fullName);
+#endif
+            }
+            NITF_FREE(fullName);
+            return;
+        }
+        nitf_ListIterator_increment(&iter);
+    }
+}
+
+/*
+ *  Loads every deferred DSO.  The registry lock must be held.
+ */
+NITFPRIV(void) loadDeferredPlugins(nitf_PluginRegistry* reg)
+{
+    while (!nitf_List_isEmpty(reg->deferredPlugins))
+    {
+        nitf_Error error;
+        char* fullName = (char*)nitf_List_popFront(reg->deferredPlugins);
+        if (!loadPlugin(reg, fullName, NRT_TRUE, &error))
+        {
+#ifdef NITF_DEBUG_PLUGIN_REG
+            printf("Warning: plugin [%s] failed to load!\n", fullName);
+#endif
+        }
+        NITF_FREE(fullName);
+    }
+}
+
+#ifndef NITF_STATIC_TRE_REGISTRY
+NITFPROT(const nitf_StaticTREHandler*)
+nitf_PluginRegistry_getStaticTREHandlers(size_t* numHandlers)
+{
+    *numHandlers = 0;
+    return NULL;
+}
+#endif
+
+NITFPRIV(int) compareStaticTREHandler(const void* key, const void* entry)
+{
+    return strcmp((const char*)key,
+                  ((const nitf_StaticTREHandler*)entry)->name);
+}
+
+/*
+ *  Finds a TRE handler, loading it if need be: loaded plugins and registered
+ *  handlers first, then the static TRE registry, then (in lazy mode) the
+ *  plugin named after the tag, then all the other plugins not yet loaded.
+ *  The registry lock must be held.
+ *
+ *  Returns NULL, without an error, if nothing handles the tag.
+ */
+NITFPRIV(NITF_PLUGIN_TRE_HANDLER_FUNCTION)
+findTREHandler(nitf_PluginRegistry* reg,
+               const char* treIdent,
+               int* hadError,
+               nitf_Error* error)
+{
+    char pluginName[NITF_MAX_PATH];
+    size_t numStatic = 0;
+    const nitf_StaticTREHandler* staticHandlers;
+    const nitf_StaticTREHandler* staticHandler = NULL;
+    nitf_Pair* pair;
+
+    *hadError = 0;
+
+    pair = nitf_HashTable_find(reg->treHandlers, treIdent);
+    if (pair)
+    {
+        return (NITF_PLUGIN_TRE_HANDLER_FUNCTION)pair->data;
+    }
+
+    /*  Plugins are named after their tag, like insertCreator() expects  */
+    memset(pluginName, 0, NITF_MAX_PATH);
+    nrt_strncpy_s(pluginName, NITF_MAX_PATH, treIdent, NITF_MAX_PATH - 1);
+    nitf_Utils_replace(pluginName, ' ', '_');
+
+    staticHandlers = nitf_PluginRegistry_getStaticTREHandlers(&numStatic);
+    if (staticHandlers)
+    {
+        staticHandler = (const nitf_StaticTREHandler*)bsearch(
+                pluginName, staticHandlers, numStatic,
+                sizeof(nitf_StaticTREHandler), compareStaticTREHandler);
+    }
+    if (staticHandler)
+    {
+        /*  First use: initialize it, and add it like a registered one  */
+        int i;
+        const char** ident = (*staticHandler->init)(error);
+        if (!ident)
+        {
+            *hadError = 1;
+            return NULL;
+        }
+        for (i = 1; ident[i] != NULL; ++i)
+        {
+            if (!nitf_HashTable_exists(reg->treHandlers, ident[i]) &&
+                !nitf_HashTable_insert(reg->treHandlers,
+                                       ident[i],
+                                       (NITF_DATA*)staticHandler->handler,
+                                       error))
+            {
+                *hadError = 1;
+                return NULL;
+            }
+        }
+        return staticHandler->handler;
+    }
+
+    if (nitf_List_isEmpty(reg->deferredPlugins))
+    {
+        return NULL;
+    }
+
+    loadDeferredPlugin(reg, pluginName);
+    pair = nitf_HashTable_find(reg->treHandlers, treIdent);
+    if (!pair)
+    {
+        /*  A plugin may handle tags it isn't named after  */
+        loadDeferredPlugins(reg);
+        pair = nitf_HashTable_find(reg->treHandlers, treIdent);
+    }
+    return pair ? (NITF_PLUGIN_TRE_HANDLER_FUNCTION)pair->data : NULL;
+}
+
 NITFAPI(NITF_BOOL)
 nitf_PluginRegistry_registerCompressionHandler(
         NITF_PLUGIN_INIT_FUNCTION init,
@@ -548,6 +786,8 @@ nitf_PluginRegistry_registerCompressionHandler(
         return NITF_FAILURE;
     }
 
+    /*  In lazy mode, lookups may be loading plugins  */
+    nitf_Mutex_lock(GET_MUTEX());
     for (; ident[i] != NULL; ++i)
     {
 #ifdef NITF_DEBUG_PLUGIN_REG
@@ -561,6 +801,7 @@ nitf_PluginRegistry_registerCompressionHandler(
                                     (NITF_DATA*)handle,
                                     error);
     }
+    nitf_Mutex_unlock(GET_MUTEX());
 
     return ok;
 }
@@ -594,6 +835,8 @@ nitf_PluginRegistry_registerDecompressionHandler(
         return NITF_FAILURE;
     }
 
+    /*  In lazy mode, lookups may be loading plugins  */
+    nitf_Mutex_lock(GET_MUTEX());
     for (; ident[i] != NULL; ++i)
     {
 #ifdef NITF_DEBUG_PLUGIN_REG
@@ -607,6 +850,7 @@ nitf_PluginRegistry_registerDecompressionHandler(
                                     (NITF_DATA*)handle,
                                     error);
     }
+    nitf_Mutex_unlock(GET_MUTEX());
 
     return ok;
 }
@@ -639,6 +883,8 @@ nitf_PluginRegistry_registerTREHandler(NITF_PLUGIN_INIT_FUNCTION init,
         return NITF_FAILURE;
     }
 
+    /*  In lazy mode, lookups may be loading plugins  */
+    nitf_Mutex_lock(GET_MUTEX());
     for (; ident[i] != NULL; ++i)
     {
 #ifdef NITF_DEBUG_PLUGIN_REG
@@ -652,6 +898,7 @@ nitf_PluginRegistry_registerTREHandler(NITF_PLUGIN_INIT_FUNCTION init,
                                     (NITF_DATA*)handle,
                                     error);
     }
+    nitf_Mutex_unlock(GET_MUTEX());
 
     return ok;
 }
@@ -661,8 +908,6 @@ nitf_PluginRegistry_internalLoadDir(nitf_PluginRegistry* reg,
                                     const char* dirName,
                                     nitf_Error* error)
 {
-    (void)reg;
-
     const char* name;
     size_t sizePath;
     nitf_Directory* dir = NULL;
@@ -703,7 +948,15 @@ nitf_PluginRegistry_internalLoadDir(nitf_PluginRegistry* reg,
                 /*  See if we have .so or .dll extensions  */
                 if ((end = (char*)strstr(name, NITF_DLL_EXTENSION)) != NULL)
                 {
-                    if (!nitf_PluginRegistry_loadPlugin(fullName, error))
+                    if (reg->lazyLoad)
+                    {
+                        if (!deferPlugin(reg, fullName, error))
+                        {
+                            nitf_Directory_destruct(&dir);
+                            return NITF_FAILURE;
+                        }
+                    }
+                    else if (!loadPlugin(reg, fullName, NRT_FALSE, error))
                     {
 #ifdef NITF_DEBUG_PLUGIN_REG
                         printf("Warning: plugin [%s] failed to load!\n", name);
@@ -745,13 +998,19 @@ NITFPROT(NITF_BOOL)
 nitf_PluginRegistry_internalTREHandlerExists(nitf_PluginRegistry* reg,
                                              const char* ident)
 {
-    return nitf_HashTable_exists(reg->treHandlers, ident);
+    int hadError = 0;
+    nitf_Error error;
+    return findTREHandler(reg, ident, &hadError, &error) != NULL;
 }
 
 NITFPROT(NITF_BOOL)
 nitf_PluginRegistry_internalCompressionHandlerExists(nitf_PluginRegistry* reg,
                                                      const char* ident)
 {
+    if (!nitf_HashTable_exists(reg->compressionHandlers, ident))
+    {
+        loadDeferredPlugins(reg);
+    }
     return nitf_HashTable_exists(reg->compressionHandlers, ident);
 }
 
@@ -759,6 +1018,10 @@ NITFPROT(NITF_BOOL)
 nitf_PluginRegistry_internalDecompressionHandlerExists(nitf_PluginRegistry* reg,
                                                        const char* ident)
 {
+    if (!nitf_HashTable_exists(reg->decompressionHandlers, ident))
+    {
+        loadDeferredPlugins(reg);
+    }
     return nitf_HashTable_exists(reg->decompressionHandlers, ident);
 }
 
@@ -851,7 +1114,16 @@ nitf_PluginRegistry_retrieveDecompConstructor(nitf_PluginRegistry* reg,
     /*  No error has occurred (yet)  */
     *hadError = 0;
 
-    if (!nitf_HashTable_exists(reg->decompressionHandlers, ident))
+    nitf_Mutex_lock(GET_MUTEX());
+    pair = nitf_HashTable_find(reg->decompressionHandlers, ident);
+    if (!pair)
+    {
+        loadDeferredPlugins(reg);
+        pair = nitf_HashTable_find(reg->decompressionHandlers, ident);
+    }
+    nitf_Mutex_unlock(GET_MUTEX());
+
+    if (!pair)
     {
         *hadError = 1;
         nitf_Error_init(error,
@@ -860,18 +1132,6 @@ nitf_PluginRegistry_retrieveDecompConstructor(nitf_PluginRegistry* reg,
                         NRT_ERR_DECOMPRESSION);
         return NULL;
     }
-    pair = nitf_HashTable_find(reg->decompressionHandlers, ident);
-
-    /*  If nothing is there, we don't have a handler, plain and simple  */
-    if (!pair)
-    {
-        nitf_Error_initf(error,
-                         NRT_CTXT,
-                         NRT_ERR_DECOMPRESSION,
-                         "Don't have a handler for '%s'",
-                         ident);
-        return NULL;
-    }
 
     return (NITF_PLUGIN_DECOMPRESSION_CONSTRUCT_FUNCTION)pair->data;
 }
@@ -888,7 +1148,16 @@ nitf_PluginRegistry_retrieveCompConstructor(nitf_PluginRegistry* reg,
     /*  No error has occurred (yet)  */
     *hadError = 0;
 
-    if (!nitf_HashTable_exists(reg->compressionHandlers, ident))
+    nitf_Mutex_lock(GET_MUTEX());
+    pair = nitf_HashTable_find(reg->compressionHandlers, ident);
+    if (!pair)
+    {
+        loadDeferredPlugins(reg);
+        pair = nitf_HashTable_find(reg->compressionHandlers, ident);
+    }
+    nitf_Mutex_unlock(GET_MUTEX());
+
+    if (!pair)
     {
         *hadError = 1;
         nitf_Error_init(error,
@@ -897,18 +1166,6 @@ nitf_PluginRegistry_retrieveCompConstructor(nitf_PluginRegistry* reg,
                         NRT_ERR_COMPRESSION);
         return NULL;
     }
-    pair = nitf_HashTable_find(reg->compressionHandlers, ident);
-
-    /*  If nothing is there, we don't have a handler, plain and simple  */
-    if (!pair)
-    {
-        nitf_Error_initf(error,
-                         NRT_CTXT,
-                         NRT_ERR_COMPRESSION,
-                         "Don't have a handler for '%s'",
-                         ident);
-        return NULL;
-    }
 
     return (NITF_PLUGIN_COMPRESSION_CONSTRUCT_FUNCTION)pair->data;
 }
@@ -918,11 +1175,17 @@ insertCreator(nitf_DLL* dso,
               nitf_HashTable* hash,
               const char* ident,
               const char* suffix,
+              NITF_BOOL keepExisting,
               nitf_Error* error)
 {
     /*  Get the name of the handler  */
     char name[NITF_MAX_PATH];
 
+    if (keepExisting && nitf_HashTable_exists(hash, ident))
+    {
+        return NITF_SUCCESS;
+    }
+
     if (!nitf_DLL_isValid(dso))
     {
         nitf_Error_initf(error,
@@ -975,28 +1238,17 @@ nitf_PluginRegistry_retrieveTREHandler(nitf_PluginRegistry* reg,
                                        nitf_Error* error)
 {
     nitf_TREHandler* theHandler;
-    /*  We get back a pair from the hash table  */
-    nitf_Pair* pair;
     /*  We are trying to find tre_main  */
     NITF_PLUGIN_TRE_HANDLER_FUNCTION treMain = NULL;
 
-    /*  No error has occurred (yet)  */
-    *hadError = 0;
-
-    if (!nitf_HashTable_exists(reg->treHandlers, treIdent))
-    {
-        return NULL;
-    }
-    /*  Lookup the pair from the hash table, by the tre_id  */
-    pair = nitf_HashTable_find(reg->treHandlers, treIdent);
+    nitf_Mutex_lock(GET_MUTEX());
+    treMain = findTREHandler(reg, treIdent, hadError, error);
+    nitf_Mutex_unlock(GET_MUTEX());
 
     /*  If nothing is there, we dont have a handler, plain and simple  */
-    if (!pair)
+    if (!treMain)
         return NULL;
 
-    /*  If something is, get its DLL part  */
-    treMain = (NITF_PLUGIN_TRE_HANDLER_FUNCTION)pair->data;
-
     theHandler = (*treMain)(error);
     if (!theHandler)
     {
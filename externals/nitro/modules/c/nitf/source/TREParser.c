@@ -0,0 +1,1390 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program;
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nitf/TREParser.h"
+#include "nitf/TRECursor.h"
+
+/*
+ *  The parser follows the rules of nitf_TRECursor_iterate() and its
+ *  helpers, so the comments below only point out where it has to work
+ *  around them.  Each description entry becomes one instruction at the
+ *  same index, so a jump is the index of the matching LOOP, ENDLOOP or
+ *  ENDIF entry.
+ */
+
+#define TAG_BUF_LEN NITF_TRECursor_tag_str_LEN
+
+/* The cursor keeps its loops and expression operands on nitf_IntStacks */
+#define MAX_DEPTH NITF_INT_STACK_DEPTH
+
+/* The most characters one "[%d]" index takes */
+#define INDEX_LEN 12
+
+/* Size of the arena block that lives on the stack */
+#define ARENA_STACK_SIZE 4096
+
+typedef unsigned int (*NITF_TRE_PARSER_COUNT_FUNCTION) (nitf_TRE*,
+                                                        char idx[10][10],
+                                                        int,
+                                                        nitf_Error*);
+
+enum
+{
+    OP_FIELD,
+    OP_LOOP,
+    OP_ENDLOOP,
+    OP_IF,
+    OP_SKIP
+};
+
+enum
+{
+    LENGTH_FIXED,
+    LENGTH_GOBBLE,
+    LENGTH_EXPRESSION
+};
+
+enum
+{
+    COUNT_CONSTANT,
+    COUNT_FUNCTION,
+    COUNT_FIELD,
+    COUNT_INVALID
+};
+
+enum
+{
+    IF_EQ,
+    IF_NE,
+    IF_LT,
+    IF_GT,
+    IF_GE,
+    IF_LE,
+    IF_EQUAL,
+    IF_NOT_EQUAL,
+    IF_BITS,
+    IF_INVALID
+};
+
+enum
+{
+    TOKEN_CONSTANT,
+    TOKEN_FIELD,
+    TOKEN_OPERATOR
+};
+
+/*
+ *  A field that a loop, condition or length refers to: the tag up to any
+ *  '[', and how many indices follow it.  A plain tag (brackets < 0) is
+ *  looked up the way nitf_TRECursor_getTREPair() does, with each of the
+ *  enclosing loops' indices tried in turn.
+ */
+typedef struct _TREParserRef
+{
+    const char* name;
+    size_t nameLength;
+    int brackets;
+} TREParserRef;
+
+typedef struct _TREParserToken
+{
+    int kind;
+    int value;      /* the constant, or the operator character */
+    NITF_BOOL unary;
+    TREParserRef ref;
+} TREParserToken;
+
+typedef struct _TREParserOp
+{
+    int code;
+    int depth;              /* loops around the entry */
+    int jump;
+
+    /* OP_FIELD */
+    nitf_FieldType type;
+    int lengthKind;
+    int length;
+    size_t tagLength;
+    NITF_BOOL referenced;
+    int firstToken;
+    int numTokens;
+
+    /* OP_LOOP and OP_IF */
+    TREParserRef ref;
+    int kind;
+    int value;
+    char countOp;
+    unsigned int bits;
+    const char* string;
+    NITF_TRE_PARSER_COUNT_FUNCTION function;
+
+    const nitf_TREDescription* entry;
+} TREParserOp;
+
+struct _nitf_TREParser
+{
+    const nitf_TREDescription* description;
+    TREParserOp* ops;
+    int numOps;
+    TREParserToken* tokens;
+    int numTokens;
+};
+
+NITFPRIV(NITF_BOOL) isOperator(const char* token, size_t length)
+{
+    return length == 1 &&
+           (token[0] == '+' || token[0] == '-' || token[0] == '*' ||
+            token[0] == '/' || token[0] == '%');
+}
+
+NITFPRIV(NITF_BOOL) isNumber(const char* token, size_t length)
+{
+    size_t i;
+    for (i = 0; i < length; ++i)
+    {
+        if (!isdigit((unsigned char)token[i]))
+            return 0;
+    }
+    return length > 0;
+}
+
+/* Fills in a reference, or returns 0 if it can't be resolved like the cursor */
+NITFPRIV(NITF_BOOL) compileRef(TREParserRef* ref, const char* tag,
+                               size_t length, int depth)
+{
+    size_t i;
+    if (!tag || length == 0)
+        return NITF_FAILURE;
+
+    ref->name = tag;
+    ref->nameLength = length;
+    ref->brackets = -1;
+    for (i = 0; i < length; ++i)
+    {
+        if (tag[i] == '[')
+        {
+            if (ref->brackets < 0)
+            {
+                ref->nameLength = i;
+                ref->brackets = 0;
+            }
+            ref->brackets++;
+        }
+    }
+
+    /* The cursor only has indices for the loops it's in */
+    if (ref->brackets > depth)
+        return NITF_FAILURE;
+    return ref->nameLength + (size_t)depth * INDEX_LEN < TAG_BUF_LEN;
+}
+
+NITFPRIV(NITF_BOOL) compileLoop(TREParserOp* op)
+{
+    const nitf_TREDescription* entry = op->entry;
+    const char* label = entry->label;
+
+    if (label && strcmp(label, NITF_CONST_N) == 0)
+    {
+        op->kind = COUNT_CONSTANT;
+        op->value = entry->tag ? NITF_ATO32(entry->tag) : 0;
+        if (op->value < 0)
+            op->value = 0;
+        return NITF_SUCCESS;
+    }
+    if (label && strcmp(label, NITF_FUNCTION) == 0)
+    {
+        op->kind = COUNT_FUNCTION;
+        op->function = (NITF_TRE_PARSER_COUNT_FUNCTION)entry->tag;
+        return op->function != NULL;
+    }
+
+    op->kind = COUNT_FIELD;
+    if (!compileRef(&op->ref, entry->tag,
+                    entry->tag ? strlen(entry->tag) : 0, op->depth))
+        return NITF_FAILURE;
+
+    if (label && strlen(label) != 0)
+    {
+        while (isspace(*label))
+            label++;
+        if (*label == '+' || *label == '-' || *label == '*' ||
+            *label == '/' || *label == '%')
+        {
+            op->countOp = *label++;
+            while (isspace(*label))
+                label++;
+            op->value = NITF_ATO32(label);
+        }
+        else
+        {
+            /* The cursor always counts 0 for these */
+            op->kind = COUNT_INVALID;
+        }
+    }
+    return NITF_SUCCESS;
+}
+
+NITFPRIV(NITF_BOOL) compileIf(TREParserOp* op)
+{
+    const nitf_TREDescription* entry = op->entry;
+    const char* label = entry->label;
+    const char* space;
+    size_t length;
+
+    if (!label || !entry->tag ||
+        !compileRef(&op->ref, entry->tag, strlen(entry->tag), op->depth))
+        return NITF_FAILURE;
+
+    while (isspace(*label))
+        label++;
+    space = strchr(label, ' ');
+    if (!space)
+        return NITF_FAILURE;
+    length = (size_t)(space - label);
+    op->string = space + 1;
+
+#define IS_OP(str_) (length == strlen(str_) && strncmp(label, str_, length) == 0)
+    if (IS_OP("eq"))
+        op->kind = IF_EQ;
+    else if (IS_OP("ne"))
+        op->kind = IF_NE;
+    else if (IS_OP("<"))
+        op->kind = IF_LT;
+    else if (IS_OP(">"))
+        op->kind = IF_GT;
+    else if (IS_OP(">="))
+        op->kind = IF_GE;
+    else if (IS_OP("<="))
+        op->kind = IF_LE;
+    else if (IS_OP("=="))
+        op->kind = IF_EQUAL;
+    else if (IS_OP("!="))
+        op->kind = IF_NOT_EQUAL;
+    else if (IS_OP("&"))
+        op->kind = IF_BITS;
+    else
+        op->kind = IF_INVALID;
+#undef IS_OP
+
+    if (op->kind == IF_BITS)
+        op->bits = NITF_ATOU32_BASE(op->string, 0);
+    else if (op->kind >= IF_LT && op->kind <= IF_NOT_EQUAL)
+        op->value = NITF_ATO32(op->string);
+    return NITF_SUCCESS;
+}
+
+/*
+ *  Splits a length expression into tokens, or returns 0 if it can never
+ *  evaluate (the cursor reports an error for every use of those).
+ *  With tokens == NULL, this only counts them.
+ */
+NITFPRIV(NITF_BOOL) compileExpression(TREParserOp* op,
+                                      TREParserToken* tokens,
+                                      int* numTokens)
+{
+    const char* expression = op->entry->special;
+    int stackSize = 0;
+    int count = 0;
+
+    while (*expression)
+    {
+        const char* start;
+        size_t length;
+
+        while (*expression && isspace(*expression))
+            ++expression;
+        start = expression;
+        while (*expression && !isspace(*expression))
+            ++expression;
+        length = (size_t)(expression - start);
+        if (length == 0)
+            break;
+
+        if (isOperator(start, length))
+        {
+            if (stackSize == 0)
+                return NITF_FAILURE;
+            if (tokens)
+            {
+                tokens[count].kind = TOKEN_OPERATOR;
+                tokens[count].value = start[0];
+                tokens[count].unary = stackSize == 1;
+            }
+            if (stackSize > 1)
+                --stackSize;
+        }
+        else
+        {
+            /* The cursor's stack drops anything pushed past its depth */
+            if (stackSize == MAX_DEPTH)
+                return NITF_FAILURE;
+            ++stackSize;
+
+            if (isNumber(start, length))
+            {
+                if (tokens)
+                {
+                    char number[TAG_BUF_LEN];
+                    if (length >= sizeof(number))
+                        return NITF_FAILURE;
+                    memcpy(number, start, length);
+                    number[length] = 0;
+                    tokens[count].kind = TOKEN_CONSTANT;
+                    tokens[count].value = NITF_ATO32(number);
+                }
+            }
+            else if (tokens)
+            {
+                tokens[count].kind = TOKEN_FIELD;
+                if (!compileRef(&tokens[count].ref, start, length, op->depth))
+                    return NITF_FAILURE;
+            }
+        }
+        ++count;
+    }
+
+    *numTokens = count;
+    return stackSize == 1;
+}
+
+NITFPRIV(NITF_BOOL) refersTo(const TREParserRef* ref, const char* tag,
+                             size_t tagLength)
+{
+    return ref->nameLength == tagLength &&
+           memcmp(ref->name, tag, tagLength) == 0;
+}
+
+/* Marks the fields that something looks up while parsing */
+NITFPRIV(void) markReferenced(nitf_TREParser* parser)
+{
+    int i, j;
+    for (i = 0; i < parser->numOps; ++i)
+    {
+        TREParserOp* field = &parser->ops[i];
+        if (field->code != OP_FIELD)
+            continue;
+
+        for (j = 0; j < parser->numOps && !field->referenced; ++j)
+        {
+            const TREParserOp* op = &parser->ops[j];
+            if ((op->code == OP_IF ||
+                 (op->code == OP_LOOP && op->kind == COUNT_FIELD)) &&
+                refersTo(&op->ref, field->entry->tag, field->tagLength))
+            {
+                field->referenced = 1;
+            }
+        }
+        for (j = 0; j < parser->numTokens && !field->referenced; ++j)
+        {
+            const TREParserToken* token = &parser->tokens[j];
+            if (token->kind == TOKEN_FIELD &&
+                refersTo(&token->ref, field->entry->tag, field->tagLength))
+            {
+                field->referenced = 1;
+            }
+        }
+    }
+}
+
+NITFAPI(nitf_TREParser*)
+nitf_TREParser_construct(const nitf_TREDescription* description,
+                         nitf_Error* error)
+{
+    nitf_TREParser* parser = NULL;
+    int open[MAX_DEPTH * 2 + 1];
+    int numOpen = 0;
+    int depth = 0;
+    int numTokens = 0;
+    int i;
+
+    if (!description)
+    {
+        nitf_Error_init(error, "NULL TRE description", NITF_CTXT,
+                        NITF_ERR_INVALID_PARAMETER);
+        return NULL;
+    }
+
+    parser = (nitf_TREParser*)NITF_MALLOC(sizeof(nitf_TREParser));
+    if (!parser)
+    {
+        nitf_Error_init(error, NITF_STRERROR(NITF_ERRNO), NITF_CTXT,
+                        NITF_ERR_MEMORY);
+        return NULL;
+    }
+    parser->description = description;
+    parser->ops = NULL;
+    parser->tokens = NULL;
+    parser->numTokens = 0;
+    parser->numOps = 0;
+    while (description[parser->numOps].data_type != NITF_END)
+        parser->numOps++;
+
+    parser->ops = (TREParserOp*)NITF_MALLOC(
+            sizeof(TREParserOp) * (size_t)(parser->numOps + 1));
+    if (!parser->ops)
+    {
+        nitf_Error_init(error, NITF_STRERROR(NITF_ERRNO), NITF_CTXT,
+                        NITF_ERR_MEMORY);
+        goto CATCH_ERROR;
+    }
+    memset(parser->ops, 0, sizeof(TREParserOp) * (size_t)(parser->numOps + 1));
+
+    for (i = 0; i < parser->numOps; ++i)
+    {
+        TREParserOp* op = &parser->ops[i];
+        const nitf_TREDescription* entry = &description[i];
+        op->entry = entry;
+        op->depth = depth;
+        op->jump = -1;
+
+        if (entry->data_type == NITF_BCS_A ||
+            entry->data_type == NITF_BCS_N ||
+            entry->data_type == NITF_BINARY)
+        {
+            op->code = OP_FIELD;
+            op->type = (nitf_FieldType)entry->data_type;
+            if (!entry->tag || strchr(entry->tag, '['))
+                goto UNSUPPORTED;
+            op->tagLength = strlen(entry->tag);
+            if (op->tagLength + (size_t)depth * INDEX_LEN >= TAG_BUF_LEN)
+                goto UNSUPPORTED;
+
+            if (entry->data_count == NITF_TRE_CONDITIONAL_LENGTH)
+            {
+                int count;
+                /* Without an expression, the cursor skips the field */
+                if (!entry->special)
+                {
+                    op->code = OP_SKIP;
+                    continue;
+                }
+                op->lengthKind = LENGTH_EXPRESSION;
+                if (!compileExpression(op, NULL, &count))
+                    goto UNSUPPORTED;
+                op->numTokens = count;
+                numTokens += count;
+            }
+            else if (entry->data_count == NITF_TRE_GOBBLE)
+                op->lengthKind = LENGTH_GOBBLE;
+            else if (entry->data_count >= 0)
+            {
+                op->lengthKind = LENGTH_FIXED;
+                op->length = entry->data_count;
+            }
+            else
+                goto UNSUPPORTED;
+        }
+        else if (entry->data_type == NITF_LOOP ||
+                 entry->data_type == NITF_IF)
+        {
+            if (entry->data_type == NITF_LOOP)
+            {
+                op->code = OP_LOOP;
+                if (!compileLoop(op))
+                    goto UNSUPPORTED;
+                if (++depth > MAX_DEPTH)
+                    goto UNSUPPORTED;
+            }
+            else
+            {
+                op->code = OP_IF;
+                if (!compileIf(op))
+                    goto UNSUPPORTED;
+            }
+            if (numOpen == (int)(sizeof(open) / sizeof(open[0])))
+                goto UNSUPPORTED;
+            open[numOpen++] = i;
+        }
+        else if (entry->data_type == NITF_ENDLOOP ||
+                 entry->data_type == NITF_ENDIF)
+        {
+            const int expected = entry->data_type == NITF_ENDLOOP ?
+                    OP_LOOP : OP_IF;
+            TREParserOp* start;
+
+            /*
+             *  The cursor skips loops and ifs by counting only their own
+             *  kind, so they have to nest within each other for the jumps
+             *  to agree with it.
+             */
+            if (numOpen == 0 || parser->ops[open[numOpen - 1]].code != expected)
+                goto UNSUPPORTED;
+            start = &parser->ops[open[--numOpen]];
+            start->jump = i;
+
+            if (expected == OP_LOOP)
+            {
+                op->code = OP_ENDLOOP;
+                op->jump = (int)(start - parser->ops);
+                op->depth = --depth;
+            }
+            else
+                op->code = OP_SKIP;
+        }
+        else if (entry->data_type > NITF_LOOP && entry->data_type < NITF_END)
+            op->code = OP_SKIP;
+        else
+            goto UNSUPPORTED;
+    }
+    if (numOpen != 0)
+        goto UNSUPPORTED;
+
+    if (numTokens > 0)
+    {
+        parser->tokens = (TREParserToken*)NITF_MALLOC(
+                sizeof(TREParserToken) * (size_t)numTokens);
+        if (!parser->tokens)
+        {
+            nitf_Error_init(error, NITF_STRERROR(NITF_ERRNO), NITF_CTXT,
+                            NITF_ERR_MEMORY);
+            goto CATCH_ERROR;
+        }
+        memset(parser->tokens, 0, sizeof(TREParserToken) * (size_t)numTokens);
+
+        for (i = 0; i < parser->numOps; ++i)
+        {
+            TREParserOp* op = &parser->ops[i];
+            int count;
+            if (op->code != OP_FIELD || op->lengthKind != LENGTH_EXPRESSION)
+                continue;
+            op->firstToken = parser->numTokens;
+            if (!compileExpression(op, parser->tokens + op->firstToken,
+                                   &count))
+                goto UNSUPPORTED;
+            parser->numTokens += count;
+        }
+    }
+
+    markReferenced(parser);
+    return parser;
+
+UNSUPPORTED:
+    nitf_Error_initf(error, NITF_CTXT, NITF_ERR_INVALID_OBJECT,
+                     "TRE description entry %d can't be compiled", i);
+CATCH_ERROR:
+    nitf_TREParser_destruct(&parser);
+    return NULL;
+}
+
+NITFAPI(void) nitf_TREParser_destruct(nitf_TREParser** parser)
+{
+    if (*parser)
+    {
+        if ((*parser)->ops)
+            NITF_FREE((*parser)->ops);
+        if ((*parser)->tokens)
+            NITF_FREE((*parser)->tokens);
+        NITF_FREE(*parser);
+        *parser = NULL;
+    }
+}
+
+/*
+ *  Memory for the lookups made while parsing.  It starts with a block on
+ *  the stack, and everything in it is freed at once when the parse is done.
+ */
+typedef union _TREParserAlign
+{
+    void* p;
+    double d;
+    size_t s;
+} TREParserAlign;
+
+typedef struct _TREParserArena
+{
+    char* block;
+    size_t size;
+    size_t used;
+    TREParserAlign* heapBlocks;     /* first slot links to the next */
+} TREParserArena;
+
+NITFPRIV(void*) arenaAlloc(TREParserArena* arena, size_t size,
+                           nitf_Error* error)
+{
+    void* p;
+    size = (size + sizeof(TREParserAlign) - 1) /
+            sizeof(TREParserAlign) * sizeof(TREParserAlign);
+
+    if (arena->used + size > arena->size)
+    {
+        size_t blockSize = arena->size * 2;
+        TREParserAlign* block;
+        while (blockSize < size)
+            blockSize *= 2;
+
+        block = (TREParserAlign*)NITF_MALLOC(sizeof(TREParserAlign) +
+                                             blockSize);
+        if (!block)
+        {
+            nitf_Error_init(error, NITF_STRERROR(NITF_ERRNO), NITF_CTXT,
+                            NITF_ERR_MEMORY);
+            return NULL;
+        }
+        block->p = arena->heapBlocks;
+        arena->heapBlocks = block;
+        arena->block = (char*)(block + 1);
+        arena->size = blockSize;
+        arena->used = 0;
+    }
+
+    p = arena->block + arena->used;
+    arena->used += size;
+    return p;
+}
+
+NITFPRIV(void) arenaFree(TREParserArena* arena)
+{
+    while (arena->heapBlocks)
+    {
+        TREParserAlign* next = (TREParserAlign*)arena->heapBlocks->p;
+        NITF_FREE(arena->heapBlocks);
+        arena->heapBlocks = next;
+    }
+}
+
+/* A field that's been parsed, by its key */
+typedef struct _TREParserEntry
+{
+    const char* key;
+    size_t length;
+    nitf_Field* field;
+} TREParserEntry;
+
+typedef struct _TREParserState
+{
+    const nitf_TREParser* parser;
+    nitf_TRE* tre;
+    int next;
+    int looping;
+    int count[MAX_DEPTH];
+    int index[MAX_DEPTH];
+
+    /* The index strings the count functions get */
+    char idx_str[10][10];
+
+    /* "[i][j]..." for the loops, and where each loop's part starts */
+    char suffix[TAG_BUF_LEN];
+    size_t suffixLength[MAX_DEPTH + 1];
+
+    TREParserArena arena;
+    TREParserEntry* table;
+    size_t tableSize;
+    size_t tableCount;
+} TREParserState;
+
+NITFPRIV(size_t) hashKey(const char* key, size_t length)
+{
+    size_t hash = 2166136261u;
+    size_t i;
+    for (i = 0; i < length; ++i)
+        hash = (hash ^ (unsigned char)key[i]) * 16777619u;
+    return hash;
+}
+
+NITFPRIV(nitf_Field*) findKey(const TREParserState* state, const char* key,
+                              size_t length)
+{
+    size_t slot;
+    if (state->tableCount == 0)
+        return NULL;
+
+    slot = hashKey(key, length) & (state->tableSize - 1);
+    while (state->table[slot].key)
+    {
+        const TREParserEntry* entry = &state->table[slot];
+        if (entry->length == length && memcmp(entry->key, key, length) == 0)
+            return entry->field;
+        slot = (slot + 1) & (state->tableSize - 1);
+    }
+    return NULL;
+}
+
+/* Keeps the first field for a key, as nitf_HashTable_find() would find */
+NITFPRIV(NITF_BOOL) addKey(TREParserState* state, const char* key,
+                           size_t length, nitf_Field* field,
+                           nitf_Error* error)
+{
+    size_t slot;
+    char* copy;
+
+    if (findKey(state, key, length))
+        return NITF_SUCCESS;
+
+    if ((state->tableCount + 1) * 2 > state->tableSize)
+    {
+        const size_t oldSize = state->tableSize;
+        const TREParserEntry* old = state->table;
+        size_t i;
+
+        state->tableSize = oldSize ? oldSize * 2 : 64;
+        state->table = (TREParserEntry*)arenaAlloc(
+                &state->arena, sizeof(TREParserEntry) * state->tableSize,
+                error);
+        if (!state->table)
+            return NITF_FAILURE;
+        memset(state->table, 0, sizeof(TREParserEntry) * state->tableSize);
+
+        for (i = 0; i < oldSize; ++i)
+        {
+            if (old[i].key)
+            {
+                slot = hashKey(old[i].key, old[i].length) &
+                        (state->tableSize - 1);
+                while (state->table[slot].key)
+                    slot = (slot + 1) & (state->tableSize - 1);
+                state->table[slot] = old[i];
+            }
+        }
+    }
+
+    copy = (char*)arenaAlloc(&state->arena, length, error);
+    if (!copy)
+        return NITF_FAILURE;
+    memcpy(copy, key, length);
+
+    slot = hashKey(key, length) & (state->tableSize - 1);
+    while (state->table[slot].key)
+        slot = (slot + 1) & (state->tableSize - 1);
+    state->table[slot].key = copy;
+    state->table[slot].length = length;
+    state->table[slot].field = field;
+    state->tableCount++;
+    return NITF_SUCCESS;
+}
+
+/* The same field nitf_TRECursor_getTREPair() finds, while at op's depth */
+NITFPRIV(nitf_Field*) findRef(const TREParserState* state,
+                              const TREParserRef* ref)
+{
+    char key[TAG_BUF_LEN];
+    memcpy(key, ref->name, ref->nameLength);
+
+    if (ref->brackets >= 0)
+    {
+        const size_t length = state->suffixLength[ref->brackets];
+        memcpy(key + ref->nameLength, state->suffix, length);
+        return findKey(state, key, ref->nameLength + length);
+    }
+    else
+    {
+        int i;
+        memcpy(key + ref->nameLength, state->suffix,
+               state->suffixLength[state->looping]);
+        for (i = 0; i <= state->looping; ++i)
+        {
+            nitf_Field* field = findKey(state, key,
+                                        ref->nameLength +
+                                        state->suffixLength[i]);
+            if (field)
+                return field;
+        }
+    }
+    return NULL;
+}
+
+NITFPRIV(void) setIndex(TREParserState* state, int level)
+{
+    char index[16];
+    const int length = NITF_SNPRINTF(index, sizeof(index), "[%d]",
+                                     state->index[level]);
+    memcpy(state->suffix + state->suffixLength[level], index,
+           (size_t)length);
+    state->suffixLength[level + 1] = state->suffixLength[level] +
+            (size_t)length;
+    nrt_strcpy_s(state->idx_str[level], sizeof(state->idx_str[level]), index);
+}
+
+NITFPRIV(int) evalLoop(TREParserState* state, const TREParserOp* op,
+                       nitf_Error* error)
+{
+    nitf_Field* field;
+    int loops;
+
+    switch (op->kind)
+    {
+        case COUNT_CONSTANT:
+            return op->value;
+        case COUNT_FUNCTION:
+            loops = (int)op->function(state->tre, state->idx_str,
+                                      state->looping, error);
+            if (loops == -1)
+                return 0;
+            break;
+        case COUNT_FIELD:
+            field = findRef(state, &op->ref);
+            if (!field || !nitf_Field_get(field, (char*)&loops,
+                                          NITF_CONV_INT, sizeof(loops),
+                                          error))
+                return 0;
+            switch (op->countOp)
+            {
+                case '+':
+                    loops += op->value;
+                    break;
+                case '-':
+                    loops -= op->value;
+                    break;
+                case '*':
+                    loops *= op->value;
+                    break;
+                case '/':
+                case '%':
+                    if (op->value == 0)
+                        return 0;
+                    if (op->countOp == '/')
+                        loops /= op->value;
+                    else
+                        loops %= op->value;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        default:
+            return 0;
+    }
+    return loops < 0 ? 0 : loops;
+}
+
+NITFPRIV(NITF_BOOL) evalIf(TREParserState* state, const TREParserOp* op,
+                           nitf_Error* error)
+{
+    nitf_Field* field = findRef(state, &op->ref);
+    int fieldData;
+    unsigned int bitFieldData;
+    int status;
+
+    if (!field)
+        return 0;
+
+    switch (op->kind)
+    {
+        case IF_EQ:
+        case IF_NE:
+            if (field->type == NITF_BCS_N)
+                return 0;
+            status = strncmp(field->raw, op->string, field->length);
+            return op->kind == IF_EQ ? !status : status != 0;
+        case IF_BITS:
+            if (field->type != NITF_BINARY ||
+                !nitf_Field_get(field, (char*)&bitFieldData, NITF_CONV_UINT,
+                                sizeof(bitFieldData), error))
+                return 0;
+            return (op->bits & bitFieldData) != 0;
+        case IF_INVALID:
+            return 0;
+        default:
+            break;
+    }
+
+    if (field->type != NITF_BCS_N ||
+        !nitf_Field_get(field, (char*)&fieldData, NITF_CONV_INT,
+                        sizeof(fieldData), error))
+        return 0;
+
+    status = fieldData - op->value;
+    switch (op->kind)
+    {
+        case IF_LT:
+            return status < 0;
+        case IF_GT:
+            return status > 0;
+        case IF_GE:
+            return status >= 0;
+        case IF_LE:
+            return status <= 0;
+        case IF_EQUAL:
+            return status == 0;
+        default:
+            return status != 0;
+    }
+}
+
+/* Returns the field's length, or -1 on error, with the cursor's messages */
+NITFPRIV(int) evalLength(TREParserState* state, const TREParserOp* op,
+                         nitf_Error* error)
+{
+    int stack[MAX_DEPTH];
+    int size = 0;
+    int i;
+
+    for (i = 0; i < op->numTokens; ++i)
+    {
+        const TREParserToken* token =
+                &state->parser->tokens[op->firstToken + i];
+        int value;
+
+        if (token->kind == TOKEN_CONSTANT)
+            value = token->value;
+        else if (token->kind == TOKEN_FIELD)
+        {
+            nitf_Field* field = findRef(state, &token->ref);
+            if (!field)
+            {
+                nitf_Error_init(error,
+                        "nitf_TRECursor_evaluatePostfix: invalid TRE field reference",
+                        NITF_CTXT, NITF_ERR_INVALID_PARAMETER);
+                return -1;
+            }
+            if (!nitf_Field_get(field, (char*)&value, NITF_CONV_INT,
+                                sizeof(value), error))
+                return -1;
+        }
+        else
+        {
+            const int op2 = stack[--size];
+            const int op1 = token->unary ? 0 : stack[--size];
+            switch (token->value)
+            {
+                case '+':
+                    value = op1 + op2;
+                    break;
+                case '-':
+                    value = op1 - op2;
+                    break;
+                case '*':
+                    value = op1 * op2;
+                    break;
+                default:
+                    if (op2 == 0)
+                    {
+                        nitf_Error_init(error,
+                                "nitf_TRECursor_evaluatePostfix: attempt to divide by zero",
+                                NITF_CTXT, NITF_ERR_INVALID_PARAMETER);
+                        return -1;
+                    }
+                    value = token->value == '/' ? op1 / op2 : op1 % op2;
+                    break;
+            }
+        }
+        stack[size++] = value;
+    }
+    return stack[0];
+}
+
+/*
+ *  Steps to the next field, as nitf_TRECursor_iterate() does.  Returns it
+ *  with its length, or NULL with *length set to -1 on an error.
+ */
+NITFPRIV(const TREParserOp*) nextField(TREParserState* state, int* length,
+                                       nitf_Error* error)
+{
+    const nitf_TREParser* parser = state->parser;
+    *length = 0;
+
+    while (state->next < parser->numOps)
+    {
+        const TREParserOp* op = &parser->ops[state->next++];
+        int level;
+
+        switch (op->code)
+        {
+            case OP_FIELD:
+                if (op->lengthKind == LENGTH_FIXED)
+                    *length = op->length;
+                else if (op->lengthKind == LENGTH_GOBBLE)
+                    *length = NITF_TRE_GOBBLE;
+                else
+                {
+                    *length = evalLength(state, op, error);
+                    if (*length < 0)
+                    {
+                        nitf_Error_print(error, stderr,
+                                         "TRE expression error:");
+                        return NULL;
+                    }
+                    if (*length == 0)
+                        break;
+                }
+                return op;
+
+            case OP_LOOP:
+                level = state->looping;
+                state->count[level] = evalLoop(state, op, error);
+                if (state->count[level] > 0)
+                {
+                    state->index[level] = 0;
+                    setIndex(state, level);
+                    state->looping++;
+                }
+                else
+                    state->next = op->jump + 1;
+                break;
+
+            case OP_ENDLOOP:
+                level = state->looping - 1;
+                if (--state->count[level] > 0)
+                {
+                    state->index[level]++;
+                    setIndex(state, level);
+                    state->next = op->jump + 1;
+                }
+                else
+                    state->looping--;
+                break;
+
+            case OP_IF:
+                if (!evalIf(state, op, error))
+                    state->next = op->jump + 1;
+                break;
+
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+NITFAPI(int) nitf_TREParser_parse(const nitf_TREParser* parser,
+                                  nitf_TRE* tre,
+                                  char* bufptr,
+                                  nitf_Error* error)
+{
+    int status = 1;
+    uint32_t offset = 0;
+    int length;
+    nitf_Field* field = NULL;
+    nitf_TREPrivateData* privData = NULL;
+    const TREParserOp* op;
+    TREParserState state;
+    TREParserAlign stackBlock[ARENA_STACK_SIZE / sizeof(TREParserAlign)];
+    char key[TAG_BUF_LEN];
+
+    if (!tre)
+    {
+        nitf_Error_init(error,
+                        "parse -> invalid tre object",
+                        NITF_CTXT,
+                        NITF_ERR_INVALID_PARAMETER);
+        return NITF_FAILURE;
+    }
+
+    privData = (nitf_TREPrivateData*)tre->priv;
+    if (!privData)
+    {
+        nitf_Error_init(error,
+            "invalid tre->priv object",
+            NITF_CTXT,
+            NITF_ERR_INVALID_PARAMETER);
+        return NITF_FAILURE;
+    }
+
+    /* flush the hash first, to protect from duplicate entries */
+    nitf_TREPrivateData_flush(privData, error);
+
+    state.parser = parser;
+    state.tre = tre;
+    state.next = 0;
+    state.looping = 0;
+    state.suffixLength[0] = 0;
+    state.arena.block = (char*)stackBlock;
+    state.arena.size = sizeof(stackBlock);
+    state.arena.used = 0;
+    state.arena.heapBlocks = NULL;
+    state.table = NULL;
+    state.tableSize = 0;
+    state.tableCount = 0;
+
+    while (offset < privData->length && status)
+    {
+        char* data = bufptr + offset;
+        size_t keyLength;
+        op = nextField(&state, &length, error);
+        if (!op)
+            break;
+
+        if (length == NITF_TRE_GOBBLE)
+            length = (int)(privData->length - offset);
+
+        field = nitf_Field_construct((size_t)length, op->type, error);
+        if (!field)
+            goto CATCH_ERROR;
+
+        /*
+         *  A field running past the end of the data is padded with zeros,
+         *  rather than read from past the end of the buffer.
+         */
+        if ((uint32_t)length > privData->length - offset)
+        {
+            const size_t available = privData->length - offset;
+            char* padded = (char*)arenaAlloc(&state.arena, (size_t)length,
+                                             error);
+            if (!padded)
+            {
+                nitf_Field_destruct(&field);
+                goto CATCH_ERROR;
+            }
+            memcpy(padded, data, available);
+            memset(padded + available, 0, (size_t)length - available);
+            data = padded;
+        }
+
+        if (field->type == NITF_BINARY && length == NITF_INT16_SZ)
+        {
+            int16_t int16 = (int16_t)NITF_NTOHS(*((int16_t*)data));
+            status = nitf_Field_setRawData(field, (NITF_DATA*)&int16,
+                                           length, error);
+        }
+        else if (field->type == NITF_BINARY && length == NITF_INT32_SZ)
+        {
+            int32_t int32 = (int32_t)NITF_NTOHL(*((int32_t*)data));
+            status = nitf_Field_setRawData(field, (NITF_DATA*)&int32,
+                                           length, error);
+        }
+        else
+        {
+            status = nitf_Field_setRawData(field, (NITF_DATA*)data, length,
+                                           error);
+        }
+
+        keyLength = op->tagLength + state.suffixLength[op->depth];
+        memcpy(key, op->entry->tag, op->tagLength);
+        memcpy(key + op->tagLength, state.suffix,
+               state.suffixLength[op->depth]);
+        key[keyLength] = 0;
+
+        nitf_HashTable_insert(privData->hash, key, field, error);
+        if (op->referenced &&
+            !addKey(&state, key, keyLength, field, error))
+            goto CATCH_ERROR;
+
+        offset += (uint32_t)length;
+    }
+    arenaFree(&state.arena);
+
+    /* check if we still have more to parse, and throw an error if so */
+    if (offset < privData->length)
+    {
+        nitf_Error_init(error,
+                        "TRE data is longer than it should be",
+                        NITF_CTXT,
+                        NITF_ERR_INVALID_OBJECT);
+        status = NITF_FAILURE;
+    }
+    return status;
+
+CATCH_ERROR:
+    arenaFree(&state.arena);
+    return NITF_FAILURE;
+}
+
+/*
+ *  Parsers for the descriptions nitf_TREParser_get() has seen, by address.
+ *  Descriptions that can't be compiled are kept too, with a NULL parser.
+ */
+typedef struct _TREParserCacheEntry
+{
+    const nitf_TREDescription* description;
+    nitf_TREParser* parser;
+} TREParserCacheEntry;
+
+static TREParserCacheEntry* __TREParserCache = NULL;
+static size_t __TREParserCacheSize = 0;
+static size_t __TREParserCacheCount = 0;
+static int __TREParserCacheAtExit = 0;
+
+static nitf_Mutex __TREParserCacheLock = NITF_MUTEX_INIT;
+#if defined(WIN32) || defined(_WIN32)
+static long __TREParserCacheInitLock = 0;
+
+NITFPRIV(nitf_Mutex*) GET_MUTEX(void)
+{
+    if (__TREParserCacheLock == NULL)
+    {
+        while (InterlockedExchange(&__TREParserCacheInitLock, 1) == 1)
+            /* loop, another thread own the lock */;
+        if (__TREParserCacheLock == NULL)
+            nitf_Mutex_init(&__TREParserCacheLock);
+        InterlockedExchange(&__TREParserCacheInitLock, 0);
+    }
+    return &__TREParserCacheLock;
+}
+#else
+#define GET_MUTEX() &__TREParserCacheLock
+#endif
+
+NITFPRIV(size_t) cacheSlot(const nitf_TREDescription* description,
+                           size_t size)
+{
+    return ((size_t)description / sizeof(nitf_TREDescription)) & (size - 1);
+}
+
+NITFPRIV(void) freeCache(void)
+{
+    size_t i;
+    for (i = 0; i < __TREParserCacheSize; ++i)
+    {
+        if (__TREParserCache[i].parser)
+            nitf_TREParser_destruct(&__TREParserCache[i].parser);
+    }
+    NITF_FREE(__TREParserCache);
+    __TREParserCache = NULL;
+    __TREParserCacheSize = __TREParserCacheCount = 0;
+}
+
+/* Returns 0 if the cache can't grow; the description is then not cached */
+NITFPRIV(NITF_BOOL) reserveCache(void)
+{
+    TREParserCacheEntry* cache;
+    size_t size;
+    size_t i;
+
+    if ((__TREParserCacheCount + 1) * 2 <= __TREParserCacheSize)
+        return NITF_SUCCESS;
+
+    size = __TREParserCacheSize ? __TREParserCacheSize * 2 : 256;
+    cache = (TREParserCacheEntry*)NITF_MALLOC(sizeof(TREParserCacheEntry) *
+                                              size);
+    if (!cache)
+        return NITF_FAILURE;
+    memset(cache, 0, sizeof(TREParserCacheEntry) * size);
+
+    for (i = 0; i < __TREParserCacheSize; ++i)
+    {
+        const TREParserCacheEntry* entry = &__TREParserCache[i];
+        if (entry->description)
+        {
+            size_t slot = cacheSlot(entry->description, size);
+            while (cache[slot].description)
+                slot = (slot + 1) & (size - 1);
+            cache[slot] = *entry;
+        }
+    }
+
+    if (__TREParserCache)
+        NITF_FREE(__TREParserCache);
+    if (!__TREParserCacheAtExit)
+    {
+        atexit(freeCache);
+        __TREParserCacheAtExit = 1;
+    }
+    __TREParserCache = cache;
+    __TREParserCacheSize = size;
+    return NITF_SUCCESS;
+}
+
+NITFAPI(const nitf_TREParser*)
+nitf_TREParser_get(const nitf_TREDescription* description)
+{
+    nitf_TREParser* parser = NULL;
+    nitf_Error error;
+    size_t slot;
+
+    if (!description)
+        return NULL;
+
+    nitf_Mutex_lock(GET_MUTEX());
+    if (__TREParserCacheSize > 0)
+    {
+        slot = cacheSlot(description, __TREParserCacheSize);
+        while (__TREParserCache[slot].description)
+        {
+            if (__TREParserCache[slot].description == description)
+            {
+                parser = __TREParserCache[slot].parser;
+                nitf_Mutex_unlock(GET_MUTEX());
+                return parser;
+            }
+            slot = (slot + 1) & (__TREParserCacheSize - 1);
+        }
+    }
+
+    parser = nitf_TREParser_construct(description, &error);
+    if (reserveCache())
+    {
+        slot = cacheSlot(description, __TREParserCacheSize);
+        while (__TREParserCache[slot].description)
+            slot = (slot + 1) & (__TREParserCacheSize - 1);
+        __TREParserCache[slot].description = description;
+        __TREParserCache[slot].parser = parser;
+        __TREParserCacheCount++;
+    }
+    else if (parser)
+    {
+        /* It would leak, so use the interpreter for this one */
+        nitf_TREParser_destruct(&parser);
+    }
+    nitf_Mutex_unlock(GET_MUTEX());
+    return parser;
+}
+
+NITFAPI(void) nitf_TREParser_evict(const nitf_TREDescription* description)
+{
+    size_t slot;
+    size_t next;
+    size_t home;
+
+    if (!description)
+        return;
+
+    nitf_Mutex_lock(GET_MUTEX());
+    if (__TREParserCacheSize == 0)
+    {
+        nitf_Mutex_unlock(GET_MUTEX());
+        return;
+    }
+
+    slot = cacheSlot(description, __TREParserCacheSize);
+    while (__TREParserCache[slot].description &&
+           __TREParserCache[slot].description != description)
+        slot = (slot + 1) & (__TREParserCacheSize - 1);
+    if (!__TREParserCache[slot].description)
+    {
+        nitf_Mutex_unlock(GET_MUTEX());
+        return;
+    }
+
+    if (__TREParserCache[slot].parser)
+        nitf_TREParser_destruct(&__TREParserCache[slot].parser);
+    __TREParserCache[slot].description = NULL;
+    __TREParserCacheCount--;
+
+    /*
+     *  Move the rest of the run back into the gap wherever that is still
+     *  at or after an entry's home slot, so lookups keep finding it
+     */
+    next = slot;
+    for (;;)
+    {
+        next = (next + 1) & (__TREParserCacheSize - 1);
+        if (!__TREParserCache[next].description)
+            break;
+        home = cacheSlot(__TREParserCache[next].description,
+                         __TREParserCacheSize);
+        if (slot < next ? (home <= slot || home > next)
+                        : (home <= slot && home > next))
+        {
+            __TREParserCache[slot] = __TREParserCache[next];
+            __TREParserCache[next].description = NULL;
+            __TREParserCache[next].parser = NULL;
+            slot = next;
+        }
+    }
+    nitf_Mutex_unlock(GET_MUTEX());
+}
+
+NITFPROT(void) nitf_TREParser_clearCache(void)
+{
+    nitf_Mutex_lock(GET_MUTEX());
+    freeCache();
+    nitf_Mutex_unlock(GET_MUTEX());
+}
@@ -21,6 +21,7 @@
  */
 
 #include "nitf/TREUtils.h"
+#include "nitf/TREParser.h"
 #include "nitf/TREPrivateData.h"
 
 NITFAPI(int) nitf_TREUtils_parse(nitf_TRE* tre, char* bufptr, nitf_Error* error)
@@ -778,6 +779,7 @@ nitf_TREUtils_basicRead(nitf_IOInterface* io,
     char* data = NULL;
     nitf_TREDescriptionSet* descriptions = NULL;
     nitf_TREDescriptionInfo* infoPtr = NULL;
+    const nitf_TREParser* parser = NULL;
 
     if (!tre)
         return NITF_FAILURE;
@@ -832,7 +834,11 @@ nitf_TREUtils_basicRead(nitf_IOInterface* io,
 #ifdef NITF_DEBUG
         printf("Trying TRE with description: %s\n\n", infoPtr->name);
 #endif
-        ok = nitf_TREUtils_parse(tre, data, error);
+        parser = nitf_TREParser_get(infoPtr->description);
+        if (parser)
+            ok = nitf_TREParser_parse(parser, tre, data, error);
+        else
+            ok = nitf_TREUtils_parse(tre, data, error);
         if (ok)
         {
             nitf_TREPrivateData* priv = (nitf_TREPrivateData*)tre->priv;
@@ -0,0 +1,220 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ *  Times nitf_ImageIO_read of an in-memory image for every pixel type that
+ *  needs unformatting or band interleaved by pixel unpacking, with the vector
+ *  functions enabled and disabled.
+ *
+ *  The command line call is:
+ *
+ *  bench_image_io_unformat [size] [iterations]
+ *
+ *  The image is size x size pixels in one block (default 1024) and each read
+ *  is repeated iterations times (default 20).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <import/nitf.h>
+
+typedef struct
+{
+    const char *pixelType;
+    uint32_t bits;
+    uint32_t actualBits;
+    const char *justification;
+    uint32_t numBands;
+    int iq;                 /* Two band I/Q, read as one interleaved band */
+}
+BenchSpec;
+
+static const BenchSpec SPECS[] =
+{
+    { "INT", 8, 8, "R", 2, 0 },
+    { "INT", 8, 8, "R", 3, 0 },
+    { "INT", 8, 8, "R", 4, 0 },
+    { "INT", 16, 16, "R", 1, 0 },
+    { "INT", 16, 12, "L", 1, 0 },
+    { "INT", 16, 16, "R", 2, 0 },
+    { "SI", 16, 12, "R", 1, 0 },
+    { "SI", 16, 12, "L", 1, 0 },
+    { "SI", 16, 16, "R", 2, 1 },
+    { "INT", 32, 32, "R", 1, 0 },
+    { "INT", 32, 20, "L", 1, 0 },
+    { "SI", 32, 24, "R", 1, 0 },
+    { "SI", 32, 24, "L", 1, 0 },
+    { "R", 32, 32, "R", 1, 0 },
+    { "R", 32, 32, "R", 2, 0 },
+    { "R", 32, 32, "R", 2, 1 },
+    { "INT", 64, 64, "R", 1, 0 },
+    { "INT", 64, 40, "L", 1, 0 },
+    { "SI", 64, 40, "R", 1, 0 },
+    { "SI", 64, 40, "L", 1, 0 },
+    { "R", 64, 64, "R", 1, 0 },
+    { "R", 64, 64, "R", 2, 1 },
+    { "C", 64, 64, "R", 1, 0 }
+};
+
+/* Returns the seconds taken by the reads, or a negative value on error */
+static double timeReads(const BenchSpec *spec, uint32_t size, int iterations,
+                        char *data, size_t dataSize, uint8_t *out,
+                        int vectorize)
+{
+    const uint32_t numRead = spec->iq ? 1 : spec->numBands;
+    const size_t bandSize = (size_t) size * size * (spec->bits / 8) *
+                            (spec->numBands / numRead);
+    nitf_Error error;
+    nitf_ImageSubheader *subheader;
+    nitf_BandInfo **bands;
+    nitf_ImageIO *imageIO;
+    nitf_IOInterface *io;
+    nitf_SubWindow *subwindow;
+    uint32_t bandList[4];
+    uint8_t *user[4];
+    uint32_t band;
+    int padded;
+    int i;
+    clock_t start;
+    double seconds = -1.;
+
+    subheader = nitf_ImageSubheader_construct(&error);
+    if (!subheader)
+        goto CATCH_ERROR;
+    nitf_ImageSubheader_setBlocking(subheader, size, size, size, size,
+                                    spec->numBands > 1 ? "P" : "B", &error);
+
+    /* The subheader takes the band array */
+    bands = (nitf_BandInfo **) NITF_MALLOC(sizeof(nitf_BandInfo *) *
+                                           spec->numBands);
+    if (!bands)
+        goto CATCH_ERROR;
+    for (band = 0; band < spec->numBands; ++band)
+    {
+        bands[band] = nitf_BandInfo_construct(&error);
+        if (!bands[band]
+            || !nitf_BandInfo_init(bands[band], "M",
+                                   spec->iq ? (band == 0 ? "I" : "Q") : " ",
+                                   "N", "   ", 0, 0, NULL, &error))
+            goto CATCH_ERROR;
+        bandList[band] = band;
+        user[band] = out + band * bandSize;
+    }
+    if (!nitf_ImageSubheader_setPixelInformation(
+            subheader, spec->pixelType, spec->bits, spec->actualBits,
+            spec->justification, spec->numBands > 1 ? "MULTI" : "MONO",
+            "VIS", spec->numBands, bands, &error)
+        || !nitf_ImageSubheader_setCompression(subheader, "NC", "", &error))
+        goto CATCH_ERROR;
+
+    imageIO = nitf_ImageIO_construct(subheader, 0, dataSize, NULL, NULL,
+                                     NULL, &error);
+    if (!imageIO)
+        goto CATCH_ERROR;
+    io = nitf_BufferAdapter_construct(data, dataSize, 0, &error);
+    if (!io)
+        goto CATCH_ERROR;
+    subwindow = nitf_SubWindow_construct(&error);
+    if (!subwindow)
+        goto CATCH_ERROR;
+    subwindow->startRow = 0;
+    subwindow->numRows = size;
+    subwindow->startCol = 0;
+    subwindow->numCols = size;
+    subwindow->numBands = numRead;
+    subwindow->bandList = bandList;
+
+    nitf_ImageIO_setVectorization(imageIO, vectorize);
+    start = clock();
+    for (i = 0; i < iterations; i++)
+    {
+        if (!nitf_ImageIO_read(imageIO, io, subwindow, user, &padded, &error))
+            goto CATCH_ERROR;
+    }
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    nitf_SubWindow_destruct(&subwindow);
+    nitf_IOInterface_destruct(&io);
+    nitf_ImageIO_destruct(&imageIO);
+    nitf_ImageSubheader_destruct(&subheader);
+    return seconds;
+
+CATCH_ERROR:
+    nitf_Error_print(&error, stderr, "Benchmark failed");
+    return -1.;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t size = (argc > 1) ? (uint32_t) atoi(argv[1]) : 1024;
+    const int iterations = (argc > 2) ? atoi(argv[2]) : 20;
+    size_t i, j;
+
+    printf("%-4s %5s %5s %4s %5s %3s %10s %10s %8s\n", "TYPE", "NBPP",
+           "ABPP", "JUST", "BANDS", "IQ", "SCALAR(s)", "VECTOR(s)", "SPEEDUP");
+
+    for (i = 0; i < sizeof(SPECS) / sizeof(SPECS[0]); i++)
+    {
+        const BenchSpec *spec = SPECS + i;
+        const size_t dataSize = (size_t) size * size * (spec->bits / 8) *
+                                spec->numBands;
+        char *data = (char *) NITF_MALLOC(dataSize);
+        uint8_t *scalarOut = (uint8_t *) NITF_MALLOC(dataSize);
+        uint8_t *vectorOut = (uint8_t *) NITF_MALLOC(dataSize);
+        double scalar, vector;
+
+        if (!data || !scalarOut || !vectorOut)
+        {
+            fprintf(stderr, "Could not allocate %lu bytes\n",
+                    (unsigned long) dataSize);
+            return 1;
+        }
+        for (j = 0; j < dataSize; j++)
+            data[j] = (char) ((j * 131 + j / 7) & 0xFF);
+
+        scalar = timeReads(spec, size, iterations, data, dataSize,
+                           scalarOut, 0);
+        vector = timeReads(spec, size, iterations, data, dataSize,
+                           vectorOut, 1);
+        if (scalar < 0. || vector < 0.)
+            return 1;
+        if (memcmp(scalarOut, vectorOut, dataSize) != 0)
+        {
+            fprintf(stderr, "Vector and scalar reads differ for %s %u\n",
+                    spec->pixelType, spec->bits);
+            return 1;
+        }
+
+        printf("%-4s %5u %5u %4s %5u %3s %10.4f %10.4f %7.2fx\n",
+               spec->pixelType, spec->bits, spec->actualBits,
+               spec->justification, spec->numBands, spec->iq ? "Y" : "N",
+               scalar, vector, (vector > 0.) ? scalar / vector : 0.);
+
+        NITF_FREE(data);
+        NITF_FREE(scalarOut);
+        NITF_FREE(vectorOut);
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ *  Times what a short-lived program pays for TRE handlers: creating the
+ *  plugin registry, then the first lookup of a few tags.  The registry is a
+ *  singleton, so each run is a new process (this program, run again with
+ *  --child).  Each plugin load mode (NITF_PLUGIN_LOAD_MODE) is run several
+ *  times, and the modes must find handlers for the same tags.
+ *
+ *  The command line call is:
+ *
+ *  bench_plugin_startup [runs] [tag ...]
+ *
+ *  runs defaults to 10, and the tags to a handful of common ones.  Times
+ *  are CPU time in milliseconds.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <import/nitf.h>
+
+#if defined(WIN32) || defined(_WIN32)
+#define popen _popen
+#define pclose _pclose
+#define putenv _putenv
+#endif
+
+static const char *DEFAULT_TAGS[] =
+{
+    "ACFTB", "AIMIDB", "BLOCKA", "PIAIMC", "RPC00B", "STDIDC", "USE00A"
+};
+
+static double msSince(clock_t start)
+{
+    return (double) (clock() - start) * 1000. / CLOCKS_PER_SEC;
+}
+
+/* Prints "<registry ms> <lookup ms> <tags handled>" */
+static int runChild(const char *mode, int numTags, char **tags)
+{
+    static char loadMode[64];
+    nitf_Error error;
+    nitf_PluginRegistry *reg;
+    clock_t start;
+    double registryTime;
+    int found = 0;
+    int i;
+
+    NITF_SNPRINTF(loadMode, sizeof(loadMode), "%s=%s",
+                  NITF_PLUGIN_LOAD_MODE, mode);
+    putenv(loadMode);
+
+    start = clock();
+    reg = nitf_PluginRegistry_getInstance(&error);
+    if (!reg)
+    {
+        nitf_Error_print(&error, stderr, "Could not create the registry");
+        return 1;
+    }
+    registryTime = msSince(start);
+
+    start = clock();
+    for (i = 0; i < numTags; i++)
+    {
+        int bad = 0;
+        if (nitf_PluginRegistry_retrieveTREHandler(reg, tags[i], &bad,
+                                                   &error))
+            found++;
+        if (bad)
+        {
+            nitf_Error_print(&error, stderr, tags[i]);
+            return 1;
+        }
+    }
+
+    printf("%f %f %d\n", registryTime, msSince(start), found);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *MODES[] = { "eager", "lazy" };
+    const char **tags = DEFAULT_TAGS;
+    int numTags = (int) (sizeof(DEFAULT_TAGS) / sizeof(DEFAULT_TAGS[0]));
+    int runs = 10;
+    int expectedFound = -1;
+    char command[4096];
+    size_t length;
+    size_t m;
+    int i;
+
+    if (argc > 2 && strcmp(argv[1], "--child") == 0)
+        return runChild(argv[2], argc - 3, argv + 3);
+
+    if (argc > 1)
+        runs = atoi(argv[1]);
+    if (argc > 2)
+    {
+        tags = (const char **) (argv + 2);
+        numTags = argc - 2;
+    }
+
+    printf("%-6s %12s %12s %12s %6s\n", "MODE", "REGISTRY(ms)", "LOOKUP(ms)",
+           "TOTAL(ms)", "FOUND");
+    for (m = 0; m < sizeof(MODES) / sizeof(MODES[0]); m++)
+    {
+        double registryTime = 0.;
+        double lookupTime = 0.;
+        int found = 0;
+
+        length = (size_t) NITF_SNPRINTF(command, sizeof(command),
+                                        "\"%s\" --child %s", argv[0],
+                                        MODES[m]);
+        for (i = 0; i < numTags && length < sizeof(command); i++)
+        {
+            length += (size_t) NITF_SNPRINTF(command + length,
+                                             sizeof(command) - length,
+                                             " \"%s\"", tags[i]);
+        }
+
+        for (i = 0; i < runs; i++)
+        {
+            double registryRun, lookupRun;
+            FILE *child = popen(command, "r");
+            if (!child)
+            {
+                fprintf(stderr, "Could not run %s\n", command);
+                return 1;
+            }
+            if (fscanf(child, "%lf %lf %d", &registryRun, &lookupRun,
+                       &found) != 3)
+            {
+                fprintf(stderr, "Run failed: %s\n", command);
+                pclose(child);
+                return 1;
+            }
+            pclose(child);
+            registryTime += registryRun;
+            lookupTime += lookupRun;
+        }
+
+        if (runs > 0)
+        {
+            registryTime /= runs;
+            lookupTime /= runs;
+        }
+        printf("%-6s %12.3f %12.3f %12.3f %3d/%d\n", MODES[m], registryTime,
+               lookupTime, registryTime + lookupTime, found, numTags);
+
+        if (expectedFound < 0)
+            expectedFound = found;
+        else if (found != expectedFound)
+        {
+            fprintf(stderr, "The load modes handle different tags\n");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,415 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ *  Compares parsing TRE data with nitf_TREUtils_parse() (the TRECursor
+ *  interpreter) and with a compiled nitf_TREParser, for every description of
+ *  every TRE plugin in the plugin path.  Each description is fed its default
+ *  data and a set of generated buffers (digits, text and random bytes, of a
+ *  few sizes), and both must give the same status, error and fields.
+ *
+ *  The command line call is:
+ *
+ *  bench_tre_parse [iterations] [tag ...]
+ *
+ *  iterations (default 20) is how many times each buffer is parsed for the
+ *  timings, and the tags limit the run to those TREs.  Times are CPU time in
+ *  milliseconds.  Both parsers print length expression errors to stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <import/nitf.h>
+
+/* Room past each buffer, since the cursor reads past the end of short data */
+#define SLACK (1024 * 1024)
+
+#define NUM_SIZES 3
+static const uint32_t SIZES[NUM_SIZES] = { 64, 1024, 16384 };
+
+typedef enum
+{
+    PATTERN_DEFAULT,
+    PATTERN_ONES,
+    PATTERN_TWOS,
+    PATTERN_SMALL_DIGITS,
+    PATTERN_DIGITS,
+    PATTERN_TEXT,
+    PATTERN_BYTES,
+    NUM_PATTERNS
+} Pattern;
+
+static double msSince(clock_t start)
+{
+    return (double) (clock() - start) * 1000. / CLOCKS_PER_SEC;
+}
+
+static int wantTag(const char *tag, int numTags, char **tags)
+{
+    int i;
+    if (numTags == 0)
+        return 1;
+    for (i = 0; i < numTags; i++)
+    {
+        if (strcmp(tag, tags[i]) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+/* Fills buffer (which has SLACK zeros after length) or returns 0 */
+static uint32_t makeData(const char *tag, const char *name, Pattern pattern,
+                         uint32_t size, char *buffer)
+{
+    static const char TEXT[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .-+";
+    uint32_t length = size;
+    uint32_t i;
+
+    memset(buffer, 0, size + SLACK);
+    switch (pattern)
+    {
+        case PATTERN_DEFAULT:
+        {
+            nitf_Error error;
+            nitf_TRE *tre = nitf_TRE_construct(tag, name, &error);
+            char *raw;
+            if (!tre)
+                return 0;
+            raw = nitf_TREUtils_getRawData(tre, &length, &error);
+            nitf_TRE_destruct(&tre);
+            if (!raw || length == 0 || length > size)
+            {
+                if (raw)
+                    NITF_FREE(raw);
+                return 0;
+            }
+            memcpy(buffer, raw, length);
+            NITF_FREE(raw);
+            break;
+        }
+        case PATTERN_ONES:
+        case PATTERN_TWOS:
+            memset(buffer, pattern == PATTERN_ONES ? '1' : '2', length);
+            break;
+        case PATTERN_SMALL_DIGITS:
+            for (i = 0; i < length; i++)
+                buffer[i] = (char) ('0' + rand() % 3);
+            break;
+        case PATTERN_DIGITS:
+            for (i = 0; i < length; i++)
+                buffer[i] = (char) ('0' + rand() % 10);
+            break;
+        case PATTERN_TEXT:
+            for (i = 0; i < length; i++)
+                buffer[i] = TEXT[rand() % (sizeof(TEXT) - 1)];
+            break;
+        default:
+            for (i = 0; i < length; i++)
+                buffer[i] = (char) (rand() & 0xff);
+            break;
+    }
+    return length;
+}
+
+/*
+ *  Returns 1 if the handler came from nitf_TREUtils_createBasicHandler().
+ *  Each plugin links its own copy of nitf-c, so unless this program exports
+ *  its symbols (-rdynamic) a plugin's handler points at that plugin's
+ *  nitf_TREUtils_basicRead(), not ours.  Look it up in every loaded plugin.
+ */
+static int isBasicHandler(nitf_PluginRegistry *reg, nitf_TREHandler *handler)
+{
+    nitf_ListIterator iter;
+    nitf_ListIterator end;
+
+    if (handler->read == nitf_TREUtils_basicRead)
+        return 1;
+
+    iter = nitf_List_begin(reg->dsos);
+    end = nitf_List_end(reg->dsos);
+    for (; nitf_ListIterator_notEqualTo(&iter, &end);
+         nitf_ListIterator_increment(&iter))
+    {
+        nitf_DLL *dll = (nitf_DLL *) nitf_ListIterator_get(&iter);
+        nitf_Error error;
+        NITF_DLL_FUNCTION_PTR read =
+                nitf_DLL_retrieve(dll, "nitf_TREUtils_basicRead", &error);
+        if (read && (NITF_TRE_READER) read == handler->read)
+            return 1;
+    }
+    return 0;
+}
+
+static nitf_TRE *makeTRE(const char *tag, nitf_TREHandler *handler,
+                         nitf_TREDescription *description, uint32_t length,
+                         nitf_Error *error)
+{
+    nitf_TREPrivateData *priv;
+    nitf_TRE *tre = nitf_TRE_createSkeleton(tag, error);
+    if (!tre)
+        return NULL;
+
+    tre->handler = handler;
+    priv = nitf_TREPrivateData_construct(error);
+    if (!priv)
+    {
+        nitf_TRE_destruct(&tre);
+        return NULL;
+    }
+    priv->length = length;
+    priv->description = description;
+    tre->priv = priv;
+    return tre;
+}
+
+/* Returns 1 if both TREs hold the same fields under the same keys */
+static int sameFields(nitf_TRE *a, nitf_TRE *b)
+{
+    nitf_HashTable *hashA = ((nitf_TREPrivateData *) a->priv)->hash;
+    nitf_HashTable *hashB = ((nitf_TREPrivateData *) b->priv)->hash;
+    int i;
+
+    if (hashA->nbuckets != hashB->nbuckets)
+        return 0;
+    for (i = 0; i < hashA->nbuckets; i++)
+    {
+        nitf_ListIterator iterA = nitf_List_begin(hashA->buckets[i]);
+        nitf_ListIterator endA = nitf_List_end(hashA->buckets[i]);
+        nitf_ListIterator iterB = nitf_List_begin(hashB->buckets[i]);
+        nitf_ListIterator endB = nitf_List_end(hashB->buckets[i]);
+
+        while (nitf_ListIterator_notEqualTo(&iterA, &endA) &&
+               nitf_ListIterator_notEqualTo(&iterB, &endB))
+        {
+            nitf_Pair *pairA = (nitf_Pair *) nitf_ListIterator_get(&iterA);
+            nitf_Pair *pairB = (nitf_Pair *) nitf_ListIterator_get(&iterB);
+            nitf_Field *fieldA = (nitf_Field *) pairA->data;
+            nitf_Field *fieldB = (nitf_Field *) pairB->data;
+
+            if (strcmp(pairA->key, pairB->key) != 0 ||
+                fieldA->type != fieldB->type ||
+                fieldA->length != fieldB->length ||
+                memcmp(fieldA->raw, fieldB->raw, fieldA->length) != 0)
+                return 0;
+
+            nitf_ListIterator_increment(&iterA);
+            nitf_ListIterator_increment(&iterB);
+        }
+        if (nitf_ListIterator_notEqualTo(&iterA, &endA) ||
+            nitf_ListIterator_notEqualTo(&iterB, &endB))
+            return 0;
+    }
+    return 1;
+}
+
+typedef struct
+{
+    int buffers;
+    int parsed;
+    int mismatches;
+    double interpreterTime;
+    double compiledTime;
+} Result;
+
+/* Parses one buffer both ways, checking and timing them */
+static void compare(const char *tag, nitf_TREHandler *handler,
+                    nitf_TREDescriptionInfo *info,
+                    const nitf_TREParser *parser, char *data,
+                    uint32_t length, int iterations, Result *result)
+{
+    nitf_Error error;
+    nitf_Error interpreterError;
+    nitf_Error compiledError;
+    nitf_TRE *interpreted;
+    nitf_TRE *compiled;
+    int interpreterOK, compiledOK;
+    clock_t start;
+    int i;
+
+    interpreted = makeTRE(tag, handler, info->description, length, &error);
+    compiled = makeTRE(tag, handler, info->description, length, &error);
+    if (!interpreted || !compiled)
+    {
+        nitf_Error_print(&error, stderr, tag);
+        exit(1);
+    }
+
+    memset(&interpreterError, 0, sizeof(interpreterError));
+    memset(&compiledError, 0, sizeof(compiledError));
+    interpreterOK = nitf_TREUtils_parse(interpreted, data, &interpreterError);
+    compiledOK = nitf_TREParser_parse(parser, compiled, data, &compiledError);
+
+    result->buffers++;
+    if (interpreterOK)
+        result->parsed++;
+    if (interpreterOK != compiledOK ||
+        (!interpreterOK &&
+         strcmp(interpreterError.message, compiledError.message) != 0) ||
+        !sameFields(interpreted, compiled))
+    {
+        result->mismatches++;
+        printf("MISMATCH %s (%s), %u bytes: interpreter %d \"%s\", "
+               "compiled %d \"%s\"\n", tag, info->name, length,
+               interpreterOK, interpreterOK ? "" : interpreterError.message,
+               compiledOK, compiledOK ? "" : compiledError.message);
+    }
+
+    start = clock();
+    for (i = 0; i < iterations; i++)
+        nitf_TREUtils_parse(interpreted, data, &error);
+    result->interpreterTime += msSince(start);
+
+    start = clock();
+    for (i = 0; i < iterations; i++)
+        nitf_TREParser_parse(parser, compiled, data, &error);
+    result->compiledTime += msSince(start);
+
+    nitf_TRE_destruct(&interpreted);
+    nitf_TRE_destruct(&compiled);
+}
+
+int main(int argc, char **argv)
+{
+    static char loadMode[] = NITF_PLUGIN_LOAD_MODE "=eager";
+    nitf_Error error;
+    nitf_PluginRegistry *reg;
+    nitf_HashTable *handlers;
+    char *data;
+    int iterations = 20;
+    int numTags = 0;
+    char **tags = NULL;
+    Result total;
+    int interpreted = 0;
+    int i;
+
+    if (argc > 1)
+        iterations = atoi(argv[1]);
+    if (argc > 2)
+    {
+        tags = argv + 2;
+        numTags = argc - 2;
+    }
+
+    putenv(loadMode);
+    reg = nitf_PluginRegistry_getInstance(&error);
+    if (!reg)
+    {
+        nitf_Error_print(&error, stderr, "Could not create the registry");
+        return 1;
+    }
+
+    data = (char *) malloc(SIZES[NUM_SIZES - 1] + SLACK);
+    if (!data)
+        return 1;
+    srand(1);
+    memset(&total, 0, sizeof(total));
+
+    printf("%-16s %7s %7s %14s %12s %8s\n", "TRE", "BUFFERS", "PARSED",
+           "INTERPRET(ms)", "COMPILED(ms)", "SPEEDUP");
+
+    handlers = reg->treHandlers;
+    for (i = 0; i < handlers->nbuckets; i++)
+    {
+        nitf_ListIterator iter = nitf_List_begin(handlers->buckets[i]);
+        nitf_ListIterator end = nitf_List_end(handlers->buckets[i]);
+
+        for (; nitf_ListIterator_notEqualTo(&iter, &end);
+             nitf_ListIterator_increment(&iter))
+        {
+            nitf_Pair *pair = (nitf_Pair *) nitf_ListIterator_get(&iter);
+            nitf_TREHandler *handler;
+            nitf_TREDescriptionSet *set;
+            nitf_TREDescriptionInfo *info;
+            Result result;
+            int bad = 0;
+
+            if (!wantTag(pair->key, numTags, tags))
+                continue;
+            handler = nitf_PluginRegistry_retrieveTREHandler(reg, pair->key,
+                                                             &bad, &error);
+            if (bad || !handler || !isBasicHandler(reg, handler))
+                continue;
+
+            memset(&result, 0, sizeof(result));
+            set = (nitf_TREDescriptionSet *) handler->data;
+            for (info = set->descriptions; info && info->description; info++)
+            {
+                const nitf_TREParser *parser =
+                        nitf_TREParser_get(info->description);
+                int pattern, size;
+                if (!parser)
+                {
+                    printf("%s (%s) uses the interpreter\n", pair->key,
+                           info->name);
+                    interpreted++;
+                    continue;
+                }
+
+                for (pattern = 0; pattern < NUM_PATTERNS; pattern++)
+                {
+                    for (size = 0; size < NUM_SIZES; size++)
+                    {
+                        uint32_t length = makeData(pair->key, info->name,
+                                                   (Pattern) pattern,
+                                                   SIZES[size], data);
+                        if (length > 0)
+                        {
+                            compare(pair->key, handler, info, parser, data,
+                                    length, iterations, &result);
+                        }
+                        /* The default data doesn't depend on the size */
+                        if (pattern == PATTERN_DEFAULT && length > 0)
+                            break;
+                    }
+                }
+            }
+
+            if (result.buffers > 0)
+            {
+                printf("%-16s %7d %7d %14.3f %12.3f %7.2fx\n", pair->key,
+                       result.buffers, result.parsed, result.interpreterTime,
+                       result.compiledTime,
+                       result.compiledTime > 0. ?
+                               result.interpreterTime / result.compiledTime :
+                               0.);
+            }
+            total.buffers += result.buffers;
+            total.parsed += result.parsed;
+            total.mismatches += result.mismatches;
+            total.interpreterTime += result.interpreterTime;
+            total.compiledTime += result.compiledTime;
+        }
+    }
+
+    printf("%-16s %7d %7d %14.3f %12.3f %7.2fx\n", "TOTAL", total.buffers,
+           total.parsed, total.interpreterTime, total.compiledTime,
+           total.compiledTime > 0. ?
+                   total.interpreterTime / total.compiledTime : 0.);
+    printf("%d descriptions use the interpreter, %d mismatches\n",
+           interpreted, total.mismatches);
+    free(data);
+    return total.mismatches == 0 ? 0 : 1;
+}
@@ -926,6 +926,400 @@ TEST_CASE(testPBlock4BytePixels)
     }
 }
 
+TEST_CASE(testReadDirect)
+{
+    /* One band, 4 full-width blocks of 4 rows each */
+    const char* const filename = "test_image_io_read_direct.tmp";
+    nitf_Error error;
+    uint8_t pixels[NUM_ROWS * NUM_COLS];
+    uint8_t readPixels[NUM_ROWS * NUM_COLS];
+    uint8_t* user[1];
+    const uint8_t* data;
+    uint32_t bandList = 0;
+    int padded;
+    size_t ii;
+
+    for (ii = 0; ii < sizeof(pixels); ++ii)
+    {
+        pixels[ii] = (uint8_t)('A' + ii / NUM_COLS);
+    }
+    FILE* file = fopen(filename, "wb");
+    TEST_ASSERT(file);
+    fwrite(pixels, 1, sizeof(pixels), file);
+    fclose(file);
+
+    nitf_ImageSubheader* subheader = nitf_ImageSubheader_construct(&error);
+    TEST_ASSERT(subheader);
+    nitf_ImageSubheader_setBlocking(subheader, NUM_ROWS, NUM_COLS,
+                                    ROWS_PER_BLOCK, NUM_COLS, "B", &error);
+    /* The subheader takes the band array */
+    nitf_BandInfo** band = (nitf_BandInfo**)malloc(sizeof(nitf_BandInfo*));
+    TEST_ASSERT(band);
+    band[0] = nitf_BandInfo_construct(&error);
+    TEST_ASSERT(band[0]);
+    TEST_ASSERT(nitf_BandInfo_init(band[0], "M", " ", "N", "   ", 0, 0, NULL,
+                                   &error));
+    nitf_ImageSubheader_setPixelInformation(subheader, "INT", 8, 8, "R",
+                                            "MONO", "VIS", 1, band, &error);
+    nitf_ImageSubheader_setCompression(subheader, "NC", "", &error);
+
+    nitf_ImageIO* imageIO = nitf_ImageIO_construct(
+            subheader, 0, sizeof(pixels), NULL, NULL, NULL, &error);
+    TEST_ASSERT(imageIO);
+    nitf_IOInterface* io = nitf_MMapAdapter_open(filename, &error);
+    TEST_ASSERT(io);
+    TEST_ASSERT(nitf_MMapAdapter_advise(io, 0, 0, NITF_MMAP_SEQUENTIAL,
+                                        &error));
+
+    nitf_SubWindow* subwindow = nitf_SubWindow_construct(&error);
+    TEST_ASSERT(subwindow);
+    subwindow->numBands = 1;
+    subwindow->bandList = &bandList;
+
+    /* Full rows across several blocks point straight into the file */
+    subwindow->startRow = 2;
+    subwindow->numRows = 9;
+    subwindow->startCol = 0;
+    subwindow->numCols = NUM_COLS;
+    TEST_ASSERT(nitf_ImageIO_readDirect(imageIO, io, subwindow, &data,
+                                        &error));
+    TEST_ASSERT(data == nitf_MMapAdapter_getData(io, 2 * NUM_COLS, 1, &error));
+
+    /* ... and match what a copying read returns */
+    user[0] = readPixels;
+    TEST_ASSERT(nitf_ImageIO_read(imageIO, io, subwindow, user, &padded,
+                                  &error));
+    TEST_ASSERT(memcmp(data, readPixels, 9 * NUM_COLS) == 0);
+
+    /* So does part of one row */
+    subwindow->startRow = 5;
+    subwindow->numRows = 1;
+    subwindow->startCol = 3;
+    subwindow->numCols = 7;
+    TEST_ASSERT(nitf_ImageIO_readDirect(imageIO, io, subwindow, &data,
+                                        &error));
+    TEST_ASSERT(data == nitf_MMapAdapter_getData(io, 5 * NUM_COLS + 3, 1,
+                                                 &error));
+
+    /* Parts of several rows aren't contiguous */
+    subwindow->numRows = 2;
+    TEST_ASSERT(nitf_ImageIO_readDirect(imageIO, io, subwindow, &data,
+                                        &error));
+    TEST_ASSERT_NULL(data);
+
+    /* Nor is anything that isn't mapped */
+    nitf_IOInterface* bufferIO = nitf_BufferAdapter_construct(
+            (char*)pixels, sizeof(pixels), 0, &error);
+    TEST_ASSERT(bufferIO);
+    subwindow->numRows = 1;
+    TEST_ASSERT(nitf_ImageIO_readDirect(imageIO, bufferIO, subwindow, &data,
+                                        &error));
+    TEST_ASSERT_NULL(data);
+
+    nitf_IOInterface_destruct(&bufferIO);
+    nitf_SubWindow_destruct(&subwindow);
+    nitf_IOInterface_destruct(&io);
+    nitf_ImageIO_destruct(&imageIO);
+    nitf_ImageSubheader_destruct(&subheader);
+    remove(filename);
+}
+
+TEST_CASE(testReadBlockMapped)
+{
+    /* One band, 4 full-width blocks of 4 rows each */
+    const char* const filename = "test_image_io_read_block_mapped.tmp";
+    const uint64_t blockBytes = ROWS_PER_BLOCK * NUM_COLS;
+    nitf_Error error;
+    uint8_t pixels[NUM_ROWS * NUM_COLS];
+    const uint8_t* block;
+    const uint8_t* copied;
+    uint64_t blockSize;
+    size_t ii;
+
+    for (ii = 0; ii < sizeof(pixels); ++ii)
+    {
+        pixels[ii] = (uint8_t)('A' + ii / NUM_COLS);
+    }
+    FILE* file = fopen(filename, "wb");
+    TEST_ASSERT(file);
+    fwrite(pixels, 1, sizeof(pixels), file);
+    fclose(file);
+
+    nitf_ImageSubheader* subheader = nitf_ImageSubheader_construct(&error);
+    TEST_ASSERT(subheader);
+    nitf_ImageSubheader_setBlocking(subheader, NUM_ROWS, NUM_COLS,
+                                    ROWS_PER_BLOCK, NUM_COLS, "B", &error);
+    /* The subheader takes the band array */
+    nitf_BandInfo** band = (nitf_BandInfo**)malloc(sizeof(nitf_BandInfo*));
+    TEST_ASSERT(band);
+    band[0] = nitf_BandInfo_construct(&error);
+    TEST_ASSERT(band[0]);
+    TEST_ASSERT(nitf_BandInfo_init(band[0], "M", " ", "N", "   ", 0, 0, NULL,
+                                   &error));
+    nitf_ImageSubheader_setPixelInformation(subheader, "INT", 8, 8, "R",
+                                            "MONO", "VIS", 1, band, &error);
+    nitf_ImageSubheader_setCompression(subheader, "NC", "", &error);
+
+    nitf_ImageIO* imageIO = nitf_ImageIO_construct(
+            subheader, 0, sizeof(pixels), NULL, NULL, NULL, &error);
+    TEST_ASSERT(imageIO);
+    nitf_IOInterface* io = nitf_MMapAdapter_open(filename, &error);
+    TEST_ASSERT(io);
+    TEST_ASSERT(nitf_ImageIO_setupDirectBlockRead(imageIO, io, 1, &error));
+
+    /* The block points straight into the file */
+    TEST_ASSERT(nitf_ImageIO_readBlockMapped(imageIO, io, 2, &block,
+                                             &blockSize, &error));
+    TEST_ASSERT(block == nitf_MMapAdapter_getData(io, 2 * blockBytes, 1,
+                                                  &error));
+    TEST_ASSERT(blockSize == blockBytes);
+
+    /* ... while the writable one is still a copy of it */
+    copied = nitf_ImageIO_readBlockDirect(imageIO, io, 2, &blockSize, &error);
+    TEST_ASSERT(copied);
+    TEST_ASSERT(copied != block);
+    TEST_ASSERT(blockSize == blockBytes);
+    TEST_ASSERT(memcmp(copied, block, (size_t)blockBytes) == 0);
+
+    /* Nothing that isn't mapped can be read in place */
+    nitf_IOInterface* bufferIO = nitf_BufferAdapter_construct(
+            (char*)pixels, sizeof(pixels), 0, &error);
+    TEST_ASSERT(bufferIO);
+    TEST_ASSERT(nitf_ImageIO_readBlockMapped(imageIO, bufferIO, 2, &block,
+                                             &blockSize, &error));
+    TEST_ASSERT_NULL(block);
+
+    nitf_IOInterface_destruct(&bufferIO);
+    nitf_IOInterface_destruct(&io);
+    nitf_ImageIO_destruct(&imageIO);
+    nitf_ImageSubheader_destruct(&subheader);
+    remove(filename);
+}
+
+TEST_CASE(testReadBatch)
+{
+    /* One band of 16 bit big endian pixels in 4 x 4 blocks */
+    const char* const filename = "test_image_io_read_batch.tmp";
+    nitf_Error error;
+    uint8_t fileData[NUM_ROWS * NUM_COLS * 2];
+    uint16_t readPixels[NUM_ROWS * NUM_COLS];
+    uint8_t* user[1];
+    uint32_t bandList = 0;
+    int padded;
+    size_t row, col, ii, offset;
+
+    /* Each pixel is row * NUM_COLS + col, stored block by block */
+    for (row = 0; row < NUM_ROWS; ++row)
+    {
+        for (col = 0; col < NUM_COLS; ++col)
+        {
+            const uint16_t value = (uint16_t)(row * NUM_COLS + col);
+            const size_t block = (row / ROWS_PER_BLOCK) *
+                    (NUM_COLS / COLS_PER_BLOCK) + col / COLS_PER_BLOCK;
+            offset = 2 * (block * ROWS_PER_BLOCK * COLS_PER_BLOCK +
+                    (row % ROWS_PER_BLOCK) * COLS_PER_BLOCK +
+                    col % COLS_PER_BLOCK);
+            fileData[offset] = (uint8_t)(value >> 8);
+            fileData[offset + 1] = (uint8_t)(value & 0xFF);
+        }
+    }
+    FILE* file = fopen(filename, "wb");
+    TEST_ASSERT(file);
+    fwrite(fileData, 1, sizeof(fileData), file);
+    fclose(file);
+
+    nitf_ImageSubheader* subheader = nitf_ImageSubheader_construct(&error);
+    TEST_ASSERT(subheader);
+    nitf_ImageSubheader_setBlocking(subheader, NUM_ROWS, NUM_COLS,
+                                    ROWS_PER_BLOCK, COLS_PER_BLOCK, "B",
+                                    &error);
+    /* The subheader takes the band array */
+    nitf_BandInfo** band = (nitf_BandInfo**)malloc(sizeof(nitf_BandInfo*));
+    TEST_ASSERT(band);
+    band[0] = nitf_BandInfo_construct(&error);
+    TEST_ASSERT(band[0]);
+    TEST_ASSERT(nitf_BandInfo_init(band[0], "M", " ", "N", "   ", 0, 0, NULL,
+                                   &error));
+    nitf_ImageSubheader_setPixelInformation(subheader, "INT", 16, 16, "R",
+                                            "MONO", "VIS", 1, band, &error);
+    nitf_ImageSubheader_setCompression(subheader, "NC", "", &error);
+
+    nitf_ImageIO* imageIO = nitf_ImageIO_construct(
+            subheader, 0, sizeof(fileData), NULL, NULL, NULL, &error);
+    TEST_ASSERT(imageIO);
+
+    nitf_SubWindow* subwindow = nitf_SubWindow_construct(&error);
+    TEST_ASSERT(subwindow);
+    subwindow->numBands = 1;
+    subwindow->bandList = &bandList;
+    subwindow->startRow = 3;
+    subwindow->numRows = 10;
+    subwindow->startCol = 2;
+    subwindow->numCols = 12;
+    user[0] = (uint8_t*)readPixels;
+
+    /* Concurrent reads, then one at a time; both land in the same place */
+    for (ii = 0; ii < 2; ++ii)
+    {
+        nitf_IOInterface* io = (ii == 0) ?
+                nitf_AsyncIOAdapter_open(filename, 3, &error) :
+                nitf_IOHandleAdapter_open(filename, NITF_ACCESS_READONLY,
+                                          NITF_OPEN_EXISTING, &error);
+        TEST_ASSERT(io);
+
+        memset(readPixels, 0, sizeof(readPixels));
+        TEST_ASSERT(nitf_ImageIO_read(imageIO, io, subwindow, user, &padded,
+                                      &error));
+        for (row = 0; row < subwindow->numRows; ++row)
+        {
+            for (col = 0; col < subwindow->numCols; ++col)
+            {
+                TEST_ASSERT(readPixels[row * subwindow->numCols + col] ==
+                            (row + subwindow->startRow) * NUM_COLS +
+                            col + subwindow->startCol);
+            }
+        }
+        nitf_IOInterface_destruct(&io);
+    }
+
+    nitf_SubWindow_destruct(&subwindow);
+    nitf_ImageIO_destruct(&imageIO);
+    nitf_ImageSubheader_destruct(&subheader);
+    remove(filename);
+}
+
+/* Reads are compared with the vector unformat and unpack functions on and off */
+#define VECTOR_SIZE 64
+
+typedef struct VectorSpec
+{
+    const char* pixelType;
+    uint32_t bits;
+    uint32_t actualBits;
+    const char* justification;
+    uint32_t numBands;
+    NITF_BOOL iq;      /* Two band I/Q, read as one interleaved band */
+} VectorSpec;
+
+static NITF_BOOL readVectorImage(const VectorSpec* spec, char* data,
+                                 size_t size, int vectorize, uint8_t* out)
+{
+    const uint32_t numRead = spec->iq ? 1 : spec->numBands;
+    const size_t bandSize = VECTOR_SIZE * VECTOR_SIZE * (spec->bits / 8) *
+                            (spec->numBands / numRead);
+    nitf_Error error;
+    uint32_t bandList[4];
+    uint8_t* user[4];
+    int padded;
+    uint32_t band;
+    NITF_BOOL result;
+
+    nitf_ImageSubheader* subheader = nitf_ImageSubheader_construct(&error);
+    if (!subheader)
+        return NITF_FAILURE;
+    nitf_ImageSubheader_setBlocking(subheader, VECTOR_SIZE, VECTOR_SIZE,
+                                    VECTOR_SIZE, VECTOR_SIZE,
+                                    spec->numBands > 1 ? "P" : "B", &error);
+
+    /* The subheader takes the band array */
+    nitf_BandInfo** bands =
+        (nitf_BandInfo**)malloc(sizeof(nitf_BandInfo*) * spec->numBands);
+    if (!bands)
+        return NITF_FAILURE;
+    for (band = 0; band < spec->numBands; ++band)
+    {
+        bands[band] = nitf_BandInfo_construct(&error);
+        nitf_BandInfo_init(bands[band], "M",
+                           spec->iq ? (band == 0 ? "I" : "Q") : " ", "N",
+                           "   ", 0, 0, NULL, &error);
+        bandList[band] = band;
+        user[band] = out + band * bandSize;
+    }
+    nitf_ImageSubheader_setPixelInformation(
+        subheader, spec->pixelType, spec->bits, spec->actualBits,
+        spec->justification, spec->numBands > 1 ? "MULTI" : "MONO", "VIS",
+        spec->numBands, bands, &error);
+    nitf_ImageSubheader_setCompression(subheader, "NC", "", &error);
+
+    nitf_ImageIO* imageIO = nitf_ImageIO_construct(subheader, 0, size, NULL,
+                                                   NULL, NULL, &error);
+    nitf_IOInterface* io = nitf_BufferAdapter_construct(data, size, 0,
+                                                         &error);
+    nitf_SubWindow* subwindow = nitf_SubWindow_construct(&error);
+    if (!imageIO || !io || !subwindow)
+        return NITF_FAILURE;
+    subwindow->startRow = 0;
+    subwindow->numRows = VECTOR_SIZE;
+    subwindow->startCol = 0;
+    subwindow->numCols = VECTOR_SIZE;
+    subwindow->numBands = numRead;
+    subwindow->bandList = bandList;
+
+    nitf_ImageIO_setVectorization(imageIO, vectorize);
+    result = nitf_ImageIO_read(imageIO, io, subwindow, user, &padded,
+                               &error);
+
+    nitf_SubWindow_destruct(&subwindow);
+    nitf_IOInterface_destruct(&io);
+    nitf_ImageIO_destruct(&imageIO);
+    nitf_ImageSubheader_destruct(&subheader);
+    return result;
+}
+
+TEST_CASE(testVectorUnformat)
+{
+    const VectorSpec specs[] =
+    {
+        { "INT", 8, 8, "R", 2, 0 },
+        { "INT", 8, 8, "R", 3, 0 },
+        { "INT", 8, 8, "R", 4, 0 },
+        { "INT", 16, 16, "R", 1, 0 },
+        { "INT", 16, 12, "L", 2, 0 },
+        { "SI", 16, 12, "R", 1, 0 },
+        { "SI", 16, 12, "L", 3, 0 },
+        { "SI", 16, 16, "R", 2, 1 },
+        { "INT", 32, 32, "R", 2, 0 },
+        { "INT", 32, 20, "L", 1, 0 },
+        { "SI", 32, 24, "R", 1, 0 },
+        { "SI", 32, 24, "L", 2, 0 },
+        { "R", 32, 32, "R", 4, 0 },
+        { "R", 32, 32, "R", 2, 1 },
+        { "R", 64, 64, "R", 2, 0 },
+        { "R", 64, 64, "R", 2, 1 },
+        { "INT", 64, 40, "L", 1, 0 },
+        { "SI", 64, 40, "R", 1, 0 },
+        { "C", 64, 64, "R", 2, 0 }
+    };
+    const size_t numSpecs = sizeof(specs) / sizeof(specs[0]);
+    size_t ii, jj;
+
+    for (ii = 0; ii < numSpecs; ++ii)
+    {
+        const size_t size = (size_t)VECTOR_SIZE * VECTOR_SIZE *
+                            (specs[ii].bits / 8) * specs[ii].numBands;
+        char* data = (char*)malloc(size);
+        uint8_t* scalar = (uint8_t*)malloc(size);
+        uint8_t* vector = (uint8_t*)malloc(size);
+        TEST_ASSERT(data && scalar && vector);
+
+        /* Every byte value, so every sign and shift case is covered */
+        for (jj = 0; jj < size; ++jj)
+        {
+            data[jj] = (char)((jj * 131 + jj / 7) & 0xFF);
+        }
+        memset(scalar, 0, size);
+        memset(vector, 0xFF, size);
+
+        TEST_ASSERT(readVectorImage(&specs[ii], data, size, 0, scalar));
+        TEST_ASSERT(readVectorImage(&specs[ii], data, size, 1, vector));
+        TEST_ASSERT(memcmp(scalar, vector, size) == 0);
+
+        free(data);
+        free(scalar);
+        free(vector);
+    }
+}
+
 TEST_MAIN(
     (void)argc;
     (void)argv;
@@ -937,4 +1331,8 @@ TEST_MAIN(
     CHECK(testInvalidReadOrderFailsGracefully);
     CHECK(testPBlock4BytePixels);
     CHECK(testTwoBandRoundTrip);
+    CHECK(testReadDirect);
+    CHECK(testReadBlockMapped);
+    CHECK(testReadBatch);
+    CHECK(testVectorUnformat);
     )
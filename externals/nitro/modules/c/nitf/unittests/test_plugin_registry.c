@@ -0,0 +1,200 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ *  Lazy plugin loading.  The registry is a singleton, so these run in order
+ *  against the one registry, created with NITF_PLUGIN_LOAD_MODE=lazy.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <import/nitf.h>
+#include "Test.h"
+
+/* A handler registered for ACFTA before its plugin is loaded */
+static const char* testIdent[] = { NITF_PLUGIN_TRE_KEY, "ACFTA", NULL };
+static nitf_TREHandler testHandler;
+
+static const char** testInit(nitf_Error* error)
+{
+    (void)error;
+    return testIdent;
+}
+
+static nitf_TREHandler* testHandle(nitf_Error* error)
+{
+    (void)error;
+    return &testHandler;
+}
+
+/* Returns 1 if the plugin called name has been loaded */
+static int isLoaded(nitf_PluginRegistry* reg, const char* name)
+{
+    nitf_ListIterator iter = nitf_List_begin(reg->dsos);
+    nitf_ListIterator end = nitf_List_end(reg->dsos);
+    for (; nitf_ListIterator_notEqualTo(&iter, &end);
+         nitf_ListIterator_increment(&iter))
+    {
+        char keyName[NITF_MAX_PATH] = "";
+        nitf_DLL* dll = (nitf_DLL*)nitf_ListIterator_get(&iter);
+        nitf_Utils_baseName(keyName, dll->libname, NITF_DLL_EXTENSION);
+        if (strcmp(keyName, name) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+/* Returns 1 if the plugin called name was found but not loaded yet */
+static int isDeferred(nitf_PluginRegistry* reg, const char* name)
+{
+    nitf_ListIterator iter = nitf_List_begin(reg->deferredPlugins);
+    nitf_ListIterator end = nitf_List_end(reg->deferredPlugins);
+    for (; nitf_ListIterator_notEqualTo(&iter, &end);
+         nitf_ListIterator_increment(&iter))
+    {
+        char keyName[NITF_MAX_PATH] = "";
+        nitf_Utils_baseName(keyName,
+                            (const char*)nitf_ListIterator_get(&iter),
+                            NITF_DLL_EXTENSION);
+        if (strcmp(keyName, name) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+static nitf_TREHandler* retrieve(const char* testName,
+                                 nitf_PluginRegistry* reg,
+                                 const char* tag)
+{
+    nitf_Error error;
+    int hadError = 0;
+    nitf_TREHandler* handler =
+            nitf_PluginRegistry_retrieveTREHandler(reg, tag, &hadError, &error);
+    TEST_ASSERT_EQ_INT(hadError, 0);
+    return handler;
+}
+
+TEST_CASE(testNothingLoaded)
+{
+    nitf_Error error;
+    nitf_PluginRegistry* reg = nitf_PluginRegistry_getInstance(&error);
+    TEST_ASSERT(reg != NULL);
+    TEST_ASSERT(reg->lazyLoad);
+    TEST_ASSERT(nitf_List_isEmpty(reg->dsos));
+    TEST_ASSERT(isDeferred(reg, "ACFTA"));
+    TEST_ASSERT(isDeferred(reg, "ACFTB"));
+}
+
+TEST_CASE(testLoadsNamedPlugin)
+{
+    nitf_Error error;
+    nitf_PluginRegistry* reg = nitf_PluginRegistry_getInstance(&error);
+    size_t numStatic = 0;
+    const uint32_t numDeferred = nitf_List_size(reg->deferredPlugins);
+
+    TEST_ASSERT(retrieve(testName, reg, "ACFTB") != NULL);
+    if (nitf_PluginRegistry_getStaticTREHandlers(&numStatic))
+    {
+        /* The built-in TREs come before any plugin */
+        TEST_ASSERT(nitf_List_isEmpty(reg->dsos));
+        TEST_ASSERT(isDeferred(reg, "ACFTB"));
+    }
+    else
+    {
+        /* Only the plugin named after the tag */
+        TEST_ASSERT_EQ_INT(nitf_List_size(reg->dsos), 1);
+        TEST_ASSERT(isLoaded(reg, "ACFTB"));
+        TEST_ASSERT(!isDeferred(reg, "ACFTB"));
+        TEST_ASSERT_EQ_INT(nitf_List_size(reg->deferredPlugins),
+                           numDeferred - 1);
+    }
+}
+
+TEST_CASE(testRegisteredHandler)
+{
+    nitf_Error error;
+    nitf_PluginRegistry* reg = nitf_PluginRegistry_getInstance(&error);
+    TEST_ASSERT(isDeferred(reg, "ACFTA"));
+    TEST_ASSERT(nitf_PluginRegistry_registerTREHandler(testInit, testHandle,
+                                                       &error));
+    TEST_ASSERT(retrieve(testName, reg, "ACFTA") == &testHandler);
+    TEST_ASSERT(!isLoaded(reg, "ACFTA"));
+}
+
+TEST_CASE(testStaticTREHandlers)
+{
+    nitf_Error error;
+    nitf_PluginRegistry* reg = nitf_PluginRegistry_getInstance(&error);
+    size_t numStatic = 0;
+    size_t i;
+    const nitf_StaticTREHandler* handlers =
+            nitf_PluginRegistry_getStaticTREHandlers(&numStatic);
+    if (!handlers)
+    {
+        /* Built without ENABLE_STATIC_TRE_REGISTRY */
+        TEST_ASSERT_EQ_INT(numStatic, 0);
+        return;
+    }
+
+    /* Sorted for bsearch() */
+    TEST_ASSERT(numStatic > 0);
+    for (i = 1; i < numStatic; ++i)
+    {
+        TEST_ASSERT(strcmp(handlers[i - 1].name, handlers[i].name) < 0);
+    }
+
+    /* Found without loading its plugin */
+    TEST_ASSERT(retrieve(testName, reg, "BANDSB") != NULL);
+    TEST_ASSERT(!isLoaded(reg, "BANDSB"));
+    TEST_ASSERT(isDeferred(reg, "BANDSB"));
+}
+
+TEST_CASE(testFallbackLoadsAll)
+{
+    nitf_Error error;
+    nitf_PluginRegistry* reg = nitf_PluginRegistry_getInstance(&error);
+
+    /* No plugin is named after it, so every plugin is tried */
+    TEST_ASSERT_NULL(retrieve(testName, reg, "NO_SUCH_TRE"));
+    TEST_ASSERT(nitf_List_isEmpty(reg->deferredPlugins));
+    TEST_ASSERT(isLoaded(reg, "ACFTA"));
+    TEST_ASSERT(isLoaded(reg, "ACFTB"));
+
+    /* Loading ACFTA's plugin didn't replace the handler registered first */
+    TEST_ASSERT(retrieve(testName, reg, "ACFTA") == &testHandler);
+}
+
+TEST_MAIN(
+    static char loadMode[] = NITF_PLUGIN_LOAD_MODE "=lazy";
+    (void) argc;
+    (void) argv;
+
+    /* Before anything creates the registry */
+    putenv(loadMode);
+
+    CHECK(testNothingLoaded);
+    CHECK(testLoadsNamedPlugin);
+    CHECK(testRegisteredHandler);
+    CHECK(testStaticTREHandlers);
+    CHECK(testFallbackLoadsAll);
+    )
@@ -0,0 +1,382 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include <import/nitf.h>
+#include "Test.h"
+
+/* A field to set before taking a TRE's raw data */
+typedef struct
+{
+    const char* tag;
+    const char* value;
+    size_t length;
+} FieldValue;
+
+/* An empty TRE with the same handler and description as from */
+static nitf_TRE* makeEmptyTRE(nitf_TRE* from, uint32_t length)
+{
+    nitf_Error error;
+    nitf_TREPrivateData* priv;
+    nitf_TRE* tre = nitf_TRE_createSkeleton(from->tag, &error);
+    if (!tre)
+        return NULL;
+
+    tre->handler = from->handler;
+    priv = nitf_TREPrivateData_construct(&error);
+    if (!priv)
+    {
+        nitf_TRE_destruct(&tre);
+        return NULL;
+    }
+    priv->length = length;
+    priv->description = ((nitf_TREPrivateData*)from->priv)->description;
+    tre->priv = priv;
+    return tre;
+}
+
+/* Returns 1 if both TREs hold the same fields, keys and hash order */
+static int sameFields(nitf_TRE* a, nitf_TRE* b)
+{
+    nitf_HashTable* hashA = ((nitf_TREPrivateData*)a->priv)->hash;
+    nitf_HashTable* hashB = ((nitf_TREPrivateData*)b->priv)->hash;
+    int i;
+
+    if (hashA->nbuckets != hashB->nbuckets)
+        return 0;
+    for (i = 0; i < hashA->nbuckets; i++)
+    {
+        nitf_ListIterator iterA = nitf_List_begin(hashA->buckets[i]);
+        nitf_ListIterator endA = nitf_List_end(hashA->buckets[i]);
+        nitf_ListIterator iterB = nitf_List_begin(hashB->buckets[i]);
+        nitf_ListIterator endB = nitf_List_end(hashB->buckets[i]);
+
+        while (nitf_ListIterator_notEqualTo(&iterA, &endA) &&
+               nitf_ListIterator_notEqualTo(&iterB, &endB))
+        {
+            nitf_Pair* pairA = (nitf_Pair*)nitf_ListIterator_get(&iterA);
+            nitf_Pair* pairB = (nitf_Pair*)nitf_ListIterator_get(&iterB);
+            nitf_Field* fieldA = (nitf_Field*)pairA->data;
+            nitf_Field* fieldB = (nitf_Field*)pairB->data;
+
+            if (strcmp(pairA->key, pairB->key) != 0 ||
+                fieldA->type != fieldB->type ||
+                fieldA->length != fieldB->length ||
+                memcmp(fieldA->raw, fieldB->raw, fieldA->length) != 0)
+                return 0;
+
+            nitf_ListIterator_increment(&iterA);
+            nitf_ListIterator_increment(&iterB);
+        }
+        if (nitf_ListIterator_notEqualTo(&iterA, &endA) ||
+            nitf_ListIterator_notEqualTo(&iterB, &endB))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ *  Parses the first length bytes of data with nitf_TREUtils_parse() and
+ *  with the compiled parser, and checks they agree.  The cursor reads past
+ *  the end of short data, so the rest of the buffer is zeroed for it.
+ */
+static void compareParsers(const char* testName,
+                           nitf_TRE* tre,
+                           const char* data,
+                           uint32_t length,
+                           uint32_t bufferLength)
+{
+    nitf_Error interpreterError;
+    nitf_Error compiledError;
+    nitf_TRE* interpreted = NULL;
+    nitf_TRE* compiled = NULL;
+    int interpreterOK;
+    int compiledOK;
+    const nitf_TREParser* parser = nitf_TREParser_get(
+            ((nitf_TREPrivateData*)tre->priv)->description);
+    char* buffer = (char*)NITF_MALLOC(bufferLength);
+    TEST_ASSERT(parser != NULL);
+    TEST_ASSERT(buffer != NULL);
+    memset(buffer, 0, bufferLength);
+    memcpy(buffer, data, length);
+
+    interpreted = makeEmptyTRE(tre, length);
+    compiled = makeEmptyTRE(tre, length);
+    TEST_ASSERT(interpreted != NULL);
+    TEST_ASSERT(compiled != NULL);
+
+    memset(&interpreterError, 0, sizeof(interpreterError));
+    memset(&compiledError, 0, sizeof(compiledError));
+    interpreterOK = nitf_TREUtils_parse(interpreted, buffer, &interpreterError);
+    compiledOK = nitf_TREParser_parse(parser, compiled, buffer, &compiledError);
+
+    TEST_ASSERT_EQ_INT(compiledOK, interpreterOK);
+    if (!interpreterOK)
+    {
+        TEST_ASSERT_EQ_STR(compiledError.message, interpreterError.message);
+    }
+    TEST_ASSERT(sameFields(interpreted, compiled));
+
+    nitf_TRE_destruct(&interpreted);
+    nitf_TRE_destruct(&compiled);
+    NITF_FREE(buffer);
+}
+
+/*
+ *  Constructs the TRE and walks its description, setting each field to its
+ *  value in fields, or else to zeros (or blanks for BCS-A)
+ */
+static nitf_TRE* populateTRE(const char* testName,
+                             const char* tag,
+                             const FieldValue* fields)
+{
+    nitf_Error error;
+    nitf_TRECursor cursor;
+    char blank[256];
+    nitf_TRE* tre = nitf_TRE_construct(tag, NULL, &error);
+    TEST_ASSERT(tre != NULL);
+
+    cursor = nitf_TRECursor_begin(tre);
+    while (!nitf_TRECursor_isDone(&cursor))
+    {
+        const char* value = blank;
+        size_t length;
+        size_t i;
+
+        TEST_ASSERT(nitf_TRECursor_iterate(&cursor, &error) != 0);
+        length = (size_t)cursor.length;
+        TEST_ASSERT(length <= sizeof(blank));
+        memset(blank, cursor.desc_ptr->data_type == NITF_BCS_A ? ' ' :
+                      cursor.desc_ptr->data_type == NITF_BCS_N ? '0' : 0,
+               length);
+        for (i = 0; fields[i].tag; i++)
+        {
+            if (strcmp(cursor.tag_str, fields[i].tag) == 0)
+            {
+                value = fields[i].value;
+                length = fields[i].length;
+            }
+        }
+        TEST_ASSERT(nitf_TRE_setField(tre, cursor.tag_str, (NITF_DATA*)value,
+                                      length, &error));
+    }
+    nitf_TRECursor_cleanup(&cursor);
+    return tre;
+}
+
+/*
+ *  Compares the parsers on the TRE's data, on that data cut short, and on
+ *  a run of digits as long as it
+ */
+static void compareTRE(const char* testName,
+                       const char* tag,
+                       const FieldValue* fields)
+{
+    nitf_Error error;
+    nitf_TRE* tre = populateTRE(testName, tag, fields);
+    char* raw;
+    char* digits;
+    uint32_t length = 0;
+    uint32_t bufferLength;
+
+    raw = nitf_TREUtils_getRawData(tre, &length, &error);
+    TEST_ASSERT(raw != NULL);
+    TEST_ASSERT(length > 0);
+
+    /* Room for the cursor to read past short data */
+    bufferLength = length + 4096;
+    compareParsers(testName, tre, raw, length, bufferLength);
+    compareParsers(testName, tre, raw, length / 2, bufferLength);
+    compareParsers(testName, tre, raw, length - 1, bufferLength);
+
+    /* Every count and mask is large, so this runs out of data */
+    digits = (char*)NITF_MALLOC(length);
+    TEST_ASSERT(digits != NULL);
+    memset(digits, '1', length);
+    compareParsers(testName, tre, digits, length, bufferLength);
+
+    NITF_FREE(digits);
+    NITF_FREE(raw);
+    nitf_TRE_destruct(&tre);
+}
+
+TEST_CASE(testParseBANDSB)
+{
+    /*
+     *  The same mask byte either way round turns on some cube level fields
+     *  and several per band groups, including the bad band flags and NIIRS
+     */
+    const FieldValue fields[] = { { "EXISTENCE_MASK", "\x0c\x0c\x0c\x0c", 4 },
+                                  { "COUNT", "00002", 5 },
+                                  { "BAD_BAND[0]", "0", 1 },
+                                  { "NIIRS[0]", "045", 3 },
+                                  { "BAD_BAND[1]", "1", 1 },
+                                  { "NIIRS[1]", "030", 3 },
+                                  { NULL, NULL, 0 } };
+    compareTRE(testName, "BANDSB", fields);
+}
+
+TEST_CASE(testParseSENSRB)
+{
+    /*
+     *  Some optional groups, a variable number of transform parameters,
+     *  point sets, time stamps, uncertainties and a parameter whose length
+     *  is another field
+     */
+    const FieldValue fields[] = { { "GENERAL_DATA", "Y", 1 },
+                                  { "TRANSFORM_PARAMS", "3", 1 },
+                                  { "ATTITUDE_QUATERNION", "Y", 1 },
+                                  { "POINT_SET_DATA", "02", 2 },
+                                  { "POINT_COUNT[0]", "002", 3 },
+                                  { "POINT_COUNT[1]", "001", 3 },
+                                  { "TIME_STAMPED_DATA_SETS", "01", 2 },
+                                  { "TIME_STAMP_TYPE[0]", "06a", 3 },
+                                  { "TIME_STAMP_COUNT[0]", "0002", 4 },
+                                  { "UNCERTAINTY_DATA", "002", 3 },
+                                  { "ADDITIONAL_PARAMETER_DATA", "001", 3 },
+                                  { "PARAMETER_SIZE[0]", "005", 3 },
+                                  { "PARAMETER_COUNT[0]", "0002", 4 },
+                                  { NULL, NULL, 0 } };
+    compareTRE(testName, "SENSRB", fields);
+}
+
+TEST_CASE(testParseRSMPCA)
+{
+    /* Rational polynomials with a few terms each */
+    const FieldValue fields[] = { { "RNTRMS", "004", 3 },
+                                  { "RDTRMS", "002", 3 },
+                                  { "CNTRMS", "003", 3 },
+                                  { "CDTRMS", "001", 3 },
+                                  { NULL, NULL, 0 } };
+    compareTRE(testName, "RSMPCA", fields);
+}
+
+TEST_CASE(testClearCache)
+{
+    /* The parsers are rebuilt after the cache is cleared */
+    const FieldValue fields[] = { { "RNTRMS", "002", 3 },
+                                  { NULL, NULL, 0 } };
+    nitf_TREParser_clearCache();
+    compareTRE(testName, "RSMPCA", fields);
+    nitf_TREParser_clearCache();
+    compareTRE(testName, "RSMPCA", fields);
+}
+
+/* A one field description on the heap */
+static nitf_TREDescription* makeDescription(const char* tag, int length)
+{
+    nitf_TREDescription* description = (nitf_TREDescription*)NITF_MALLOC(
+            sizeof(nitf_TREDescription) * 2);
+    if (!description)
+        return NULL;
+    description[0].data_type = NITF_BCS_A;
+    description[0].data_count = length;
+    description[0].label = "Field";
+    description[0].tag = tag;
+    description[0].special = NULL;
+    description[1].data_type = NITF_END;
+    description[1].data_count = 0;
+    description[1].label = NULL;
+    description[1].tag = NULL;
+    description[1].special = NULL;
+    return description;
+}
+
+TEST_CASE(testEvict)
+{
+    /*
+     *  Each description is freed once it's evicted, so the next is likely
+     *  to be allocated at the same address.  It has to get its own parser.
+     */
+    const char* tags[] = { "FIRST", "SECOND", "THIRD" };
+    const int lengths[] = { 2, 3, 4 };
+    char data[] = "1234";
+    nitf_TREDescription* kept = makeDescription("KEPT", 1);
+    const nitf_TREParser* keptParser;
+    int i;
+
+    TEST_ASSERT(kept != NULL);
+    keptParser = nitf_TREParser_get(kept);
+    TEST_ASSERT(keptParser != NULL);
+
+    for (i = 0; i < 3; i++)
+    {
+        nitf_Error error;
+        nitf_TREDescriptionInfo infos[2];
+        nitf_TREDescriptionSet set;
+        nitf_TREHandler handler;
+        nitf_TREPrivateData* priv;
+        nitf_Field* field;
+        const nitf_TREParser* parser;
+        nitf_TREDescription* description =
+                makeDescription(tags[i], lengths[i]);
+        nitf_TRE* tre = nitf_TRE_createSkeleton("TEST", &error);
+        TEST_ASSERT(description != NULL);
+        TEST_ASSERT(tre != NULL);
+
+        infos[0].name = "TEST";
+        infos[0].description = description;
+        infos[0].lengthMatch = NITF_TRE_DESC_NO_LENGTH;
+        infos[1].name = NULL;
+        infos[1].description = NULL;
+        infos[1].lengthMatch = NITF_TRE_DESC_NO_LENGTH;
+        set.defaultIndex = 0;
+        set.descriptions = infos;
+        TEST_ASSERT(nitf_TREUtils_createBasicHandler(&set, &handler, &error));
+        tre->handler = &handler;
+
+        priv = nitf_TREPrivateData_construct(&error);
+        TEST_ASSERT(priv != NULL);
+        priv->length = (uint32_t)lengths[i];
+        priv->description = description;
+        tre->priv = priv;
+
+        parser = nitf_TREParser_get(description);
+        TEST_ASSERT(parser != NULL);
+        TEST_ASSERT(nitf_TREParser_parse(parser, tre, data, &error));
+        field = (nitf_Field*)nitf_TRE_getField(tre, tags[i]);
+        TEST_ASSERT(field != NULL);
+        TEST_ASSERT_EQ_INT(field->length, lengths[i]);
+
+        nitf_TRE_destruct(&tre);
+
+        nitf_TREParser_evict(description);
+        NITF_FREE(description);
+    }
+
+    /* Evicting the others didn't lose it */
+    TEST_ASSERT(nitf_TREParser_get(kept) == keptParser);
+    nitf_TREParser_evict(kept);
+    NITF_FREE(kept);
+}
+
+TEST_MAIN(
+    (void) argc;
+    (void) argv;
+
+    CHECK(testParseBANDSB);
+    CHECK(testParseSENSRB);
+    CHECK(testParseRSMPCA);
+    CHECK(testClearCache);
+    CHECK(testEvict);
+    )
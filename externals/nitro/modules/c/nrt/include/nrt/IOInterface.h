@@ -40,6 +40,19 @@ typedef int (*NRT_IO_INTERFACE_GET_MODE) (NRT_DATA *, nrt_Error *);
 typedef NRT_BOOL(*NRT_IO_INTERFACE_CLOSE) (NRT_DATA *, nrt_Error *);
 typedef void (*NRT_IO_INTERFACE_DESTRUCT) (NRT_DATA *);
 
+/**
+ * One read in a batch: 'size' bytes at 'offset' into 'buf'
+ */
+typedef struct _NRT_IORequest
+{
+    nrt_Off offset;
+    void *buf;
+    size_t size;
+} nrt_IORequest;
+
+typedef NRT_BOOL(*NRT_IO_INTERFACE_READ_BATCH) (NRT_DATA *, nrt_IORequest *,
+                                                size_t, nrt_Error *);
+
 typedef struct _NRT_IIOInterface
 {
     NRT_IO_INTERFACE_READ read;
@@ -51,6 +64,9 @@ typedef struct _NRT_IIOInterface
     NRT_IO_INTERFACE_GET_MODE getMode;
     NRT_IO_INTERFACE_CLOSE close;
     NRT_IO_INTERFACE_DESTRUCT destruct;
+
+    /* Optional; NULL if the requests can only be read one at a time */
+    NRT_IO_INTERFACE_READ_BATCH readBatch;
 } nrt_IIOInterface;
 
 typedef struct _NRT_IOInterface
@@ -65,6 +81,16 @@ typedef struct _NRT_IOInterface
 NRTAPI(NRT_BOOL) nrt_IOInterface_read(nrt_IOInterface *, void* buf, size_t size,
                                       nrt_Error * error);
 
+/**
+ * Reads each of 'count' requests.  Interfaces that can have several reads
+ * in flight at once complete them in any order; the others seek and read
+ * each in turn.  The current offset is unspecified afterwards.
+ */
+NRTAPI(NRT_BOOL) nrt_IOInterface_readBatch(nrt_IOInterface * io,
+                                           nrt_IORequest * requests,
+                                           size_t count,
+                                           nrt_Error * error);
+
 /**
  * Writes data to the interface
  */
@@ -131,5 +157,70 @@ NRTAPI(nrt_IOInterface *) nrt_BufferAdapter_construct(const char *buf, size_t si
                                                       NRT_BOOL ownBuf,
                                                       nrt_Error * error);
 
+/**
+ * Access hints for a memory mapped IOInterface.  They only affect
+ * performance, and are ignored where the OS has no equivalent.
+ */
+typedef enum _nrt_MMapAdvice
+{
+    NRT_MMAP_NORMAL = 0,    /* No particular access pattern */
+    NRT_MMAP_SEQUENTIAL,    /* Read ahead aggressively, drop pages once read */
+    NRT_MMAP_RANDOM,        /* Don't read ahead */
+    NRT_MMAP_WILLNEED       /* Start reading the range in now */
+} nrt_MMapAdvice;
+
+/**
+ * Creates a read-only IOInterface that memory maps the whole file.  Reads
+ * are copies out of the mapping, so there are no system calls after the
+ * open, and nrt_MMapAdapter_getData() gives direct access to the file's
+ * contents.
+ */
+NRTAPI(nrt_IOInterface *) nrt_MMapAdapter_open(const char *fname,
+                                               nrt_Error * error);
+
+/**
+ * Returns true if the interface was created by nrt_MMapAdapter_open() and
+ * hasn't been closed
+ */
+NRTAPI(NRT_BOOL) nrt_MMapAdapter_isMapped(nrt_IOInterface * io);
+
+/**
+ * Returns a pointer to 'size' bytes at 'offset' in the mapped file.  The
+ * pointer is valid until the interface is closed.  This doesn't move the
+ * interface's file position, so it's safe to call from multiple threads.
+ *
+ * Returns NULL and sets the error if the interface isn't mapped or the
+ * range is past the end of the file.
+ */
+NRTAPI(const void *) nrt_MMapAdapter_getData(nrt_IOInterface * io,
+                                             nrt_Off offset,
+                                             size_t size,
+                                             nrt_Error * error);
+
+/**
+ * Tells the OS how 'size' bytes at 'offset' in the mapped file will be
+ * accessed.  A size of 0 means through the end of the file.
+ */
+NRTAPI(NRT_BOOL) nrt_MMapAdapter_advise(nrt_IOInterface * io,
+                                        nrt_Off offset,
+                                        size_t size,
+                                        nrt_MMapAdvice advice,
+                                        nrt_Error * error);
+
+/**
+ * Creates a read-only IOInterface for reading many blocks of a file at once.
+ * Batch reads are positional reads (no seek), issued concurrently by
+ * 'numThreads' worker threads so that the storage has many requests
+ * queued; each finishes whenever its data arrives.  A 'numThreads' of 0
+ * uses NRT_ASYNC_IO_DEFAULT_THREADS.
+ *
+ * Where positional reads aren't available (Windows) this is an
+ * IOHandleAdapter, which reads a batch one request at a time.
+ */
+#define NRT_ASYNC_IO_DEFAULT_THREADS 8
+NRTAPI(nrt_IOInterface *) nrt_AsyncIOAdapter_open(const char *fname,
+                                                  uint32_t numThreads,
+                                                  nrt_Error * error);
+
 NRT_CXX_ENDGUARD
 #endif
@@ -0,0 +1,492 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2016, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "nrt/IOInterface.h"
+
+#if defined(WIN32) || defined(_WIN32)
+
+NRTAPI(nrt_IOInterface *) nrt_AsyncIOAdapter_open(const char *fname,
+                                                  uint32_t numThreads,
+                                                  nrt_Error * error)
+{
+    /* No pread(); batches are read a request at a time */
+    (void)numThreads;
+    return nrt_IOHandleAdapter_open(fname, NRT_ACCESS_READONLY,
+                                    NRT_OPEN_EXISTING, error);
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NRT_CXX_GUARD
+
+/*
+ * The worker threads wait for a batch, then each claims the next unread
+ * request until there are none left.  The thread that submitted the batch
+ * works on it too, then waits for the requests still being read.
+ */
+typedef struct _AsyncIOControl
+{
+    int fd;
+    nrt_Off size;
+    nrt_Off mark;
+
+    pthread_t *threads;
+    uint32_t numThreads;        /* Number of threads started */
+    pthread_mutex_t lock;
+    pthread_cond_t batchReady;
+    pthread_cond_t batchDone;
+    NRT_BOOL haveSync;          /* The lock and conditions are initialized */
+    NRT_BOOL shutdown;
+
+    /* The batch being read; everything below is guarded by the lock */
+    nrt_IORequest *requests;
+    size_t count;
+    size_t next;                /* Next request to claim */
+    size_t pending;             /* Requests not yet finished */
+    int errnum;                 /* First error; -1 for end of file */
+} AsyncIOControl;
+
+/* Returns 0, an errno value, or -1 if the file ends first */
+NRTPRIV(int) AsyncIOAdapter_readAt(int fd, nrt_Off offset, char *buf,
+                                   size_t size)
+{
+    while (size > 0)
+    {
+        const ssize_t bytes = pread(fd, buf, size, (off_t) offset);
+        if (bytes < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno;
+        }
+        if (bytes == 0)
+        {
+            return -1;
+        }
+        buf += bytes;
+        offset += bytes;
+        size -= (size_t) bytes;
+    }
+    return 0;
+}
+
+/* Read requests from the current batch until there are none to claim */
+NRTPRIV(void) AsyncIOAdapter_work(AsyncIOControl * control)
+{
+    while (control->next < control->count)
+    {
+        const nrt_IORequest *request = &control->requests[control->next++];
+        int result;
+
+        pthread_mutex_unlock(&control->lock);
+        result = AsyncIOAdapter_readAt(control->fd, request->offset,
+                                       (char *) request->buf, request->size);
+        pthread_mutex_lock(&control->lock);
+
+        if (result != 0 && control->errnum == 0)
+        {
+            control->errnum = result;
+        }
+        if (--control->pending == 0)
+        {
+            pthread_cond_signal(&control->batchDone);
+        }
+    }
+}
+
+NRTPRIV(void *) AsyncIOAdapter_worker(void *arg)
+{
+    AsyncIOControl *control = (AsyncIOControl *) arg;
+
+    pthread_mutex_lock(&control->lock);
+    while (!control->shutdown)
+    {
+        if (control->next < control->count)
+        {
+            AsyncIOAdapter_work(control);
+        }
+        else
+        {
+            pthread_cond_wait(&control->batchReady, &control->lock);
+        }
+    }
+    pthread_mutex_unlock(&control->lock);
+    return NULL;
+}
+
+NRTPRIV(void) AsyncIOAdapter_stop(AsyncIOControl * control)
+{
+    uint32_t ii;
+
+    if (control->numThreads > 0)
+    {
+        pthread_mutex_lock(&control->lock);
+        control->shutdown = NRT_TRUE;
+        pthread_cond_broadcast(&control->batchReady);
+        pthread_mutex_unlock(&control->lock);
+
+        for (ii = 0; ii < control->numThreads; ++ii)
+        {
+            pthread_join(control->threads[ii], NULL);
+        }
+        control->numThreads = 0;
+    }
+    if (control->threads)
+    {
+        NRT_FREE(control->threads);
+        control->threads = NULL;
+    }
+    if (control->fd >= 0)
+    {
+        close(control->fd);
+        control->fd = -1;
+    }
+}
+
+NRTPRIV(NRT_BOOL) AsyncIOAdapter_start(AsyncIOControl * control,
+                                       uint32_t numThreads,
+                                       nrt_Error * error)
+{
+    int result;
+
+    if (pthread_mutex_init(&control->lock, NULL) != 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        return NRT_FAILURE;
+    }
+    if (pthread_cond_init(&control->batchReady, NULL) != 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        pthread_mutex_destroy(&control->lock);
+        return NRT_FAILURE;
+    }
+    if (pthread_cond_init(&control->batchDone, NULL) != 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        pthread_cond_destroy(&control->batchReady);
+        pthread_mutex_destroy(&control->lock);
+        return NRT_FAILURE;
+    }
+    control->haveSync = NRT_TRUE;
+
+    control->threads =
+        (pthread_t *) NRT_MALLOC(sizeof(pthread_t) * numThreads);
+    if (!control->threads)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        return NRT_FAILURE;
+    }
+    while (control->numThreads < numThreads)
+    {
+        result = pthread_create(&control->threads[control->numThreads], NULL,
+                                &AsyncIOAdapter_worker, control);
+        if (result != 0)
+        {
+            nrt_Error_init(error, NRT_STRERROR(result), NRT_CTXT,
+                           NRT_ERR_MEMORY);
+            return NRT_FAILURE;
+        }
+        ++control->numThreads;
+    }
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(NRT_BOOL) AsyncIOAdapter_readBatch(NRT_DATA * data,
+                                           nrt_IORequest * requests,
+                                           size_t count, nrt_Error * error)
+{
+    AsyncIOControl *control = (AsyncIOControl *) data;
+    int errnum;
+
+    if (control->fd < 0)
+    {
+        nrt_Error_init(error, "File is closed", NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    if (count == 0)
+    {
+        return NRT_SUCCESS;
+    }
+
+    pthread_mutex_lock(&control->lock);
+    control->requests = requests;
+    control->count = count;
+    control->next = 0;
+    control->pending = count;
+    control->errnum = 0;
+    pthread_cond_broadcast(&control->batchReady);
+
+    AsyncIOAdapter_work(control);
+    while (control->pending > 0)
+    {
+        pthread_cond_wait(&control->batchDone, &control->lock);
+    }
+
+    errnum = control->errnum;
+    control->requests = NULL;
+    control->count = 0;
+    control->next = 0;
+    pthread_mutex_unlock(&control->lock);
+
+    if (errnum == -1)
+    {
+        nrt_Error_init(error, "Invalid size requested - EOF", NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    if (errnum != 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(errnum), NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(NRT_BOOL) AsyncIOAdapter_read(NRT_DATA * data, void *buf, size_t size,
+                                      nrt_Error * error)
+{
+    AsyncIOControl *control = (AsyncIOControl *) data;
+    int result;
+
+    if (control->fd < 0)
+    {
+        nrt_Error_init(error, "File is closed", NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+
+    /* One request isn't worth handing to a worker */
+    result = AsyncIOAdapter_readAt(control->fd, control->mark, (char *) buf,
+                                   size);
+    if (result == -1)
+    {
+        nrt_Error_init(error, "Invalid size requested - EOF", NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    if (result != 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(result), NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+    control->mark += (nrt_Off) size;
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(NRT_BOOL) AsyncIOAdapter_write(NRT_DATA * data, const void *buf,
+                                       size_t size, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)data;
+    (void)buf;
+    (void)size;
+
+    nrt_Error_init(error, "Asynchronous I/O files are read-only", NRT_CTXT,
+                   NRT_ERR_WRITING_TO_FILE);
+    return NRT_FAILURE;
+}
+
+NRTPRIV(NRT_BOOL) AsyncIOAdapter_canSeek(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)data;
+    (void)error;
+
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(nrt_Off) AsyncIOAdapter_seek(NRT_DATA * data, nrt_Off offset,
+                                     int whence, nrt_Error * error)
+{
+    AsyncIOControl *control = (AsyncIOControl *) data;
+    nrt_Off mark;
+
+    if (whence == NRT_SEEK_SET)
+    {
+        mark = offset;
+    }
+    else if (whence == NRT_SEEK_CUR)
+    {
+        mark = control->mark + offset;
+    }
+    else if (whence == NRT_SEEK_END)
+    {
+        mark = control->size + offset;
+    }
+    else
+    {
+        nrt_Error_init(error, "Invalid/unsupported seek directive", NRT_CTXT,
+                       NRT_ERR_SEEKING_IN_FILE);
+        return -1;
+    }
+
+    if (mark < 0)
+    {
+        nrt_Error_init(error, "Attempt to seek before the start of the file",
+                       NRT_CTXT, NRT_ERR_SEEKING_IN_FILE);
+        return -1;
+    }
+    control->mark = mark;
+    return mark;
+}
+
+NRTPRIV(nrt_Off) AsyncIOAdapter_tell(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    return ((AsyncIOControl *) data)->mark;
+}
+
+NRTPRIV(nrt_Off) AsyncIOAdapter_getSize(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    return ((AsyncIOControl *) data)->size;
+}
+
+NRTPRIV(int) AsyncIOAdapter_getMode(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)data;
+    (void)error;
+
+    return NRT_ACCESS_READONLY;
+}
+
+NRTPRIV(NRT_BOOL) AsyncIOAdapter_close(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    AsyncIOAdapter_stop((AsyncIOControl *) data);
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(void) AsyncIOAdapter_destruct(NRT_DATA * data)
+{
+    AsyncIOControl *control = (AsyncIOControl *) data;
+
+    if (control)
+    {
+        AsyncIOAdapter_stop(control);
+        if (control->haveSync)
+        {
+            pthread_cond_destroy(&control->batchDone);
+            pthread_cond_destroy(&control->batchReady);
+            pthread_mutex_destroy(&control->lock);
+            control->haveSync = NRT_FALSE;
+        }
+    }
+}
+
+NRTAPI(nrt_IOInterface *) nrt_AsyncIOAdapter_open(const char *fname,
+                                                  uint32_t numThreads,
+                                                  nrt_Error * error)
+{
+    static nrt_IIOInterface asyncInterface = {
+        &AsyncIOAdapter_read,
+        &AsyncIOAdapter_write,
+        &AsyncIOAdapter_canSeek,
+        &AsyncIOAdapter_seek,
+        &AsyncIOAdapter_tell,
+        &AsyncIOAdapter_getSize,
+        &AsyncIOAdapter_getMode,
+        &AsyncIOAdapter_close,
+        &AsyncIOAdapter_destruct,
+        &AsyncIOAdapter_readBatch
+    };
+    nrt_IOInterface *impl = NULL;
+    AsyncIOControl *control = NULL;
+    struct stat info;
+
+    impl = (nrt_IOInterface *) NRT_MALLOC(sizeof(nrt_IOInterface));
+    if (!impl)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        goto CATCH_ERROR;
+    }
+    memset(impl, 0, sizeof(nrt_IOInterface));
+
+    control = (AsyncIOControl *) NRT_MALLOC(sizeof(AsyncIOControl));
+    if (!control)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        goto CATCH_ERROR;
+    }
+    memset(control, 0, sizeof(AsyncIOControl));
+    control->fd = -1;
+    impl->data = (NRT_DATA *) control;
+    impl->iface = &asyncInterface;
+
+    control->fd = open(fname, O_RDONLY);
+    if (control->fd < 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_OPENING_FILE);
+        goto CATCH_ERROR;
+    }
+    if (fstat(control->fd, &info) != 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_STAT_FILE);
+        goto CATCH_ERROR;
+    }
+    control->size = (nrt_Off) info.st_size;
+
+    if (!AsyncIOAdapter_start(control, numThreads > 0 ? numThreads :
+                              NRT_ASYNC_IO_DEFAULT_THREADS, error))
+    {
+        goto CATCH_ERROR;
+    }
+    return impl;
+
+    CATCH_ERROR:
+    {
+        if (impl)
+            nrt_IOInterface_destruct(&impl);
+        return NULL;
+    }
+}
+
+NRT_CXX_ENDGUARD
+
+#endif
@@ -45,6 +45,34 @@ NRTAPI(NRT_BOOL) nrt_IOInterface_read(nrt_IOInterface * io, void* buf,
     return io->iface->read(io->data, buf, size, error);
 }
 
+NRTAPI(NRT_BOOL) nrt_IOInterface_readBatch(nrt_IOInterface * io,
+                                           nrt_IORequest * requests,
+                                           size_t count,
+                                           nrt_Error * error)
+{
+    size_t ii;
+
+    if (io->iface->readBatch != NULL)
+    {
+        return io->iface->readBatch(io->data, requests, count, error);
+    }
+
+    for (ii = 0; ii < count; ++ii)
+    {
+        if (!NRT_IO_SUCCESS(nrt_IOInterface_seek(io, requests[ii].offset,
+                                                 NRT_SEEK_SET, error)))
+        {
+            return NRT_FAILURE;
+        }
+        if (!nrt_IOInterface_read(io, requests[ii].buf, requests[ii].size,
+                                  error))
+        {
+            return NRT_FAILURE;
+        }
+    }
+    return NRT_SUCCESS;
+}
+
 NRTAPI(NRT_BOOL) nrt_IOInterface_write(nrt_IOInterface * io, const void* buf,
                                        size_t size, nrt_Error * error)
 {
@@ -324,7 +352,8 @@ NRTAPI(nrt_IOInterface *) nrt_IOHandleAdapter_construct(nrt_IOHandle handle,
         &IOHandleAdapter_getSize,
         &IOHandleAdapter_getMode,
         &IOHandleAdapter_close,
-        &IOHandleAdapter_destruct
+        &IOHandleAdapter_destruct,
+        NULL
     };
     nrt_IOInterface *impl = NULL;
     IOHandleControl *control = NULL;
@@ -398,7 +427,8 @@ NRTAPI(nrt_IOInterface *) nrt_BufferAdapter_construct(const char *buf, size_t si
         &BufferAdapter_getSize,
         &BufferAdapter_getMode,
         &BufferAdapter_close,
-        &BufferAdapter_destruct
+        &BufferAdapter_destruct,
+        NULL
     };
     nrt_IOInterface *impl = NULL;
     BufferIOControl *control = NULL;
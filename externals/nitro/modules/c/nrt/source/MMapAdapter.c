@@ -0,0 +1,465 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2016, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "nrt/IOInterface.h"
+
+#if defined(WIN32) || defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+NRT_CXX_GUARD
+
+typedef struct _MMapControl
+{
+    char *data;     /* Start of the mapping; NULL if the file is empty */
+    size_t size;
+    size_t mark;
+    NRT_BOOL isOpen;
+} MMapControl;
+
+NRTPRIV(NRT_BOOL) MMapAdapter_map(MMapControl * control, const char *fname,
+                                  nrt_Error * error)
+{
+#if defined(WIN32) || defined(_WIN32)
+    LARGE_INTEGER fileSize;
+    HANDLE mapping;
+    HANDLE handle = CreateFile(fname, GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_OPENING_FILE);
+        return NRT_FAILURE;
+    }
+    if (!GetFileSizeEx(handle, &fileSize))
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_STAT_FILE);
+        CloseHandle(handle);
+        return NRT_FAILURE;
+    }
+    if ((unsigned long long) fileSize.QuadPart > (size_t) -1)
+    {
+        nrt_Error_init(error, "File is too large to map", NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        CloseHandle(handle);
+        return NRT_FAILURE;
+    }
+    control->size = (size_t) fileSize.QuadPart;
+
+    /* Windows can't map an empty file */
+    if (control->size > 0)
+    {
+        mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL)
+        {
+            control->data = (char *) MapViewOfFile(mapping, FILE_MAP_READ,
+                                                   0, 0, 0);
+            /* The view keeps the mapping open */
+            CloseHandle(mapping);
+        }
+        if (control->data == NULL)
+        {
+            nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                           NRT_ERR_MEMORY);
+            CloseHandle(handle);
+            return NRT_FAILURE;
+        }
+    }
+    CloseHandle(handle);
+    return NRT_SUCCESS;
+#else
+    struct stat info;
+    void *data;
+    const int fd = open(fname, O_RDONLY);
+    if (fd < 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_OPENING_FILE);
+        return NRT_FAILURE;
+    }
+    if (fstat(fd, &info) != 0)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_STAT_FILE);
+        close(fd);
+        return NRT_FAILURE;
+    }
+    if ((unsigned long long) info.st_size > (size_t) -1)
+    {
+        nrt_Error_init(error, "File is too large to map", NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        close(fd);
+        return NRT_FAILURE;
+    }
+    control->size = (size_t) info.st_size;
+
+    /* mmap() rejects a length of 0 */
+    if (control->size > 0)
+    {
+        data = mmap(NULL, control->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                           NRT_ERR_MEMORY);
+            close(fd);
+            return NRT_FAILURE;
+        }
+        control->data = (char *) data;
+    }
+
+    /* The mapping stays valid after the descriptor is closed */
+    close(fd);
+    return NRT_SUCCESS;
+#endif
+}
+
+NRTPRIV(void) MMapAdapter_unmap(MMapControl * control)
+{
+    if (control->data != NULL)
+    {
+#if defined(WIN32) || defined(_WIN32)
+        UnmapViewOfFile(control->data);
+#else
+        munmap(control->data, control->size);
+#endif
+        control->data = NULL;
+    }
+    control->size = 0;
+    control->mark = 0;
+    control->isOpen = NRT_FALSE;
+}
+
+NRTPRIV(NRT_BOOL) MMapAdapter_read(NRT_DATA * data, void *buf, size_t size,
+                                   nrt_Error * error)
+{
+    MMapControl *control = (MMapControl *) data;
+
+    if (control->mark > control->size || size > control->size - control->mark)
+    {
+        nrt_Error_init(error, "Invalid size requested - EOF", NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NRT_FAILURE;
+    }
+
+    if (size > 0)
+    {
+        memcpy(buf, control->data + control->mark, size);
+        control->mark += size;
+    }
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(NRT_BOOL) MMapAdapter_write(NRT_DATA * data, const void *buf,
+                                    size_t size, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)data;
+    (void)buf;
+    (void)size;
+
+    nrt_Error_init(error, "Memory mapped files are read-only", NRT_CTXT,
+                   NRT_ERR_WRITING_TO_FILE);
+    return NRT_FAILURE;
+}
+
+NRTPRIV(NRT_BOOL) MMapAdapter_canSeek(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)data;
+    (void)error;
+
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(nrt_Off) MMapAdapter_seek(NRT_DATA * data, nrt_Off offset, int whence,
+                                  nrt_Error * error)
+{
+    MMapControl *control = (MMapControl *) data;
+    nrt_Off mark;
+
+    if (whence == NRT_SEEK_SET)
+    {
+        mark = offset;
+    }
+    else if (whence == NRT_SEEK_CUR)
+    {
+        mark = (nrt_Off) control->mark + offset;
+    }
+    else if (whence == NRT_SEEK_END)
+    {
+        mark = (nrt_Off) control->size + offset;
+    }
+    else
+    {
+        nrt_Error_init(error, "Invalid/unsupported seek directive", NRT_CTXT,
+                       NRT_ERR_SEEKING_IN_FILE);
+        return -1;
+    }
+
+    if (mark < 0)
+    {
+        nrt_Error_init(error, "Attempt to seek before the start of the file",
+                       NRT_CTXT, NRT_ERR_SEEKING_IN_FILE);
+        return -1;
+    }
+    control->mark = (size_t) mark;
+    return mark;
+}
+
+NRTPRIV(nrt_Off) MMapAdapter_tell(NRT_DATA * data, nrt_Error * error)
+{
+    MMapControl *control = (MMapControl *) data;
+
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    return (nrt_Off) control->mark;
+}
+
+NRTPRIV(nrt_Off) MMapAdapter_getSize(NRT_DATA * data, nrt_Error * error)
+{
+    MMapControl *control = (MMapControl *) data;
+
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    return (nrt_Off) control->size;
+}
+
+NRTPRIV(int) MMapAdapter_getMode(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)data;
+    (void)error;
+
+    return NRT_ACCESS_READONLY;
+}
+
+NRTPRIV(NRT_BOOL) MMapAdapter_close(NRT_DATA * data, nrt_Error * error)
+{
+    /* Silence compiler warnings about unused variables */
+    (void)error;
+
+    MMapAdapter_unmap((MMapControl *) data);
+    return NRT_SUCCESS;
+}
+
+NRTPRIV(void) MMapAdapter_destruct(NRT_DATA * data)
+{
+    if (data)
+    {
+        MMapAdapter_unmap((MMapControl *) data);
+    }
+}
+
+NRTPRIV(NRT_BOOL) MMapAdapter_readBatch(NRT_DATA * data,
+                                        nrt_IORequest * requests,
+                                        size_t count, nrt_Error * error)
+{
+    MMapControl *control = (MMapControl *) data;
+    size_t ii;
+
+    for (ii = 0; ii < count; ++ii)
+    {
+        const nrt_IORequest *request = &requests[ii];
+        if (request->offset < 0 ||
+            (size_t) request->offset > control->size ||
+            request->size > control->size - (size_t) request->offset)
+        {
+            nrt_Error_init(error, "Invalid size requested - EOF", NRT_CTXT,
+                           NRT_ERR_READING_FROM_FILE);
+            return NRT_FAILURE;
+        }
+        if (request->size > 0)
+        {
+            memcpy(request->buf, control->data + request->offset,
+                   request->size);
+        }
+    }
+    return NRT_SUCCESS;
+}
+
+static nrt_IIOInterface mmapInterface = {
+    &MMapAdapter_read,
+    &MMapAdapter_write,
+    &MMapAdapter_canSeek,
+    &MMapAdapter_seek,
+    &MMapAdapter_tell,
+    &MMapAdapter_getSize,
+    &MMapAdapter_getMode,
+    &MMapAdapter_close,
+    &MMapAdapter_destruct,
+    &MMapAdapter_readBatch
+};
+
+NRTAPI(nrt_IOInterface *) nrt_MMapAdapter_open(const char *fname,
+                                               nrt_Error * error)
+{
+    nrt_IOInterface *impl = NULL;
+    MMapControl *control = NULL;
+
+    impl = (nrt_IOInterface *) NRT_MALLOC(sizeof(nrt_IOInterface));
+    if (!impl)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        goto CATCH_ERROR;
+    }
+    memset(impl, 0, sizeof(nrt_IOInterface));
+
+    control = (MMapControl *) NRT_MALLOC(sizeof(MMapControl));
+    if (!control)
+    {
+        nrt_Error_init(error, NRT_STRERROR(NRT_ERRNO), NRT_CTXT,
+                       NRT_ERR_MEMORY);
+        goto CATCH_ERROR;
+    }
+    memset(control, 0, sizeof(MMapControl));
+    impl->data = (NRT_DATA *) control;
+    impl->iface = &mmapInterface;
+
+    if (!MMapAdapter_map(control, fname, error))
+    {
+        goto CATCH_ERROR;
+    }
+    control->isOpen = NRT_TRUE;
+    return impl;
+
+    CATCH_ERROR:
+    {
+        if (impl)
+            nrt_IOInterface_destruct(&impl);
+        return NULL;
+    }
+}
+
+NRTAPI(NRT_BOOL) nrt_MMapAdapter_isMapped(nrt_IOInterface * io)
+{
+    if (io == NULL || io->iface != &mmapInterface || io->data == NULL)
+    {
+        return NRT_FALSE;
+    }
+    return ((MMapControl *) io->data)->isOpen;
+}
+
+NRTAPI(const void *) nrt_MMapAdapter_getData(nrt_IOInterface * io,
+                                             nrt_Off offset,
+                                             size_t size,
+                                             nrt_Error * error)
+{
+    MMapControl *control;
+
+    if (!nrt_MMapAdapter_isMapped(io))
+    {
+        nrt_Error_init(error, "IO interface isn't memory mapped", NRT_CTXT,
+                       NRT_ERR_INVALID_OBJECT);
+        return NULL;
+    }
+
+    control = (MMapControl *) io->data;
+    if (offset < 0 || (size_t) offset > control->size ||
+        size > control->size - (size_t) offset || control->data == NULL)
+    {
+        nrt_Error_init(error, "Invalid size requested - EOF", NRT_CTXT,
+                       NRT_ERR_READING_FROM_FILE);
+        return NULL;
+    }
+    return control->data + offset;
+}
+
+NRTAPI(NRT_BOOL) nrt_MMapAdapter_advise(nrt_IOInterface * io,
+                                        nrt_Off offset,
+                                        size_t size,
+                                        nrt_MMapAdvice advice,
+                                        nrt_Error * error)
+{
+    const char *data;
+    MMapControl *control;
+
+    if (size == 0 && nrt_MMapAdapter_isMapped(io))
+    {
+        control = (MMapControl *) io->data;
+        if (control->size == 0)
+        {
+            /* Nothing to advise about */
+            return NRT_SUCCESS;
+        }
+        if (offset >= 0 && (size_t) offset < control->size)
+        {
+            size = control->size - (size_t) offset;
+        }
+    }
+
+    data = (const char *) nrt_MMapAdapter_getData(io, offset, size, error);
+    if (data == NULL)
+    {
+        return NRT_FAILURE;
+    }
+
+#if defined(WIN32) || defined(_WIN32)
+    /* Windows only has a hint for the whole file, when it's opened */
+    (void)advice;
+#else
+    {
+        /* posix_madvise() needs a page aligned address */
+        const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+        const size_t skip = (size_t) ((uintptr_t) data % pageSize);
+        int posixAdvice;
+        int result;
+
+        switch (advice)
+        {
+        case NRT_MMAP_SEQUENTIAL:
+            posixAdvice = POSIX_MADV_SEQUENTIAL;
+            break;
+        case NRT_MMAP_RANDOM:
+            posixAdvice = POSIX_MADV_RANDOM;
+            break;
+        case NRT_MMAP_WILLNEED:
+            posixAdvice = POSIX_MADV_WILLNEED;
+            break;
+        default:
+            posixAdvice = POSIX_MADV_NORMAL;
+            break;
+        }
+
+        result = posix_madvise((void *) (data - skip), size + skip,
+                               posixAdvice);
+        if (result != 0)
+        {
+            nrt_Error_init(error, NRT_STRERROR(result), NRT_CTXT,
+                           NRT_ERR_MEMORY);
+            return NRT_FAILURE;
+        }
+    }
+#endif
+    return NRT_SUCCESS;
+}
+
+NRT_CXX_ENDGUARD
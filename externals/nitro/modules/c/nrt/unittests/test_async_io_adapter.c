@@ -0,0 +1,186 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+
+#include <import/nrt.h>
+#include "Test.h"
+
+#define ASYNC_TEST_FILE "test_async_io_adapter.tmp"
+#define TEST_FILE_SIZE 4096
+#define NUM_REQUESTS 64
+
+static void writeTestFile(void)
+{
+    char buffer[TEST_FILE_SIZE];
+    size_t ii;
+    FILE* file;
+
+    for (ii = 0; ii < TEST_FILE_SIZE; ++ii)
+    {
+        buffer[ii] = (char)(ii % 251);
+    }
+    file = fopen(ASYNC_TEST_FILE, "wb");
+    assert(file);
+    fwrite(buffer, 1, TEST_FILE_SIZE, file);
+    fclose(file);
+}
+
+/* Reads every 64 bytes of the file backwards, in one batch */
+static int readBackwards(nrt_IOInterface* io, nrt_Error* error)
+{
+    char output[TEST_FILE_SIZE];
+    nrt_IORequest requests[NUM_REQUESTS];
+    const size_t size = TEST_FILE_SIZE / NUM_REQUESTS;
+    size_t ii;
+
+    memset(output, 0, sizeof(output));
+    for (ii = 0; ii < NUM_REQUESTS; ++ii)
+    {
+        requests[ii].offset = (nrt_Off)((NUM_REQUESTS - 1 - ii) * size);
+        requests[ii].buf = output + (NUM_REQUESTS - 1 - ii) * size;
+        requests[ii].size = size;
+    }
+    if (!nrt_IOInterface_readBatch(io, requests, NUM_REQUESTS, error))
+    {
+        return 0;
+    }
+
+    for (ii = 0; ii < TEST_FILE_SIZE; ++ii)
+    {
+        if (output[ii] != (char)(ii % 251))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+TEST_CASE(testReadBatch)
+{
+    nrt_Error error;
+    size_t ii;
+
+    writeTestFile();
+    nrt_IOInterface* reader = nrt_AsyncIOAdapter_open(ASYNC_TEST_FILE, 4,
+                                                      &error);
+    TEST_ASSERT(reader != NULL);
+    TEST_ASSERT(nrt_IOInterface_getSize(reader, &error) == TEST_FILE_SIZE);
+    TEST_ASSERT(nrt_IOInterface_getMode(reader, &error) == NRT_ACCESS_READONLY);
+
+    /* The same workers serve every batch */
+    for (ii = 0; ii < 10; ++ii)
+    {
+        TEST_ASSERT(readBackwards(reader, &error));
+    }
+
+    nrt_IOInterface_destruct(&reader);
+    remove(ASYNC_TEST_FILE);
+}
+
+TEST_CASE(testReadBatchPastEnd)
+{
+    char output[16];
+    nrt_IORequest requests[2];
+    nrt_Error error;
+
+    writeTestFile();
+    nrt_IOInterface* reader = nrt_AsyncIOAdapter_open(ASYNC_TEST_FILE, 0,
+                                                      &error);
+    TEST_ASSERT(reader != NULL);
+
+    requests[0].offset = 0;
+    requests[0].buf = output;
+    requests[0].size = 8;
+    requests[1].offset = TEST_FILE_SIZE - 4;
+    requests[1].buf = output + 8;
+    requests[1].size = 8;
+    TEST_ASSERT(!nrt_IOInterface_readBatch(reader, requests, 2, &error));
+
+    /* A failed batch doesn't stop the next one */
+    requests[1].offset = TEST_FILE_SIZE - 8;
+    TEST_ASSERT(nrt_IOInterface_readBatch(reader, requests, 2, &error));
+    TEST_ASSERT(output[8] == (char)((TEST_FILE_SIZE - 8) % 251));
+
+    nrt_IOInterface_destruct(&reader);
+    remove(ASYNC_TEST_FILE);
+}
+
+TEST_CASE(testSequentialRead)
+{
+    char output[4];
+    nrt_Error error;
+
+    writeTestFile();
+    nrt_IOInterface* reader = nrt_AsyncIOAdapter_open(ASYNC_TEST_FILE, 2,
+                                                      &error);
+    TEST_ASSERT(reader != NULL);
+
+    TEST_ASSERT(nrt_IOInterface_seek(reader, 300, NRT_SEEK_SET, &error) ==
+                300);
+    TEST_ASSERT(nrt_IOInterface_read(reader, output, sizeof(output), &error));
+    TEST_ASSERT(output[0] == (char)(300 % 251));
+    TEST_ASSERT(output[3] == (char)(303 % 251));
+    TEST_ASSERT(nrt_IOInterface_tell(reader, &error) == 304);
+
+    TEST_ASSERT(nrt_IOInterface_seek(reader, -2, NRT_SEEK_END, &error) ==
+                TEST_FILE_SIZE - 2);
+    TEST_ASSERT(!nrt_IOInterface_read(reader, output, sizeof(output), &error));
+    TEST_ASSERT(!nrt_IOInterface_write(reader, output, sizeof(output), &error));
+
+    /* Closing stops the workers; nothing can be read after */
+    TEST_ASSERT(nrt_IOInterface_close(reader, &error));
+    TEST_ASSERT(!readBackwards(reader, &error));
+
+    nrt_IOInterface_destruct(&reader);
+    remove(ASYNC_TEST_FILE);
+}
+
+TEST_CASE(testFallbackBatch)
+{
+    nrt_Error error;
+
+    /* Interfaces without a batch read seek and read each request */
+    writeTestFile();
+    nrt_IOInterface* reader = nrt_IOHandleAdapter_open(
+        ASYNC_TEST_FILE, NRT_ACCESS_READONLY, NRT_OPEN_EXISTING, &error);
+    TEST_ASSERT(reader != NULL);
+    TEST_ASSERT(readBackwards(reader, &error));
+    nrt_IOInterface_destruct(&reader);
+
+    reader = nrt_MMapAdapter_open(ASYNC_TEST_FILE, &error);
+    TEST_ASSERT(reader != NULL);
+    TEST_ASSERT(readBackwards(reader, &error));
+    nrt_IOInterface_destruct(&reader);
+
+    TEST_ASSERT(nrt_AsyncIOAdapter_open("does_not_exist.tmp", 2, &error) ==
+                NULL);
+    remove(ASYNC_TEST_FILE);
+}
+
+TEST_MAIN(
+    (void) argc;
+    (void) argv;
+    CHECK(testReadBatch);
+    CHECK(testReadBatchPastEnd);
+    CHECK(testSequentialRead);
+    CHECK(testFallbackBatch);
+    )
@@ -0,0 +1,156 @@
+/* =========================================================================
+ * This file is part of NITRO
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * NITRO is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+
+#include <import/nrt.h>
+#include "Test.h"
+
+#define MMAP_TEST_FILE "test_mmap_adapter.tmp"
+#define TEST_BUF_SIZE 10
+
+static void writeTestFile(size_t size)
+{
+    const char buffer[TEST_BUF_SIZE] = { 0, 0, 0, 1, 1, 1, 1, 1, 2, 2 };
+    FILE* file = fopen(MMAP_TEST_FILE, "wb");
+    assert(file);
+    fwrite(buffer, 1, size, file);
+    fclose(file);
+}
+
+TEST_CASE(testReadInBounds)
+{
+    char output[5];
+    nrt_Error error;
+    size_t ii;
+
+    writeTestFile(TEST_BUF_SIZE);
+    nrt_IOInterface* reader = nrt_MMapAdapter_open(MMAP_TEST_FILE, &error);
+    TEST_ASSERT(reader != NULL);
+    TEST_ASSERT(nrt_MMapAdapter_isMapped(reader));
+    TEST_ASSERT(nrt_IOInterface_getSize(reader, &error) == TEST_BUF_SIZE);
+    TEST_ASSERT(nrt_IOInterface_getMode(reader, &error) == NRT_ACCESS_READONLY);
+
+    nrt_IOInterface_seek(reader, 3, NRT_SEEK_SET, &error);
+    TEST_ASSERT(nrt_IOInterface_read(reader, output, sizeof(output), &error));
+    for (ii = 0; ii < sizeof(output); ++ii)
+    {
+        TEST_ASSERT(output[ii] == (char)1);
+    }
+    TEST_ASSERT(nrt_IOInterface_tell(reader, &error) == 8);
+
+    nrt_IOInterface_destruct(&reader);
+    remove(MMAP_TEST_FILE);
+}
+
+TEST_CASE(testReadPastEnd)
+{
+    char output[5];
+    nrt_Error error;
+
+    writeTestFile(TEST_BUF_SIZE);
+    nrt_IOInterface* reader = nrt_MMapAdapter_open(MMAP_TEST_FILE, &error);
+    TEST_ASSERT(reader != NULL);
+
+    nrt_IOInterface_seek(reader, 8, NRT_SEEK_SET, &error);
+    TEST_ASSERT(!nrt_IOInterface_read(reader, output, sizeof(output), &error));
+
+    nrt_IOInterface_seek(reader, TEST_BUF_SIZE + 1, NRT_SEEK_SET, &error);
+    TEST_ASSERT(!nrt_IOInterface_read(reader, output, 1, &error));
+
+    nrt_IOInterface_destruct(&reader);
+    remove(MMAP_TEST_FILE);
+}
+
+TEST_CASE(testGetData)
+{
+    nrt_Error error;
+    const char* data;
+
+    writeTestFile(TEST_BUF_SIZE);
+    nrt_IOInterface* reader = nrt_MMapAdapter_open(MMAP_TEST_FILE, &error);
+    TEST_ASSERT(reader != NULL);
+
+    /* Direct access leaves the file position alone */
+    data = (const char*)nrt_MMapAdapter_getData(reader, 8, 2, &error);
+    TEST_ASSERT(data != NULL);
+    TEST_ASSERT(data[0] == (char)2 && data[1] == (char)2);
+    TEST_ASSERT(nrt_IOInterface_tell(reader, &error) == 0);
+
+    TEST_ASSERT(nrt_MMapAdapter_getData(reader, 8, 3, &error) == NULL);
+    TEST_ASSERT(nrt_MMapAdapter_advise(reader, 0, 0, NRT_MMAP_SEQUENTIAL,
+                                       &error));
+    TEST_ASSERT(nrt_MMapAdapter_advise(reader, 3, 5, NRT_MMAP_RANDOM,
+                                       &error));
+
+    /* Nothing is mapped once it's closed */
+    nrt_IOInterface_close(reader, &error);
+    TEST_ASSERT(!nrt_MMapAdapter_isMapped(reader));
+    TEST_ASSERT(nrt_MMapAdapter_getData(reader, 0, 1, &error) == NULL);
+
+    nrt_IOInterface_destruct(&reader);
+    remove(MMAP_TEST_FILE);
+}
+
+TEST_CASE(testNotMapped)
+{
+    char buffer[TEST_BUF_SIZE];
+    nrt_Error error;
+
+    nrt_IOInterface* reader = nrt_BufferAdapter_construct(
+        buffer, TEST_BUF_SIZE, 0, &error);
+    TEST_ASSERT(!nrt_MMapAdapter_isMapped(reader));
+    TEST_ASSERT(nrt_MMapAdapter_getData(reader, 0, 1, &error) == NULL);
+    nrt_IOInterface_destruct(&reader);
+
+    TEST_ASSERT(nrt_MMapAdapter_open("does_not_exist.tmp", &error) == NULL);
+}
+
+TEST_CASE(testWriteFails)
+{
+    char input[5];
+    nrt_Error error;
+
+    memset(input, 0, sizeof(input));
+    /* An empty file has nothing to map, but can still be opened */
+    writeTestFile(0);
+    nrt_IOInterface* writer = nrt_MMapAdapter_open(MMAP_TEST_FILE, &error);
+    TEST_ASSERT(writer != NULL);
+    TEST_ASSERT(nrt_MMapAdapter_isMapped(writer));
+    TEST_ASSERT(nrt_IOInterface_getSize(writer, &error) == 0);
+    TEST_ASSERT(nrt_MMapAdapter_advise(writer, 0, 0, NRT_MMAP_SEQUENTIAL,
+                                       &error));
+
+    TEST_ASSERT(!nrt_IOInterface_write(writer, input, sizeof(input), &error));
+
+    nrt_IOInterface_destruct(&writer);
+    remove(MMAP_TEST_FILE);
+}
+
+TEST_MAIN(
+    (void) argc;
+    (void) argv;
+    CHECK(testReadInBounds);
+    CHECK(testReadPastEnd);
+    CHECK(testGetData);
+    CHECK(testNotMapped);
+    CHECK(testWriteFails);
+    )
@@ -0,0 +1,56 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CPHD_CPHD_METADATA_SUMMARIZER_H__
+#define __CPHD_CPHD_METADATA_SUMMARIZER_H__
+
+#include <string>
+#include <vector>
+
+#include <six/MetadataIndexer.h>
+#include <cphd/Metadata.h>
+
+namespace cphd
+{
+/*
+ *  \struct CPHDMetadataSummarizer
+ *
+ *  \brief Summarizes CPHD files for a six::MetadataIndexer
+ *
+ *  Only the file header and XML are read; unlike CPHDReader, the support
+ *  arrays and PVP block are not.  Each file is one product, and the
+ *  polarization of each channel is listed.
+ */
+struct CPHDMetadataSummarizer : public six::MetadataSummarizer
+{
+    bool supports(const std::string& pathname) const override;
+
+    void summarize(const std::string& pathname,
+                   std::vector<six::MetadataSummary>& summaries) const override;
+
+protected:
+    //! Fill in the fields for the file.  Override this to add more.
+    virtual void summarize(const Metadata& metadata,
+                           six::MetadataSummary& summary) const;
+};
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <std/string>
 
 #include <scene/sys_Conf.h>
+#include <io/InputStream.h>
 #include <xml/lite/Element.h>
 #include <xml/lite/Document.h>
 #include <cphd/CPHDXMLParser.h>
@@ -139,6 +140,23 @@ public:
     virtual Metadata fromXML(const xml::lite::Document& doc,
         const std::vector<std::filesystem::path>& schemaPaths = std::vector<std::filesystem::path>());
 
+    /*!
+     *  \func fromXMLStream
+     *
+     *  \brief Parse CPHD XML directly from a stream to Metadata object
+     *
+     *  Much faster, and uses far less memory, than parsing to a DOM
+     *  first when there are many channels.  The XML isn't validated, as
+     *  that needs the DOM.
+     *
+     *  \param is Stream containing the XML
+     *  \param size Number of bytes to read from the stream
+     *
+     *  \return pointer to metadata object
+     */
+    virtual std::unique_ptr<Metadata> fromXMLStream(
+            io::InputStream& is, int size = io::InputStream::IS_END);
+
     //! \return Suported version to uri mapping
     static std::unordered_map<std::string, xml::lite::Uri> getVersionUriMap();
 
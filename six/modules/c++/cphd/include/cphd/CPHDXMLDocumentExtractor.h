@@ -0,0 +1,48 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CPHD_CPHD_XML_DOCUMENT_EXTRACTOR_H__
+#define __CPHD_CPHD_XML_DOCUMENT_EXTRACTOR_H__
+
+#include <string>
+#include <vector>
+
+#include <six/BatchValidator.h>
+
+namespace cphd
+{
+/*
+ *  \struct CPHDXMLDocumentExtractor
+ *
+ *  \brief Extracts the XML block of CPHD files for a six::BatchValidator
+ *
+ *  Only the file header and XML block are read, and the XML isn't parsed.
+ */
+struct CPHDXMLDocumentExtractor : public six::XMLDocumentExtractor
+{
+    bool supports(const std::string& pathname) const override;
+
+    void extract(const std::string& pathname,
+                 std::vector<coda_oss::u8string>& documents) const override;
+};
+}
+
+#endif
@@ -25,6 +25,7 @@
 
 #include <memory>
 
+#include <io/InputStream.h>
 #include <logging/Logger.h>
 #include <xml/lite/Element.h>
 #include <xml/lite/Document.h>
@@ -36,6 +37,7 @@
 #include <cphd/Metadata.h>
 #include <cphd/PVP.h>
 #include <cphd/ReferenceGeometry.h>
+#include <cphd/TxRcv.h>
 #include <cphd/Types.h>
 
 namespace cphd
@@ -88,6 +90,25 @@ public:
     std::unique_ptr<Metadata> fromXML(
             const xml::lite::Document* doc);
 
+    /*!
+     *  \func fromXML
+     *
+     *  \brief Parse a CPHD XML stream to Metadata object without
+     *  building a DOM for the whole document
+     *
+     *  Each section, and each item of the Data channel, Channel parameter
+     *  and TxRcv lists, is parsed as soon as it ends and then discarded.
+     *  Character data is preserved, as when reading a CPHD file.
+     *
+     *  \param is Stream containing the XML
+     *  \param size Number of bytes to read from the stream
+     *  \param[out] uri Namespace URI of the root element
+     *
+     *  \return pointer to metadata object
+     */
+    std::unique_ptr<Metadata> fromXML(
+            io::InputStream& is, int size, xml::lite::Uri& uri);
+
 private:
     typedef xml::lite::Element*  XMLElem;
 
@@ -165,6 +186,13 @@ private:
     void parseSupportArrayParameter(const xml::lite::Element* paramXML, SupportArrayParameter& param,
                                     bool additionalFlag) const;
     void parseTxRcvParameter(const xml::lite::Element* paramXML, ParameterType& param) const;
+    void parseTxWFParameters(const xml::lite::Element* paramXML, TxWFParameters& param) const;
+    void parseRcvParameters(const xml::lite::Element* paramXML, RcvParameters& param) const;
+    void parseTxRcvCounts(const xml::lite::Element* txRcvXML, size_t numTxWFs, size_t numRcvs) const;
+    void parseDataCommon(const xml::lite::Element* dataXML, Data& data) const;
+    void parseDataChannel(const xml::lite::Element* channelXML, Data::Channel& channel) const;
+    void parseDataSupportArray(const xml::lite::Element* supportXML, Data& data) const;
+    void parseChannelCommon(const xml::lite::Element* channelXML, Channel& channel) const;
 
 private:
     six::SICommonXMLParser10x mCommon;
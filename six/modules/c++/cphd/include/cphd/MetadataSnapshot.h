@@ -0,0 +1,52 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __CPHD_METADATA_SNAPSHOT_H__
+#define __CPHD_METADATA_SNAPSHOT_H__
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <std/cstddef>
+#include <std/span>
+
+#include <cphd/Metadata.h>
+
+namespace cphd
+{
+/*!
+ *  Append a six::MetadataSnapshot of CPHD metadata to 'buffer'.  Its
+ *  identifier is "CPHD".
+ */
+void serializeSnapshot(const Metadata& metadata,
+                       std::vector<std::byte>& buffer);
+
+/*!
+ *  Load CPHD metadata from what serializeSnapshot() wrote
+ *
+ *  \throw if 'buffer' isn't a complete snapshot of CPHD metadata
+ */
+std::unique_ptr<Metadata>
+deserializeSnapshot(std::span<const std::byte> buffer);
+}
+
+#endif
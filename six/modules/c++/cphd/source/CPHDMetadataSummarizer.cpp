@@ -0,0 +1,96 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cphd/CPHDMetadataSummarizer.h>
+
+#include <except/Exception.h>
+#include <io/FileInputStream.h>
+#include <logging/NullLogger.h>
+#include <gsl/gsl.h>
+
+#include <six/Utilities.h>
+#include <cphd/CPHDXMLControl.h>
+#include <cphd/FileHeader.h>
+
+namespace cphd
+{
+bool CPHDMetadataSummarizer::supports(const std::string& pathname) const
+{
+    try
+    {
+        // CPHD 0.3 is read by cphd03
+        io::FileInputStream inStream(pathname);
+        const std::string version = FileHeader::readVersion(inStream);
+        return !version.empty() && version[0] != '0';
+    }
+    catch (const except::Exception&)
+    {
+        return false;
+    }
+}
+
+void CPHDMetadataSummarizer::summarize(
+        const std::string& pathname,
+        std::vector<six::MetadataSummary>& summaries) const
+{
+    io::FileInputStream inStream(pathname);
+    FileHeader header;
+    header.read(inStream);
+
+    inStream.seek(header.getXMLBlockByteOffset(), io::Seekable::START);
+    logging::NullLogger log;
+    const std::unique_ptr<Metadata> metadata =
+            CPHDXMLControl(&log).fromXMLStream(
+                    inStream, gsl::narrow<int>(header.getXMLBlockSize()));
+
+    six::MetadataSummary summary;
+    summarize(*metadata, summary);
+    summaries.push_back(summary);
+}
+
+void CPHDMetadataSummarizer::summarize(const Metadata& metadata,
+                                       six::MetadataSummary& summary) const
+{
+    summary[six::MetadataField::TYPE] = "CPHD";
+    summary[six::MetadataField::VERSION] = metadata.getVersion();
+    summary[six::MetadataField::NAME] = metadata.collectionID.coreName;
+    summary[six::MetadataField::COLLECTOR] =
+            metadata.collectionID.collectorName;
+    summary[six::MetadataField::COLLECT_START] =
+            six::toString(metadata.global.timeline.collectionStart);
+    summary[six::MetadataField::CLASSIFICATION] =
+            metadata.collectionID.getClassificationLevel();
+    summary[six::MetadataField::FOOTPRINT] =
+            toString(metadata.sceneCoordinates.imageAreaCorners);
+
+    std::string polarization;
+    for (const auto& parameter : metadata.channel.parameters)
+    {
+        if (!polarization.empty())
+        {
+            polarization += ' ';
+        }
+        polarization += parameter.polarization.txPol.toString() + ':' +
+                parameter.polarization.rcvPol.toString();
+    }
+    summary[six::MetadataField::POLARIZATION] = polarization;
+}
+}
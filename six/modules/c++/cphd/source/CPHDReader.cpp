@@ -64,19 +64,29 @@ void CPHDReader::initialize(std::shared_ptr<io::SeekableInputStream> inStream,
     // Read in the XML string
     inStream->seek(mFileHeader.getXMLBlockByteOffset(), io::Seekable::START);
 
-    six::MinidomParser xmlParser;
-    xmlParser.preserveCharacterData(true);
-    xmlParser.parse(*inStream, gsl::narrow<int>(mFileHeader.getXMLBlockSize()));
-
     if (logger.get() == nullptr)
     {
         logger = std::make_shared<logging::NullLogger>();
     }
 
-    std::vector<std::filesystem::path> schemaPaths;
-    std::transform(schemaPaths_.begin(), schemaPaths_.end(), std::back_inserter(schemaPaths),
-        [](const std::string& s) { return s; });
-    mMetadata = CPHDXMLControl(logger.get()).fromXML(xmlParser.getDocument(), schemaPaths);
+    const int xmlSize = gsl::narrow<int>(mFileHeader.getXMLBlockSize());
+    if (schemaPaths_.empty())
+    {
+        // Nothing to validate, so skip the DOM
+        mMetadata = std::move(*CPHDXMLControl(logger.get()).fromXMLStream(
+                *inStream, xmlSize));
+    }
+    else
+    {
+        six::MinidomParser xmlParser;
+        xmlParser.preserveCharacterData(true);
+        xmlParser.parse(*inStream, xmlSize);
+
+        std::vector<std::filesystem::path> schemaPaths;
+        std::transform(schemaPaths_.begin(), schemaPaths_.end(), std::back_inserter(schemaPaths),
+            [](const std::string& s) { return s; });
+        mMetadata = CPHDXMLControl(logger.get()).fromXML(xmlParser.getDocument(), schemaPaths);
+    }
 
     mSupportBlock = std::make_unique<SupportBlock>(inStream, mMetadata.data, mFileHeader);
 
@@ -161,6 +161,17 @@ Metadata CPHDXMLControl::fromXML(const xml::lite::Document& doc, const std::vect
     return *(result.release());
 }
 
+std::unique_ptr<Metadata> CPHDXMLControl::fromXMLStream(io::InputStream& is,
+                                                        int size)
+{
+    // The parser's URI is only used for writing
+    xml::lite::Uri uri;
+    std::unique_ptr<Metadata> metadata =
+            getParser(uri)->fromXML(is, size, uri);
+    metadata->setVersion(uriToVersion(uri));
+    return metadata;
+}
+
 std::unique_ptr<Metadata> CPHDXMLControl::fromXMLImpl(const xml::lite::Document* doc)
 {
     const xml::lite::Uri uri(doc->getRootElement()->getUri());
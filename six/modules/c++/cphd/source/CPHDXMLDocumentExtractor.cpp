@@ -0,0 +1,63 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cphd/CPHDXMLDocumentExtractor.h>
+
+#include <except/Exception.h>
+#include <io/FileInputStream.h>
+
+#include <cphd/FileHeader.h>
+
+namespace cphd
+{
+bool CPHDXMLDocumentExtractor::supports(const std::string& pathname) const
+{
+    try
+    {
+        // CPHD 0.3 has no schema
+        io::FileInputStream inStream(pathname);
+        const std::string version = FileHeader::readVersion(inStream);
+        return !version.empty() && version[0] != '0';
+    }
+    catch (const except::Exception&)
+    {
+        return false;
+    }
+}
+
+void CPHDXMLDocumentExtractor::extract(
+        const std::string& pathname,
+        std::vector<coda_oss::u8string>& documents) const
+{
+    io::FileInputStream inStream(pathname);
+    FileHeader header;
+    header.read(inStream);
+
+    coda_oss::u8string xml(static_cast<size_t>(header.getXMLBlockSize()),
+                           coda_oss::u8string::value_type(0));
+    inStream.seek(header.getXMLBlockByteOffset(), io::Seekable::START);
+    if (!xml.empty())
+    {
+        inStream.read(&xml[0], xml.size(), true);
+    }
+    documents.push_back(std::move(xml));
+}
+}
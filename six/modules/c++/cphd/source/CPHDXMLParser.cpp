@@ -26,6 +26,7 @@
 #include <str/Convert.h>
 #include <six/Utilities.h>
 #include <six/SICommonXMLParser.h>
+#include <six/StreamingXMLParser.h>
 #include <cphd/CPHDXMLParser.h>
 #include <cphd/Enums.h>
 #include <cphd/Metadata.h>
@@ -965,6 +966,155 @@ std::unique_ptr<Metadata> CPHDXMLParser::fromXML(
     return cphd;
 }
 
+std::unique_ptr<Metadata> CPHDXMLParser::fromXML(io::InputStream& is,
+                                                 int size,
+                                                 xml::lite::Uri& uri)
+{
+    std::unique_ptr<Metadata> cphd(new Metadata());
+    Metadata& metadata = *cphd;
+
+    // The potentially large lists are registered below their sections so
+    // each item is parsed and discarded as soon as it ends.  A section's
+    // handler is called after all of its items have been.
+    six::StreamingXMLParser parser;
+    parser.preserveCharacterData(true);
+
+    parser.addHandler("CollectionID", [&](const xml::lite::Element& element)
+    {
+        fromXML(&element, metadata.collectionID);
+    });
+    parser.addHandler("Global", [&](const xml::lite::Element& element)
+    {
+        fromXML(&element, metadata.global);
+    });
+    parser.addHandler("SceneCoordinates", [&](const xml::lite::Element& element)
+    {
+        fromXML(&element, metadata.sceneCoordinates);
+    });
+    parser.addHandler("Data/Channel", [&](const xml::lite::Element& element)
+    {
+        metadata.data.channels.emplace_back();
+        parseDataChannel(&element, metadata.data.channels.back());
+    });
+    parser.addHandler("Data/SupportArray", [&](const xml::lite::Element& element)
+    {
+        parseDataSupportArray(&element, metadata.data);
+    });
+    parser.addHandler("Data", [&](const xml::lite::Element& element)
+    {
+        parseDataCommon(&element, metadata.data);
+    });
+    parser.addHandler("Channel/Parameters", [&](const xml::lite::Element& element)
+    {
+        metadata.channel.parameters.emplace_back();
+        parseChannelParameters(&element, metadata.channel.parameters.back());
+    });
+    parser.addHandler("Channel", [&](const xml::lite::Element& element)
+    {
+        parseChannelCommon(&element, metadata.channel);
+    });
+    parser.addHandler("PVP", [&](const xml::lite::Element& element)
+    {
+        fromXML(&element, metadata.pvp);
+    });
+    parser.addHandler("Dwell", [&](const xml::lite::Element& element)
+    {
+        fromXML(&element, metadata.dwell);
+    });
+    parser.addHandler("ReferenceGeometry", [&](const xml::lite::Element& element)
+    {
+        fromXML(&element, metadata.referenceGeometry);
+    });
+    parser.addHandler("SupportArray", [&](const xml::lite::Element& element)
+    {
+        metadata.supportArray.reset(new SupportArray());
+        fromXML(&element, *(metadata.supportArray));
+    });
+    parser.addHandler("Antenna", [&](const xml::lite::Element& element)
+    {
+        metadata.antenna.reset(new Antenna());
+        fromXML(&element, *(metadata.antenna));
+    });
+    parser.addHandler("TxRcv/TxWFParameters", [&](const xml::lite::Element& element)
+    {
+        if (!metadata.txRcv.get())
+        {
+            metadata.txRcv.reset(new TxRcv());
+        }
+        metadata.txRcv->txWFParameters.emplace_back();
+        parseTxWFParameters(&element, metadata.txRcv->txWFParameters.back());
+    });
+    parser.addHandler("TxRcv/RcvParameters", [&](const xml::lite::Element& element)
+    {
+        if (!metadata.txRcv.get())
+        {
+            metadata.txRcv.reset(new TxRcv());
+        }
+        metadata.txRcv->rcvParameters.emplace_back();
+        parseRcvParameters(&element, metadata.txRcv->rcvParameters.back());
+    });
+    parser.addHandler("TxRcv", [&](const xml::lite::Element& element)
+    {
+        if (!metadata.txRcv.get())
+        {
+            metadata.txRcv.reset(new TxRcv());
+        }
+        parseTxRcvCounts(&element, metadata.txRcv->txWFParameters.size(),
+                         metadata.txRcv->rcvParameters.size());
+    });
+    parser.addHandler("ErrorParameters", [&](const xml::lite::Element& element)
+    {
+        metadata.errorParameters.reset(new ErrorParameters());
+        fromXML(&element, *(metadata.errorParameters));
+    });
+    parser.addHandler("ProductInfo", [&](const xml::lite::Element& element)
+    {
+        metadata.productInfo.reset(new ProductInfo());
+        fromXML(&element, *(metadata.productInfo));
+    });
+    parser.addHandler("GeoInfo", [&](const xml::lite::Element& element)
+    {
+        metadata.geoInfo.emplace_back();
+        fromXML(&element, metadata.geoInfo.back());
+    });
+    parser.addHandler("MatchInfo", [&](const xml::lite::Element& element)
+    {
+        metadata.matchInfo.reset(new MatchInformation());
+        fromXML(&element, *(metadata.matchInfo));
+    });
+
+    parser.parse(is, size);
+
+    // The same checks getFirstAndOnly() and getOptional() make on a DOM
+    static const char* const required[] = {
+            "CollectionID", "Global", "SceneCoordinates", "Data", "Channel",
+            "PVP", "Dwell", "ReferenceGeometry" };
+    for (const char* name : required)
+    {
+        if (parser.getCount(name) != 1)
+        {
+            throw except::Exception(Ctxt(
+                    "Expected exactly one " + std::string(name) +
+                    " element, found " + std::to_string(parser.getCount(name))));
+        }
+    }
+    static const char* const optional[] = {
+            "SupportArray", "Antenna", "TxRcv", "ErrorParameters",
+            "ProductInfo", "MatchInfo" };
+    for (const char* name : optional)
+    {
+        if (parser.getCount(name) > 1)
+        {
+            throw except::Exception(Ctxt(
+                    "Expected at most one " + std::string(name) +
+                    " element, found " + std::to_string(parser.getCount(name))));
+        }
+    }
+
+    uri = xml::lite::Uri(parser.getRootUri());
+    return cphd;
+}
+
 void CPHDXMLParser::fromXML(const xml::lite::Element* collectionIDXML, CollectionInformation& collectionID)
 {
     parseString(getFirstAndOnly(collectionIDXML, "CollectorName"),
@@ -1224,18 +1374,7 @@ void CPHDXMLParser::fromXML(const xml::lite::Element* sceneCoordsXML,
 
 void CPHDXMLParser::fromXML(const xml::lite::Element* dataXML, Data& data)
 {
-    const xml::lite::Element* signalXML = getFirstAndOnly(dataXML, "SignalArrayFormat");
-    data.signalArrayFormat = SignalArrayFormat::toType(signalXML->getCharacterData());
-
-    size_t numBytesPVP_temp = 0;
-    XMLElem numBytesPVPXML = getFirstAndOnly(dataXML, "NumBytesPVP");
-    parseUInt(numBytesPVPXML, numBytesPVP_temp);
-    if(numBytesPVP_temp % 8 != 0)
-    {
-        throw except::Exception(Ctxt(
-                "Number of bytes must be multiple of 8"));
-    }
-    data.numBytesPVP = numBytesPVP_temp;
+    parseDataCommon(dataXML, data);
 
     // Channels
     std::vector<XMLElem> channelsXML;
@@ -1243,27 +1382,7 @@ void CPHDXMLParser::fromXML(const xml::lite::Element* dataXML, Data& data)
     data.channels.resize(channelsXML.size());
     for (size_t ii = 0; ii < channelsXML.size(); ++ii)
     {
-        parseString(getFirstAndOnly(channelsXML[ii], "Identifier"),
-                    data.channels[ii].identifier);
-        parseUInt(getFirstAndOnly(channelsXML[ii], "NumVectors"),
-                  data.channels[ii].numVectors);
-        parseUInt(getFirstAndOnly(channelsXML[ii], "NumSamples"),
-                  data.channels[ii].numSamples);
-        parseUInt(getFirstAndOnly(channelsXML[ii], "SignalArrayByteOffset"),
-                  data.channels[ii].signalArrayByteOffset);
-        parseUInt(getFirstAndOnly(channelsXML[ii], "PVPArrayByteOffset"),
-                  data.channels[ii].pvpArrayByteOffset);
-        XMLElem compressionXML = getOptional(channelsXML[ii], "CompressedSignalSize");
-        if (compressionXML)
-        {
-            parseUInt(compressionXML, data.channels[ii].compressedSignalSize);
-        }
-    }
-    XMLElem compressionXML = getOptional(dataXML, "SignalCompressionID");
-    if (compressionXML)
-    {
-        parseString(compressionXML,
-                    data.signalCompressionID);
+        parseDataChannel(channelsXML[ii], data.channels[ii]);
     }
 
     // Support Arrays
@@ -1271,29 +1390,13 @@ void CPHDXMLParser::fromXML(const xml::lite::Element* dataXML, Data& data)
     dataXML->getElementsByTagName("SupportArray", supportsXML);
     for (size_t ii = 0; ii < supportsXML.size(); ++ii)
     {
-        std::string id;
-        size_t offset;
-        size_t numRows;
-        size_t numCols;
-        size_t numBytes;
-        parseString(getFirstAndOnly(supportsXML[ii], "Identifier"), id);
-        parseUInt(getFirstAndOnly(supportsXML[ii], "ArrayByteOffset"), offset);
-        parseUInt(getFirstAndOnly(supportsXML[ii], "NumRows"), numRows);
-        parseUInt(getFirstAndOnly(supportsXML[ii], "NumCols"), numCols);
-        parseUInt(getFirstAndOnly(supportsXML[ii], "BytesPerElement"), numBytes);
-        data.setSupportArray(id, numRows, numCols, numBytes, offset);
+        parseDataSupportArray(supportsXML[ii], data);
     }
 }
 
 void CPHDXMLParser::fromXML(const xml::lite::Element* channelXML, Channel& channel)
 {
-    parseString(getFirstAndOnly(channelXML, "RefChId"), channel.refChId);
-    parseBooleanType(getFirstAndOnly(channelXML, "FXFixedCPHD"),
-                     channel.fxFixedCphd);
-    parseBooleanType(getFirstAndOnly(channelXML, "TOAFixedCPHD"),
-                     channel.toaFixedCphd);
-    parseBooleanType(getFirstAndOnly(channelXML, "SRPFixedCPHD"),
-                     channel.srpFixedCphd);
+    parseChannelCommon(channelXML, channel);
 
     std::vector<XMLElem> parametersXML;
     channelXML->getElementsByTagName("Parameters", parametersXML);
@@ -1302,12 +1405,6 @@ void CPHDXMLParser::fromXML(const xml::lite::Element* channelXML, Channel& chann
     {
         parseChannelParameters(parametersXML[ii], channel.parameters[ii]);
     }
-
-    XMLElem addedParametersXML = getOptional(channelXML, "AddedParameters");
-    if(addedParametersXML)
-    {
-        mCommon.parseParameters(addedParametersXML, "Parameter", channel.addedParameters);
-    }
 }
 
 void CPHDXMLParser::fromXML(const xml::lite::Element* pvpXML, Pvp& pvp)
@@ -1571,44 +1668,23 @@ void CPHDXMLParser::fromXML(const xml::lite::Element* antennaXML, Antenna& anten
 
 void CPHDXMLParser::fromXML(const xml::lite::Element* txRcvXML, TxRcv& txRcv)
 {
-    size_t numTxWFs = 0;
-    size_t numRcvs = 0;
-    parseUInt(getFirstAndOnly(txRcvXML, "NumTxWFs"), numTxWFs);
-    txRcv.txWFParameters.resize(numTxWFs);
-    parseUInt(getFirstAndOnly(txRcvXML, "NumRcvs"), numRcvs);
-    txRcv.rcvParameters.resize(numRcvs);
-
     std::vector<XMLElem> txWFXMLVec;
     txRcvXML->getElementsByTagName("TxWFParameters", txWFXMLVec);
-    if(txRcv.txWFParameters.size() != txWFXMLVec.size())
-    {
-        throw except::Exception(Ctxt(
-                "Incorrect number of TxWF parameters provided"));
-    }
-    for(size_t ii = 0; ii < txWFXMLVec.size(); ++ii)
-    {
-        parseTxRcvParameter(txWFXMLVec[ii], txRcv.txWFParameters[ii]);
-        parseDouble(getFirstAndOnly(txWFXMLVec[ii], "PulseLength"), txRcv.txWFParameters[ii].pulseLength);
-        parseDouble(getFirstAndOnly(txWFXMLVec[ii], "RFBandwidth"), txRcv.txWFParameters[ii].rfBandwidth);
-        parseOptionalDouble(txWFXMLVec[ii], "Power", txRcv.txWFParameters[ii].power);
-    }
-
     std::vector<XMLElem> rcvXMLVec;
     txRcvXML->getElementsByTagName("RcvParameters", rcvXMLVec);
-    if(txRcv.rcvParameters.size() != rcvXMLVec.size())
+    parseTxRcvCounts(txRcvXML, txWFXMLVec.size(), rcvXMLVec.size());
+
+    txRcv.txWFParameters.resize(txWFXMLVec.size());
+    for(size_t ii = 0; ii < txWFXMLVec.size(); ++ii)
     {
-        throw except::Exception(Ctxt(
-                "Incorrect number of Rcv parameters provided"));
+        parseTxWFParameters(txWFXMLVec[ii], txRcv.txWFParameters[ii]);
     }
+
+    txRcv.rcvParameters.resize(rcvXMLVec.size());
     for(size_t ii = 0; ii < rcvXMLVec.size(); ++ii)
     {
-        parseTxRcvParameter(rcvXMLVec[ii], txRcv.rcvParameters[ii]);
-        parseDouble(getFirstAndOnly(rcvXMLVec[ii], "WindowLength"), txRcv.rcvParameters[ii].windowLength);
-        parseDouble(getFirstAndOnly(rcvXMLVec[ii], "SampleRate"), txRcv.rcvParameters[ii].sampleRate);
-        parseDouble(getFirstAndOnly(rcvXMLVec[ii], "IFFilterBW"), txRcv.rcvParameters[ii].ifFilterBW);
-        parseOptionalDouble(rcvXMLVec[ii], "PathGain", txRcv.rcvParameters[ii].pathGain);
+        parseRcvParameters(rcvXMLVec[ii], txRcv.rcvParameters[ii]);
     }
-
 }
 
 void CPHDXMLParser::fromXML(const xml::lite::Element* errParamXML, ErrorParameters& errParam)
@@ -2197,4 +2273,119 @@ void CPHDXMLParser::parseTxRcvParameter(const xml::lite::Element* paramXML, Para
     parseOptionalDouble(paramXML, "LFMRate", param.lfmRate);
     param.polarization = PolarizationType::toType(getFirstAndOnly(paramXML, "Polarization")->getCharacterData());
 }
+
+void CPHDXMLParser::parseTxWFParameters(const xml::lite::Element* paramXML,
+                                        TxWFParameters& param) const
+{
+    parseTxRcvParameter(paramXML, param);
+    parseDouble(getFirstAndOnly(paramXML, "PulseLength"), param.pulseLength);
+    parseDouble(getFirstAndOnly(paramXML, "RFBandwidth"), param.rfBandwidth);
+    parseOptionalDouble(paramXML, "Power", param.power);
+}
+
+void CPHDXMLParser::parseRcvParameters(const xml::lite::Element* paramXML,
+                                       RcvParameters& param) const
+{
+    parseTxRcvParameter(paramXML, param);
+    parseDouble(getFirstAndOnly(paramXML, "WindowLength"), param.windowLength);
+    parseDouble(getFirstAndOnly(paramXML, "SampleRate"), param.sampleRate);
+    parseDouble(getFirstAndOnly(paramXML, "IFFilterBW"), param.ifFilterBW);
+    parseOptionalDouble(paramXML, "PathGain", param.pathGain);
+}
+
+void CPHDXMLParser::parseTxRcvCounts(const xml::lite::Element* txRcvXML,
+                                     size_t numTxWFs, size_t numRcvs) const
+{
+    size_t expected = 0;
+    parseUInt(getFirstAndOnly(txRcvXML, "NumTxWFs"), expected);
+    if(expected != numTxWFs)
+    {
+        throw except::Exception(Ctxt(
+                "Incorrect number of TxWF parameters provided"));
+    }
+    parseUInt(getFirstAndOnly(txRcvXML, "NumRcvs"), expected);
+    if(expected != numRcvs)
+    {
+        throw except::Exception(Ctxt(
+                "Incorrect number of Rcv parameters provided"));
+    }
+}
+
+void CPHDXMLParser::parseDataCommon(const xml::lite::Element* dataXML,
+                                    Data& data) const
+{
+    const xml::lite::Element* signalXML = getFirstAndOnly(dataXML, "SignalArrayFormat");
+    data.signalArrayFormat = SignalArrayFormat::toType(signalXML->getCharacterData());
+
+    size_t numBytesPVP_temp = 0;
+    XMLElem numBytesPVPXML = getFirstAndOnly(dataXML, "NumBytesPVP");
+    parseUInt(numBytesPVPXML, numBytesPVP_temp);
+    if(numBytesPVP_temp % 8 != 0)
+    {
+        throw except::Exception(Ctxt(
+                "Number of bytes must be multiple of 8"));
+    }
+    data.numBytesPVP = numBytesPVP_temp;
+
+    XMLElem compressionXML = getOptional(dataXML, "SignalCompressionID");
+    if (compressionXML)
+    {
+        parseString(compressionXML,
+                    data.signalCompressionID);
+    }
+}
+
+void CPHDXMLParser::parseDataChannel(const xml::lite::Element* channelXML,
+                                     Data::Channel& channel) const
+{
+    parseString(getFirstAndOnly(channelXML, "Identifier"),
+                channel.identifier);
+    parseUInt(getFirstAndOnly(channelXML, "NumVectors"),
+              channel.numVectors);
+    parseUInt(getFirstAndOnly(channelXML, "NumSamples"),
+              channel.numSamples);
+    parseUInt(getFirstAndOnly(channelXML, "SignalArrayByteOffset"),
+              channel.signalArrayByteOffset);
+    parseUInt(getFirstAndOnly(channelXML, "PVPArrayByteOffset"),
+              channel.pvpArrayByteOffset);
+    XMLElem compressionXML = getOptional(channelXML, "CompressedSignalSize");
+    if (compressionXML)
+    {
+        parseUInt(compressionXML, channel.compressedSignalSize);
+    }
+}
+
+void CPHDXMLParser::parseDataSupportArray(const xml::lite::Element* supportXML,
+                                          Data& data) const
+{
+    std::string id;
+    size_t offset;
+    size_t numRows;
+    size_t numCols;
+    size_t numBytes;
+    parseString(getFirstAndOnly(supportXML, "Identifier"), id);
+    parseUInt(getFirstAndOnly(supportXML, "ArrayByteOffset"), offset);
+    parseUInt(getFirstAndOnly(supportXML, "NumRows"), numRows);
+    parseUInt(getFirstAndOnly(supportXML, "NumCols"), numCols);
+    parseUInt(getFirstAndOnly(supportXML, "BytesPerElement"), numBytes);
+    data.setSupportArray(id, numRows, numCols, numBytes, offset);
+}
+
+void CPHDXMLParser::parseChannelCommon(const xml::lite::Element* channelXML,
+                                       Channel& channel) const
+{
+    parseString(getFirstAndOnly(channelXML, "RefChId"), channel.refChId);
+    parseBooleanType(getFirstAndOnly(channelXML, "FXFixedCPHD"),
+                     channel.fxFixedCphd);
+    parseBooleanType(getFirstAndOnly(channelXML, "TOAFixedCPHD"),
+                     channel.toaFixedCphd);
+    parseBooleanType(getFirstAndOnly(channelXML, "SRPFixedCPHD"),
+                     channel.srpFixedCphd);
+
+    XMLElem addedParametersXML = getOptional(channelXML, "AddedParameters");
+    if(addedParametersXML)
+    {
+        mCommon.parseParameters(addedParametersXML, "Parameter", channel.addedParameters);
+    }
+}
 }
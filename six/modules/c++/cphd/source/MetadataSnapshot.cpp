@@ -0,0 +1,647 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cphd/MetadataSnapshot.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include <except/Exception.h>
+#include <six/MetadataSnapshot.h>
+#include <six/sicd/MetadataSnapshot.h>
+
+namespace
+{
+const char SNAPSHOT_IDENTIFIER[] = "CPHD";
+
+// Keys are written in order, so a snapshot doesn't depend on how the map
+// happened to be hashed
+template <typename T>
+std::vector<std::string> sortedKeys(
+        const std::unordered_map<std::string, T>& map)
+{
+    std::vector<std::string> keys;
+    keys.reserve(map.size());
+    for (const auto& entry : map)
+    {
+        keys.push_back(entry.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+}
+
+namespace cphd
+{
+using six::SnapshotArchive;
+
+// These are static, but they need to be in cphd so that the archive can
+// find them by argument dependent lookup.  Each is defined before the
+// types that contain it.
+static void snapshot(SnapshotArchive& archive, Timeline& timeline)
+{
+    archive(timeline.collectionStart, timeline.rcvCollectionStart,
+            timeline.txTime1, timeline.txTime2);
+}
+
+static void snapshot(SnapshotArchive& archive, FxBand& fxBand)
+{
+    archive(fxBand.fxMin, fxBand.fxMax);
+}
+
+static void snapshot(SnapshotArchive& archive, TOASwath& toaSwath)
+{
+    archive(toaSwath.toaMin, toaSwath.toaMax);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     TropoParameters& tropoParameters)
+{
+    archive(tropoParameters.n0, tropoParameters.refHeight);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     IonoParameters& ionoParameters)
+{
+    archive(ionoParameters.tecv, ionoParameters.f2Height);
+}
+
+static void snapshot(SnapshotArchive& archive, Global& global)
+{
+    archive(global.domainType,
+            global.sgn,
+            global.timeline,
+            global.fxBand,
+            global.toaSwath,
+            global.tropoParameters,
+            global.ionoParameters);
+}
+
+static void snapshot(SnapshotArchive& archive, IARP& iarp)
+{
+    archive(iarp.ecf, iarp.llh);
+}
+
+static void snapshot(SnapshotArchive& archive, Planar& planar)
+{
+    archive(planar.uIax, planar.uIay);
+}
+
+static void snapshot(SnapshotArchive& archive, HAE& hae)
+{
+    archive(hae.uIax, hae.uIay);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ReferenceSurface& referenceSurface)
+{
+    archive(referenceSurface.planar, referenceSurface.hae);
+}
+
+static void snapshot(SnapshotArchive& archive, AreaType& area)
+{
+    archive(area.x1y1, area.x2y2, area.polygon);
+}
+
+static void snapshot(SnapshotArchive& archive, LineSample& lineSample)
+{
+    size_t index = lineSample.getIndex();
+    archive(lineSample.line, lineSample.sample, index);
+    lineSample.setIndex(index);
+}
+
+static void snapshot(SnapshotArchive& archive, ImageAreaXExtent& extent)
+{
+    archive(extent.lineSpacing, extent.firstLine, extent.numLines);
+}
+
+static void snapshot(SnapshotArchive& archive, ImageAreaYExtent& extent)
+{
+    archive(extent.sampleSpacing, extent.firstSample, extent.numSamples);
+}
+
+static void snapshot(SnapshotArchive& archive, Segment& segment)
+{
+    archive(segment.startLine,
+            segment.startSample,
+            segment.endLine,
+            segment.endSample,
+            segment.identifier,
+            segment.polygon);
+}
+
+static void snapshot(SnapshotArchive& archive, ImageGrid& imageGrid)
+{
+    archive(imageGrid.identifier,
+            imageGrid.iarpLocation,
+            imageGrid.xExtent,
+            imageGrid.yExtent,
+            imageGrid.segments);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     SceneCoordinates& sceneCoordinates)
+{
+    archive(sceneCoordinates.earthModel,
+            sceneCoordinates.iarp,
+            sceneCoordinates.referenceSurface,
+            sceneCoordinates.imageArea,
+            sceneCoordinates.imageAreaCorners,
+            sceneCoordinates.extendedArea,
+            sceneCoordinates.imageGrid);
+}
+
+static void snapshot(SnapshotArchive& archive, Data::Channel& channel)
+{
+    archive(channel.identifier,
+            channel.numVectors,
+            channel.numSamples,
+            channel.signalArrayByteOffset,
+            channel.pvpArrayByteOffset,
+            channel.compressedSignalSize);
+}
+
+static void snapshot(SnapshotArchive& archive, Data& data)
+{
+    archive(data.signalArrayFormat,
+            data.numBytesPVP,
+            data.channels,
+            data.signalCompressionID);
+
+    // Support arrays go through setSupportArray(), which also checks that
+    // they don't overlap
+    const auto keys = sortedKeys(data.supportArrayMap);
+    const size_t numSupportArrays = archive.count(keys.size());
+    for (size_t ii = 0; ii < numSupportArrays; ++ii)
+    {
+        Data::SupportArray supportArray = archive.isReading() ?
+                Data::SupportArray() : data.supportArrayMap.at(keys[ii]);
+        archive(supportArray.identifier,
+                supportArray.numRows,
+                supportArray.numCols,
+                supportArray.bytesPerElement,
+                supportArray.arrayByteOffset);
+        if (archive.isReading())
+        {
+            data.setSupportArray(supportArray.identifier,
+                                 supportArray.numRows,
+                                 supportArray.numCols,
+                                 supportArray.bytesPerElement,
+                                 supportArray.arrayByteOffset);
+        }
+    }
+}
+
+static void snapshot(SnapshotArchive& archive, Polarization& polarization)
+{
+    archive(polarization.txPol, polarization.rcvPol);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     TOAExtended::LFMEclipse& lfmEclipse)
+{
+    archive(lfmEclipse.fxEarlyLow,
+            lfmEclipse.fxEarlyHigh,
+            lfmEclipse.fxLateLow,
+            lfmEclipse.fxLateHigh);
+}
+
+static void snapshot(SnapshotArchive& archive, TOAExtended& toaExtended)
+{
+    archive(toaExtended.toaExtSaved, toaExtended.lfmEclipse);
+}
+
+static void snapshot(SnapshotArchive& archive, DwellTimes& dwellTimes)
+{
+    archive(dwellTimes.codId, dwellTimes.dwellId);
+}
+
+static void snapshot(SnapshotArchive& archive, TgtRefLevel& tgtRefLevel)
+{
+    archive(tgtRefLevel.ptRef);
+}
+
+static void snapshot(SnapshotArchive& archive, Point& point)
+{
+    archive(point.fx, point.pn);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     FxNoiseProfile& fxNoiseProfile)
+{
+    archive(fxNoiseProfile.point);
+}
+
+static void snapshot(SnapshotArchive& archive, NoiseLevel& noiseLevel)
+{
+    archive(noiseLevel.pnRef, noiseLevel.bnRef, noiseLevel.fxNoiseProfile);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ChannelParameter::TxRcv& txRcv)
+{
+    archive(txRcv.txWFId, txRcv.rcvId);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ChannelParameter::Antenna& antenna)
+{
+    archive(antenna.txAPCId,
+            antenna.txAPATId,
+            antenna.rcvAPCId,
+            antenna.rcvAPATId);
+}
+
+static void snapshot(SnapshotArchive& archive, ChannelParameter& parameter)
+{
+    archive(parameter.identifier,
+            parameter.refVectorIndex,
+            parameter.fxFixed,
+            parameter.toaFixed,
+            parameter.srpFixed,
+            parameter.signalNormal,
+            parameter.polarization,
+            parameter.fxC,
+            parameter.fxBW,
+            parameter.fxBWNoise,
+            parameter.toaSaved,
+            parameter.dwellTimes,
+            parameter.imageArea,
+            parameter.toaExtended,
+            parameter.antenna,
+            parameter.txRcv,
+            parameter.tgtRefLevel,
+            parameter.noiseLevel);
+}
+
+static void snapshot(SnapshotArchive& archive, Channel& channel)
+{
+    archive(channel.refChId,
+            channel.fxFixedCphd,
+            channel.toaFixedCphd,
+            channel.srpFixedCphd,
+            channel.parameters,
+            channel.addedParameters);
+}
+
+// Offsets go through Pvp::setOffset(), which keeps track of which words
+// are in use
+static void snapshot(SnapshotArchive& archive, Pvp& pvp, PVPType& param)
+{
+    size_t size = param.getSize();
+    size_t offset = param.getOffset();
+    std::string format = param.getFormat();
+    archive(size, offset, format);
+    if (archive.isReading())
+    {
+        param.setSize(size);
+        param.setFormat(format);
+        if (six::Init::isUndefined(offset))
+        {
+            param.setOffset(offset);
+        }
+        else
+        {
+            pvp.setOffset(offset, param);
+        }
+    }
+}
+
+static void snapshot(SnapshotArchive& archive, Pvp& pvp)
+{
+    for (PVPType* param : { &pvp.txTime, &pvp.txPos, &pvp.txVel,
+                            &pvp.rcvTime, &pvp.rcvPos, &pvp.rcvVel,
+                            &pvp.srpPos, &pvp.ampSF, &pvp.aFDOP,
+                            &pvp.aFRR1, &pvp.aFRR2, &pvp.fx1, &pvp.fx2,
+                            &pvp.fxN1, &pvp.fxN2, &pvp.toa1, &pvp.toa2,
+                            &pvp.toaE1, &pvp.toaE2, &pvp.tdTropoSRP,
+                            &pvp.tdIonoSRP, &pvp.sc0, &pvp.scss,
+                            &pvp.signal })
+    {
+        snapshot(archive, pvp, *param);
+    }
+
+    const size_t numAdded = archive.count(pvp.addedPVP.size());
+    auto it = pvp.addedPVP.begin();
+    for (size_t ii = 0; ii < numAdded; ++ii)
+    {
+        APVPType param = archive.isReading() ? APVPType() : (it++)->second;
+        size_t size = param.getSize();
+        size_t offset = param.getOffset();
+        std::string format = param.getFormat();
+        std::string name = param.getName();
+        archive(size, offset, format, name);
+        if (archive.isReading())
+        {
+            pvp.setCustomParameter(size, offset, format, name);
+        }
+    }
+}
+
+static void snapshot(SnapshotArchive& archive, COD& cod)
+{
+    archive(cod.identifier, cod.codTimePoly);
+}
+
+static void snapshot(SnapshotArchive& archive, DwellTime& dwellTime)
+{
+    archive(dwellTime.identifier, dwellTime.dwellTimePoly);
+}
+
+static void snapshot(SnapshotArchive& archive, Dwell& dwell)
+{
+    archive(dwell.cod, dwell.dtime);
+}
+
+static void snapshot(SnapshotArchive& archive, SRP& srp)
+{
+    archive(srp.ecf, srp.iac);
+}
+
+static void snapshot(SnapshotArchive& archive, ImagingType& imagingType)
+{
+    archive(imagingType.azimuthAngle,
+            imagingType.grazeAngle,
+            imagingType.twistAngle,
+            imagingType.slopeAngle,
+            imagingType.layoverAngle);
+}
+
+static void snapshot(SnapshotArchive& archive, Monostatic& monostatic)
+{
+    snapshot(archive, static_cast<ImagingType&>(monostatic));
+    archive(monostatic.sideOfTrack,
+            monostatic.slantRange,
+            monostatic.groundRange,
+            monostatic.dopplerConeAngle,
+            monostatic.incidenceAngle,
+            monostatic.arpPos,
+            monostatic.arpVel);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     Bistatic::PlatformParams& platform)
+{
+    archive(platform.sideOfTrack,
+            platform.time,
+            platform.azimuthAngle,
+            platform.grazeAngle,
+            platform.incidenceAngle,
+            platform.dopplerConeAngle,
+            platform.groundRange,
+            platform.slantRange,
+            platform.pos,
+            platform.vel);
+}
+
+static void snapshot(SnapshotArchive& archive, Bistatic& bistatic)
+{
+    snapshot(archive, static_cast<ImagingType&>(bistatic));
+    archive(bistatic.azimuthAngleRate,
+            bistatic.bistaticAngle,
+            bistatic.bistaticAngleRate,
+            bistatic.txPlatform,
+            bistatic.rcvPlatform);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ReferenceGeometry& referenceGeometry)
+{
+    archive(referenceGeometry.referenceTime,
+            referenceGeometry.srpCODTime,
+            referenceGeometry.srpDwellTime,
+            referenceGeometry.srp,
+            referenceGeometry.monostatic,
+            referenceGeometry.bistatic);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     SupportArrayParameter& parameter)
+{
+    size_t identifier = parameter.getIdentifier();
+    archive(parameter.elementFormat,
+            parameter.x0,
+            parameter.y0,
+            parameter.xSS,
+            parameter.ySS,
+            identifier);
+    parameter.setIdentifier(identifier);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     AdditionalSupportArray& supportArray)
+{
+    snapshot(archive, static_cast<SupportArrayParameter&>(supportArray));
+    archive(supportArray.identifier,
+            supportArray.xUnits,
+            supportArray.yUnits,
+            supportArray.zUnits,
+            supportArray.parameter);
+}
+
+static void snapshot(SnapshotArchive& archive, SupportArray& supportArray)
+{
+    archive(supportArray.iazArray, supportArray.antGainPhase);
+
+    const auto keys = sortedKeys(supportArray.addedSupportArray);
+    const size_t numAdded = archive.count(keys.size());
+    for (size_t ii = 0; ii < numAdded; ++ii)
+    {
+        std::string key = archive.isReading() ? std::string() : keys[ii];
+        archive(key);
+        archive(supportArray.addedSupportArray[key]);
+    }
+    if (supportArray.addedSupportArray.size() != numAdded)
+    {
+        throw except::Exception(Ctxt(
+                "Metadata snapshot has duplicate support arrays"));
+    }
+}
+
+static void snapshot(SnapshotArchive& archive, AntCoordFrame& frame)
+{
+    archive(frame.identifier, frame.xAxisPoly, frame.yAxisPoly);
+}
+
+static void snapshot(SnapshotArchive& archive, AntPhaseCenter& phaseCenter)
+{
+    archive(phaseCenter.identifier, phaseCenter.acfId, phaseCenter.apcXYZ);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     AntPattern::GainPhaseArray& gainPhaseArray)
+{
+    archive(gainPhaseArray.freq,
+            gainPhaseArray.arrayId,
+            gainPhaseArray.elementId);
+}
+
+static void snapshot(SnapshotArchive& archive, AntPattern& pattern)
+{
+    archive(pattern.identifier,
+            pattern.freqZero,
+            pattern.gainZero,
+            pattern.ebFreqShift,
+            pattern.mlFreqDilation,
+            pattern.gainBSPoly,
+            pattern.eb,
+            pattern.array,
+            pattern.element,
+            pattern.gainPhaseArray);
+}
+
+static void snapshot(SnapshotArchive& archive, Antenna& antenna)
+{
+    archive(antenna.antCoordFrame, antenna.antPhaseCenter,
+            antenna.antPattern);
+}
+
+static void snapshot(SnapshotArchive& archive, ParameterType& parameter)
+{
+    archive(parameter.identifier,
+            parameter.freqCenter,
+            parameter.lfmRate,
+            parameter.polarization);
+}
+
+static void snapshot(SnapshotArchive& archive, TxWFParameters& parameters)
+{
+    snapshot(archive, static_cast<ParameterType&>(parameters));
+    archive(parameters.pulseLength, parameters.rfBandwidth,
+            parameters.power);
+}
+
+static void snapshot(SnapshotArchive& archive, RcvParameters& parameters)
+{
+    snapshot(archive, static_cast<ParameterType&>(parameters));
+    archive(parameters.windowLength,
+            parameters.sampleRate,
+            parameters.ifFilterBW,
+            parameters.pathGain);
+}
+
+static void snapshot(SnapshotArchive& archive, TxRcv& txRcv)
+{
+    archive(txRcv.txWFParameters, txRcv.rcvParameters);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ErrorParameters::Monostatic::RadarSensor& radarSensor)
+{
+    archive(radarSensor.rangeBias,
+            radarSensor.clockFreqSF,
+            radarSensor.collectionStartTime,
+            radarSensor.rangeBiasDecorr);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ErrorParameters::Monostatic& monostatic)
+{
+    archive(monostatic.posVelErr,
+            monostatic.radarSensor,
+            monostatic.tropoError,
+            monostatic.ionoError,
+            monostatic.parameter);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ErrorParameters::Bistatic::RadarSensor& radarSensor)
+{
+    archive(radarSensor.clockFreqSF, radarSensor.collectionStartTime);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ErrorParameters::Bistatic::Platform& platform)
+{
+    archive(platform.posVelErr, platform.radarSensor);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ErrorParameters::Bistatic& bistatic)
+{
+    archive(bistatic.txPlatform, bistatic.rcvPlatform, bistatic.parameter);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ErrorParameters& errorParameters)
+{
+    archive(errorParameters.monostatic, errorParameters.bistatic);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ProductInfo::CreationInfo& creationInfo)
+{
+    archive(creationInfo.application,
+            creationInfo.dateTime,
+            creationInfo.site,
+            creationInfo.parameter);
+}
+
+static void snapshot(SnapshotArchive& archive, ProductInfo& productInfo)
+{
+    archive(productInfo.profile,
+            productInfo.creationInfo,
+            productInfo.parameter);
+}
+
+static void snapshot(SnapshotArchive& archive, Metadata& metadata)
+{
+    std::string version = metadata.getVersion();
+    archive(version);
+    metadata.setVersion(version);
+
+    archive(metadata.collectionID,
+            metadata.global,
+            metadata.sceneCoordinates,
+            metadata.data,
+            metadata.channel,
+            metadata.pvp,
+            metadata.dwell,
+            metadata.referenceGeometry,
+            metadata.supportArray,
+            metadata.antenna,
+            metadata.txRcv,
+            metadata.errorParameters,
+            metadata.productInfo,
+            metadata.geoInfo,
+            metadata.matchInfo);
+}
+
+void serializeSnapshot(const Metadata& metadata,
+                       std::vector<std::byte>& buffer)
+{
+    SnapshotArchive archive(SNAPSHOT_IDENTIFIER, buffer);
+
+    // Writing only reads the fields
+    archive(const_cast<Metadata&>(metadata));
+}
+
+std::unique_ptr<Metadata>
+deserializeSnapshot(std::span<const std::byte> buffer)
+{
+    SnapshotArchive archive(SNAPSHOT_IDENTIFIER, buffer);
+    auto metadata = std::make_unique<Metadata>();
+    archive(*metadata);
+    archive.finish();
+    return metadata;
+}
+}
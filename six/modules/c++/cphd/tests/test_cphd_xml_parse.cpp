@@ -0,0 +1,235 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <scene/sys_Conf.h>
+#include <cli/ArgumentParser.h>
+#include <io/FileInputStream.h>
+#include <io/FileOutputStream.h>
+#include <io/StringStream.h>
+#include <logging/NullLogger.h>
+
+#include <six/XmlLite.h>
+#include <cphd/CPHDXMLControl.h>
+#include <cphd/Metadata.h>
+
+/*!
+ * Times parsing CPHD XML to Metadata through a DOM and by streaming, and
+ * reports the peak memory of the process.  Run each mode in its own
+ * process to compare peak memory.
+ *
+ * To make large metadata, pass --channels and --output: the channels and
+ * TxRcv parameters of the input are repeated and the result is written to
+ * the output file.
+ */
+namespace
+{
+std::string readFile(const std::string& pathname)
+{
+    io::FileInputStream ifs(pathname);
+    io::StringStream contents;
+    ifs.streamTo(contents);
+    return contents.stream().str();
+}
+
+// Peak resident set size in KB, if known
+long getPeakMemory()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return usage.ru_maxrss;
+    }
+#endif
+    return -1;
+}
+
+std::unique_ptr<cphd::Metadata> parseDOM(const std::string& xml)
+{
+    io::StringStream stream;
+    stream.write(xml.c_str(), xml.size());
+
+    six::MinidomParser xmlParser;
+    xmlParser.preserveCharacterData(true);
+    xmlParser.parse(stream, static_cast<int>(xml.size()));
+
+    cphd::CPHDXMLControl xmlControl(new logging::NullLogger(), true);
+    return std::make_unique<cphd::Metadata>(
+            xmlControl.fromXML(xmlParser.getDocument()));
+}
+
+std::unique_ptr<cphd::Metadata> parseStream(const std::string& xml)
+{
+    io::StringStream stream;
+    stream.write(xml.c_str(), xml.size());
+
+    cphd::CPHDXMLControl xmlControl(new logging::NullLogger(), true);
+    return xmlControl.fromXMLStream(stream, static_cast<int>(xml.size()));
+}
+
+template <typename ParseT>
+std::unique_ptr<cphd::Metadata> timeParse(const std::string& name,
+                                          const std::string& xml,
+                                          size_t iterations,
+                                          ParseT parse)
+{
+    std::unique_ptr<cphd::Metadata> metadata;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t ii = 0; ii < iterations; ++ii)
+    {
+        metadata = parse(xml);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const std::chrono::duration<double, std::milli> elapsed = end - start;
+    std::cout << name << ": " << elapsed.count() / iterations
+              << " ms per parse, peak memory " << getPeakMemory()
+              << " KB\n";
+    return metadata;
+}
+
+void repeat(cphd::Metadata& metadata, size_t numChannels)
+{
+    const cphd::Data::Channel dataChannel = metadata.data.channels.at(0);
+    const cphd::ChannelParameter parameter = metadata.channel.parameters.at(0);
+    metadata.data.channels.clear();
+    metadata.channel.parameters.clear();
+    for (size_t ii = 0; ii < numChannels; ++ii)
+    {
+        const std::string id = "Channel" + std::to_string(ii);
+        metadata.data.channels.push_back(dataChannel);
+        metadata.data.channels.back().identifier = id;
+        metadata.channel.parameters.push_back(parameter);
+        metadata.channel.parameters.back().identifier = id;
+    }
+
+    if (metadata.txRcv.get() &&
+        !metadata.txRcv->txWFParameters.empty() &&
+        !metadata.txRcv->rcvParameters.empty())
+    {
+        const cphd::TxWFParameters txWF = metadata.txRcv->txWFParameters[0];
+        const cphd::RcvParameters rcv = metadata.txRcv->rcvParameters[0];
+        metadata.txRcv->txWFParameters.assign(numChannels, txWF);
+        metadata.txRcv->rcvParameters.assign(numChannels, rcv);
+        for (size_t ii = 0; ii < numChannels; ++ii)
+        {
+            metadata.txRcv->txWFParameters[ii].identifier =
+                    "TxWF" + std::to_string(ii);
+            metadata.txRcv->rcvParameters[ii].identifier =
+                    "Rcv" + std::to_string(ii);
+        }
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        // Parse the command line
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Time parsing CPHD XML through a DOM and by streaming.");
+        parser.addArgument("-m --mode", "Parser(s) to time", cli::STORE,
+                           "mode", "MODE")->addChoice("dom")
+                ->addChoice("stream")->addChoice("both")->setDefault("both");
+        parser.addArgument("-i --iterations", "Number of times to parse",
+                           cli::STORE, "iterations", "NUM")->setDefault(1);
+        parser.addArgument("-c --channels",
+                           "Repeat the input's channels this many times",
+                           cli::STORE, "channels", "NUM")->setDefault(0);
+        parser.addArgument("-o --output",
+                           "Write the repeated XML here instead of timing",
+                           cli::STORE, "output", "XML")->setDefault("");
+        parser.addArgument("input", "Input CPHD XML pathname", cli::STORE,
+                           "input", "XML", 1, 1);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+        const std::string inPathname(options->get<std::string>("input"));
+        const std::string mode(options->get<std::string>("mode"));
+        const size_t iterations(options->get<size_t>("iterations"));
+        const size_t numChannels(options->get<size_t>("channels"));
+        const std::string outPathname(options->get<std::string>("output"));
+
+        const std::string xml = readFile(inPathname);
+
+        if (numChannels > 0)
+        {
+            if (outPathname.empty())
+            {
+                throw except::Exception(Ctxt(
+                        "--channels requires --output"));
+            }
+            std::unique_ptr<cphd::Metadata> metadata = parseDOM(xml);
+            repeat(*metadata, numChannels);
+
+            cphd::CPHDXMLControl xmlControl(new logging::NullLogger(), true);
+            const std::string repeated = xmlControl.toXMLString(*metadata);
+            io::FileOutputStream ofs(outPathname);
+            ofs.write(repeated.c_str(), repeated.size());
+            std::cout << "Wrote " << numChannels << " channels ("
+                      << repeated.size() << " bytes) to " << outPathname
+                      << "\n";
+            return 0;
+        }
+
+        std::cout << "Parsing " << xml.size() << " bytes of XML\n";
+        std::unique_ptr<cphd::Metadata> domMetadata;
+        std::unique_ptr<cphd::Metadata> streamMetadata;
+        if (mode != "stream")
+        {
+            domMetadata = timeParse("DOM", xml, iterations, parseDOM);
+        }
+        if (mode != "dom")
+        {
+            streamMetadata = timeParse("Stream", xml, iterations, parseStream);
+        }
+
+        if (domMetadata.get() && streamMetadata.get() &&
+            !(*domMetadata == *streamMetadata))
+        {
+            std::cerr << "Metadata are not equal\n";
+            return 1;
+        }
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception\n";
+    }
+    return 1;
+}
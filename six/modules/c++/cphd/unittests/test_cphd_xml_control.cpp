@@ -26,8 +26,10 @@
 #include <cphd/CPHDXMLControl.h>
 #include <cphd/Global.h>
 #include <cphd/Metadata.h>
+#include <cphd/MetadataSnapshot.h>
 #include <cphd/SceneCoordinates.h>
 #include <io/StringStream.h>
+#include <six/MetadataSnapshot.h>
 #include <xml/lite/MinidomParser.h>
 #include "TestCase.h"
 
@@ -1172,7 +1174,108 @@ TEST_CASE(testReadXML)
     }
 }
 
+TEST_CASE(testStreamXML)
+{
+    for (auto pair : cphd::CPHDXMLControl::getVersionUriMap())
+    {
+        auto& version = pair.first;
+        const auto xmlString = testCPHDXML(version);
+
+        io::StringStream domStream;
+        domStream.write(xmlString.c_str(), xmlString.size());
+        xml::lite::MinidomParser xmlParser;
+        xmlParser.preserveCharacterData(true);
+        xmlParser.parse(domStream, domStream.available());
+        const std::unique_ptr<cphd::Metadata> expected =
+                cphd::CPHDXMLControl().fromXML(xmlParser.getDocument());
+
+        io::StringStream stream;
+        stream.write(xmlString.c_str(), xmlString.size());
+        const std::unique_ptr<cphd::Metadata> metadata =
+                cphd::CPHDXMLControl().fromXMLStream(stream,
+                                                     stream.available());
+
+        TEST_ASSERT_EQ(metadata->getVersion(), version);
+        TEST_ASSERT_EQ(metadata->data.getNumChannels(), static_cast<size_t>(2));
+        TEST_ASSERT_EQ(metadata->txRcv->rcvParameters.size(), static_cast<size_t>(2));
+        TEST_ASSERT_TRUE(*metadata == *expected);
+    }
+}
+
+TEST_CASE(testStreamXMLErrors)
+{
+    const auto xmlString = testCPHDXML("1.0.1");
+
+    // Wrong number of RcvParameters
+    std::string badCount = xmlString;
+    const std::string numRcvs = "<NumRcvs>2</NumRcvs>";
+    badCount.replace(badCount.find(numRcvs), numRcvs.size(),
+                     "<NumRcvs>3</NumRcvs>");
+    io::StringStream badCountStream;
+    badCountStream.write(badCount.c_str(), badCount.size());
+    TEST_EXCEPTION(cphd::CPHDXMLControl().fromXMLStream(
+            badCountStream, badCountStream.available()));
+
+    // Repeated required section
+    std::string repeated = xmlString;
+    const size_t start = repeated.find("    <Global>");
+    const size_t end = repeated.find("</Global>\n") + 10;
+    repeated.insert(end, repeated.substr(start, end - start));
+    io::StringStream repeatedStream;
+    repeatedStream.write(repeated.c_str(), repeated.size());
+    TEST_EXCEPTION(cphd::CPHDXMLControl().fromXMLStream(
+            repeatedStream, repeatedStream.available()));
+}
+
+TEST_CASE(testSnapshot)
+{
+    for (auto pair : cphd::CPHDXMLControl::getVersionUriMap())
+    {
+        auto& version = pair.first;
+        const auto xmlString = testCPHDXML(version);
+
+        io::StringStream stream;
+        stream.write(xmlString.c_str(), xmlString.size());
+        xml::lite::MinidomParser xmlParser;
+        xmlParser.preserveCharacterData(true);
+        xmlParser.parse(stream, stream.available());
+        const std::unique_ptr<cphd::Metadata> expected =
+                cphd::CPHDXMLControl().fromXML(xmlParser.getDocument());
+
+        std::vector<std::byte> snapshot;
+        cphd::serializeSnapshot(*expected, snapshot);
+        const std::unique_ptr<cphd::Metadata> metadata = cphd::deserializeSnapshot(
+                std::span<const std::byte>(snapshot.data(), snapshot.size()));
+
+        TEST_ASSERT_EQ(metadata->getVersion(), version);
+        TEST_ASSERT_TRUE(*metadata == *expected);
+        TEST_ASSERT_TRUE(cphd::CPHDXMLControl().toXMLString(*metadata) ==
+                         cphd::CPHDXMLControl().toXMLString(*expected));
+        std::vector<std::byte> again;
+        cphd::serializeSnapshot(*metadata, again);
+        TEST_ASSERT_TRUE(again == snapshot);
+
+        // A truncated snapshot, extra bytes, or a snapshot of something
+        // else is an error
+        for (const size_t size : { static_cast<size_t>(4), snapshot.size() / 2, snapshot.size() - 1 })
+        {
+            TEST_EXCEPTION(cphd::deserializeSnapshot(
+                    std::span<const std::byte>(snapshot.data(), size)));
+        }
+        snapshot.push_back(std::byte(0));
+        TEST_EXCEPTION(cphd::deserializeSnapshot(
+                std::span<const std::byte>(snapshot.data(), snapshot.size())));
+        std::vector<std::byte> sicdSnapshot;
+        const six::SnapshotArchive sicdHeader("COMPLEX", sicdSnapshot);
+        TEST_EXCEPTION(cphd::deserializeSnapshot(
+                std::span<const std::byte>(sicdSnapshot.data(), sicdSnapshot.size())));
+    }
+}
+
 TEST_MAIN(
     TEST_CHECK(testVersions);
     TEST_CHECK(testReadXML);
+    TEST_CHECK(testStreamXML);
+    TEST_CHECK(testStreamXMLErrors);
+    TEST_CHECK(testSnapshot);
 )
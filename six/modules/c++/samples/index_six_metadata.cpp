@@ -0,0 +1,179 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <std/memory>
+
+#include <import/cli.h>
+#include <import/io.h>
+#include <import/six.h>
+#include <import/six/sicd.h>
+#include <import/six/sidd.h>
+#include <sys/FileFinder.h>
+#include <cphd/CPHDMetadataSummarizer.h>
+
+namespace
+{
+// Adds the polarization, which six::Data doesn't have
+class SICDAndSIDDSummarizer final : public six::NITFMetadataSummarizer
+{
+protected:
+    void summarize(const six::Data& data,
+                   six::MetadataSummary& summary) const override
+    {
+        six::NITFMetadataSummarizer::summarize(data, summary);
+
+        std::vector<std::string> polarizations;
+        if (data.getDataType() == six::DataType::COMPLEX)
+        {
+            const auto& complexData =
+                    dynamic_cast<const six::sicd::ComplexData&>(data);
+            if (complexData.radarCollection.get())
+            {
+                for (const auto& channel :
+                     complexData.radarCollection->rcvChannels)
+                {
+                    polarizations.push_back(
+                            six::toString(channel->txRcvPolarization));
+                }
+            }
+        }
+        else if (data.getDataType() == six::DataType::DERIVED)
+        {
+            const auto& derivedData =
+                    dynamic_cast<const six::sidd::DerivedData&>(data);
+            if (derivedData.exploitationFeatures.get())
+            {
+                for (const auto& collection :
+                     derivedData.exploitationFeatures->collections)
+                {
+                    for (const auto& polarization :
+                         collection->information.polarization)
+                    {
+                        polarizations.push_back(
+                                polarization->txPolarization.toString() +
+                                ':' +
+                                polarization->rcvPolarization.toString());
+                    }
+                }
+            }
+        }
+        summary[six::MetadataField::POLARIZATION] =
+                str::join(polarizations, " ");
+    }
+};
+
+std::vector<std::string> findFiles(const std::vector<std::string>& inputs)
+{
+    std::vector<std::string> pathnames;
+    for (const auto& input : inputs)
+    {
+        if (sys::OS().isDirectory(input))
+        {
+            const std::vector<std::string> found = sys::FileFinder::search(
+                    sys::FileOnlyPredicate(), {input}, true);
+            pathnames.insert(pathnames.end(), found.begin(), found.end());
+        }
+        else
+        {
+            pathnames.push_back(input);
+        }
+    }
+    return pathnames;
+}
+}
+
+/*!
+ *  Builds a columnar index of the metadata in SICD, SIDD and CPHD files
+ */
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Index the metadata of SICDs, SIDDs and CPHDs. Each file is "
+                "opened for its metadata only. Directories are searched "
+                "recursively.");
+        parser.addArgument("-t --threads", "Number of files to open at once",
+                           cli::STORE, "threads", "NUM")->
+                setDefault(std::max<size_t>(
+                        std::thread::hardware_concurrency(), 1));
+        parser.addArgument("-f --fields",
+                           "Comma-separated fields to index (default: all of "
+                           "them)",
+                           cli::STORE, "fields", "FIELDS")->setDefault("");
+        parser.addArgument("-o --output", "Index file to write", cli::STORE,
+                           "output", "FILE", 1, 1, true);
+        parser.addArgument("input", "Input files and directories", cli::STORE,
+                           "input", "INPUT", 1, -1);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+
+        const size_t numThreads = options->get<size_t>("threads");
+        const std::string fieldsStr = options->get<std::string>("fields");
+        const std::vector<std::string> fields = fieldsStr.empty() ?
+                six::MetadataField::getAll() : str::split(fieldsStr, ",");
+
+        std::vector<std::string> inputs;
+        const cli::Value* const inputValues = options->getValue("input");
+        for (size_t ii = 0; ii < inputValues->size(); ++ii)
+        {
+            inputs.push_back(inputValues->get<std::string>(ii));
+        }
+        const std::vector<std::string> pathnames = findFiles(inputs);
+
+        six::XMLControlFactory::getInstance().addCreator<six::sicd::ComplexXMLControl>();
+        six::XMLControlFactory::getInstance().addCreator<six::sidd::DerivedXMLControl>();
+
+        six::MetadataIndexer indexer(fields, numThreads);
+        indexer.addSummarizer(std::make_unique<SICDAndSIDDSummarizer>());
+        indexer.addSummarizer(std::make_unique<cphd::CPHDMetadataSummarizer>());
+
+        six::MetadataIndexStatistics stats;
+        const six::MetadataIndex index = indexer.index(pathnames, &stats);
+
+        io::FileOutputStream outStream(options->get<std::string>("output"));
+        index.write(outStream);
+        outStream.close();
+
+        std::cout << "Files: " << stats.numFiles
+                  << ", failed: " << stats.numFailed
+                  << ", products: " << stats.numProducts << "\n"
+                  << "Open time (ms) min: " << stats.minOpenTime
+                  << ", mean: " << stats.meanOpenTime
+                  << ", max: " << stats.maxOpenTime << "\n"
+                  << "Total time: " << stats.elapsedTime << " ms\n";
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
@@ -176,6 +176,9 @@ int main(int argc, char** argv)
                            "rowsPerBlock", "ROWS_PER_BLOCK");
         parser.addArgument("--colsPerBlock", "Max cols per block", cli::STORE,
                            "colsPerBlock", "COLS_PER_BLOCK");
+        parser.addArgument("--blockingThreads",
+                           "Block on this many threads (0 for one per CPU)",
+                           cli::STORE, "blockingThreads", "THREADS");
         parser.addArgument("--size", "Max image segment size", cli::STORE,
                            "maxSize", "BYTES");
         parser.addArgument("--version", "Version", cli::STORE,
@@ -248,6 +251,12 @@ int main(int argc, char** argv)
             colsPerBlock = options->get<std::string>("colsPerBlock");
         }
 
+        std::string blockingThreads;
+        if (options->hasValue("blockingThreads"))
+        {
+            blockingThreads = options->get<std::string>("blockingThreads");
+        }
+
         std::string version;
         if (options->hasValue("version"))
         {
@@ -384,6 +393,13 @@ int main(int argc, char** argv)
                     colsPerBlock);
         }
 
+        if (!blockingThreads.empty())
+        {
+            writerOptions.setParameter(
+                    six::NITFWriteControl::OPT_NUM_BLOCKING_THREADS,
+                    blockingThreads);
+        }
+
         six::NITFWriteControl writer(writerOptions, container, &xmlRegistry);
         writer.setLogger(log);
         writer.save(buffers.get(), outputFile, schemaPaths);
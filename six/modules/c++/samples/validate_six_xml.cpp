@@ -0,0 +1,152 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <std/filesystem>
+#include <std/memory>
+
+#include <import/cli.h>
+#include <import/six.h>
+#include <sys/FileFinder.h>
+#include <six/BatchValidator.h>
+#include <cphd/CPHDXMLDocumentExtractor.h>
+
+namespace
+{
+std::vector<std::string> findFiles(const std::vector<std::string>& inputs)
+{
+    std::vector<std::string> pathnames;
+    for (const auto& input : inputs)
+    {
+        if (sys::OS().isDirectory(input))
+        {
+            const std::vector<std::string> found = sys::FileFinder::search(
+                    sys::FileOnlyPredicate(), {input}, true);
+            pathnames.insert(pathnames.end(), found.begin(), found.end());
+        }
+        else
+        {
+            pathnames.push_back(input);
+        }
+    }
+    return pathnames;
+}
+
+std::vector<std::string> getValues(const cli::Results& options,
+                                   const std::string& name)
+{
+    std::vector<std::string> values;
+    if (options.hasValue(name))
+    {
+        const cli::Value* const value = options.getValue(name);
+        for (size_t ii = 0; ii < value->size(); ++ii)
+        {
+            values.push_back(value->get<std::string>(ii));
+        }
+    }
+    return values;
+}
+}
+
+/*!
+ *  Validates the XML in SICDs, SIDDs, CPHDs and XML files against their
+ *  schemas.  Each line of output is tab-separated: the document, then
+ *  VALID, INVALID or FAILED, then either why it failed or, for each
+ *  error, its level, line and message.
+ */
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Validate the XML of SICDs, SIDDs, CPHDs and XML files "
+                "against their schemas. The XML isn't parsed into six data "
+                "structures. Directories are searched recursively.");
+        parser.addArgument("-t --threads",
+                           "Number of files to validate at once",
+                           cli::STORE, "threads", "NUM")->
+                setDefault(std::max<size_t>(
+                        std::thread::hardware_concurrency(), 1));
+        parser.addArgument("-s --schema",
+                           "Schema or directory of schemas (default: "
+                           "SIX_SCHEMA_PATH or the installed schemas)",
+                           cli::STORE, "schema", "FILE", 1, -1);
+        parser.addArgument("input", "Input files and directories", cli::STORE,
+                           "input", "INPUT", 1, -1);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+
+        std::vector<std::string> schemaPaths = getValues(*options, "schema");
+        six::XMLControl::loadSchemaPaths(schemaPaths);
+        const std::vector<std::filesystem::path> schemas(schemaPaths.begin(),
+                                                         schemaPaths.end());
+
+        const std::vector<std::string> pathnames =
+                findFiles(getValues(*options, "input"));
+
+        six::BatchValidator validator(schemas,
+                                      options->get<size_t>("threads"));
+        validator.addExtractor(
+                std::make_unique<six::NITFXMLDocumentExtractor>());
+        validator.addExtractor(
+                std::make_unique<cphd::CPHDXMLDocumentExtractor>());
+        validator.addExtractor(
+                std::make_unique<six::XMLFileDocumentExtractor>());
+
+        bool allValid = true;
+        for (const auto& result : validator.validate(pathnames))
+        {
+            if (!result.failure.empty())
+            {
+                std::cout << result.getID() << "\tFAILED\t" << result.failure
+                          << "\n";
+            }
+            else if (result.errors.empty())
+            {
+                std::cout << result.getID() << "\tVALID\n";
+            }
+            else
+            {
+                for (const auto& error : result.errors)
+                {
+                    std::cout << result.getID() << "\tINVALID\t"
+                              << error.getLevel() << "\t" << error.getLine()
+                              << "\t" << error.getMessage() << "\n";
+                }
+            }
+            allValid = allValid && result.isValid();
+        }
+        return allValid ? 0 : 1;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
@@ -24,6 +24,7 @@
 
 #include <scene/AdjustableParams.h>
 #include <scene/CoordinateTransform.h>
+#include <scene/DEM.h>
 #include <scene/ECEFToLLATransform.h>
 #include <scene/EllipsoidModel.h>
 #include <scene/Errors.h>
@@ -0,0 +1,194 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SCENE_DEM_H__
+#define __SCENE_DEM_H__
+
+#include <stddef.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/File.h>
+#include <types/RowCol.h>
+
+#include "scene/Types.h"
+
+namespace scene
+{
+/*!
+ *  \class DEM
+ *  \brief Digital elevation model interface used for terrain projection
+ *
+ *  Heights are in meters above the WGS-84 ellipsoid (HAE).  Implementations
+ *  must be safe to call from multiple threads at once.
+ */
+struct DEM
+{
+    virtual ~DEM() = default;
+
+    /*!
+     *  \param lat Latitude in degrees
+     *  \param lon Longitude in degrees
+     *  \return Whether the DEM can provide a height at this location
+     */
+    virtual bool contains(double lat, double lon) const = 0;
+
+    /*!
+     *  \param lat Latitude in degrees
+     *  \param lon Longitude in degrees
+     *  \return Height (meters HAE) at this location
+     *  \throws except::Exception if the location is not covered
+     */
+    virtual double getHeight(double lat, double lon) const = 0;
+};
+
+/*!
+ *  \class ConstantHeightDEM
+ *  \brief A DEM that is the same height everywhere
+ *
+ *  Projecting to this is equivalent to the constant height
+ *  ProjectionModel::imageToScene()
+ */
+class ConstantHeightDEM : public DEM
+{
+public:
+    explicit ConstantHeightDEM(double height) :
+        mHeight(height)
+    {
+    }
+
+    bool contains(double , double ) const override
+    {
+        return true;
+    }
+
+    double getHeight(double , double ) const override
+    {
+        return mHeight;
+    }
+
+private:
+    const double mHeight;
+};
+
+/*!
+ *  \class GridDEM
+ *  \brief A DEM of height posts on a regular latitude/longitude grid
+ *
+ *  Post (row, col) is located at
+ *  (origin.lat + row * spacing.lat, origin.lon + col * spacing.lon), so a
+ *  north-up grid has a negative latitude spacing.  Heights between posts
+ *  are bilinearly interpolated.
+ *
+ *  The posts are kept in square tiles which overlap their neighbors by one
+ *  post, so every bilinear sample touches exactly one tile.  When reading
+ *  from a file, tiles are loaded on first use and a bounded number of them
+ *  are kept in a least-recently-used cache, so projecting a neighborhood of
+ *  image points only reads the part of the DEM it needs.
+ */
+class GridDEM : public DEM
+{
+public:
+    static const size_t DEFAULT_TILE_SIZE = 256;
+    static const size_t DEFAULT_MAX_CACHED_TILES = 64;
+
+    /*!
+     *  Constructs a DEM from heights already in memory
+     *
+     *  \param origin Location of post (0, 0) in degrees
+     *  \param spacing Spacing between posts in degrees
+     *  \param dims Number of posts in each direction (each must be >= 2)
+     *  \param heights Row-major heights in meters HAE
+     */
+    GridDEM(const LatLon& origin,
+            const LatLon& spacing,
+            const types::RowCol<size_t>& dims,
+            std::vector<float>&& heights);
+
+    /*!
+     *  Constructs a DEM which reads its heights from a file of row-major,
+     *  native byte order 32-bit floats (meters HAE)
+     *
+     *  \param origin Location of post (0, 0) in degrees
+     *  \param spacing Spacing between posts in degrees
+     *  \param dims Number of posts in each direction (each must be >= 2)
+     *  \param pathname File to read heights from
+     *  \param tileSize Number of posts along each side of a tile
+     *  \param maxCachedTiles Maximum number of tiles to keep in memory
+     */
+    GridDEM(const LatLon& origin,
+            const LatLon& spacing,
+            const types::RowCol<size_t>& dims,
+            const std::string& pathname,
+            size_t tileSize = DEFAULT_TILE_SIZE,
+            size_t maxCachedTiles = DEFAULT_MAX_CACHED_TILES);
+
+    GridDEM(const GridDEM&) = delete;
+    GridDEM& operator=(const GridDEM&) = delete;
+
+    bool contains(double lat, double lon) const override;
+
+    double getHeight(double lat, double lon) const override;
+
+    const types::RowCol<size_t>& getDims() const
+    {
+        return mDims;
+    }
+
+private:
+    typedef std::vector<float> Tile;
+
+    void checkGeometry() const;
+
+    // Continuous (row, col) post coordinates of a location
+    types::RowCol<double> toPostCoordinates(double lat, double lon) const;
+
+    std::shared_ptr<const Tile> getTile(size_t tileRow, size_t tileCol) const;
+
+    std::shared_ptr<const Tile> loadTile(size_t tileRow,
+                                         size_t tileCol) const;
+
+    const LatLon mOrigin;
+    const LatLon mSpacing;
+    const types::RowCol<size_t> mDims;
+    const size_t mTileSize;
+    const size_t mMaxCachedTiles;
+    types::RowCol<size_t> mNumTiles;
+
+    // Only used when reading from a file
+    mutable sys::File mFile;
+    mutable std::mutex mMutex;
+    mutable std::unordered_map<size_t,
+            std::pair<std::shared_ptr<const Tile>,
+                      std::list<size_t>::iterator> > mTiles;
+    mutable std::list<size_t> mRecentlyUsed;
+
+    // Only used when all of the heights are in memory
+    std::shared_ptr<const Tile> mAllHeights;
+};
+}
+
+#endif
@@ -22,6 +22,10 @@
 #ifndef __SCENE_ECEF_TO_LLA_TRANSFORM_H__
 #define __SCENE_ECEF_TO_LLA_TRANSFORM_H__
 
+#include <stddef.h>
+
+#include <std/span>
+
 #include "scene/CoordinateTransform.h"
 
 namespace scene
@@ -55,6 +59,37 @@ struct ECEFToLLATransform : public CoordinateTransform
      */
     LatLonAlt transform(const Vector3& ecef) const;
 
+    /**
+     * This function transforms a batch of ECEF coordinates, stored as
+     * separate X, Y and Z arrays, to latitude/longitude (in degrees) and
+     * altitude.
+     *
+     * Unlike the single point transform() above, this uses the closed-form
+     * solution of Vermeille (2004), so every point costs the same fixed
+     * number of operations and the loop body has no data-dependent
+     * iteration.  For points at or above 1000 km below the ellipsoid
+     * surface the results agree with the iterative transform() to within
+     * 1e-9 degrees in latitude and longitude and 1e-6 in altitude
+     * (in the units of the ellipsoid model).  Points deep enough inside
+     * the ellipsoid that the closed form does not apply (within about
+     * 45 km of its center) fall back to the iterative transform().
+     *
+     * @param x     The ECEF X coordinates
+     * @param y     The ECEF Y coordinates
+     * @param z     The ECEF Z coordinates
+     * @param lat   Output latitudes in degrees
+     * @param lon   Output longitudes in degrees
+     * @param alt   Output altitudes above the ellipsoid
+     * @param numThreads  Number of threads to split the points across
+     */
+    void transform(std::span<const double> x,
+                   std::span<const double> y,
+                   std::span<const double> z,
+                   std::span<double> lat,
+                   std::span<double> lon,
+                   std::span<double> alt,
+                   size_t numThreads = 1) const;
+
 private:
     static double computeLongitude(const Vector3& ecef);
     double computeAltitude(const Vector3& ecef, double latitude) const;
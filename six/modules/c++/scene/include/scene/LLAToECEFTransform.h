@@ -22,9 +22,14 @@
 #ifndef __SCENE_LLA_TO_ECEF_TRANSFORM_H__
 #define __SCENE_LLA_TO_ECEF_TRANSFORM_H__
 
-#include "scene/CoordinateTransform.h"
+#include <stddef.h>
+
 #include <sstream>
 
+#include <std/span>
+
+#include "scene/CoordinateTransform.h"
+
 namespace scene
 {
 
@@ -55,6 +60,31 @@ struct LLAToECEFTransform : public CoordinateTransform
      * @return      A Vector3
      */
     Vector3 transform(const LatLonAlt& lla) const;
+
+    /**
+     * This function transforms a batch of latitude/longitude (in degrees)
+     * and altitude values, stored as separate arrays, to ECEF X, Y and Z
+     * arrays.  This uses the closed-form prime vertical radius of
+     * curvature formulation and is equivalent to calling transform() on
+     * each point, without the per-point LatLonAlt construction.
+     *
+     * @param lat   The latitudes in degrees
+     * @param lon   The longitudes in degrees
+     * @param alt   The altitudes above the ellipsoid
+     * @param x     Output ECEF X coordinates
+     * @param y     Output ECEF Y coordinates
+     * @param z     Output ECEF Z coordinates
+     * @param numThreads  Number of threads to split the points across
+     * @throws except::InvalidFormatException if any latitude is outside of
+     *         [-90, 90] or any longitude is outside of [-180, 180]
+     */
+    void transform(std::span<const double> lat,
+                   std::span<const double> lon,
+                   std::span<const double> alt,
+                   std::span<double> x,
+                   std::span<double> y,
+                   std::span<double> z,
+                   size_t numThreads = 1) const;
 private:
 
     double computeRadius(const LatLonAlt& lla) const;
@@ -0,0 +1,95 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SCENE_POLYNOMIAL_FIT_2D_H__
+#define __SCENE_POLYNOMIAL_FIT_2D_H__
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <math/linear/Matrix2D.h>
+#include <math/poly/TwoD.h>
+
+namespace scene
+{
+/*!
+ * \class PolynomialFit2D
+ * \brief Two-dimensional linear least squares fit which can be reused
+ * for several sets of observations at the same (x, y) locations
+ *
+ * This fits the same polynomial as math::poly::fit(x, y, z, nx, ny): x and
+ * y are centered on their means and scaled by their RMS so neither
+ * dimension dominates.  Rather than inverting the normal equations for
+ * every fit, the design matrix is built and QR factored once in the
+ * constructor.  Each fit() is then just a Householder update and a back
+ * substitution, which is both cheaper and better conditioned.
+ *
+ * Once constructed, fit() may be called from multiple threads at once.
+ */
+class PolynomialFit2D
+{
+public:
+    /*!
+     * \param x Input x coordinates
+     * \param y Input y coordinates.  Must be the same size as x.
+     * \param nx The requested order X of the output polys
+     * \param ny The requested order Y of the output polys
+     * \throw except::Exception if the matrices are not equally sized, there
+     * are not enough points, or the points don't determine a unique fit
+     */
+    PolynomialFit2D(const math::linear::Matrix2D<double>& x,
+                    const math::linear::Matrix2D<double>& y,
+                    size_t nx,
+                    size_t ny);
+
+    /*!
+     * \param z Observed outputs.  z(i, j) is the observation at
+     * (x(i, j), y(i, j)).
+     * \throw except::Exception if z is not the same size as x and y
+     * \return A polynomial, f(x, y) = z
+     */
+    math::poly::TwoD<double> fit(const math::linear::Matrix2D<double>& z) const;
+
+private:
+    const size_t mNumRows;
+    const size_t mNumCols;
+    const size_t mOrderX;
+    const size_t mOrderY;
+    const size_t mNumPoints;
+    const size_t mNumCoeffs;
+
+    // Normalization applied to the inputs
+    double mMeanX;
+    double mMeanY;
+    double mScaleX;
+    double mScaleY;
+
+    // Householder QR factorization of the column-major design matrix.  The
+    // reflection vectors are stored on and below the diagonal and R above
+    // it, with R's diagonal kept separately.
+    std::vector<double> mQR;
+    std::vector<double> mRDiag;
+    std::vector<double> mBeta;
+};
+}
+
+#endif
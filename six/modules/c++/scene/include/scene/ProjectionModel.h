@@ -22,7 +22,10 @@
 #ifndef __SCENE_PROJECTION_MODEL_H__
 #define __SCENE_PROJECTION_MODEL_H__
 
+#include <stddef.h>
+
 #include <std/optional>
+#include <std/span>
 
 #include <math/poly/OneD.h>
 #include <math/poly/TwoD.h>
@@ -31,6 +34,7 @@
 #include <scene/GridECEFTransform.h>
 #include <scene/AdjustableParams.h>
 #include <scene/Errors.h>
+#include <scene/DEM.h>
 
 namespace scene
 {
@@ -140,6 +144,24 @@ public:
         return sceneToImage(scenePoint, AdjustableParams(), oTimeCOA);
     }
 
+    /*!
+     * Same as above but projects a batch of scene points, splitting them
+     * across numThreads threads
+     *
+     *  \param scenePoints Scene (ground) points in 3-space
+     *  \param[out] imageGridPoints Continuous surface image points.  Must
+     *  be the same size as scenePoints.
+     *  \param[out] timeCOA Time COA of each point.  Must be either empty or
+     *  the same size as scenePoints.
+     *  \param numThreads Number of threads to use
+     *  \param delta Delta values to apply for the adjustable parameters
+     */
+    void sceneToImage(std::span<const Vector3> scenePoints,
+                      std::span<types::RowCol<double> > imageGridPoints,
+                      std::span<double> timeCOA,
+                      size_t numThreads = 1,
+                      const AdjustableParams& delta = AdjustableParams()) const;
+
     /*!
      *  Implements (Slant plane) Image to Scene (Ground plane)
      *  projection using computerContour and contourToGroundPlane
@@ -207,6 +229,56 @@ public:
                          double heightThreshold = 1.0,
                          size_t maxNumIters = 3) const;
 
+    /*!
+     * Projects an image point onto the surface of a DEM
+     *
+     * The R/Rdot contour for the image point is computed once.  Each
+     * iteration then projects it to a constant height surface as in the
+     * constant height imageToScene() above, samples the DEM underneath
+     * the result and picks the next height with a safeguarded secant
+     * step, until the projected point is within heightTolerance of the
+     * DEM surface.
+     *
+     *  \param imageGridPoint A point (meters) in the image surface
+     *  (continuous)
+     *  \param dem The terrain to project onto.  Must cover the projected
+     *  point.
+     *  \param delta Delta values to apply for the adjustable parameters
+     *  \param heightTolerance Convergence threshold (meters) between the
+     *  height of the projected point and the DEM height there.  Must be
+     *  positive.
+     *  \param maxNumIters Maximum number of constant height projections
+     *  to perform
+     *
+     *  \return A scene (ground) point in 3 space on the DEM surface
+     *  \throws except::Exception if the projection doesn't converge or
+     *  leaves the DEM
+     */
+    Vector3 imageToScene(const types::RowCol<double>& imageGridPoint,
+                         const DEM& dem,
+                         const AdjustableParams& delta = AdjustableParams(),
+                         double heightTolerance = 0.01,
+                         size_t maxNumIters = 20) const;
+
+    /*!
+     * Same as above but projects a batch of image points, splitting them
+     * across numThreads threads
+     *
+     *  \param imageGridPoints Points (meters) in the image surface
+     *  \param dem The terrain to project onto
+     *  \param[out] scenePoints Projected points.  Must be the same size as
+     *  imageGridPoints.
+     *  \param numThreads Number of threads to use
+     */
+    void imageToScene(
+            std::span<const types::RowCol<double> > imageGridPoints,
+            const DEM& dem,
+            std::span<Vector3> scenePoints,
+            size_t numThreads = 1,
+            const AdjustableParams& delta = AdjustableParams(),
+            double heightTolerance = 0.01,
+            size_t maxNumIters = 20) const;
+
     math::linear::MatrixMxN<2, 2> slantToImagePartials(
             const types::RowCol<double>& imageGridPoint,
             double delta = 0.0001) const;
@@ -348,6 +420,17 @@ protected:
             double earthInitialSpin,
             const types::RowCol<double>& imageGridPoint) const;
 
+    // Steps 1-7 of section 9.1 of SICD Image Projections: projects an
+    // already computed R/Rdot contour to a constant height surface
+    LatLonAlt contourToHAE(double r,
+                           double rDot,
+                           const Vector3& arpCOA,
+                           const Vector3& velCOA,
+                           const LatLonAlt& scpLatLon,
+                           double height,
+                           double heightThreshold = 1.0,
+                           size_t maxNumIters = 3) const;
+
     void imageToSceneAdjustment(const AdjustableParams& delta,
                                 double timeCOA,
                                 double& r,
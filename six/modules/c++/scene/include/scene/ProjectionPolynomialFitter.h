@@ -22,8 +22,11 @@
 #ifndef __SCENE_PROJECTION_POLYNOMIAL_FITTER_H__
 #define __SCENE_PROJECTION_POLYNOMIAL_FITTER_H__
 
+#include <vector>
+
 #include <math/poly/Fit.h>
 #include <scene/GridECEFTransform.h>
+#include <scene/PolynomialFit2D.h>
 #include <scene/ProjectionModel.h>
 #include <math/linear/Matrix2D.h>
 
@@ -55,13 +58,15 @@ public:
      * \param outExtent Output extent in pixels
      * \param numPoints1D Number of points to use in each direction when
      * sampling the grid.  Defaults to 10.
+     * \param numThreads Number of threads to split the projections across
      */
     ProjectionPolynomialFitter(
             const ProjectionModel& projModel,
             const GridECEFTransform& gridTransform,
             const types::RowCol<double>& outPixelStart,
             const types::RowCol<size_t>& outExtent,
-            size_t numPoints1D = DEFAULTS_POINTS_1D);
+            size_t numPoints1D = DEFAULTS_POINTS_1D,
+            size_t numThreads = 1);
 
     /* Samples a numPoints1D x numPoints1D grid of points that spans
      * the extent of a polygon using sceneToImage().
@@ -80,6 +85,7 @@ public:
      * determine the grid of points.
      * \param numPoints1D Number of points to use in each direction when
      * sampling the grid.  Defaults to 10.
+     * \param numThreads Number of threads to split the projections across
      */
     ProjectionPolynomialFitter(
             const ProjectionModel& projModel,
@@ -88,7 +94,8 @@ public:
             const types::RowCol<double>& outPixelStart,
             const types::RowCol<size_t>& outExtent,
             const std::vector<types::RowCol<double> >& polygon,
-            size_t numPoints1D = DEFAULTS_POINTS_1D);
+            size_t numPoints1D = DEFAULTS_POINTS_1D,
+            size_t numThreads = 1);
 
 
     ProjectionPolynomialFitter(const ProjectionPolynomialFitter&) = delete;
@@ -298,8 +305,8 @@ public:
         }
 
         // Now fit the polynomial
-        timeCOAPoly = math::poly::fit(rowMapping, colMapping, mTimeCOA,
-                                      polyOrderX, polyOrderY);
+        timeCOAPoly = PolynomialFit2D(rowMapping, colMapping,
+                                      polyOrderX, polyOrderY).fit(mTimeCOA);
 
         // Optionally report the residual error
         if (meanResidualError)
@@ -323,12 +330,14 @@ public:
     }
 
 private:
-    void projectToSlantPlane(const ProjectionModel& projModel,
-                             const GridECEFTransform& gridTransform,
-                             const types::RowCol<double>& outPixelStart,
-                             const types::RowCol<double>& currentOffset,
-                             size_t row,
-                             size_t col);
+    // Projects the numPoints1D x numPoints1D output plane pixels (in
+    // row-major order) to the slant plane
+    void projectToSlantPlane(
+            const ProjectionModel& projModel,
+            const GridECEFTransform& gridTransform,
+            const types::RowCol<double>& outPixelStart,
+            const std::vector<types::RowCol<double> >& outputPixels,
+            size_t numThreads);
 
     void getSlantPlaneSamples(
             const types::RowCol<size_t>& inPixelStart,
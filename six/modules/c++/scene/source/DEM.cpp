@@ -0,0 +1,222 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "scene/DEM.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <except/Exception.h>
+
+#undef min
+#undef max
+
+namespace
+{
+// Allow for round-off when a location is right on the edge of the grid
+constexpr double EDGE_TOLERANCE = 1.0e-9;
+}
+
+namespace scene
+{
+GridDEM::GridDEM(const LatLon& origin,
+                 const LatLon& spacing,
+                 const types::RowCol<size_t>& dims,
+                 std::vector<float>&& heights) :
+    mOrigin(origin),
+    mSpacing(spacing),
+    mDims(dims),
+    mTileSize(std::max(dims.row, dims.col)),
+    mMaxCachedTiles(1),
+    mNumTiles(1, 1)
+{
+    checkGeometry();
+    if (heights.size() != dims.area())
+    {
+        std::ostringstream ostr;
+        ostr << "Expected " << dims.area() << " heights but got "
+             << heights.size();
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    mAllHeights.reset(new Tile(std::move(heights)));
+}
+
+GridDEM::GridDEM(const LatLon& origin,
+                 const LatLon& spacing,
+                 const types::RowCol<size_t>& dims,
+                 const std::string& pathname,
+                 size_t tileSize,
+                 size_t maxCachedTiles) :
+    mOrigin(origin),
+    mSpacing(spacing),
+    mDims(dims),
+    mTileSize(tileSize),
+    mMaxCachedTiles(maxCachedTiles),
+    mFile(pathname)
+{
+    checkGeometry();
+    if (mTileSize == 0 || mMaxCachedTiles == 0)
+    {
+        throw except::Exception(Ctxt(
+                "Tile size and number of cached tiles must be positive"));
+    }
+
+    const sys::Off_T expectedLength =
+            static_cast<sys::Off_T>(dims.area() * sizeof(float));
+    if (mFile.length() != expectedLength)
+    {
+        std::ostringstream ostr;
+        ostr << "DEM file " << pathname << " has " << mFile.length()
+             << " bytes but " << expectedLength << " were expected";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    // Tiles cover cells, and there is one less cell than posts in each
+    // direction
+    mNumTiles.row = (mDims.row - 2) / mTileSize + 1;
+    mNumTiles.col = (mDims.col - 2) / mTileSize + 1;
+}
+
+void GridDEM::checkGeometry() const
+{
+    if (mDims.row < 2 || mDims.col < 2)
+    {
+        throw except::Exception(Ctxt(
+                "DEM must have at least two posts in each direction"));
+    }
+    if (mSpacing.getLat() == 0.0 || mSpacing.getLon() == 0.0)
+    {
+        throw except::Exception(Ctxt("DEM post spacing must be non-zero"));
+    }
+}
+
+types::RowCol<double> GridDEM::toPostCoordinates(double lat, double lon) const
+{
+    return types::RowCol<double>(
+            (lat - mOrigin.getLat()) / mSpacing.getLat(),
+            (lon - mOrigin.getLon()) / mSpacing.getLon());
+}
+
+bool GridDEM::contains(double lat, double lon) const
+{
+    const types::RowCol<double> pos = toPostCoordinates(lat, lon);
+    return pos.row >= -EDGE_TOLERANCE &&
+           pos.row <= mDims.row - 1 + EDGE_TOLERANCE &&
+           pos.col >= -EDGE_TOLERANCE &&
+           pos.col <= mDims.col - 1 + EDGE_TOLERANCE;
+}
+
+double GridDEM::getHeight(double lat, double lon) const
+{
+    if (!contains(lat, lon))
+    {
+        std::ostringstream ostr;
+        ostr << "Location (" << lat << ", " << lon
+             << ") is outside of the DEM";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+
+    // Find the cell this is in, clamping so the last row/column of posts
+    // still has a cell
+    const types::RowCol<double> pos = toPostCoordinates(lat, lon);
+    const double maxCellRow = static_cast<double>(mDims.row - 2);
+    const double maxCellCol = static_cast<double>(mDims.col - 2);
+    const size_t cellRow = static_cast<size_t>(
+            std::min(std::max(std::floor(pos.row), 0.0), maxCellRow));
+    const size_t cellCol = static_cast<size_t>(
+            std::min(std::max(std::floor(pos.col), 0.0), maxCellCol));
+    const double rowFrac = pos.row - cellRow;
+    const double colFrac = pos.col - cellCol;
+
+    const size_t tileRow = cellRow / mTileSize;
+    const size_t tileCol = cellCol / mTileSize;
+    const std::shared_ptr<const Tile> tile = getTile(tileRow, tileCol);
+
+    const size_t firstRow = tileRow * mTileSize;
+    const size_t firstCol = tileCol * mTileSize;
+    const size_t tileWidth =
+            std::min(firstCol + mTileSize + 1, mDims.col) - firstCol;
+    const float* const cell = tile->data() +
+            (cellRow - firstRow) * tileWidth + (cellCol - firstCol);
+
+    const double top = cell[0] + colFrac * (cell[1] - cell[0]);
+    const double bottom = cell[tileWidth] +
+            colFrac * (cell[tileWidth + 1] - cell[tileWidth]);
+    return top + rowFrac * (bottom - top);
+}
+
+std::shared_ptr<const GridDEM::Tile>
+GridDEM::getTile(size_t tileRow, size_t tileCol) const
+{
+    if (mAllHeights)
+    {
+        return mAllHeights;
+    }
+
+    const size_t key = tileRow * mNumTiles.col + tileCol;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto iter = mTiles.find(key);
+    if (iter != mTiles.end())
+    {
+        mRecentlyUsed.splice(mRecentlyUsed.begin(), mRecentlyUsed,
+                             iter->second.second);
+        return iter->second.first;
+    }
+
+    std::shared_ptr<const Tile> tile = loadTile(tileRow, tileCol);
+    mRecentlyUsed.push_front(key);
+    mTiles[key] = std::make_pair(tile, mRecentlyUsed.begin());
+
+    if (mTiles.size() > mMaxCachedTiles)
+    {
+        mTiles.erase(mRecentlyUsed.back());
+        mRecentlyUsed.pop_back();
+    }
+    return tile;
+}
+
+std::shared_ptr<const GridDEM::Tile>
+GridDEM::loadTile(size_t tileRow, size_t tileCol) const
+{
+    // Tiles overlap their neighbors by one post
+    const size_t firstRow = tileRow * mTileSize;
+    const size_t firstCol = tileCol * mTileSize;
+    const size_t numRows =
+            std::min(firstRow + mTileSize + 1, mDims.row) - firstRow;
+    const size_t numCols =
+            std::min(firstCol + mTileSize + 1, mDims.col) - firstCol;
+
+    std::shared_ptr<Tile> tile(new Tile(numRows * numCols));
+    for (size_t row = 0; row < numRows; ++row)
+    {
+        const size_t offset =
+                ((firstRow + row) * mDims.col + firstCol) * sizeof(float);
+        mFile.seekTo(static_cast<sys::Off_T>(offset),
+                     sys::File::FROM_START);
+        mFile.readInto(tile->data() + row * numCols,
+                       numCols * sizeof(float));
+    }
+    return tile;
+}
+}
@@ -20,7 +20,12 @@
  *
  */
 #include "scene/ECEFToLLATransform.h"
+
+#include <cmath>
+
+#include <except/Exception.h>
 #include <math/Utilities.h>
+#include <mt/Runnable1D.h>
 
 scene::ECEFToLLATransform::ECEFToLLATransform(const EllipsoidModel *initVals)
  : CoordinateTransform(initVals)
@@ -69,6 +74,73 @@ scene::ECEFToLLATransform::transform(const Vector3& ecef) const
    return lla;
 }
 
+void scene::ECEFToLLATransform::transform(std::span<const double> x,
+                                          std::span<const double> y,
+                                          std::span<const double> z,
+                                          std::span<double> lat,
+                                          std::span<double> lon,
+                                          std::span<double> alt,
+                                          size_t numThreads) const
+{
+    const size_t numPoints = x.size();
+    if (y.size() != numPoints || z.size() != numPoints ||
+        lat.size() != numPoints || lon.size() != numPoints ||
+        alt.size() != numPoints)
+    {
+        throw except::Exception(Ctxt(
+                "ECEF and LLA arrays must all be the same size"));
+    }
+
+    const double a = model->getEquatorialRadius();
+    const double f = model->calculateFlattening();
+    const double e2 = 1.0 - math::square(1.0 - f);
+    const double e4 = e2 * e2;
+    const double invA2 = 1.0 / math::square(a);
+    const double radToDeg = 180.0 / M_PI;
+
+    // Vermeille, H. "Computing geodetic coordinates from geocentric
+    // coordinates", Journal of Geodesy (2004) 78: 94-95
+    const auto op = [&](size_t ii)
+    {
+        const double xx = x[ii];
+        const double yy = y[ii];
+        const double zz = z[ii];
+
+        const double w2 = xx * xx + yy * yy;
+        const double p = w2 * invA2;
+        const double q = (1.0 - e2) * invA2 * zz * zz;
+        const double r = (p + q - e4) / 6.0;
+        if (r <= 0.0)
+        {
+            // Inside the evolute of the ellipsoid; the closed form
+            // doesn't apply here, so use the iterative solution
+            Vector3 ecef;
+            ecef[0] = xx;
+            ecef[1] = yy;
+            ecef[2] = zz;
+            const LatLonAlt lla = transform(ecef);
+            lat[ii] = lla.getLat();
+            lon[ii] = lla.getLon();
+            alt[ii] = lla.getAlt();
+            return;
+        }
+
+        const double s = e4 * p * q / (4.0 * r * r * r);
+        const double t = std::cbrt(1.0 + s + std::sqrt(s * (2.0 + s)));
+        const double u = r * (1.0 + t + 1.0 / t);
+        const double v = std::sqrt(u * u + e4 * q);
+        const double w = e2 * (u + v - q) / (2.0 * v);
+        const double k = std::sqrt(u + v + w * w) - w;
+        const double d = k * std::sqrt(w2) / (k + e2);
+        const double dz = std::sqrt(d * d + zz * zz);
+
+        lat[ii] = 2.0 * std::atan2(zz, d + dz) * radToDeg;
+        lon[ii] = std::atan2(yy, xx) * radToDeg;
+        alt[ii] = (k + e2 - 1.0) / k * dz;
+    };
+    mt::run1D(numPoints, numThreads, op);
+}
+
 double scene::ECEFToLLATransform::computeLongitude(const Vector3& ecef)
 {
     double longitude = 0;
@@ -20,7 +20,12 @@
  *
  */
 #include "scene/LLAToECEFTransform.h"
+
+#include <cmath>
+
+#include <except/Exception.h>
 #include <math/Utilities.h>
+#include <mt/Runnable1D.h>
 
 scene::LLAToECEFTransform::LLAToECEFTransform(const EllipsoidModel *initVals)
  : CoordinateTransform(initVals)
@@ -75,6 +80,59 @@ scene::Vector3 scene::LLAToECEFTransform::transform(const LatLonAlt& lla) const
     return ecef;
 }
 
+void scene::LLAToECEFTransform::transform(std::span<const double> lat,
+                                          std::span<const double> lon,
+                                          std::span<const double> alt,
+                                          std::span<double> x,
+                                          std::span<double> y,
+                                          std::span<double> z,
+                                          size_t numThreads) const
+{
+    const size_t numPoints = lat.size();
+    if (lon.size() != numPoints || alt.size() != numPoints ||
+        x.size() != numPoints || y.size() != numPoints ||
+        z.size() != numPoints)
+    {
+        throw except::Exception(Ctxt(
+                "LLA and ECEF arrays must all be the same size"));
+    }
+
+    // Validate up front so the conversion loop itself never throws
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        if (std::abs(lat[ii]) > 90.0 || std::abs(lon[ii]) > 180.0)
+        {
+            std::ostringstream str;
+            str << "Invalid lla coordinate at index " << ii << ": "
+                << "lat=" << lat[ii] << ", lon=" << lon[ii]
+                << ", alt=" << alt[ii];
+            throw except::InvalidFormatException(Ctxt(str.str()));
+        }
+    }
+
+    const double a = model->getEquatorialRadius();
+    const double f = model->calculateFlattening();
+    const double e2 = 1.0 - math::square(1.0 - f);
+    const double degToRad = M_PI / 180.0;
+
+    const auto op = [&](size_t ii)
+    {
+        double sinlat, coslat;
+        math::SinCos(lat[ii] * degToRad, sinlat, coslat);
+        double sinlon, coslon;
+        math::SinCos(lon[ii] * degToRad, sinlon, coslon);
+
+        // Prime vertical radius of curvature
+        const double n = a / std::sqrt(1.0 - e2 * sinlat * sinlat);
+        const double h = alt[ii];
+
+        x[ii] = (n + h) * coslat * coslon;
+        y[ii] = (n + h) * coslat * sinlon;
+        z[ii] = (n * (1.0 - e2) + h) * sinlat;
+    };
+    mt::run1D(numPoints, numThreads, op);
+}
+
 double scene::LLAToECEFTransform::computeRadius(const LatLonAlt& lla) const
 {
     const double f = model->calculateFlattening();
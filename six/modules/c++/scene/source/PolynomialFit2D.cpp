@@ -0,0 +1,231 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "scene/PolynomialFit2D.h"
+
+#include <cmath>
+#include <sstream>
+
+#include <except/Exception.h>
+
+namespace
+{
+// Relative size below which a column of R is treated as zero
+constexpr double RANK_TOLERANCE = 1.0e-10;
+}
+
+namespace scene
+{
+PolynomialFit2D::PolynomialFit2D(const math::linear::Matrix2D<double>& x,
+                                 const math::linear::Matrix2D<double>& y,
+                                 size_t nx,
+                                 size_t ny) :
+    mNumRows(x.rows()),
+    mNumCols(x.cols()),
+    mOrderX(nx),
+    mOrderY(ny),
+    mNumPoints(x.size()),
+    mNumCoeffs((nx + 1) * (ny + 1)),
+    mMeanX(0.0),
+    mMeanY(0.0),
+    mScaleX(0.0),
+    mScaleY(0.0)
+{
+    if (y.rows() != mNumRows || y.cols() != mNumCols)
+    {
+        throw except::Exception(Ctxt("Matrices must be equally sized"));
+    }
+
+    if (mNumPoints < mNumCoeffs)
+    {
+        std::ostringstream excSS;
+        excSS << "Not enough points for a unique fit solution ("
+              << mNumPoints << " points for a " << mNumCoeffs
+              << "-coefficient fit)!"
+              << " You should really have at least (orderX+1)*(orderY+1) = "
+              << mNumCoeffs << " points for this to do what you expect.";
+        throw except::Exception(Ctxt(excSS.str()));
+    }
+
+    // Center around zero and normalize using the standard deviation
+    const double* const xData = x.get();
+    const double* const yData = y.get();
+    for (size_t ii = 0; ii < mNumPoints; ++ii)
+    {
+        mMeanX += xData[ii];
+        mMeanY += yData[ii];
+    }
+    mMeanX /= static_cast<double>(mNumPoints);
+    mMeanY /= static_cast<double>(mNumPoints);
+
+    double sumSqX(0.0);
+    double sumSqY(0.0);
+    for (size_t ii = 0; ii < mNumPoints; ++ii)
+    {
+        const double dx = xData[ii] - mMeanX;
+        const double dy = yData[ii] - mMeanY;
+        sumSqX += dx * dx;
+        sumSqY += dy * dy;
+    }
+    mScaleX = 1.0 / std::sqrt(sumSqX / static_cast<double>(mNumPoints));
+    mScaleY = 1.0 / std::sqrt(sumSqY / static_cast<double>(mNumPoints));
+
+    // Build the design matrix.  Column k * (ny + 1) + l holds x^k * y^l.
+    mQR.resize(mNumPoints * mNumCoeffs);
+    for (size_t ii = 0; ii < mNumPoints; ++ii)
+    {
+        const double xp = (xData[ii] - mMeanX) * mScaleX;
+        const double yp = (yData[ii] - mMeanY) * mScaleY;
+
+        double xacc = 1.0;
+        size_t coeff = 0;
+        for (size_t kk = 0; kk <= nx; ++kk)
+        {
+            double yacc = 1.0;
+            for (size_t ll = 0; ll <= ny; ++ll, ++coeff)
+            {
+                mQR[coeff * mNumPoints + ii] = xacc * yacc;
+                yacc *= yp;
+            }
+            xacc *= xp;
+        }
+    }
+
+    // Householder QR
+    mRDiag.resize(mNumCoeffs);
+    mBeta.resize(mNumCoeffs);
+    for (size_t jj = 0; jj < mNumCoeffs; ++jj)
+    {
+        double* const column = &mQR[jj * mNumPoints];
+
+        double normSq(0.0);
+        double fullNormSq(0.0);
+        for (size_t ii = 0; ii < mNumPoints; ++ii)
+        {
+            const double sq = column[ii] * column[ii];
+            fullNormSq += sq;
+            if (ii >= jj)
+            {
+                normSq += sq;
+            }
+        }
+
+        // If nothing is left of this column after removing its projection
+        // onto the previous ones, the columns are (numerically) dependent
+        const double norm = std::sqrt(normSq);
+        if (!(norm > RANK_TOLERANCE * std::sqrt(fullNormSq)))
+        {
+            throw except::Exception(Ctxt(
+                    "Points do not determine a unique fit solution"));
+        }
+
+        // Reflect onto -sign(a_jj) * norm to avoid cancellation
+        const double alpha = (column[jj] > 0.0) ? -norm : norm;
+        column[jj] -= alpha;
+        mRDiag[jj] = alpha;
+
+        double vNormSq(0.0);
+        for (size_t ii = jj; ii < mNumPoints; ++ii)
+        {
+            vNormSq += column[ii] * column[ii];
+        }
+        mBeta[jj] = 2.0 / vNormSq;
+
+        for (size_t kk = jj + 1; kk < mNumCoeffs; ++kk)
+        {
+            double* const other = &mQR[kk * mNumPoints];
+            double dot(0.0);
+            for (size_t ii = jj; ii < mNumPoints; ++ii)
+            {
+                dot += column[ii] * other[ii];
+            }
+            dot *= mBeta[jj];
+            for (size_t ii = jj; ii < mNumPoints; ++ii)
+            {
+                other[ii] -= dot * column[ii];
+            }
+        }
+    }
+}
+
+math::poly::TwoD<double>
+PolynomialFit2D::fit(const math::linear::Matrix2D<double>& z) const
+{
+    if (z.rows() != mNumRows || z.cols() != mNumCols)
+    {
+        throw except::Exception(Ctxt("Matrices must be equally sized"));
+    }
+
+    // Apply Q^T to the observations
+    std::vector<double> b(z.get(), z.get() + mNumPoints);
+    for (size_t jj = 0; jj < mNumCoeffs; ++jj)
+    {
+        const double* const column = &mQR[jj * mNumPoints];
+        double dot(0.0);
+        for (size_t ii = jj; ii < mNumPoints; ++ii)
+        {
+            dot += column[ii] * b[ii];
+        }
+        dot *= mBeta[jj];
+        for (size_t ii = jj; ii < mNumPoints; ++ii)
+        {
+            b[ii] -= dot * column[ii];
+        }
+    }
+
+    // Back substitute R c = Q^T z
+    std::vector<double> c(mNumCoeffs);
+    for (size_t jj = mNumCoeffs; jj-- > 0;)
+    {
+        double sum = b[jj];
+        for (size_t kk = jj + 1; kk < mNumCoeffs; ++kk)
+        {
+            sum -= mQR[kk * mNumPoints + jj] * c[kk];
+        }
+        c[jj] = sum / mRDiag[jj];
+    }
+
+    // Remove the normalization scaling
+    math::poly::TwoD<double> coeffs(mOrderX, mOrderY);
+    double xacc = 1.0;
+    size_t p = 0;
+    for (size_t ii = 0; ii <= mOrderX; ++ii)
+    {
+        double yacc = 1.0;
+        for (size_t jj = 0; jj <= mOrderY; ++jj, ++p)
+        {
+            coeffs[ii][jj] = c[p] * (xacc * yacc);
+            yacc *= mScaleY;
+        }
+        xacc *= mScaleX;
+    }
+
+    // Shift the polynomial back from its centered offset
+    math::poly::TwoD<double> xShift(1, 1);
+    math::poly::TwoD<double> yShift(1, 1);
+    xShift[0][0] = -mMeanX;
+    xShift[1][0] = 1;
+    yShift[0][0] = -mMeanY;
+    yShift[0][1] = 1;
+
+    return coeffs.transformInput(xShift, yShift);
+}
+}
@@ -26,6 +26,7 @@
 #include <string>
 
 #include <math/Utilities.h>
+#include <mt/Runnable1D.h>
 #include "scene/ECEFToLLATransform.h"
 #include "scene/Utilities.h"
 
@@ -214,6 +215,34 @@ ProjectionModel::sceneToImage(const Vector3& scenePoint,
     throw except::Exception(Ctxt("Point failed to converge"));
 }
 
+void ProjectionModel::sceneToImage(
+        std::span<const Vector3> scenePoints,
+        std::span<types::RowCol<double> > imageGridPoints,
+        std::span<double> timeCOA,
+        size_t numThreads,
+        const AdjustableParams& delta) const
+{
+    if (imageGridPoints.size() != scenePoints.size())
+    {
+        throw except::Exception(Ctxt(
+                "Must have the same number of image and scene points"));
+    }
+    const bool wantTimeCOA = !timeCOA.empty();
+    if (wantTimeCOA && timeCOA.size() != scenePoints.size())
+    {
+        throw except::Exception(Ctxt(
+                "Must have the same number of time COAs and scene points"));
+    }
+
+    const auto op = [&](size_t ii)
+    {
+        imageGridPoints[ii] = sceneToImage(
+                scenePoints[ii], delta,
+                wantTimeCOA ? &timeCOA[ii] : nullptr);
+    };
+    mt::run1D(scenePoints.size(), numThreads, op);
+}
+
 Vector3
 ProjectionModel::imageToScene(const types::RowCol<double>& imageGridPoint,
                               const Vector3& groundRefPoint,
@@ -274,17 +303,6 @@ Vector3 ProjectionModel::imageToScene(
                 "Max number of iterations must be positive"));
     }
 
-    // 1. Compute the geodetic ground plane normal at the SCP
-    //    Note that this is different than the value passed in to the other
-    //    imageToScene() overloading which is the spherical earth GPN (see
-    //    section 5.1 for details)
-    const ECEFToLLATransform ecefToLatLon;
-    const LatLonAlt scpLatLon = ecefToLatLon.transform(mSCP);
-    Vector3 groundPlaneNormal = computeUnitVector(scpLatLon);
-
-    Vector3 groundRefPoint =
-            mSCP + (height - scpLatLon.getAlt()) * groundPlaneNormal;
-
     // Compute contour just once
     const double timeCOA = mTimeCOAPoly(imageGridPoint.row,
                                         imageGridPoint.col);
@@ -297,6 +315,132 @@ Vector3 ProjectionModel::imageToScene(
     // Adjustable parameters do not affect Rdot
     imageToSceneAdjustment(delta, timeCOA, r, arpCOA, velCOA);
 
+    const ECEFToLLATransform ecefToLatLon;
+    const LatLonAlt SPP = contourToHAE(r, rDot, arpCOA, velCOA,
+                                       ecefToLatLon.transform(mSCP),
+                                       height, heightThreshold, maxNumIters);
+    return scene::Utilities::latLonToECEF(SPP);
+}
+
+Vector3 ProjectionModel::imageToScene(
+        const types::RowCol<double>& imageGridPoint,
+        const DEM& dem,
+        const AdjustableParams& delta,
+        double heightTolerance,
+        size_t maxNumIters) const
+{
+    if (heightTolerance <= 0)
+    {
+        throw except::Exception(Ctxt("Height tolerance must be positive"));
+    }
+
+    // The R/Rdot contour doesn't depend on the height, so compute it once
+    // and reuse it for every constant height projection below
+    const double timeCOA = mTimeCOAPoly(imageGridPoint.row,
+                                        imageGridPoint.col);
+    Vector3 arpCOA = mARPPoly(timeCOA);
+    Vector3 velCOA = mARPVelPoly(timeCOA);
+    double r{}, rDot{};
+    computeContour(arpCOA, velCOA, timeCOA, imageGridPoint, &r, &rDot);
+    imageToSceneAdjustment(delta, timeCOA, r, arpCOA, velCOA);
+
+    const ECEFToLLATransform ecefToLatLon;
+    const LatLonAlt scpLatLon = ecefToLatLon.transform(mSCP);
+
+    // We're looking for the height h where the DEM height under the
+    // constant height projection to h is h itself, i.e. the root of
+    // f(h) = DEM(project(h)) - h.  Start from the DEM height at the SCP,
+    // take secant steps and fall back to bisection once the root is
+    // bracketed and a secant step would leave the bracket.
+    double height = dem.contains(scpLatLon.getLat(), scpLatLon.getLon()) ?
+            dem.getHeight(scpLatLon.getLat(), scpLatLon.getLon()) : 0.0;
+    double prevHeight = 0.0;
+    double prevDiff = 0.0;
+    double below = -std::numeric_limits<double>::max();
+    double above = std::numeric_limits<double>::max();
+    for (size_t iter = 0; iter < maxNumIters; ++iter)
+    {
+        const LatLonAlt surfacePoint = contourToHAE(r, rDot, arpCOA, velCOA,
+                                                    scpLatLon, height);
+        const double diff = dem.getHeight(surfacePoint.getLat(),
+                                          surfacePoint.getLon()) - height;
+        if (std::abs(diff) <= heightTolerance)
+        {
+            return scene::Utilities::latLonToECEF(surfacePoint);
+        }
+
+        if (diff > 0)
+        {
+            below = std::max(below, height);
+        }
+        else
+        {
+            above = std::min(above, height);
+        }
+
+        double nextHeight = height + diff;
+        if (iter > 0 && diff != prevDiff)
+        {
+            nextHeight = height - diff * (height - prevHeight) /
+                    (diff - prevDiff);
+        }
+        if (below > -std::numeric_limits<double>::max() &&
+            above < std::numeric_limits<double>::max() &&
+            (nextHeight <= below || nextHeight >= above))
+        {
+            nextHeight = (below + above) / 2;
+        }
+
+        prevHeight = height;
+        prevDiff = diff;
+        height = nextHeight;
+    }
+
+    throw except::Exception(Ctxt("Terrain projection failed to converge"));
+}
+
+void ProjectionModel::imageToScene(
+        std::span<const types::RowCol<double> > imageGridPoints,
+        const DEM& dem,
+        std::span<Vector3> scenePoints,
+        size_t numThreads,
+        const AdjustableParams& delta,
+        double heightTolerance,
+        size_t maxNumIters) const
+{
+    if (imageGridPoints.size() != scenePoints.size())
+    {
+        throw except::Exception(Ctxt(
+                "Must have the same number of image and scene points"));
+    }
+
+    const auto op = [&](size_t ii)
+    {
+        scenePoints[ii] = imageToScene(imageGridPoints[ii], dem, delta,
+                                       heightTolerance, maxNumIters);
+    };
+    mt::run1D(imageGridPoints.size(), numThreads, op);
+}
+
+LatLonAlt ProjectionModel::contourToHAE(double r,
+                                        double rDot,
+                                        const Vector3& arpCOA,
+                                        const Vector3& velCOA,
+                                        const LatLonAlt& scpLatLon,
+                                        double height,
+                                        double heightThreshold,
+                                        size_t maxNumIters) const
+{
+    // 1. Compute the geodetic ground plane normal at the SCP
+    //    Note that this is different than the value passed in to the other
+    //    imageToScene() overloading which is the spherical earth GPN (see
+    //    section 5.1 for details)
+    const ECEFToLLATransform ecefToLatLon;
+    Vector3 groundPlaneNormal = computeUnitVector(scpLatLon);
+
+    Vector3 groundRefPoint =
+            mSCP + (height - scpLatLon.getAlt()) * groundPlaneNormal;
+
     Vector3 gppECEF{};
     Vector3 uUP{};
     double deltaHeight(std::numeric_limits<double>::max());
@@ -358,8 +502,7 @@ Vector3 ProjectionModel::imageToScene(
 
     // 7. Assign surface point SPP position by adjusting its height to be on
     //    the HAE surface
-    const LatLonAlt SPP(SLP.getLat(), SLP.getLon(), height);
-    return scene::Utilities::latLonToECEF(SPP);
+    return LatLonAlt(SLP.getLat(), SLP.getLon(), height);
 }
 
 void ProjectionModel::imageToSceneAdjustment(const AdjustableParams& delta,
@@ -21,9 +21,11 @@
  */
 
 #include <gsl/gsl.h>
+#include <std/span>
 
 #include <scene/ProjectionPolynomialFitter.h>
 #include <polygon/PolygonMask.h>
+#include <mt/Runnable1D.h>
 
 #undef min
 #undef max
@@ -58,7 +60,8 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
     const GridECEFTransform& gridTransform,
     const types::RowCol<double>& outPixelStart,
     const types::RowCol<size_t>& outExtent,
-    size_t numPoints1D) :
+    size_t numPoints1D,
+    size_t numThreads) :
     mNumPoints1D(numPoints1D),
     mOutputPlaneRows(numPoints1D, numPoints1D),
     mOutputPlaneCols(numPoints1D, numPoints1D),
@@ -77,6 +80,8 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
         static_cast<double>(outExtent.col - 1) / static_cast<double>(mNumPoints1D - 1));
 
     types::RowCol<double> currentOffset(outPixelStart);
+    std::vector<types::RowCol<double> > outputPixels;
+    outputPixels.reserve(mNumPoints1D * mNumPoints1D);
 
     for (size_t ii = 0;
          ii < mNumPoints1D;
@@ -88,10 +93,12 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
              jj < mNumPoints1D;
              ++jj, currentOffset.col += skip.col)
         {
-            projectToSlantPlane(projModel, gridTransform, outPixelStart,
-                                currentOffset, ii, jj);
+            outputPixels.push_back(currentOffset);
         }
     }
+
+    projectToSlantPlane(projModel, gridTransform, outPixelStart,
+                        outputPixels, numThreads);
 }
 
 ProjectionPolynomialFitter::ProjectionPolynomialFitter(
@@ -101,7 +108,8 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
         const types::RowCol<double>& outPixelStart,
         const types::RowCol<size_t>& /*outExtent*/,
         const std::vector<types::RowCol<double> >& polygon,
-        size_t numPoints1D) :
+        size_t numPoints1D,
+        size_t numThreads) :
     mNumPoints1D(numPoints1D),
     mOutputPlaneRows(numPoints1D, numPoints1D),
     mOutputPlaneCols(numPoints1D, numPoints1D),
@@ -194,6 +202,9 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
          static_cast<double>(newExtentRow - 1) / 
          static_cast<double>(numPoints1D - 1);
 
+    std::vector<types::RowCol<double> > outputPixels;
+    outputPixels.reserve(numPoints1D * numPoints1D);
+
     double currentOffsetRow = static_cast<double>(newStartRow);
     for (size_t ii = 0; ii < numPoints1D; ++ii, currentOffsetRow += newDeltaRow)
     {
@@ -220,34 +231,54 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
         double currentCol = static_cast<double>(colRange.mStartElement);
         for (size_t jj = 0; jj < numPoints1D; ++jj, currentCol += newDeltaCol)
         {
-            const types::RowCol<double> currentOffset(currentRow, currentCol);
-            projectToSlantPlane(projModel, gridTransform, outPixelStart,
-                currentOffset, ii, jj);
+            outputPixels.push_back(
+                    types::RowCol<double>(currentRow, currentCol));
         }
     }
+
+    projectToSlantPlane(projModel, gridTransform, outPixelStart,
+                        outputPixels, numThreads);
 }
 
 void ProjectionPolynomialFitter::projectToSlantPlane(
     const ProjectionModel& projModel,
     const GridECEFTransform& gridTransform,
     const types::RowCol<double>& outPixelStart,
-    const types::RowCol<double>& currentOffset,
-    size_t row,
-    size_t col)
+    const std::vector<types::RowCol<double> >& outputPixels,
+    size_t numThreads)
 {
-    // Get the coordinate relative to the outPixelStart.
-    mOutputPlaneRows(row, col) = currentOffset.row - outPixelStart.row;
-    mOutputPlaneCols(row, col) = currentOffset.col - outPixelStart.col;
+    const size_t numPoints = outputPixels.size();
 
-    // Find ECEF of the output plane pixel.
-    const scene::Vector3 ecef =
-        gridTransform.rowColToECEF(currentOffset);
+    // Find ECEF of the output plane pixels.
+    std::vector<Vector3> ecef(numPoints);
+    const auto toECEF = [&](size_t idx)
+    {
+        ecef[idx] = gridTransform.rowColToECEF(outputPixels[idx]);
+    };
+    mt::run1D(numPoints, numThreads, toECEF);
 
-    // Project ECEF coordinate into the slant plane and get meters from
+    // Project ECEF coordinates into the slant plane and get meters from
     // the slant plane scene center point.
-    double timeCOA(0.0);
-    mSceneCoordinates(row, col) = projModel.sceneToImage(ecef, &timeCOA);
-    mTimeCOA(row, col) = timeCOA;
+    std::vector<types::RowCol<double> > sceneCoordinates(numPoints);
+    std::vector<double> timeCOA(numPoints);
+    projModel.sceneToImage(
+            std::span<const Vector3>(ecef.data(), ecef.size()),
+            std::span<types::RowCol<double> >(sceneCoordinates.data(),
+                                              sceneCoordinates.size()),
+            std::span<double>(timeCOA.data(), timeCOA.size()),
+            numThreads);
+
+    for (size_t idx = 0; idx < numPoints; ++idx)
+    {
+        const size_t row = idx / mNumPoints1D;
+        const size_t col = idx % mNumPoints1D;
+
+        // Get the coordinate relative to the outPixelStart.
+        mOutputPlaneRows(row, col) = outputPixels[idx].row - outPixelStart.row;
+        mOutputPlaneCols(row, col) = outputPixels[idx].col - outPixelStart.col;
+        mSceneCoordinates(row, col) = sceneCoordinates[idx];
+        mTimeCOA(row, col) = timeCOA[idx];
+    }
 }
 
 void ProjectionPolynomialFitter::getSlantPlaneSamples(
@@ -307,16 +338,12 @@ void ProjectionPolynomialFitter::fitOutputToSlantPolynomials(
                          slantPlaneRows,
                          slantPlaneCols);
 
-    // Now fit the polynomials
-    outputToSlantRow = math::poly::fit(mOutputPlaneRows,
-                                       mOutputPlaneCols,
-                                       slantPlaneRows,
-                                       polyOrderX, polyOrderY);
-
-    outputToSlantCol = math::poly::fit(mOutputPlaneRows,
-                                       mOutputPlaneCols,
-                                       slantPlaneCols,
-                                       polyOrderX, polyOrderY);
+    // Now fit the polynomials.  Both are sampled at the same output plane
+    // locations, so they can share the factored design matrix.
+    const PolynomialFit2D fit(mOutputPlaneRows, mOutputPlaneCols,
+                              polyOrderX, polyOrderY);
+    outputToSlantRow = fit.fit(slantPlaneRows);
+    outputToSlantCol = fit.fit(slantPlaneCols);
 
     // Optionally report the residual error
     if (meanResidualErrorRow || meanResidualErrorCol)
@@ -375,16 +402,12 @@ void ProjectionPolynomialFitter::fitSlantToOutputPolynomials(
                          slantPlaneRows,
                          slantPlaneCols);
 
-    // Now fit the polynomials
-    slantToOutputRow = math::poly::fit(slantPlaneRows,
-                                       slantPlaneCols,
-                                       mOutputPlaneRows,
-                                       polyOrderX, polyOrderY);
-
-    slantToOutputCol = math::poly::fit(slantPlaneRows,
-                                       slantPlaneCols,
-                                       mOutputPlaneCols,
-                                       polyOrderX, polyOrderY);
+    // Now fit the polynomials.  Both are sampled at the same slant plane
+    // locations, so they can share the factored design matrix.
+    const PolynomialFit2D fit(slantPlaneRows, slantPlaneCols,
+                              polyOrderX, polyOrderY);
+    slantToOutputRow = fit.fit(mOutputPlaneRows);
+    slantToOutputCol = fit.fit(mOutputPlaneCols);
 
     // Optionally report the residual error
     if (meanResidualErrorRow || meanResidualErrorCol)
@@ -448,8 +471,8 @@ void ProjectionPolynomialFitter::fitTimeCOAPolynomial(
     }
 
     // Now fit the polynomial
-    timeCOAPoly = math::poly::fit(rowMapping, colMapping, mTimeCOA,
-                                  polyOrderX, polyOrderY);
+    timeCOAPoly = PolynomialFit2D(rowMapping, colMapping,
+                                  polyOrderX, polyOrderY).fit(mTimeCOA);
 
     // Optionally report the residual error
     if (meanResidualError)
@@ -0,0 +1,143 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Times the per-point ECEF <-> LLA transforms against the batch versions
+// and reports the largest disagreement between the two.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <std/span>
+
+#include <import/cli.h>
+#include <sys/StopWatch.h>
+#include <scene/ECEFToLLATransform.h>
+#include <scene/LLAToECEFTransform.h>
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Benchmark scalar vs. batch ECEF <-> LLA transforms");
+        parser.addArgument("-n --num-points", "Number of points",
+                           cli::STORE, "numPoints", "NUM")->
+                setDefault(1000000);
+        parser.addArgument("-t --threads", "Threads for the batch transforms",
+                           cli::STORE, "numThreads", "NUM")->
+                setDefault(std::thread::hardware_concurrency());
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+        const size_t numPoints = options->get<size_t>("numPoints");
+        const size_t numThreads = options->get<size_t>("numThreads");
+
+        // Points on a spiral over the globe at SAR-ish altitudes
+        std::vector<double> lat(numPoints), lon(numPoints), alt(numPoints);
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            const double frac = static_cast<double>(ii) / numPoints;
+            lat[ii] = -89.0 + 178.0 * frac;
+            lon[ii] = std::fmod(ii * 0.37, 360.0) - 180.0;
+            alt[ii] = std::fmod(ii * 13.0, 8.0e5) - 1.0e3;
+        }
+
+        std::vector<double> x(numPoints), y(numPoints), z(numPoints);
+        std::vector<double> outLat(numPoints), outLon(numPoints),
+                outAlt(numPoints);
+
+        const scene::LLAToECEFTransform toECEF;
+        const scene::ECEFToLLATransform toLLA;
+        sys::RealTimeStopWatch sw;
+
+        sw.start();
+        std::vector<scene::Vector3> scalarECEF(numPoints);
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            scalarECEF[ii] = toECEF.transform(
+                    scene::LatLonAlt(lat[ii], lon[ii], alt[ii]));
+        }
+        const double scalarToECEF = sw.stop();
+
+        sw.clear();
+        sw.start();
+        toECEF.transform(std::span<const double>(lat.data(), numPoints),
+                         std::span<const double>(lon.data(), numPoints),
+                         std::span<const double>(alt.data(), numPoints),
+                         std::span<double>(x.data(), numPoints),
+                         std::span<double>(y.data(), numPoints),
+                         std::span<double>(z.data(), numPoints),
+                         numThreads);
+        const double batchToECEF = sw.stop();
+
+        sw.clear();
+        sw.start();
+        std::vector<scene::LatLonAlt> scalarLLA(numPoints);
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            scalarLLA[ii] = toLLA.transform(scalarECEF[ii]);
+        }
+        const double scalarToLLA = sw.stop();
+
+        sw.clear();
+        sw.start();
+        toLLA.transform(std::span<const double>(x.data(), numPoints),
+                        std::span<const double>(y.data(), numPoints),
+                        std::span<const double>(z.data(), numPoints),
+                        std::span<double>(outLat.data(), numPoints),
+                        std::span<double>(outLon.data(), numPoints),
+                        std::span<double>(outAlt.data(), numPoints),
+                        numThreads);
+        const double batchToLLA = sw.stop();
+
+        double maxLatDiff = 0.0;
+        double maxAltDiff = 0.0;
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            maxLatDiff = std::max(maxLatDiff,
+                    std::abs(outLat[ii] - scalarLLA[ii].getLat()));
+            maxAltDiff = std::max(maxAltDiff,
+                    std::abs(outAlt[ii] - scalarLLA[ii].getAlt()));
+        }
+
+        std::cout << "Points: " << numPoints
+                  << ", threads: " << numThreads << "\n"
+                  << "LLA->ECEF scalar: " << scalarToECEF << " ms, batch: "
+                  << batchToECEF << " ms\n"
+                  << "ECEF->LLA scalar: " << scalarToLLA << " ms, batch: "
+                  << batchToLLA << " ms\n"
+                  << "Max |lat| difference (deg): " << maxLatDiff << "\n"
+                  << "Max |alt| difference: " << maxAltDiff << std::endl;
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
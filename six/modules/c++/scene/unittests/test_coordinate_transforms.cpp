@@ -0,0 +1,183 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cmath>
+#include <vector>
+
+#include <std/span>
+
+#include <scene/ECEFToLLATransform.h>
+#include <scene/LLAToECEFTransform.h>
+#include "TestCase.h"
+
+namespace
+{
+std::span<const double> in(const std::vector<double>& values)
+{
+    return std::span<const double>(values.data(), values.size());
+}
+
+std::span<double> out(std::vector<double>& values)
+{
+    return std::span<double>(values.data(), values.size());
+}
+
+struct LLAGrid final
+{
+    std::vector<double> lat;
+    std::vector<double> lon;
+    std::vector<double> alt;
+};
+
+// Covers both poles, the anti-meridian and altitudes from well
+// below the surface out past geosynchronous orbit
+LLAGrid makeGrid()
+{
+    LLAGrid grid;
+    for (double lat = -90.0; lat <= 90.0; lat += 7.5)
+    {
+        for (double lon = -179.0; lon <= 179.0; lon += 11.0)
+        {
+            for (double alt : {-1.0e6, -500.0, 0.0, 1234.5, 7.5e5, 4.0e7})
+            {
+                grid.lat.push_back(lat);
+                grid.lon.push_back(lon);
+                grid.alt.push_back(alt);
+            }
+        }
+    }
+    return grid;
+}
+}
+
+TEST_CASE(testBatchLLAToECEFMatchesScalar)
+{
+    const LLAGrid grid = makeGrid();
+    const size_t numPoints = grid.lat.size();
+    std::vector<double> x(numPoints), y(numPoints), z(numPoints);
+
+    const scene::LLAToECEFTransform toECEF;
+    toECEF.transform(in(grid.lat), in(grid.lon), in(grid.alt),
+                     out(x), out(y), out(z));
+
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        const scene::Vector3 expected = toECEF.transform(
+                scene::LatLonAlt(grid.lat[ii], grid.lon[ii], grid.alt[ii]));
+        TEST_ASSERT_ALMOST_EQ_EPS(x[ii], expected[0], 1e-6);
+        TEST_ASSERT_ALMOST_EQ_EPS(y[ii], expected[1], 1e-6);
+        TEST_ASSERT_ALMOST_EQ_EPS(z[ii], expected[2], 1e-6);
+    }
+}
+
+TEST_CASE(testBatchECEFToLLAMatchesScalar)
+{
+    const LLAGrid grid = makeGrid();
+    const size_t numPoints = grid.lat.size();
+    std::vector<double> x(numPoints), y(numPoints), z(numPoints);
+    const scene::LLAToECEFTransform toECEF;
+    toECEF.transform(in(grid.lat), in(grid.lon), in(grid.alt),
+                     out(x), out(y), out(z));
+
+    std::vector<double> lat(numPoints), lon(numPoints), alt(numPoints);
+    const scene::ECEFToLLATransform toLLA;
+    toLLA.transform(in(x), in(y), in(z), out(lat), out(lon), out(alt), 4);
+
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        scene::Vector3 ecef;
+        ecef[0] = x[ii];
+        ecef[1] = y[ii];
+        ecef[2] = z[ii];
+        const scene::LatLonAlt expected = toLLA.transform(ecef);
+
+        TEST_ASSERT_ALMOST_EQ_EPS(lat[ii], expected.getLat(), 1e-9);
+        TEST_ASSERT_ALMOST_EQ_EPS(alt[ii], expected.getAlt(), 1e-6);
+        if (std::abs(grid.lat[ii]) < 90.0)
+        {
+            TEST_ASSERT_ALMOST_EQ_EPS(lon[ii], expected.getLon(), 1e-9);
+            TEST_ASSERT_ALMOST_EQ_EPS(lon[ii], grid.lon[ii], 1e-9);
+        }
+
+        // And it should round-trip back to where we started
+        TEST_ASSERT_ALMOST_EQ_EPS(lat[ii], grid.lat[ii], 1e-9);
+        TEST_ASSERT_ALMOST_EQ_EPS(alt[ii], grid.alt[ii], 1e-6);
+    }
+}
+
+TEST_CASE(testBatchECEFToLLANearCenter)
+{
+    // These are inside the evolute of the ellipsoid, where the
+    // batch transform falls back to the iterative solution
+    const std::vector<double> x{1000.0, 0.0, -2.0e4};
+    const std::vector<double> y{-500.0, 3.0e4, 0.0};
+    const std::vector<double> z{250.0, 1.0e4, -1.0e3};
+    std::vector<double> lat(3), lon(3), alt(3);
+
+    const scene::ECEFToLLATransform toLLA;
+    toLLA.transform(in(x), in(y), in(z), out(lat), out(lon), out(alt));
+
+    for (size_t ii = 0; ii < x.size(); ++ii)
+    {
+        scene::Vector3 ecef;
+        ecef[0] = x[ii];
+        ecef[1] = y[ii];
+        ecef[2] = z[ii];
+        const scene::LatLonAlt expected = toLLA.transform(ecef);
+        TEST_ASSERT_EQ(lat[ii], expected.getLat());
+        TEST_ASSERT_EQ(lon[ii], expected.getLon());
+        TEST_ASSERT_EQ(alt[ii], expected.getAlt());
+    }
+}
+
+TEST_CASE(testBatchSizeMismatch)
+{
+    const std::vector<double> input(4);
+    std::vector<double> output(4), shortOutput(3);
+
+    const scene::ECEFToLLATransform toLLA;
+    TEST_EXCEPTION(toLLA.transform(in(input), in(input), in(input),
+                                   out(output), out(output), out(shortOutput)));
+
+    const scene::LLAToECEFTransform toECEF;
+    TEST_EXCEPTION(toECEF.transform(in(input), in(input), in(input),
+                                    out(shortOutput), out(output), out(output)));
+}
+
+TEST_CASE(testBatchInvalidLLA)
+{
+    const std::vector<double> lat{0.0, 91.0};
+    const std::vector<double> lon{0.0, 0.0};
+    const std::vector<double> alt{0.0, 0.0};
+    std::vector<double> x(2), y(2), z(2);
+
+    const scene::LLAToECEFTransform toECEF;
+    TEST_EXCEPTION(toECEF.transform(in(lat), in(lon), in(alt),
+                                    out(x), out(y), out(z)));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testBatchLLAToECEFMatchesScalar);
+    TEST_CHECK(testBatchECEFToLLAMatchesScalar);
+    TEST_CHECK(testBatchECEFToLLANearCenter);
+    TEST_CHECK(testBatchSizeMismatch);
+    TEST_CHECK(testBatchInvalidLLA);
+    )
@@ -0,0 +1,271 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cmath>
+#include <memory>
+
+#include <math/Utilities.h>
+#include <math/linear/Matrix2D.h>
+#include <math/poly/Fit.h>
+#include <scene/GridECEFTransform.h>
+#include <scene/PolynomialFit2D.h>
+#include <scene/ProjectionModel.h>
+#include <scene/ProjectionPolynomialFitter.h>
+#include <scene/SceneGeometry.h>
+#include <scene/Utilities.h>
+#include "TestCase.h"
+
+namespace
+{
+const size_t NUM_POINTS_1D = 12;
+
+// Irregularly spaced sample locations, similar to what the fitter sees
+void makeSamples(math::linear::Matrix2D<double>& x,
+                 math::linear::Matrix2D<double>& y)
+{
+    x = math::linear::Matrix2D<double>(NUM_POINTS_1D, NUM_POINTS_1D);
+    y = math::linear::Matrix2D<double>(NUM_POINTS_1D, NUM_POINTS_1D);
+    for (size_t ii = 0; ii < NUM_POINTS_1D; ++ii)
+    {
+        for (size_t jj = 0; jj < NUM_POINTS_1D; ++jj)
+        {
+            x(ii, jj) = 1000.0 + 250.0 * ii + 3.0 * std::sin(0.7 * jj);
+            y(ii, jj) = -400.0 + 180.0 * jj + 5.0 * std::cos(1.3 * ii);
+        }
+    }
+}
+
+math::poly::TwoD<double> makePoly()
+{
+    math::poly::TwoD<double> poly(2, 3);
+    poly[0][0] = 12.5;
+    poly[0][1] = -0.25;
+    poly[0][2] = 1.5e-4;
+    poly[0][3] = -2.0e-8;
+    poly[1][0] = 0.8;
+    poly[1][1] = 3.0e-5;
+    poly[1][2] = -1.0e-8;
+    poly[2][0] = -6.0e-5;
+    poly[2][1] = 2.0e-9;
+    return poly;
+}
+
+// Same geometry as test_terrain_projection
+std::unique_ptr<scene::ProjectionModel> makeModel(scene::Vector3& scp,
+                                                  scene::Vector3& east,
+                                                  scene::Vector3& north)
+{
+    const scene::LatLonAlt scpLLA(35.0, -117.0, 0.0);
+    scp = scene::Utilities::latLonToECEF(scpLLA);
+
+    double sinLat, cosLat, sinLon, cosLon;
+    math::SinCos(scpLLA.getLatRadians(), sinLat, cosLat);
+    math::SinCos(scpLLA.getLonRadians(), sinLon, cosLon);
+    scene::Vector3 up;
+    up[0] = cosLat * cosLon;
+    up[1] = cosLat * sinLon;
+    up[2] = sinLat;
+    east[0] = -sinLon;
+    east[1] = cosLon;
+    east[2] = 0.0;
+    north = math::linear::cross(up, east);
+
+    const scene::Vector3 arpPos = scp + up * 5.0e5 - east * 3.0e5;
+    const scene::Vector3 arpVel = north * 7000.0;
+
+    math::poly::OneD<scene::Vector3> arpPoly(1);
+    arpPoly[0] = arpPos;
+    arpPoly[1] = arpVel;
+
+    math::poly::TwoD<double> timeCOAPoly(0, 0);
+
+    scene::Vector3 rowVec = scp - arpPos;
+    rowVec.normalize();
+    scene::Vector3 colVec = arpVel - rowVec * arpVel.dot(rowVec);
+    colVec.normalize();
+
+    const scene::SceneGeometry geom(arpVel, arpPos, scp);
+    const int lookDir = (geom.getSideOfTrack() == 1) ? 1 : -1;
+
+    return std::unique_ptr<scene::ProjectionModel>(
+            new scene::PlaneProjectionModel(geom.getSlantPlaneZ(),
+                                            rowVec,
+                                            colVec,
+                                            scp,
+                                            arpPoly,
+                                            timeCOAPoly,
+                                            lookDir));
+}
+}
+
+TEST_CASE(testRecoversPolynomial)
+{
+    math::linear::Matrix2D<double> x, y;
+    makeSamples(x, y);
+    const math::poly::TwoD<double> expected = makePoly();
+
+    math::linear::Matrix2D<double> z(NUM_POINTS_1D, NUM_POINTS_1D);
+    for (size_t ii = 0; ii < NUM_POINTS_1D; ++ii)
+    {
+        for (size_t jj = 0; jj < NUM_POINTS_1D; ++jj)
+        {
+            z(ii, jj) = expected(x(ii, jj), y(ii, jj));
+        }
+    }
+
+    const math::poly::TwoD<double> actual =
+            scene::PolynomialFit2D(x, y, 2, 3).fit(z);
+    TEST_ASSERT_EQ(actual.orderX(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(actual.orderY(), static_cast<size_t>(3));
+    for (size_t ii = 0; ii < NUM_POINTS_1D; ++ii)
+    {
+        for (size_t jj = 0; jj < NUM_POINTS_1D; ++jj)
+        {
+            TEST_ASSERT_ALMOST_EQ_EPS(actual(x(ii, jj), y(ii, jj)),
+                                      z(ii, jj), 1e-6);
+        }
+    }
+}
+
+TEST_CASE(testMatchesPolyFit)
+{
+    math::linear::Matrix2D<double> x, y;
+    makeSamples(x, y);
+
+    // Noisy data, so this is a genuine least squares problem
+    math::linear::Matrix2D<double> z1(NUM_POINTS_1D, NUM_POINTS_1D);
+    math::linear::Matrix2D<double> z2(NUM_POINTS_1D, NUM_POINTS_1D);
+    for (size_t ii = 0; ii < NUM_POINTS_1D; ++ii)
+    {
+        for (size_t jj = 0; jj < NUM_POINTS_1D; ++jj)
+        {
+            z1(ii, jj) = 0.01 * x(ii, jj) + std::sin(0.3 * ii * jj);
+            z2(ii, jj) = 1e-6 * x(ii, jj) * y(ii, jj) +
+                    0.1 * std::cos(0.9 * ii + 0.2 * jj);
+        }
+    }
+
+    const scene::PolynomialFit2D fit(x, y, 3, 3);
+    const math::poly::TwoD<double> actual1 = fit.fit(z1);
+    const math::poly::TwoD<double> actual2 = fit.fit(z2);
+    const math::poly::TwoD<double> expected1 = math::poly::fit(x, y, z1, 3, 3);
+    const math::poly::TwoD<double> expected2 = math::poly::fit(x, y, z2, 3, 3);
+
+    for (size_t ii = 0; ii < NUM_POINTS_1D; ++ii)
+    {
+        for (size_t jj = 0; jj < NUM_POINTS_1D; ++jj)
+        {
+            TEST_ASSERT_ALMOST_EQ_EPS(actual1(x(ii, jj), y(ii, jj)),
+                                      expected1(x(ii, jj), y(ii, jj)), 1e-6);
+            TEST_ASSERT_ALMOST_EQ_EPS(actual2(x(ii, jj), y(ii, jj)),
+                                      expected2(x(ii, jj), y(ii, jj)), 1e-6);
+        }
+    }
+}
+
+TEST_CASE(testBadInputs)
+{
+    math::linear::Matrix2D<double> x, y;
+    makeSamples(x, y);
+
+    // Too many coefficients for the number of points
+    TEST_EXCEPTION(scene::PolynomialFit2D(x, y, 12, 12));
+
+    // Mismatched sizes
+    const math::linear::Matrix2D<double> small(2, 2);
+    TEST_EXCEPTION(scene::PolynomialFit2D(x, small, 1, 1));
+    TEST_EXCEPTION(scene::PolynomialFit2D(x, y, 1, 1).fit(small));
+
+    // All the points in a line can't determine a 2D fit
+    math::linear::Matrix2D<double> line(NUM_POINTS_1D, NUM_POINTS_1D);
+    for (size_t ii = 0; ii < NUM_POINTS_1D; ++ii)
+    {
+        for (size_t jj = 0; jj < NUM_POINTS_1D; ++jj)
+        {
+            line(ii, jj) = 2.0 * x(ii, jj);
+        }
+    }
+    TEST_EXCEPTION(scene::PolynomialFit2D(x, line, 1, 1));
+}
+
+TEST_CASE(testThreadedFitterMatchesSerial)
+{
+    scene::Vector3 scp, east, north;
+    const std::unique_ptr<scene::ProjectionModel> model =
+            makeModel(scp, east, north);
+
+    // A north-up 0.5 m output plane centered on the SCP
+    const scene::PlanarGridECEFTransform gridTransform(
+            types::RowCol<double>(0.5, 0.5),
+            types::RowCol<double>(2000.0, 2000.0),
+            north * -1.0,
+            east,
+            scp);
+
+    const types::RowCol<double> outPixelStart(100.0, 200.0);
+    const types::RowCol<size_t> outExtent(3000, 3500);
+    const scene::ProjectionPolynomialFitter serial(
+            *model, gridTransform, outPixelStart, outExtent, 15, 1);
+    const scene::ProjectionPolynomialFitter threaded(
+            *model, gridTransform, outPixelStart, outExtent, 15, 4);
+
+    for (size_t ii = 0; ii < 15; ++ii)
+    {
+        for (size_t jj = 0; jj < 15; ++jj)
+        {
+            TEST_ASSERT_EQ(threaded.getOutputPlaneRows()(ii, jj),
+                           serial.getOutputPlaneRows()(ii, jj));
+            TEST_ASSERT_EQ(threaded.getOutputPlaneCols()(ii, jj),
+                           serial.getOutputPlaneCols()(ii, jj));
+            TEST_ASSERT_EQ(threaded.getSceneCoordinates()(ii, jj).row,
+                           serial.getSceneCoordinates()(ii, jj).row);
+            TEST_ASSERT_EQ(threaded.getSceneCoordinates()(ii, jj).col,
+                           serial.getSceneCoordinates()(ii, jj).col);
+            TEST_ASSERT_EQ(threaded.getTimeCOA()(ii, jj),
+                           serial.getTimeCOA()(ii, jj));
+        }
+    }
+
+    // The output to slant polys should reproduce the samples
+    math::poly::TwoD<double> outputToSlantRow;
+    math::poly::TwoD<double> outputToSlantCol;
+    double errorRow(0.0);
+    double errorCol(0.0);
+    threaded.fitOutputToSlantPolynomials(
+            types::RowCol<size_t>(0, 0),
+            types::RowCol<double>(1000.0, 1000.0),
+            types::RowCol<double>(1000.0, 1000.0),
+            types::RowCol<double>(0.5, 0.5),
+            4, 4,
+            outputToSlantRow,
+            outputToSlantCol,
+            &errorRow,
+            &errorCol);
+    TEST_ASSERT(errorRow < 1e-6);
+    TEST_ASSERT(errorCol < 1e-6);
+}
+
+TEST_MAIN(
+    TEST_CHECK(testRecoversPolynomial);
+    TEST_CHECK(testMatchesPolyFit);
+    TEST_CHECK(testBadInputs);
+    TEST_CHECK(testThreadedFitterMatchesSerial);
+    )
@@ -0,0 +1,267 @@
+/* =========================================================================
+ * This file is part of scene-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * scene-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdio.h>
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <std/span>
+
+#include <math/Utilities.h>
+#include <scene/DEM.h>
+#include <scene/ECEFToLLATransform.h>
+#include <scene/ProjectionModel.h>
+#include <scene/SceneGeometry.h>
+#include <scene/Utilities.h>
+#include "TestCase.h"
+
+namespace
+{
+const scene::LatLon DEM_ORIGIN(35.2, -117.2);
+const scene::LatLon DEM_SPACING(-0.001, 0.001);
+const types::RowCol<size_t> DEM_DIMS(401, 401);
+
+std::vector<float> makeHills()
+{
+    std::vector<float> heights(DEM_DIMS.area());
+    for (size_t row = 0; row < DEM_DIMS.row; ++row)
+    {
+        for (size_t col = 0; col < DEM_DIMS.col; ++col)
+        {
+            heights[row * DEM_DIMS.col + col] = static_cast<float>(
+                    400.0 + 150.0 * std::sin(row * 0.05) *
+                    std::cos(col * 0.03));
+        }
+    }
+    return heights;
+}
+
+// A side-looking collection centered at (35, -117) with the sensor
+// 500 km up, flying north
+std::unique_ptr<scene::ProjectionModel> makeModel()
+{
+    const scene::LatLonAlt scpLLA(35.0, -117.0, 0.0);
+    const scene::Vector3 scp = scene::Utilities::latLonToECEF(scpLLA);
+
+    double sinLat, cosLat, sinLon, cosLon;
+    math::SinCos(scpLLA.getLatRadians(), sinLat, cosLat);
+    math::SinCos(scpLLA.getLonRadians(), sinLon, cosLon);
+    scene::Vector3 up;
+    up[0] = cosLat * cosLon;
+    up[1] = cosLat * sinLon;
+    up[2] = sinLat;
+    scene::Vector3 east;
+    east[0] = -sinLon;
+    east[1] = cosLon;
+    east[2] = 0.0;
+    const scene::Vector3 north = math::linear::cross(up, east);
+
+    const scene::Vector3 arpPos = scp + up * 5.0e5 - east * 3.0e5;
+    const scene::Vector3 arpVel = north * 7000.0;
+
+    math::poly::OneD<scene::Vector3> arpPoly(1);
+    arpPoly[0] = arpPos;
+    arpPoly[1] = arpVel;
+
+    math::poly::TwoD<double> timeCOAPoly(0, 0);
+
+    scene::Vector3 rowVec = scp - arpPos;
+    rowVec.normalize();
+    scene::Vector3 colVec = arpVel - rowVec * arpVel.dot(rowVec);
+    colVec.normalize();
+
+    const scene::SceneGeometry geom(arpVel, arpPos, scp);
+    const int lookDir = (geom.getSideOfTrack() == 1) ? 1 : -1;
+
+    return std::unique_ptr<scene::ProjectionModel>(
+            new scene::PlaneProjectionModel(geom.getSlantPlaneZ(),
+                                            rowVec,
+                                            colVec,
+                                            scp,
+                                            arpPoly,
+                                            timeCOAPoly,
+                                            lookDir));
+}
+
+std::vector<types::RowCol<double> > makeImagePoints()
+{
+    std::vector<types::RowCol<double> > points;
+    for (double row = -3000.0; row <= 3000.0; row += 750.0)
+    {
+        for (double col = -3000.0; col <= 3000.0; col += 1000.0)
+        {
+            points.push_back(types::RowCol<double>(row, col));
+        }
+    }
+    return points;
+}
+}
+
+TEST_CASE(testGridDEMInterpolation)
+{
+    const std::vector<float> heights = makeHills();
+    const scene::GridDEM dem(DEM_ORIGIN, DEM_SPACING, DEM_DIMS,
+                             std::vector<float>(heights));
+
+    // Exactly on posts
+    TEST_ASSERT_ALMOST_EQ_EPS(
+            dem.getHeight(DEM_ORIGIN.getLat(), DEM_ORIGIN.getLon()),
+            heights[0], 1e-6);
+    TEST_ASSERT_ALMOST_EQ_EPS(
+            dem.getHeight(DEM_ORIGIN.getLat() + 400 * DEM_SPACING.getLat(),
+                          DEM_ORIGIN.getLon() + 400 * DEM_SPACING.getLon()),
+            heights.back(), 1e-6);
+
+    // Halfway between four posts
+    const double expected = (heights[10 * DEM_DIMS.col + 20] +
+                             heights[10 * DEM_DIMS.col + 21] +
+                             heights[11 * DEM_DIMS.col + 20] +
+                             heights[11 * DEM_DIMS.col + 21]) / 4;
+    TEST_ASSERT_ALMOST_EQ_EPS(
+            dem.getHeight(DEM_ORIGIN.getLat() + 10.5 * DEM_SPACING.getLat(),
+                          DEM_ORIGIN.getLon() + 20.5 * DEM_SPACING.getLon()),
+            expected, 1e-4);
+
+    TEST_ASSERT(!dem.contains(DEM_ORIGIN.getLat() + 0.01,
+                              DEM_ORIGIN.getLon()));
+    TEST_EXCEPTION(dem.getHeight(DEM_ORIGIN.getLat() + 0.01,
+                                 DEM_ORIGIN.getLon()));
+}
+
+TEST_CASE(testGridDEMFromFile)
+{
+    const std::vector<float> heights = makeHills();
+    const std::string pathname = "test_terrain_projection_dem.raw";
+    {
+        std::ofstream out(pathname.c_str(), std::ios::binary);
+        out.write(reinterpret_cast<const char*>(heights.data()),
+                  heights.size() * sizeof(float));
+    }
+
+    {
+        const scene::GridDEM inMemory(DEM_ORIGIN, DEM_SPACING, DEM_DIMS,
+                                      std::vector<float>(heights));
+
+        // Small tiles and cache so we cross tile boundaries and evict
+        const scene::GridDEM fromFile(DEM_ORIGIN, DEM_SPACING, DEM_DIMS,
+                                      pathname, 16, 4);
+        for (double row = 0.0; row <= 400.0; row += 3.7)
+        {
+            for (double col = 0.0; col <= 400.0; col += 15.9)
+            {
+                const double lat =
+                        DEM_ORIGIN.getLat() + row * DEM_SPACING.getLat();
+                const double lon =
+                        DEM_ORIGIN.getLon() + col * DEM_SPACING.getLon();
+                TEST_ASSERT_EQ(fromFile.getHeight(lat, lon),
+                               inMemory.getHeight(lat, lon));
+            }
+        }
+    }
+    remove(pathname.c_str());
+
+    TEST_EXCEPTION(scene::GridDEM(DEM_ORIGIN, DEM_SPACING, DEM_DIMS,
+                                  std::vector<float>(10)));
+}
+
+TEST_CASE(testConstantHeightMatchesHAEProjection)
+{
+    const std::unique_ptr<scene::ProjectionModel> model = makeModel();
+    const scene::ConstantHeightDEM dem(250.0);
+
+    for (const auto& imagePoint : makeImagePoints())
+    {
+        const scene::Vector3 expected =
+                model->imageToScene(imagePoint, 250.0);
+        const scene::Vector3 actual = model->imageToScene(imagePoint, dem);
+        TEST_ASSERT_ALMOST_EQ_EPS((actual - expected).norm(), 0.0, 1e-6);
+    }
+}
+
+TEST_CASE(testProjectToTerrain)
+{
+    const std::unique_ptr<scene::ProjectionModel> model = makeModel();
+    const scene::GridDEM dem(DEM_ORIGIN, DEM_SPACING, DEM_DIMS, makeHills());
+    const scene::ECEFToLLATransform toLLA;
+
+    for (const auto& imagePoint : makeImagePoints())
+    {
+        const scene::Vector3 scenePoint = model->imageToScene(imagePoint, dem);
+
+        // It should be on the terrain...
+        const scene::LatLonAlt lla = toLLA.transform(scenePoint);
+        TEST_ASSERT_ALMOST_EQ_EPS(lla.getAlt(),
+                                  dem.getHeight(lla.getLat(), lla.getLon()),
+                                  0.02);
+
+        // ...and project back to where it came from
+        const types::RowCol<double> roundTrip =
+                model->sceneToImage(scenePoint);
+        TEST_ASSERT_ALMOST_EQ_EPS(roundTrip.row, imagePoint.row, 1e-2);
+        TEST_ASSERT_ALMOST_EQ_EPS(roundTrip.col, imagePoint.col, 1e-2);
+    }
+}
+
+TEST_CASE(testBatchProjectToTerrain)
+{
+    const std::unique_ptr<scene::ProjectionModel> model = makeModel();
+    const scene::GridDEM dem(DEM_ORIGIN, DEM_SPACING, DEM_DIMS, makeHills());
+
+    const std::vector<types::RowCol<double> > imagePoints = makeImagePoints();
+    std::vector<scene::Vector3> scenePoints(imagePoints.size());
+    model->imageToScene(
+            std::span<const types::RowCol<double> >(imagePoints.data(),
+                                                    imagePoints.size()),
+            dem,
+            std::span<scene::Vector3>(scenePoints.data(), scenePoints.size()),
+            3);
+
+    for (size_t ii = 0; ii < imagePoints.size(); ++ii)
+    {
+        const scene::Vector3 expected =
+                model->imageToScene(imagePoints[ii], dem);
+        TEST_ASSERT_EQ(scenePoints[ii][0], expected[0]);
+        TEST_ASSERT_EQ(scenePoints[ii][1], expected[1]);
+        TEST_ASSERT_EQ(scenePoints[ii][2], expected[2]);
+    }
+}
+
+TEST_CASE(testProjectOffTerrain)
+{
+    const std::unique_ptr<scene::ProjectionModel> model = makeModel();
+    const scene::GridDEM dem(DEM_ORIGIN, DEM_SPACING, DEM_DIMS, makeHills());
+
+    // Well outside of the DEM
+    TEST_EXCEPTION(model->imageToScene(types::RowCol<double>(5.0e4, 0.0),
+                                       dem));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testGridDEMInterpolation);
+    TEST_CHECK(testGridDEMFromFile);
+    TEST_CHECK(testConstantHeightMatchesHAEProjection);
+    TEST_CHECK(testProjectToTerrain);
+    TEST_CHECK(testBatchProjectToTerrain);
+    TEST_CHECK(testProjectOffTerrain);
+    )
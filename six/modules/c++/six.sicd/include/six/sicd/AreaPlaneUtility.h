@@ -72,6 +72,14 @@ public:
      */
     static bool hasAreaPlane(const ComplexData& data);
 
+    /*!
+     * Returns the areaPlane of ComplexData if it has one, otherwise the
+     * one setAreaPlane() would add, without modifying data
+     * \param data ComplexData to get AreaPlane from
+     * \return AreaPlane describing the output plane
+     */
+    static AreaPlane getAreaPlane(const ComplexData& data);
+
     static const double DEFAULT_SAMPLE_DENSITY;
 
 private:
@@ -26,6 +26,7 @@
 #include <scene/GridECEFTransform.h>
 #include <scene/ECEFToLLATransform.h>
 #include <six/sicd/ComplexData.h>
+#include <six/sicd/ProjectionContext.h>
 
 namespace six
 {
@@ -45,6 +46,13 @@ public:
      */
     GeoLocator(const ComplexData& complexData, bool shadowsDown=true);
 
+    /*!
+     * Constructor using the output plane already cached in a context
+     * \param context Projection context for the SICD
+     * \param shadowsDown If true, rotate output plane to shadows-down orientation
+     */
+    GeoLocator(const ProjectionContext& context, bool shadowsDown=true);
+
     GeoLocator(const GeoLocator&) = delete;
     GeoLocator& operator=(const GeoLocator&) = delete;
 
@@ -56,8 +64,8 @@ public:
     LatLonAlt geolocate(const RowColDouble& rowCol) const;
 
 private:
-    scene::PlanarGridECEFTransform buildTransformer(
-            const ComplexData& complexData, bool shadowsDown) const;
+    static scene::PlanarGridECEFTransform buildTransformer(
+            AreaPlane plane, bool shadowsDown);
     const scene::ECEFToLLATransform mEcefToLla;
     const scene::PlanarGridECEFTransform mRowColToEcef;
 };
@@ -0,0 +1,61 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2018, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SICD_METADATA_SNAPSHOT_H__
+#define __SIX_SICD_METADATA_SNAPSHOT_H__
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <std/cstddef>
+#include <std/span>
+
+#include <six/MetadataSnapshot.h>
+#include <six/sicd/ComplexData.h>
+
+namespace six
+{
+namespace sicd
+{
+/*!
+ *  Append a six::MetadataSnapshot of SICD metadata to 'buffer'.  Its
+ *  identifier is "COMPLEX".
+ */
+void serializeSnapshot(const ComplexData& data,
+                       std::vector<std::byte>& buffer);
+
+/*!
+ *  Load SICD metadata from what serializeSnapshot() wrote
+ *
+ *  \throw if 'buffer' isn't a complete snapshot of SICD metadata
+ */
+std::unique_ptr<ComplexData>
+deserializeSnapshot(std::span<const std::byte> buffer);
+
+// CPHD reuses these
+void snapshot(SnapshotArchive& archive,
+              ElectricalBoresight& electricalBoresight);
+void snapshot(SnapshotArchive& archive, GainAndPhasePolys& polys);
+}
+}
+
+#endif
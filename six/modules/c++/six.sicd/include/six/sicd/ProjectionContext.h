@@ -0,0 +1,180 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2017, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SICD_PROJECTION_CONTEXT_H__
+#define __SIX_SICD_PROJECTION_CONTEXT_H__
+
+#include <stddef.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <types/RowCol.h>
+#include <scene/ECEFToLLATransform.h>
+#include <scene/GridECEFTransform.h>
+#include <scene/ProjectionModel.h>
+#include <scene/ProjectionPolynomialFitter.h>
+#include <scene/SceneGeometry.h>
+#include <six/sicd/ComplexData.h>
+#include <six/sicd/RadarCollection.h>
+
+namespace six
+{
+namespace sicd
+{
+/*!
+ * \class ProjectionContext
+ * \brief Everything needed to project pixels of one SICD, built once
+ *
+ * Building the scene geometry, projection model and output plane from
+ * ComplexData is far more expensive than projecting a handful of points
+ * with them.  This holds onto all of it so callers making many small
+ * projection requests against the same image only pay that cost once.
+ *
+ * The output plane is the SICD's RadarCollection/Area/Plane if it has one,
+ * and is otherwise derived the same way as
+ * Utilities::getModelComponents().
+ *
+ * Once constructed, all methods are const and may be called from multiple
+ * threads at once.  The default polynomial fitter is built the first time
+ * it is asked for.
+ */
+class ProjectionContext
+{
+public:
+    /*!
+     * \param complexData SICD metadata.  A copy of it is kept, so it does
+     * not need to outlive this object.
+     */
+    explicit ProjectionContext(const ComplexData& complexData);
+
+    ProjectionContext(const ProjectionContext&) = delete;
+    ProjectionContext& operator=(const ProjectionContext&) = delete;
+
+    const ComplexData& getComplexData() const
+    {
+        return *mComplexData;
+    }
+
+    const scene::SceneGeometry& getSceneGeometry() const
+    {
+        return *mGeometry;
+    }
+
+    const scene::ProjectionModel& getProjectionModel() const
+    {
+        return *mProjectionModel;
+    }
+
+    //! Output plane definition
+    const AreaPlane& getAreaPlane() const
+    {
+        return mAreaPlane;
+    }
+
+    //! \return Same as Utilities::getGroundPlaneNormal()
+    const Vector3& getGroundPlaneNormal() const
+    {
+        return mGroundPlaneNormal;
+    }
+
+    //! Transform from output plane pixels to ECEF
+    const scene::PlanarGridECEFTransform& getOutputPlaneTransform() const
+    {
+        return mOutputPlaneTransform;
+    }
+
+    const scene::ECEFToLLATransform& getECEFToLLATransform() const
+    {
+        return mECEFToLLA;
+    }
+
+    /*!
+     * \return Fitter sampling the output plane extent of the SICD with
+     * the default number of points.  This is the same as
+     * Utilities::getPolynomialFitter(complexData), but is only built once.
+     */
+    const scene::ProjectionPolynomialFitter& getPolynomialFitter() const;
+
+    /*!
+     * Build a new ProjectionPolynomialFitter from the cached model
+     * \param numPoints1D Number of points to use in each direction of grid
+     * \param sampleWithinValidDataPolygon Only get grid sample points from
+     * within the valid data polygon
+     * \param numThreads Number of threads to sample the grid with
+     */
+    std::unique_ptr<scene::ProjectionPolynomialFitter>
+    createPolynomialFitter(size_t numPoints1D,
+                           bool sampleWithinValidDataPolygon,
+                           size_t numThreads = 1) const;
+
+    /*!
+     * Project a slant plane pixel into the ground plane
+     * \param pixel Slant plane (row, col) pixel
+     * \return Ground plane location in ECEF
+     */
+    Vector3 slantPixelToECEF(const types::RowCol<double>& pixel) const;
+
+    /*!
+     * Project a slant plane pixel into the output plane
+     * \param pixel Slant plane (row, col) pixel
+     * \return Output plane (row, col) pixel
+     */
+    types::RowCol<double>
+    slantToOutputPixel(const types::RowCol<double>& pixel) const;
+
+    /*!
+     * Project an output plane pixel back into the slant plane
+     * \param pixel Output plane (row, col) pixel
+     * \return Slant plane (row, col) pixel
+     */
+    types::RowCol<double>
+    outputToSlantPixel(const types::RowCol<double>& pixel) const;
+
+    //! \return The SICD's valid data polygon in slant plane pixels, or its
+    //! four corners if it doesn't have one
+    std::vector<types::RowCol<double> > getSlantValidData() const;
+
+private:
+    const std::unique_ptr<const ComplexData> mComplexData;
+    const std::unique_ptr<const scene::SceneGeometry> mGeometry;
+    const std::unique_ptr<const scene::ProjectionModel> mProjectionModel;
+    const AreaPlane mAreaPlane;
+    const Vector3 mGroundPlaneNormal;
+    const scene::PlanarGridECEFTransform mOutputPlaneTransform;
+    const scene::ECEFToLLATransform mECEFToLLA;
+
+    // Output plane pixel <-> distance from the ORP
+    const types::RowCol<double> mOutputSampleSpacing;
+    const types::RowCol<double> mOutputCenterPixel;
+
+    // Slant plane pixel <-> distance from the SCP
+    const types::RowCol<double> mSlantSampleSpacing;
+    const types::RowCol<double> mSlantOffset;
+
+    mutable std::once_flag mFitterFlag;
+    mutable std::unique_ptr<scene::ProjectionPolynomialFitter> mFitter;
+};
+}
+}
+
+#endif
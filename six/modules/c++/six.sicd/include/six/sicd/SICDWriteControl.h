@@ -48,6 +48,9 @@ namespace sicd
  * a use case where you will be getting/generating pixels gradually rather
  * than all at once, and you may get/generate them in an order other than the
  * order they'll be written to disk, you can use this class instead.
+ *
+ * six::RegionWriteControl does the same for SIDDs, including blocked SIDDs
+ * and those with several products.
  */
 class SICDWriteControl : public six::NITFWriteControl
 {
@@ -98,15 +101,30 @@ public:
      * \param dims The dimensions of the image data pixels.
      * \param restoreData Unless the OPT_BYTE_SWAP option has been set or this
      *     is a big endian system, the incoming data needs to be endian swapped.
-     *     For memory efficiency, this is done in-place.  This flag controls
-     *     if the incoming data should be swapped back afterwards.  By default,
-     *     the data will be swapped back.
+     *     By default, it's swapped a chunk at a time into scratch buffers, as
+     *     with the const overload, and left alone.  Otherwise it's swapped
+     *     in place and left swapped, which saves the copies.
      */
     void save(void* imageData,
               const types::RowCol<size_t>& offset,
               const types::RowCol<size_t>& dims,
               bool restoreData = true);
 
+    /*!
+     * Same as above, but the image data is never modified.  When it needs to
+     * be endian swapped, it's swapped a megabyte or so at a time into
+     * scratch buffers that are kept between calls.  For large regions,
+     * worker threads swap the next chunks while the current one is written.
+     *
+     * \param imageData The image data pixels to write
+     * \param offset The global offset in pixels as to where these pixels are
+     *     in the image
+     * \param dims The dimensions of the image data pixels
+     */
+    void save(const void* imageData,
+              const types::RowCol<size_t>& offset,
+              const types::RowCol<size_t>& dims);
+
     /*!
      * Closes the underlying IO interface.  This will occur implicitly in the
      * destructor if it's not called.
@@ -114,17 +132,35 @@ public:
     void close();
 
 private:
+    //! Consecutive rows of a region, all in one image segment
+    struct RowChunk final
+    {
+        size_t firstRow; // within the region
+        size_t numRows;
+        nitf::Off byteOffset; // of the first row in the file
+    };
+
     void writeHeaders();
+    void prepareToSave();
 
     void write(const std::vector<sys::byte>& data);
     void write(const std::vector<std::byte>& data);
 
+    std::vector<RowChunk> getRowChunks(const types::RowCol<size_t>& offset,
+                                       const types::RowCol<size_t>& dims,
+                                       size_t maxChunkBytes) const;
+
+    void writeRows(const std::byte* rows,
+                   const RowChunk& chunk,
+                   size_t numBytesPerRow);
+
 private:
     std::unique_ptr<nitf::IOInterface> mIO;
     const std::vector<std::string> mSchemaPaths;
 
     std::vector<nitf::Off> mImageDataStart;
     std::vector<NITFSegmentInfo> mImageSegmentInfo;
+    std::vector<std::vector<std::byte> > mSwapBuffers;
     bool mHaveWrittenHeaders;
 };
 }
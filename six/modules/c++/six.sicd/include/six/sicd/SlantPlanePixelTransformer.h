@@ -32,6 +32,7 @@
 #include <scene/SceneGeometry.h>
 #include <scene/ProjectionModel.h>
 #include <six/sicd/ComplexData.h>
+#include <six/sicd/ProjectionContext.h>
 
 namespace six
 {
@@ -60,6 +61,15 @@ public:
                                const scene::SceneGeometry& geom,
                                const scene::ProjectionModel& projection);
 
+    /*!
+     *  \fn Constructor
+     *  \param context - Cached geometry and projection model for a SICD
+     *
+     *  NOTE: The context's ProjectionModel is stored by reference. Make
+     *        sure the context outlives this class.
+     */
+    explicit SlantPlanePixelTransformer(const ProjectionContext& context);
+
     SlantPlanePixelTransformer(const SlantPlanePixelTransformer&) = delete;
     SlantPlanePixelTransformer& operator=(const SlantPlanePixelTransformer&) = delete;
 
@@ -36,6 +36,7 @@
 #include <six/sicd/SICDMesh.h>
 #include <six/NITFReadControl.h>
 #include <six/sicd/AreaPlaneUtility.h>
+#include <six/sicd/ProjectionContext.h>
 
 namespace six
 {
@@ -84,13 +85,15 @@ public:
      * \param numPoints1D Number of points to use in each direction of grid.
      * \param sampleWithinValidDataPolygon Only get grid sample points from
      * with the valid data polygon.
+     * \param numThreads Number of threads to sample the grid with.
      * \return ProjectionPolynomialFitter from ComplexData
      */
     static mem::auto_ptr<scene::ProjectionPolynomialFitter>
     getPolynomialFitter(const ComplexData& complexData,
                         size_t numPoints1D =
                          scene::ProjectionPolynomialFitter::DEFAULTS_POINTS_1D,
-                        bool sampleWithinValidDataPolygon = false);
+                        bool sampleWithinValidDataPolygon = false,
+                        size_t numThreads = 1);
 
     /*
      * If the SICD contains a valid data polygon, provides this.
@@ -641,6 +644,18 @@ public:
         const std::vector<types::RowCol<double> >& spPixels,
         std::vector<types::RowCol<double> >& opPixels);
 
+    /*!
+     * Same as above, but reuses the model in an existing ProjectionContext
+     * rather than building one from the ComplexData on every call.
+     * \param context Projection context for the SICD.
+     * \param spPixels Slant plane pixel coordinates.
+     * \param opPixels Output plane pixel coordinates.
+     */
+    static void projectPixelsToOutputPlane(
+        const ProjectionContext& context,
+        const std::vector<types::RowCol<double> >& spPixels,
+        std::vector<types::RowCol<double> >& opPixels);
+
     /*!
      * Project slant plane valid data polygon pixel locations to output
      * plane pixel locations.
@@ -651,6 +666,15 @@ public:
         const six::sicd::ComplexData& complexData,
         std::vector<types::RowCol<double> >& opPixels);
 
+    /*!
+     * Same as above, but reuses the model in an existing ProjectionContext.
+     * \param context Projection context for the SICD.
+     * \param opPixels Output plane pixel coordinates.
+     */
+    static void projectValidDataPolygonToOutputPlane(
+        const ProjectionContext& context,
+        std::vector<types::RowCol<double> >& opPixels);
+
     /*!
      * Project output plane pixel locations to slant plane pixel locations.
      * \param complexData Complex metadata.
@@ -662,6 +686,17 @@ public:
         const std::vector<types::RowCol<double> >& opPixels,
         std::vector<types::RowCol<double> >& spPixels);
 
+    /*!
+     * Same as above, but reuses the model in an existing ProjectionContext.
+     * \param context Projection context for the SICD.
+     * \param opPixels Output plane pixel coordinates.
+     * \param spPixels Slant plane pixel coordinates.
+     */
+    static void projectPixelsToSlantPlane(
+        const ProjectionContext& context,
+        const std::vector<types::RowCol<double> >& opPixels,
+        std::vector<types::RowCol<double> >& spPixels);
+
     static std::complex<long double> from_AMP8I_PHS8I(uint8_t input_amplitude, uint8_t input_value, const six::AmplitudeTable*);
 };
 
@@ -245,6 +245,18 @@ void AreaPlaneUtility::setAreaPlane(ComplexData& data,
     }
 }
 
+AreaPlane AreaPlaneUtility::getAreaPlane(const ComplexData& data)
+{
+    if (hasAreaPlane(data))
+    {
+        return *data.radarCollection->area->plane;
+    }
+
+    AreaPlane areaPlane;
+    deriveAreaPlane(data, areaPlane);
+    return areaPlane;
+}
+
 void AreaPlaneUtility::deriveAreaPlane(const ComplexData& data,
         AreaPlane& areaPlane,
         bool includeSegmentList,
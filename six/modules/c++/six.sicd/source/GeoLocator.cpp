@@ -28,7 +28,15 @@ namespace six
 namespace sicd
 {
 GeoLocator::GeoLocator(const ComplexData& complexData, bool shadowsDown):
-    mEcefToLla(/*needed by ICC*/), mRowColToEcef(buildTransformer(complexData, shadowsDown))
+    mEcefToLla(/*needed by ICC*/),
+    mRowColToEcef(buildTransformer(AreaPlaneUtility::getAreaPlane(complexData),
+                                   shadowsDown))
+{
+}
+
+GeoLocator::GeoLocator(const ProjectionContext& context, bool shadowsDown):
+    mEcefToLla(/*needed by ICC*/),
+    mRowColToEcef(buildTransformer(context.getAreaPlane(), shadowsDown))
 {
 }
 
@@ -38,15 +46,8 @@ LatLonAlt GeoLocator::geolocate(const RowColDouble& rowCol) const
 }
 
 scene::PlanarGridECEFTransform
-GeoLocator::buildTransformer(const ComplexData& complexData, bool shadowsDown) const
+GeoLocator::buildTransformer(AreaPlane plane, bool shadowsDown)
 {
-    std::unique_ptr<ComplexData> dataClone(
-        static_cast<ComplexData*>(complexData.clone()));
-    if (!AreaPlaneUtility::hasAreaPlane(*dataClone))
-    {
-        AreaPlaneUtility::setAreaPlane(*dataClone);
-    }
-    AreaPlane& plane = *dataClone->radarCollection->area->plane;
     if (shadowsDown)
     {
         plane.rotateToShadowsDown();
@@ -0,0 +1,395 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2018, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/sicd/MetadataSnapshot.h>
+
+namespace
+{
+const char SNAPSHOT_IDENTIFIER[] = "COMPLEX";
+}
+
+namespace six
+{
+namespace sicd
+{
+// The rest are static, but they need to be in six::sicd so that the
+// archive can find them by argument dependent lookup.  Each is defined
+// before the types that contain it.
+static void snapshot(SnapshotArchive& archive, ImageCreation& imageCreation)
+{
+    archive(imageCreation.application, imageCreation.dateTime,
+            imageCreation.site, imageCreation.profile);
+}
+
+static void snapshot(SnapshotArchive& archive, ImageData& imageData)
+{
+    archive(imageData.pixelType,
+            imageData.amplitudeTable,
+            imageData.numRows,
+            imageData.numCols,
+            imageData.firstRow,
+            imageData.firstCol,
+            imageData.fullImage,
+            imageData.scpPixel,
+            imageData.validData);
+}
+
+static void snapshot(SnapshotArchive& archive, GeoData& geoData)
+{
+    archive(static_cast<GeoDataBase&>(geoData), geoData.scp);
+}
+
+static void snapshot(SnapshotArchive& archive, WeightType& weightType)
+{
+    archive(weightType.windowName, weightType.parameters);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DirectionParameters& directionParameters)
+{
+    archive(directionParameters.unitVector,
+            directionParameters.sampleSpacing,
+            directionParameters.impulseResponseWidth,
+            directionParameters.sign,
+            directionParameters.impulseResponseBandwidth,
+            directionParameters.kCenter,
+            directionParameters.deltaK1,
+            directionParameters.deltaK2,
+            directionParameters.deltaKCOAPoly,
+            directionParameters.weightType,
+            directionParameters.weights);
+}
+
+static void snapshot(SnapshotArchive& archive, Grid& grid)
+{
+    archive(grid.imagePlane, grid.type, grid.timeCOAPoly, grid.row,
+            grid.col);
+}
+
+static void snapshot(SnapshotArchive& archive, TimelineSet& timelineSet)
+{
+    archive(timelineSet.tStart,
+            timelineSet.tEnd,
+            timelineSet.interPulsePeriodStart,
+            timelineSet.interPulsePeriodEnd,
+            timelineSet.interPulsePeriodPoly);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     InterPulsePeriod& interPulsePeriod)
+{
+    archive(interPulsePeriod.sets);
+}
+
+static void snapshot(SnapshotArchive& archive, Timeline& timeline)
+{
+    archive(timeline.collectStart, timeline.collectDuration,
+            timeline.interPulsePeriod);
+}
+
+static void snapshot(SnapshotArchive& archive, RcvAPC& rcvAPC)
+{
+    archive(rcvAPC.rcvAPCPolys);
+}
+
+static void snapshot(SnapshotArchive& archive, Position& position)
+{
+    archive(position.arpPoly, position.grpPoly, position.txAPCPoly,
+            position.rcvAPC);
+}
+
+static void snapshot(SnapshotArchive& archive, TxStep& txStep)
+{
+    archive(txStep.waveformIndex, txStep.txPolarization);
+}
+
+static void snapshot(SnapshotArchive& archive, WaveformParameters& waveform)
+{
+    archive(waveform.txPulseLength,
+            waveform.txRFBandwidth,
+            waveform.txFrequencyStart,
+            waveform.txFMRate,
+            waveform.rcvDemodType,
+            waveform.rcvWindowLength,
+            waveform.adcSampleRate,
+            waveform.rcvIFBandwidth,
+            waveform.rcvFrequencyStart,
+            waveform.rcvFMRate);
+}
+
+static void snapshot(SnapshotArchive& archive, ChannelParameters& channel)
+{
+    archive(channel.txRcvPolarization, channel.rcvAPCIndex);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     AreaDirectionParameters& direction)
+{
+    archive(direction.unitVector, direction.spacing, direction.elements,
+            direction.first);
+}
+
+static void snapshot(SnapshotArchive& archive, Segment& segment)
+{
+    archive(segment.startLine, segment.startSample, segment.endLine,
+            segment.endSample, segment.identifier);
+}
+
+static void snapshot(SnapshotArchive& archive, AreaPlane& plane)
+{
+    archive(plane.referencePoint, plane.xDirection, plane.yDirection,
+            plane.segmentList, plane.orientation);
+}
+
+static void snapshot(SnapshotArchive& archive, Area& area)
+{
+    archive(area.acpCorners, area.plane);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     RadarCollection& radarCollection)
+{
+    archive(radarCollection.refFrequencyIndex,
+            radarCollection.txFrequencyMin,
+            radarCollection.txFrequencyMax,
+            radarCollection.txPolarization,
+            radarCollection.polarizationHVAnglePoly,
+            radarCollection.txSequence,
+            radarCollection.waveform,
+            radarCollection.rcvChannels,
+            radarCollection.area,
+            radarCollection.parameters);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     RcvChannelProcessed& rcvChannelProcessed)
+{
+    archive(rcvChannelProcessed.numChannelsProcessed,
+            rcvChannelProcessed.prfScaleFactor,
+            rcvChannelProcessed.channelIndex);
+}
+
+static void snapshot(SnapshotArchive& archive, Distortion& distortion)
+{
+    archive(distortion.calibrationDate,
+            distortion.a,
+            distortion.f1,
+            distortion.q1,
+            distortion.q2,
+            distortion.f2,
+            distortion.q3,
+            distortion.q4,
+            distortion.gainErrorA,
+            distortion.gainErrorF1,
+            distortion.gainErrorF2,
+            distortion.phaseErrorF1,
+            distortion.phaseErrorF2);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     PolarizationCalibration& polarizationCalibration)
+{
+    archive(polarizationCalibration.hvAngleCompensationApplied,
+            polarizationCalibration.distortionCorrectionApplied,
+            polarizationCalibration.distortion);
+}
+
+static void snapshot(SnapshotArchive& archive, Processing& processing)
+{
+    archive(processing.type, processing.applied, processing.parameters);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ImageFormation& imageFormation)
+{
+    archive(imageFormation.segmentIdentifier,
+            imageFormation.rcvChannelProcessed,
+            imageFormation.txRcvPolarizationProc,
+            imageFormation.imageFormationAlgorithm,
+            imageFormation.tStartProc,
+            imageFormation.tEndProc,
+            imageFormation.txFrequencyProcMin,
+            imageFormation.txFrequencyProcMax,
+            imageFormation.slowTimeBeamCompensation,
+            imageFormation.imageBeamCompensation,
+            imageFormation.azimuthAutofocus,
+            imageFormation.rangeAutofocus,
+            imageFormation.processing,
+            imageFormation.polarizationCalibration);
+}
+
+static void snapshot(SnapshotArchive& archive, SCPCOA& scpcoa)
+{
+    archive(scpcoa.scpTime,
+            scpcoa.arpPos,
+            scpcoa.arpVel,
+            scpcoa.arpAcc,
+            scpcoa.sideOfTrack,
+            scpcoa.slantRange,
+            scpcoa.groundRange,
+            scpcoa.dopplerConeAngle,
+            scpcoa.grazeAngle,
+            scpcoa.incidenceAngle,
+            scpcoa.twistAngle,
+            scpcoa.slopeAngle,
+            scpcoa.azimAngle,
+            scpcoa.layoverAngle);
+}
+
+void snapshot(SnapshotArchive& archive,
+              ElectricalBoresight& electricalBoresight)
+{
+    archive(electricalBoresight.dcxPoly, electricalBoresight.dcyPoly);
+}
+
+void snapshot(SnapshotArchive& archive, GainAndPhasePolys& polys)
+{
+    archive(polys.gainPoly, polys.phasePoly);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     HalfPowerBeamwidths& halfPowerBeamwidths)
+{
+    archive(halfPowerBeamwidths.dcx, halfPowerBeamwidths.dcy);
+}
+
+static void snapshot(SnapshotArchive& archive, AntennaParameters& parameters)
+{
+    archive(parameters.xAxisPoly,
+            parameters.yAxisPoly,
+            parameters.frequencyZero,
+            parameters.electricalBoresight,
+            parameters.halfPowerBeamwidths,
+            parameters.array,
+            parameters.element,
+            parameters.gainBSPoly,
+            parameters.electricalBoresightFrequencyShift,
+            parameters.mainlobeFrequencyDilation);
+}
+
+static void snapshot(SnapshotArchive& archive, Antenna& antenna)
+{
+    archive(antenna.tx, antenna.rcv, antenna.twoWay);
+}
+
+static void snapshot(SnapshotArchive& archive, SlowTimeDeskew& deskew)
+{
+    archive(deskew.applied, deskew.slowTimeDeskewPhasePoly);
+}
+
+static void snapshot(SnapshotArchive& archive, PFA& pfa)
+{
+    archive(pfa.focusPlaneNormal,
+            pfa.imagePlaneNormal,
+            pfa.polarAngleRefTime,
+            pfa.polarAnglePoly,
+            pfa.spatialFrequencyScaleFactorPoly,
+            pfa.krg1,
+            pfa.krg2,
+            pfa.kaz1,
+            pfa.kaz2,
+            pfa.slowTimeDeskew);
+}
+
+static void snapshot(SnapshotArchive& archive, RMAT& rmat)
+{
+    archive(rmat.refTime,
+            rmat.refPos,
+            rmat.refVel,
+            rmat.distRefLinePoly,
+            rmat.cosDCACOAPoly,
+            rmat.kx1,
+            rmat.kx2,
+            rmat.ky1,
+            rmat.ky2,
+            rmat.dopConeAngleRef);
+}
+
+static void snapshot(SnapshotArchive& archive, RMCR& rmcr)
+{
+    archive(rmcr.refPos, rmcr.refVel, rmcr.dopConeAngleRef);
+}
+
+static void snapshot(SnapshotArchive& archive, INCA& inca)
+{
+    archive(inca.timeCAPoly,
+            inca.rangeCA,
+            inca.freqZero,
+            inca.dopplerRateScaleFactorPoly,
+            inca.dopplerCentroidPoly,
+            inca.dopplerCentroidCOA);
+}
+
+static void snapshot(SnapshotArchive& archive, RMA& rma)
+{
+    archive(rma.algoType, rma.rmat, rma.rmcr, rma.inca);
+}
+
+static void snapshot(SnapshotArchive& archive, RgAzComp& rgAzComp)
+{
+    archive(rgAzComp.azSF, rgAzComp.kazPoly);
+}
+
+static void snapshot(SnapshotArchive& archive, ComplexData& data)
+{
+    std::string version = data.getVersion();
+    archive(version);
+    data.setVersion(version);
+
+    archive(data.collectionInformation,
+            data.imageCreation,
+            data.imageData,
+            data.geoData,
+            data.grid,
+            data.timeline,
+            data.position,
+            data.radarCollection,
+            data.imageFormation,
+            data.scpcoa,
+            data.radiometric,
+            data.antenna,
+            data.errorStatistics,
+            data.matchInformation,
+            data.pfa,
+            data.rma,
+            data.rgAzComp);
+}
+
+void serializeSnapshot(const ComplexData& data,
+                       std::vector<std::byte>& buffer)
+{
+    SnapshotArchive archive(SNAPSHOT_IDENTIFIER, buffer);
+
+    // Writing only reads the fields
+    archive(const_cast<ComplexData&>(data));
+}
+
+std::unique_ptr<ComplexData>
+deserializeSnapshot(std::span<const std::byte> buffer)
+{
+    SnapshotArchive archive(SNAPSHOT_IDENTIFIER, buffer);
+    auto data = std::make_unique<ComplexData>();
+    archive(*data);
+    archive.finish();
+    return data;
+}
+}
+}
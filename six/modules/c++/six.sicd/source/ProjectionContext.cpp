@@ -0,0 +1,187 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2017, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/sicd/ProjectionContext.h>
+
+#include <six/sicd/AreaPlaneUtility.h>
+#include <six/sicd/Utilities.h>
+
+namespace six
+{
+namespace sicd
+{
+ProjectionContext::ProjectionContext(const ComplexData& complexData) :
+    mComplexData(static_cast<ComplexData*>(complexData.clone())),
+    mGeometry(Utilities::getSceneGeometry(mComplexData.get())),
+    mProjectionModel(Utilities::getProjectionModel(mComplexData.get(),
+                                                   mGeometry.get())),
+    mAreaPlane(AreaPlaneUtility::getAreaPlane(*mComplexData)),
+    mGroundPlaneNormal(Utilities::getGroundPlaneNormal(*mComplexData)),
+    mOutputPlaneTransform(
+            types::RowCol<double>(mAreaPlane.xDirection->spacing,
+                                  mAreaPlane.yDirection->spacing),
+            mAreaPlane.referencePoint.rowCol,
+            mAreaPlane.xDirection->unitVector,
+            mAreaPlane.yDirection->unitVector,
+            mAreaPlane.referencePoint.ecef),
+    mECEFToLLA(/*needed by ICC*/),
+    mOutputSampleSpacing(mAreaPlane.xDirection->spacing,
+                         mAreaPlane.yDirection->spacing),
+    mOutputCenterPixel(
+            static_cast<double>(mAreaPlane.xDirection->elements / 2 + 1),
+            static_cast<double>(mAreaPlane.yDirection->elements / 2 + 1)),
+    mSlantSampleSpacing(mComplexData->grid->row->sampleSpacing,
+                        mComplexData->grid->col->sampleSpacing),
+    mSlantOffset(
+            mComplexData->imageData->scpPixel.row -
+                    static_cast<double>(mComplexData->imageData->firstRow),
+            mComplexData->imageData->scpPixel.col -
+                    static_cast<double>(mComplexData->imageData->firstCol))
+{
+}
+
+const scene::ProjectionPolynomialFitter&
+ProjectionContext::getPolynomialFitter() const
+{
+    std::call_once(mFitterFlag, [this]()
+    {
+        mFitter = createPolynomialFitter(
+                scene::ProjectionPolynomialFitter::DEFAULTS_POINTS_1D, false);
+    });
+    return *mFitter;
+}
+
+std::unique_ptr<scene::ProjectionPolynomialFitter>
+ProjectionContext::createPolynomialFitter(
+        size_t numPoints1D,
+        bool sampleWithinValidDataPolygon,
+        size_t numThreads) const
+{
+    types::RowCol<size_t> offset;
+    types::RowCol<size_t> extent;
+    mComplexData->getOutputPlaneOffsetAndExtent(mAreaPlane, offset, extent);
+
+    if (!sampleWithinValidDataPolygon)
+    {
+        return std::unique_ptr<scene::ProjectionPolynomialFitter>(
+                new scene::ProjectionPolynomialFitter(*mProjectionModel,
+                                                      mOutputPlaneTransform,
+                                                      offset,
+                                                      extent,
+                                                      numPoints1D,
+                                                      numThreads));
+    }
+
+    // Get the size of the output plane image.
+    const types::RowCol<size_t> fullExtent(mAreaPlane.xDirection->elements,
+                                           mAreaPlane.yDirection->elements);
+
+    // Get the valid data polygon in the output plane.
+    std::vector<types::RowCol<double> > polygon;
+    Utilities::projectValidDataPolygonToOutputPlane(*this, polygon);
+
+    return std::unique_ptr<scene::ProjectionPolynomialFitter>(
+            new scene::ProjectionPolynomialFitter(*mProjectionModel,
+                                                  mOutputPlaneTransform,
+                                                  fullExtent,
+                                                  offset,
+                                                  extent,
+                                                  polygon,
+                                                  numPoints1D,
+                                                  numThreads));
+}
+
+Vector3 ProjectionContext::slantPixelToECEF(
+        const types::RowCol<double>& pixel) const
+{
+    // Convert slant pixel to meters from scene center, then project into
+    // the ground plane
+    const types::RowCol<double> imagePt(mComplexData->pixelToImagePoint(pixel));
+    return mProjectionModel->imageToScene(imagePt,
+                                          mGeometry->getReferencePosition(),
+                                          mGroundPlaneNormal);
+}
+
+types::RowCol<double> ProjectionContext::slantToOutputPixel(
+        const types::RowCol<double>& pixel) const
+{
+    const types::RowCol<double> spXY(mComplexData->pixelToImagePoint(pixel));
+
+    // Convert to output plane ECEF.
+    const Vector3& opORPECEF = mAreaPlane.referencePoint.ecef;
+    const Vector3 opECEF =
+            mProjectionModel->imageToScene(spXY, opORPECEF,
+                                           mGroundPlaneNormal);
+
+    // Convert ECEF to output distance to the output plane ORP.
+    const Vector3 diffECEF = opECEF - opORPECEF;
+    const double opX = diffECEF.dot(mAreaPlane.xDirection->unitVector);
+    const double opY = diffECEF.dot(mAreaPlane.yDirection->unitVector);
+
+    // Convert XY to pixels.
+    return types::RowCol<double>(
+            opX / mOutputSampleSpacing.row + mOutputCenterPixel.row,
+            opY / mOutputSampleSpacing.col + mOutputCenterPixel.col);
+}
+
+types::RowCol<double> ProjectionContext::outputToSlantPixel(
+        const types::RowCol<double>& pixel) const
+{
+    // Convert output plane pixel to ECEF.
+    const Vector3 ecef = mOutputPlaneTransform.rowColToECEF(pixel);
+
+    // Convert ECEF to slant plane distance from SCP.
+    double timeCOA = 0.0;
+    const types::RowCol<double> spXY =
+            mProjectionModel->sceneToImage(ecef, &timeCOA);
+
+    // Convert to slant plane pixel.
+    return spXY / mSlantSampleSpacing + mSlantOffset;
+}
+
+std::vector<types::RowCol<double> >
+ProjectionContext::getSlantValidData() const
+{
+    // If we don't have a valid data polygon, then the entire SICD is valid.
+    const std::vector<RowColInt>& validData =
+            mComplexData->imageData->validData;
+    std::vector<types::RowCol<double> > spPixels;
+    if (validData.empty())
+    {
+        const types::RowCol<double> extent(getExtent(*mComplexData));
+        spPixels.push_back(types::RowCol<double>(0, 0));
+        spPixels.push_back(types::RowCol<double>(0, extent.col - 1));
+        spPixels.push_back(types::RowCol<double>(extent.row - 1,
+                                                 extent.col - 1));
+        spPixels.push_back(types::RowCol<double>(extent.row - 1, 0));
+    }
+    else
+    {
+        spPixels.reserve(validData.size());
+        for (const auto& vertex : validData)
+        {
+            spPixels.push_back(types::RowCol<double>(vertex));
+        }
+    }
+    return spPixels;
+}
+}
+}
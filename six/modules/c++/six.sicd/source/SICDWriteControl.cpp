@@ -20,9 +20,173 @@
  *
  */
 
+#include <string.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+#include <mt/ThreadGroup.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
 #include <six/sicd/SICDByteProvider.h>
 #include <six/sicd/SICDWriteControl.h>
 
+namespace
+{
+// Bytes of rows swapped and written at once
+constexpr size_t SWAP_CHUNK_BYTES = 1024 * 1024;
+
+// Swapping is bound by memory bandwidth, so more threads don't help
+constexpr size_t MAX_SWAP_THREADS = 4;
+
+// Chunks swapped into scratch buffers by the workers and written in order
+// by the caller, at most one buffer's worth of chunks ahead of the writer
+class SwapPipeline final
+{
+public:
+    typedef std::function<void(size_t, std::byte*)> SwapFunc;
+    typedef std::function<void(size_t, const std::byte*)> WriteFunc;
+
+    SwapPipeline(size_t numChunks,
+                 std::vector<std::vector<std::byte> >& buffers,
+                 size_t numSlots,
+                 const SwapFunc& swap) :
+        mNumChunks(numChunks),
+        mBuffers(buffers),
+        mNumSlots(numSlots),
+        mSwap(swap),
+        mFilled(numSlots, numChunks)
+    {
+    }
+
+    // Worker loop: swap chunks in order, a few ahead of the writer
+    void work()
+    {
+        for (size_t chunk = nextChunk(); chunk < mNumChunks;
+             chunk = nextChunk())
+        {
+            const size_t slot = chunk % mNumSlots;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [&]()
+                {
+                    return mAborted || chunk < mNumWritten + mNumSlots;
+                });
+                if (mAborted)
+                {
+                    return;
+                }
+            }
+
+            try
+            {
+                mSwap(chunk, mBuffers[slot].data());
+            }
+            catch (...)
+            {
+                abort(std::current_exception());
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFilled[slot] = chunk;
+            mCondition.notify_all();
+        }
+    }
+
+    // Writer loop: write each chunk once it's swapped
+    void write(const WriteFunc& write)
+    {
+        for (size_t chunk = 0; chunk < mNumChunks; ++chunk)
+        {
+            const size_t slot = chunk % mNumSlots;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [&]()
+                {
+                    return mAborted || mFilled[slot] == chunk;
+                });
+                if (mAborted)
+                {
+                    return;
+                }
+            }
+
+            try
+            {
+                write(chunk, mBuffers[slot].data());
+            }
+            catch (...)
+            {
+                abort(std::current_exception());
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            ++mNumWritten;
+            mCondition.notify_all();
+        }
+    }
+
+    void abort(std::exception_ptr error)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mError)
+        {
+            mError = error;
+        }
+        mAborted = true;
+        mCondition.notify_all();
+    }
+
+    std::exception_ptr getError() const
+    {
+        return mError;
+    }
+
+private:
+    size_t nextChunk()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mNextChunk++;
+    }
+
+    const size_t mNumChunks;
+    std::vector<std::vector<std::byte> >& mBuffers;
+    const size_t mNumSlots;
+    const SwapFunc mSwap;
+
+    std::vector<size_t> mFilled; // chunk in each slot
+    size_t mNumWritten = 0;
+    size_t mNextChunk = 0;
+    bool mAborted = false;
+    std::exception_ptr mError;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+};
+
+class SwapRunnable final : public sys::Runnable
+{
+public:
+    explicit SwapRunnable(SwapPipeline& pipeline) :
+        mPipeline(pipeline)
+    {
+    }
+
+    void run() override
+    {
+        mPipeline.work();
+    }
+
+private:
+    SwapPipeline& mPipeline;
+};
+}
+
 namespace six
 {
 namespace sicd
@@ -89,10 +253,7 @@ void SICDWriteControl::writeHeaders()
     write(byteProvider.getDesSubheaderAndData());
 }
 
-void SICDWriteControl::save(void* imageData,
-                            const types::RowCol<size_t>& offset,
-                            const types::RowCol<size_t>& dims,
-                            bool restoreData)
+void SICDWriteControl::prepareToSave()
 {
     if (getContainer().get() == nullptr)
     {
@@ -106,22 +267,24 @@ void SICDWriteControl::save(void* imageData,
         writeHeaders();
         mHaveWrittenHeaders = true;
     }
+}
 
-    const six::Data* const data = getContainer()->getData(0);
-    constexpr size_t NUM_BANDS = 2;
-    const size_t numBytesPerPixel = data->getNumBytesPerPixel() / NUM_BANDS;
-    const size_t numPixelsTotal = dims.area() * NUM_BANDS;
-    const bool doByteSwap = shouldByteSwap();
-
-    // Byte swap if needed
-    if (doByteSwap)
+std::vector<SICDWriteControl::RowChunk>
+SICDWriteControl::getRowChunks(const types::RowCol<size_t>& offset,
+                               const types::RowCol<size_t>& dims,
+                               size_t maxChunkBytes) const
+{
+    std::vector<RowChunk> chunks;
+    if (dims.area() == 0)
     {
-        sys::byteSwap(imageData,
-                      static_cast<unsigned short>(numBytesPerPixel),
-                      numPixelsTotal);
+        return chunks;
     }
 
+    const six::Data* const data = getContainer()->getData(0);
+    const size_t numBytesPerPixel = data->getNumBytesPerPixel();
     const size_t globalNumCols = data->getNumCols();
+    const size_t maxRowsPerChunk = std::max<size_t>(
+            maxChunkBytes / (dims.col * numBytesPerPixel), 1);
 
     for (size_t seg = 0; seg < mImageSegmentInfo.size(); ++seg)
     {
@@ -133,58 +296,185 @@ void SICDWriteControl::save(void* imageData,
                                        startGlobalRowToWrite,
                                        numRowsToWrite))
         {
-            // Figure out what offset of 'imageData' we're writing from
-            const size_t startLocalRowToWrite =
-                    startGlobalRowToWrite - offset.row;
-            const size_t numBytesPerRow = dims.col * numBytesPerPixel * NUM_BANDS;
-            const std::byte* imageDataPtr =
-                    static_cast<std::byte*>(imageData) +
-                    startLocalRowToWrite * numBytesPerRow;
-
-            // Now figure out our offset into the segment
-            const auto segStartRow = imageSegmentInfo.getFirstRow();
-            const size_t startRowInSegToWrite =
-                    startGlobalRowToWrite - segStartRow;
-            const size_t pixelOffset =
-                    startRowInSegToWrite * globalNumCols + offset.col;
-            size_t byteOffset = mImageDataStart[seg] +
-                    pixelOffset * numBytesPerPixel * NUM_BANDS;
-
-            // TODO: For SIDD we'll have to handle blocking too
-
-            if (dims.col == globalNumCols)
-            {
-                // Life is easy - one write
-                mIO->seek(static_cast<nitf::Off>(byteOffset), NITF_SEEK_SET);
-                mIO->write(imageDataPtr,
-                           numRowsToWrite * dims.col * NUM_BANDS *
-                               numBytesPerPixel);
-            }
-            else
+            const size_t endGlobalRowToWrite =
+                    startGlobalRowToWrite + numRowsToWrite;
+            for (size_t row = startGlobalRowToWrite, numRows;
+                 row < endGlobalRowToWrite;
+                 row += numRows)
             {
-                // Need to write out partial rows
-                const size_t rowSeekStride =
-                        globalNumCols * numBytesPerPixel * NUM_BANDS;
-
-                for (size_t row = 0;
-                     row < numRowsToWrite;
-                     ++row, byteOffset += rowSeekStride,
-                         imageDataPtr += numBytesPerRow)
-                {
-                    mIO->seek(static_cast<nitf::Off>(byteOffset), NITF_SEEK_SET);
-                    mIO->write(imageDataPtr, numBytesPerRow);
-                }
+                numRows = std::min(maxRowsPerChunk, endGlobalRowToWrite - row);
+
+                // Figure out our offset into the segment
+                const size_t pixelOffset =
+                        (row - imageSegmentInfo.getFirstRow()) *
+                                globalNumCols + offset.col;
+
+                RowChunk chunk;
+                chunk.firstRow = row - offset.row;
+                chunk.numRows = numRows;
+                chunk.byteOffset = mImageDataStart[seg] +
+                        static_cast<nitf::Off>(pixelOffset * numBytesPerPixel);
+                chunks.push_back(chunk);
             }
         }
     }
+    return chunks;
+}
+
+void SICDWriteControl::writeRows(const std::byte* rows,
+                                 const RowChunk& chunk,
+                                 size_t numBytesPerRow)
+{
+    const six::Data* const data = getContainer()->getData(0);
+    const size_t rowSeekStride =
+            data->getNumCols() * data->getNumBytesPerPixel();
+
+    if (numBytesPerRow == rowSeekStride)
+    {
+        // Life is easy - one write
+        mIO->seek(chunk.byteOffset, NITF_SEEK_SET);
+        mIO->write(rows, chunk.numRows * numBytesPerRow);
+    }
+    else
+    {
+        // Need to write out partial rows
+        nitf::Off byteOffset = chunk.byteOffset;
+        for (size_t row = 0;
+             row < chunk.numRows;
+             ++row, byteOffset += rowSeekStride, rows += numBytesPerRow)
+        {
+            mIO->seek(byteOffset, NITF_SEEK_SET);
+            mIO->write(rows, numBytesPerRow);
+        }
+    }
+}
 
-    // Byte swap back if needed
-    if (doByteSwap && restoreData)
+void SICDWriteControl::save(void* imageData,
+                            const types::RowCol<size_t>& offset,
+                            const types::RowCol<size_t>& dims,
+                            bool restoreData)
+{
+    if (restoreData)
+    {
+        // Swapping copies leaves nothing to restore
+        save(static_cast<const void*>(imageData), offset, dims);
+        return;
+    }
+
+    prepareToSave();
+
+    const six::Data* const data = getContainer()->getData(0);
+    constexpr size_t NUM_BANDS = 2;
+    const size_t numBytesPerPixel = data->getNumBytesPerPixel() / NUM_BANDS;
+    const size_t numPixelsTotal = dims.area() * NUM_BANDS;
+
+    // Byte swap if needed
+    if (shouldByteSwap())
     {
         sys::byteSwap(imageData,
                       static_cast<unsigned short>(numBytesPerPixel),
                       numPixelsTotal);
     }
+
+    const std::byte* const input = static_cast<const std::byte*>(imageData);
+    const size_t numBytesPerRow = dims.col * data->getNumBytesPerPixel();
+    for (const auto& chunk :
+         getRowChunks(offset, dims, std::numeric_limits<size_t>::max()))
+    {
+        writeRows(input + chunk.firstRow * numBytesPerRow, chunk,
+                  numBytesPerRow);
+    }
+}
+
+void SICDWriteControl::save(const void* imageData,
+                            const types::RowCol<size_t>& offset,
+                            const types::RowCol<size_t>& dims)
+{
+    prepareToSave();
+
+    const six::Data* const data = getContainer()->getData(0);
+    constexpr size_t NUM_BANDS = 2;
+    const size_t numBytesPerBand = data->getNumBytesPerPixel() / NUM_BANDS;
+    const size_t numBytesPerRow = dims.col * data->getNumBytesPerPixel();
+    const std::byte* const input = static_cast<const std::byte*>(imageData);
+
+    if (!shouldByteSwap())
+    {
+        for (const auto& chunk :
+             getRowChunks(offset, dims, std::numeric_limits<size_t>::max()))
+        {
+            writeRows(input + chunk.firstRow * numBytesPerRow, chunk,
+                      numBytesPerRow);
+        }
+        return;
+    }
+
+    const std::vector<RowChunk> chunks =
+            getRowChunks(offset, dims, SWAP_CHUNK_BYTES);
+    size_t maxChunkBytes = 0;
+    for (const auto& chunk : chunks)
+    {
+        maxChunkBytes = std::max(maxChunkBytes,
+                                 chunk.numRows * numBytesPerRow);
+    }
+
+    const auto swapChunk = [&](size_t index, std::byte* output)
+    {
+        const RowChunk& chunk = chunks[index];
+        const size_t numBytes = chunk.numRows * numBytesPerRow;
+        memcpy(output, input + chunk.firstRow * numBytesPerRow, numBytes);
+        sys::byteSwap(output,
+                      static_cast<unsigned short>(numBytesPerBand),
+                      numBytes / numBytesPerBand);
+    };
+    const auto writeChunk = [&](size_t index, const std::byte* rows)
+    {
+        writeRows(rows, chunks[index], numBytesPerRow);
+    };
+
+    // One worker per chunk after the first, up to the limit
+    const size_t numThreads = chunks.empty() ? 0 :
+            std::min({chunks.size() - 1, MAX_SWAP_THREADS,
+                      static_cast<size_t>(sys::OS().getNumCPUs())});
+    const size_t numSlots = numThreads == 0 ?
+            std::min<size_t>(chunks.size(), 1) :
+            std::min(2 * numThreads, chunks.size());
+
+    // The buffers are kept for the next call
+    if (mSwapBuffers.size() < numSlots)
+    {
+        mSwapBuffers.resize(numSlots);
+    }
+    for (size_t ii = 0; ii < numSlots; ++ii)
+    {
+        if (mSwapBuffers[ii].size() < maxChunkBytes)
+        {
+            mSwapBuffers[ii].resize(maxChunkBytes);
+        }
+    }
+
+    if (numThreads == 0)
+    {
+        for (size_t ii = 0; ii < chunks.size(); ++ii)
+        {
+            swapChunk(ii, mSwapBuffers[0].data());
+            writeChunk(ii, mSwapBuffers[0].data());
+        }
+        return;
+    }
+
+    SwapPipeline pipeline(chunks.size(), mSwapBuffers, numSlots, swapChunk);
+    mt::ThreadGroup threads;
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        threads.createThread(std::make_unique<SwapRunnable>(pipeline));
+    }
+    pipeline.write(writeChunk);
+    threads.joinAll();
+    if (pipeline.getError())
+    {
+        std::rethrow_exception(pipeline.getError());
+    }
 }
 
 void SICDWriteControl::close()
@@ -47,6 +47,14 @@ SlantPlanePixelTransformer::SlantPlanePixelTransformer(
     mGroundPlaneNormal.normalize();
 }
 
+SlantPlanePixelTransformer::SlantPlanePixelTransformer(
+    const ProjectionContext& context) :
+    SlantPlanePixelTransformer(context.getComplexData(),
+                               context.getSceneGeometry(),
+                               context.getProjectionModel())
+{
+}
+
 scene::Vector3 SlantPlanePixelTransformer::toECEF(
     const types::RowCol<double>& pixel) const
 {
@@ -376,15 +376,7 @@ static void getModelComponents_(const ComplexData& complexData,
 {
     geometry.reset(Utilities::getSceneGeometry(&complexData));
     projectionModel.reset(Utilities::getProjectionModel(&complexData, geometry.get()));
-
-    if (AreaPlaneUtility::hasAreaPlane(complexData))
-    {
-        areaPlane = *complexData.radarCollection->area->plane;
-    }
-    else
-    {
-        AreaPlaneUtility::deriveAreaPlane(complexData, areaPlane);
-    }
+    areaPlane = AreaPlaneUtility::getAreaPlane(complexData);
 }
 #if !CODA_OSS_cpp17
 void Utilities::getModelComponents(const ComplexData& complexData,
@@ -405,56 +397,14 @@ void Utilities::getModelComponents(const ComplexData& complexData,
 
 mem::auto_ptr<scene::ProjectionPolynomialFitter> Utilities::getPolynomialFitter(const ComplexData& complexData,
         size_t numPoints1D,
-        bool sampleWithinValidDataPolygon)
-{
-    std::unique_ptr<scene::SceneGeometry> geometry;
-    std::unique_ptr<scene::ProjectionModel> projectionModel;
-    AreaPlane areaPlane;
-
-    Utilities::getModelComponents(complexData,
-                                  geometry,
-                                  projectionModel,
-                                  areaPlane);
-
-    const RowColDouble sampleSpacing(areaPlane.xDirection->spacing,
-                                     areaPlane.yDirection->spacing);
-    const scene::PlanarGridECEFTransform ecefTransform(
-            sampleSpacing,
-            areaPlane.referencePoint.rowCol,
-            areaPlane.xDirection->unitVector,
-            areaPlane.yDirection->unitVector,
-            areaPlane.referencePoint.ecef);
-
-    types::RowCol<size_t> offset;
-    types::RowCol<size_t> extent;
-    complexData.getOutputPlaneOffsetAndExtent(areaPlane, offset, extent);
-
-    if (!sampleWithinValidDataPolygon)
-    {
-        return mem::auto_ptr<scene::ProjectionPolynomialFitter>(
-                new scene::ProjectionPolynomialFitter(*projectionModel,
-                                                      ecefTransform,
-                                                      offset,
-                                                      extent,
-                                                      numPoints1D));
-    }
-
-    // Get the size of the output plane image.
-    const types::RowCol<size_t> fullExtent(areaPlane.xDirection->elements,
-                                     areaPlane.yDirection->elements);
-
-    // Get the valid data polygon in the output plane.
-    std::vector<types::RowCol<double>> polygon;
-    Utilities::projectValidDataPolygonToOutputPlane(complexData, polygon);
-
+        bool sampleWithinValidDataPolygon,
+        size_t numThreads)
+{
+    const ProjectionContext context(complexData);
     return mem::auto_ptr<scene::ProjectionPolynomialFitter>(
-            new scene::ProjectionPolynomialFitter(*projectionModel,
-                                                  ecefTransform,
-                                                  fullExtent,
-                                                  offset,
-                                                  extent,
-                                                  polygon,
-                                                  numPoints1D));
+            context.createPolynomialFitter(
+                    numPoints1D, sampleWithinValidDataPolygon,
+                    numThreads).release());
 }
 
 void Utilities::getValidDataPolygon(
@@ -1483,12 +1433,14 @@ void Utilities::fitXYProjectionPolys(
                                           dims.col,
                                           slantMesh.getY().data());
 
-    outputXYToSlantX =
-            math::poly::fit(outputX, outputY, slantX, orderX, orderY);
-    outputXYToSlantY =
-            math::poly::fit(outputX, outputY, slantY, orderX, orderY);
-    slantXYToOutputX = math::poly::fit(slantX, slantY, outputX, orderX, orderY);
-    slantXYToOutputY = math::poly::fit(slantX, slantY, outputY, orderX, orderY);
+    // Each direction shares its design matrix between the X and Y fits
+    const scene::PolynomialFit2D outputFit(outputX, outputY, orderX, orderY);
+    outputXYToSlantX = outputFit.fit(slantX);
+    outputXYToSlantY = outputFit.fit(slantY);
+
+    const scene::PolynomialFit2D slantFit(slantX, slantY, orderX, orderY);
+    slantXYToOutputX = slantFit.fit(outputX);
+    slantXYToOutputY = slantFit.fit(outputY);
 }
 
 void Utilities::projectPixelsToOutputPlane(
@@ -1496,46 +1448,21 @@ void Utilities::projectPixelsToOutputPlane(
         const std::vector<types::RowCol<double>>& spPixels,
         std::vector<types::RowCol<double>>& opPixels)
 {
-    std::unique_ptr<scene::SceneGeometry> geometry;
-    std::unique_ptr<scene::ProjectionModel> projectionModel;
-    AreaPlane areaPlane;
-
-    Utilities::getModelComponents(complexData,
-                                  geometry,
-                                  projectionModel,
-                                  areaPlane);
-
-    const types::RowCol<double> opSampleSpacing(areaPlane.xDirection->spacing,
-                                                areaPlane.yDirection->spacing);
-
-    const types::RowCol<double> opCenterPixel(
-            static_cast<double>(areaPlane.xDirection->elements / 2 + 1),
-            static_cast<double>(areaPlane.yDirection->elements / 2 + 1));
-
-    const six::Vector3 opORPECEF = areaPlane.referencePoint.ecef;
-    const six::Vector3 opZ = Utilities::getGroundPlaneNormal(complexData);
+    projectPixelsToOutputPlane(ProjectionContext(complexData),
+                               spPixels,
+                               opPixels);
+}
 
+void Utilities::projectPixelsToOutputPlane(
+        const ProjectionContext& context,
+        const std::vector<types::RowCol<double>>& spPixels,
+        std::vector<types::RowCol<double>>& opPixels)
+{
     // Project slant plane pixels to output plane pixels.
     opPixels.resize(spPixels.size());
     for (size_t ii = 0; ii < spPixels.size(); ++ii)
     {
-        const types::RowCol<double> spXY(
-                complexData.pixelToImagePoint(spPixels[ii]));
-
-        // Convert to output plane ECEF.
-        const six::Vector3 opECEF =
-                projectionModel->imageToScene(spXY, opORPECEF, opZ);
-
-        // Convert ECEF to output distance to the output plane ORP.
-        const six::Vector3 diffECEF = opECEF - opORPECEF;
-        const double opX = diffECEF.dot(areaPlane.xDirection->unitVector);
-        const double opY = diffECEF.dot(areaPlane.yDirection->unitVector);
-
-        // Convert XY to pixels.
-        opPixels[ii] = types::RowCol<double>(opX / opSampleSpacing.row +
-                                                     opCenterPixel.row,
-                                             opY / opSampleSpacing.col +
-                                                     opCenterPixel.col);
+        opPixels[ii] = context.slantToOutputPixel(spPixels[ii]);
     }
 }
 
@@ -1543,30 +1470,15 @@ void Utilities::projectValidDataPolygonToOutputPlane(
         const six::sicd::ComplexData& complexData,
         std::vector<types::RowCol<double>>& opPixels)
 {
-    // If we don't have a valid data polygon, then the entire SICD is valid.
-    std::vector<six::RowColInt> validData = complexData.imageData->validData;
-    if (validData.size() == 0)
-    {
-        // Get dimensions of SICD.
-        const types::RowCol<ptrdiff_t> extent(getExtent(complexData));
-        const auto numRows = extent.row;
-        const auto numCols = extent.col;
-
-        validData.push_back(six::RowColInt(0, 0));
-        validData.push_back(six::RowColInt(0, numCols - 1));
-        validData.push_back(six::RowColInt(numRows - 1, numCols - 1));
-        validData.push_back(six::RowColInt(numRows - 1, 0));
-    }
-
-    // Convert to double coordinates.
-    std::vector<types::RowCol<double>> spPixels(validData.size());
-    for (size_t ii = 0; ii < validData.size(); ++ii)
-    {
-        spPixels[ii] = validData[ii];
-    }
+    projectValidDataPolygonToOutputPlane(ProjectionContext(complexData),
+                                         opPixels);
+}
 
-    // Project to the output plane.
-    projectPixelsToOutputPlane(complexData, spPixels, opPixels);
+void Utilities::projectValidDataPolygonToOutputPlane(
+        const ProjectionContext& context,
+        std::vector<types::RowCol<double>>& opPixels)
+{
+    projectPixelsToOutputPlane(context, context.getSlantValidData(), opPixels);
 }
 
 void Utilities::projectPixelsToSlantPlane(
@@ -1574,47 +1486,21 @@ void Utilities::projectPixelsToSlantPlane(
         const std::vector<types::RowCol<double>>& opPixels,
         std::vector<types::RowCol<double>>& spPixels)
 {
-    std::unique_ptr<scene::SceneGeometry> geometry;
-    std::unique_ptr<scene::ProjectionModel> projectionModel;
-    AreaPlane areaPlane;
-
-    Utilities::getModelComponents(complexData,
-                                  geometry,
-                                  projectionModel,
-                                  areaPlane);
-
-    const types::RowCol<double> opSampleSpacing(areaPlane.xDirection->spacing,
-                                                areaPlane.yDirection->spacing);
-    const scene::PlanarGridECEFTransform ecefTransform(
-            opSampleSpacing,
-            areaPlane.referencePoint.rowCol,
-            areaPlane.xDirection->unitVector,
-            areaPlane.yDirection->unitVector,
-            areaPlane.referencePoint.ecef);
-    const types::RowCol<double> spSampleSpacing(
-            complexData.grid->row->sampleSpacing,
-            complexData.grid->col->sampleSpacing);
-    const types::RowCol<double> spOrigOffset(
-            static_cast<double>(complexData.imageData->firstRow),
-            static_cast<double>(complexData.imageData->firstCol));
-    const types::RowCol<double> spSCP(complexData.imageData->scpPixel);
-    const types::RowCol<double> spOffset(spSCP.row - spOrigOffset.row,
-                                         spSCP.col - spOrigOffset.col);
+    projectPixelsToSlantPlane(ProjectionContext(complexData),
+                              opPixels,
+                              spPixels);
+}
 
+void Utilities::projectPixelsToSlantPlane(
+        const ProjectionContext& context,
+        const std::vector<types::RowCol<double>>& opPixels,
+        std::vector<types::RowCol<double>>& spPixels)
+{
     // Project output plane pixels to slant plane pixels.
     spPixels.resize(opPixels.size());
     for (size_t ii = 0; ii < opPixels.size(); ++ii)
     {
-        // Convert output plane pixel to ECEF.
-        const scene::Vector3 ecef = ecefTransform.rowColToECEF(opPixels[ii]);
-
-        // Convert ECEF to slant plane distance from SCP.
-        double timeCOA = 0.0;
-        const types::RowCol<double> spXY =
-                projectionModel->sceneToImage(ecef, &timeCOA);
-
-        // Convert to slant plane pixel.
-        spPixels[ii] = (spXY / spSampleSpacing + spOffset);
+        spPixels[ii] = context.outputToSlantPixel(opPixels[ii]);
     }
 }
 }
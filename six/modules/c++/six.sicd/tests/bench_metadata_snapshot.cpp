@@ -0,0 +1,101 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Times loading SICD metadata from XML vs. from a six::MetadataSnapshot
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <import/cli.h>
+#include <import/six.h>
+#include <import/six/sicd.h>
+#include <six/sicd/MetadataSnapshot.h>
+#include <sys/StopWatch.h>
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Benchmark loading SICD metadata from XML vs. a snapshot");
+        parser.addArgument("-i --iterations", "Number of times to load each",
+                           cli::STORE, "iterations", "NUM")->
+                setDefault(100);
+        parser.addArgument("input", "Input SICD XML files", cli::STORE,
+                           "input", "FILE", 1, -1);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+        const size_t numIterations = options->get<size_t>("iterations");
+
+        const cli::Value* const inputs = options->getValue("input");
+        for (size_t ii = 0; ii < inputs->size(); ++ii)
+        {
+            const std::string pathname = inputs->get<std::string>(ii);
+            const std::vector<std::filesystem::path>* const noSchemaPaths =
+                    nullptr;
+            const std::u8string xml = six::sicd::Utilities::toXMLString(
+                    *six::sicd::Utilities::parseDataFromFile(pathname,
+                                                             noSchemaPaths),
+                    noSchemaPaths);
+
+            sys::RealTimeStopWatch sw;
+            sw.start();
+            std::unique_ptr<six::sicd::ComplexData> fromXML;
+            for (size_t jj = 0; jj < numIterations; ++jj)
+            {
+                fromXML = six::sicd::Utilities::parseDataFromString(
+                        xml, noSchemaPaths);
+            }
+            const double xmlTime = sw.stop() / numIterations;
+
+            std::vector<std::byte> snapshot;
+            six::sicd::serializeSnapshot(*fromXML, snapshot);
+            const std::span<const std::byte> buffer(snapshot.data(),
+                                                    snapshot.size());
+
+            sw.clear();
+            sw.start();
+            for (size_t jj = 0; jj < numIterations; ++jj)
+            {
+                six::sicd::deserializeSnapshot(buffer);
+            }
+            const double snapshotTime = sw.stop() / numIterations;
+
+            std::cout << pathname << "\n"
+                      << "    XML: " << xml.size() << " bytes, "
+                      << xmlTime << " ms\n"
+                      << "    Snapshot: " << snapshot.size() << " bytes, "
+                      << snapshotTime << " ms\n";
+        }
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
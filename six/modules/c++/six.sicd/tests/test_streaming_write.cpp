@@ -257,6 +257,9 @@ struct Tester final
     // Writes where some rows are written out with only some of the cols
     void testMultipleWritesOfPartialRows();
 
+    // Writes from a const buffer, which must come back unchanged
+    void testWritesOfConstData();
+
 private:
     void normalWrite();
 
@@ -446,6 +449,42 @@ void Tester<DataTypeT>::testMultipleWritesOfPartialRows()
     compare("Multiple writes of partial rows");
 }
 
+template <typename DataTypeT>
+void Tester<DataTypeT>::testWritesOfConstData()
+{
+    const EnsureFileCleanup ensureFileCleanup(mTestPathname);
+
+    six::Options options;
+    setMaxProductSize(options);
+    six::sicd::SICDWriteControl sicdWriter(mTestPathname, mSchemaPaths);
+    sicdWriter.initialize(options, mContainer);
+
+    const std::vector<std::complex<DataTypeT> > original(mImage);
+    const std::complex<DataTypeT>* const imagePtr = mImagePtr;
+
+    // Rows [60, 123)
+    types::RowCol<size_t> offset(60, 0);
+    sicdWriter.save(imagePtr + offset.row * mDims.col,
+                    offset,
+                    types::RowCol<size_t>(63, mDims.col));
+
+    // Rows [0, 60)
+    offset.row = 0;
+    sicdWriter.save(imagePtr + offset.row * mDims.col,
+                    offset,
+                    types::RowCol<size_t>(60, mDims.col));
+
+    sicdWriter.close();
+
+    if (mImage != original)
+    {
+        std::cerr << "Writes of const data changed the data" << std::endl;
+        mSuccess = false;
+    }
+
+    compare("Writes of const data");
+}
+
 template <typename DataTypeT>
 bool doTests(const std::vector<std::string>& schemaPaths,
              bool setMaxProductSize,
@@ -465,6 +504,7 @@ bool doTests(const std::vector<std::string>& schemaPaths,
     tester.testSingleWrite();
     tester.testMultipleWritesOfFullRows();
     tester.testMultipleWritesOfPartialRows();
+    tester.testWritesOfConstData();
 
     return tester.success();
 }
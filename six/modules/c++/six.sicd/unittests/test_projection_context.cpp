@@ -0,0 +1,189 @@
+/* =========================================================================
+* This file is part of six.sicd-c++
+* =========================================================================
+*
+* (C) Copyright 2004 - 2017, MDA Information Systems LLC
+*
+* six.sicd-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <six/sicd/AreaPlaneUtility.h>
+#include <six/sicd/GeoLocator.h>
+#include <six/sicd/ProjectionContext.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+
+namespace
+{
+std::unique_ptr<six::sicd::ComplexData> createData()
+{
+    std::unique_ptr<six::sicd::ComplexData> data =
+            six::sicd::Utilities::createFakeComplexData();
+    data->grid->row.reset(new six::sicd::DirectionParameters());
+    data->grid->row->sign = six::FFTSign::NEG;
+    data->grid->row->sampleSpacing = 0.5;
+    data->grid->col.reset(new six::sicd::DirectionParameters());
+    data->grid->col->sign = six::FFTSign::NEG;
+    data->grid->col->sampleSpacing = 0.75;
+    data->setNumRows(100);
+    data->setNumCols(100);
+    data->imageData->scpPixel = six::RowColInt(50, 50);
+
+    six::sicd::AreaPlaneUtility::setAreaPlane(*data);
+    six::sicd::AreaPlane& plane = *data->radarCollection->area->plane;
+    plane.xDirection->spacing = 0.6;
+    plane.xDirection->elements = 150;
+    plane.yDirection->spacing = 0.6;
+    plane.yDirection->elements = 150;
+    plane.referencePoint.rowCol = six::RowColDouble(75.0, 75.0);
+    return data;
+}
+
+std::vector<types::RowCol<double> > createPixels()
+{
+    std::vector<types::RowCol<double> > pixels;
+    for (double row = 0.0; row < 100.0; row += 12.5)
+    {
+        for (double col = 0.0; col < 100.0; col += 9.0)
+        {
+            pixels.push_back(types::RowCol<double>(row, col));
+        }
+    }
+    return pixels;
+}
+
+bool equal(const std::vector<types::RowCol<double> >& lhs,
+           const std::vector<types::RowCol<double> >& rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (size_t ii = 0; ii < lhs.size(); ++ii)
+    {
+        if (lhs[ii].row != rhs[ii].row || lhs[ii].col != rhs[ii].col)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+TEST_CASE(testMatchesUtilities)
+{
+    const std::unique_ptr<six::sicd::ComplexData> data = createData();
+    const six::sicd::ProjectionContext context(*data);
+    const std::vector<types::RowCol<double> > pixels = createPixels();
+
+    std::vector<types::RowCol<double> > expected;
+    std::vector<types::RowCol<double> > actual;
+    six::sicd::Utilities::projectPixelsToOutputPlane(*data, pixels, expected);
+    six::sicd::Utilities::projectPixelsToOutputPlane(context, pixels, actual);
+    TEST_ASSERT(equal(actual, expected));
+
+    six::sicd::Utilities::projectPixelsToSlantPlane(*data, pixels, expected);
+    six::sicd::Utilities::projectPixelsToSlantPlane(context, pixels, actual);
+    TEST_ASSERT(equal(actual, expected));
+
+    six::sicd::Utilities::projectValidDataPolygonToOutputPlane(*data,
+                                                               expected);
+    six::sicd::Utilities::projectValidDataPolygonToOutputPlane(context,
+                                                               actual);
+    TEST_ASSERT_EQ(actual.size(), static_cast<size_t>(4));
+    TEST_ASSERT(equal(actual, expected));
+}
+
+TEST_CASE(testRoundTrip)
+{
+    const std::unique_ptr<six::sicd::ComplexData> data = createData();
+    const six::sicd::ProjectionContext context(*data);
+
+    for (const auto& pixel : createPixels())
+    {
+        const types::RowCol<double> roundTrip =
+                context.outputToSlantPixel(context.slantToOutputPixel(pixel));
+        TEST_ASSERT_ALMOST_EQ_EPS(roundTrip.row, pixel.row, 1e-2);
+        TEST_ASSERT_ALMOST_EQ_EPS(roundTrip.col, pixel.col, 1e-2);
+    }
+}
+
+TEST_CASE(testGeoLocator)
+{
+    const std::unique_ptr<six::sicd::ComplexData> data = createData();
+    const six::sicd::ProjectionContext context(*data);
+
+    for (bool shadowsDown : {true, false})
+    {
+        const six::sicd::GeoLocator expected(*data, shadowsDown);
+        const six::sicd::GeoLocator actual(context, shadowsDown);
+        for (const auto& pixel : createPixels())
+        {
+            const six::LatLonAlt lhs = actual.geolocate(pixel);
+            const six::LatLonAlt rhs = expected.geolocate(pixel);
+            TEST_ASSERT_EQ(lhs.getLat(), rhs.getLat());
+            TEST_ASSERT_EQ(lhs.getLon(), rhs.getLon());
+            TEST_ASSERT_EQ(lhs.getAlt(), rhs.getAlt());
+        }
+    }
+}
+
+TEST_CASE(testSharedAcrossThreads)
+{
+    const std::unique_ptr<six::sicd::ComplexData> data = createData();
+    const six::sicd::ProjectionContext context(*data);
+    const std::vector<types::RowCol<double> > pixels = createPixels();
+
+    std::vector<types::RowCol<double> > expected;
+    six::sicd::Utilities::projectPixelsToOutputPlane(context, pixels, expected);
+
+    const size_t numThreads = 4;
+    std::vector<std::vector<types::RowCol<double> > > results(numThreads);
+    std::vector<const scene::ProjectionPolynomialFitter*> fitters(numThreads);
+    std::vector<std::thread> threads;
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        threads.push_back(std::thread([&, ii]()
+        {
+            fitters[ii] = &context.getPolynomialFitter();
+            six::sicd::Utilities::projectPixelsToOutputPlane(context, pixels,
+                                                             results[ii]);
+        }));
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        TEST_ASSERT(equal(results[ii], expected));
+
+        // The fitter is only built once
+        TEST_ASSERT(fitters[ii] == fitters[0]);
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testMatchesUtilities);
+    TEST_CHECK(testRoundTrip);
+    TEST_CHECK(testGeoLocator);
+    TEST_CHECK(testSharedAcrossThreads);
+    )
@@ -345,6 +345,38 @@ TEST_CASE(test_readFromNITF_sicd_50x50)
     auto buffer = readFromNITF(inputPathname);
 }
 
+static std::vector<std::complex<float>> readImage(six::NITFReadControl& reader, const six::Data& data)
+{
+    std::vector<std::complex<float>> image(data.getNumRows() * data.getNumCols());
+    six::Region region;
+    region.setComplexBuffer(image.data());
+    reader.interleaved(region, 0);
+    return image;
+}
+TEST_CASE(test_metadata_only_sicd_50x50)
+{
+    setNitfPluginPath();
+    const auto inputPathname = getNitfPath("sicd_50x50.nitf");
+
+    six::sicd::NITFReadComplexXMLControl full;
+    full.load(inputPathname);
+    const auto pExpected = getComplexData(*getContainer(full), 0);
+
+    six::sicd::NITFReadComplexXMLControl metadataOnly;
+    metadataOnly.NITFReadControl().getOptions().setParameter(six::NITFReadControl::OPT_METADATA_ONLY, six::Parameter(1));
+    metadataOnly.load(inputPathname);
+    const auto pActual = getComplexData(*getContainer(metadataOnly), 0);
+    TEST_ASSERT(six::sicd::Utilities::toXMLString(*pActual, nullptr /*pSchemaPaths*/) ==
+        six::sicd::Utilities::toXMLString(*pExpected, nullptr /*pSchemaPaths*/));
+
+    // The image segments are matched up on the first read; after that,
+    // the pixels and the Data are the same as for a full load.
+    const auto expectedImage = readImage(full.NITFReadControl(), *pExpected);
+    const auto actualImage = readImage(metadataOnly.NITFReadControl(), *pActual);
+    TEST_ASSERT(actualImage == expectedImage);
+    TEST_ASSERT(*getComplexData(*getContainer(metadataOnly), 0) == *pExpected);
+}
+
 static six::sicd::ComplexImageResult readSicd_(const std::filesystem::path& sicdPathname,
     six::PixelType expectedPixelType, size_t expectedNumBytesPerPixel)
 {
@@ -488,5 +520,6 @@ TEST_MAIN(
     //TEST_CHECK(sicd_French_legacy_xml);    
     TEST_CHECK(test_readFromNITF_sicd_50x50);
     TEST_CHECK(test_read_sicd_50x50);
+    TEST_CHECK(test_metadata_only_sicd_50x50);
     TEST_CHECK(test_create_sicd_from_mem_32f);
     )
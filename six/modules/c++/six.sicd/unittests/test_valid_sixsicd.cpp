@@ -34,6 +34,7 @@
 
 #include <six/Utilities.h>
 #include <import/six/sicd.h>
+#include <six/sicd/MetadataSnapshot.h>
 
 #include "TestCase.h"
 
@@ -176,8 +177,72 @@ TEST_CASE(test_read_sicd130_xml)
     test_read_sicd_xml(testName, "sicd130.xml");
 }
 
+static std::vector<std::byte> toSnapshot(const six::sicd::ComplexData& complexData)
+{
+    std::vector<std::byte> snapshot;
+    six::sicd::serializeSnapshot(complexData, snapshot);
+    return snapshot;
+}
+static std::unique_ptr<six::sicd::ComplexData> fromSnapshot(const std::vector<std::byte>& snapshot)
+{
+    return six::sicd::deserializeSnapshot(std::span<const std::byte>(snapshot.data(), snapshot.size()));
+}
+
+static void test_snapshot_round_trip(const std::string& testName, const std::filesystem::path& path)
+{
+    const auto pExpected = six::sicd::Utilities::parseDataFromFile(get_sample_xml_path(path), nullptr /*pSchemaPaths*/);
+
+    const auto snapshot = toSnapshot(*pExpected);
+    TEST_ASSERT_EQ(six::MetadataSnapshot::getIdentifier(std::span<const std::byte>(snapshot.data(), snapshot.size())), "COMPLEX");
+    const auto pActual = fromSnapshot(snapshot);
+    TEST_ASSERT_EQ(pActual->getVersion(), pExpected->getVersion());
+
+    // everything that makes it into the XML has to make it through a snapshot
+    const auto expectedXML = six::sicd::Utilities::toXMLString(*pExpected, nullptr /*pSchemaPaths*/);
+    const auto actualXML = six::sicd::Utilities::toXMLString(*pActual, nullptr /*pSchemaPaths*/);
+    TEST_ASSERT(actualXML == expectedXML);
+    TEST_ASSERT(*pActual == *pExpected);
+    TEST_ASSERT(toSnapshot(*pActual) == snapshot);
+}
+
+TEST_CASE(test_snapshot_sicd_xml)
+{
+    test_snapshot_round_trip(testName, "sicd040.xml");
+    test_snapshot_round_trip(testName, "sicd041_image_form_algo_other.xml");
+    test_snapshot_round_trip(testName, "sicd050_image_form_algo_other.xml");
+    test_snapshot_round_trip(testName, "sicd101.xml");
+    test_snapshot_round_trip(testName, "sicd101_image_form_algo_other.xml");
+    test_snapshot_round_trip(testName, "sicd110.xml");
+    test_snapshot_round_trip(testName, "sicd110_image_form_algo_other.xml");
+    test_snapshot_round_trip(testName, "sicd110_no_match_collects.xml");
+    test_snapshot_round_trip(testName, "sicd130.xml");
+}
+
+TEST_CASE(test_bad_snapshot)
+{
+    const auto pComplexData = six::sicd::Utilities::parseDataFromFile(get_sample_xml_path("sicd130.xml"), nullptr /*pSchemaPaths*/);
+    auto snapshot = toSnapshot(*pComplexData);
+
+    // any truncation is caught
+    for (const size_t size : { static_cast<size_t>(4), snapshot.size() / 2, snapshot.size() - 1 })
+    {
+        const std::vector<std::byte> truncated(snapshot.begin(), snapshot.begin() + size);
+        TEST_EXCEPTION(fromSnapshot(truncated));
+    }
+
+    // as are extra bytes
+    auto extra = snapshot;
+    extra.push_back(std::byte(0));
+    TEST_EXCEPTION(fromSnapshot(extra));
+
+    snapshot[0] = static_cast<std::byte>('X');
+    TEST_EXCEPTION(fromSnapshot(snapshot));
+}
+
 TEST_MAIN(
     TEST_CHECK(test_createFakeComplexData);
     TEST_CHECK(test_read_sicd110_xml);
     TEST_CHECK(test_read_sicd110_xml);
+    TEST_CHECK(test_snapshot_sicd_xml);
+    TEST_CHECK(test_bad_snapshot);
     )
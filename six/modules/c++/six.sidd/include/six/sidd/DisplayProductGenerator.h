@@ -0,0 +1,249 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_DISPLAY_PRODUCT_GENERATOR_H__
+#define __SIX_SIDD_DISPLAY_PRODUCT_GENERATOR_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <complex>
+#include <vector>
+
+#include <mem/ScopedCopyablePtr.h>
+#include <six/Types.h>
+#include <six/sidd/Display.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ *  \struct DisplayTileSource
+ *  \brief Supplies detected magnitude a tile of rows at a time
+ */
+struct DisplayTileSource
+{
+    virtual ~DisplayTileSource() = default;
+
+    /*!
+     *  Read the magnitude of some rows of the image.  Tiles are read by
+     *  many threads at once, so this must be thread-safe.
+     *
+     *  \param startRow First row to read
+     *  \param numRows Number of rows to read
+     *  \param magnitude numRows * numCols values, row by row
+     */
+    virtual void read(size_t startRow, size_t numRows, float* magnitude) = 0;
+};
+
+/*!
+ *  \struct ComplexTileSource
+ *  \brief Detects the magnitude of complex (SICD RE32F_IM32F) pixels
+ */
+struct ComplexTileSource : public DisplayTileSource
+{
+    //! Read complex pixels, as for DisplayTileSource::read()
+    virtual void readComplex(size_t startRow, size_t numRows,
+                             std::complex<float>* pixels) = 0;
+
+    void read(size_t startRow, size_t numRows, float* magnitude) override;
+
+    //! \param numCols Number of columns in the image
+    explicit ComplexTileSource(size_t numCols) : mNumCols(numCols)
+    {
+    }
+
+private:
+    const size_t mNumCols;
+};
+
+/*!
+ *  \struct DisplayTileSink
+ *  \brief Takes the 8-bit product a tile of rows at a time
+ */
+struct DisplayTileSink
+{
+    virtual ~DisplayTileSink() = default;
+
+    /*!
+     *  Write some rows of the product.  Tiles are written by many threads
+     *  at once and in no particular order, so this must be thread-safe.
+     *
+     *  \param startRow First row of the tile
+     *  \param numRows Number of rows in the tile
+     *  \param pixels numRows * numCols pixels, row by row
+     */
+    virtual void write(size_t startRow, size_t numRows,
+                       const uint8_t* pixels) = 0;
+};
+
+/*!
+ *  \struct DisplayGenerationOptions
+ *  \brief How the magnitude is turned into display pixels
+ *
+ *  The DRA clip points are percentiles of the magnitude histogram, each
+ *  moved toward the data extreme by its modifier:
+ *
+ *      low  = value(pMin) - eMinModifier * (value(pMin) - minimum)
+ *      high = value(pMax) + eMaxModifier * (maximum - value(pMax))
+ *
+ *  Pixels are scaled linearly from [low, high] to [0, 255], then passed
+ *  through the remap LUT if there is one.
+ */
+struct DisplayGenerationOptions final
+{
+    //! Fraction of pixels at or below the low clip point, in [0, 1]
+    double pMin = 0.02;
+
+    //! Fraction of pixels at or below the high clip point, in [0, 1]
+    double pMax = 0.98;
+
+    //! Move the low clip point toward the minimum, in [0, 1]
+    double eMinModifier = 0.0;
+
+    //! Move the high clip point toward the maximum, in [0, 1]
+    double eMaxModifier = 0.0;
+
+    //! Number of worker threads; 0 for one per CPU
+    size_t numThreads = 0;
+
+    //! Number of rows read and written at once
+    size_t tileRows = 256;
+
+    //! Optional 256 entry, 1 byte remap LUT applied after the DRA
+    mem::ScopedCopyablePtr<LUT> remapLUT;
+};
+
+/*!
+ *  \struct DRAStatistics
+ *  \brief What the histogram pass found
+ */
+struct DRAStatistics final
+{
+    size_t numPixels = 0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+
+    //! Magnitude at the pMin and pMax percentiles
+    double eMin = 0.0;
+    double eMax = 0.0;
+
+    //! Clip points after the modifiers; these map to 0 and 255
+    double low = 0.0;
+    double high = 0.0;
+};
+
+/*!
+ *  \class DisplayProductGenerator
+ *  \brief Turns detected magnitude into an 8-bit (MONO8I) SIDD product
+ *
+ *  The image is streamed through twice, a tile of rows at a time, by a
+ *  pool of worker threads that each take the next tile as they finish the
+ *  last:
+ *
+ *  1. Each worker histograms its tiles; the histograms are then merged
+ *     and the DRA clip points read off the result.  The histogram bins
+ *     are the top 16 bits of the float, so it needs no range up front
+ *     and resolves magnitudes to within 1% at any scale.
+ *  2. Each worker applies the DRA and remap LUT to its tiles, with SSE2
+ *     where it's available, and hands them to the sink.
+ *
+ *  fillDisplay() then records what was done in the Display.
+ */
+class DisplayProductGenerator
+{
+public:
+    /*!
+     *  \param numRows Number of rows in the image
+     *  \param numCols Number of columns in the image
+     *  \param options How to generate the product
+     *  \throw except::Exception if the options are invalid
+     */
+    DisplayProductGenerator(size_t numRows, size_t numCols,
+                            const DisplayGenerationOptions& options =
+                                    DisplayGenerationOptions());
+
+    /*!
+     *  Histogram the image and compute the DRA clip points.
+     *
+     *  \return The statistics, also kept for generate()
+     */
+    const DRAStatistics& computeDRA(DisplayTileSource& source);
+
+    /*!
+     *  Write the product to the sink, first computing the DRA if
+     *  computeDRA() hasn't been called.
+     */
+    void generate(DisplayTileSource& source, DisplayTileSink& sink);
+
+    //! Set the clip points directly instead of calling computeDRA()
+    void setDRA(const DRAStatistics& statistics);
+
+    //! The clip points computeDRA() or setDRA() set
+    const DRAStatistics& getStatistics() const
+    {
+        return mStatistics;
+    }
+
+    /*!
+     *  Record the product in a Display: the pixel type, band count, remap
+     *  (both SIDD 1.0 and 2.0 forms) and the DRA parameters.  Processing
+     *  entries are created if there are none; their other fields, such as
+     *  the interactive filters, are left for the caller.
+     */
+    void fillDisplay(Display& display) const;
+
+    /*!
+     *  Remap magnitude to display pixels with the current clip points
+     *  and LUT.  This is what generate() does to each tile.
+     */
+    void remap(const float* magnitude, size_t size, uint8_t* pixels) const;
+
+    //! Compute the magnitude of complex pixels
+    static void detect(const std::complex<float>* pixels, size_t size,
+                       float* magnitude);
+
+    //! Number of histogram bins: one per value of the top 16 float bits
+    static constexpr size_t NUM_BINS = 0x8000;
+
+    /*!
+     *  Add magnitudes to a NUM_BINS histogram.  The bins are the sign-less
+     *  top 16 bits of the float, which are monotonic in |magnitude| and
+     *  about 0.8% wide.
+     */
+    static void histogram(const float* magnitude, size_t size,
+                          std::vector<uint64_t>& bins);
+
+private:
+    size_t getNumThreads() const;
+    void computeClipPoints(const std::vector<uint64_t>& bins);
+
+    const size_t mNumRows;
+    const size_t mNumCols;
+    const DisplayGenerationOptions mOptions;
+    DRAStatistics mStatistics;
+    bool mHaveDRA = false;
+};
+}
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include "six/ReadControlFactory.h"
 #include "six/Adapters.h"
 #include <import/tiff.h>
+#include <types/RowCol.h>
 
 namespace six
 {
@@ -61,6 +62,24 @@ struct GeoTIFFReadControl : public ReadControl
         return "TIFF";
     }
 
+    /*!
+     *  Number of levels of an image, including full resolution.  Levels
+     *  past the first are the reduced resolution overviews that follow
+     *  the image in the file.
+     */
+    size_t getNumLevels(size_t imageNumber) const;
+
+    //! Size of a level of an image; level 0 is full resolution
+    types::RowCol<size_t> getDims(size_t imageNumber, size_t level) const;
+
+    /*!
+     *  Read a region of a level of an image, in that level's pixel
+     *  coordinates.
+     *
+     *  eturn The region's buffer, allocated if it had none
+     */
+    UByte* readLevel(Region& region, size_t imageNumber, size_t level);
+
 protected:
 
     tiff::FileReader mReader;
@@ -69,6 +88,12 @@ private:
     template<typename TSchemaPaths, typename TCreateXmlParser>
     void load_(const std::string& fromFile, const TSchemaPaths&, TCreateXmlParser);
 
+    //! The TIFF image holding a level of an image
+    tiff::ImageReader* getImageReader(size_t imageNumber, size_t level) const;
+
+    //! TIFF image indices of each image's levels
+    std::vector<std::vector<uint32_t> > mLevels;
+
 };
 
 struct GeoTIFFReadControlCreator final : public ReadControlCreator
@@ -25,6 +25,7 @@
 
 #if !defined(SIX_TIFF_DISABLED)
 
+#include <memory>
 #include <std/filesystem>
 
 #include "six/Types.h"
@@ -32,6 +33,7 @@
 #include "six/WriteControl.h"
 #include "six/XMLControlFactory.h"
 #include "six/sidd/DerivedData.h"
+#include "six/sidd/ReducedResolution.h"
 #include <import/tiff.h>
 
 namespace six
@@ -42,16 +44,18 @@ namespace sidd
  *  \class GeoTIFFWriteControl
  *  \brief Write a SIDD GeoTIFF
  *
- *  This class uses the tiff-c++ library to write out a GeoTIFF that
- *  can be up to 4GB.  If the imagery exceeds the limit, this instance
- *  of WriteControl will throw an exception.
+ *  This class uses the tiff-c++ library to write out a GeoTIFF.  Files
+ *  that would pass 4GB are written as BigTIFFs.
  *
- *  Image is currently stripped, and contains the required TIFF, GeoTIFF and
- *  private SICD/SIDD keys described in the File Format Description document.
+ *  Images are written in strips unless OPT_TILE_SIZE asks for tiles.  With
+ *  OPT_MAX_OVERVIEWS, each image is followed by reduced resolution
+ *  overviews, marked with NewSubfileType 1, which are built and written
+ *  as the image's rows go by.  Tiles and overviews let any region of any
+ *  resolution be read without reading the rest of the file.  The full
+ *  resolution image contains the required TIFF, GeoTIFF and private
+ *  SICD/SIDD keys described in the File Format Description document.
  *
  *  Containers must represent derived products!
- *
- *  \todo Support tiles using Options?
  */
 class GeoTIFFWriteControl : public WriteControl
 {
@@ -59,6 +63,21 @@ class GeoTIFFWriteControl : public WriteControl
     std::vector<Data*> mComplexData;
     std::vector<Data*> mDerivedData;
 public:
+    //! Tile width and length, a multiple of 16 such as 256; 0 to write
+    //! strips.  Defaults to 0.
+    static const char OPT_TILE_SIZE[];
+
+    //! Non-zero to always write a BigTIFF.  By default, only files that
+    //! would pass 4GB are.
+    static const char OPT_BIG_TIFF[];
+
+    //! Most overviews to write for each image, or -1 to halve images
+    //! until they fit in an OVERVIEW_MIN_DIMENSION square.  Defaults to 0,
+    //! no overviews.
+    static const char OPT_MAX_OVERVIEWS[];
+
+    static const size_t OVERVIEW_MIN_DIMENSION;
+
     GeoTIFFWriteControl();
 
     GeoTIFFWriteControl(const GeoTIFFWriteControl&) = delete;
@@ -97,10 +116,47 @@ public:
     std::string getFileType() const override { return "GeoTIFF"; }
 
 private:
-    template<typename TBufferList>
-    void save(const TBufferList& sources,
-        const std::string& toFile,
-        const std::vector<std::string>& schemaPaths);
+    /*
+     *  Write an image and its overviews.
+     *  \param getRows Returns the pixels of rows [row, row + numRows),
+     *  called for each row in order
+     */
+    template<typename TGetRows>
+    void writeImage(tiff::FileWriter& tiffWriter,
+                    const DerivedData& data,
+                    const std::string& toFilePrefix,
+                    const std::vector<std::string>& schemaPaths,
+                    TGetRows getRows);
+
+    //! Whether the images and their overviews need a BigTIFF
+    bool needsBigTIFF() const;
+
+    //! Most overviews for each image; 0 for none, -1 for no limit
+    int getMaxOverviews() const;
+
+    /*
+     *  Add an overview image after imageWriter for each level, with its
+     *  data laid out after the data of the image before it.
+     *  \return A builder that writes the overviews' rows, or nullptr for
+     *  no overviews
+     */
+    std::unique_ptr<RRDSBuilder> addOverviews(
+            tiff::FileWriter& tiffWriter,
+            const DerivedData& data,
+            tiff::ImageWriter& imageWriter,
+            std::vector<tiff::ImageWriter*>& overviewWriters) const;
+
+    //! Tile width and length; 0 for strips
+    size_t getTileSize() const;
+
+    //! Tile the image if requested
+    void setTiling(tiff::ImageWriter& imageWriter) const;
+
+    //! Add the size and pixel layout tags
+    static
+    void setupImageFormat(const DerivedData& data,
+                          const types::RowCol<size_t>& extent,
+                          tiff::IFD* ifd);
 
     static
     void addCharArray(tiff::IFD* ifd,
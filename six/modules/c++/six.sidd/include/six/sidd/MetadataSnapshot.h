@@ -0,0 +1,56 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_METADATA_SNAPSHOT_H__
+#define __SIX_SIDD_METADATA_SNAPSHOT_H__
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <std/cstddef>
+#include <std/span>
+
+#include <six/MetadataSnapshot.h>
+#include <six/sidd/DerivedData.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ *  Append a six::MetadataSnapshot of SIDD metadata to 'buffer'.  Its
+ *  identifier is "DERIVED".
+ */
+void serializeSnapshot(const DerivedData& data,
+                       std::vector<std::byte>& buffer);
+
+/*!
+ *  Load SIDD metadata from what serializeSnapshot() wrote
+ *
+ *  \throw if 'buffer' isn't a complete snapshot of SIDD metadata
+ */
+std::unique_ptr<DerivedData>
+deserializeSnapshot(std::span<const std::byte> buffer);
+}
+}
+
+#endif
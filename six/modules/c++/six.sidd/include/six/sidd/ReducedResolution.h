@@ -0,0 +1,323 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_REDUCED_RESOLUTION_H__
+#define __SIX_SIDD_REDUCED_RESOLUTION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <std/cstddef>
+
+#include <types/RowCol.h>
+#include <six/NITFReadControl.h>
+#include <six/Region.h>
+#include <six/sidd/DerivedData.h>
+
+namespace six
+{
+namespace sidd
+{
+/*!
+ *  Reduced resolution data sets (RRDS) are stored as NITF R-sets: level k
+ *  is a SIDD of its own, 2^k times smaller in each direction, written next
+ *  to the full resolution SIDD with the extension replaced by ".r<k>" (so
+ *  image.nitf has image.r1, image.r2, ...).  Each level's metadata is the
+ *  full resolution metadata with the pixel footprint, sample spacing,
+ *  reference point and valid data rescaled.
+ */
+
+/*!
+ *  \struct RRDSOptions
+ *  \brief How to build the reduced resolution levels
+ */
+struct RRDSOptions final
+{
+    /*!
+     *  How each 2x2 block becomes one pixel: DECIMATE (keep the upper
+     *  left pixel), MAX_PIXEL or AVERAGE.  LUT pixel types only support
+     *  DECIMATE.  The other methods need filters, which aren't supported.
+     */
+    DownsamplingMethod method = DownsamplingMethod::DECIMATE;
+
+    //! Stop once both dimensions are no larger than this
+    size_t minDimension = 256;
+
+    //! Most levels to build, not counting full resolution; 0 for no limit
+    size_t maxLevels = 0;
+};
+
+/*!
+ *  Receives each reduced resolution row as soon as it is complete.  Rows
+ *  of a level arrive in order, but rows of different levels interleave.
+ *
+ *  \param level The level, from 1
+ *  \param row The row within that level
+ *  \param pixels The row, pixel interleaved in native byte order.  It is
+ *  only valid for the duration of the call.
+ */
+using RRDSRowHandler = std::function<void(size_t level, size_t row,
+                                          const std::byte* pixels)>;
+
+/*!
+ *  \class RRDSBuilder
+ *  \brief Builds every reduced resolution level in one pass
+ *
+ *  Rows of the full resolution image are added in order, in as many calls
+ *  as is convenient (say, as each block is written).  Each level keeps
+ *  one row of 2x2 sums and one output row; a finished row goes straight
+ *  to the handler and on to the next level.  Memory is proportional to
+ *  the image width, whatever its height.
+ */
+class RRDSBuilder
+{
+public:
+    /*!
+     *  \param fullDims Size of the full resolution image
+     *  \param pixelType Its pixel type
+     *  \param handler Called with each reduced resolution row
+     *  \param options How to build the levels
+     *  \throw except::Exception if the method isn't supported for the
+     *  pixel type
+     */
+    RRDSBuilder(const types::RowCol<size_t>& fullDims,
+                PixelType pixelType,
+                const RRDSRowHandler& handler,
+                const RRDSOptions& options = RRDSOptions());
+
+    /*!
+     *  Add the next rows of the full resolution image.  Every row that
+     *  they complete is passed to the handler before this returns.
+     *
+     *  \param rows numRows full resolution rows, pixel interleaved
+     *  \param numRows Number of rows
+     */
+    void addRows(const std::byte* rows, size_t numRows);
+
+    //! Whether every full resolution row has been added
+    bool isComplete() const
+    {
+        return mRowsAdded == mFullDims.row;
+    }
+
+    //! Number of reduced resolution levels, not counting full resolution
+    size_t getNumLevels() const
+    {
+        return mLevels.size();
+    }
+
+    //! Size of a level; level 0 is full resolution
+    types::RowCol<size_t> getDims(size_t level) const;
+
+    //! Bytes held for all the levels' partial rows
+    size_t getBufferSize() const;
+
+    const RRDSOptions& getOptions() const
+    {
+        return mOptions;
+    }
+
+private:
+    struct Level final
+    {
+        types::RowCol<size_t> dims;
+        std::vector<uint32_t> accumulator;
+        std::vector<std::byte> row;
+        size_t numRows = 0;
+        size_t pendingRows = 0;
+    };
+
+    const Level& getLevel(size_t level) const;
+    void addRow(size_t level, const std::byte* row);
+    void emitRow(size_t level);
+
+    const types::RowCol<size_t> mFullDims;
+    const RRDSOptions mOptions;
+    const RRDSRowHandler mHandler;
+    size_t mSamplesPerPixel;
+    size_t mBytesPerSample;
+    std::vector<Level> mLevels;
+    size_t mRowsAdded = 0;
+};
+
+//! The R-set pathname for a level, e.g. image.r2 for image.nitf
+std::string getRRDSPathname(const std::string& pathname, size_t level);
+
+/*!
+ *  Record the down-sampling method in each NonInteractiveProcessing RRDS.
+ *  Entries are not created; SIDD 1.0 has nowhere to record it.
+ */
+void setDownsamplingMethod(DerivedData& data, DownsamplingMethod method);
+
+/*!
+ *  Rescale the full resolution metadata for a level, for the method used
+ *  to build it
+ */
+void scaleToRRDSLevel(DerivedData& data, size_t level,
+                      DownsamplingMethod method);
+
+/*!
+ *  \class RRDSWriteControl
+ *  \brief Streams a single image SIDD and its R-sets to disk
+ *
+ *  Every file is laid out up front by a SIDDByteProvider.  Full resolution
+ *  rows are written as they are added and run through an RRDSBuilder,
+ *  whose rows are written to their R-sets as soon as they are complete.
+ *  Only the rows passed to addRows() and the builder's partial rows are
+ *  ever in memory.  The down-sampling method is recorded in the metadata
+ *  of every level.
+ */
+class RRDSWriteControl
+{
+public:
+    /*!
+     *  Create the full resolution SIDD and its R-sets.
+     *
+     *  \param data Metadata of the full resolution SIDD
+     *  \param pathname Pathname of the full resolution SIDD
+     *  \param schemaPaths Directories or files of schema locations
+     *  \param options How to build the reduced resolution levels
+     */
+    RRDSWriteControl(const DerivedData& data,
+                     const std::string& pathname,
+                     const std::vector<std::string>& schemaPaths,
+                     const RRDSOptions& options = RRDSOptions());
+
+    ~RRDSWriteControl();
+
+    /*!
+     *  Write the next rows of the full resolution image, and whatever rows
+     *  of the levels they complete.  The files are closed once the last row
+     *  is in.
+     *
+     *  \param rows numRows rows, pixel interleaved in native byte order
+     *  \param numRows Number of rows
+     */
+    void addRows(const std::byte* rows, size_t numRows);
+
+    //! Whether every full resolution row has been written
+    bool isComplete() const
+    {
+        return mBuilder.isComplete();
+    }
+
+    //! Number of reduced resolution levels, not counting full resolution
+    size_t getNumLevels() const
+    {
+        return mBuilder.getNumLevels();
+    }
+
+private:
+    struct LevelFile;
+
+    void writeRows(size_t level, const std::byte* rows, size_t startRow,
+                   size_t numRows);
+
+    const size_t mBytesPerPixel;
+    const bool mSwapBytes;
+    std::vector<std::unique_ptr<LevelFile> > mFiles;
+    std::vector<std::byte> mSwapped;
+    size_t mRowsAdded = 0;
+    RRDSBuilder mBuilder;
+};
+
+/*!
+ *  Write a single image SIDD and its R-sets through an RRDSWriteControl.
+ *
+ *  \param data Metadata of the SIDD
+ *  \param image The pixels, pixel interleaved
+ *  \param pathname Pathname of the full resolution SIDD
+ *  \param schemaPaths Directories or files of schema locations
+ *  \param options How to build the reduced resolution levels
+ *  \return The number of reduced resolution levels written
+ */
+size_t saveWithRRDS(const DerivedData& data,
+                    const std::byte* image,
+                    const std::string& pathname,
+                    const std::vector<std::string>& schemaPaths,
+                    const RRDSOptions& options = RRDSOptions());
+
+/*!
+ *  \class RRDSReader
+ *  \brief Reads the level of a SIDD that best fits a zoom
+ *
+ *  Levels are opened when they are first read.
+ */
+class RRDSReader
+{
+public:
+    /*!
+     *  Load the full resolution SIDD and find its R-sets.  Only the
+     *  first image of the full resolution SIDD is used.
+     *
+     *  \param pathname Pathname of the full resolution SIDD
+     *  \param schemaPaths Directories or files of schema locations
+     */
+    RRDSReader(const std::string& pathname,
+               const std::vector<std::string>& schemaPaths =
+                       std::vector<std::string>());
+
+    //! Number of levels, including full resolution
+    size_t getNumLevels() const
+    {
+        return mReaders.size();
+    }
+
+    //! Size of a level; level 0 is full resolution
+    types::RowCol<size_t> getDims(size_t level) const;
+
+    /*!
+     *  The coarsest level with at least the requested resolution
+     *
+     *  \param zoom Displayed pixels per full resolution pixel, e.g. 0.25
+     *  to show a quarter of the full resolution size
+     */
+    size_t selectLevel(double zoom) const;
+
+    //! The coarsest level at least this big in both dimensions
+    size_t selectLevel(const types::RowCol<size_t>& minDims) const;
+
+    //! The metadata of a level
+    const DerivedData& getData(size_t level);
+
+    /*!
+     *  Read a region of a level, in that level's pixel coordinates.
+     *
+     *  \return The region's buffer, allocated if it had none
+     */
+    UByte* read(size_t level, Region& region);
+
+private:
+    NITFReadControl& getReader(size_t level);
+
+    const std::string mPathname;
+    const std::vector<std::string> mSchemaPaths;
+    types::RowCol<size_t> mFullDims;
+    std::vector<std::unique_ptr<NITFReadControl> > mReaders;
+};
+}
+}
+
+#endif
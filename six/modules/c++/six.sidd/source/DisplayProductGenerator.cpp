@@ -0,0 +1,552 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/sidd/DisplayProductGenerator.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <std/memory>
+
+#include <except/Exception.h>
+#include <mt/ThreadGroup.h>
+#include <sys/Conf.h>
+#include <sys/OS.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIX_SIDD_DISPLAY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+// What one worker found in its tiles
+struct TileHistogram final
+{
+    std::vector<uint64_t> bins;
+    size_t numPixels = 0;
+    float minimum = std::numeric_limits<float>::max();
+    float maximum = std::numeric_limits<float>::lowest();
+};
+
+// Hands out tiles of rows, one at a time, to the workers
+class TileQueue final
+{
+public:
+    TileQueue(size_t numRows, size_t tileRows) :
+        mNumRows(numRows),
+        mTileRows(tileRows),
+        mNext(0)
+    {
+    }
+
+    size_t getNumTiles() const
+    {
+        return (mNumRows + mTileRows - 1) / mTileRows;
+    }
+
+    // Returns false once every tile has been handed out
+    bool next(size_t& startRow, size_t& numRows)
+    {
+        const size_t tile = mNext++;
+        if (tile >= getNumTiles())
+        {
+            return false;
+        }
+        startRow = tile * mTileRows;
+        numRows = std::min(mTileRows, mNumRows - startRow);
+        return true;
+    }
+
+private:
+    const size_t mNumRows;
+    const size_t mTileRows;
+    std::atomic<size_t> mNext;
+};
+
+class HistogramRunnable final : public sys::Runnable
+{
+public:
+    HistogramRunnable(six::sidd::DisplayTileSource& source,
+                      TileQueue& tiles,
+                      size_t numCols,
+                      size_t tileRows,
+                      TileHistogram& result) :
+        mSource(source),
+        mTiles(tiles),
+        mNumCols(numCols),
+        mTileRows(tileRows),
+        mResult(result)
+    {
+    }
+
+    void run() override
+    {
+        std::vector<float> magnitude(mTileRows * mNumCols);
+        mResult.bins.assign(six::sidd::DisplayProductGenerator::NUM_BINS, 0);
+
+        size_t startRow;
+        size_t numRows;
+        while (mTiles.next(startRow, numRows))
+        {
+            const size_t size = numRows * mNumCols;
+            mSource.read(startRow, numRows, magnitude.data());
+            six::sidd::DisplayProductGenerator::histogram(
+                    magnitude.data(), size, mResult.bins);
+
+            const auto minMax = std::minmax_element(magnitude.begin(),
+                                                    magnitude.begin() + size);
+            mResult.minimum = std::min(mResult.minimum, *minMax.first);
+            mResult.maximum = std::max(mResult.maximum, *minMax.second);
+            mResult.numPixels += size;
+        }
+    }
+
+private:
+    six::sidd::DisplayTileSource& mSource;
+    TileQueue& mTiles;
+    const size_t mNumCols;
+    const size_t mTileRows;
+    TileHistogram& mResult;
+};
+
+class RemapRunnable final : public sys::Runnable
+{
+public:
+    RemapRunnable(const six::sidd::DisplayProductGenerator& generator,
+                  six::sidd::DisplayTileSource& source,
+                  six::sidd::DisplayTileSink& sink,
+                  TileQueue& tiles,
+                  size_t numCols,
+                  size_t tileRows) :
+        mGenerator(generator),
+        mSource(source),
+        mSink(sink),
+        mTiles(tiles),
+        mNumCols(numCols),
+        mTileRows(tileRows)
+    {
+    }
+
+    void run() override
+    {
+        std::vector<float> magnitude(mTileRows * mNumCols);
+        std::vector<uint8_t> pixels(mTileRows * mNumCols);
+
+        size_t startRow;
+        size_t numRows;
+        while (mTiles.next(startRow, numRows))
+        {
+            mSource.read(startRow, numRows, magnitude.data());
+            mGenerator.remap(magnitude.data(), numRows * mNumCols,
+                             pixels.data());
+            mSink.write(startRow, numRows, pixels.data());
+        }
+    }
+
+private:
+    const six::sidd::DisplayProductGenerator& mGenerator;
+    six::sidd::DisplayTileSource& mSource;
+    six::sidd::DisplayTileSink& mSink;
+    TileQueue& mTiles;
+    const size_t mNumCols;
+    const size_t mTileRows;
+};
+
+// Runs one runnable per thread, or just the one inline
+template <typename MakeT>
+void runWorkers(size_t numThreads, MakeT makeRunnable)
+{
+    if (numThreads <= 1)
+    {
+        makeRunnable(0)->run();
+        return;
+    }
+
+    mt::ThreadGroup threads;
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        threads.createThread(makeRunnable(ii));
+    }
+    threads.joinAll();
+}
+
+void checkFraction(double value, const std::string& name)
+{
+    if (!(value >= 0.0 && value <= 1.0))
+    {
+        std::ostringstream ostr;
+        ostr << name << " must be in [0, 1], not " << value;
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+}
+
+// The smallest magnitude that falls in a histogram bin
+double binStart(size_t bin)
+{
+    const uint32_t bits = static_cast<uint32_t>(bin) << 16;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// The magnitude that a fraction of the pixels are at or below, found by
+// interpolating linearly within the bin it falls in
+double percentile(const std::vector<uint64_t>& bins, uint64_t total,
+                  double fraction)
+{
+    const double target = fraction * static_cast<double>(total);
+    uint64_t below = 0;
+    for (size_t bin = 0; bin < bins.size(); ++bin)
+    {
+        if (bins[bin] == 0)
+        {
+            continue;
+        }
+        if (static_cast<double>(below + bins[bin]) >= target)
+        {
+            const double within =
+                    (target - static_cast<double>(below)) /
+                    static_cast<double>(bins[bin]);
+            const double start = binStart(bin);
+            return start + within * (binStart(bin + 1) - start);
+        }
+        below += bins[bin];
+    }
+    return binStart(bins.size() - 1);
+}
+}
+
+namespace six
+{
+namespace sidd
+{
+constexpr size_t DisplayProductGenerator::NUM_BINS;
+
+void ComplexTileSource::read(size_t startRow, size_t numRows,
+                             float* magnitude)
+{
+    // The magnitude buffer is half the size of the complex pixels, so
+    // they have to go somewhere else.  Keep one buffer per thread.
+    thread_local std::vector<std::complex<float> > pixels;
+    pixels.resize(numRows * mNumCols);
+    readComplex(startRow, numRows, pixels.data());
+    DisplayProductGenerator::detect(pixels.data(), pixels.size(), magnitude);
+}
+
+DisplayProductGenerator::DisplayProductGenerator(
+        size_t numRows,
+        size_t numCols,
+        const DisplayGenerationOptions& options) :
+    mNumRows(numRows),
+    mNumCols(numCols),
+    mOptions(options)
+{
+    if (mNumRows == 0 || mNumCols == 0)
+    {
+        throw except::Exception(Ctxt("The image must not be empty"));
+    }
+    if (mOptions.tileRows == 0)
+    {
+        throw except::Exception(Ctxt("Tiles must have at least one row"));
+    }
+
+    checkFraction(mOptions.pMin, "pMin");
+    checkFraction(mOptions.pMax, "pMax");
+    checkFraction(mOptions.eMinModifier, "eMinModifier");
+    checkFraction(mOptions.eMaxModifier, "eMaxModifier");
+    if (mOptions.pMin > mOptions.pMax)
+    {
+        throw except::Exception(Ctxt("pMin must not be greater than pMax"));
+    }
+
+    if (mOptions.remapLUT.get() &&
+        (mOptions.remapLUT->numEntries != 256 ||
+         mOptions.remapLUT->elementSize != 1))
+    {
+        std::ostringstream ostr;
+        ostr << "The remap LUT must have 256 1-byte entries, not "
+             << mOptions.remapLUT->numEntries << " "
+             << mOptions.remapLUT->elementSize << "-byte entries";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+}
+
+size_t DisplayProductGenerator::getNumThreads() const
+{
+    const size_t numThreads = mOptions.numThreads == 0 ?
+            sys::OS().getNumCPUs() : mOptions.numThreads;
+    const size_t numTiles = (mNumRows + mOptions.tileRows - 1) /
+            mOptions.tileRows;
+    return std::max<size_t>(std::min(numThreads, numTiles), 1);
+}
+
+const DRAStatistics&
+DisplayProductGenerator::computeDRA(DisplayTileSource& source)
+{
+    const size_t numThreads = getNumThreads();
+    const size_t tileRows = std::min(mOptions.tileRows, mNumRows);
+    TileQueue tiles(mNumRows, tileRows);
+    std::vector<TileHistogram> results(numThreads);
+
+    runWorkers(numThreads, [&](size_t ii)
+    {
+        return std::make_unique<HistogramRunnable>(
+                source, tiles, mNumCols, tileRows, results[ii]);
+    });
+
+    // Merge the per-thread histograms
+    std::vector<uint64_t> bins(NUM_BINS, 0);
+    DRAStatistics statistics;
+    float minimum = std::numeric_limits<float>::max();
+    float maximum = std::numeric_limits<float>::lowest();
+    for (const TileHistogram& result : results)
+    {
+        if (result.numPixels == 0)
+        {
+            continue;
+        }
+        for (size_t bin = 0; bin < NUM_BINS; ++bin)
+        {
+            bins[bin] += result.bins[bin];
+        }
+        statistics.numPixels += result.numPixels;
+        minimum = std::min(minimum, result.minimum);
+        maximum = std::max(maximum, result.maximum);
+    }
+    statistics.minimum = minimum;
+    statistics.maximum = maximum;
+    mStatistics = statistics;
+
+    computeClipPoints(bins);
+    return mStatistics;
+}
+
+void DisplayProductGenerator::computeClipPoints(
+        const std::vector<uint64_t>& bins)
+{
+    DRAStatistics& stats = mStatistics;
+
+    // Interpolating within a bin can step outside the data
+    const auto clamp = [&stats](double value)
+    {
+        return std::min(std::max(value, stats.minimum), stats.maximum);
+    };
+    stats.eMin = clamp(percentile(bins, stats.numPixels, mOptions.pMin));
+    stats.eMax = clamp(percentile(bins, stats.numPixels, mOptions.pMax));
+
+    stats.low = stats.eMin -
+            mOptions.eMinModifier * (stats.eMin - stats.minimum);
+    stats.high = stats.eMax +
+            mOptions.eMaxModifier * (stats.maximum - stats.eMax);
+    mHaveDRA = true;
+}
+
+void DisplayProductGenerator::setDRA(const DRAStatistics& statistics)
+{
+    if (!(statistics.low <= statistics.high))
+    {
+        throw except::Exception(Ctxt(
+                "The low clip point must not be above the high one"));
+    }
+    mStatistics = statistics;
+    mHaveDRA = true;
+}
+
+void DisplayProductGenerator::generate(DisplayTileSource& source,
+                                       DisplayTileSink& sink)
+{
+    if (!mHaveDRA)
+    {
+        computeDRA(source);
+    }
+
+    const size_t numThreads = getNumThreads();
+    const size_t tileRows = std::min(mOptions.tileRows, mNumRows);
+    TileQueue tiles(mNumRows, tileRows);
+
+    runWorkers(numThreads, [&](size_t)
+    {
+        return std::make_unique<RemapRunnable>(
+                *this, source, sink, tiles, mNumCols, tileRows);
+    });
+}
+
+void DisplayProductGenerator::histogram(const float* magnitude, size_t size,
+                                        std::vector<uint64_t>& bins)
+{
+    if (bins.size() != NUM_BINS)
+    {
+        throw except::Exception(Ctxt("Histograms must have NUM_BINS bins"));
+    }
+
+    uint64_t* const counts = bins.data();
+    for (size_t ii = 0; ii < size; ++ii)
+    {
+        uint32_t bits;
+        memcpy(&bits, magnitude + ii, sizeof(bits));
+        ++counts[(bits >> 16) & 0x7FFF];
+    }
+}
+
+void DisplayProductGenerator::detect(const std::complex<float>* pixels,
+                                     size_t size,
+                                     float* magnitude)
+{
+    const float* in = reinterpret_cast<const float*>(pixels);
+    size_t ii = 0;
+
+#ifdef SIX_SIDD_DISPLAY_SSE2
+    for (; ii + 4 <= size; ii += 4)
+    {
+        // Square [re0 im0 re1 im1] and [re2 im2 re3 im3], then add the
+        // even and odd lanes
+        const __m128 a = _mm_loadu_ps(in + 2 * ii);
+        const __m128 b = _mm_loadu_ps(in + 2 * ii + 4);
+        const __m128 aa = _mm_mul_ps(a, a);
+        const __m128 bb = _mm_mul_ps(b, b);
+        const __m128 re = _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 im = _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(magnitude + ii, _mm_sqrt_ps(_mm_add_ps(re, im)));
+    }
+#endif
+
+    // Not std::abs(), which calls hypot() and so differs from the above
+    for (; ii < size; ++ii)
+    {
+        const float re = in[2 * ii];
+        const float im = in[2 * ii + 1];
+        magnitude[ii] = std::sqrt(re * re + im * im);
+    }
+}
+
+void DisplayProductGenerator::remap(const float* magnitude, size_t size,
+                                    uint8_t* pixels) const
+{
+    const float low = static_cast<float>(mStatistics.low);
+    const float scale = mStatistics.high > mStatistics.low ?
+            static_cast<float>(255.0 / (mStatistics.high - mStatistics.low)) :
+            0.0f;
+    size_t ii = 0;
+
+#ifdef SIX_SIDD_DISPLAY_SSE2
+    const __m128 lowV = _mm_set1_ps(low);
+    const __m128 scaleV = _mm_set1_ps(scale);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max = _mm_set1_ps(255.0f);
+    for (; ii + 16 <= size; ii += 16)
+    {
+        __m128i words[4];
+        for (size_t jj = 0; jj < 4; ++jj)
+        {
+            __m128 value = _mm_loadu_ps(magnitude + ii + 4 * jj);
+            value = _mm_mul_ps(_mm_sub_ps(value, lowV), scaleV);
+            value = _mm_min_ps(_mm_max_ps(value, zero), max);
+
+            // Rounds to nearest even, like std::nearbyint() below
+            words[jj] = _mm_cvtps_epi32(value);
+        }
+        const __m128i shorts0 = _mm_packs_epi32(words[0], words[1]);
+        const __m128i shorts1 = _mm_packs_epi32(words[2], words[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + ii),
+                         _mm_packus_epi16(shorts0, shorts1));
+    }
+#endif
+
+    // Written so NaN goes to 0, as it does with _mm_max_ps()
+    for (; ii < size; ++ii)
+    {
+        float value = (magnitude[ii] - low) * scale;
+        value = value > 0.0f ? value : 0.0f;
+        value = value < 255.0f ? value : 255.0f;
+        pixels[ii] = static_cast<uint8_t>(std::nearbyint(value));
+    }
+
+    if (mOptions.remapLUT.get())
+    {
+        const unsigned char* const lut = mOptions.remapLUT->getTable();
+        for (size_t jj = 0; jj < size; ++jj)
+        {
+            pixels[jj] = lut[pixels[jj]];
+        }
+    }
+}
+
+void DisplayProductGenerator::fillDisplay(Display& display) const
+{
+    display.pixelType = PixelType::MONO8I;
+    display.numBands = 1;
+
+    // SIDD 1.0
+    LUT* const remapLUT = mOptions.remapLUT.get() ?
+            mOptions.remapLUT->clone() : nullptr;
+    display.remapInformation.reset(
+            new MonochromeDisplayRemap("DRA", remapLUT));
+
+    // SIDD 2.0: the remap is the LUT, widened to 16 bits
+    if (display.nonInteractiveProcessing.empty())
+    {
+        display.nonInteractiveProcessing.resize(1);
+    }
+    if (!display.nonInteractiveProcessing[0].get())
+    {
+        display.nonInteractiveProcessing[0].reset(
+                new NonInteractiveProcessing());
+        display.nonInteractiveProcessing[0]->rrds.downsamplingMethod =
+                DownsamplingMethod::DECIMATE;
+    }
+    auto& options = display.nonInteractiveProcessing[0]->
+            productGenerationOptions;
+    options.dataRemapping.reset(new LookupTable());
+    options.dataRemapping->lutName = "DRA";
+    options.dataRemapping->custom.reset(new LookupTable::Custom(256, 1));
+    LUT& table = options.dataRemapping->custom->lutValues[0];
+    for (size_t ii = 0; ii < 256; ++ii)
+    {
+        const short value = mOptions.remapLUT.get() ?
+                *(*mOptions.remapLUT)[ii] : static_cast<short>(ii);
+        memcpy(table[ii], &value, sizeof(value));
+    }
+
+    if (display.interactiveProcessing.empty())
+    {
+        display.interactiveProcessing.resize(1);
+    }
+    if (!display.interactiveProcessing[0].get())
+    {
+        display.interactiveProcessing[0].reset(new InteractiveProcessing());
+    }
+    auto& dra = display.interactiveProcessing[0]->dynamicRangeAdjustment;
+    dra.algorithmType = DRAType::AUTO;
+    dra.bandStatsSource = 1;
+    dra.draParameters.reset(new DynamicRangeAdjustment::DRAParameters());
+    dra.draParameters->pMin = mOptions.pMin;
+    dra.draParameters->pMax = mOptions.pMax;
+    dra.draParameters->eMinModifier = mOptions.eMinModifier;
+    dra.draParameters->eMaxModifier = mOptions.eMaxModifier;
+}
+}
+}
@@ -142,6 +142,20 @@ void six::sidd::GeoTIFFReadControl::load_(const std::string& fromFile, const TSc
         throw except::Exception(Ctxt(fromFile + ": unexpected file type"));
     }
 
+    // Overviews follow the image they reduce
+    mLevels.clear();
+    for (uint32_t ii = 0; ii < mReader.getImageCount(); ++ii)
+    {
+        if (mReader[ii]->isReducedResolution() && !mLevels.empty())
+        {
+            mLevels.back().push_back(ii);
+        }
+        else
+        {
+            mLevels.push_back(std::vector<uint32_t>(1, ii));
+        }
+    }
+
     std::vector<std::u8string> xmlStrs;
     parseXMLEntry((*(mReader[0]->getIFD()))[six::Constants::GT_XML_KEY],
                   xmlStrs);
@@ -217,16 +231,51 @@ void six::sidd::GeoTIFFReadControl::load(const std::filesystem::path& fromFile_,
     load_(fromFile, pSchemaPaths, createXmlParser);
 }
 
-six::UByte* six::sidd::GeoTIFFReadControl::interleaved(six::Region& region,
-                                                       size_t imIndex)
+tiff::ImageReader*
+six::sidd::GeoTIFFReadControl::getImageReader(size_t imageNumber,
+                                              size_t level) const
 {
-    if (mReader.getImageCount() <= imIndex)
+    if (imageNumber >= mLevels.size())
     {
         throw except::IndexOutOfRangeException(Ctxt(
-                "Invalid index: " + std::to_string(imIndex)));
+                "Invalid index: " + std::to_string(imageNumber)));
     }
+    if (level >= mLevels[imageNumber].size())
+    {
+        throw except::IndexOutOfRangeException(Ctxt(
+                "Invalid level: " + std::to_string(level)));
+    }
+    return mReader[mLevels[imageNumber][level]];
+}
 
-    tiff::ImageReader *imReader = mReader[static_cast<uint32_t>(imIndex)];
+size_t six::sidd::GeoTIFFReadControl::getNumLevels(size_t imageNumber) const
+{
+    if (imageNumber >= mLevels.size())
+    {
+        throw except::IndexOutOfRangeException(Ctxt(
+                "Invalid index: " + std::to_string(imageNumber)));
+    }
+    return mLevels[imageNumber].size();
+}
+
+types::RowCol<size_t>
+six::sidd::GeoTIFFReadControl::getDims(size_t imageNumber, size_t level) const
+{
+    tiff::IFD* const ifd = getImageReader(imageNumber, level)->getIFD();
+    return types::RowCol<size_t>(ifd->getImageLength(), ifd->getImageWidth());
+}
+
+six::UByte* six::sidd::GeoTIFFReadControl::interleaved(six::Region& region,
+                                                       size_t imIndex)
+{
+    return readLevel(region, imIndex, 0);
+}
+
+six::UByte* six::sidd::GeoTIFFReadControl::readLevel(six::Region& region,
+                                                     size_t imIndex,
+                                                     size_t level)
+{
+    tiff::ImageReader* const imReader = getImageReader(imIndex, level);
     tiff::IFD *ifd = imReader->getIFD();
 
     const auto numRowsTotal = ifd->getImageLength();
@@ -267,36 +316,12 @@ six::UByte* six::sidd::GeoTIFFReadControl::interleaved(six::Region& region,
         buffer = region.setBuffer(regionExtent.area() * elemSize).release();
     }
 
-    if (numRowsReq == numRowsTotal && numColsReq == numColsTotal)
-    {
-        // one read
-        imReader->getData(reinterpret_cast<unsigned char*>(buffer), static_cast<uint32_t>(numRowsReq * numColsReq));
-    }
-    else
-    {
-        std::vector<std::byte> scopedRowBuf(gsl::narrow<size_t>(numColsTotal) * elemSize);
-        std::byte* const rowBuf(scopedRowBuf.data());
-
-        //        // skip past rows
-        //        for (size_t i = 0; i < startRow; ++i)
-        //            imReader->getData(rowBuf, numColsTotal);
-
-        size_t offset = 0;
-        // this is not the most efficient, but it works
-        for (size_t i = 0; i < static_cast<size_t>(numRowsReq); ++i)
-        {
-            auto rowBuf_ = reinterpret_cast<unsigned char*>(rowBuf);
-            // possibly skip past some cols
-            if (startCol > 0)
-                imReader->getData(rowBuf_, static_cast<uint32_t>(startCol));
-            imReader->getData(rowBuf_, static_cast<uint32_t>(numColsReq));
-            memcpy(buffer + offset, rowBuf, static_cast<size_t>(numColsReq * elemSize));
-            offset += numColsReq * elemSize;
-            // more skipping..
-            if (extentCols < numColsTotal)
-                imReader->getData(rowBuf_, static_cast<uint32_t>(numColsTotal - extentCols));
-        }
-    }
+    // Only the strips or tiles overlapping the region are read
+    imReader->getRegion(reinterpret_cast<unsigned char*>(buffer),
+                        gsl::narrow<uint32_t>(startRow),
+                        gsl::narrow<uint32_t>(numRowsReq),
+                        gsl::narrow<uint32_t>(startCol),
+                        gsl::narrow<uint32_t>(numColsReq));
     return buffer;
 }
 void six::sidd::GeoTIFFReadControl::interleaved(six::Region& region,
@@ -20,6 +20,7 @@
  *
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include <std/filesystem>
@@ -41,6 +42,47 @@ namespace fs = std::filesystem;
 using namespace six;
 using namespace six::sidd;
 
+namespace
+{
+// Room for the IFDs and XML, when deciding whether a file needs BigTIFF
+const uint64_t METADATA_ALLOWANCE = 64 * 1024 * 1024;
+
+// Cap on the elements passed to the TIFF writer at once
+const size_t MAX_ELEMENTS_PER_WRITE = 1 << 30;
+
+RRDSOptions getOverviewOptions(PixelType pixelType, int maxOverviews)
+{
+    RRDSOptions options;
+
+    // Averaging LUT indices would give the wrong colors
+    options.method = (pixelType == PixelType::MONO8LU ||
+                      pixelType == PixelType::RGB8LU) ?
+            DownsamplingMethod::DECIMATE : DownsamplingMethod::AVERAGE;
+    options.minDimension = GeoTIFFWriteControl::OVERVIEW_MIN_DIMENSION;
+    options.maxLevels = maxOverviews < 0 ? 0 : static_cast<size_t>(maxOverviews);
+    return options;
+}
+
+uint64_t getStoredSize(const types::RowCol<size_t>& dims,
+                       size_t tileSize,
+                       size_t bytesPerPixel)
+{
+    // Tiles past the edges are padded out to full size
+    types::RowCol<size_t> stored(dims);
+    if (tileSize > 0)
+    {
+        stored.row = (dims.row + tileSize - 1) / tileSize * tileSize;
+        stored.col = (dims.col + tileSize - 1) / tileSize * tileSize;
+    }
+    return static_cast<uint64_t>(stored.row) * stored.col * bytesPerPixel;
+}
+}
+
+const char GeoTIFFWriteControl::OPT_TILE_SIZE[] = "TileSize";
+const char GeoTIFFWriteControl::OPT_BIG_TIFF[] = "BigTIFF";
+const char GeoTIFFWriteControl::OPT_MAX_OVERVIEWS[] = "MaxOverviews";
+const size_t GeoTIFFWriteControl::OVERVIEW_MIN_DIMENSION = 256;
+
 GeoTIFFWriteControl::GeoTIFFWriteControl()
 {
     tiff::KnownTagsRegistry::getInstance().addEntry(Constants::GT_XML_KEY,
@@ -55,8 +97,6 @@ void GeoTIFFWriteControl::initialize(std::shared_ptr<Container> container)
 
     // There still could be complex data in the container though, so we
     // will keep those around for later
-
-    uint64_t length = 0;
     for (size_t ii = 0; ii < container->size(); ++ii)
     {
         Data* data = container->getData(ii);
@@ -64,16 +104,6 @@ void GeoTIFFWriteControl::initialize(std::shared_ptr<Container> container)
             mComplexData.push_back(data);
         else if (data->getDataType() == DataType::DERIVED)
         {
-            //length = ??
-            length += gsl::narrow<uint64_t>(data->getNumBytesPerPixel())
-                    * gsl::narrow<uint64_t>(data->getNumRows())
-                    * gsl::narrow<uint64_t>(data->getNumCols());
-
-            if (length > Constants::GT_SIZE_MAX)
-                throw except::Exception(Ctxt(
-                        "Data segments are too large to be stored in " \
-                        "GeoTIFF format"));
-
             mDerivedData.push_back(data);
         }
         else
@@ -90,30 +120,27 @@ void GeoTIFFWriteControl::save(const SourceList& sources,
 {
     tiff::FileWriter tiffWriter(toFile);
 
-    tiffWriter.writeHeader();
+    tiffWriter.writeHeader(needsBigTIFF());
     if (sources.size() != mDerivedData.size())
         throw except::Exception(Ctxt(FmtX(
                 "Meta-data count [%d] does not match source list [%d]",
                 mDerivedData.size(), sources.size())));
 
-    std::vector<unsigned char> buf;
+    std::vector<std::byte> buf;
     for (size_t ii = 0; ii < sources.size(); ++ii)
     {
-        tiff::ImageWriter* const imageWriter = tiffWriter.addImage();
         const DerivedData* const data =  static_cast<DerivedData*>(mDerivedData[ii]);
         const size_t oneRow = data->getNumCols() * data->getNumBytesPerPixel();
-        tiff::IFD* ifd = imageWriter->getIFD();
-        setupIFD(data, ifd, sys::Path::splitExt(toFile).first, schemaPaths);
-        buf.resize(oneRow);
-
-        const auto extent = getExtent(*data);
-        const auto numCols = static_cast<uint32_t>(extent.col);
-        for (size_t row = 0; row < extent.row; ++row)
+        io::InputStream& source = *sources[ii];
+        const auto getRows = [&](size_t, size_t numRows)
         {
-            sources[ii]->read(buf.data(), oneRow);
-            imageWriter->putData(buf.data(), numCols);
-        }
-        imageWriter->writeIFD();
+            buf.resize(numRows * oneRow);
+            source.read(buf.data(), buf.size());
+            return static_cast<const std::byte*>(buf.data());
+        };
+
+        writeImage(tiffWriter, *data, sys::Path::splitExt(toFile).first,
+                   schemaPaths, getRows);
     }
 
     tiffWriter.close();
@@ -125,57 +152,7 @@ void GeoTIFFWriteControl::setupIFD(const DerivedData* data,
                                    const std::string& toFilePrefix,
                                    const std::vector<std::string>& schemaPaths)
 {
-    const PixelType pixelType = data->getPixelType();
-    const types::RowCol<uint32_t> extent(getExtent(*data));
-    const auto numRows = extent.row;
-    const auto numCols = extent.col;
-
-    // Start by initializing the TIFF info
-    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, numCols);
-
-    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, numRows);
-    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE);
-
-    tiff::IFDEntry* bitsPerSample = (*ifd)[tiff::KnownTags::BITS_PER_SAMPLE];
-
-    const auto numBands = data->getNumChannels();
-    const auto bitDepth = data->getNumBytesPerPixel() * 8 / numBands;
-
-    for (unsigned int j = 0; j < numBands; ++j)
-    {
-        bitsPerSample->addValue(tiff::TypeFactory::create(
-                (unsigned char*) &bitDepth,
-                tiff::Const::Type::SHORT));
-    }
-
-    unsigned short photoInterp(1);
-
-    if (pixelType == PixelType::RGB8LU)
-    {
-        ifd->addEntry("ColorMap");
-        tiff::IFDEntry* lutEntry = (*ifd)["ColorMap"];
-        LUT& lut = *data->display->remapInformation->remapLUT;
-
-        for (unsigned int j = 0; j < 3; ++j)
-        {
-            for (unsigned int i = 0; i < lut.numEntries; ++i)
-            {
-                const unsigned short lutij = lut[i][j];
-                lutEntry->addValue(tiff::TypeFactory::create(
-                        (unsigned char*) &lutij,
-                        tiff::Const::Type::SHORT));
-            }
-        }
-
-        photoInterp = 3;
-    }
-    else if (pixelType == PixelType::RGB24I)
-    {
-        constexpr short spp = 3;
-        ifd->addEntry(tiff::KnownTags::SAMPLES_PER_PIXEL, spp);
-        photoInterp = 2;
-    }
-    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION, photoInterp);
+    setupImageFormat(*data, getExtent(*data), ifd);
 
     addStringArray(ifd,
                    "ImageDescription",
@@ -245,30 +222,221 @@ void GeoTIFFWriteControl::setupIFD(const DerivedData* data,
     }
 }
 
-inline void putData(tiff::ImageWriter& imageWriter,
-    const six::UByte* const sources_ii, const DerivedData& data)
+void GeoTIFFWriteControl::setupImageFormat(const DerivedData& data,
+                                           const types::RowCol<size_t>& extent,
+                                           tiff::IFD* ifd)
 {
-    imageWriter.putData(sources_ii, static_cast<uint32_t>(getExtent(data).area()));
+    const PixelType pixelType = data.getPixelType();
+    const auto numRows = gsl::narrow<uint32_t>(extent.row);
+    const auto numCols = gsl::narrow<uint32_t>(extent.col);
+
+    // Start by initializing the TIFF info
+    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, numCols);
+
+    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, numRows);
+    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE);
+
+    tiff::IFDEntry* bitsPerSample = (*ifd)[tiff::KnownTags::BITS_PER_SAMPLE];
+
+    const auto numBands = data.getNumChannels();
+    const auto bitDepth =
+            static_cast<unsigned short>(data.getNumBytesPerPixel() * 8 / numBands);
+
+    for (unsigned int j = 0; j < numBands; ++j)
+    {
+        bitsPerSample->addValue(tiff::TypeFactory::create(
+                (unsigned char*) &bitDepth,
+                tiff::Const::Type::SHORT));
+    }
+
+    unsigned short photoInterp(1);
+
+    if (pixelType == PixelType::RGB8LU)
+    {
+        ifd->addEntry("ColorMap");
+        tiff::IFDEntry* lutEntry = (*ifd)["ColorMap"];
+        LUT& lut = *data.display->remapInformation->remapLUT;
+
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            for (unsigned int i = 0; i < lut.numEntries; ++i)
+            {
+                const unsigned short lutij = lut[i][j];
+                lutEntry->addValue(tiff::TypeFactory::create(
+                        (unsigned char*) &lutij,
+                        tiff::Const::Type::SHORT));
+            }
+        }
+
+        photoInterp = 3;
+    }
+    else if (pixelType == PixelType::RGB24I)
+    {
+        constexpr short spp = 3;
+        ifd->addEntry(tiff::KnownTags::SAMPLES_PER_PIXEL, spp);
+        photoInterp = 2;
+    }
+    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION, photoInterp);
+}
+
+size_t GeoTIFFWriteControl::getTileSize() const
+{
+    return static_cast<size_t>(getOptions().getParameter(
+            OPT_TILE_SIZE, Parameter(0)));
+}
+
+void GeoTIFFWriteControl::setTiling(tiff::ImageWriter& imageWriter) const
+{
+    const size_t tileSize = getTileSize();
+    if (tileSize > 0)
+    {
+        imageWriter.setTileSize(gsl::narrow<uint32_t>(tileSize),
+                                gsl::narrow<uint32_t>(tileSize));
+    }
+}
+
+bool GeoTIFFWriteControl::needsBigTIFF() const
+{
+    if (static_cast<int>(getOptions().getParameter(OPT_BIG_TIFF, Parameter(0))))
+    {
+        return true;
+    }
+
+    const size_t tileSize = getTileSize();
+    const int maxOverviews = getMaxOverviews();
+
+    uint64_t length = 0;
+    for (const Data* data : mDerivedData)
+    {
+        const RRDSOptions options =
+                getOverviewOptions(data->getPixelType(), maxOverviews);
+        const size_t bytesPerPixel = data->getNumBytesPerPixel();
+
+        // Same levels as RRDSBuilder
+        types::RowCol<size_t> dims = getExtent(*data);
+        length += getStoredSize(dims, tileSize, bytesPerPixel);
+        for (size_t level = 0;
+             maxOverviews != 0 &&
+             (options.maxLevels == 0 || level < options.maxLevels) &&
+             std::max(dims.row, dims.col) > options.minDimension;
+             ++level)
+        {
+            dims = types::RowCol<size_t>((dims.row + 1) / 2,
+                                         (dims.col + 1) / 2);
+            length += getStoredSize(dims, tileSize, bytesPerPixel);
+        }
+    }
+
+    return length + METADATA_ALLOWANCE > Constants::GT_SIZE_MAX;
 }
-inline void putData(tiff::ImageWriter& imageWriter,
-    std::span<const std::byte> sources_ii, const DerivedData& data)
+
+int GeoTIFFWriteControl::getMaxOverviews() const
 {
-    if (sources_ii.size() != getExtent(data).area())
+    return static_cast<int>(
+            getOptions().getParameter(OPT_MAX_OVERVIEWS, Parameter(0)));
+}
+
+std::unique_ptr<RRDSBuilder> GeoTIFFWriteControl::addOverviews(
+        tiff::FileWriter& tiffWriter,
+        const DerivedData& data,
+        tiff::ImageWriter& imageWriter,
+        std::vector<tiff::ImageWriter*>& overviewWriters) const
+{
+    const int maxOverviews = getMaxOverviews();
+    if (maxOverviews == 0)
     {
-        throw std::logic_error("sizes don't match!");
+        return nullptr;
     }
 
-    const void* pSource = sources_ii.data();
-    imageWriter.putData(static_cast<const unsigned char*>(pSource), static_cast<uint32_t>(sources_ii.size()));
+    // Each overview row goes straight to its image, so no level is ever
+    // held in memory
+    const auto writeRow = [&overviewWriters](size_t level, size_t,
+                                             const std::byte* pixels)
+    {
+        tiff::ImageWriter* const overviewWriter = overviewWriters[level - 1];
+        overviewWriter->putData(
+                reinterpret_cast<const unsigned char*>(pixels),
+                overviewWriter->getIFD()->getImageWidth());
+    };
+    std::unique_ptr<RRDSBuilder> builder(new RRDSBuilder(
+            getExtent(data), data.getPixelType(), writeRow,
+            getOverviewOptions(data.getPixelType(), maxOverviews)));
+    if (builder->getNumLevels() == 0)
+    {
+        return nullptr;
+    }
+
+    tiff::ImageWriter* previous = &imageWriter;
+    for (size_t level = 1; level <= builder->getNumLevels(); ++level)
+    {
+        tiff::ImageWriter* const overviewWriter = tiffWriter.addImage();
+        tiff::IFD* const ifd = overviewWriter->getIFD();
+
+        // A reduced resolution version of the image before it
+        constexpr uint32_t subfileType = 1;
+        ifd->addEntry("NewSubfileType", subfileType);
+
+        setupImageFormat(data, builder->getDims(level), ifd);
+        ifd->addEntry(tiff::KnownTags::COMPRESSION,
+                      (unsigned short) tiff::Const::CompressionType::NO_COMPRESSION);
+        constexpr unsigned short planarConf = 1;
+        ifd->addEntry("PlanarConfiguration", planarConf);
+        setTiling(*overviewWriter);
+
+        overviewWriter->setDataOffset(previous->getDataEnd());
+        overviewWriters.push_back(overviewWriter);
+        previous = overviewWriter;
+    }
+    return builder;
 }
-template<typename TBufferList>
-void GeoTIFFWriteControl::save(const TBufferList& sources,
-                               const std::string& toFile,
-                               const std::vector<std::string>& schemaPaths)
+
+template<typename TGetRows>
+void GeoTIFFWriteControl::writeImage(tiff::FileWriter& tiffWriter,
+                                     const DerivedData& data,
+                                     const std::string& toFilePrefix,
+                                     const std::vector<std::string>& schemaPaths,
+                                     TGetRows getRows)
+{
+    tiff::ImageWriter* const imageWriter = tiffWriter.addImage();
+    setupIFD(&data, imageWriter->getIFD(), toFilePrefix, schemaPaths);
+    setTiling(*imageWriter);
+
+    std::vector<tiff::ImageWriter*> overviewWriters;
+    const std::unique_ptr<RRDSBuilder> overviewBuilder =
+            addOverviews(tiffWriter, data, *imageWriter, overviewWriters);
+
+    // A row of tiles at a time, which is what the TIFF writer buffers
+    const auto extent = getExtent(data);
+    const size_t rowsPerWrite = std::max<size_t>(
+            std::min(std::max<size_t>(getTileSize(), 1),
+                     MAX_ELEMENTS_PER_WRITE / extent.col), 1);
+    for (size_t row = 0; row < extent.row; row += rowsPerWrite)
+    {
+        const size_t numRows = std::min(rowsPerWrite, extent.row - row);
+        const std::byte* const rows = getRows(row, numRows);
+        imageWriter->putData(reinterpret_cast<const unsigned char*>(rows),
+                             gsl::narrow<uint32_t>(numRows * extent.col));
+        if (overviewBuilder)
+        {
+            overviewBuilder->addRows(rows, numRows);
+        }
+    }
+
+    // The IFDs go after all of the data, in order
+    imageWriter->writeIFD();
+    for (tiff::ImageWriter* const overviewWriter : overviewWriters)
+    {
+        overviewWriter->writeIFD();
+    }
+}
+
+void GeoTIFFWriteControl::save(const BufferList& sources,
+    const std::string& toFile,
+    const std::vector<std::string>& schemaPaths)
 {
     tiff::FileWriter tiffWriter(toFile);
 
-    tiffWriter.writeHeader();
+    tiffWriter.writeHeader(needsBigTIFF());
     if (sources.size() != mDerivedData.size())
         throw except::Exception(Ctxt(FmtX(
                 "Meta-data count [%d] does not match source list [%d]",
@@ -276,27 +444,20 @@ void GeoTIFFWriteControl::save(const TBufferList& sources,
 
     for (size_t ii = 0; ii < sources.size(); ++ii)
     {
-
-        tiff::ImageWriter* imageWriter = tiffWriter.addImage();
-        tiff::IFD* ifd = imageWriter->getIFD();
-
         const DerivedData* const data = (DerivedData*) mDerivedData[ii];
-        setupIFD(data, ifd, sys::Path::splitExt(toFile).first, schemaPaths);        
-
-        // Now we hack to write
-        putData(*imageWriter, sources[ii], *data);
+        const size_t oneRow = data->getNumCols() * data->getNumBytesPerPixel();
+        const auto image = reinterpret_cast<const std::byte*>(sources[ii]);
+        const auto getRows = [&](size_t row, size_t)
+        {
+            return image + row * oneRow;
+        };
 
-        imageWriter->writeIFD();
+        writeImage(tiffWriter, *data, sys::Path::splitExt(toFile).first,
+                   schemaPaths, getRows);
     }
 
     tiffWriter.close();
 }
-void GeoTIFFWriteControl::save(const BufferList& sources,
-    const std::string& toFile,
-    const std::vector<std::string>& schemaPaths)
-{
-    save(sources, toFile, schemaPaths);
-}
 
 void GeoTIFFWriteControl::addCharArray(tiff::IFD* ifd, const std::string &tag,
                                        const char* cstr, int tiffType)
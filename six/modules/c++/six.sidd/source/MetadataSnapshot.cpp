@@ -0,0 +1,883 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/sidd/MetadataSnapshot.h>
+
+#include <except/Exception.h>
+
+namespace
+{
+const char SNAPSHOT_IDENTIFIER[] = "DERIVED";
+}
+
+namespace six
+{
+namespace sidd
+{
+// These are static, but they need to be in six::sidd so that the archive
+// can find them by argument dependent lookup.  Each is defined before the
+// types that contain it.
+static void snapshot(SnapshotArchive& archive,
+                     ProcessorInformation& processorInformation)
+{
+    archive(processorInformation.application,
+            processorInformation.processingDateTime,
+            processorInformation.site,
+            processorInformation.profile);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DerivedClassification& classification)
+{
+    archive(classification.securityExtensions,
+            classification.desVersion,
+            classification.createDate,
+            classification.compliesWith,
+            classification.classification,
+            classification.ownerProducer,
+            classification.sciControls,
+            classification.sarIdentifier,
+            classification.disseminationControls,
+            classification.fgiSourceOpen,
+            classification.fgiSourceProtected,
+            classification.releasableTo,
+            classification.nonICMarkings,
+            classification.classifiedBy,
+            classification.compilationReason,
+            classification.derivativelyClassifiedBy,
+            classification.classificationReason,
+            classification.nonUSControls,
+            classification.derivedFrom,
+            classification.declassDate,
+            classification.declassEvent,
+            classification.declassException,
+            classification.exemptedSourceType,
+            classification.exemptedSourceDate,
+            classification.exemptFrom,
+            classification.joint,
+            classification.atomicEnergyMarkings,
+            classification.displayOnlyTo,
+            classification.noticeType,
+            classification.noticeReason,
+            classification.noticeDate,
+            classification.unregisteredNoticeType,
+            classification.externalNotice);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ProductCreation& productCreation)
+{
+    archive(productCreation.processorInformation,
+            productCreation.classification,
+            productCreation.productName,
+            productCreation.productClass,
+            productCreation.productType,
+            productCreation.productCreationExtensions);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     mem::ScopedCloneablePtr<Remap>& remap)
+{
+    if (!archive.transfer(remap.get() != nullptr))
+    {
+        remap.reset();
+        return;
+    }
+
+    // The only two kinds of remap
+    auto monochrome = dynamic_cast<MonochromeDisplayRemap*>(remap.get());
+    if (archive.transfer(monochrome != nullptr))
+    {
+        if (archive.isReading())
+        {
+            monochrome = new MonochromeDisplayRemap("");
+            remap.reset(monochrome);
+        }
+        archive(monochrome->remapType, monochrome->remapParameters);
+    }
+    else if (archive.isReading())
+    {
+        remap.reset(new ColorDisplayRemap());
+    }
+    archive(remap->displayType, remap->remapLUT);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     MonitorCompensationApplied& monitorCompensationApplied)
+{
+    archive(monitorCompensationApplied.gamma, monitorCompensationApplied.xMin);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DRAHistogramOverrides& histogramOverrides)
+{
+    archive(histogramOverrides.clipMin, histogramOverrides.clipMax);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     LookupTable::Predefined& predefined)
+{
+    archive(predefined.databaseName, predefined.remapFamily,
+            predefined.remapMember);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     mem::ScopedCopyablePtr<LookupTable::Custom>& custom)
+{
+    if (!archive.transfer(custom.get() != nullptr))
+    {
+        custom.reset();
+        return;
+    }
+    if (archive.isReading())
+    {
+        custom.reset(new LookupTable::Custom(0, 0));
+    }
+    snapshot(archive, custom->lutValues);
+}
+
+static void snapshot(SnapshotArchive& archive, LookupTable& lookupTable)
+{
+    archive(lookupTable.lutName, lookupTable.predefined, lookupTable.custom);
+}
+
+static void snapshot(SnapshotArchive& archive, Filter::Predefined& predefined)
+{
+    archive(predefined.databaseName, predefined.filterFamily,
+            predefined.filterMember);
+}
+
+static void snapshot(SnapshotArchive& archive, Filter::Kernel::Custom& custom)
+{
+    archive(custom.size, custom.filterCoef);
+}
+
+static void snapshot(SnapshotArchive& archive, Filter::Kernel& kernel)
+{
+    archive(kernel.predefined, kernel.custom);
+}
+
+static void snapshot(SnapshotArchive& archive, Filter::Bank::Custom& custom)
+{
+    archive(custom.numPhasings, custom.numPoints, custom.filterCoef);
+}
+
+static void snapshot(SnapshotArchive& archive, Filter::Bank& bank)
+{
+    archive(bank.predefined, bank.custom);
+}
+
+static void snapshot(SnapshotArchive& archive, Filter& filter)
+{
+    archive(filter.filterName, filter.filterKernel, filter.filterBank,
+            filter.operation);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     BandEqualization& bandEqualization)
+{
+    archive(bandEqualization.algorithm, bandEqualization.bandLUTs);
+}
+
+static void snapshot(SnapshotArchive& archive, RRDS& rrds)
+{
+    archive(rrds.downsamplingMethod, rrds.antiAlias, rrds.interpolation);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ProductGenerationOptions& options)
+{
+    archive(options.bandEqualization,
+            options.modularTransferFunctionRestoration,
+            options.dataRemapping,
+            options.asymmetricPixelCorrection);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     NonInteractiveProcessing& processing)
+{
+    archive(processing.productGenerationOptions, processing.rrds);
+}
+
+static void snapshot(SnapshotArchive& archive, Scaling& scaling)
+{
+    archive(scaling.antiAlias, scaling.interpolation);
+}
+
+static void snapshot(SnapshotArchive& archive, Orientation& orientation)
+{
+    archive(orientation.shadowDirection);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     GeometricTransform& geometricTransform)
+{
+    archive(geometricTransform.scaling, geometricTransform.orientation);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     SharpnessEnhancement& sharpnessEnhancement)
+{
+    archive(sharpnessEnhancement.modularTransferFunctionCompensation,
+            sharpnessEnhancement.modularTransferFunctionEnhancement);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ColorManagementModule& colorManagementModule)
+{
+    archive(colorManagementModule.renderingIntent,
+            colorManagementModule.sourceProfile,
+            colorManagementModule.displayProfile,
+            colorManagementModule.iccProfile);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ColorSpaceTransform& colorSpaceTransform)
+{
+    archive(colorSpaceTransform.colorManagementModule);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DynamicRangeAdjustment::DRAParameters& parameters)
+{
+    archive(parameters.pMin, parameters.pMax, parameters.eMinModifier,
+            parameters.eMaxModifier);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DynamicRangeAdjustment::DRAOverrides& overrides)
+{
+    archive(overrides.subtractor, overrides.multiplier);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DynamicRangeAdjustment& dynamicRangeAdjustment)
+{
+    archive(dynamicRangeAdjustment.algorithmType,
+            dynamicRangeAdjustment.bandStatsSource,
+            dynamicRangeAdjustment.draParameters,
+            dynamicRangeAdjustment.draOverrides);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     InteractiveProcessing& processing)
+{
+    archive(processing.geometricTransform,
+            processing.sharpnessEnhancement,
+            processing.colorSpaceTransform,
+            processing.dynamicRangeAdjustment,
+            processing.tonalTransferCurve);
+}
+
+static void snapshot(SnapshotArchive& archive, Display& display)
+{
+    archive(display.pixelType,
+            display.remapInformation,
+            display.magnificationMethod,
+            display.decimationMethod,
+            display.histogramOverrides,
+            display.monitorCompensationApplied,
+            display.numBands,
+            display.defaultBandDisplay,
+            display.nonInteractiveProcessing,
+            display.interactiveProcessing,
+            display.displayExtensions);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     GeographicInformation& geographicInformation)
+{
+    archive(geographicInformation.countryCodes,
+            geographicInformation.securityInformation,
+            geographicInformation.geographicInformationExtensions);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     GeographicCoverage& geographicCoverage)
+{
+    archive(geographicCoverage.regionType,
+            geographicCoverage.georegionIdentifiers,
+            geographicCoverage.footprint,
+            geographicCoverage.subRegion,
+            geographicCoverage.geographicInformation);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     mem::ScopedCopyablePtr<GeographicCoverage>& coverage)
+{
+    if (!archive.transfer(coverage.get() != nullptr))
+    {
+        coverage.reset();
+        return;
+    }
+    if (archive.isReading())
+    {
+        coverage.reset(new GeographicCoverage(RegionType::NOT_SET));
+    }
+    archive(*coverage);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     TargetInformation& targetInformation)
+{
+    archive(targetInformation.identifiers,
+            targetInformation.footprint,
+            targetInformation.targetInformationExtensions);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     GeographicAndTarget& geographicAndTarget)
+{
+    archive(geographicAndTarget.geographicCoverage,
+            geographicAndTarget.targetInformation,
+            geographicAndTarget.geoInfos);
+}
+
+static void snapshot(SnapshotArchive& archive, ProductPlane& productPlane)
+{
+    archive(productPlane.rowUnitVector, productPlane.colUnitVector);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     mem::ScopedCloneablePtr<Projection>& projection)
+{
+    if (!archive.transfer(projection.get() != nullptr))
+    {
+        projection.reset();
+        return;
+    }
+
+    // The projection type says which kind of projection it is
+    ProjectionType type =
+            archive.transfer(projection.get() ? projection->projectionType
+                                              : ProjectionType());
+    if (archive.isReading())
+    {
+        switch (type)
+        {
+        case ProjectionType::GEOGRAPHIC:
+            projection.reset(new GeographicProjection());
+            break;
+        case ProjectionType::CYLINDRICAL:
+            projection.reset(new CylindricalProjection());
+            break;
+        case ProjectionType::PLANE:
+            projection.reset(new PlaneProjection());
+            break;
+        case ProjectionType::POLYNOMIAL:
+            projection.reset(new PolynomialProjection());
+            break;
+        default:
+            throw except::Exception(Ctxt(
+                    "Metadata snapshot has an invalid projection type"));
+        }
+    }
+    archive(projection->referencePoint);
+
+    if (auto polynomial =
+                dynamic_cast<PolynomialProjection*>(projection.get()))
+    {
+        archive(polynomial->rowColToLat,
+                polynomial->rowColToLon,
+                polynomial->rowColToAlt,
+                polynomial->latLonToRow,
+                polynomial->latLonToCol);
+    }
+    if (auto measurable =
+                dynamic_cast<MeasurableProjection*>(projection.get()))
+    {
+        archive(measurable->sampleSpacing, measurable->timeCOAPoly);
+    }
+    if (auto cylindrical =
+                dynamic_cast<CylindricalProjection*>(projection.get()))
+    {
+        archive(cylindrical->stripmapDirection,
+                cylindrical->curvatureRadius);
+    }
+    if (auto plane = dynamic_cast<PlaneProjection*>(projection.get()))
+    {
+        archive(plane->productPlane);
+    }
+}
+
+static void snapshot(SnapshotArchive& archive, Measurement& measurement)
+{
+    archive(measurement.projection,
+            measurement.pixelFootprint,
+            measurement.arpFlag,
+            measurement.arpPoly,
+            measurement.validData);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     mem::ScopedCopyablePtr<Measurement>& measurement)
+{
+    if (!archive.transfer(measurement.get() != nullptr))
+    {
+        measurement.reset();
+        return;
+    }
+    if (archive.isReading())
+    {
+        measurement.reset(new Measurement(ProjectionType::NOT_SET));
+    }
+    archive(*measurement);
+}
+
+static void snapshot(SnapshotArchive& archive, InputROI& inputROI)
+{
+    archive(inputROI.size, inputROI.upperLeft);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     TxRcvPolarization& polarization)
+{
+    archive(polarization.txPolarization,
+            polarization.rcvPolarization,
+            polarization.rcvPolarizationOffset,
+            polarization.processed);
+}
+
+static void snapshot(SnapshotArchive& archive, Information& information)
+{
+    archive(information.sensorName,
+            information.radarMode,
+            information.radarModeID,
+            information.collectionDateTime,
+            information.localDateTime,
+            information.collectionDuration,
+            information.resolution,
+            information.inputROI,
+            information.polarization);
+}
+
+static void snapshot(SnapshotArchive& archive, Geometry& geometry)
+{
+    archive(geometry.azimuth,
+            geometry.slope,
+            geometry.squint,
+            geometry.graze,
+            geometry.tilt,
+            geometry.dopplerConeAngle,
+            geometry.extensions);
+}
+
+static void snapshot(SnapshotArchive& archive, Phenomenology& phenomenology)
+{
+    archive(phenomenology.shadow,
+            phenomenology.layover,
+            phenomenology.multiPath,
+            phenomenology.groundTrack,
+            phenomenology.extensions);
+}
+
+static void snapshot(SnapshotArchive& archive, Collection& collection)
+{
+    archive(collection.identifier,
+            collection.information,
+            collection.geometry,
+            collection.phenomenology);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ProcTxRcvPolarization& polarization)
+{
+    archive(polarization.txPolarizationProc,
+            polarization.rcvPolarizationProc);
+}
+
+static void snapshot(SnapshotArchive& archive, Product& product)
+{
+    archive(product.resolution,
+            product.ellipticity,
+            product.polarization,
+            product.north,
+            product.extensions);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ExploitationFeatures& exploitationFeatures)
+{
+    archive(exploitationFeatures.collections, exploitationFeatures.product);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ProcessingModule& processingModule)
+{
+    archive(processingModule.moduleName,
+            processingModule.moduleParameters,
+            processingModule.processingModules);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ProductProcessing& productProcessing)
+{
+    archive(productProcessing.processingModules);
+}
+
+static void snapshot(SnapshotArchive& archive, GeometricChip& geometricChip)
+{
+    archive(geometricChip.chipSize,
+            geometricChip.originalUpperLeftCoordinate,
+            geometricChip.originalUpperRightCoordinate,
+            geometricChip.originalLowerLeftCoordinate,
+            geometricChip.originalLowerRightCoordinate);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     ProcessingEvent& processingEvent)
+{
+    archive(processingEvent.applicationName,
+            processingEvent.appliedDateTime,
+            processingEvent.interpolationMethod,
+            processingEvent.descriptor);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DownstreamReprocessing& downstreamReprocessing)
+{
+    archive(downstreamReprocessing.geometricChip,
+            downstreamReprocessing.processingEvents);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     J2KCompression::Layer& layer)
+{
+    archive(layer.bitRate);
+}
+
+static void snapshot(SnapshotArchive& archive, J2KCompression& compression)
+{
+    archive(compression.numWaveletLevels, compression.numBands,
+            compression.layerInfo);
+}
+
+static void snapshot(SnapshotArchive& archive, Compression& compression)
+{
+    archive(compression.original, compression.parsed);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     GeographicCoordinates& geographicCoordinates)
+{
+    archive(geographicCoordinates.longitudeDensity,
+            geographicCoordinates.latitudeDensity,
+            geographicCoordinates.referenceOrigin);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     Geopositioning& geopositioning)
+{
+    archive(geopositioning.coordinateSystemType,
+            geopositioning.geodeticDatum,
+            geopositioning.referenceEllipsoid,
+            geopositioning.verticalDatum,
+            geopositioning.soundingDatum,
+            geopositioning.falseOrigin,
+            geopositioning.utmGridZoneNumber);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     PositionalAccuracy& positionalAccuracy)
+{
+    archive(positionalAccuracy.numRegions,
+            positionalAccuracy.absoluteAccuracyHorizontal,
+            positionalAccuracy.absoluteAccuracyVertical,
+            positionalAccuracy.pointToPointAccuracyHorizontal,
+            positionalAccuracy.pointToPointAccuracyVertical);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     DigitalElevationData& digitalElevationData)
+{
+    archive(digitalElevationData.geographicCoordinates,
+            digitalElevationData.geopositioning,
+            digitalElevationData.positionalAccuracy,
+            digitalElevationData.nullValue);
+}
+
+static void snapshot(SnapshotArchive& archive, SFAPoint& point)
+{
+    archive(point.x, point.y, point.z, point.m);
+}
+
+static void snapshot(SnapshotArchive& archive, SFALineString& lineString)
+{
+    archive(lineString.vertices);
+}
+
+static void snapshot(SnapshotArchive& archive, SFAPolygon& polygon)
+{
+    archive(polygon.rings);
+}
+
+// SFA objects are created from the type name they were written with
+static SFAGeometry* newSFAGeometry(const std::string& type)
+{
+    if (type == SFAPoint::TYPE_NAME)
+    {
+        return new SFAPoint();
+    }
+    if (type == SFALineString::TYPE_NAME)
+    {
+        return new SFALineString();
+    }
+    if (type == SFALine::TYPE_NAME)
+    {
+        return new SFALine();
+    }
+    if (type == SFALinearRing::TYPE_NAME)
+    {
+        return new SFALinearRing();
+    }
+    if (type == SFAPolygon::TYPE_NAME)
+    {
+        return new SFAPolygon();
+    }
+    if (type == SFATriangle::TYPE_NAME)
+    {
+        return new SFATriangle();
+    }
+    if (type == SFAPolyhedralSurface::TYPE_NAME)
+    {
+        return new SFAPolyhedralSurface();
+    }
+    if (type == SFATriangulatedIrregularNetwork::TYPE_NAME)
+    {
+        return new SFATriangulatedIrregularNetwork();
+    }
+    if (type == SFAMultiPoint::TYPE_NAME)
+    {
+        return new SFAMultiPoint();
+    }
+    if (type == SFAMultiLineString::TYPE_NAME)
+    {
+        return new SFAMultiLineString();
+    }
+    if (type == SFAMultiPolygon::TYPE_NAME)
+    {
+        return new SFAMultiPolygon();
+    }
+    throw except::Exception(Ctxt(
+            "Metadata snapshot has an invalid SFA geometry type " + type));
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     mem::ScopedCloneablePtr<SFAGeometry>& geometry)
+{
+    if (!archive.transfer(geometry.get() != nullptr))
+    {
+        geometry.reset();
+        return;
+    }
+
+    const std::string type =
+            archive.transfer(geometry.get() ? geometry->getType()
+                                            : std::string());
+    if (archive.isReading())
+    {
+        geometry.reset(newSFAGeometry(type));
+    }
+
+    SFAGeometry* const g = geometry.get();
+    if (auto point = dynamic_cast<SFAPoint*>(g))
+    {
+        archive(*point);
+    }
+    else if (auto lineString = dynamic_cast<SFALineString*>(g))
+    {
+        archive(*lineString);
+    }
+    else if (auto polygon = dynamic_cast<SFAPolygon*>(g))
+    {
+        archive(*polygon);
+    }
+    else if (auto surface = dynamic_cast<SFAPolyhedralSurface*>(g))
+    {
+        archive(surface->patches);
+    }
+    else if (auto tin = dynamic_cast<SFATriangulatedIrregularNetwork*>(g))
+    {
+        archive(tin->patches);
+    }
+    else if (auto multiPoint = dynamic_cast<SFAMultiPoint*>(g))
+    {
+        archive(multiPoint->vertices);
+    }
+    else if (auto multiLineString = dynamic_cast<SFAMultiLineString*>(g))
+    {
+        archive(multiLineString->elements);
+    }
+    else if (auto multiPolygon = dynamic_cast<SFAMultiPolygon*>(g))
+    {
+        archive(multiPolygon->elements);
+    }
+    else
+    {
+        throw except::Exception(Ctxt(
+                "Can't snapshot SFA geometry type " + type));
+    }
+}
+
+static void snapshot(SnapshotArchive& archive, SFADatum& datum)
+{
+    archive(datum.spheroid.name,
+            datum.spheroid.semiMajorAxis,
+            datum.spheroid.inverseFlattening);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     SFAPrimeMeridian& primeMeridian)
+{
+    archive(primeMeridian.name, primeMeridian.longitude);
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     SFAGeographicCoordinateSystem& coordinateSystem)
+{
+    archive(coordinateSystem.csName,
+            coordinateSystem.datum,
+            coordinateSystem.primeMeridian,
+            coordinateSystem.angularUnit,
+            coordinateSystem.linearUnit);
+}
+
+static void snapshot(
+        SnapshotArchive& archive,
+        mem::ScopedCloneablePtr<SFACoordinateSystem>& coordinateSystem)
+{
+    if (!archive.transfer(coordinateSystem.get() != nullptr))
+    {
+        coordinateSystem.reset();
+        return;
+    }
+
+    const std::string type = archive.transfer(
+            coordinateSystem.get() ? coordinateSystem->getType()
+                                   : std::string());
+    if (archive.isReading())
+    {
+        if (type == SFAGeocentricCoordinateSystem::TYPE_NAME)
+        {
+            coordinateSystem.reset(new SFAGeocentricCoordinateSystem());
+        }
+        else if (type == SFAGeographicCoordinateSystem::TYPE_NAME)
+        {
+            coordinateSystem.reset(new SFAGeographicCoordinateSystem());
+        }
+        else if (type == SFAProjectedCoordinateSystem::TYPE_NAME)
+        {
+            coordinateSystem.reset(new SFAProjectedCoordinateSystem());
+        }
+        else
+        {
+            throw except::Exception(Ctxt(
+                    "Metadata snapshot has an invalid SFA coordinate "
+                    "system type " + type));
+        }
+    }
+
+    SFACoordinateSystem* const cs = coordinateSystem.get();
+    if (auto geocentric = dynamic_cast<SFAGeocentricCoordinateSystem*>(cs))
+    {
+        archive(geocentric->csName,
+                geocentric->datum,
+                geocentric->primeMeridian,
+                geocentric->linearUnit);
+    }
+    else if (auto geographic =
+                     dynamic_cast<SFAGeographicCoordinateSystem*>(cs))
+    {
+        archive(*geographic);
+    }
+    else if (auto projected =
+                     dynamic_cast<SFAProjectedCoordinateSystem*>(cs))
+    {
+        archive(projected->csName,
+                projected->geographicCoordinateSystem,
+                projected->projection.name,
+                projected->parameter.name,
+                projected->parameter.value,
+                projected->linearUnit);
+    }
+    else
+    {
+        throw except::Exception(Ctxt(
+                "Can't snapshot SFA coordinate system type " + type));
+    }
+}
+
+static void snapshot(SnapshotArchive& archive,
+                     SFAReferenceSystem& referenceSystem)
+{
+    archive(referenceSystem.coordinateSystem, referenceSystem.axisNames);
+}
+
+static void snapshot(SnapshotArchive& archive, Annotation& annotation)
+{
+    archive(annotation.identifier,
+            annotation.spatialReferenceSystem,
+            annotation.objects);
+}
+
+static void snapshot(SnapshotArchive& archive, DerivedData& data)
+{
+    std::string version = data.getVersion();
+    archive(version);
+    data.setVersion(version);
+
+    archive(data.productCreation,
+            data.display,
+            data.geographicAndTarget,
+            data.geoData,
+            data.measurement,
+            data.exploitationFeatures,
+            data.productProcessing,
+            data.downstreamReprocessing,
+            data.errorStatistics,
+            data.radiometric,
+            data.matchInformation,
+            data.compression,
+            data.digitalElevationData,
+            data.annotations,
+            data.nitfLUT);
+}
+
+void serializeSnapshot(const DerivedData& data,
+                       std::vector<std::byte>& buffer)
+{
+    SnapshotArchive archive(SNAPSHOT_IDENTIFIER, buffer);
+
+    // Writing only reads the fields
+    archive(const_cast<DerivedData&>(data));
+}
+
+std::unique_ptr<DerivedData>
+deserializeSnapshot(std::span<const std::byte> buffer)
+{
+    SnapshotArchive archive(SNAPSHOT_IDENTIFIER, buffer);
+    auto data = std::make_unique<DerivedData>();
+    archive(*data);
+    archive.finish();
+    return data;
+}
+}
+}
@@ -0,0 +1,617 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/sidd/ReducedResolution.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <except/Exception.h>
+#include <io/FileOutputStream.h>
+#include <nitf/NITFBufferList.hpp>
+#include <sys/Conf.h>
+#include <sys/OS.h>
+#include <sys/Path.h>
+#include <six/sidd/SIDDByteProvider.h>
+
+namespace
+{
+types::RowCol<size_t> halve(const types::RowCol<size_t>& dims)
+{
+    return types::RowCol<size_t>((dims.row + 1) / 2, (dims.col + 1) / 2);
+}
+
+types::RowCol<size_t> levelDims(types::RowCol<size_t> dims, size_t level)
+{
+    for (size_t ii = 0; ii < level; ++ii)
+    {
+        dims = halve(dims);
+    }
+    return dims;
+}
+
+// A level's pixel i covers full resolution pixels [f * i, f * i + f - 1].
+// Decimation keeps the first of them; the others are centered.
+double levelOffset(double factor, six::sidd::DownsamplingMethod method)
+{
+    return method == six::sidd::DownsamplingMethod::DECIMATE ?
+            0.0 : (factor - 1.0) / 2.0;
+}
+
+// P'(x, y) = P(factor * x + offset, factor * y + offset)
+six::Poly2D scaleInput(const six::Poly2D& poly, double factor, double offset)
+{
+    if (poly.empty())
+    {
+        return poly;
+    }
+
+    const six::Poly2D x(1, 0, std::vector<double>{ offset, factor });
+    const six::Poly2D y(0, 1, std::vector<double>{ offset, factor });
+    six::Poly2D result(0, 0);
+    six::Poly2D xPower(0, 0, std::vector<double>{ 1.0 });
+    for (size_t ii = 0; ii <= poly.orderX(); ++ii)
+    {
+        six::Poly2D term = xPower;
+        for (size_t jj = 0; jj <= poly.orderY(); ++jj)
+        {
+            result += term * poly[ii][jj];
+            term *= y;
+        }
+        xPower *= x;
+    }
+    return result;
+}
+
+// P'(x, y) = (P(x, y) - offset) / factor
+six::Poly2D scaleOutput(const six::Poly2D& poly, double factor, double offset)
+{
+    if (poly.empty())
+    {
+        return poly;
+    }
+
+    six::Poly2D result = poly;
+    result[0][0] -= offset;
+    return result / factor;
+}
+}
+
+namespace six
+{
+namespace sidd
+{
+RRDSBuilder::RRDSBuilder(const types::RowCol<size_t>& fullDims,
+                         PixelType pixelType,
+                         const RRDSRowHandler& handler,
+                         const RRDSOptions& options) :
+    mFullDims(fullDims),
+    mOptions(options),
+    mHandler(handler),
+    mSamplesPerPixel(1),
+    mBytesPerSample(1)
+{
+    switch (pixelType)
+    {
+    case PixelType::MONO8I:
+        break;
+    case PixelType::MONO16I:
+        mBytesPerSample = 2;
+        break;
+    case PixelType::RGB24I:
+        mSamplesPerPixel = 3;
+        break;
+    case PixelType::MONO8LU:
+    case PixelType::RGB8LU:
+        // Combining LUT indices is meaningless
+        if (mOptions.method != DownsamplingMethod::DECIMATE)
+        {
+            throw except::Exception(Ctxt(
+                    "LUT pixel types can only be decimated"));
+        }
+        break;
+    default:
+        throw except::Exception(Ctxt(
+                "Unsupported pixel type " + pixelType.toString()));
+    }
+
+    if (mOptions.method != DownsamplingMethod::DECIMATE &&
+        mOptions.method != DownsamplingMethod::MAX_PIXEL &&
+        mOptions.method != DownsamplingMethod::AVERAGE)
+    {
+        throw except::Exception(Ctxt(
+                "Unsupported down-sampling method " +
+                mOptions.method.toString()));
+    }
+
+    types::RowCol<size_t> dims = mFullDims;
+    while ((mOptions.maxLevels == 0 ||
+            mLevels.size() < mOptions.maxLevels) &&
+           std::max(dims.row, dims.col) > std::max<size_t>(
+                   mOptions.minDimension, 1))
+    {
+        dims = halve(dims);
+
+        Level level;
+        level.dims = dims;
+        level.accumulator.resize(dims.col * mSamplesPerPixel);
+        level.row.resize(dims.col * mSamplesPerPixel * mBytesPerSample);
+        mLevels.push_back(std::move(level));
+    }
+}
+
+types::RowCol<size_t> RRDSBuilder::getDims(size_t level) const
+{
+    return level == 0 ? mFullDims : getLevel(level).dims;
+}
+
+size_t RRDSBuilder::getBufferSize() const
+{
+    size_t size = 0;
+    for (const Level& level : mLevels)
+    {
+        size += level.accumulator.capacity() * sizeof(uint32_t) +
+                level.row.capacity();
+    }
+    return size;
+}
+
+const RRDSBuilder::Level& RRDSBuilder::getLevel(size_t level) const
+{
+    if (level == 0 || level > mLevels.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Level " << level << " is not in [1, " << mLevels.size()
+             << "]";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    return mLevels[level - 1];
+}
+
+void RRDSBuilder::addRows(const std::byte* rows, size_t numRows)
+{
+    if (mRowsAdded + numRows > mFullDims.row)
+    {
+        throw except::Exception(Ctxt("More rows added than the image has"));
+    }
+
+    const size_t rowBytes = mFullDims.col * mSamplesPerPixel *
+            mBytesPerSample;
+    for (size_t ii = 0; ii < numRows; ++ii, ++mRowsAdded)
+    {
+        if (!mLevels.empty())
+        {
+            addRow(1, rows + ii * rowBytes);
+        }
+    }
+
+    // An odd row count leaves a half-filled row in each level.  Emitting
+    // it feeds the next level, so this has to go from the top down.
+    if (isComplete())
+    {
+        for (size_t level = 1; level <= mLevels.size(); ++level)
+        {
+            if (mLevels[level - 1].pendingRows > 0)
+            {
+                emitRow(level);
+            }
+        }
+    }
+}
+
+void RRDSBuilder::addRow(size_t level, const std::byte* row)
+{
+    Level& out = mLevels[level - 1];
+    const size_t inCols = getDims(level - 1).col;
+    const bool first = out.pendingRows == 0;
+    uint32_t* const accumulator = out.accumulator.data();
+
+    for (size_t col = 0; col < out.dims.col; ++col)
+    {
+        const size_t inCol0 = 2 * col;
+        const size_t inCol1 = std::min(inCol0 + 1, inCols - 1);
+        for (size_t sample = 0; sample < mSamplesPerPixel; ++sample)
+        {
+            uint32_t values[2];
+            const size_t inCol[2] = { inCol0, inCol1 };
+            for (size_t ii = 0; ii < 2; ++ii)
+            {
+                const std::byte* const in = row +
+                        (inCol[ii] * mSamplesPerPixel + sample) *
+                        mBytesPerSample;
+                if (mBytesPerSample == 1)
+                {
+                    values[ii] = static_cast<uint8_t>(*in);
+                }
+                else
+                {
+                    uint16_t value;
+                    memcpy(&value, in, sizeof(value));
+                    values[ii] = value;
+                }
+            }
+
+            uint32_t& total = accumulator[col * mSamplesPerPixel + sample];
+            switch (mOptions.method)
+            {
+            case DownsamplingMethod::MAX_PIXEL:
+                total = std::max(first ? 0 : total,
+                                 std::max(values[0], values[1]));
+                break;
+            case DownsamplingMethod::AVERAGE:
+                total = (first ? 0 : total) + values[0] +
+                        (inCol1 != inCol0 ? values[1] : 0);
+                break;
+            default:
+                if (first)
+                {
+                    total = values[0];
+                }
+                break;
+            }
+        }
+    }
+
+    if (++out.pendingRows == 2)
+    {
+        emitRow(level);
+    }
+}
+
+void RRDSBuilder::emitRow(size_t level)
+{
+    Level& out = mLevels[level - 1];
+    const size_t inCols = getDims(level - 1).col;
+    std::byte* const row = out.row.data();
+
+    for (size_t col = 0; col < out.dims.col; ++col)
+    {
+        const uint32_t numCols = 2 * col + 1 < inCols ? 2 : 1;
+        const uint32_t count =
+                static_cast<uint32_t>(out.pendingRows) * numCols;
+        for (size_t sample = 0; sample < mSamplesPerPixel; ++sample)
+        {
+            const size_t index = col * mSamplesPerPixel + sample;
+            uint32_t value = out.accumulator[index];
+            if (mOptions.method == DownsamplingMethod::AVERAGE)
+            {
+                value = (value + count / 2) / count;
+            }
+
+            if (mBytesPerSample == 1)
+            {
+                row[index] = static_cast<std::byte>(value);
+            }
+            else
+            {
+                const uint16_t value16 = static_cast<uint16_t>(value);
+                memcpy(row + 2 * index, &value16, sizeof(value16));
+            }
+        }
+    }
+
+    out.pendingRows = 0;
+    if (mHandler)
+    {
+        mHandler(level, out.numRows, row);
+    }
+    ++out.numRows;
+
+    // The row is only overwritten once two more rows come in, so the next
+    // level can read it in place
+    if (level < mLevels.size())
+    {
+        addRow(level + 1, row);
+    }
+}
+
+std::string getRRDSPathname(const std::string& pathname, size_t level)
+{
+    // Only look for the extension in the filename, not the directories
+    const std::string extension =
+            sys::Path::splitExt(sys::Path::basename(pathname)).second;
+    return pathname.substr(0, pathname.size() - extension.size()) + ".r" +
+            std::to_string(level);
+}
+
+void setDownsamplingMethod(DerivedData& data, DownsamplingMethod method)
+{
+    if (data.display.get() == nullptr)
+    {
+        return;
+    }
+    for (auto& processing : data.display->nonInteractiveProcessing)
+    {
+        if (processing.get())
+        {
+            processing->rrds.downsamplingMethod = method;
+        }
+    }
+}
+
+void scaleToRRDSLevel(DerivedData& data, size_t level,
+                      DownsamplingMethod method)
+{
+    const double factor = std::ldexp(1.0, static_cast<int>(level));
+    const double offset = levelOffset(factor, method);
+
+    const types::RowCol<size_t> dims = levelDims(
+            types::RowCol<size_t>(data.getNumRows(), data.getNumCols()),
+            level);
+    data.setNumRows(dims.row);
+    data.setNumCols(dims.col);
+
+    for (RowColInt& vertex : data.measurement->validData)
+    {
+        vertex.row = static_cast<ptrdiff_t>(std::floor(
+                (vertex.row - offset) / factor + 0.5));
+        vertex.col = static_cast<ptrdiff_t>(std::floor(
+                (vertex.col - offset) / factor + 0.5));
+    }
+
+    Projection* const projection = data.measurement->projection.get();
+    if (projection == nullptr)
+    {
+        return;
+    }
+    RowColDouble& refPoint = projection->referencePoint.rowCol;
+    refPoint.row = (refPoint.row - offset) / factor;
+    refPoint.col = (refPoint.col - offset) / factor;
+
+    // The time COA polynomial is in meters from the reference point, so
+    // only the spacing changes
+    if (projection->isMeasurable())
+    {
+        auto measurable = static_cast<MeasurableProjection*>(projection);
+        measurable->sampleSpacing.row *= factor;
+        measurable->sampleSpacing.col *= factor;
+    }
+    else if (projection->projectionType == ProjectionType::POLYNOMIAL)
+    {
+        auto polynomial = static_cast<PolynomialProjection*>(projection);
+        polynomial->rowColToLat =
+                scaleInput(polynomial->rowColToLat, factor, offset);
+        polynomial->rowColToLon =
+                scaleInput(polynomial->rowColToLon, factor, offset);
+        polynomial->rowColToAlt =
+                scaleInput(polynomial->rowColToAlt, factor, offset);
+        polynomial->latLonToRow =
+                scaleOutput(polynomial->latLonToRow, factor, offset);
+        polynomial->latLonToCol =
+                scaleOutput(polynomial->latLonToCol, factor, offset);
+    }
+}
+
+struct RRDSWriteControl::LevelFile final
+{
+    LevelFile(const DerivedData& data,
+              const std::string& pathname,
+              const std::vector<std::string>& schemaPaths) :
+        provider(data, schemaPaths),
+        numRows(data.getNumRows()),
+        stream(pathname)
+    {
+    }
+
+    const SIDDByteProvider provider;
+    const size_t numRows;
+    io::FileOutputStream stream;
+    nitf::NITFBufferList buffers;
+};
+
+RRDSWriteControl::RRDSWriteControl(const DerivedData& data,
+                                   const std::string& pathname,
+                                   const std::vector<std::string>& schemaPaths,
+                                   const RRDSOptions& options) :
+    mBytesPerPixel(data.getNumBytesPerPixel()),
+    mSwapBytes(data.getPixelType() == PixelType::MONO16I &&
+               !sys::isBigEndianSystem()),
+    mBuilder(types::RowCol<size_t>(data.getNumRows(), data.getNumCols()),
+             data.getPixelType(),
+             [this](size_t level, size_t row, const std::byte* pixels)
+             {
+                 writeRows(level, pixels, row, 1);
+             },
+             options)
+{
+    for (size_t level = 0; level <= mBuilder.getNumLevels(); ++level)
+    {
+        std::unique_ptr<DerivedData> levelData(
+                static_cast<DerivedData*>(data.clone()));
+        setDownsamplingMethod(*levelData, options.method);
+        if (level > 0)
+        {
+            scaleToRRDSLevel(*levelData, level, options.method);
+        }
+        mFiles.emplace_back(new LevelFile(
+                *levelData,
+                level == 0 ? pathname : getRRDSPathname(pathname, level),
+                schemaPaths));
+    }
+}
+
+RRDSWriteControl::~RRDSWriteControl()
+{
+}
+
+void RRDSWriteControl::addRows(const std::byte* rows, size_t numRows)
+{
+    // This checks the row count, so it goes before any writing
+    mBuilder.addRows(rows, numRows);
+    writeRows(0, rows, mRowsAdded, numRows);
+    mRowsAdded += numRows;
+}
+
+void RRDSWriteControl::writeRows(size_t level,
+                                 const std::byte* rows,
+                                 size_t startRow,
+                                 size_t numRows)
+{
+    LevelFile& file = *mFiles[level];
+    const void* data = rows;
+    if (mSwapBytes)
+    {
+        // NITFs are big endian
+        const size_t numPixels = numRows * mBuilder.getDims(level).col;
+        mSwapped.resize(numPixels * mBytesPerPixel);
+        sys::byteSwap(rows, 2, numPixels, mSwapped.data());
+        data = mSwapped.data();
+    }
+
+    nitf::Off fileOffset = 0;
+    file.provider.getBytes(data, startRow, numRows, fileOffset, file.buffers);
+    file.stream.seek(fileOffset, io::Seekable::START);
+    for (const nitf::NITFBuffer& buffer : file.buffers.mBuffers)
+    {
+        file.stream.write(static_cast<const std::byte*>(buffer.mData),
+                          buffer.mNumBytes);
+    }
+
+    if (startRow + numRows == file.numRows)
+    {
+        file.stream.close();
+    }
+}
+
+size_t saveWithRRDS(const DerivedData& data,
+                    const std::byte* image,
+                    const std::string& pathname,
+                    const std::vector<std::string>& schemaPaths,
+                    const RRDSOptions& options)
+{
+    RRDSWriteControl writer(data, pathname, schemaPaths, options);
+
+    // Feed the writer in strips, as a blocked producer would
+    const size_t rowBytes = data.getNumCols() * data.getNumBytesPerPixel();
+    const size_t stripRows = 256;
+    for (size_t row = 0; row < data.getNumRows(); row += stripRows)
+    {
+        writer.addRows(image + row * rowBytes,
+                       std::min(stripRows, data.getNumRows() - row));
+    }
+    return writer.getNumLevels();
+}
+
+RRDSReader::RRDSReader(const std::string& pathname,
+                       const std::vector<std::string>& schemaPaths) :
+    mPathname(pathname),
+    mSchemaPaths(schemaPaths)
+{
+    mReaders.emplace_back(new NITFReadControl());
+    mReaders[0]->load(mPathname, mSchemaPaths);
+    const DerivedData& data = getData(0);
+    mFullDims = types::RowCol<size_t>(data.getNumRows(), data.getNumCols());
+
+    // Levels are numbered from 1 with no gaps
+    const sys::OS os;
+    while (os.exists(getRRDSPathname(mPathname, mReaders.size())))
+    {
+        mReaders.emplace_back();
+    }
+}
+
+types::RowCol<size_t> RRDSReader::getDims(size_t level) const
+{
+    if (level >= mReaders.size())
+    {
+        std::ostringstream ostr;
+        ostr << "Level " << level << " is not in [0, " << mReaders.size()
+             << ")";
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    return levelDims(mFullDims, level);
+}
+
+size_t RRDSReader::selectLevel(double zoom) const
+{
+    if (!(zoom > 0.0))
+    {
+        throw except::Exception(Ctxt("Zoom must be positive"));
+    }
+
+    size_t level = 0;
+    while (level + 1 < mReaders.size() &&
+           std::ldexp(1.0, -static_cast<int>(level + 1)) >= zoom)
+    {
+        ++level;
+    }
+    return level;
+}
+
+size_t RRDSReader::selectLevel(const types::RowCol<size_t>& minDims) const
+{
+    size_t level = 0;
+    while (level + 1 < mReaders.size())
+    {
+        const types::RowCol<size_t> dims = getDims(level + 1);
+        if (dims.row < minDims.row || dims.col < minDims.col)
+        {
+            break;
+        }
+        ++level;
+    }
+    return level;
+}
+
+const DerivedData& RRDSReader::getData(size_t level)
+{
+    const Data* const data = getReader(level).getContainer()->getData(0);
+    const DerivedData* const derived = dynamic_cast<const DerivedData*>(data);
+    if (derived == nullptr)
+    {
+        throw except::Exception(Ctxt(
+                (level == 0 ? mPathname : getRRDSPathname(mPathname, level)) +
+                " is not a SIDD"));
+    }
+    return *derived;
+}
+
+UByte* RRDSReader::read(size_t level, Region& region)
+{
+    return getReader(level).interleaved(region, 0);
+}
+
+NITFReadControl& RRDSReader::getReader(size_t level)
+{
+    getDims(level);
+    if (mReaders[level].get() == nullptr)
+    {
+        std::unique_ptr<NITFReadControl> reader(new NITFReadControl());
+        reader->load(getRRDSPathname(mPathname, level), mSchemaPaths);
+        mReaders[level] = std::move(reader);
+
+        const DerivedData& data = getData(level);
+        const types::RowCol<size_t> dims = getDims(level);
+        if (data.getNumRows() != dims.row || data.getNumCols() != dims.col)
+        {
+            mReaders[level].reset();
+            throw except::Exception(Ctxt(
+                    getRRDSPathname(mPathname, level) +
+                    " is the wrong size for its level"));
+        }
+    }
+    return *mReaders[level];
+}
+}
+}
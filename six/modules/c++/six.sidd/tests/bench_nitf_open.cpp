@@ -0,0 +1,141 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Times NITFReadControl::load() on SIDD files with and without
+// NITFReadControl::OPT_METADATA_ONLY, and checks that both find the
+// same products.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <std/filesystem>
+
+#include <import/cli.h>
+#include <import/six.h>
+#include <import/six/sidd.h>
+#include <sys/StopWatch.h>
+
+namespace
+{
+std::vector<std::string> getNames(const six::Container& container)
+{
+    std::vector<std::string> names;
+    for (size_t ii = 0; ii < container.size(); ++ii)
+    {
+        names.push_back(container.getData(ii)->getName());
+    }
+    return names;
+}
+
+double timeLoad(const std::string& pathname,
+                const std::vector<std::string>& schemaPaths,
+                bool metadataOnly,
+                size_t numIterations,
+                std::vector<std::string>& names)
+{
+    sys::RealTimeStopWatch sw;
+    sw.start();
+    for (size_t ii = 0; ii < numIterations; ++ii)
+    {
+        six::NITFReadControl reader;
+        reader.getOptions().setParameter(
+                six::NITFReadControl::OPT_METADATA_ONLY,
+                six::Parameter(metadataOnly ? 1 : 0));
+        if (metadataOnly)
+        {
+            // Cataloging doesn't validate
+            reader.load(std::filesystem::path(pathname), nullptr /*pSchemaPaths*/);
+        }
+        else
+        {
+            reader.load(pathname, schemaPaths);
+        }
+        if (ii == 0)
+        {
+            names = getNames(*reader.getContainer());
+        }
+    }
+    return sw.stop() / numIterations;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Benchmark a full vs. metadata-only open of SIDD NITFs");
+        parser.addArgument("-i --iterations", "Number of times to open each file",
+                           cli::STORE, "iterations", "NUM")->
+                setDefault(10);
+        parser.addArgument("--schema", "Schema path, to validate on full opens",
+                           cli::STORE, "schema", "PATH");
+        parser.addArgument("input", "Input SIDD NITFs", cli::STORE, "input",
+                           "FILE", 1, -1);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+        const size_t numIterations = options->get<size_t>("iterations");
+        std::vector<std::string> schemaPaths;
+        if (options->hasValue("schema"))
+        {
+            schemaPaths.push_back(options->get<std::string>("schema"));
+        }
+
+        six::XMLControlFactory::getInstance().addCreator<six::sidd::DerivedXMLControl>();
+
+        bool same = true;
+        const cli::Value* const inputs = options->getValue("input");
+        for (size_t ii = 0; ii < inputs->size(); ++ii)
+        {
+            const std::string pathname = inputs->get<std::string>(ii);
+
+            std::vector<std::string> fullNames;
+            std::vector<std::string> metadataNames;
+            const double fullTime = timeLoad(pathname, schemaPaths, false,
+                                             numIterations, fullNames);
+            const double metadataTime = timeLoad(pathname, schemaPaths, true,
+                                                 numIterations, metadataNames);
+
+            std::cout << pathname << "\n"
+                      << "    Full open: " << fullTime << " ms\n"
+                      << "    Metadata-only open: " << metadataTime
+                      << " ms\n";
+
+            if (fullNames != metadataNames)
+            {
+                std::cerr << pathname << ": metadata-only open found "
+                          << "different products\n";
+                same = false;
+            }
+        }
+        return same ? 0 : 1;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
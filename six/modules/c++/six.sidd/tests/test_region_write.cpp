@@ -0,0 +1,438 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Test program for RegionWriteControl
+// Demonstrates that writing SIDDs a tile at a time, in any order, results in
+// the same files as the normal writes via NITFWriteControl
+
+#include <string.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <io/ReadUtils.h>
+#include <sys/OS.h>
+
+#include <six/NITFWriteControl.h>
+#include <six/RegionWriteControl.h>
+#include <six/sidd/DerivedXMLControl.h>
+#include <six/sidd/Utilities.h>
+
+namespace
+{
+// Makes sure a file gets removed
+class EnsureFileCleanup
+{
+public:
+    EnsureFileCleanup(const std::string& pathname) :
+        mPathname(pathname)
+    {
+        removeIfExists();
+    }
+
+    ~EnsureFileCleanup()
+    {
+        try
+        {
+            removeIfExists();
+        }
+        catch (...)
+        {
+        }
+    }
+
+private:
+    void removeIfExists()
+    {
+        sys::OS os;
+        if (os.exists(mPathname))
+        {
+            os.remove(mPathname);
+        }
+    }
+
+private:
+    const std::string mPathname;
+};
+
+struct Tile
+{
+    size_t imageNumber;
+    types::RowCol<size_t> offset;
+    types::RowCol<size_t> dims;
+};
+
+// Two MONO16I products of different sizes
+class Tester
+{
+public:
+    Tester(size_t numRowsPerBlock,
+           size_t numColsPerBlock,
+           size_t maxProductSize) :
+        mNormalPathname("normal_write.nitf"),
+        mNormalFileCleanup(mNormalPathname),
+        mTestPathname("region_write.nitf"),
+        mContainer(new six::Container(six::DataType::DERIVED)),
+        mNumRowsPerBlock(numRowsPerBlock),
+        mNumColsPerBlock(numColsPerBlock),
+        mMaxProductSize(maxProductSize),
+        mSuccess(true)
+    {
+        mXMLRegistry.addCreator<six::sidd::DerivedXMLControl>();
+
+        const types::RowCol<size_t> dims[] = {
+                types::RowCol<size_t>(123, 456),
+                types::RowCol<size_t>(57, 89) };
+        for (size_t ii = 0; ii < 2; ++ii)
+        {
+            std::unique_ptr<six::sidd::DerivedData> data =
+                    six::sidd::Utilities::createFakeDerivedData();
+            setExtent(*data, dims[ii]);
+            data->setPixelType(six::PixelType::MONO16I);
+            mContainer->addData(std::move(data));
+
+            mDims.push_back(dims[ii]);
+            mImages.push_back(std::vector<uint16_t>(dims[ii].area()));
+            for (size_t jj = 0; jj < mImages[ii].size(); ++jj)
+            {
+                mImages[ii][jj] = static_cast<uint16_t>(jj * 7919 + ii);
+            }
+        }
+
+        normalWrite();
+    }
+
+    bool success() const
+    {
+        return mSuccess;
+    }
+
+    // Every product in one save()
+    void testSingleWrite()
+    {
+        std::vector<Tile> tiles;
+        for (size_t ii = 0; ii < mDims.size(); ++ii)
+        {
+            tiles.push_back(Tile{ii, types::RowCol<size_t>(0, 0), mDims[ii]});
+        }
+        regionWrite("Single write", tiles);
+    }
+
+    // Odd sized tiles of both products, shuffled together
+    void testShuffledTiles(unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::vector<Tile> tiles;
+        for (size_t ii = 0; ii < mDims.size(); ++ii)
+        {
+            for (size_t row = 0, numRows; row < mDims[ii].row; row += numRows)
+            {
+                numRows = std::min<size_t>(1 + generator() % 20,
+                                           mDims[ii].row - row);
+                for (size_t col = 0, numCols; col < mDims[ii].col;
+                     col += numCols)
+                {
+                    numCols = std::min<size_t>(1 + generator() % 50,
+                                               mDims[ii].col - col);
+                    tiles.push_back(Tile{ii,
+                                         types::RowCol<size_t>(row, col),
+                                         types::RowCol<size_t>(numRows,
+                                                               numCols)});
+                }
+            }
+        }
+        std::shuffle(tiles.begin(), tiles.end(), generator);
+        regionWrite("Shuffled tiles", tiles);
+    }
+
+    // Overlapping tiles whose pixels add up to a whole block row
+    void testOverlap()
+    {
+        // Only held block rows are checked
+        if (mNumColsPerBlock == 0)
+        {
+            return;
+        }
+
+        const EnsureFileCleanup ensureFileCleanup(mTestPathname);
+
+        six::Options options;
+        setWriterOptions(options);
+        six::RegionWriteControl writer(mTestPathname, mSchemaPaths);
+        writer.setXMLControlRegistry(&mXMLRegistry);
+        writer.initialize(options, mContainer);
+
+        const size_t numCols = mDims[0].col;
+        const std::vector<uint16_t> tileData(mNumRowsPerBlock * numCols);
+        writer.save(tileData.data(), types::RowCol<size_t>(0, 0),
+                    types::RowCol<size_t>(mNumRowsPerBlock, 20));
+        try
+        {
+            writer.save(tileData.data(), types::RowCol<size_t>(0, 10),
+                        types::RowCol<size_t>(mNumRowsPerBlock,
+                                              numCols - 20));
+            std::cerr << "Overlap" << getSuffix() << " wasn't caught"
+                      << std::endl;
+            mSuccess = false;
+        }
+        catch (const except::Exception&)
+        {
+            std::cout << "Overlap" << getSuffix() << " caught" << std::endl;
+        }
+    }
+
+    // Saving into a block row that was already written out
+    void testSaveToWrittenBlockRow()
+    {
+        // Only held block rows are checked
+        if (mNumColsPerBlock == 0)
+        {
+            return;
+        }
+
+        const EnsureFileCleanup ensureFileCleanup(mTestPathname);
+
+        six::Options options;
+        setWriterOptions(options);
+        six::RegionWriteControl writer(mTestPathname, mSchemaPaths);
+        writer.setXMLControlRegistry(&mXMLRegistry);
+        writer.initialize(options, mContainer);
+
+        const size_t numCols = mDims[0].col;
+        const std::vector<uint16_t> tileData(mNumRowsPerBlock * numCols);
+        writer.save(tileData.data(), types::RowCol<size_t>(0, 0),
+                    types::RowCol<size_t>(mNumRowsPerBlock, numCols));
+        try
+        {
+            writer.save(tileData.data(), types::RowCol<size_t>(1, 0),
+                        types::RowCol<size_t>(1, 10));
+            std::cerr << "Save to written block row" << getSuffix()
+                      << " wasn't caught" << std::endl;
+            mSuccess = false;
+        }
+        catch (const except::Exception&)
+        {
+            std::cout << "Save to written block row" << getSuffix()
+                      << " caught" << std::endl;
+        }
+
+        if (writer.getNumPendingBlockRows() != 0)
+        {
+            std::cerr << "Save to written block row" << getSuffix()
+                      << " left block rows pending" << std::endl;
+            mSuccess = false;
+        }
+    }
+
+private:
+    void setWriterOptions(six::Options& options) const
+    {
+        if (mMaxProductSize != 0)
+        {
+            options.setParameter(
+                    six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                    mMaxProductSize);
+        }
+        if (mNumRowsPerBlock != 0)
+        {
+            options.setParameter(
+                    six::NITFHeaderCreator::OPT_NUM_ROWS_PER_BLOCK,
+                    mNumRowsPerBlock);
+        }
+        if (mNumColsPerBlock != 0)
+        {
+            options.setParameter(
+                    six::NITFHeaderCreator::OPT_NUM_COLS_PER_BLOCK,
+                    mNumColsPerBlock);
+        }
+    }
+
+    void normalWrite()
+    {
+        six::Options options;
+        setWriterOptions(options);
+        six::NITFWriteControl writer(options, mContainer, &mXMLRegistry);
+
+        six::BufferList images;
+        for (const auto& image : mImages)
+        {
+            const void* pImage = image.data();
+            images.push_back(static_cast<const six::UByte*>(pImage));
+        }
+        writer.save(images, mNormalPathname, mSchemaPaths);
+
+        io::readFileContents(mNormalPathname, mNormalFile);
+    }
+
+    void regionWrite(const std::string& prefix, const std::vector<Tile>& tiles)
+    {
+        const EnsureFileCleanup ensureFileCleanup(mTestPathname);
+
+        six::Options options;
+        setWriterOptions(options);
+        six::RegionWriteControl writer(mTestPathname, mSchemaPaths);
+        writer.setXMLControlRegistry(&mXMLRegistry);
+        writer.initialize(options, mContainer);
+
+        std::vector<uint16_t> tileData;
+        for (const auto& tile : tiles)
+        {
+            const std::vector<uint16_t>& image = mImages[tile.imageNumber];
+            const size_t numCols = mDims[tile.imageNumber].col;
+            tileData.resize(tile.dims.area());
+            for (size_t row = 0; row < tile.dims.row; ++row)
+            {
+                memcpy(&tileData[row * tile.dims.col],
+                       &image[(tile.offset.row + row) * numCols +
+                              tile.offset.col],
+                       tile.dims.col * sizeof(uint16_t));
+            }
+            writer.save(tileData.data(), tile.offset, tile.dims,
+                        tile.imageNumber);
+        }
+
+        if (writer.getNumPendingBlockRows() != 0)
+        {
+            std::cerr << prefix << getSuffix()
+                      << " left block rows pending" << std::endl;
+            mSuccess = false;
+        }
+        writer.close();
+
+        compare(prefix);
+    }
+
+    std::string getSuffix() const
+    {
+        return " (rows/block=" + std::to_string(mNumRowsPerBlock) +
+                ", cols/block=" + std::to_string(mNumColsPerBlock) +
+                ", max product size=" + std::to_string(mMaxProductSize) + ")";
+    }
+
+    void compare(const std::string& prefix)
+    {
+        std::vector<sys::byte> testFile;
+        io::readFileContents(mTestPathname, testFile);
+        if (testFile == mNormalFile)
+        {
+            std::cout << prefix << getSuffix() << " matches" << std::endl;
+            return;
+        }
+
+        const auto mismatch = std::mismatch(
+                mNormalFile.begin(),
+                mNormalFile.begin() + std::min(mNormalFile.size(),
+                                               testFile.size()),
+                testFile.begin());
+        std::cerr << prefix << getSuffix() << " DOES NOT MATCH at byte "
+                  << (mismatch.first - mNormalFile.begin()) << std::endl;
+        mSuccess = false;
+    }
+
+private:
+    const std::string mNormalPathname;
+    const EnsureFileCleanup mNormalFileCleanup;
+    const std::string mTestPathname;
+    const std::vector<std::string> mSchemaPaths;
+
+    six::XMLControlRegistry mXMLRegistry;
+    std::shared_ptr<six::Container> mContainer;
+    std::vector<types::RowCol<size_t> > mDims;
+    std::vector<std::vector<uint16_t> > mImages;
+    std::vector<sys::byte> mNormalFile;
+
+    const size_t mNumRowsPerBlock;
+    const size_t mNumColsPerBlock;
+    const size_t mMaxProductSize;
+
+    bool mSuccess;
+};
+
+bool doTests(size_t numRowsPerBlock,
+             size_t numColsPerBlock,
+             size_t maxProductSize)
+{
+    Tester tester(numRowsPerBlock, numColsPerBlock, maxProductSize);
+    tester.testSingleWrite();
+    for (unsigned int seed = 1; seed <= 3; ++seed)
+    {
+        tester.testShuffledTiles(seed);
+    }
+    tester.testOverlap();
+    tester.testSaveToWrittenBlockRow();
+    return tester.success();
+}
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+    try
+    {
+        // Unblocked, blocked by rows only, and blocked with pad rows and
+        // columns, each with one and with several segments per product
+        const size_t blocking[][2] = { { 0, 0 }, { 7, 0 }, { 7, 9 } };
+        const size_t maxProductSizes[] = { 0, 30 * 456 * 2 + 2 * 1024 };
+
+        bool success = true;
+        for (const auto& blockDims : blocking)
+        {
+            for (const auto maxProductSize : maxProductSizes)
+            {
+                if (!doTests(blockDims[0], blockDims[1], maxProductSize))
+                {
+                    success = false;
+                }
+            }
+        }
+
+        // With any luck we passed
+        if (success)
+        {
+            std::cout << "All tests pass!\n";
+        }
+        else
+        {
+            std::cerr << "Some tests FAIL!\n";
+        }
+
+        return (success ? 0 : 1);
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "Caught std::exception: " << ex.what() << std::endl;
+        return 1;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << "Caught except::Exception: " << ex.getMessage()
+                  << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Caught unknown exception\n";
+        return 1;
+    }
+}
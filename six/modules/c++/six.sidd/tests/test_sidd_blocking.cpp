@@ -130,13 +130,14 @@ void makeMultiBandSIDD(const std::string& inputPathname,
 
 void roundTripAndBlock(const std::string& installPathname,
         const std::string& inputPathname,
-        const std::string& outputPathname)
+        const std::string& outputPathname,
+        const std::string& extraArgs = "")
 {
     const std::string roundTripProgram =
             getProgramPathname(installPathname, "round_trip_six");
     sys::Exec roundTripCommand(roundTripProgram + " --retainDateTime" +
             " --size 5000 --rowsPerBlock 10 --colsPerBlock 10 " +
-            inputPathname + " " + outputPathname);
+            extraArgs + inputPathname + " " + outputPathname);
     roundTripCommand.run();
 }
 
@@ -191,6 +192,8 @@ int main(int argc, char** argv)
         TempFileWithExtension multiBandMultiImageSidd(".nitf");
         TempFileWithExtension roundTrippedSidd(".nitf");
         TempFileWithExtension roundTrippedMultiBandSidd(".nitf");
+        TempFileWithExtension parallelBlockedSidd(".nitf");
+        TempFileWithExtension parallelBlockedMultiBandSidd(".nitf");
         getMultiImageSIDD(installPathname, multiImageSidd.pathname());
         makeMultiBandSIDD(multiImageSidd.pathname(),
                 multiBandMultiImageSidd.pathname());
@@ -199,11 +202,22 @@ int main(int argc, char** argv)
         roundTripAndBlock(installPathname,
                 multiBandMultiImageSidd.pathname(),
                 roundTrippedMultiBandSidd.pathname());
+        roundTripAndBlock(installPathname,
+                multiImageSidd.pathname(), parallelBlockedSidd.pathname(),
+                "--blockingThreads 3 ");
+        roundTripAndBlock(installPathname,
+                multiBandMultiImageSidd.pathname(),
+                parallelBlockedMultiBandSidd.pathname(),
+                "--blockingThreads 3 ");
 
         if (checkBlocking(multiImageSidd.pathname(),
                 roundTrippedSidd.pathname()) &&
             checkBlocking(multiBandMultiImageSidd.pathname(),
-                roundTrippedMultiBandSidd.pathname()))
+                roundTrippedMultiBandSidd.pathname()) &&
+            checkBlocking(multiImageSidd.pathname(),
+                parallelBlockedSidd.pathname()) &&
+            checkBlocking(multiBandMultiImageSidd.pathname(),
+                parallelBlockedMultiBandSidd.pathname()))
         {
             return 0;
         }
@@ -0,0 +1,320 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include <six/sidd/DisplayProductGenerator.h>
+#include "TestCase.h"
+
+namespace
+{
+// A ramp from 0 up to numRows * numCols - 1, in raster order
+class RampSource final : public six::sidd::DisplayTileSource
+{
+public:
+    explicit RampSource(size_t numCols) : mNumCols(numCols)
+    {
+    }
+
+    void read(size_t startRow, size_t numRows, float* magnitude) override
+    {
+        for (size_t ii = 0; ii < numRows * mNumCols; ++ii)
+        {
+            magnitude[ii] = static_cast<float>(startRow * mNumCols + ii);
+        }
+    }
+
+private:
+    const size_t mNumCols;
+};
+
+class MemorySink final : public six::sidd::DisplayTileSink
+{
+public:
+    MemorySink(size_t numRows, size_t numCols) :
+        pixels(numRows * numCols),
+        timesWritten(numRows),
+        mNumCols(numCols)
+    {
+    }
+
+    void write(size_t startRow, size_t numRows,
+               const uint8_t* tile) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        memcpy(&pixels[startRow * mNumCols], tile, numRows * mNumCols);
+        for (size_t row = startRow; row < startRow + numRows; ++row)
+        {
+            ++timesWritten[row];
+        }
+    }
+
+    std::vector<uint8_t> pixels;
+    std::vector<size_t> timesWritten;
+
+private:
+    const size_t mNumCols;
+    std::mutex mMutex;
+};
+
+uint8_t expectedPixel(float magnitude, double low, double high)
+{
+    const float scale = static_cast<float>(255.0 / (high - low));
+    float value = (magnitude - static_cast<float>(low)) * scale;
+    value = value > 0.0f ? value : 0.0f;
+    value = value < 255.0f ? value : 255.0f;
+    return static_cast<uint8_t>(std::nearbyint(value));
+}
+
+six::sidd::DRAStatistics makeClipPoints(double low, double high)
+{
+    six::sidd::DRAStatistics statistics;
+    statistics.low = low;
+    statistics.high = high;
+    return statistics;
+}
+}
+
+TEST_CASE(testDetect)
+{
+    // Enough for the vector loop and a scalar tail
+    std::vector<std::complex<float> > pixels;
+    for (size_t ii = 0; ii < 23; ++ii)
+    {
+        pixels.push_back(std::complex<float>(
+                static_cast<float>(ii) * 1.5f - 7.0f,
+                static_cast<float>(ii % 5) * -2.25f));
+    }
+
+    std::vector<float> magnitude(pixels.size());
+    six::sidd::DisplayProductGenerator::detect(pixels.data(), pixels.size(),
+                                               magnitude.data());
+    for (size_t ii = 0; ii < pixels.size(); ++ii)
+    {
+        const float re = pixels[ii].real();
+        const float im = pixels[ii].imag();
+        const float expected = std::sqrt(re * re + im * im);
+        TEST_ASSERT_EQ(magnitude[ii], expected);
+    }
+}
+
+TEST_CASE(testRemap)
+{
+    six::sidd::DisplayProductGenerator generator(1, 1);
+    generator.setDRA(makeClipPoints(10.0, 110.0));
+
+    std::vector<float> magnitude;
+    for (size_t ii = 0; ii < 45; ++ii)
+    {
+        magnitude.push_back(static_cast<float>(ii) * 3.1f - 5.0f);
+    }
+    magnitude[7] = std::numeric_limits<float>::quiet_NaN();
+    magnitude[40] = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<uint8_t> pixels(magnitude.size());
+    generator.remap(magnitude.data(), magnitude.size(), pixels.data());
+    for (size_t ii = 0; ii < magnitude.size(); ++ii)
+    {
+        const uint8_t expected = expectedPixel(magnitude[ii], 10.0, 110.0);
+        TEST_ASSERT_EQ(static_cast<int>(pixels[ii]),
+                       static_cast<int>(expected));
+    }
+    TEST_ASSERT_EQ(static_cast<int>(pixels[7]), 0);
+    TEST_ASSERT_EQ(static_cast<int>(pixels[44]), 255);
+}
+
+TEST_CASE(testRemapLUT)
+{
+    six::sidd::DisplayGenerationOptions options;
+    options.remapLUT.reset(new six::LUT(256, 1));
+    for (size_t ii = 0; ii < 256; ++ii)
+    {
+        *(*options.remapLUT)[ii] = static_cast<unsigned char>(255 - ii);
+    }
+
+    six::sidd::DisplayProductGenerator generator(1, 1, options);
+    generator.setDRA(makeClipPoints(0.0, 255.0));
+
+    std::vector<float> magnitude(256);
+    for (size_t ii = 0; ii < magnitude.size(); ++ii)
+    {
+        magnitude[ii] = static_cast<float>(ii);
+    }
+    std::vector<uint8_t> pixels(magnitude.size());
+    generator.remap(magnitude.data(), magnitude.size(), pixels.data());
+    for (size_t ii = 0; ii < pixels.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(static_cast<size_t>(pixels[ii]), 255 - ii);
+    }
+}
+
+TEST_CASE(testComputeDRA)
+{
+    const size_t numRows = 300;
+    const size_t numCols = 100;
+    const double numPixels = static_cast<double>(numRows * numCols);
+
+    six::sidd::DisplayGenerationOptions options;
+    options.pMin = 0.1;
+    options.pMax = 0.9;
+    options.eMinModifier = 0.5;
+    options.eMaxModifier = 0.25;
+    options.tileRows = 32;
+
+    RampSource source(numCols);
+    std::vector<six::sidd::DRAStatistics> results;
+    for (size_t numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+        options.numThreads = numThreads;
+        six::sidd::DisplayProductGenerator generator(numRows, numCols,
+                                                     options);
+        results.push_back(generator.computeDRA(source));
+    }
+
+    const six::sidd::DRAStatistics& stats = results[0];
+    TEST_ASSERT_EQ(stats.numPixels, numRows * numCols);
+    TEST_ASSERT_EQ(stats.minimum, 0.0);
+    TEST_ASSERT_EQ(stats.maximum, numPixels - 1);
+
+    // Within the histogram's resolution
+    TEST_ASSERT_ALMOST_EQ_EPS(stats.eMin, 0.1 * numPixels, 0.01 * stats.eMin);
+    TEST_ASSERT_ALMOST_EQ_EPS(stats.eMax, 0.9 * numPixels, 0.01 * stats.eMax);
+    TEST_ASSERT_ALMOST_EQ_EPS(stats.low, 0.5 * stats.eMin, 1e-9);
+    TEST_ASSERT_ALMOST_EQ_EPS(
+            stats.high,
+            stats.eMax + 0.25 * (stats.maximum - stats.eMax), 1e-9);
+
+    // Merging the threads' histograms changes nothing
+    TEST_ASSERT_EQ(results[1].numPixels, stats.numPixels);
+    TEST_ASSERT_EQ(results[1].eMin, stats.eMin);
+    TEST_ASSERT_EQ(results[1].eMax, stats.eMax);
+    TEST_ASSERT_EQ(results[1].low, stats.low);
+    TEST_ASSERT_EQ(results[1].high, stats.high);
+}
+
+TEST_CASE(testGenerate)
+{
+    const size_t numRows = 123;
+    const size_t numCols = 37;
+
+    six::sidd::DisplayGenerationOptions options;
+    options.numThreads = 3;
+    options.tileRows = 10;
+    six::sidd::DisplayProductGenerator generator(numRows, numCols, options);
+
+    RampSource source(numCols);
+    MemorySink sink(numRows, numCols);
+    generator.generate(source, sink);
+
+    for (size_t row = 0; row < numRows; ++row)
+    {
+        TEST_ASSERT_EQ(sink.timesWritten[row], static_cast<size_t>(1));
+    }
+
+    const six::sidd::DRAStatistics& stats = generator.getStatistics();
+    for (size_t ii = 0; ii < sink.pixels.size(); ++ii)
+    {
+        const uint8_t expected = expectedPixel(static_cast<float>(ii),
+                                               stats.low, stats.high);
+        TEST_ASSERT_EQ(static_cast<int>(sink.pixels[ii]),
+                       static_cast<int>(expected));
+    }
+    TEST_ASSERT_EQ(static_cast<int>(sink.pixels.front()), 0);
+    TEST_ASSERT_EQ(static_cast<int>(sink.pixels.back()), 255);
+}
+
+TEST_CASE(testFillDisplay)
+{
+    six::sidd::DisplayGenerationOptions options;
+    options.pMin = 0.05;
+    options.eMaxModifier = 0.5;
+    six::sidd::DisplayProductGenerator generator(1, 1, options);
+
+    six::sidd::Display display;
+    generator.fillDisplay(display);
+
+    TEST_ASSERT(display.pixelType == six::PixelType::MONO8I);
+    TEST_ASSERT_EQ(display.numBands, static_cast<size_t>(1));
+    TEST_ASSERT(display.remapInformation.get() != nullptr);
+    TEST_ASSERT(display.remapInformation->displayType ==
+                six::DisplayType::MONO);
+
+    TEST_ASSERT_EQ(display.nonInteractiveProcessing.size(),
+                   static_cast<size_t>(1));
+    const auto& processing = *display.nonInteractiveProcessing[0];
+    TEST_ASSERT(processing.rrds.downsamplingMethod ==
+                six::sidd::DownsamplingMethod::DECIMATE);
+    const auto& remap = *processing.productGenerationOptions.dataRemapping;
+    TEST_ASSERT_EQ(remap.lutName, "DRA");
+    TEST_ASSERT_EQ(remap.custom->lutValues.size(), static_cast<size_t>(1));
+    const six::LUT& lut = remap.custom->lutValues[0];
+    TEST_ASSERT_EQ(lut.numEntries, static_cast<size_t>(256));
+    for (size_t ii = 0; ii < lut.numEntries; ++ii)
+    {
+        short value;
+        memcpy(&value, lut[ii], sizeof(value));
+        TEST_ASSERT_EQ(static_cast<size_t>(value), ii);
+    }
+
+    TEST_ASSERT_EQ(display.interactiveProcessing.size(),
+                   static_cast<size_t>(1));
+    const auto& dra = display.interactiveProcessing[0]->dynamicRangeAdjustment;
+    TEST_ASSERT(dra.algorithmType == six::sidd::DRAType::AUTO);
+    TEST_ASSERT_EQ(dra.draParameters->pMin, 0.05);
+    TEST_ASSERT_EQ(dra.draParameters->pMax, 0.98);
+    TEST_ASSERT_EQ(dra.draParameters->eMinModifier, 0.0);
+    TEST_ASSERT_EQ(dra.draParameters->eMaxModifier, 0.5);
+}
+
+TEST_CASE(testInvalidOptions)
+{
+    six::sidd::DisplayGenerationOptions options;
+    options.pMin = 0.9;
+    options.pMax = 0.1;
+    TEST_EXCEPTION(six::sidd::DisplayProductGenerator(1, 1, options));
+
+    options = six::sidd::DisplayGenerationOptions();
+    options.eMaxModifier = 2.0;
+    TEST_EXCEPTION(six::sidd::DisplayProductGenerator(1, 1, options));
+
+    options = six::sidd::DisplayGenerationOptions();
+    options.remapLUT.reset(new six::LUT(256, 2));
+    TEST_EXCEPTION(six::sidd::DisplayProductGenerator(1, 1, options));
+
+    TEST_EXCEPTION(six::sidd::DisplayProductGenerator(0, 1));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testDetect);
+    TEST_CHECK(testRemap);
+    TEST_CHECK(testRemapLUT);
+    TEST_CHECK(testComputeDRA);
+    TEST_CHECK(testGenerate);
+    TEST_CHECK(testFillDisplay);
+    TEST_CHECK(testInvalidOptions);
+)
@@ -0,0 +1,537 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+#include <std/cstddef>
+
+#include <sys/OS.h>
+#include <six/sidd/ReducedResolution.h>
+#include <six/sidd/Utilities.h>
+#include "TestCase.h"
+
+namespace
+{
+// Collects each level's rows, checking that they come in order
+class LevelCollector final
+{
+public:
+    LevelCollector(size_t fullCols, size_t pixelBytes) :
+        mFullCols(fullCols),
+        mPixelBytes(pixelBytes)
+    {
+    }
+
+    six::sidd::RRDSRowHandler handler()
+    {
+        return [this](size_t level, size_t row, const std::byte* pixels)
+        {
+            if (mLevels.size() < level)
+            {
+                mLevels.resize(level);
+            }
+            const size_t rowBytes = getRowBytes(level);
+            std::vector<std::byte>& levelPixels = mLevels[level - 1];
+            if (levelPixels.size() != row * rowBytes)
+            {
+                mInOrder = false;
+            }
+            levelPixels.insert(levelPixels.end(), pixels, pixels + rowBytes);
+        };
+    }
+
+    const std::vector<std::byte>& getPixels(size_t level) const
+    {
+        return mLevels.at(level - 1);
+    }
+
+    size_t getNumRows(size_t level) const
+    {
+        return mLevels.size() < level ? 0 :
+                mLevels[level - 1].size() / getRowBytes(level);
+    }
+
+    bool isInOrder() const
+    {
+        return mInOrder;
+    }
+
+private:
+    size_t getRowBytes(size_t level) const
+    {
+        size_t cols = mFullCols;
+        for (size_t ii = 0; ii < level; ++ii)
+        {
+            cols = (cols + 1) / 2;
+        }
+        return cols * mPixelBytes;
+    }
+
+    const size_t mFullCols;
+    const size_t mPixelBytes;
+    std::vector<std::vector<std::byte> > mLevels;
+    bool mInOrder = true;
+};
+
+// Halve an image the slow way, one output pixel at a time
+std::vector<uint32_t> halve(const std::vector<uint32_t>& in,
+                            const types::RowCol<size_t>& inDims,
+                            size_t numSamples,
+                            six::sidd::DownsamplingMethod method)
+{
+    const types::RowCol<size_t> outDims((inDims.row + 1) / 2,
+                                        (inDims.col + 1) / 2);
+    std::vector<uint32_t> out(outDims.area() * numSamples);
+    for (size_t row = 0; row < outDims.row; ++row)
+    {
+        for (size_t col = 0; col < outDims.col; ++col)
+        {
+            for (size_t sample = 0; sample < numSamples; ++sample)
+            {
+                uint32_t total = 0;
+                uint32_t maximum = 0;
+                uint32_t count = 0;
+                for (size_t r = 2 * row; r < std::min(2 * row + 2, inDims.row);
+                     ++r)
+                {
+                    for (size_t c = 2 * col;
+                         c < std::min(2 * col + 2, inDims.col); ++c)
+                    {
+                        const uint32_t value =
+                                in[(r * inDims.col + c) * numSamples + sample];
+                        total += value;
+                        maximum = std::max(maximum, value);
+                        ++count;
+                    }
+                }
+
+                uint32_t& value =
+                        out[(row * outDims.col + col) * numSamples + sample];
+                if (method == six::sidd::DownsamplingMethod::AVERAGE)
+                {
+                    value = (total + count / 2) / count;
+                }
+                else if (method == six::sidd::DownsamplingMethod::MAX_PIXEL)
+                {
+                    value = maximum;
+                }
+                else
+                {
+                    value = in[(2 * row * inDims.col + 2 * col) * numSamples +
+                               sample];
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// Builds the levels a few rows at a time and checks them against halve()
+bool checkBuilder(const std::string& testName,
+                  six::PixelType pixelType,
+                  six::sidd::DownsamplingMethod method,
+                  const types::RowCol<size_t>& dims)
+{
+    const size_t numSamples = pixelType == six::PixelType::RGB24I ? 3 : 1;
+    const size_t sampleBytes = pixelType == six::PixelType::MONO16I ? 2 : 1;
+    const uint32_t sampleMax = sampleBytes == 2 ? 0xFFFF : 0xFF;
+
+    std::vector<uint32_t> samples(dims.area() * numSamples);
+    std::vector<std::byte> image(samples.size() * sampleBytes);
+    for (size_t ii = 0; ii < samples.size(); ++ii)
+    {
+        samples[ii] = static_cast<uint32_t>((ii * 7919 + ii / 13) % sampleMax);
+        if (sampleBytes == 2)
+        {
+            const uint16_t value = static_cast<uint16_t>(samples[ii]);
+            memcpy(&image[2 * ii], &value, sizeof(value));
+        }
+        else
+        {
+            image[ii] = static_cast<std::byte>(samples[ii]);
+        }
+    }
+
+    six::sidd::RRDSOptions options;
+    options.method = method;
+    options.minDimension = 1;
+    const size_t rowBytes = dims.col * numSamples * sampleBytes;
+    LevelCollector collector(dims.col, numSamples * sampleBytes);
+    six::sidd::RRDSBuilder builder(dims, pixelType, collector.handler(),
+                                   options);
+
+    for (size_t row = 0; row < dims.row; row += 3)
+    {
+        TEST_ASSERT_FALSE(builder.isComplete());
+        builder.addRows(&image[row * rowBytes], std::min<size_t>(3, dims.row - row));
+
+        // Level 1 is never more than a row behind
+        const size_t rowsIn = std::min<size_t>(row + 3, dims.row);
+        TEST_ASSERT_EQ(collector.getNumRows(1),
+                       rowsIn == dims.row ? (rowsIn + 1) / 2 : rowsIn / 2);
+    }
+    TEST_ASSERT_TRUE(builder.isComplete());
+    TEST_ASSERT_TRUE(collector.isInOrder());
+
+    types::RowCol<size_t> levelDims = dims;
+    for (size_t level = 1; level <= builder.getNumLevels(); ++level)
+    {
+        samples = halve(samples, levelDims, numSamples, method);
+        levelDims = builder.getDims(level);
+
+        const std::vector<std::byte>& pixels = collector.getPixels(level);
+        TEST_ASSERT_EQ(pixels.size(), samples.size() * sampleBytes);
+        for (size_t ii = 0; ii < samples.size(); ++ii)
+        {
+            uint32_t value;
+            if (sampleBytes == 2)
+            {
+                uint16_t value16;
+                memcpy(&value16, &pixels[2 * ii], sizeof(value16));
+                value = value16;
+            }
+            else
+            {
+                value = static_cast<uint8_t>(pixels[ii]);
+            }
+            TEST_ASSERT_EQ(value, samples[ii]);
+        }
+    }
+    TEST_ASSERT_EQ(levelDims.row, static_cast<size_t>(1));
+    TEST_ASSERT_EQ(levelDims.col, static_cast<size_t>(1));
+    return true;
+}
+
+class EnsureFileCleanup final
+{
+public:
+    EnsureFileCleanup(const std::string& pathname) :
+        mPathname(pathname)
+    {
+        removeIfExists();
+    }
+
+    ~EnsureFileCleanup()
+    {
+        try
+        {
+            removeIfExists();
+        }
+        catch (...)
+        {
+        }
+    }
+
+private:
+    void removeIfExists()
+    {
+        sys::OS os;
+        if (os.exists(mPathname))
+        {
+            os.remove(mPathname);
+        }
+    }
+
+    const std::string mPathname;
+};
+}
+
+TEST_CASE(testNumLevels)
+{
+    six::sidd::RRDSOptions options;
+    options.minDimension = 1;
+    six::sidd::RRDSBuilder builder(types::RowCol<size_t>(10, 7),
+                                   six::PixelType::MONO8I, nullptr, options);
+    TEST_ASSERT_EQ(builder.getNumLevels(), static_cast<size_t>(4));
+    TEST_ASSERT_EQ(builder.getDims(1).row, static_cast<size_t>(5));
+    TEST_ASSERT_EQ(builder.getDims(1).col, static_cast<size_t>(4));
+    TEST_ASSERT_EQ(builder.getDims(3).row, static_cast<size_t>(2));
+    TEST_ASSERT_EQ(builder.getDims(3).col, static_cast<size_t>(1));
+
+    options.minDimension = 4;
+    six::sidd::RRDSBuilder smaller(types::RowCol<size_t>(10, 7),
+                                   six::PixelType::MONO8I, nullptr, options);
+    TEST_ASSERT_EQ(smaller.getNumLevels(), static_cast<size_t>(2));
+
+    options.maxLevels = 1;
+    six::sidd::RRDSBuilder capped(types::RowCol<size_t>(10, 7),
+                                  six::PixelType::MONO8I, nullptr, options);
+    TEST_ASSERT_EQ(capped.getNumLevels(), static_cast<size_t>(1));
+}
+
+TEST_CASE(testDecimate)
+{
+    TEST_ASSERT_TRUE(checkBuilder(testName, six::PixelType::MONO8I,
+                                  six::sidd::DownsamplingMethod::DECIMATE,
+                                  types::RowCol<size_t>(37, 29)));
+    TEST_ASSERT_TRUE(checkBuilder(testName, six::PixelType::RGB8LU,
+                                  six::sidd::DownsamplingMethod::DECIMATE,
+                                  types::RowCol<size_t>(16, 16)));
+}
+
+TEST_CASE(testAverage)
+{
+    TEST_ASSERT_TRUE(checkBuilder(testName, six::PixelType::MONO8I,
+                                  six::sidd::DownsamplingMethod::AVERAGE,
+                                  types::RowCol<size_t>(37, 29)));
+    TEST_ASSERT_TRUE(checkBuilder(testName, six::PixelType::MONO16I,
+                                  six::sidd::DownsamplingMethod::AVERAGE,
+                                  types::RowCol<size_t>(20, 45)));
+}
+
+TEST_CASE(testMaxPixel)
+{
+    TEST_ASSERT_TRUE(checkBuilder(testName, six::PixelType::RGB24I,
+                                  six::sidd::DownsamplingMethod::MAX_PIXEL,
+                                  types::RowCol<size_t>(33, 18)));
+}
+
+TEST_CASE(testUnsupported)
+{
+    six::sidd::RRDSOptions options;
+    options.method = six::sidd::DownsamplingMethod::AVERAGE;
+    TEST_EXCEPTION(six::sidd::RRDSBuilder(types::RowCol<size_t>(10, 10),
+                                          six::PixelType::MONO8LU, nullptr,
+                                          options));
+
+    options.method = six::sidd::DownsamplingMethod::LAGRANGE;
+    TEST_EXCEPTION(six::sidd::RRDSBuilder(types::RowCol<size_t>(10, 10),
+                                          six::PixelType::MONO8I, nullptr,
+                                          options));
+
+    six::sidd::RRDSBuilder builder(types::RowCol<size_t>(2, 2),
+                                   six::PixelType::MONO8I, nullptr);
+    const std::vector<std::byte> rows(6);
+    TEST_EXCEPTION(builder.addRows(rows.data(), 3));
+}
+
+TEST_CASE(testBufferSize)
+{
+    // Only the width matters: a tall image holds no more than a short one
+    six::sidd::RRDSOptions options;
+    options.method = six::sidd::DownsamplingMethod::AVERAGE;
+    options.minDimension = 1;
+    options.maxLevels = 3;
+
+    const size_t cols = 64;
+    const std::vector<std::byte> rows(cols * 256);
+    size_t levelRows = 0;
+    const auto handler = [&levelRows](size_t, size_t, const std::byte*)
+    {
+        ++levelRows;
+    };
+    six::sidd::RRDSBuilder shortBuilder(types::RowCol<size_t>(16, cols),
+                                        six::PixelType::MONO8I, handler,
+                                        options);
+    six::sidd::RRDSBuilder tallBuilder(types::RowCol<size_t>(16384, cols),
+                                       six::PixelType::MONO8I, handler,
+                                       options);
+    const size_t bufferSize = tallBuilder.getBufferSize();
+    TEST_ASSERT_EQ(bufferSize, shortBuilder.getBufferSize());
+
+    // An accumulator and an output row for each level, 32 + 16 + 8 pixels
+    TEST_ASSERT_EQ(bufferSize, (32 + 16 + 8) * (sizeof(uint32_t) + 1));
+
+    for (size_t row = 0; row < 16384; row += 256)
+    {
+        tallBuilder.addRows(rows.data(), 256);
+        TEST_ASSERT_EQ(tallBuilder.getBufferSize(), bufferSize);
+    }
+    TEST_ASSERT_TRUE(tallBuilder.isComplete());
+    TEST_ASSERT_EQ(levelRows, static_cast<size_t>(8192 + 4096 + 2048));
+}
+
+TEST_CASE(testPathname)
+{
+    TEST_ASSERT_EQ(six::sidd::getRRDSPathname("image.nitf", 1), "image.r1");
+    TEST_ASSERT_EQ(six::sidd::getRRDSPathname("out.v2/image.ntf", 3),
+                   "out.v2/image.r3");
+    TEST_ASSERT_EQ(six::sidd::getRRDSPathname("out.v2/image", 2),
+                   "out.v2/image.r2");
+}
+
+TEST_CASE(testScalePolynomialProjection)
+{
+    std::unique_ptr<six::sidd::DerivedData> data(
+            new six::sidd::DerivedData());
+    data->measurement.reset(
+            new six::sidd::Measurement(six::ProjectionType::POLYNOMIAL));
+    data->setNumRows(100);
+    data->setNumCols(51);
+    data->measurement->projection->referencePoint.rowCol =
+            six::RowColDouble(50.5, 25.5);
+
+    auto projection = static_cast<six::sidd::PolynomialProjection*>(
+            data->measurement->projection.get());
+    projection->rowColToLat = six::Poly2D(1, 1);
+    projection->rowColToLat[0][0] = 10.0;
+    projection->rowColToLat[1][0] = 0.01;
+    projection->rowColToLat[0][1] = -0.02;
+    projection->rowColToLat[1][1] = 0.0001;
+    projection->latLonToRow = six::Poly2D(1, 0);
+    projection->latLonToRow[0][0] = -1000.0;
+    projection->latLonToRow[1][0] = 100.0;
+    const six::Poly2D rowColToLat = projection->rowColToLat;
+    const six::Poly2D latLonToRow = projection->latLonToRow;
+
+    six::sidd::scaleToRRDSLevel(*data, 2,
+                                six::sidd::DownsamplingMethod::AVERAGE);
+    TEST_ASSERT_EQ(data->getNumRows(), static_cast<size_t>(25));
+    TEST_ASSERT_EQ(data->getNumCols(), static_cast<size_t>(13));
+
+    // Level 2 pixel i is centered on full resolution pixel 4 * i + 1.5
+    const six::RowColDouble& refPoint =
+            data->measurement->projection->referencePoint.rowCol;
+    TEST_ASSERT_ALMOST_EQ(refPoint.row, 12.25);
+    TEST_ASSERT_ALMOST_EQ(refPoint.col, 6.0);
+
+    for (double row = 0; row < 25; row += 6)
+    {
+        for (double col = 0; col < 13; col += 4)
+        {
+            TEST_ASSERT_ALMOST_EQ(projection->rowColToLat(row, col),
+                                  rowColToLat(4 * row + 1.5, 4 * col + 1.5));
+        }
+    }
+    TEST_ASSERT_ALMOST_EQ(projection->latLonToRow(12.0, 0.0),
+                          (latLonToRow(12.0, 0.0) - 1.5) / 4);
+}
+
+TEST_CASE(testRoundTrip)
+{
+    const std::string pathname = "test_reduced_resolution.nitf";
+    const types::RowCol<size_t> dims(40, 30);
+
+    std::unique_ptr<six::sidd::DerivedData> data(
+            six::sidd::Utilities::createFakeDerivedData().release());
+    setExtent(*data, dims);
+    data->setPixelType(six::PixelType::MONO8I);
+
+    std::vector<std::byte> image(dims.area());
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<std::byte>(ii % 251);
+    }
+
+    six::sidd::RRDSOptions options;
+    options.method = six::sidd::DownsamplingMethod::MAX_PIXEL;
+    options.minDimension = 8;
+
+    // 20x15, 10x8 and 5x4
+    const EnsureFileCleanup cleanup0(pathname);
+    const EnsureFileCleanup cleanup1(six::sidd::getRRDSPathname(pathname, 1));
+    const EnsureFileCleanup cleanup2(six::sidd::getRRDSPathname(pathname, 2));
+    const EnsureFileCleanup cleanup3(six::sidd::getRRDSPathname(pathname, 3));
+    const size_t numLevels = six::sidd::saveWithRRDS(
+            *data, image.data(), pathname, std::vector<std::string>(),
+            options);
+    TEST_ASSERT_EQ(numLevels, static_cast<size_t>(3));
+
+    six::sidd::RRDSReader reader(pathname);
+    TEST_ASSERT_EQ(reader.getNumLevels(), static_cast<size_t>(4));
+    TEST_ASSERT_EQ(reader.selectLevel(1.0), static_cast<size_t>(0));
+    TEST_ASSERT_EQ(reader.selectLevel(0.3), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(reader.selectLevel(0.01), static_cast<size_t>(3));
+    TEST_ASSERT_EQ(reader.selectLevel(types::RowCol<size_t>(9, 9)),
+                   static_cast<size_t>(1));
+
+    const six::sidd::DerivedData& levelData = reader.getData(2);
+    TEST_ASSERT_EQ(levelData.getNumRows(), static_cast<size_t>(10));
+    TEST_ASSERT_EQ(levelData.getNumCols(), static_cast<size_t>(8));
+
+    LevelCollector collector(dims.col, 1);
+    six::sidd::RRDSBuilder builder(dims, six::PixelType::MONO8I,
+                                   collector.handler(), options);
+    builder.addRows(image.data(), dims.row);
+    const std::vector<std::byte>& expected = collector.getPixels(2);
+
+    six::Region region;
+    std::vector<std::byte> pixels(expected.size());
+    region.setBuffer(pixels.data());
+    reader.read(2, region);
+    TEST_ASSERT(pixels == expected);
+}
+
+TEST_CASE(testRoundTrip16)
+{
+    // 16-bit pixels are swapped to big endian on their way to disk
+    const std::string pathname = "test_reduced_resolution16.nitf";
+    const types::RowCol<size_t> dims(9, 11);
+
+    std::unique_ptr<six::sidd::DerivedData> data(
+            six::sidd::Utilities::createFakeDerivedData().release());
+    setExtent(*data, dims);
+    data->setPixelType(six::PixelType::MONO16I);
+
+    std::vector<uint16_t> image(dims.area());
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<uint16_t>(ii * 257 + 3);
+    }
+    const auto pixels = reinterpret_cast<const std::byte*>(image.data());
+
+    six::sidd::RRDSOptions options;
+    options.method = six::sidd::DownsamplingMethod::AVERAGE;
+    options.maxLevels = 1;
+    options.minDimension = 1;
+
+    const EnsureFileCleanup cleanup0(pathname);
+    const EnsureFileCleanup cleanup1(six::sidd::getRRDSPathname(pathname, 1));
+    TEST_ASSERT_EQ(six::sidd::saveWithRRDS(*data, pixels, pathname,
+                                           std::vector<std::string>(),
+                                           options),
+                   static_cast<size_t>(1));
+
+    LevelCollector collector(dims.col, sizeof(uint16_t));
+    six::sidd::RRDSBuilder builder(dims, six::PixelType::MONO16I,
+                                   collector.handler(), options);
+    builder.addRows(pixels, dims.row);
+
+    six::sidd::RRDSReader reader(pathname);
+    for (size_t level = 0; level < 2; ++level)
+    {
+        const std::vector<std::byte> expected = level == 0 ?
+                std::vector<std::byte>(pixels, pixels + 2 * image.size()) :
+                collector.getPixels(level);
+
+        six::Region region;
+        std::vector<std::byte> read(expected.size());
+        region.setBuffer(read.data());
+        reader.read(level, region);
+        TEST_ASSERT(read == expected);
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testNumLevels);
+    TEST_CHECK(testDecimate);
+    TEST_CHECK(testAverage);
+    TEST_CHECK(testMaxPixel);
+    TEST_CHECK(testUnsupported);
+    TEST_CHECK(testBufferSize);
+    TEST_CHECK(testPathname);
+    TEST_CHECK(testScalePolynomialProjection);
+    TEST_CHECK(testRoundTrip);
+    TEST_CHECK(testRoundTrip16);
+)
@@ -34,6 +34,7 @@
 
 #include <six/Utilities.h>
 #include <import/six/sidd.h>
+#include <six/sidd/MetadataSnapshot.h>
 
 #include "TestCase.h"
 
@@ -174,8 +175,58 @@ TEST_CASE(test_read_sidd300_xml)
     test_read_sidd_xml(testName, "sidd300.xml");
 }
 
+static std::vector<std::byte> toSnapshot(const six::sidd::DerivedData& derivedData)
+{
+    std::vector<std::byte> snapshot;
+    six::sidd::serializeSnapshot(derivedData, snapshot);
+    return snapshot;
+}
+static std::unique_ptr<six::sidd::DerivedData> fromSnapshot(const std::vector<std::byte>& snapshot)
+{
+    return six::sidd::deserializeSnapshot(std::span<const std::byte>(snapshot.data(), snapshot.size()));
+}
+
+static void test_snapshot_round_trip(const std::string& testName, const six::sidd::DerivedData& expected)
+{
+    const auto snapshot = toSnapshot(expected);
+    TEST_ASSERT_EQ(six::MetadataSnapshot::getIdentifier(std::span<const std::byte>(snapshot.data(), snapshot.size())), "DERIVED");
+    const auto pActual = fromSnapshot(snapshot);
+    TEST_ASSERT_EQ(pActual->getVersion(), expected.getVersion());
+
+    // everything that makes it into the XML has to make it through a snapshot
+    const auto expectedXML = six::sidd::Utilities::toXMLString(expected, nullptr /*pSchemaPaths*/);
+    const auto actualXML = six::sidd::Utilities::toXMLString(*pActual, nullptr /*pSchemaPaths*/);
+    TEST_ASSERT(actualXML == expectedXML);
+    TEST_ASSERT(toSnapshot(*pActual) == snapshot);
+    TEST_ASSERT(*pActual == expected);
+
+    // any truncation is caught, as are extra bytes
+    for (const size_t size : { static_cast<size_t>(4), snapshot.size() / 2, snapshot.size() - 1 })
+    {
+        const std::vector<std::byte> truncated(snapshot.begin(), snapshot.begin() + size);
+        TEST_EXCEPTION(fromSnapshot(truncated));
+    }
+    auto extra = snapshot;
+    extra.push_back(std::byte(0));
+    TEST_EXCEPTION(fromSnapshot(extra));
+}
+
+TEST_CASE(test_snapshot_sidd_xml)
+{
+    for (const auto filename : { "sidd200.xml", "sidd300.xml" })
+    {
+        const auto pDerivedData = six::sidd::Utilities::parseDataFromFile(get_sample_xml_path(filename), nullptr /*pSchemaPaths*/);
+        test_snapshot_round_trip(testName, *pDerivedData);
+    }
+    for (const auto version : { "2.0.0", "3.0.0" })
+    {
+        test_snapshot_round_trip(testName, *six::sidd::Utilities::createFakeDerivedData(version));
+    }
+}
+
 TEST_MAIN(
     TEST_CHECK(test_createFakeDerivedData);
     TEST_CHECK(test_read_sidd200_xml);
     TEST_CHECK(test_read_sidd300_xml);
+    TEST_CHECK(test_snapshot_sidd_xml);
     )
@@ -46,6 +46,7 @@
 #include "six/Parameter.h"
 #include "six/Radiometric.h"
 #include "six/Region.h"
+#include "six/RegionWriteControl.h"
 #include "six/ReadControl.h"
 #include "six/ReadControlFactory.h"
 #include "six/Serialize.h"
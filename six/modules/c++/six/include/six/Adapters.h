@@ -175,6 +175,38 @@ public:
 };
 
 
+/*!
+ *  \class BlockedMemoryWriteHandler
+ *  \brief Writes a blocked image segment from memory on a worker pool
+ *
+ *  Worker threads cut the segment into NITF blocks (with
+ *  nitf::ImageBlocker) and byte-swap them, a few megabytes of blocks at a
+ *  time, while the writing thread writes each group of blocks as soon as
+ *  it and every group before it are done.  Blocking and swapping overlap
+ *  the output I/O, and only a couple of groups per worker are held at
+ *  once.
+ *
+ *  The segment is written pixel interleaved, which is what SIDD's "B"
+ *  (single band) and "P" blocking modes store.
+ */
+struct BlockedMemoryWriteHandler final : public nitf::WriteHandler
+{
+    /*!
+     *  \param info The image segment
+     *  \param buffer The whole image, pixel interleaved
+     *  \param data The image's metadata
+     *  \param blockDims Rows and columns per block; 0 for the whole segment
+     *  \param doByteSwap Whether to swap each sample
+     *  \param numThreads Number of blocking threads, at least 1
+     */
+    BlockedMemoryWriteHandler(const NITFSegmentInfo& info,
+                              const std::byte* buffer,
+                              const Data& data,
+                              const types::RowCol<size_t>& blockDims,
+                              bool doByteSwap,
+                              size_t numThreads);
+};
+
 /*!
  *  \class StreamWriteHandler
  *  \brief Derived implementation for nitf::WriteHandler
@@ -203,6 +235,25 @@ struct StreamWriteHandler: public nitf::WriteHandler
                        io::InputStream* is, const Data&, bool doByteSwap);
 };
 
+/*!
+ *  \class ReservedWriteHandler
+ *  \brief Reserves an image segment's data to be written later
+ *
+ *  Nothing is written besides a single zero byte at the end of the
+ *  reserved space, so the rest stays zero (or a hole in the file, where the
+ *  file system supports them).  Once NITRO has written every header, the
+ *  pixels can be written anywhere in the space.
+ */
+struct ReservedWriteHandler final : public nitf::WriteHandler
+{
+    /*!
+     *  \param numBytes Size of the segment's image data
+     *  \param dataStart Set to the file offset of the image data when the
+     *  segment is written.  It must outlive the write.
+     */
+    ReservedWriteHandler(size_t numBytes, nitf::Off& dataStart);
+};
+
 }
 
 #endif
@@ -0,0 +1,159 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_BATCH_VALIDATOR_H__
+#define __SIX_BATCH_VALIDATOR_H__
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <std/filesystem>
+#include <std/string>
+
+#include <logging/Logger.h>
+#include <xml/lite/ValidatorInterface.h>
+
+namespace six
+{
+/*!
+ *  \struct XMLDocumentExtractor
+ *  \brief Pulls the XML documents out of one kind of file
+ */
+struct XMLDocumentExtractor
+{
+    virtual ~XMLDocumentExtractor() = default;
+
+    //! Is the file one that this can extract XML from?
+    virtual bool supports(const std::string& pathname) const = 0;
+
+    /*!
+     *  Extract each XML document in a file, as is.  This is called for
+     *  many files at once, so it must be thread-safe.
+     *
+     *  \param pathname File to extract from
+     *  \param documents The XML documents, UTF-8 encoded (appended)
+     *  \throw if the file can't be read
+     */
+    virtual void extract(const std::string& pathname,
+                         std::vector<coda_oss::u8string>& documents) const = 0;
+};
+
+/*!
+ *  \struct NITFXMLDocumentExtractor
+ *  \brief Extracts each SICD and SIDD DES from a NITF
+ *
+ *  The DES data is read straight from the file; the XML isn't parsed.
+ */
+struct NITFXMLDocumentExtractor : public XMLDocumentExtractor
+{
+    NITFXMLDocumentExtractor();
+
+    bool supports(const std::string& pathname) const override;
+
+    void extract(const std::string& pathname,
+                 std::vector<coda_oss::u8string>& documents) const override;
+};
+
+/*!
+ *  \struct XMLFileDocumentExtractor
+ *  \brief Treats a file that starts with '<' as one XML document
+ */
+struct XMLFileDocumentExtractor : public XMLDocumentExtractor
+{
+    bool supports(const std::string& pathname) const override;
+
+    void extract(const std::string& pathname,
+                 std::vector<coda_oss::u8string>& documents) const override;
+};
+
+/*!
+ *  \struct DocumentValidation
+ *  \brief The outcome of validating one XML document
+ */
+struct DocumentValidation final
+{
+    std::string pathname;
+
+    //! Which document in the file this is
+    size_t document = 0;
+
+    //! Why the file couldn't be validated at all, if it couldn't
+    std::string failure;
+
+    //! What the schema validation found wrong
+    std::vector<xml::lite::ValidationInfo> errors;
+
+    //! Milliseconds to validate the document
+    double validationTime = 0.0;
+
+    bool isValid() const
+    {
+        return failure.empty() && errors.empty();
+    }
+
+    //! The ID used for the document in its errors: "pathname[document]"
+    std::string getID() const;
+};
+
+/*!
+ *  \class BatchValidator
+ *  \brief Validates the XML in many files at once
+ *
+ *  Each file is handed to the first extractor that supports it, and each
+ *  document it finds is validated against the schema for its namespace.
+ *  A fixed number of worker threads each take the next file as they
+ *  finish the last.  The compiled schemas are shared between the threads
+ *  and with XMLControl, through six::SchemaCache, so they're compiled
+ *  once per thread at most.
+ *
+ *  Results are in the same order as the files.  A file that can't be read
+ *  is one result, with its failure set.
+ */
+class BatchValidator
+{
+public:
+    /*!
+     *  \param schemaPaths Schemas and directories to search for schemas
+     *  \param numThreads Number of files to validate at once
+     *  \param log Logger for reporting schemas that fail to load
+     */
+    BatchValidator(const std::vector<std::filesystem::path>& schemaPaths,
+                   size_t numThreads,
+                   logging::Logger* log = nullptr);
+
+    //! Extractors are tried in the order that they're added
+    void addExtractor(std::unique_ptr<XMLDocumentExtractor>&& extractor);
+
+    //! Validate the XML in each file
+    std::vector<DocumentValidation>
+    validate(const std::vector<std::string>& pathnames) const;
+
+private:
+    const std::vector<std::filesystem::path> mSchemaPaths;
+    const size_t mNumThreads;
+    logging::Logger* const mLog;
+    std::vector<std::unique_ptr<XMLDocumentExtractor> > mExtractors;
+};
+}
+
+#endif
@@ -0,0 +1,235 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_METADATA_INDEXER_H__
+#define __SIX_METADATA_INDEXER_H__
+
+#include <stddef.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/InputStream.h>
+#include <io/OutputStream.h>
+
+#include "six/Data.h"
+#include "six/Types.h"
+
+namespace six
+{
+//! Metadata of one product in a file, by field name
+typedef std::map<std::string, std::string> MetadataSummary;
+
+/*!
+ *  \struct MetadataField
+ *  \brief Names of the fields that the standard summarizers fill in
+ */
+struct MetadataField final
+{
+    //! Filled in by the MetadataIndexer
+    static const char PATHNAME[];
+    static const char PRODUCT[];
+    static const char OPEN_TIME[];
+    static const char ERROR_MESSAGE[];
+
+    //! "SICD", "SIDD" or "CPHD"
+    static const char TYPE[];
+    static const char VERSION[];
+
+    //! The SICD core name, SIDD product name or CPHD core name
+    static const char NAME[];
+    static const char COLLECTOR[];
+    static const char COLLECT_START[];
+    static const char CLASSIFICATION[];
+    static const char NUM_ROWS[];
+    static const char NUM_COLS[];
+
+    //! Space-separated "lat lon" of each corner
+    static const char FOOTPRINT[];
+
+    //! Space-separated "tx:rcv" of each polarization
+    static const char POLARIZATION[];
+
+    //! All of the above, in order
+    static std::vector<std::string> getAll();
+};
+
+/*!
+ *  \struct MetadataSummarizer
+ *  \brief Reads just enough of one kind of file to summarize it
+ */
+struct MetadataSummarizer
+{
+    virtual ~MetadataSummarizer() = default;
+
+    //! Is the file one that this can summarize?
+    virtual bool supports(const std::string& pathname) const = 0;
+
+    /*!
+     *  Summarize each product in a file.  This is called for many files
+     *  at once, so it must be thread-safe.
+     *
+     *  \param pathname File to summarize
+     *  \param summaries Summary of each product in the file (appended)
+     *  \throw if the file can't be read
+     */
+    virtual void summarize(const std::string& pathname,
+                           std::vector<MetadataSummary>& summaries) const = 0;
+
+    //! Format corners for MetadataField::FOOTPRINT
+    static std::string toString(const LatLonCorners& corners);
+};
+
+/*!
+ *  \struct NITFMetadataSummarizer
+ *  \brief Summarizes SICD and SIDD NITFs
+ *
+ *  Files are opened with NITFReadControl::OPT_METADATA_ONLY and without
+ *  validating the XML, and each SICD or SIDD DES is a product.  The
+ *  XMLControlFactory must already have the XML controls for the products
+ *  registered.
+ */
+struct NITFMetadataSummarizer : public MetadataSummarizer
+{
+    NITFMetadataSummarizer();
+
+    bool supports(const std::string& pathname) const override;
+
+    void summarize(const std::string& pathname,
+                   std::vector<MetadataSummary>& summaries) const override;
+
+protected:
+    /*!
+     *  Fill in the fields for one product.  By default, this fills in
+     *  all of the MetadataField's that six::Data provides, which is all
+     *  of them but the polarization.  Override this to add more.
+     */
+    virtual void summarize(const Data& data, MetadataSummary& summary) const;
+};
+
+/*!
+ *  \struct MetadataIndex
+ *  \brief A table of metadata, with one row per product
+ *
+ *  The table is stored by column, which is how it's written out: each
+ *  column's values are together, so a reader can skip the columns it
+ *  doesn't want.
+ */
+struct MetadataIndex final
+{
+    //! Column names
+    std::vector<std::string> fields;
+
+    //! values[column][row]
+    std::vector<std::vector<std::string> > values;
+
+    size_t getNumRows() const
+    {
+        return values.empty() ? 0 : values[0].size();
+    }
+
+    //! Get the column for a field, or throw if there isn't one
+    const std::vector<std::string>& getColumn(const std::string& field) const;
+
+    /*!
+     *  Write out in a compact binary format.  After a header, each column
+     *  is its name, the length of each value, then the values themselves.
+     *  Integers are little endian.
+     */
+    void write(io::OutputStream& os) const;
+
+    /*!
+     *  Read what write() wrote
+     *
+     *  \throw if the counts and sizes don't fit in the stream (when it
+     *  knows its size) or don't match the column sizes
+     */
+    static MetadataIndex read(io::InputStream& is);
+};
+
+/*!
+ *  \struct MetadataIndexStatistics
+ *  \brief How long indexing took
+ */
+struct MetadataIndexStatistics final
+{
+    size_t numFiles = 0;
+    size_t numFailed = 0;
+    size_t numProducts = 0;
+
+    //! Milliseconds to summarize each file
+    double minOpenTime = 0.0;
+    double meanOpenTime = 0.0;
+    double maxOpenTime = 0.0;
+
+    //! Milliseconds for the whole index
+    double elapsedTime = 0.0;
+};
+
+/*!
+ *  \class MetadataIndexer
+ *  \brief Summarizes many files at once into a MetadataIndex
+ *
+ *  Each file is handed to the first summarizer that supports it.  Files
+ *  are checked and summarized by a fixed number of worker threads, each
+ *  taking the next file as it finishes the last, so slow files don't hold
+ *  up the rest.  Rows are in the same order as the files, whatever order
+ *  they finish in.
+ *
+ *  Each product is a row.  A file that can't be summarized is one row
+ *  with MetadataField::ERROR_MESSAGE set.  The indexer fills in
+ *  MetadataField::PATHNAME, PRODUCT (the product's index in the file),
+ *  OPEN_TIME (milliseconds to summarize the whole file) and ERROR_MESSAGE
+ *  itself.
+ */
+class MetadataIndexer
+{
+public:
+    /*!
+     *  \param fields The fields to include, in order.  Those that a
+     *  summarizer doesn't provide are empty.
+     *  \param numThreads Number of files to summarize at once
+     */
+    MetadataIndexer(const std::vector<std::string>& fields,
+                    size_t numThreads);
+
+    //! Summarizers are tried in the order that they're added
+    void addSummarizer(std::unique_ptr<MetadataSummarizer>&& summarizer);
+
+    /*!
+     *  Summarize some files
+     *
+     *  \param pathnames Files to summarize
+     *  \param stats If not NULL, filled in with timing statistics
+     */
+    MetadataIndex index(const std::vector<std::string>& pathnames,
+                        MetadataIndexStatistics* stats = nullptr) const;
+
+private:
+    std::vector<std::string> mFields;
+    const size_t mNumThreads;
+    std::vector<std::unique_ptr<MetadataSummarizer> > mSummarizers;
+};
+}
+
+#endif
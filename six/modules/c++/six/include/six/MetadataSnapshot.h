@@ -0,0 +1,481 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_METADATA_SNAPSHOT_H__
+#define __SIX_METADATA_SNAPSHOT_H__
+#pragma once
+
+#include <stdint.h>
+
+#include <complex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <std/cstddef> // std::byte
+#include <std/span>
+
+#include <mem/ScopedPtr.h>
+#include <str/EncodedString.h>
+
+#include "six/CollectionInformation.h"
+#include "six/Enum.h"
+#include "six/ErrorStatistics.h"
+#include "six/GeoDataBase.h"
+#include "six/GeoInfo.h"
+#include "six/MatchInformation.h"
+#include "six/ParameterCollection.h"
+#include "six/Radiometric.h"
+#include "six/Serialize.h"
+#include "six/Types.h"
+
+/*!
+ *  A metadata snapshot is a compact binary form of SICD, SIDD or CPHD
+ *  metadata, for passing it between processes (or storing it next to the
+ *  data) without converting to and from XML each time.
+ *
+ *  The snapshot holds the fields of the data model itself, in declaration
+ *  order: scalars, strings, then a count for each vector and a presence
+ *  flag for each optional member.  Loading one allocates the objects and
+ *  copies the fields in, with no text parsing, schema validation or XML
+ *  conversion.  Each product module declares how its types are
+ *  snapshotted alongside its own types (six/sicd/MetadataSnapshot.h,
+ *  six/sidd/MetadataSnapshot.h and cphd/MetadataSnapshot.h).
+ *
+ *  A snapshot is tied to the format version that wrote it, and is meant
+ *  for moving metadata around, not for archiving it; XML remains the
+ *  interchange format.  Integers are big endian, as with the other
+ *  serialized six data.
+ */
+namespace six
+{
+struct MetadataSnapshot final
+{
+    //! The first bytes of every snapshot
+    static const char MAGIC[];
+
+    //! The format version written, and the only version read
+    static constexpr uint32_t VERSION = 1;
+
+    /*!
+     *  Get the identifier of the metadata in a snapshot: the DataType
+     *  ("COMPLEX" or "DERIVED") for SICD or SIDD, or "CPHD".
+     *
+     *  \throw if 'buffer' isn't a snapshot
+     */
+    static std::string getIdentifier(std::span<const std::byte> buffer);
+};
+
+namespace details
+{
+// std::void_t is C++17
+template <typename...>
+struct MakeVoid
+{
+    typedef void type;
+};
+
+// The polarization enums keep the text of an OTHER* value alongside it
+template <typename T, typename = void>
+struct HasOtherText : std::false_type
+{
+};
+template <typename T>
+struct HasOtherText<T, typename MakeVoid<decltype(T::other_)>::type>
+    : std::true_type
+{
+};
+
+// How SnapshotArchive::value() handles a type without its own overload
+enum class SnapshotKind
+{
+    Boolean,
+    Integer,
+    Real,
+    Enum,
+    SixEnum,
+    Object
+};
+template <typename T>
+struct SnapshotKindOf
+    : std::integral_constant<
+              SnapshotKind,
+              std::is_same<T, bool>::value ? SnapshotKind::Boolean :
+              std::is_integral<T>::value ? SnapshotKind::Integer :
+              std::is_floating_point<T>::value ? SnapshotKind::Real :
+              std::is_enum<T>::value ? SnapshotKind::Enum :
+              std::is_base_of<details::Enum<T>, T>::value ?
+                      SnapshotKind::SixEnum : SnapshotKind::Object>
+{
+};
+}
+
+/*!
+ *  \class SnapshotArchive
+ *  \brief Writes or reads the fields of a metadata snapshot
+ *
+ *  The same calls describe a type's fields in both directions, so writing
+ *  and reading can't drift apart:
+ *
+ *  \code
+ *  void snapshot(SnapshotArchive& archive, Radiometric& radiometric)
+ *  {
+ *      archive(radiometric.noiseLevel, radiometric.rcsSFPoly, ...);
+ *  }
+ *  \endcode
+ *
+ *  Scalars, enums, strings, vectors, optional (mem::ScopedPtr) members and
+ *  the common six math types are handled here.  Any other type is
+ *  described by a snapshot(SnapshotArchive&, T&) function found by
+ *  argument dependent lookup.  Optional members of types without a default
+ *  constructor (usually polymorphic ones) are handed whole to
+ *  snapshot(SnapshotArchive&, mem::ScopedPtr<T, ...>&), which writes
+ *  whatever it needs to recreate them.
+ *
+ *  When writing, the fields are only read, even though they're passed by
+ *  non-const reference.  Reading is into a default constructed object,
+ *  and reuses the optional members it was constructed with.  It checks
+ *  every count and length against the bytes that are left and limits how
+ *  deeply objects nest, so a truncated or corrupt snapshot throws rather
+ *  than overrunning.
+ */
+class SnapshotArchive final
+{
+public:
+    //! Objects nested more deeply than this are an error
+    static constexpr size_t MAX_DEPTH = 64;
+
+    /*!
+     *  Start writing a snapshot
+     *
+     *  \param identifier The kind of metadata that will be written
+     *  \param[out] buffer The snapshot is appended to this
+     */
+    SnapshotArchive(const std::string& identifier,
+                    std::vector<std::byte>& buffer);
+
+    /*!
+     *  Start reading a snapshot
+     *
+     *  \param identifier The kind of metadata expected
+     *  \param buffer The snapshot
+     *  \throw if 'buffer' isn't a snapshot of 'identifier' metadata
+     */
+    SnapshotArchive(const std::string& identifier,
+                    std::span<const std::byte> buffer);
+
+    SnapshotArchive(const SnapshotArchive&) = delete;
+    SnapshotArchive& operator=(const SnapshotArchive&) = delete;
+
+    bool isReading() const
+    {
+        return mBuffer == nullptr;
+    }
+
+    /*!
+     *  Check that the whole snapshot has been read.  Does nothing when
+     *  writing.
+     *
+     *  \throw if there are bytes left over
+     */
+    void finish() const;
+
+    //! Write or read each of 'values', in order
+    template <typename... T>
+    void operator()(T&... values)
+    {
+        const int expand[] = { 0, (value(values), 0)... };
+        (void)expand;
+    }
+
+    /*!
+     *  Write 'v' and return it, or return the value read in its place.
+     *  This is for what isn't a field, such as a presence flag or the
+     *  type of a polymorphic object.
+     */
+    template <typename T>
+    T transfer(T v)
+    {
+        value(v);
+        return v;
+    }
+
+    template <typename T>
+    void value(T& v)
+    {
+        value(v, details::SnapshotKindOf<T>());
+    }
+
+    template <typename T>
+    void value(std::vector<T>& values)
+    {
+        const size_t size = count(values.size());
+        values.resize(size);
+        for (auto& v : values)
+        {
+            value(v);
+        }
+    }
+
+    template <typename T, typename CopyIsClone>
+    void value(mem::ScopedPtr<T, CopyIsClone>& ptr)
+    {
+        optional(ptr, std::is_default_constructible<T>());
+    }
+
+    template <typename T>
+    void value(std::complex<T>& v)
+    {
+        T real = v.real();
+        T imag = v.imag();
+        (*this)(real, imag);
+        v = std::complex<T>(real, imag);
+    }
+
+    template <typename T>
+    void value(types::RowCol<T>& v)
+    {
+        (*this)(v.row, v.col);
+    }
+
+    template <typename T>
+    void value(types::RgAz<T>& v)
+    {
+        (*this)(v.rg, v.az);
+    }
+
+    template <size_t N, typename T>
+    void value(math::linear::VectorN<N, T>& v)
+    {
+        for (size_t ii = 0; ii < N; ++ii)
+        {
+            value(v[ii]);
+        }
+    }
+
+    template <typename T>
+    void value(math::poly::OneD<T>& poly)
+    {
+        std::vector<T> coefs = poly.coeffs();
+        value(coefs);
+        if (isReading())
+        {
+            // OneD(coefs) would make an empty polynomial a zero
+            poly = coefs.empty() ? math::poly::OneD<T>()
+                                 : math::poly::OneD<T>(coefs);
+        }
+    }
+
+    template <typename T>
+    void value(math::poly::TwoD<T>& poly)
+    {
+        value(poly.coeffs());
+    }
+
+    template <typename T>
+    void value(Corners<T>& corners)
+    {
+        (*this)(corners.upperLeft, corners.upperRight,
+                corners.lowerRight, corners.lowerLeft);
+    }
+
+    void value(std::string& v);
+    void value(str::EncodedString& v);
+    void value(std::vector<unsigned char>& bytes);
+    void value(DateTime& v);
+    void value(LatLon& v);
+    void value(LatLonAlt& v);
+    void value(AngleMagnitude& v);
+    void value(FrameType& v);
+
+    /*!
+     *  Write the size of a vector, or read one and check that that many
+     *  elements could fit in the bytes that are left
+     */
+    size_t count(size_t size);
+
+private:
+    class Nested final
+    {
+    public:
+        explicit Nested(SnapshotArchive& archive);
+        ~Nested();
+
+        Nested(const Nested&) = delete;
+        Nested& operator=(const Nested&) = delete;
+
+    private:
+        SnapshotArchive& mArchive;
+    };
+
+    template <details::SnapshotKind Kind>
+    using KindTag = std::integral_constant<details::SnapshotKind, Kind>;
+
+    void value(bool& v, KindTag<details::SnapshotKind::Boolean>)
+    {
+        boolean(v);
+    }
+
+    template <typename T>
+    void value(T& v, KindTag<details::SnapshotKind::Integer>)
+    {
+        integer(v);
+    }
+
+    template <typename T>
+    void value(T& v, KindTag<details::SnapshotKind::Real>)
+    {
+        real(v);
+    }
+
+    template <typename T>
+    void value(T& v, KindTag<details::SnapshotKind::Enum>)
+    {
+        auto underlying = static_cast<int64_t>(v);
+        integer(underlying);
+        v = static_cast<T>(underlying);
+    }
+
+    template <typename T>
+    void value(T& v, KindTag<details::SnapshotKind::SixEnum>)
+    {
+        int underlying = v.value;
+        integer(underlying);
+        if (isReading())
+        {
+            // Enum::cast() would format an error message up front
+            v.value = underlying;
+            if (!v.toString(std::nothrow).has_value())
+            {
+                outOfRange();
+            }
+        }
+        otherText(v, details::HasOtherText<T>());
+    }
+
+    template <typename T>
+    void value(T& v, KindTag<details::SnapshotKind::Object>)
+    {
+        const Nested nested(*this);
+        snapshot(*this, v);
+    }
+
+    template <typename T>
+    void otherText(T& v, std::true_type)
+    {
+        value(v.other_);
+    }
+
+    template <typename T>
+    void otherText(T&, std::false_type)
+    {
+    }
+
+    template <typename T, typename CopyIsClone>
+    void optional(mem::ScopedPtr<T, CopyIsClone>& ptr, std::true_type)
+    {
+        if (!transfer(ptr.get() != nullptr))
+        {
+            ptr.reset();
+            return;
+        }
+        if (!ptr.get())
+        {
+            ptr.reset(new T());
+        }
+        value(*ptr);
+    }
+
+    template <typename T, typename CopyIsClone>
+    void optional(mem::ScopedPtr<T, CopyIsClone>& ptr, std::false_type)
+    {
+        const Nested nested(*this);
+        snapshot(*this, ptr);
+    }
+
+    void boolean(bool& v);
+    void real(double& v);
+    void real(float& v);
+    void require(size_t size) const;
+
+    template <typename T>
+    void integer(T& v)
+    {
+        using Wide = typename std::conditional<std::is_signed<T>::value,
+                                               int64_t, uint64_t>::type;
+        Wide wide = static_cast<Wide>(v);
+        if (isReading())
+        {
+            require(sizeof(wide));
+            deserialize(mCurrent, mSwapBytes, wide);
+            if (static_cast<Wide>(static_cast<T>(wide)) != wide)
+            {
+                outOfRange();
+            }
+            v = static_cast<T>(wide);
+        }
+        else
+        {
+            serialize(wide, mSwapBytes, *mBuffer);
+        }
+    }
+
+    [[noreturn]] static void outOfRange();
+
+    std::vector<std::byte>* const mBuffer = nullptr;
+    const std::byte* mCurrent = nullptr;
+    const std::byte* mEnd = nullptr;
+    const bool mSwapBytes;
+    size_t mDepth = 0;
+};
+
+void snapshot(SnapshotArchive& archive, DecorrType& decorr);
+void snapshot(SnapshotArchive& archive, ReferencePoint& referencePoint);
+void snapshot(SnapshotArchive& archive, SCP& scp);
+void snapshot(SnapshotArchive& archive, Parameter& parameter);
+void snapshot(SnapshotArchive& archive, ParameterCollection& parameters);
+void snapshot(SnapshotArchive& archive,
+              CollectionInformation& collectionInformation);
+void snapshot(SnapshotArchive& archive, GeoInfo& geoInfo);
+void snapshot(SnapshotArchive& archive, GeoDataBase& geoData);
+void snapshot(SnapshotArchive& archive, NoiseLevel& noiseLevel);
+void snapshot(SnapshotArchive& archive, Radiometric& radiometric);
+void snapshot(SnapshotArchive& archive, MatchCollect& matchCollect);
+void snapshot(SnapshotArchive& archive, MatchType& matchType);
+void snapshot(SnapshotArchive& archive, MatchInformation& matchInformation);
+void snapshot(SnapshotArchive& archive, CorrCoefs& corrCoefs);
+void snapshot(SnapshotArchive& archive, PosVelError& posVelError);
+void snapshot(SnapshotArchive& archive, RadarSensor& radarSensor);
+void snapshot(SnapshotArchive& archive, TropoError& tropoError);
+void snapshot(SnapshotArchive& archive, IonoError& ionoError);
+void snapshot(SnapshotArchive& archive, UnmodeledS& unmodeled);
+void snapshot(SnapshotArchive& archive, UnmodeledS::Decorr& decorr);
+void snapshot(SnapshotArchive& archive,
+              UnmodeledS::Decorr::Xrow_Ycol& xrowYcol);
+void snapshot(SnapshotArchive& archive, Components& components);
+void snapshot(SnapshotArchive& archive, CompositeSCP& compositeSCP);
+void snapshot(SnapshotArchive& archive, ErrorStatistics& errorStatistics);
+void snapshot(SnapshotArchive& archive, AmplitudeTable& amplitudeTable);
+void snapshot(SnapshotArchive& archive, mem::ScopedCopyablePtr<LUT>& lut);
+void snapshot(SnapshotArchive& archive, std::vector<LUT>& luts);
+}
+
+#endif
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <std/filesystem>
 
 #include "six/NITFImageInfo.h"
@@ -54,6 +55,19 @@ namespace six
  */
 struct NITFReadControl : public ReadControl
 {
+    /*!
+     *  Set this option to a non-zero value to open files for their
+     *  metadata, e.g. for cataloging.  load() then reads the NITF
+     *  headers and the SICD/SIDD DES, but doesn't parse TREs (they're
+     *  kept as raw bytes) or read any legends.  The XML is validated
+     *  against the schema paths as usual; pass a NULL schema path list to
+     *  skip that too.  Image segments aren't matched up with the Data
+     *  until the first call to interleaved(); until then, the Data has no
+     *  NITF image subheader security options, and a SIDD 2.0 has no LUT
+     *  from the NITF.
+     */
+    static const char OPT_METADATA_ONLY[];
+
     //!  Constructor
     NITFReadControl(FILE* log);
     NITFReadControl();
@@ -258,6 +272,11 @@ private:
     template<typename TSchemaPath>
     void load_(std::shared_ptr<nitf::IOInterface> ioInterface, const std::vector<TSchemaPath>* pSchemaPaths);
 
+    bool isMetadataOnly() const;
+
+    //! Matches up image segments with the Data, for reading pixels
+    void loadImageSegments();
+
     std::unique_ptr<Legend> findLegend(size_t productNum);
 
     void readLegendPixelData(const nitf::ImageSubheader& subheader,
@@ -283,6 +302,10 @@ private:
     // The issue occurs from the explicit destructor of
     // IOControl
     std::shared_ptr<nitf::IOInterface> mInterface;
+
+    //! Guards loading the image segments on the first interleaved()
+    std::mutex mImageSegmentsMutex;
+    bool mImageSegmentsLoaded = false;
 };
 
 
@@ -58,8 +58,6 @@ namespace six
  */
 class NITFWriteControl : public WriteControl
 {
-    void addLegend(const Legend&, int imageNumber);
-
     ptrdiff_t AMP8I_PHS8I_cutoff() const; // for eventual use by to_AMP8I_PHS8I());
 
     template<typename T>
@@ -83,8 +81,19 @@ class NITFWriteControl : public WriteControl
     template<typename T>
     bool prepareIO(const T& imageData, nitf::IOInterface& outputFile);
 
+    bool useParallelBlocking(bool isBlocking, bool enableJ2K) const;
+    size_t getNumBlockingThreads() const;
+
 public:
 
+    /*!
+     *  Block SIDD images on this many worker threads (0 for one per CPU)
+     *  while the blocks already done are written.  Only applies to
+     *  blocked, uncompressed images written from memory; without this
+     *  option, NITRO's ImageWriter blocks them on the calling thread.
+     */
+    static const char OPT_NUM_BLOCKING_THREADS[];
+
     //! Constructor. Must call initialize to use.
     NITFWriteControl(FILE* log = stderr);
     ~NITFWriteControl() noexcept {}
@@ -452,6 +461,9 @@ protected:
      */
     void addDataAndWrite(const std::vector<std::string>& schemaPaths);
 
+    //! Write a legend as the given image segment
+    void addLegend(const Legend&, int imageNumber);
+
     /*!
      * This function sets the NITF blocking.  By default, the product
      * will be unblocked, but for SIDDs the user can override this via
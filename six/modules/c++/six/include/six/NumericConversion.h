@@ -0,0 +1,69 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_NUMERIC_CONVERSION_H__
+#define __SIX_NUMERIC_CONVERSION_H__
+
+#include <string>
+
+namespace six
+{
+/*
+ *  Conversions between floating point values and XML text.
+ *
+ *  These give exactly the same text (or value) as the stream-based
+ *  conversions they replace, but don't construct a stream, and look up
+ *  its locale, for every value.  The decimal point is always '.',
+ *  whatever the locale.
+ */
+
+/*!
+ *  Format a value as std::scientific, std::uppercase with the given
+ *  precision, less any '+' in the exponent: the format required by the
+ *  SICD and SIDD specs, e.g. "-1.25000000000000000E-05" or "3.0E00".
+ *
+ *  \param value Value to format
+ *  \param precision Number of digits after the decimal point
+ */
+std::string toScientificString(double value, int precision);
+
+/*!
+ *  Format a value as a stream does by default, with the given precision.
+ *  This is the format of str::toString(), e.g. "0.5" or "1.0000000000000001e-05".
+ *
+ *  \param value Value to format
+ *  \param precision Maximum number of significant digits
+ */
+std::string toGeneralString(double value, int precision);
+
+/*!
+ *  Parse a value exactly as str::toType() does by reading a stream.
+ *  Leading whitespace is skipped and anything after the number is ignored.
+ *
+ *  \param s String to parse
+ *  \throw except::BadCastException if s doesn't begin with a number, or
+ *  it's out of range of the type
+ */
+double parseDouble(const std::string& s);
+float parseFloat(const std::string& s);
+}
+
+#endif
@@ -0,0 +1,181 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __SIX_REGION_WRITE_CONTROL_H__
+#define __SIX_REGION_WRITE_CONTROL_H__
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <std/cstddef>
+
+#include <types/RowCol.h>
+#include <six/NITFSegmentInfo.h>
+#include <six/NITFWriteControl.h>
+
+namespace six
+{
+/*!
+ * \class RegionWriteControl
+ * \brief NITF write control that writes the pixels of each product one
+ * region at a time, in any order
+ *
+ * This is six::sicd::SICDWriteControl for any SICD or SIDD, including
+ * blocked SIDDs and SIDDs with several products (and legends).  The headers
+ * and XML are written, with space reserved for the pixels, before the first
+ * region is saved.
+ *
+ * Images that aren't blocked, or whose blocks span every column, are
+ * written straight to the file.  Otherwise, a block row can only be written
+ * once all of its blocks are complete, so each block row that has been
+ * partly saved is held until it is.  Saving in roughly row order keeps
+ * this to a few block rows, however the regions are shaped.
+ *
+ * Each pixel should be saved exactly once.  Compressed output isn't
+ * supported.
+ */
+class RegionWriteControl : public NITFWriteControl
+{
+public:
+    /*!
+     * Constructor
+     *
+     * \param outputPathname Full path to the output file to write
+     * \param schemaPaths Directories or files of schema locations
+     */
+    RegionWriteControl(const std::string& outputPathname,
+                       const std::vector<std::string>& schemaPaths);
+
+    //! Closes the file if close() wasn't called, ignoring any errors
+    ~RegionWriteControl();
+
+    RegionWriteControl(const RegionWriteControl&) = delete;
+    RegionWriteControl& operator=(const RegionWriteControl&) = delete;
+
+    using NITFWriteControl::initialize;
+    using NITFWriteControl::save;
+
+    /*!
+     * Writes a region of a product's pixels.  The first time this is
+     * called, the headers will be written to the file.
+     *
+     * \param imageData The region's pixels, pixel interleaved and in the
+     *     product's pixel type.  Unless the OPT_BYTE_SWAP option has been set
+     *     or this is a big endian system, these are endian swapped as they
+     *     are written; the caller's buffer is left alone.
+     * \param offset The region's offset in the product, in pixels.  Image
+     *     segments and blocks are taken care of by this class.
+     * \param dims The region's dimensions
+     * \param imageNumber Which product the pixels belong to
+     *
+     * \throw except::Exception if the region is outside the product.  When
+     *     blocks don't span every column, also if the region overlaps pixels
+     *     already saved to a block row that is still held, or touches a
+     *     block row that has already been written out.
+     */
+    void save(const void* imageData,
+              const types::RowCol<size_t>& offset,
+              const types::RowCol<size_t>& dims,
+              size_t imageNumber = 0);
+
+    //! Number of partly saved block rows being held
+    size_t getNumPendingBlockRows() const;
+
+    /*!
+     * Writes out any partly saved block rows (with zeros for the pixels
+     * that weren't saved) and closes the file.  The headers are written
+     * first if nothing was saved.
+     */
+    void close();
+
+private:
+    struct BlockRow final
+    {
+        std::vector<std::byte> pixels;
+
+        //! Which of the block row's image pixels have been saved
+        std::vector<bool> saved;
+        size_t numPixels = 0;
+    };
+
+    struct Segment final
+    {
+        NITFSegmentInfo info;
+        nitf::Off dataStart = 0;
+        types::RowCol<size_t> blockDims;
+        size_t numBlocksPerRow = 0;
+        size_t numBlockRows = 0;
+        size_t blockRowBytes = 0;
+
+        //! Partly saved block rows, by index
+        std::map<size_t, BlockRow> pending;
+
+        //! Block rows already written to the file, by index
+        std::vector<bool> written;
+    };
+
+    struct Product final
+    {
+        types::RowCol<size_t> dims;
+        size_t pixelSize = 0;
+        size_t elemSize = 0;
+        std::vector<Segment> segments;
+    };
+
+    void writeHeaders();
+
+    void writeRows(const Product& product,
+                   const Segment& segment,
+                   const std::byte* imageData,
+                   size_t segmentRow,
+                   size_t col,
+                   const types::RowCol<size_t>& dims);
+
+    void bufferRows(const Product& product,
+                    Segment& segment,
+                    const std::byte* imageData,
+                    size_t segmentRow,
+                    size_t col,
+                    const types::RowCol<size_t>& dims);
+
+    void writeBlockRow(const Segment& segment,
+                       size_t blockRow,
+                       const BlockRow& pixels);
+
+    void byteSwap(const Product& product, std::byte* pixels,
+                  size_t numPixels) const;
+
+private:
+    std::unique_ptr<nitf::IOInterface> mIO;
+    const std::vector<std::string> mSchemaPaths;
+
+    std::vector<Product> mProducts;
+    std::vector<std::byte> mScratch;
+    bool mDoByteSwap;
+    bool mHaveWrittenHeaders;
+    bool mClosed;
+};
+}
+
+#endif
@@ -0,0 +1,142 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SCHEMA_VALIDATOR_CACHE_H__
+#define __SIX_SCHEMA_VALIDATOR_CACHE_H__
+
+#include <stddef.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <std/filesystem>
+#include <std/string>
+
+#include <logging/Logger.h>
+#include <mt/Singleton.h>
+#include <xml/lite/Element.h>
+#include <xml/lite/ValidatorInterface.h>
+
+namespace six
+{
+/*!
+ *  \class SchemaValidatorCache
+ *  \brief Process-wide cache of compiled schema grammars
+ *
+ *  Constructing an xml::lite::Validator loads and compiles every schema
+ *  found under its schema paths, which usually costs far more than
+ *  validating the DES itself.  This keeps the validators around so each
+ *  set of schema paths is compiled once per process rather than once per
+ *  document.  A validator's grammar pool holds the grammars for every
+ *  namespace under its paths, and the document's namespace URI selects the
+ *  grammar it's validated against.
+ *
+ *  A validator can only validate one document at a time, so each set of
+ *  schema paths keeps a pool of idle validators.  Concurrent callers each
+ *  take their own, and the pool only grows to the number of documents
+ *  that are ever validated at once.
+ */
+class SchemaValidatorCache
+{
+public:
+    SchemaValidatorCache();
+    ~SchemaValidatorCache();
+
+    SchemaValidatorCache(const SchemaValidatorCache&) = delete;
+    SchemaValidatorCache& operator=(const SchemaValidatorCache&) = delete;
+
+    /*!
+     *  Validate an element (normally a DES root element) against the
+     *  schema for its namespace URI.
+     *
+     *  The element is validated as compact XML.  If that fails, it's
+     *  validated again pretty-printed so that the line numbers in the
+     *  errors are useful.
+     *
+     *  \param element Element to validate
+     *  \param schemaPaths Schemas and directories to search for schemas.
+     *  Each distinct list is compiled once.
+     *  \param errors Object for returning errors found (errors are
+     *  appended)
+     *  \param log Logger for reporting schemas that fail to load.  Only
+     *  used when the schemas are compiled.
+     *
+     *  \return True if the element is valid
+     */
+    bool validate(const xml::lite::Element& element,
+                  const std::vector<std::filesystem::path>& schemaPaths,
+                  std::vector<xml::lite::ValidationInfo>& errors,
+                  logging::Logger* log = nullptr);
+
+    /*!
+     *  Validate an XML document as is, without parsing it into a DOM
+     *  first.  The document's namespace URI selects the schema.
+     *
+     *  \param xml The XML document, UTF-8 encoded
+     *  \param xmlID Identifies the document in the errors
+     *  \param schemaPaths Schemas and directories to search for schemas.
+     *  Each distinct list is compiled once.
+     *  \param errors Object for returning errors found (errors are
+     *  appended)
+     *  \param log Logger for reporting schemas that fail to load.  Only
+     *  used when the schemas are compiled.
+     *
+     *  \return True if the document is valid
+     */
+    bool validate(const coda_oss::u8string& xml,
+                  const std::string& xmlID,
+                  const std::vector<std::filesystem::path>& schemaPaths,
+                  std::vector<xml::lite::ValidationInfo>& errors,
+                  logging::Logger* log = nullptr);
+
+    //! \return The number of distinct sets of schema paths compiled
+    size_t size() const;
+
+    //! \return The number of validators compiled for these schema paths
+    size_t getNumValidators(
+            const std::vector<std::filesystem::path>& schemaPaths) const;
+
+    /*!
+     *  Discard all compiled schemas, e.g. if the schemas on disk have
+     *  changed.  Validations already in progress are unaffected.
+     */
+    void clear();
+
+private:
+    struct Validators;
+
+    std::shared_ptr<Validators> getValidators(
+            const std::vector<std::filesystem::path>& schemaPaths);
+
+    static std::string makeKey(
+            const std::vector<std::filesystem::path>& schemaPaths);
+
+    mutable std::mutex mMutex;
+    std::map<std::string, std::shared_ptr<Validators> > mValidators;
+};
+
+//!  Singleton declaration of our SchemaValidatorCache
+typedef mt::Singleton<SchemaValidatorCache, true> SchemaCache;
+}
+
+#endif
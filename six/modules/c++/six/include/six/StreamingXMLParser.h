@@ -0,0 +1,103 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_STREAMING_XML_PARSER_H__
+#define __SIX_STREAMING_XML_PARSER_H__
+
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <io/InputStream.h>
+#include <xml/lite/Element.h>
+
+namespace six
+{
+/*!
+ *  \class StreamingXMLParser
+ *  \brief SAX parser which hands each registered section of a document to
+ *  its handler as soon as the section ends.
+ *
+ *  A DOM for a large document (e.g. CPHD metadata with thousands of
+ *  channels) is expensive both to build and to search.  Instead, handlers
+ *  are registered for element paths relative to the root element, e.g.
+ *  "Global" or "Channel/Parameters".  Only the elements under a registered
+ *  path are kept, in a small DOM that's passed to the handler and then
+ *  thrown away.  Everything outside of a registered path is skipped.
+ *
+ *  Registered paths may be nested.  An element under a nested path is
+ *  given only to the innermost handler, so the outer handler sees its
+ *  section without those children.  This lets large repeated children be
+ *  parsed one at a time while their parent is still being read.
+ */
+struct StreamingXMLParser final
+{
+    //! Called with each complete element at a registered path
+    using Handler = std::function<void(const xml::lite::Element&)>;
+
+    StreamingXMLParser();
+    ~StreamingXMLParser();
+    StreamingXMLParser(const StreamingXMLParser&) = delete;
+    StreamingXMLParser& operator=(const StreamingXMLParser&) = delete;
+    StreamingXMLParser(StreamingXMLParser&&) = default;
+    StreamingXMLParser& operator=(StreamingXMLParser&&) = default;
+
+    /*!
+     *  Register a handler.
+     *
+     *  \param path '/' separated local names of the elements to handle,
+     *  starting below the root element
+     *  \param handler Handler for each element at this path
+     */
+    void addHandler(const std::string& path, Handler handler);
+
+    /*!
+     *  Parse a document, calling the handlers as their elements end.
+     *  Any exception thrown by a handler stops the parse.
+     *
+     *  \param is  This is the input stream to feed the parser
+     *  \param size  This is the size of the stream to feed the parser
+     */
+    void parse(io::InputStream& is, int size = io::InputStream::IS_END);
+
+    //! \return The local name of the root element of the last parse
+    const std::string& getRootName() const;
+
+    //! \return The namespace URI of the root element of the last parse
+    const std::string& getRootUri() const;
+
+    //! \return How many elements were handled at this path in the last parse
+    size_t getCount(const std::string& path) const;
+
+    /*!
+     *  @see MinidomHandler::preserveCharacterData
+     */
+    void preserveCharacterData(bool preserve);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+}
+
+#endif
@@ -24,11 +24,19 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <std/cstddef>
 #include <stdexcept>
 #include <gsl/gsl.h>
 #include <std/memory>
 
+#include <mt/ThreadGroup.h>
+#include <sys/Runnable.h>
+
 using namespace six;
 
 template<typename TPImpl>
@@ -336,6 +344,290 @@ NewMemoryWriteHandler::NewMemoryWriteHandler(const NITFSegmentInfo& info,
     validate_buffer(buffer, info, data);
 }
 
+//
+// BlockedMemoryWriteHandler
+//
+struct BlockedMemoryWriteHandlerImpl final
+{
+    const std::byte* buffer; // first row of the segment
+    size_t numRows;
+    size_t numCols;
+    size_t pixelSize;
+    size_t elemSize;
+    size_t numRowsPerBlock;
+    size_t numColsPerBlock;
+    size_t numThreads;
+    int doByteSwap;
+};
+
+namespace
+{
+// Bytes of blocks handed from the workers to the writer at once
+constexpr size_t BLOCK_GROUP_BYTES = 4 * 1024 * 1024;
+
+// Groups of blocks made by the workers and written in order by the caller
+class BlockPipeline final
+{
+public:
+    explicit BlockPipeline(const BlockedMemoryWriteHandlerImpl& impl) :
+        mImpl(impl),
+        mNumBlocksAcross((impl.numCols + impl.numColsPerBlock - 1) /
+                         impl.numColsPerBlock),
+        mNumBlocks(mNumBlocksAcross *
+                   ((impl.numRows + impl.numRowsPerBlock - 1) /
+                    impl.numRowsPerBlock)),
+        mBlockSize(impl.numRowsPerBlock * impl.numColsPerBlock *
+                   impl.pixelSize),
+        mBlocksPerGroup(std::max<size_t>(BLOCK_GROUP_BYTES / mBlockSize, 1)),
+        mNumGroups((mNumBlocks + mBlocksPerGroup - 1) / mBlocksPerGroup),
+        mSlots(std::min(2 * impl.numThreads, mNumGroups)),
+        mFilled(mSlots.size(), mNumGroups)
+    {
+        for (auto& slot : mSlots)
+        {
+            slot.resize(mBlocksPerGroup * mBlockSize);
+        }
+    }
+
+    // Worker loop: block groups in order, a few ahead of the writer
+    void work()
+    {
+        for (size_t group = mNextGroup++; group < mNumGroups;
+             group = mNextGroup++)
+        {
+            const size_t slot = group % mSlots.size();
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [&]()
+                {
+                    return mAborted || group < mNumWritten + mSlots.size();
+                });
+                if (mAborted)
+                {
+                    return;
+                }
+            }
+
+            try
+            {
+                blockGroup(group, mSlots[slot].data());
+            }
+            catch (...)
+            {
+                abort(std::current_exception());
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFilled[slot] = group;
+            mCondition.notify_all();
+        }
+    }
+
+    // Writer loop: write each group once it's blocked
+    NITF_BOOL write(nitf_IOInterface* io, nitf_Error* error)
+    {
+        for (size_t group = 0; group < mNumGroups; ++group)
+        {
+            const size_t slot = group % mSlots.size();
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [&]()
+                {
+                    return mAborted || mFilled[slot] == group;
+                });
+                if (mAborted)
+                {
+                    return NITF_FAILURE;
+                }
+            }
+
+            const size_t numBlocks =
+                    std::min(mBlocksPerGroup,
+                             mNumBlocks - group * mBlocksPerGroup);
+            if (!nitf_IOInterface_write(io, mSlots[slot].data(),
+                                        numBlocks * mBlockSize, error))
+            {
+                abort(nullptr);
+                return NITF_FAILURE;
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            ++mNumWritten;
+            mCondition.notify_all();
+        }
+        return NITF_SUCCESS;
+    }
+
+    void abort(std::exception_ptr error)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mError)
+        {
+            mError = error;
+        }
+        mAborted = true;
+        mCondition.notify_all();
+    }
+
+    std::exception_ptr getError() const
+    {
+        return mError;
+    }
+
+private:
+    void blockGroup(size_t group, std::byte* output) const
+    {
+        const size_t firstBlock = group * mBlocksPerGroup;
+        const size_t lastBlock =
+                std::min(firstBlock + mBlocksPerGroup, mNumBlocks);
+        for (size_t block = firstBlock; block < lastBlock;
+             ++block, output += mBlockSize)
+        {
+            const size_t row =
+                    (block / mNumBlocksAcross) * mImpl.numRowsPerBlock;
+            const size_t col =
+                    (block % mNumBlocksAcross) * mImpl.numColsPerBlock;
+            const std::byte* const input = mImpl.buffer +
+                    (row * mImpl.numCols + col) * mImpl.pixelSize;
+
+            // Pads the right and bottom blocks with zeros
+            nitf::ImageBlocker::block(
+                    input,
+                    mImpl.pixelSize,
+                    mImpl.numCols,
+                    mImpl.numRowsPerBlock,
+                    mImpl.numColsPerBlock,
+                    std::min(mImpl.numRowsPerBlock, mImpl.numRows - row),
+                    std::min(mImpl.numColsPerBlock, mImpl.numCols - col),
+                    output);
+
+            if (mImpl.doByteSwap)
+            {
+                sys::byteSwap(output,
+                              gsl::narrow<unsigned short>(mImpl.elemSize),
+                              mBlockSize / mImpl.elemSize);
+            }
+        }
+    }
+
+    const BlockedMemoryWriteHandlerImpl& mImpl;
+    const size_t mNumBlocksAcross;
+    const size_t mNumBlocks;
+    const size_t mBlockSize;
+    const size_t mBlocksPerGroup;
+    const size_t mNumGroups;
+
+    std::vector<std::vector<std::byte> > mSlots;
+    std::vector<size_t> mFilled; // group in each slot
+    size_t mNumWritten = 0;
+    std::atomic<size_t> mNextGroup{0};
+    bool mAborted = false;
+    std::exception_ptr mError;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+};
+
+class BlockingRunnable final : public sys::Runnable
+{
+public:
+    explicit BlockingRunnable(BlockPipeline& pipeline) :
+        mPipeline(pipeline)
+    {
+    }
+
+    void run() override
+    {
+        mPipeline.work();
+    }
+
+private:
+    BlockPipeline& mPipeline;
+};
+}
+
+static void six_BlockedMemoryWriteHandler_destruct(NITF_DATA * data)
+{
+    nitf_free<BlockedMemoryWriteHandlerImpl>(data);
+}
+
+static NITF_BOOL six_BlockedMemoryWriteHandler_write(NITF_DATA * data,
+        nitf_IOInterface* io, nitf_Error * error)
+{
+    auto const impl = cast_data<const BlockedMemoryWriteHandlerImpl*>(data);
+
+    try
+    {
+        BlockPipeline pipeline(*impl);
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < impl->numThreads; ++ii)
+        {
+            threads.createThread(
+                    std::make_unique<BlockingRunnable>(pipeline));
+        }
+
+        const NITF_BOOL written = pipeline.write(io, error);
+        threads.joinAll();
+        if (pipeline.getError())
+        {
+            std::rethrow_exception(pipeline.getError());
+        }
+        return written;
+    }
+    catch (const std::exception& ex)
+    {
+        nitf_Error_init(error, ex.what(), NITF_CTXT, NITF_ERR_UNK);
+    }
+    catch (const except::Throwable& ex)
+    {
+        nitf_Error_init(error, ex.getMessage().c_str(), NITF_CTXT,
+                        NITF_ERR_UNK);
+    }
+    return NITF_FAILURE;
+}
+
+BlockedMemoryWriteHandler::BlockedMemoryWriteHandler(
+        const NITFSegmentInfo& info,
+        const std::byte* buffer,
+        const Data& data,
+        const types::RowCol<size_t>& blockDims,
+        bool doByteSwap,
+        size_t numThreads)
+{
+    const auto numChannels = data.getNumChannels();
+    const auto pixelSize = data.getNumBytesPerPixel();
+    const auto numRows = info.getNumRows();
+    const auto numCols = data.getNumCols();
+
+    // Dont do it if we only have a byte!
+    if (pixelSize / numChannels == 1)
+        doByteSwap = false;
+
+    static nitf_IWriteHandler iWriteHandler = {
+            &six_BlockedMemoryWriteHandler_write,
+            &six_BlockedMemoryWriteHandler_destruct };
+
+    auto impl = nitf_malloc<BlockedMemoryWriteHandlerImpl>();
+    impl->buffer = buffer + info.getFirstRow() * numCols * pixelSize;
+    impl->numRows = numRows;
+    impl->numCols = numCols;
+    impl->pixelSize = pixelSize;
+    impl->elemSize = pixelSize / numChannels;
+
+    // Blocks are never bigger than the segment
+    impl->numRowsPerBlock = blockDims.row == 0 ?
+            numRows : std::min(blockDims.row, numRows);
+    impl->numColsPerBlock = blockDims.col == 0 ?
+            numCols : std::min(blockDims.col, numCols);
+    impl->numThreads = std::max<size_t>(numThreads, 1);
+    impl->doByteSwap = doByteSwap;
+
+    auto segmentWriter = create_SegmentWriter(impl, iWriteHandler);
+    setNative(segmentWriter);
+
+    setManaged(false);
+}
+
 //
 // StreamWriteHandler
 //
@@ -399,3 +691,63 @@ StreamWriteHandler::StreamWriteHandler(const NITFSegmentInfo& info,
         doByteSwap)
 {
 }
+
+//
+// ReservedWriteHandler
+//
+struct ReservedWriteHandlerImpl final
+{
+    size_t numBytes;
+    nitf::Off* dataStart;
+};
+
+static void six_ReservedWriteHandler_destruct(NITF_DATA * data)
+{
+    nitf_free<ReservedWriteHandlerImpl>(data);
+}
+
+static NITF_BOOL six_ReservedWriteHandler_write(NITF_DATA * data,
+        nitf_IOInterface* io, nitf_Error * error)
+{
+    auto const impl = cast_data<const ReservedWriteHandlerImpl*>(data);
+
+    const nitf::Off start = nitf_IOInterface_tell(io, error);
+    if (!NITF_IO_SUCCESS(start))
+        return NITF_FAILURE;
+    *impl->dataStart = start;
+
+    if (impl->numBytes == 0)
+        return NITF_SUCCESS;
+
+    // NITRO takes the segment's length from the size of the output, so
+    // the last byte has to actually be written.  Seeking past it afterwards
+    // flushes buffered writers, which otherwise only count what's buffered.
+    const auto end = start + static_cast<nitf::Off>(impl->numBytes);
+    const char zero = 0;
+    if (!NITF_IO_SUCCESS(nitf_IOInterface_seek(io, end - 1, NITF_SEEK_SET,
+                                               error)) ||
+        !nitf_IOInterface_write(io, &zero, 1, error) ||
+        !NITF_IO_SUCCESS(nitf_IOInterface_seek(io, end, NITF_SEEK_SET,
+                                               error)))
+    {
+        return NITF_FAILURE;
+    }
+    return NITF_SUCCESS;
+}
+
+ReservedWriteHandler::ReservedWriteHandler(size_t numBytes,
+                                           nitf::Off& dataStart)
+{
+    static nitf_IWriteHandler iWriteHandler = {
+            &six_ReservedWriteHandler_write,
+            &six_ReservedWriteHandler_destruct };
+
+    auto impl = nitf_malloc<ReservedWriteHandlerImpl>();
+    impl->numBytes = numBytes;
+    impl->dataStart = &dataStart;
+
+    auto segmentWriter = create_SegmentWriter(impl, iWriteHandler);
+    setNative(segmentWriter);
+
+    setManaged(false);
+}
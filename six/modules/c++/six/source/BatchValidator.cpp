@@ -0,0 +1,297 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/BatchValidator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <std/memory>
+
+#include <except/Exception.h>
+#include <io/FileInputStream.h>
+#include <mt/ThreadGroup.h>
+#include <nitf/IOHandle.hpp>
+#include <nitf/Reader.hpp>
+#include <sys/Conf.h>
+#include <sys/StopWatch.h>
+
+#include <six/NITFReadControl.h>
+#include <six/SchemaValidatorCache.h>
+#include <six/Utilities.h>
+
+namespace
+{
+// Every document in one file, and how validating them went
+struct FileValidation final
+{
+    std::vector<six::DocumentValidation> documents;
+    std::string failure;
+};
+
+class ValidateRunnable final : public sys::Runnable
+{
+public:
+    ValidateRunnable(
+            const std::vector<std::string>& pathnames,
+            const std::vector<std::unique_ptr<six::XMLDocumentExtractor> >&
+                    extractors,
+            const std::vector<std::filesystem::path>& schemaPaths,
+            logging::Logger* log,
+            std::atomic<size_t>& next,
+            std::vector<FileValidation>& results) :
+        mPathnames(pathnames),
+        mExtractors(extractors),
+        mSchemaPaths(schemaPaths),
+        mLog(log),
+        mNext(next),
+        mResults(results)
+    {
+    }
+
+    void run() override
+    {
+        for (size_t ii = mNext++; ii < mPathnames.size(); ii = mNext++)
+        {
+            validate(ii);
+        }
+    }
+
+private:
+    void validate(size_t index)
+    {
+        FileValidation& result = mResults[index];
+        try
+        {
+            const six::XMLDocumentExtractor* const extractor =
+                    findExtractor(mPathnames[index]);
+            if (extractor == nullptr)
+            {
+                result.failure = "Unsupported file type";
+                return;
+            }
+
+            std::vector<coda_oss::u8string> documents;
+            extractor->extract(mPathnames[index], documents);
+
+            result.documents.resize(documents.size());
+            for (size_t ii = 0; ii < documents.size(); ++ii)
+            {
+                six::DocumentValidation& document = result.documents[ii];
+                document.pathname = mPathnames[index];
+                document.document = ii;
+
+                sys::RealTimeStopWatch sw;
+                sw.start();
+                six::SchemaCache::getInstance().validate(
+                        documents[ii], document.getID(), mSchemaPaths,
+                        document.errors, mLog);
+                document.validationTime = sw.stop();
+            }
+        }
+        catch (const except::Exception& ex)
+        {
+            result.failure = ex.getMessage();
+        }
+        catch (const std::exception& ex)
+        {
+            result.failure = ex.what();
+        }
+        catch (...)
+        {
+            result.failure = "Unknown exception";
+        }
+    }
+
+    const six::XMLDocumentExtractor*
+    findExtractor(const std::string& pathname) const
+    {
+        for (const auto& extractor : mExtractors)
+        {
+            if (extractor->supports(pathname))
+            {
+                return extractor.get();
+            }
+        }
+        return nullptr;
+    }
+
+    const std::vector<std::string>& mPathnames;
+    const std::vector<std::unique_ptr<six::XMLDocumentExtractor> >&
+            mExtractors;
+    const std::vector<std::filesystem::path>& mSchemaPaths;
+    logging::Logger* const mLog;
+    std::atomic<size_t>& mNext;
+    std::vector<FileValidation>& mResults;
+};
+}
+
+namespace six
+{
+NITFXMLDocumentExtractor::NITFXMLDocumentExtractor()
+{
+    // The DES subheaders are needed to find the SICD and SIDD DESs.
+    // Register this now rather than in every thread.
+    loadXmlDataContentHandler(nullptr);
+}
+
+bool NITFXMLDocumentExtractor::supports(const std::string& pathname) const
+{
+    return nitf::Reader::getNITFVersion(pathname) != NITF_VER_UNKNOWN;
+}
+
+void NITFXMLDocumentExtractor::extract(
+        const std::string& pathname,
+        std::vector<coda_oss::u8string>& documents) const
+{
+    // Only the DES subheaders are parsed, not the XML itself
+    nitf::Reader reader;
+    reader.setParseTREs(false);
+    nitf::IOHandle io(pathname);
+    nitf::Record record = reader.read(io);
+
+    nitf::List des = record.getDataExtensions();
+    int index = 0;
+    for (nitf::ListIterator iter = des.begin(); iter != des.end();
+         ++iter, ++index)
+    {
+        const nitf::DESegment segment = (nitf::DESegment) *iter;
+        if (NITFReadControl::getDataType(segment) == DataType::NOT_SET)
+        {
+            continue;
+        }
+
+        nitf::SegmentReader deReader = reader.newDEReader(index);
+        coda_oss::u8string xml(static_cast<size_t>(deReader.getSize()),
+                               coda_oss::u8string::value_type(0));
+        if (!xml.empty())
+        {
+            deReader.read(&xml[0], xml.size());
+        }
+        documents.push_back(std::move(xml));
+    }
+}
+
+bool XMLFileDocumentExtractor::supports(const std::string& pathname) const
+{
+    // Skip any byte order mark and whitespace before the first tag
+    io::FileInputStream is(pathname);
+    char buffer[64];
+    const sys::SSize_T size = is.read(buffer, sizeof(buffer));
+    for (sys::SSize_T ii = 0; ii < size; ++ii)
+    {
+        const unsigned char c = static_cast<unsigned char>(buffer[ii]);
+        if (c == '<')
+        {
+            return true;
+        }
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n' &&
+            c != 0xEF && c != 0xBB && c != 0xBF)
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+void XMLFileDocumentExtractor::extract(
+        const std::string& pathname,
+        std::vector<coda_oss::u8string>& documents) const
+{
+    io::FileInputStream is(pathname);
+    coda_oss::u8string xml(static_cast<size_t>(is.available()),
+                           coda_oss::u8string::value_type(0));
+    if (!xml.empty())
+    {
+        is.read(&xml[0], xml.size(), true);
+    }
+    documents.push_back(std::move(xml));
+}
+
+std::string DocumentValidation::getID() const
+{
+    return pathname + "[" + std::to_string(document) + "]";
+}
+
+BatchValidator::BatchValidator(
+        const std::vector<std::filesystem::path>& schemaPaths,
+        size_t numThreads,
+        logging::Logger* log) :
+    mSchemaPaths(schemaPaths),
+    mNumThreads(std::max<size_t>(numThreads, 1)),
+    mLog(log)
+{
+    if (mSchemaPaths.empty())
+    {
+        throw except::Exception(Ctxt("No schemas to validate against"));
+    }
+}
+
+void BatchValidator::addExtractor(
+        std::unique_ptr<XMLDocumentExtractor>&& extractor)
+{
+    mExtractors.push_back(std::move(extractor));
+}
+
+std::vector<DocumentValidation>
+BatchValidator::validate(const std::vector<std::string>& pathnames) const
+{
+    std::vector<FileValidation> results(pathnames.size());
+    std::atomic<size_t> next(0);
+    const size_t numThreads = std::min(mNumThreads, pathnames.size());
+    if (numThreads <= 1)
+    {
+        ValidateRunnable(pathnames, mExtractors, mSchemaPaths, mLog, next,
+                         results).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            threads.createThread(std::make_unique<ValidateRunnable>(
+                    pathnames, mExtractors, mSchemaPaths, mLog, next,
+                    results));
+        }
+        threads.joinAll();
+    }
+
+    std::vector<DocumentValidation> validations;
+    for (size_t ii = 0; ii < pathnames.size(); ++ii)
+    {
+        FileValidation& result = results[ii];
+        if (!result.failure.empty() || result.documents.empty())
+        {
+            // Say why there's nothing to show for the file
+            DocumentValidation validation;
+            validation.pathname = pathnames[ii];
+            validation.failure = result.failure.empty() ?
+                    "No XML documents found" : result.failure;
+            validations.push_back(std::move(validation));
+        }
+        else
+        {
+            std::move(result.documents.begin(), result.documents.end(),
+                      std::back_inserter(validations));
+        }
+    }
+    return validations;
+}
+}
@@ -0,0 +1,543 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/MetadataIndexer.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <std/filesystem>
+#include <std/memory>
+
+#include <except/Exception.h>
+#include <mt/ThreadGroup.h>
+#include <sys/Conf.h>
+#include <sys/StopWatch.h>
+
+#include <six/NITFReadControl.h>
+#include <six/NumericConversion.h>
+#include <six/Utilities.h>
+
+namespace
+{
+const char MAGIC[] = "SIXMDIDX";
+constexpr size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+constexpr uint32_t FORMAT_VERSION = 1;
+
+template <typename T>
+void writeInt(io::OutputStream& os, T value)
+{
+    unsigned char bytes[sizeof(T)];
+    for (size_t ii = 0; ii < sizeof(T); ++ii)
+    {
+        bytes[ii] = static_cast<unsigned char>(value >> (8 * ii));
+    }
+    os.write(bytes, sizeof(T));
+}
+
+// Reads an index, checking each size against what's left of the stream
+// before allocating for it, so a damaged index is an error rather than a
+// huge allocation.  A stream that doesn't know its size is only checked
+// against the column sizes.
+class IndexReader final
+{
+public:
+    explicit IndexReader(io::InputStream& is) :
+        mStream(is),
+        mRemaining(std::numeric_limits<uint64_t>::max())
+    {
+        const sys::Off_T available = is.available();
+        if (available > 0)
+        {
+            mRemaining = static_cast<uint64_t>(available);
+        }
+    }
+
+    //! Throw unless there are at least count items of 'size' bytes left
+    void require(uint64_t count, uint64_t size) const
+    {
+        if (size > 0 && count > mRemaining / size)
+        {
+            throw except::Exception(Ctxt("Metadata index is truncated"));
+        }
+    }
+
+    void read(void* buffer, size_t size)
+    {
+        require(size, 1);
+        mStream.read(buffer, size, true);
+        mRemaining -= size;
+    }
+
+    template <typename T>
+    T readInt()
+    {
+        unsigned char bytes[sizeof(T)];
+        read(bytes, sizeof(T));
+        T value = 0;
+        for (size_t ii = 0; ii < sizeof(T); ++ii)
+        {
+            value |= static_cast<T>(bytes[ii]) << (8 * ii);
+        }
+        return value;
+    }
+
+    std::string readString(size_t length)
+    {
+        require(length, 1);
+        std::string s(length, '\0');
+        if (length > 0)
+        {
+            read(&s[0], length);
+        }
+        return s;
+    }
+
+private:
+    io::InputStream& mStream;
+    uint64_t mRemaining;
+};
+
+void writeString(io::OutputStream& os, const std::string& s)
+{
+    writeInt(os, static_cast<uint32_t>(s.size()));
+    os.write(s.data(), s.size());
+}
+
+// Everything the indexer found out about one file
+struct FileSummary final
+{
+    std::vector<six::MetadataSummary> summaries;
+    std::string error;
+    double openTime = 0.0;
+};
+
+class SummarizeRunnable final : public sys::Runnable
+{
+public:
+    SummarizeRunnable(
+            const std::vector<std::string>& pathnames,
+            const std::vector<std::unique_ptr<six::MetadataSummarizer> >&
+                    summarizers,
+            std::atomic<size_t>& next,
+            std::vector<FileSummary>& results) :
+        mPathnames(pathnames),
+        mSummarizers(summarizers),
+        mNext(next),
+        mResults(results)
+    {
+    }
+
+    void run() override
+    {
+        for (size_t ii = mNext++; ii < mPathnames.size(); ii = mNext++)
+        {
+            summarize(ii);
+        }
+    }
+
+private:
+    void summarize(size_t index)
+    {
+        FileSummary& result = mResults[index];
+        sys::RealTimeStopWatch sw;
+        sw.start();
+        try
+        {
+            // Finding the summarizer opens the file, so it's done here
+            // rather than before the threads start
+            const six::MetadataSummarizer* const summarizer =
+                    findSummarizer(mPathnames[index]);
+            if (summarizer == nullptr)
+            {
+                result.error = "Unsupported file type";
+            }
+            else
+            {
+                summarizer->summarize(mPathnames[index], result.summaries);
+            }
+        }
+        catch (const except::Exception& ex)
+        {
+            result.error = ex.getMessage();
+        }
+        catch (const std::exception& ex)
+        {
+            result.error = ex.what();
+        }
+        catch (...)
+        {
+            result.error = "Unknown exception";
+        }
+        result.openTime = sw.stop();
+
+        if (!result.error.empty())
+        {
+            result.summaries.clear();
+        }
+    }
+
+    const six::MetadataSummarizer*
+    findSummarizer(const std::string& pathname) const
+    {
+        for (const auto& summarizer : mSummarizers)
+        {
+            if (summarizer->supports(pathname))
+            {
+                return summarizer.get();
+            }
+        }
+        return nullptr;
+    }
+
+    const std::vector<std::string>& mPathnames;
+    const std::vector<std::unique_ptr<six::MetadataSummarizer> >&
+            mSummarizers;
+    std::atomic<size_t>& mNext;
+    std::vector<FileSummary>& mResults;
+};
+}
+
+namespace six
+{
+const char MetadataField::PATHNAME[] = "Pathname";
+const char MetadataField::PRODUCT[] = "Product";
+const char MetadataField::OPEN_TIME[] = "OpenTime";
+const char MetadataField::ERROR_MESSAGE[] = "Error";
+const char MetadataField::TYPE[] = "Type";
+const char MetadataField::VERSION[] = "Version";
+const char MetadataField::NAME[] = "Name";
+const char MetadataField::COLLECTOR[] = "Collector";
+const char MetadataField::COLLECT_START[] = "CollectStart";
+const char MetadataField::CLASSIFICATION[] = "Classification";
+const char MetadataField::NUM_ROWS[] = "NumRows";
+const char MetadataField::NUM_COLS[] = "NumCols";
+const char MetadataField::FOOTPRINT[] = "Footprint";
+const char MetadataField::POLARIZATION[] = "Polarization";
+
+std::vector<std::string> MetadataField::getAll()
+{
+    return { PATHNAME, PRODUCT, OPEN_TIME, ERROR_MESSAGE, TYPE, VERSION,
+             NAME, COLLECTOR, COLLECT_START, CLASSIFICATION, NUM_ROWS,
+             NUM_COLS, FOOTPRINT, POLARIZATION };
+}
+
+std::string MetadataSummarizer::toString(const LatLonCorners& corners)
+{
+    // Enough digits for a few mm
+    constexpr int precision = 10;
+
+    std::string footprint;
+    for (size_t ii = 0; ii < LatLonCorners::NUM_CORNERS; ++ii)
+    {
+        const LatLon& corner = corners.getCorner(ii);
+        if (ii > 0)
+        {
+            footprint += ' ';
+        }
+        footprint += toGeneralString(corner.getLat(), precision) + ' ' +
+                toGeneralString(corner.getLon(), precision);
+    }
+    return footprint;
+}
+
+NITFMetadataSummarizer::NITFMetadataSummarizer()
+{
+    // Register this now rather than in every thread's NITFReadControl
+    loadXmlDataContentHandler(nullptr);
+}
+
+bool NITFMetadataSummarizer::supports(const std::string& pathname) const
+{
+    return nitf::Reader::getNITFVersion(pathname) != NITF_VER_UNKNOWN;
+}
+
+void NITFMetadataSummarizer::summarize(
+        const std::string& pathname,
+        std::vector<MetadataSummary>& summaries) const
+{
+    NITFReadControl reader(nullptr);
+    reader.getOptions().setParameter(NITFReadControl::OPT_METADATA_ONLY,
+                                     Parameter(1));
+    reader.load(std::filesystem::path(pathname), nullptr /*pSchemaPaths*/);
+
+    const std::shared_ptr<const Container> container = reader.getContainer();
+    for (size_t ii = 0; ii < container->size(); ++ii)
+    {
+        MetadataSummary summary;
+        summarize(*container->getData(ii), summary);
+        summaries.push_back(summary);
+    }
+}
+
+void NITFMetadataSummarizer::summarize(const Data& data,
+                                       MetadataSummary& summary) const
+{
+    const DataType dataType = data.getDataType();
+    summary[MetadataField::TYPE] = dataType == DataType::COMPLEX ? "SICD" :
+            dataType == DataType::DERIVED ? "SIDD" : "";
+    summary[MetadataField::VERSION] = data.getVersion();
+    summary[MetadataField::NAME] = data.getName();
+    summary[MetadataField::COLLECTOR] = data.getSource();
+    summary[MetadataField::COLLECT_START] =
+            six::toString(data.getCollectionStartDateTime());
+    summary[MetadataField::CLASSIFICATION] =
+            data.getClassification().getLevel();
+    summary[MetadataField::NUM_ROWS] = std::to_string(data.getNumRows());
+    summary[MetadataField::NUM_COLS] = std::to_string(data.getNumCols());
+    summary[MetadataField::FOOTPRINT] = toString(data.getImageCorners());
+}
+
+const std::vector<std::string>&
+MetadataIndex::getColumn(const std::string& field) const
+{
+    const auto iter = std::find(fields.begin(), fields.end(), field);
+    if (iter == fields.end())
+    {
+        throw except::NoSuchKeyException(Ctxt(field));
+    }
+    return values[iter - fields.begin()];
+}
+
+void MetadataIndex::write(io::OutputStream& os) const
+{
+    if (values.size() != fields.size())
+    {
+        throw except::Exception(Ctxt("Expected a column per field"));
+    }
+    const size_t numRows = getNumRows();
+
+    os.write(MAGIC, MAGIC_SIZE);
+    writeInt(os, FORMAT_VERSION);
+    writeInt(os, static_cast<uint32_t>(fields.size()));
+    writeInt(os, static_cast<uint64_t>(numRows));
+
+    for (size_t ii = 0; ii < fields.size(); ++ii)
+    {
+        const std::vector<std::string>& column = values[ii];
+        if (column.size() != numRows)
+        {
+            throw except::Exception(Ctxt(
+                    "Column " + fields[ii] + " has the wrong number of rows"));
+        }
+
+        // The size lets readers skip columns
+        uint64_t columnSize = sizeof(uint32_t) * numRows;
+        for (const auto& value : column)
+        {
+            columnSize += value.size();
+        }
+
+        writeString(os, fields[ii]);
+        writeInt(os, columnSize);
+        for (const auto& value : column)
+        {
+            writeInt(os, static_cast<uint32_t>(value.size()));
+        }
+        for (const auto& value : column)
+        {
+            os.write(value.data(), value.size());
+        }
+    }
+}
+
+MetadataIndex MetadataIndex::read(io::InputStream& is)
+{
+    IndexReader reader(is);
+
+    char magic[MAGIC_SIZE];
+    reader.read(magic, MAGIC_SIZE);
+    if (memcmp(magic, MAGIC, MAGIC_SIZE) != 0)
+    {
+        throw except::Exception(Ctxt("Not a metadata index"));
+    }
+
+    const uint32_t version = reader.readInt<uint32_t>();
+    if (version != FORMAT_VERSION)
+    {
+        throw except::Exception(Ctxt(
+                "Unsupported metadata index version " +
+                std::to_string(version)));
+    }
+
+    MetadataIndex index;
+    const uint32_t numFields = reader.readInt<uint32_t>();
+    const uint64_t numRows = reader.readInt<uint64_t>();
+
+    // Each column has at least a name length and a size, and each of its
+    // values has at least a length
+    constexpr uint64_t minColumnSize = sizeof(uint32_t) + sizeof(uint64_t);
+    reader.require(numFields, minColumnSize);
+    if (numFields == 0 && numRows != 0)
+    {
+        throw except::Exception(Ctxt("Metadata index has rows but no columns"));
+    }
+    if (numFields > 0)
+    {
+        reader.require(numRows, sizeof(uint32_t));
+    }
+    index.fields.resize(numFields);
+    index.values.resize(numFields);
+
+    std::vector<uint32_t> lengths;
+    for (uint32_t ii = 0; ii < numFields; ++ii)
+    {
+        index.fields[ii] = reader.readString(reader.readInt<uint32_t>());
+
+        // The lengths and values have to add up to the column size
+        const uint64_t columnSize = reader.readInt<uint64_t>();
+        reader.require(columnSize, 1);
+        if (numRows > columnSize / sizeof(uint32_t))
+        {
+            throw except::Exception(Ctxt(
+                    "Column " + index.fields[ii] + " is too small"));
+        }
+        lengths.resize(static_cast<size_t>(numRows));
+        uint64_t valuesLeft = columnSize - sizeof(uint32_t) * numRows;
+        for (auto& length : lengths)
+        {
+            length = reader.readInt<uint32_t>();
+            if (length > valuesLeft)
+            {
+                throw except::Exception(Ctxt(
+                        "Column " + index.fields[ii] +
+                        " has more data than its size"));
+            }
+            valuesLeft -= length;
+        }
+        if (valuesLeft != 0)
+        {
+            throw except::Exception(Ctxt(
+                    "Column " + index.fields[ii] +
+                    " has less data than its size"));
+        }
+
+        std::vector<std::string>& column = index.values[ii];
+        column.reserve(lengths.size());
+        for (const auto length : lengths)
+        {
+            column.push_back(reader.readString(length));
+        }
+    }
+    return index;
+}
+
+MetadataIndexer::MetadataIndexer(const std::vector<std::string>& fields,
+                                 size_t numThreads) :
+    mFields(fields),
+    mNumThreads(std::max<size_t>(numThreads, 1))
+{
+}
+
+void MetadataIndexer::addSummarizer(
+        std::unique_ptr<MetadataSummarizer>&& summarizer)
+{
+    mSummarizers.push_back(std::move(summarizer));
+}
+
+MetadataIndex MetadataIndexer::index(const std::vector<std::string>& pathnames,
+                                     MetadataIndexStatistics* stats) const
+{
+    sys::RealTimeStopWatch sw;
+    sw.start();
+
+    std::vector<FileSummary> results(pathnames.size());
+
+    std::atomic<size_t> next(0);
+    const size_t numThreads = std::min(mNumThreads, pathnames.size());
+    if (numThreads <= 1)
+    {
+        SummarizeRunnable(pathnames, mSummarizers, next, results).run();
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            threads.createThread(std::make_unique<SummarizeRunnable>(
+                    pathnames, mSummarizers, next, results));
+        }
+        threads.joinAll();
+    }
+
+    MetadataIndex index;
+    index.fields = mFields;
+    index.values.resize(mFields.size());
+
+    MetadataIndexStatistics localStats;
+    localStats.numFiles = pathnames.size();
+    localStats.minOpenTime = std::numeric_limits<double>::max();
+    for (size_t ii = 0; ii < pathnames.size(); ++ii)
+    {
+        FileSummary& result = results[ii];
+        localStats.minOpenTime = std::min(localStats.minOpenTime,
+                                          result.openTime);
+        localStats.maxOpenTime = std::max(localStats.maxOpenTime,
+                                          result.openTime);
+        localStats.meanOpenTime += result.openTime;
+        if (!result.error.empty())
+        {
+            ++localStats.numFailed;
+        }
+        localStats.numProducts += result.summaries.size();
+
+        // A file that failed still gets a row, to say why
+        if (result.summaries.empty())
+        {
+            result.summaries.resize(1);
+        }
+        for (size_t product = 0; product < result.summaries.size(); ++product)
+        {
+            MetadataSummary& summary = result.summaries[product];
+            summary[MetadataField::PATHNAME] = pathnames[ii];
+            summary[MetadataField::PRODUCT] = std::to_string(product);
+            summary[MetadataField::OPEN_TIME] =
+                    toGeneralString(result.openTime, 6);
+            summary[MetadataField::ERROR_MESSAGE] = result.error;
+
+            for (size_t field = 0; field < mFields.size(); ++field)
+            {
+                const auto iter = summary.find(mFields[field]);
+                index.values[field].push_back(
+                        iter == summary.end() ? "" : iter->second);
+            }
+        }
+    }
+
+    if (pathnames.empty())
+    {
+        localStats.minOpenTime = 0.0;
+    }
+    else
+    {
+        localStats.meanOpenTime /= pathnames.size();
+    }
+    localStats.elapsedTime = sw.stop();
+
+    if (stats != nullptr)
+    {
+        *stats = localStats;
+    }
+    return index;
+}
+}
@@ -0,0 +1,557 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/MetadataSnapshot.h>
+
+#include <string.h>
+
+#include <limits>
+
+#include <std/bit>
+
+#include <except/Exception.h>
+
+namespace
+{
+constexpr size_t MAGIC_SIZE = 8;
+
+// Like the meshes, snapshots are big endian
+const bool swapBytes = std::endian::native == std::endian::little;
+
+// Read up to and including the identifier
+std::string readHeader(const std::byte*& current, const std::byte* end)
+{
+    const auto require = [&](size_t size) {
+        if (static_cast<size_t>(end - current) < size)
+        {
+            throw except::Exception(Ctxt("Metadata snapshot is truncated"));
+        }
+    };
+
+    require(MAGIC_SIZE);
+    if (memcmp(current, six::MetadataSnapshot::MAGIC, MAGIC_SIZE) != 0)
+    {
+        throw except::Exception(Ctxt("Not a metadata snapshot"));
+    }
+    current += MAGIC_SIZE;
+
+    uint32_t version = 0;
+    require(sizeof(version));
+    six::deserialize(current, swapBytes, version);
+    if (version != six::MetadataSnapshot::VERSION)
+    {
+        throw except::Exception(Ctxt(
+                "Unsupported metadata snapshot version " +
+                std::to_string(version)));
+    }
+
+    uint32_t size = 0;
+    require(sizeof(size));
+    six::deserialize(current, swapBytes, size);
+    require(size);
+    const auto* const identifier = reinterpret_cast<const char*>(current);
+    current += size;
+    return std::string(identifier, identifier + size);
+}
+}
+
+namespace six
+{
+const char MetadataSnapshot::MAGIC[] = "SIXMDSNP";
+constexpr uint32_t MetadataSnapshot::VERSION;
+
+std::string MetadataSnapshot::getIdentifier(std::span<const std::byte> buffer)
+{
+    const std::byte* current = buffer.data();
+    return readHeader(current, buffer.data() + buffer.size());
+}
+
+constexpr size_t SnapshotArchive::MAX_DEPTH;
+
+SnapshotArchive::SnapshotArchive(const std::string& identifier,
+                                 std::vector<std::byte>& buffer) :
+    mBuffer(&buffer),
+    mSwapBytes(swapBytes)
+{
+    const auto* const magic =
+            reinterpret_cast<const std::byte*>(MetadataSnapshot::MAGIC);
+    buffer.insert(buffer.end(), magic, magic + MAGIC_SIZE);
+    serialize(MetadataSnapshot::VERSION, mSwapBytes, buffer);
+
+    serialize(static_cast<uint32_t>(identifier.size()), mSwapBytes, buffer);
+    const auto* const bytes =
+            reinterpret_cast<const std::byte*>(identifier.data());
+    buffer.insert(buffer.end(), bytes, bytes + identifier.size());
+}
+
+SnapshotArchive::SnapshotArchive(const std::string& identifier,
+                                 std::span<const std::byte> buffer) :
+    mCurrent(buffer.data()),
+    mEnd(buffer.data() + buffer.size()),
+    mSwapBytes(swapBytes)
+{
+    const std::string actualIdentifier = readHeader(mCurrent, mEnd);
+    if (actualIdentifier != identifier)
+    {
+        throw except::Exception(Ctxt(
+                "Expected a metadata snapshot of " + identifier +
+                " but found " + actualIdentifier));
+    }
+}
+
+void SnapshotArchive::finish() const
+{
+    if (isReading() && mCurrent != mEnd)
+    {
+        throw except::Exception(Ctxt(
+                "Unexpected data after the metadata snapshot"));
+    }
+}
+
+SnapshotArchive::Nested::Nested(SnapshotArchive& archive) :
+    mArchive(archive)
+{
+    if (mArchive.mDepth == MAX_DEPTH)
+    {
+        throw except::Exception(Ctxt(
+                "Metadata snapshot is nested too deeply"));
+    }
+    ++mArchive.mDepth;
+}
+
+SnapshotArchive::Nested::~Nested()
+{
+    --mArchive.mDepth;
+}
+
+void SnapshotArchive::require(size_t size) const
+{
+    if (static_cast<size_t>(mEnd - mCurrent) < size)
+    {
+        throw except::Exception(Ctxt("Metadata snapshot is truncated"));
+    }
+}
+
+void SnapshotArchive::outOfRange()
+{
+    throw except::Exception(Ctxt(
+            "Metadata snapshot has a value out of range"));
+}
+
+size_t SnapshotArchive::count(size_t size)
+{
+    if (size > std::numeric_limits<uint32_t>::max())
+    {
+        throw except::Exception(Ctxt(
+                "Metadata is too large for a snapshot"));
+    }
+    auto count = static_cast<uint32_t>(size);
+    if (isReading())
+    {
+        require(sizeof(count));
+        deserialize(mCurrent, mSwapBytes, count);
+
+        // Every element takes at least a byte, so this rejects a corrupt
+        // count before anything is allocated for it
+        require(count);
+    }
+    else
+    {
+        serialize(count, mSwapBytes, *mBuffer);
+    }
+    return count;
+}
+
+void SnapshotArchive::boolean(bool& v)
+{
+    if (isReading())
+    {
+        require(1);
+        const auto byte = static_cast<uint8_t>(*mCurrent++);
+        if (byte > 1)
+        {
+            outOfRange();
+        }
+        v = byte != 0;
+    }
+    else
+    {
+        mBuffer->push_back(static_cast<std::byte>(v ? 1 : 0));
+    }
+}
+
+void SnapshotArchive::real(double& v)
+{
+    if (isReading())
+    {
+        require(sizeof(v));
+        deserialize(mCurrent, mSwapBytes, v);
+    }
+    else
+    {
+        serialize(v, mSwapBytes, *mBuffer);
+    }
+}
+
+void SnapshotArchive::real(float& v)
+{
+    if (isReading())
+    {
+        require(sizeof(v));
+        deserialize(mCurrent, mSwapBytes, v);
+    }
+    else
+    {
+        serialize(v, mSwapBytes, *mBuffer);
+    }
+}
+
+void SnapshotArchive::value(std::vector<unsigned char>& bytes)
+{
+    const size_t size = count(bytes.size());
+    if (isReading())
+    {
+        const auto* const data = reinterpret_cast<const unsigned char*>(mCurrent);
+        bytes.assign(data, data + size);
+        mCurrent += size;
+    }
+    else
+    {
+        const auto* const data = reinterpret_cast<const std::byte*>(bytes.data());
+        mBuffer->insert(mBuffer->end(), data, data + size);
+    }
+}
+
+void SnapshotArchive::value(std::string& v)
+{
+    const size_t size = count(v.size());
+    if (isReading())
+    {
+        const auto* const data = reinterpret_cast<const char*>(mCurrent);
+        v.assign(data, data + size);
+        mCurrent += size;
+    }
+    else
+    {
+        const auto* const data = reinterpret_cast<const std::byte*>(v.data());
+        mBuffer->insert(mBuffer->end(), data, data + size);
+    }
+}
+
+void SnapshotArchive::value(str::EncodedString& v)
+{
+    const coda_oss::u8string u8 = v.u8string();
+    std::string s(reinterpret_cast<const char*>(u8.data()), u8.size());
+    value(s);
+    if (isReading())
+    {
+        v = str::EncodedString(
+                reinterpret_cast<coda_oss::u8string::const_pointer>(s.data()),
+                s.size());
+    }
+}
+
+void SnapshotArchive::value(DateTime& v)
+{
+    double millis = v.getTimeInMillis();
+    real(millis);
+    if (isReading())
+    {
+        v = DateTime(millis);
+    }
+}
+
+void SnapshotArchive::value(LatLon& v)
+{
+    double lat = v.getLat();
+    double lon = v.getLon();
+    (*this)(lat, lon);
+    v.setLat(lat);
+    v.setLon(lon);
+}
+
+void SnapshotArchive::value(LatLonAlt& v)
+{
+    double lat = v.getLat();
+    double lon = v.getLon();
+    double alt = v.getAlt();
+    (*this)(lat, lon, alt);
+    v.setLat(lat);
+    v.setLon(lon);
+    v.setAlt(alt);
+}
+
+void SnapshotArchive::value(AngleMagnitude& v)
+{
+    (*this)(v.angle, v.magnitude);
+}
+
+void SnapshotArchive::value(FrameType& v)
+{
+    (*this)(v.mValue);
+}
+
+void snapshot(SnapshotArchive& archive, DecorrType& decorr)
+{
+    archive(decorr.corrCoefZero, decorr.decorrRate);
+}
+
+void snapshot(SnapshotArchive& archive, ReferencePoint& referencePoint)
+{
+    archive(referencePoint.ecef, referencePoint.rowCol, referencePoint.name);
+}
+
+void snapshot(SnapshotArchive& archive, SCP& scp)
+{
+    archive(scp.ecf, scp.llh);
+}
+
+void snapshot(SnapshotArchive& archive, Parameter& parameter)
+{
+    std::string name = parameter.getName();
+    std::string value = parameter.str();
+    archive(name, value);
+    if (archive.isReading())
+    {
+        parameter.setName(name);
+        parameter.setValue(value);
+    }
+}
+
+void snapshot(SnapshotArchive& archive, ParameterCollection& parameters)
+{
+    const size_t size = archive.count(parameters.size());
+    if (archive.isReading())
+    {
+        parameters = ParameterCollection();
+        for (size_t ii = 0; ii < size; ++ii)
+        {
+            parameters.push_back(Parameter());
+        }
+    }
+    for (auto& parameter : parameters)
+    {
+        archive(parameter);
+    }
+}
+
+void snapshot(SnapshotArchive& archive,
+              CollectionInformation& collectionInformation)
+{
+    archive(collectionInformation.collectorName,
+            collectionInformation.illuminatorName,
+            collectionInformation.coreName,
+            collectionInformation.collectType,
+            collectionInformation.radarMode,
+            collectionInformation.radarModeID,
+            collectionInformation.releaseInfo,
+            collectionInformation.countryCodes,
+            collectionInformation.parameters);
+
+    str::EncodedString classification;
+    collectionInformation.getClassificationLevel(classification);
+    archive(classification);
+    collectionInformation.setClassificationLevel(classification);
+}
+
+void snapshot(SnapshotArchive& archive, GeoInfo& geoInfo)
+{
+    archive(geoInfo.name, geoInfo.geoInfos, geoInfo.desc,
+            geoInfo.geometryLatLon);
+}
+
+void snapshot(SnapshotArchive& archive, GeoDataBase& geoData)
+{
+    archive(geoData.earthModel, geoData.imageCorners, geoData.validData,
+            geoData.geoInfos);
+}
+
+void snapshot(SnapshotArchive& archive, NoiseLevel& noiseLevel)
+{
+    archive(noiseLevel.noiseType, noiseLevel.noisePoly);
+}
+
+void snapshot(SnapshotArchive& archive, Radiometric& radiometric)
+{
+    archive(radiometric.noiseLevel,
+            radiometric.rcsSFPoly,
+            radiometric.betaZeroSFPoly,
+            radiometric.sigmaZeroSFPoly,
+            radiometric.sigmaZeroSFIncidenceMap,
+            radiometric.gammaZeroSFPoly,
+            radiometric.gammaZeroSFIncidenceMap);
+}
+
+void snapshot(SnapshotArchive& archive, MatchCollect& matchCollect)
+{
+    archive(matchCollect.coreName, matchCollect.matchIndex,
+            matchCollect.parameters);
+}
+
+void snapshot(SnapshotArchive& archive, MatchType& matchType)
+{
+    archive(matchType.collectorName,
+            matchType.illuminatorName,
+            matchType.matchType,
+            matchType.typeID,
+            matchType.currentIndex,
+            matchType.matchCollects);
+}
+
+void snapshot(SnapshotArchive& archive, MatchInformation& matchInformation)
+{
+    archive(matchInformation.types);
+}
+
+void snapshot(SnapshotArchive& archive, CorrCoefs& corrCoefs)
+{
+    archive(corrCoefs.p1p2, corrCoefs.p1p3, corrCoefs.p1v1, corrCoefs.p1v2,
+            corrCoefs.p1v3, corrCoefs.p2p3, corrCoefs.p2v1, corrCoefs.p2v2,
+            corrCoefs.p2v3, corrCoefs.p3v1, corrCoefs.p3v2, corrCoefs.p3v3,
+            corrCoefs.v1v2, corrCoefs.v1v3, corrCoefs.v2v3);
+}
+
+void snapshot(SnapshotArchive& archive, PosVelError& posVelError)
+{
+    archive(posVelError.frame,
+            posVelError.p1, posVelError.p2, posVelError.p3,
+            posVelError.v1, posVelError.v2, posVelError.v3,
+            posVelError.corrCoefs,
+            posVelError.positionDecorr);
+}
+
+void snapshot(SnapshotArchive& archive, RadarSensor& radarSensor)
+{
+    archive(radarSensor.rangeBias, radarSensor.clockFreqSF,
+            radarSensor.transmitFreqSF, radarSensor.rangeBiasDecorr);
+}
+
+void snapshot(SnapshotArchive& archive, TropoError& tropoError)
+{
+    archive(tropoError.tropoRangeVertical, tropoError.tropoRangeSlant,
+            tropoError.tropoRangeDecorr);
+}
+
+void snapshot(SnapshotArchive& archive, IonoError& ionoError)
+{
+    archive(ionoError.ionoRangeVertical, ionoError.ionoRangeRateVertical,
+            ionoError.ionoRgRgRateCC, ionoError.ionoRangeVertDecorr);
+}
+
+void snapshot(SnapshotArchive& archive, UnmodeledS& unmodeled)
+{
+    archive(unmodeled.Xrow, unmodeled.Ycol, unmodeled.XrowYcol,
+            unmodeled.UnmodeledDecorr);
+}
+
+void snapshot(SnapshotArchive& archive, UnmodeledS::Decorr& decorr)
+{
+    archive(decorr.Xrow, decorr.Ycol);
+}
+
+void snapshot(SnapshotArchive& archive,
+              UnmodeledS::Decorr::Xrow_Ycol& xrowYcol)
+{
+    archive(xrowYcol.CorrCoefZero, xrowYcol.DecorrRate);
+}
+
+void snapshot(SnapshotArchive& archive, Components& components)
+{
+    archive(components.posVelError, components.radarSensor,
+            components.tropoError, components.ionoError);
+}
+
+void snapshot(SnapshotArchive& archive, CompositeSCP& compositeSCP)
+{
+    archive(compositeSCP.scpType, compositeSCP.xErr, compositeSCP.yErr,
+            compositeSCP.xyErr);
+}
+
+void snapshot(SnapshotArchive& archive, ErrorStatistics& errorStatistics)
+{
+    archive(errorStatistics.compositeSCP,
+            errorStatistics.components,
+            errorStatistics.Unmodeled,
+            errorStatistics.additionalParameters);
+}
+
+void snapshot(SnapshotArchive& archive, AmplitudeTable& amplitudeTable)
+{
+    // The entries are doubles in native byte order, so they're written as
+    // numbers rather than as the LUT's bytes
+    for (size_t ii = 0; ii < amplitudeTable.size(); ++ii)
+    {
+        archive(amplitudeTable.index(ii));
+    }
+}
+
+// LUTs have no default constructor, so they're read whole
+static LUT readLUT(SnapshotArchive& archive)
+{
+    size_t numEntries = 0;
+    size_t elementSize = 0;
+    std::vector<unsigned char> table;
+    archive(numEntries, elementSize, table);
+    if (elementSize == 0 || table.size() % elementSize != 0 ||
+        table.size() / elementSize != numEntries)
+    {
+        throw except::Exception(Ctxt(
+                "Metadata snapshot has a LUT of the wrong size"));
+    }
+    return LUT(table.data(), numEntries, elementSize);
+}
+
+void snapshot(SnapshotArchive& archive, mem::ScopedCopyablePtr<LUT>& lut)
+{
+    if (!archive.transfer(lut.get() != nullptr))
+    {
+        lut.reset();
+    }
+    else if (archive.isReading())
+    {
+        lut.reset(new LUT(readLUT(archive)));
+    }
+    else
+    {
+        archive(lut->numEntries, lut->elementSize, lut->table);
+    }
+}
+
+void snapshot(SnapshotArchive& archive, std::vector<LUT>& luts)
+{
+    const size_t size = archive.count(luts.size());
+    if (archive.isReading())
+    {
+        luts.clear();
+        for (size_t ii = 0; ii < size; ++ii)
+        {
+            luts.push_back(readLUT(archive));
+        }
+    }
+    else
+    {
+        for (auto& lut : luts)
+        {
+            archive(lut.numEntries, lut.elementSize, lut.table);
+        }
+    }
+}
+}
@@ -95,6 +95,8 @@ six::PixelType getPixelType(const nitf::ImageSubheader& subheader)
 
 namespace six
 {
+const char NITFReadControl::OPT_METADATA_ONLY[] = "MetadataOnly";
+
 NITFReadControl::NITFReadControl(FILE* log)
 {
     // Make sure that if we use XML_DATA_CONTENT that we've loaded it into the
@@ -319,12 +321,23 @@ inline std::unique_ptr<Data> parseData_(const XMLControlRegistry& xmlReg,
     return six::parseData(xmlReg, xmlStream, dataType, pSchemaPaths, log);
 }
 
+bool NITFReadControl::isMetadataOnly() const
+{
+    const int metadataOnly = getOptions().getParameter(
+            OPT_METADATA_ONLY, Parameter(0));
+    return metadataOnly != 0;
+}
+
 template<typename TSchemaPath>
 void NITFReadControl::load_(std::shared_ptr<nitf::IOInterface> ioInterface, const std::vector<TSchemaPath>* pSchemaPaths)
 {
     reset();
     mInterface = ioInterface;
 
+    // Nothing we need is in a TRE, so don't spend time parsing them all
+    const bool metadataOnly = isMetadataOnly();
+    mReader.setParseTREs(!metadataOnly);
+
     mRecord = mReader.readIO(*ioInterface);
     const DataType dataType = getDataType(mRecord);
     mContainer.reset(new Container(dataType));
@@ -346,11 +359,8 @@ void NITFReadControl::load_(std::shared_ptr<nitf::IOInterface> ioInterface, cons
         else
         {
             SegmentInputStreamAdapter ioAdapter(deReader);
-            std::unique_ptr<Data> data(parseData_(*mXMLRegistry,
-                                               ioAdapter,
-                                               dataType,
-                                               pSchemaPaths,
-                                               *mLog));
+            std::unique_ptr<Data> data(parseData_(*mXMLRegistry, ioAdapter,
+                    dataType, pSchemaPaths, *mLog));
             if (data.get() == nullptr)
             {
                 throw except::Exception(Ctxt("Unable to transform XML DES"));
@@ -362,7 +372,13 @@ void NITFReadControl::load_(std::shared_ptr<nitf::IOInterface> ioInterface, cons
 
             if (data->getDataType() == six::DataType::DERIVED)
             {
-                mContainer->addData(std::move(data), findLegend(gsl::narrow<size_t>(productNum)));
+                // Reading a legend means reading its pixels
+                std::unique_ptr<Legend> legend;
+                if (!metadataOnly)
+                {
+                    legend = findLegend(gsl::narrow<size_t>(productNum));
+                }
+                mContainer->addData(std::move(data), std::move(legend));
             }
             else if (data->getDataType() == six::DataType::COMPLEX)
             {
@@ -383,6 +399,14 @@ void NITFReadControl::load_(std::shared_ptr<nitf::IOInterface> ioInterface, cons
     }
 
     mInfos = getImageInfos(*mContainer);
+    if (!metadataOnly)
+    {
+        loadImageSegments();
+    }
+}
+
+void NITFReadControl::loadImageSegments()
+{
     auto images_ = mRecord.getImages();
     const auto& images = images_;
 
@@ -464,6 +488,7 @@ void NITFReadControl::load_(std::shared_ptr<nitf::IOInterface> ioInterface, cons
         }
         currentInfo->addSegment(si);
     }
+    mImageSegmentsLoaded = true;
 }
 void NITFReadControl::load(std::shared_ptr<nitf::IOInterface> ioInterface, const std::vector<std::string>* pSchemaPaths_)
 {
@@ -613,6 +638,15 @@ void NITFReadControl::getIndices(const nitf::ImageSubheader& subheader, ImageAnd
 
 UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
 {
+    {
+        // Several threads may be reading regions at once
+        std::lock_guard<std::mutex> lock(mImageSegmentsMutex);
+        if (!mImageSegmentsLoaded)
+        {
+            loadImageSegments();
+        }
+    }
+
     const NITFImageInfo& thisImage = *(mInfos[imageNumber]);
 
     const types::RowCol<ptrdiff_t> imageExtent(getExtent(thisImage.getData()));
@@ -788,6 +822,7 @@ void NITFReadControl::reset()
         delete mInfos[ii];
     }
     mInfos.clear();
+    mImageSegmentsLoaded = false;
     mInterface.reset();
 }
 
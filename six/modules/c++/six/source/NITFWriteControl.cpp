@@ -38,10 +38,13 @@
 
 #include <six/XMLControlFactory.h>
 #include <nitf/IOStreamWriter.hpp>
+#include <sys/OS.h>
 
 
 namespace six
 {
+const char NITFWriteControl::OPT_NUM_BLOCKING_THREADS[] = "NumBlockingThreads";
+
 NITFWriteControl::NITFWriteControl(FILE* log/* = stderr*/)
 {
     mNITFHeaderCreator.reset(new six::NITFHeaderCreator(log));
@@ -391,6 +394,48 @@ void writeWithNitro(nitf::Writer& mWriter, const std::map<std::string, void*>& m
     }
 }
 
+inline const std::byte* image_bytes(BufferList::value_type pImageData)
+{
+    const void* pImageData_ = pImageData;
+    return static_cast<const std::byte*>(pImageData_);
+}
+template<typename T>
+inline const std::byte* image_bytes(std::span<const T> imageData)
+{
+    return six::as_bytes(imageData).data();
+}
+
+template<typename TImageData>
+void writeBlockedInParallel(nitf::Writer& mWriter, nitf::Record record, const TImageData& imageData,
+    const std::vector<NITFSegmentInfo>& imageSegments, size_t startIndex, const Data& data, bool doByteSwap,
+    size_t numThreads)
+{
+    for (size_t jj = 0; jj < imageSegments.size(); ++jj)
+    {
+        const auto imageNumber = static_cast<int>(startIndex + jj);
+        nitf::ImageSubheader subheader = nitf::ImageSegment(record.getImages()[imageNumber]).getSubheader();
+        const types::RowCol<size_t> blockDims(subheader.numPixelsPerVertBlock(),
+                                              subheader.numPixelsPerHorizBlock());
+
+        auto writeHandler = std::make_shared<BlockedMemoryWriteHandler>(imageSegments[jj],
+            image_bytes(imageData), data, blockDims, doByteSwap, numThreads);
+        mWriter.setImageWriteHandler(imageNumber, writeHandler);
+    }
+}
+
+bool NITFWriteControl::useParallelBlocking(bool isBlocking, bool enableJ2K) const
+{
+    // Compression happens inside NITRO's ImageWriter
+    return isBlocking && !enableJ2K && mCompressionOptions.empty() &&
+        getOptions().hasParameter(OPT_NUM_BLOCKING_THREADS);
+}
+
+size_t NITFWriteControl::getNumBlockingThreads() const
+{
+    const size_t numThreads = getOptions().getParameter(OPT_NUM_BLOCKING_THREADS);
+    return numThreads == 0 ? sys::OS().getNumCPUs() : numThreads;
+}
+
 static const Legend* getLegend(const six::Container* container, size_t i)
 {
     const auto legend = container->getLegend(i);
@@ -459,7 +504,15 @@ void NITFWriteControl::write_imageData(const T& imageData, const NITFImageInfo&
             throw except::Exception(Ctxt("SICD does not support blocked or J2K compressed output"));
         }
 
-        writeWithNitro(mWriter, mCompressionOptions, imageData, imageSegments, startIndex, *pData);
+        if (useParallelBlocking(isBlocking, enableJ2K))
+        {
+            writeBlockedInParallel(mWriter, getRecord(), imageData, imageSegments, startIndex, *pData,
+                doByteSwap, getNumBlockingThreads());
+        }
+        else
+        {
+            writeWithNitro(mWriter, mCompressionOptions, imageData, imageSegments, startIndex, *pData);
+        }
     }
     else
     {
@@ -0,0 +1,243 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/NumericConversion.h>
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits>
+#include <typeinfo>
+#include <vector>
+
+#include <except/Exception.h>
+#include <sys/Conf.h>
+
+namespace
+{
+// Large enough for any double at up to 17 digits of precision
+constexpr size_t BUFFER_SIZE = 64;
+
+const char* getDecimalPoint()
+{
+    const char* const decimalPoint = localeconv()->decimal_point;
+    return (decimalPoint && *decimalPoint) ? decimalPoint : ".";
+}
+
+bool isDefaultDecimalPoint(const char* decimalPoint)
+{
+    return decimalPoint[0] == '.' && decimalPoint[1] == '\0';
+}
+
+// printf() uses the C locale's decimal point, which streams (and XML) don't
+void replaceDecimalPoint(std::string& s)
+{
+    const char* const decimalPoint = getDecimalPoint();
+    if (!isDefaultDecimalPoint(decimalPoint))
+    {
+        const size_t pos = s.find(decimalPoint);
+        if (pos != std::string::npos)
+        {
+            s.replace(pos, strlen(decimalPoint), ".");
+        }
+    }
+}
+
+std::string format(const char* format, double value, int precision)
+{
+    char buffer[BUFFER_SIZE];
+    const int length = snprintf(buffer, sizeof(buffer), format, precision,
+                                value);
+    if (length < 0)
+    {
+        throw except::Exception(Ctxt("Unable to format value"));
+    }
+
+    std::string result;
+    if (static_cast<size_t>(length) < sizeof(buffer))
+    {
+        result.assign(buffer, length);
+    }
+    else
+    {
+        std::vector<char> bigBuffer(length + 1);
+        snprintf(bigBuffer.data(), bigBuffer.size(), format, precision, value);
+        result.assign(bigBuffer.data(), length);
+    }
+
+    replaceDecimalPoint(result);
+    return result;
+}
+
+bool isSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Same message as str::toType()
+template <typename T>
+except::BadCastException conversionFailed(const std::string& s)
+{
+    return except::BadCastException(Ctxt(
+            "Conversion failed: '" + s + "' -> " + typeid(T).name()));
+}
+
+/*
+ * Follows std::num_get: take the longest prefix that looks like a
+ * decimal number, then fail unless all of it converts.  strtod() on its
+ * own would also accept hex, "inf" and "nan", and overflows to infinity
+ * rather than failing.
+ */
+template <typename T, typename StrToT>
+T parse(const std::string& s, StrToT strToT)
+{
+    if (s.empty())
+    {
+        throw except::BadCastException(Ctxt("Empty string"));
+    }
+
+    const char* pos = s.c_str();
+    const char* const end = pos + s.size();
+    while (pos != end && isSpace(*pos))
+    {
+        ++pos;
+    }
+
+    const char* const begin = pos;
+    if (pos != end && (*pos == '+' || *pos == '-'))
+    {
+        ++pos;
+    }
+
+    bool foundMantissa = false;
+    bool foundDecimal = false;
+    bool foundExponent = false;
+    bool foundExponentDigits = false;
+    while (pos != end)
+    {
+        const char c = *pos;
+        if (isDigit(c))
+        {
+            foundMantissa = true;
+            foundExponentDigits = foundExponent;
+        }
+        else if (c == '.' && !foundDecimal && !foundExponent)
+        {
+            foundDecimal = true;
+        }
+        else if ((c == 'e' || c == 'E') && foundMantissa && !foundExponent)
+        {
+            foundExponent = true;
+            if (pos + 1 != end && (pos[1] == '+' || pos[1] == '-'))
+            {
+                ++pos;
+            }
+        }
+        else
+        {
+            break;
+        }
+        ++pos;
+    }
+
+    if (!foundMantissa || (foundExponent && !foundExponentDigits))
+    {
+        throw conversionFailed<T>(s);
+    }
+
+    // strtod() needs the number by itself, using the locale's decimal point
+    const size_t length = pos - begin;
+    char buffer[BUFFER_SIZE];
+    std::vector<char> bigBuffer;
+    char* number = buffer;
+    const char* const decimalPoint = getDecimalPoint();
+    const size_t decimalLength = strlen(decimalPoint);
+    const size_t numberLength = length + decimalLength;
+    if (numberLength >= sizeof(buffer))
+    {
+        bigBuffer.resize(numberLength + 1);
+        number = bigBuffer.data();
+    }
+
+    char* out = number;
+    for (const char* in = begin; in != pos; ++in)
+    {
+        if (*in == '.')
+        {
+            memcpy(out, decimalPoint, decimalLength);
+            out += decimalLength;
+        }
+        else
+        {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+
+    char* numberEnd = nullptr;
+    const T value = strToT(number, &numberEnd);
+    if (numberEnd != out ||
+        value == std::numeric_limits<T>::infinity() ||
+        value == -std::numeric_limits<T>::infinity())
+    {
+        throw conversionFailed<T>(s);
+    }
+    return value;
+}
+}
+
+namespace six
+{
+std::string toScientificString(double value, int precision)
+{
+    std::string result = format("%.*E", value, precision);
+
+    // remove any + in scientific notation to meet SICD XML standard
+    const size_t plusPos = result.find('+');
+    if (plusPos != std::string::npos)
+    {
+        result.erase(plusPos, 1);
+    }
+    return result;
+}
+
+std::string toGeneralString(double value, int precision)
+{
+    return format("%.*g", value, precision);
+}
+
+double parseDouble(const std::string& s)
+{
+    return parse<double>(s, strtod);
+}
+
+float parseFloat(const std::string& s)
+{
+    return parse<float>(s, strtof);
+}
+}
@@ -0,0 +1,438 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include <sys/Conf.h>
+#include <nitf/BufferedWriter.hpp>
+#include <six/Adapters.h>
+#include <six/RegionWriteControl.h>
+
+namespace
+{
+// Largest write of byte swapped whole rows
+constexpr size_t WRITE_CHUNK_BYTES = 4 * 1024 * 1024;
+
+inline size_t ceilingDivide(size_t numerator, size_t denominator)
+{
+    return (numerator + denominator - 1) / denominator;
+}
+}
+
+namespace six
+{
+RegionWriteControl::RegionWriteControl(
+        const std::string& outputPathname,
+        const std::vector<std::string>& schemaPaths) :
+    mIO(new nitf::BufferedWriter(outputPathname,
+                                 NITFHeaderCreator::DEFAULT_BUFFER_SIZE)),
+    mSchemaPaths(schemaPaths),
+    mDoByteSwap(false),
+    mHaveWrittenHeaders(false),
+    mClosed(false)
+{
+}
+
+RegionWriteControl::~RegionWriteControl()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void RegionWriteControl::writeHeaders()
+{
+    mDoByteSwap = shouldByteSwap();
+
+    nitf::Record& record = getRecord();
+    mWriter.prepareIO(*mIO, record);
+
+    const auto infos = getInfos();
+    mProducts.clear();
+    mProducts.resize(infos.size());
+    for (size_t ii = 0; ii < infos.size(); ++ii)
+    {
+        const NITFImageInfo& info = *infos[ii];
+        const Data& data = *info.getData();
+        Product& product = mProducts[ii];
+        product.dims = types::RowCol<size_t>(data.getNumRows(),
+                                             data.getNumCols());
+        product.pixelSize = data.getNumBytesPerPixel();
+        product.elemSize = product.pixelSize / data.getNumChannels();
+
+        const std::vector<NITFSegmentInfo> segments = info.getImageSegments();
+        product.segments.resize(segments.size());
+        for (size_t jj = 0; jj < segments.size(); ++jj)
+        {
+            Segment& segment = product.segments[jj];
+            segment.info = segments[jj];
+
+            nitf::ImageSegment imageSegment =
+                    record.getImages()[info.getStartIndex() + jj];
+            nitf::ImageSubheader subheader = imageSegment.getSubheader();
+            if (subheader.imageCompressionString() != "NC")
+            {
+                throw except::Exception(Ctxt(
+                        "Compressed images can't be written by region"));
+            }
+
+            // Blocks are never bigger than the segment
+            const size_t numRows = segment.info.getNumRows();
+            const size_t numRowsPerBlock = subheader.numPixelsPerVertBlock();
+            const size_t numColsPerBlock = subheader.numPixelsPerHorizBlock();
+            segment.blockDims.row = numRowsPerBlock == 0 ?
+                    numRows : std::min(numRowsPerBlock, numRows);
+            segment.blockDims.col = numColsPerBlock == 0 ?
+                    product.dims.col :
+                    std::min(numColsPerBlock, product.dims.col);
+
+            segment.numBlocksPerRow =
+                    ceilingDivide(product.dims.col, segment.blockDims.col);
+            segment.numBlockRows =
+                    ceilingDivide(numRows, segment.blockDims.row);
+            segment.blockRowBytes = segment.numBlocksPerRow *
+                    segment.blockDims.area() * product.pixelSize;
+            segment.written.assign(segment.numBlockRows, false);
+        }
+    }
+
+    // The handlers point at the segments, which don't move from here on
+    for (size_t ii = 0; ii < mProducts.size(); ++ii)
+    {
+        const auto startIndex = infos[ii]->getStartIndex();
+        std::vector<Segment>& segments = mProducts[ii].segments;
+        for (size_t jj = 0; jj < segments.size(); ++jj)
+        {
+            Segment& segment = segments[jj];
+            auto writeHandler = std::make_shared<ReservedWriteHandler>(
+                    segment.numBlockRows * segment.blockRowBytes,
+                    segment.dataStart);
+            mWriter.setImageWriteHandler(static_cast<int>(startIndex + jj),
+                                         writeHandler);
+        }
+
+        const Legend* const legend = getContainer()->getLegend(ii);
+        if (legend)
+        {
+            addLegend(*legend, static_cast<int>(startIndex + segments.size()));
+        }
+    }
+
+    addDataAndWrite(mSchemaPaths);
+}
+
+void RegionWriteControl::save(const void* imageData,
+                              const types::RowCol<size_t>& offset,
+                              const types::RowCol<size_t>& dims,
+                              size_t imageNumber)
+{
+    if (getContainer().get() == nullptr)
+    {
+        throw except::Exception(Ctxt(
+                "initialize() must be called prior to calling save()"));
+    }
+    if (mClosed)
+    {
+        throw except::Exception(Ctxt("The file has already been closed"));
+    }
+
+    // The first time through we'll write out all the headers
+    if (!mHaveWrittenHeaders)
+    {
+        writeHeaders();
+        mHaveWrittenHeaders = true;
+    }
+
+    if (imageNumber >= mProducts.size())
+    {
+        throw except::Exception(Ctxt(
+                "Image number " + std::to_string(imageNumber) +
+                " is out of range"));
+    }
+    Product& product = mProducts[imageNumber];
+
+    if (offset.row + dims.row > product.dims.row ||
+        offset.col + dims.col > product.dims.col)
+    {
+        throw except::Exception(Ctxt(
+                "Region is outside of image " + std::to_string(imageNumber)));
+    }
+
+    for (auto& segment : product.segments)
+    {
+        // See if we're in this segment
+        size_t startGlobalRowToWrite;
+        size_t numRowsToWrite;
+        if (segment.info.isInRange(offset.row, dims.row,
+                                   startGlobalRowToWrite,
+                                   numRowsToWrite))
+        {
+            const std::byte* const segmentData =
+                    static_cast<const std::byte*>(imageData) +
+                    (startGlobalRowToWrite - offset.row) * dims.col *
+                            product.pixelSize;
+            const size_t segmentRow =
+                    startGlobalRowToWrite - segment.info.getFirstRow();
+            const types::RowCol<size_t> segmentDims(numRowsToWrite,
+                                                    dims.col);
+
+            // When blocks span every column, the file's rows are the
+            // image's rows (padded out to a whole number of blocks)
+            if (segment.numBlocksPerRow == 1)
+            {
+                writeRows(product, segment, segmentData, segmentRow,
+                          offset.col, segmentDims);
+            }
+            else
+            {
+                bufferRows(product, segment, segmentData, segmentRow,
+                           offset.col, segmentDims);
+            }
+        }
+    }
+}
+
+void RegionWriteControl::writeRows(const Product& product,
+                                   const Segment& segment,
+                                   const std::byte* imageData,
+                                   size_t segmentRow,
+                                   size_t col,
+                                   const types::RowCol<size_t>& dims)
+{
+    const size_t numBytesPerRow = dims.col * product.pixelSize;
+    const size_t rowSeekStride = product.dims.col * product.pixelSize;
+    const nitf::Off byteOffset = segment.dataStart + static_cast<nitf::Off>(
+            segmentRow * rowSeekStride + col * product.pixelSize);
+
+    if (dims.col == product.dims.col)
+    {
+        // Life is easy - the rows are contiguous
+        mIO->seek(byteOffset, NITF_SEEK_SET);
+        if (!mDoByteSwap)
+        {
+            mIO->write(imageData, dims.row * numBytesPerRow);
+            return;
+        }
+
+        const size_t numRowsPerChunk =
+                std::max<size_t>(WRITE_CHUNK_BYTES / numBytesPerRow, 1);
+        for (size_t row = 0; row < dims.row; row += numRowsPerChunk)
+        {
+            const size_t numRows = std::min(numRowsPerChunk, dims.row - row);
+            const std::byte* const chunk = imageData + row * numBytesPerRow;
+            mScratch.assign(chunk, chunk + numRows * numBytesPerRow);
+            byteSwap(product, mScratch.data(), numRows * dims.col);
+            mIO->write(mScratch.data(), mScratch.size());
+        }
+        return;
+    }
+
+    // Need to write out partial rows
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        const std::byte* rowData = imageData + row * numBytesPerRow;
+        if (mDoByteSwap)
+        {
+            mScratch.assign(rowData, rowData + numBytesPerRow);
+            byteSwap(product, mScratch.data(), dims.col);
+            rowData = mScratch.data();
+        }
+
+        mIO->seek(byteOffset + static_cast<nitf::Off>(row * rowSeekStride),
+                  NITF_SEEK_SET);
+        mIO->write(rowData, numBytesPerRow);
+    }
+}
+
+void RegionWriteControl::bufferRows(const Product& product,
+                                    Segment& segment,
+                                    const std::byte* imageData,
+                                    size_t segmentRow,
+                                    size_t col,
+                                    const types::RowCol<size_t>& dims)
+{
+    const types::RowCol<size_t>& blockDims = segment.blockDims;
+    const size_t pixelSize = product.pixelSize;
+    const size_t numBytesPerBlock = blockDims.area() * pixelSize;
+    const size_t endRow = segmentRow + dims.row;
+    const size_t endCol = col + dims.col;
+    const size_t firstBlockCol = col / blockDims.col;
+    const size_t endBlockCol = ceilingDivide(endCol, blockDims.col);
+    const size_t firstBlockRow = segmentRow / blockDims.row;
+    const size_t endBlockRow = ceilingDivide(endRow, blockDims.row);
+
+    // A written block row is gone; holding it again would zero the rest of
+    // it when it's next written
+    for (size_t blockRow = firstBlockRow; blockRow < endBlockRow; ++blockRow)
+    {
+        if (segment.written[blockRow])
+        {
+            throw except::Exception(Ctxt(
+                    "Block row " + std::to_string(blockRow) +
+                    " has already been written"));
+        }
+    }
+
+    for (size_t blockRow = firstBlockRow; blockRow < endBlockRow; ++blockRow)
+    {
+        const size_t blockStartRow = blockRow * blockDims.row;
+        const size_t startRow = std::max(segmentRow, blockStartRow);
+        const size_t stopRow = std::min(endRow, blockStartRow + blockDims.row);
+
+        // The final block row is short of pixels by its pad rows
+        const size_t numRowsInBlockRow =
+                std::min(blockStartRow + blockDims.row,
+                         segment.info.getNumRows()) - blockStartRow;
+        const size_t numPixelsInBlockRow =
+                numRowsInBlockRow * product.dims.col;
+
+        BlockRow& pending = segment.pending[blockRow];
+        if (pending.pixels.empty())
+        {
+            // Zeros are the pad pixels of partial blocks
+            pending.pixels.resize(segment.blockRowBytes);
+            pending.saved.resize(numPixelsInBlockRow);
+        }
+
+        // Check before copying so the block row isn't left half saved
+        for (size_t row = startRow; row < stopRow; ++row)
+        {
+            const auto rowSaved = pending.saved.begin() +
+                    (row - blockStartRow) * product.dims.col;
+            if (std::find(rowSaved + col, rowSaved + endCol, true) !=
+                rowSaved + endCol)
+            {
+                throw except::Exception(Ctxt(
+                        "Pixels in block row " + std::to_string(blockRow) +
+                        " were saved more than once"));
+            }
+        }
+
+        for (size_t row = startRow; row < stopRow; ++row)
+        {
+            const std::byte* const rowData =
+                    imageData + (row - segmentRow) * dims.col * pixelSize;
+            for (size_t blockCol = firstBlockCol; blockCol < endBlockCol;
+                 ++blockCol)
+            {
+                const size_t blockStartCol = blockCol * blockDims.col;
+                const size_t startCol = std::max(col, blockStartCol);
+                const size_t stopCol =
+                        std::min(endCol, blockStartCol + blockDims.col);
+                const size_t numPixels = stopCol - startCol;
+
+                std::byte* const dest = pending.pixels.data() +
+                        blockCol * numBytesPerBlock +
+                        ((row - blockStartRow) * blockDims.col +
+                         startCol - blockStartCol) * pixelSize;
+                memcpy(dest, rowData + (startCol - col) * pixelSize,
+                       numPixels * pixelSize);
+                byteSwap(product, dest, numPixels);
+            }
+
+            const auto rowSaved = pending.saved.begin() +
+                    (row - blockStartRow) * product.dims.col;
+            std::fill(rowSaved + col, rowSaved + endCol, true);
+        }
+
+        pending.numPixels += (stopRow - startRow) * dims.col;
+        if (pending.numPixels == numPixelsInBlockRow)
+        {
+            writeBlockRow(segment, blockRow, pending);
+            segment.pending.erase(blockRow);
+            segment.written[blockRow] = true;
+        }
+    }
+}
+
+void RegionWriteControl::writeBlockRow(const Segment& segment,
+                                       size_t blockRow,
+                                       const BlockRow& pixels)
+{
+    mIO->seek(segment.dataStart +
+                      static_cast<nitf::Off>(blockRow * segment.blockRowBytes),
+              NITF_SEEK_SET);
+    mIO->write(pixels.pixels.data(), pixels.pixels.size());
+}
+
+void RegionWriteControl::byteSwap(const Product& product,
+                                  std::byte* pixels,
+                                  size_t numPixels) const
+{
+    // Dont do it if we only have a byte!
+    if (mDoByteSwap && product.elemSize > 1)
+    {
+        sys::byteSwap(pixels,
+                      static_cast<unsigned short>(product.elemSize),
+                      numPixels * product.pixelSize / product.elemSize);
+    }
+}
+
+size_t RegionWriteControl::getNumPendingBlockRows() const
+{
+    size_t numBlockRows = 0;
+    for (const auto& product : mProducts)
+    {
+        for (const auto& segment : product.segments)
+        {
+            numBlockRows += segment.pending.size();
+        }
+    }
+    return numBlockRows;
+}
+
+void RegionWriteControl::close()
+{
+    if (mClosed)
+    {
+        return;
+    }
+    mClosed = true;
+
+    if (!mHaveWrittenHeaders && getContainer().get() != nullptr)
+    {
+        writeHeaders();
+        mHaveWrittenHeaders = true;
+    }
+
+    for (auto& product : mProducts)
+    {
+        for (auto& segment : product.segments)
+        {
+            for (const auto& pending : segment.pending)
+            {
+                writeBlockRow(segment, pending.first, pending.second);
+            }
+            segment.pending.clear();
+        }
+    }
+
+    mIO->close();
+}
+}
@@ -0,0 +1,219 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/SchemaValidatorCache.h>
+
+#include <io/StringStream.h>
+#include <xml/lite/Validator.h>
+
+namespace six
+{
+// The validators compiled for one set of schema paths
+struct SchemaValidatorCache::Validators final
+{
+    std::unique_ptr<xml::lite::Validator> acquire(
+            const std::vector<std::filesystem::path>& schemaPaths,
+            logging::Logger* log)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mIdle.empty())
+            {
+                std::unique_ptr<xml::lite::Validator> validator =
+                        std::move(mIdle.back());
+                mIdle.pop_back();
+                return validator;
+            }
+            ++mNumValidators;
+        }
+
+        // Compile outside the lock so other threads can keep validating
+        try
+        {
+            return std::unique_ptr<xml::lite::Validator>(
+                    new xml::lite::Validator(schemaPaths, log, true));
+        }
+        catch (...)
+        {
+            discard();
+            throw;
+        }
+    }
+
+    void release(std::unique_ptr<xml::lite::Validator>&& validator)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIdle.push_back(std::move(validator));
+    }
+
+    // A validator that threw may be left in a bad state, so it's dropped
+    // rather than returned to the pool
+    void discard()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mNumValidators;
+    }
+
+    size_t getNumValidators() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mNumValidators;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    std::vector<std::unique_ptr<xml::lite::Validator> > mIdle;
+    size_t mNumValidators = 0;
+};
+
+SchemaValidatorCache::SchemaValidatorCache() = default;
+
+SchemaValidatorCache::~SchemaValidatorCache() = default;
+
+std::string SchemaValidatorCache::makeKey(
+        const std::vector<std::filesystem::path>& schemaPaths)
+{
+    std::string key;
+    for (const auto& path : schemaPaths)
+    {
+        key += path.string();
+        key += '\n';
+    }
+    return key;
+}
+
+std::shared_ptr<SchemaValidatorCache::Validators>
+SchemaValidatorCache::getValidators(
+        const std::vector<std::filesystem::path>& schemaPaths)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::shared_ptr<Validators>& entry = mValidators[makeKey(schemaPaths)];
+    if (!entry)
+    {
+        entry = std::make_shared<Validators>();
+    }
+    return entry;
+}
+
+bool SchemaValidatorCache::validate(
+        const xml::lite::Element& element,
+        const std::vector<std::filesystem::path>& schemaPaths,
+        std::vector<xml::lite::ValidationInfo>& errors,
+        logging::Logger* log)
+{
+    const std::shared_ptr<Validators> validators = getValidators(schemaPaths);
+    std::unique_ptr<xml::lite::Validator> validator =
+            validators->acquire(schemaPaths, log);
+
+    bool isValid(true);
+    try
+    {
+        const std::string uri = element.getUri();
+
+        // Nearly every document is valid, so skip the indentation that
+        // only matters for reporting errors
+        io::U8StringStream xmlStream;
+        element.print(xmlStream);
+
+        std::vector<xml::lite::ValidationInfo> compactErrors;
+        validator->validate(xmlStream.stream().str(), uri, compactErrors);
+
+        if (!compactErrors.empty())
+        {
+            isValid = false;
+
+            // Pretty-print so that lines numbers are useful
+            io::U8StringStream prettyStream;
+            element.prettyPrint(prettyStream);
+
+            const size_t numErrors = errors.size();
+            validator->validate(prettyStream.stream().str(), uri, errors);
+            if (errors.size() == numErrors)
+            {
+                errors.insert(errors.end(),
+                              compactErrors.begin(), compactErrors.end());
+            }
+        }
+    }
+    catch (...)
+    {
+        validators->discard();
+        throw;
+    }
+
+    validators->release(std::move(validator));
+    return isValid;
+}
+
+bool SchemaValidatorCache::validate(
+        const coda_oss::u8string& xml,
+        const std::string& xmlID,
+        const std::vector<std::filesystem::path>& schemaPaths,
+        std::vector<xml::lite::ValidationInfo>& errors,
+        logging::Logger* log)
+{
+    const std::shared_ptr<Validators> validators = getValidators(schemaPaths);
+    std::unique_ptr<xml::lite::Validator> validator =
+            validators->acquire(schemaPaths, log);
+
+    const size_t numErrors = errors.size();
+    try
+    {
+        validator->validate(xml, xmlID, errors);
+    }
+    catch (...)
+    {
+        validators->discard();
+        throw;
+    }
+
+    validators->release(std::move(validator));
+    return errors.size() == numErrors;
+}
+
+size_t SchemaValidatorCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mValidators.size();
+}
+
+size_t SchemaValidatorCache::getNumValidators(
+        const std::vector<std::filesystem::path>& schemaPaths) const
+{
+    std::shared_ptr<Validators> validators;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto iter = mValidators.find(makeKey(schemaPaths));
+        if (iter == mValidators.end())
+        {
+            return 0;
+        }
+        validators = iter->second;
+    }
+    return validators->getNumValidators();
+}
+
+void SchemaValidatorCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mValidators.clear();
+}
+}
@@ -0,0 +1,203 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <six/StreamingXMLParser.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <except/Exception.h>
+#include <xml/lite/MinidomHandler.h>
+#include <xml/lite/XMLReader.h>
+
+namespace six
+{
+struct StreamingXMLParser::Impl final : public xml::lite::ContentHandler
+{
+    Impl()
+    {
+        reader.setContentHandler(this);
+    }
+    Impl(const Impl&) = delete;
+    Impl& operator=(const Impl&) = delete;
+    Impl(Impl&&) = delete;
+    Impl& operator=(Impl&&) = delete;
+
+    void startDocument() override
+    {
+        rootName.clear();
+        rootUri.clear();
+        counts.clear();
+        path.clear();
+        pathLengths.clear();
+        sections.clear();
+    }
+
+    void startElement(const std::string& uri,
+                      const std::string& localName,
+                      const std::string& qname,
+                      const xml::lite::Attributes& attributes) override
+    {
+        pathLengths.push_back(path.size());
+        if (pathLengths.size() == 1)
+        {
+            // Paths are relative to the root
+            rootName = localName;
+            rootUri = uri;
+            return;
+        }
+
+        if (!path.empty())
+        {
+            path += '/';
+        }
+        path += localName;
+
+        const auto iter = handlers.find(path);
+        if (iter != handlers.end())
+        {
+            Section section;
+            section.dom.reset(new xml::lite::MinidomHandler());
+            section.dom->preserveCharacterData(preserve);
+            section.depth = pathLengths.size();
+            section.handler = &iter->second;
+            sections.push_back(std::move(section));
+        }
+
+        if (!sections.empty())
+        {
+            sections.back().dom->startElement(uri, localName, qname,
+                                              attributes);
+        }
+    }
+
+    void endElement(const std::string& uri,
+                    const std::string& localName,
+                    const std::string& qname) override
+    {
+        if (!sections.empty())
+        {
+            sections.back().dom->endElement(uri, localName, qname);
+
+            if (sections.back().depth == pathLengths.size())
+            {
+                ++counts[path];
+
+                // Pop the section first so the handler can't see it again
+                const std::unique_ptr<xml::lite::MinidomHandler> dom =
+                        std::move(sections.back().dom);
+                const Handler& handler = *sections.back().handler;
+                sections.pop_back();
+
+                handler(*dom->getDocument()->getRootElement());
+            }
+        }
+
+        path.resize(pathLengths.back());
+        pathLengths.pop_back();
+    }
+
+    void characters(const char* data, int length) override
+    {
+        if (!sections.empty())
+        {
+            sections.back().dom->characters(data, length);
+        }
+    }
+
+    bool vcharacters(const void* data, size_t length) override
+    {
+        // Character data outside of a section is just dropped
+        if (sections.empty())
+        {
+            return true;
+        }
+        return sections.back().dom->vcharacters(data, length);
+    }
+
+    struct Section final
+    {
+        std::unique_ptr<xml::lite::MinidomHandler> dom;
+        size_t depth = 0;
+        const Handler* handler = nullptr;
+    };
+
+    xml::lite::XMLReader reader;
+    std::unordered_map<std::string, Handler> handlers;
+    std::unordered_map<std::string, size_t> counts;
+    bool preserve = false;
+
+    std::string rootName;
+    std::string rootUri;
+
+    // The current element's path below the root, and the length of the
+    // path before each open element was added to it
+    std::string path;
+    std::vector<size_t> pathLengths;
+
+    // Sections being collected; only the innermost one sees new elements
+    std::vector<Section> sections;
+};
+
+StreamingXMLParser::StreamingXMLParser() :
+    pImpl(new Impl())
+{
+}
+
+StreamingXMLParser::~StreamingXMLParser() = default;
+
+void StreamingXMLParser::addHandler(const std::string& path, Handler handler)
+{
+    if (path.empty() || path.front() == '/' || path.back() == '/')
+    {
+        throw except::Exception(Ctxt("Invalid element path '" + path + "'"));
+    }
+    pImpl->handlers[path] = std::move(handler);
+}
+
+void StreamingXMLParser::parse(io::InputStream& is, int size)
+{
+    pImpl->startDocument();
+    pImpl->reader.parse(is, size);
+}
+
+const std::string& StreamingXMLParser::getRootName() const
+{
+    return pImpl->rootName;
+}
+
+const std::string& StreamingXMLParser::getRootUri() const
+{
+    return pImpl->rootUri;
+}
+
+size_t StreamingXMLParser::getCount(const std::string& path) const
+{
+    const auto iter = pImpl->counts.find(path);
+    return (iter == pImpl->counts.end()) ? 0 : iter->second;
+}
+
+void StreamingXMLParser::preserveCharacterData(bool preserve)
+{
+    pImpl->preserve = preserve;
+}
+}
@@ -30,6 +30,7 @@
 #include <str/EncodedStringView.h>
 #include <nitf/PluginRegistry.hpp>
 #include "six/Init.h"
+#include "six/NumericConversion.h"
 #include "six/Utilities.h"
 #include "six/XMLControl.h"
 #include "six/Data.h"
@@ -111,19 +112,14 @@ std::string six::toString<float>(const float& value)
                 Ctxt("Attempted use of uninitialized float value"));
     }
 
-    std::ostringstream os;
-    constexpr size_t precision = std::numeric_limits<float>::max_digits10;
-    os << std::uppercase << std::scientific << std::setprecision(precision)
-       << value;
-    std::string strValue = os.str();
+    constexpr int precision = std::numeric_limits<float>::max_digits10;
+    return toScientificString(value, precision);
+}
 
-    // remove any + in scientific notation to meet SICD XML standard
-    const size_t plusPos = strValue.find("+");
-    if (plusPos != std::string::npos)
-    {
-        strValue.erase(plusPos, 1);
-    }
-    return strValue;
+template <>
+float six::toType<float>(const std::string& s)
+{
+    return parseFloat(s);
 }
 
 template <>
@@ -135,19 +131,14 @@ std::string six::toString<double>(const double& value)
                 Ctxt("Attempted use of uninitialized double value"));
     }
 
-    std::ostringstream os;
-    constexpr size_t precision = std::numeric_limits<double>::max_digits10;
-    os << std::uppercase << std::scientific << std::setprecision(precision)
-       << value;
-    std::string strValue = os.str();
+    constexpr int precision = std::numeric_limits<double>::max_digits10;
+    return toScientificString(value, precision);
+}
 
-    // remove any + in scientific notation to meet SICD XML standard
-    const size_t plusPos = strValue.find("+");
-    if (plusPos != std::string::npos)
-    {
-        strValue.erase(plusPos, 1);
-    }
-    return strValue;
+template <>
+double six::toType<double>(const std::string& s)
+{
+    return parseDouble(s);
 }
 
 template <>
@@ -31,6 +31,7 @@
 #include <six/Utilities.h>
 #include <six/Types.h>
 #include <six/Data.h>
+#include <six/SchemaValidatorCache.h>
 
 namespace fs = std::filesystem;
 
@@ -149,21 +150,17 @@ template<typename TPath>
 static void do_validate_(const xml::lite::Document& doc,
     const std::vector<TPath>& paths, logging::Logger* log)
 {
-    // validate against any specified schemas
-    xml::lite::Validator validator(paths, log, true);
-
     const auto& rootElement = doc.getRootElement();
     if (rootElement->getUri().empty())
     {
         throw six::DESValidationException(Ctxt("INVALID XML: URI is empty so document version cannot be determined to use for validation"));
     }
 
-    // Pretty-print so that lines numbers are useful
-    io::U8StringStream xmlStream;
-    rootElement->prettyPrint(xmlStream);
-
+    // validate against any specified schemas, compiling them only the
+    // first time we see them
+    const std::vector<std::filesystem::path> schemaPaths(paths.begin(), paths.end());
     std::vector<xml::lite::ValidationInfo> errors;
-    validator.validate(xmlStream, rootElement->getUri(), errors);
+    SchemaCache::getInstance().validate(*rootElement, schemaPaths, errors, log);
 
     // log any error found and throw
     if (!errors.empty())
@@ -24,6 +24,7 @@
 
 #include <assert.h>
 
+#include <limits>
 #include <string>
 
 #include <nitf/coda-oss.hpp>
@@ -32,6 +33,7 @@
 #include <logging/NullLogger.h>
 #include <six/Utilities.h>
 #include <six/Init.h>
+#include <six/NumericConversion.h>
 
 namespace six
 {
@@ -191,6 +193,12 @@ inline std::string toString_(const xml::lite::QName& name, const T& v, const xml
 {
     return toString(name, v, parent);
 }
+template<>
+inline std::string toString_(const xml::lite::QName&, const double& v, const xml::lite::Element&)
+{
+    // Same text as str::toString(), without a stream per value
+    return toGeneralString(v, std::numeric_limits<double>::max_digits10);
+}
 
 template<typename T, typename ToString>
 static xml::lite::Element& createValue(const xml::lite::QName& name,
@@ -366,7 +374,7 @@ bool XmlLite::parseDouble(const xml::lite::Element& element, double& value) cons
 {
     value = Init::undefined<double>();
     const auto getValue = [&]() {
-        value = xml::lite::getValue<double>(element);
+        value = xml::lite::castValue(element, six::toType<double>);
         assert(Init::isDefined(value)); };
     return parseValue(mLogger.get(), getValue);
 }
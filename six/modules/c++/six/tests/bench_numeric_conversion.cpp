@@ -0,0 +1,163 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Times the stream-based double <-> string conversions used for XML
+// against six/NumericConversion.h, and checks that they agree.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <import/cli.h>
+#include <str/Convert.h>
+#include <sys/StopWatch.h>
+#include <six/NumericConversion.h>
+
+namespace
+{
+std::string streamScientific(double value)
+{
+    std::ostringstream os;
+    os << std::uppercase << std::scientific
+       << std::setprecision(std::numeric_limits<double>::max_digits10)
+       << value;
+    std::string strValue = os.str();
+    const size_t plusPos = strValue.find("+");
+    if (plusPos != std::string::npos)
+    {
+        strValue.erase(plusPos, 1);
+    }
+    return strValue;
+}
+
+template <typename FormatT>
+double timeFormat(const std::vector<double>& values,
+                  std::vector<std::string>& strings,
+                  FormatT format)
+{
+    sys::RealTimeStopWatch sw;
+    sw.start();
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        strings[ii] = format(values[ii]);
+    }
+    return sw.stop();
+}
+
+template <typename ParseT>
+double timeParse(const std::vector<std::string>& strings,
+                 std::vector<double>& values,
+                 ParseT parse)
+{
+    sys::RealTimeStopWatch sw;
+    sw.start();
+    for (size_t ii = 0; ii < strings.size(); ++ii)
+    {
+        values[ii] = parse(strings[ii]);
+    }
+    return sw.stop();
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        cli::ArgumentParser parser;
+        parser.setDescription(
+                "Benchmark stream vs. direct numeric conversion for XML");
+        parser.addArgument("-n --num-values", "Number of values",
+                           cli::STORE, "numValues", "NUM")->
+                setDefault(1000000);
+        const std::unique_ptr<cli::Results> options(parser.parse(argc, argv));
+        const size_t numValues = options->get<size_t>("numValues");
+
+        // Polynomial coefficients and positions span many magnitudes
+        std::mt19937 engine(42);
+        std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+        std::uniform_int_distribution<int> exponent(-20, 20);
+        std::vector<double> values(numValues);
+        for (auto& value : values)
+        {
+            value = mantissa(engine) * std::pow(10.0, exponent(engine));
+        }
+
+        std::vector<std::string> streamStrings(numValues);
+        std::vector<std::string> directStrings(numValues);
+        std::vector<double> streamValues(numValues);
+        std::vector<double> directValues(numValues);
+
+        const double streamScientificTime = timeFormat(
+                values, streamStrings, streamScientific);
+        const double directScientificTime = timeFormat(
+                values, directStrings, [](double value) {
+                    return six::toScientificString(
+                            value, std::numeric_limits<double>::max_digits10);
+                });
+        bool same = streamStrings == directStrings;
+
+        const double streamGeneralTime = timeFormat(
+                values, streamStrings,
+                [](double value) { return str::toString(value); });
+        const double directGeneralTime = timeFormat(
+                values, directStrings, [](double value) {
+                    return six::toGeneralString(
+                            value, std::numeric_limits<double>::max_digits10);
+                });
+        same = same && streamStrings == directStrings;
+
+        const double streamParseTime = timeParse(
+                streamStrings, streamValues,
+                [](const std::string& s) { return str::toType<double>(s); });
+        const double directParseTime = timeParse(
+                streamStrings, directValues, six::parseDouble);
+        same = same && streamValues == directValues && directValues == values;
+
+        std::cout << "Values: " << numValues << "\n"
+                  << "Scientific format, stream: " << streamScientificTime
+                  << " ms, direct: " << directScientificTime << " ms\n"
+                  << "General format, stream: " << streamGeneralTime
+                  << " ms, direct: " << directGeneralTime << " ms\n"
+                  << "Parse, stream: " << streamParseTime
+                  << " ms, direct: " << directParseTime << " ms\n";
+        if (!same)
+        {
+            std::cerr << "Stream and direct conversions differ\n";
+            return 1;
+        }
+        return 0;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
@@ -0,0 +1,234 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <std/memory>
+
+#include <io/StringStream.h>
+#include <str/Convert.h>
+#include <six/MetadataIndexer.h>
+
+#include "TestCase.h"
+
+namespace
+{
+// "fileN" has N products; anything else fails
+struct FakeSummarizer final : public six::MetadataSummarizer
+{
+    bool supports(const std::string& pathname) const override
+    {
+        if (pathname == "missing")
+        {
+            throw std::runtime_error("Can't find " + pathname);
+        }
+        return pathname != "unsupported";
+    }
+
+    void summarize(const std::string& pathname,
+                   std::vector<six::MetadataSummary>& summaries) const override
+    {
+        if (pathname.compare(0, 4, "file") != 0)
+        {
+            throw std::runtime_error("Can't open " + pathname);
+        }
+
+        const size_t numProducts = str::toType<size_t>(pathname.substr(4));
+        for (size_t ii = 0; ii < numProducts; ++ii)
+        {
+            six::MetadataSummary summary;
+            summary[six::MetadataField::NAME] =
+                    pathname + "_" + std::to_string(ii);
+            summary[six::MetadataField::TYPE] = "SICD";
+            summaries.push_back(summary);
+        }
+    }
+};
+
+std::vector<std::string> getPathnames()
+{
+    std::vector<std::string> pathnames;
+    for (size_t ii = 0; ii < 50; ++ii)
+    {
+        pathnames.push_back("file" + std::to_string(ii % 4));
+    }
+    pathnames.push_back("bad");
+    pathnames.push_back("unsupported");
+    return pathnames;
+}
+
+six::MetadataIndex makeIndex(size_t numThreads, six::MetadataIndexStatistics& stats)
+{
+    six::MetadataIndexer indexer({six::MetadataField::PATHNAME,
+                                  six::MetadataField::PRODUCT,
+                                  six::MetadataField::NAME,
+                                  six::MetadataField::COLLECTOR,
+                                  six::MetadataField::ERROR_MESSAGE},
+                                 numThreads);
+    indexer.addSummarizer(std::make_unique<FakeSummarizer>());
+    return indexer.index(getPathnames(), &stats);
+}
+}
+
+TEST_CASE(testIndex)
+{
+    six::MetadataIndexStatistics stats;
+    const six::MetadataIndex index = makeIndex(1, stats);
+
+    // file0 has no products, so is still a row
+    // 13 each of file0-1, 12 each of file2-3, and 2 that fail
+    TEST_ASSERT_EQ(stats.numFiles, static_cast<size_t>(52));
+    TEST_ASSERT_EQ(stats.numFailed, static_cast<size_t>(2));
+    TEST_ASSERT_EQ(stats.numProducts, static_cast<size_t>(13 + 24 + 36));
+    TEST_ASSERT_EQ(index.getNumRows(), static_cast<size_t>(13 + 13 + 24 + 36 + 2));
+    TEST_ASSERT_EQ(index.fields.size(), static_cast<size_t>(5));
+
+    const auto& pathnames = index.getColumn(six::MetadataField::PATHNAME);
+    const auto& products = index.getColumn(six::MetadataField::PRODUCT);
+    const auto& names = index.getColumn(six::MetadataField::NAME);
+    const auto& collectors = index.getColumn(six::MetadataField::COLLECTOR);
+    const auto& errors = index.getColumn(six::MetadataField::ERROR_MESSAGE);
+
+    // Rows are in the order of the files
+    TEST_ASSERT_EQ(pathnames[0], "file0");
+    TEST_ASSERT_EQ(names[0], "");
+    TEST_ASSERT_EQ(pathnames[1], "file1");
+    TEST_ASSERT_EQ(names[1], "file1_0");
+    TEST_ASSERT_EQ(pathnames[2], "file2");
+    TEST_ASSERT_EQ(products[3], "1");
+    TEST_ASSERT_EQ(names[3], "file2_1");
+    TEST_ASSERT_EQ(pathnames[6], "file3");
+    TEST_ASSERT_EQ(names[6], "file3_2");
+    TEST_ASSERT_EQ(collectors[6], "");
+    TEST_ASSERT_EQ(errors[6], "");
+
+    const size_t numRows = index.getNumRows();
+    TEST_ASSERT_EQ(pathnames[numRows - 2], "bad");
+    TEST_ASSERT_EQ(errors[numRows - 2], "Can't open bad");
+    TEST_ASSERT_EQ(pathnames[numRows - 1], "unsupported");
+    TEST_ASSERT_FALSE(errors[numRows - 1].empty());
+
+    TEST_EXCEPTION(index.getColumn(six::MetadataField::FOOTPRINT));
+}
+
+TEST_CASE(testThreadsMatch)
+{
+    six::MetadataIndexStatistics stats;
+    const six::MetadataIndex expected = makeIndex(1, stats);
+    for (size_t numThreads : {2, 7, 100})
+    {
+        const six::MetadataIndex actual = makeIndex(numThreads, stats);
+        TEST_ASSERT_TRUE(actual.fields == expected.fields);
+        TEST_ASSERT_TRUE(actual.values == expected.values);
+        TEST_ASSERT_EQ(stats.numFailed, static_cast<size_t>(2));
+    }
+}
+
+TEST_CASE(testWriteRead)
+{
+    six::MetadataIndexStatistics stats;
+    six::MetadataIndex expected = makeIndex(4, stats);
+
+    // Values don't have to be text
+    expected.values[2][0] = std::string("\0\xff\n", 3);
+
+    io::StringStream stream;
+    expected.write(stream);
+    const six::MetadataIndex actual = six::MetadataIndex::read(stream);
+    TEST_ASSERT_TRUE(actual.fields == expected.fields);
+    TEST_ASSERT_TRUE(actual.values == expected.values);
+
+    io::StringStream empty;
+    six::MetadataIndex().write(empty);
+    const six::MetadataIndex emptyIndex = six::MetadataIndex::read(empty);
+    TEST_ASSERT_EQ(emptyIndex.getNumRows(), static_cast<size_t>(0));
+
+    io::StringStream bad;
+    bad.write("SIXMDIDY");
+    TEST_EXCEPTION(six::MetadataIndex::read(bad));
+}
+
+TEST_CASE(testUnreadableFile)
+{
+    // Checking what a file is happens on the worker threads, so a file
+    // that can't be opened is a row like any other failure
+    six::MetadataIndexer indexer({six::MetadataField::PATHNAME,
+                                  six::MetadataField::ERROR_MESSAGE}, 2);
+    indexer.addSummarizer(std::make_unique<FakeSummarizer>());
+    six::MetadataIndexStatistics stats;
+    const six::MetadataIndex index =
+            indexer.index({"file1", "missing", "file2"}, &stats);
+    TEST_ASSERT_EQ(stats.numFailed, static_cast<size_t>(1));
+    TEST_ASSERT_EQ(index.getNumRows(), static_cast<size_t>(4));
+    const auto& errors = index.getColumn(six::MetadataField::ERROR_MESSAGE);
+    TEST_ASSERT_EQ(errors[1], "Can't find missing");
+}
+
+TEST_CASE(testReadDamaged)
+{
+    six::MetadataIndexStatistics stats;
+    const six::MetadataIndex expected = makeIndex(1, stats);
+    io::StringStream stream;
+    expected.write(stream);
+    const std::string good = stream.stream().str();
+
+    const auto read = [](const std::string& data)
+    {
+        io::StringStream damaged;
+        damaged.write(data);
+        return six::MetadataIndex::read(damaged);
+    };
+    TEST_ASSERT_TRUE(read(good).values == expected.values);
+
+    // Any truncation is caught
+    for (const size_t size : { static_cast<size_t>(10), static_cast<size_t>(20),
+                               good.size() / 2, good.size() - 1 })
+    {
+        TEST_EXCEPTION(read(good.substr(0, size)));
+    }
+
+    // Counts bigger than the stream are caught before allocating for them
+    std::string damaged = good;
+    damaged.replace(12, 4, "\xff\xff\xff\xff"); // number of fields
+    TEST_EXCEPTION(read(damaged));
+    damaged = good;
+    damaged.replace(16, 8, "\xff\xff\xff\xff\xff\xff\xff\x0f"); // number of rows
+    TEST_EXCEPTION(read(damaged));
+
+    // As are column sizes that don't match the values
+    const size_t columnSizeOffset = 24 + 4 + expected.fields[0].size();
+    for (const char delta : { -1, 1 })
+    {
+        damaged = good;
+        damaged[columnSizeOffset] = static_cast<char>(damaged[columnSizeOffset] + delta);
+        TEST_EXCEPTION(read(damaged));
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testIndex);
+    TEST_CHECK(testThreadsMatch);
+    TEST_CHECK(testWriteRead);
+    TEST_CHECK(testUnreadableFile);
+    TEST_CHECK(testReadDamaged);
+)
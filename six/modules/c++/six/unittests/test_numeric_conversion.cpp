@@ -0,0 +1,201 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <string.h>
+
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <str/Convert.h>
+#include <six/NumericConversion.h>
+
+#include "TestCase.h"
+
+namespace
+{
+// What six::toString() used to do
+std::string streamScientific(double value, int precision)
+{
+    std::ostringstream os;
+    os << std::uppercase << std::scientific << std::setprecision(precision)
+       << value;
+    std::string strValue = os.str();
+    const size_t plusPos = strValue.find("+");
+    if (plusPos != std::string::npos)
+    {
+        strValue.erase(plusPos, 1);
+    }
+    return strValue;
+}
+
+// Finite values from every binade, plus some special ones
+std::vector<double> getValues()
+{
+    std::vector<double> values = {
+            0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1.0 / 3.0, 1e-5, 123456789.0,
+            9.999999999999999e22, 1e23, 5e-324, -5e-324,
+            std::numeric_limits<double>::min(),
+            std::numeric_limits<double>::max(),
+            -std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::epsilon() };
+
+    std::mt19937_64 engine(12345);
+    for (size_t ii = 0; ii < 20000; ++ii)
+    {
+        uint64_t bits = engine();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (value == value &&
+            value != std::numeric_limits<double>::infinity() &&
+            value != -std::numeric_limits<double>::infinity())
+        {
+            values.push_back(value);
+        }
+    }
+
+    std::uniform_real_distribution<double> distribution(-1e4, 1e4);
+    for (size_t ii = 0; ii < 5000; ++ii)
+    {
+        values.push_back(distribution(engine));
+    }
+    return values;
+}
+
+bool sameBits(double lhs, double rhs)
+{
+    return memcmp(&lhs, &rhs, sizeof(lhs)) == 0;
+}
+}
+
+TEST_CASE(testScientificMatchesStream)
+{
+    for (double value : getValues())
+    {
+        for (int precision : {1, 9, 17})
+        {
+            TEST_ASSERT_EQ(six::toScientificString(value, precision),
+                           streamScientific(value, precision));
+        }
+        const float floatValue = static_cast<float>(value);
+        TEST_ASSERT_EQ(six::toScientificString(floatValue, 9),
+                       streamScientific(floatValue, 9));
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    TEST_ASSERT_EQ(six::toScientificString(inf, 17), streamScientific(inf, 17));
+    TEST_ASSERT_EQ(six::toScientificString(-inf, 17), streamScientific(-inf, 17));
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    TEST_ASSERT_EQ(six::toScientificString(nan, 17), streamScientific(nan, 17));
+}
+
+TEST_CASE(testGeneralMatchesStream)
+{
+    for (double value : getValues())
+    {
+        TEST_ASSERT_EQ(six::toGeneralString(value, 17), str::toString(value));
+    }
+}
+
+TEST_CASE(testRoundTrip)
+{
+    for (double value : getValues())
+    {
+        TEST_ASSERT_TRUE(sameBits(
+                six::parseDouble(six::toScientificString(value, 17)), value));
+        TEST_ASSERT_TRUE(sameBits(
+                six::parseDouble(six::toGeneralString(value, 17)), value));
+
+        const float floatValue = static_cast<float>(value);
+        if (floatValue != std::numeric_limits<float>::infinity() &&
+            floatValue != -std::numeric_limits<float>::infinity())
+        {
+            TEST_ASSERT_EQ(
+                    six::parseFloat(six::toScientificString(floatValue, 9)),
+                    floatValue);
+        }
+    }
+}
+
+TEST_CASE(testParseMatchesStream)
+{
+    const std::vector<std::string> strings = {
+            "0", "-0", "+1", "1.", ".5", "-.5", "1.5e3", "1.5E-3", "1.5e+03",
+            "  \t\n42", "7abc", "1.5.3", "1e5.3", "1e5e3", "0x1p3", "00012",
+            "1.300000000000000E00", "-2.5E-05", "1e400", "-1e400", "1e-400",
+            "4.9406564584124654E-324", "1e", "1e+", "1ex", "e5", ".", "-",
+            "+", "+-1", ".e5", "inf", "nan", "INF", "abc", " " };
+
+    for (const auto& s : strings)
+    {
+        bool streamThrew = false;
+        double expected = 0.0;
+        try
+        {
+            expected = str::toType<double>(s);
+        }
+        catch (const except::BadCastException&)
+        {
+            streamThrew = true;
+        }
+
+        if (streamThrew)
+        {
+            TEST_EXCEPTION(six::parseDouble(s));
+        }
+        else
+        {
+            TEST_ASSERT_TRUE(sameBits(six::parseDouble(s), expected));
+        }
+
+        bool floatStreamThrew = false;
+        float floatExpected = 0.0f;
+        try
+        {
+            floatExpected = str::toType<float>(s);
+        }
+        catch (const except::BadCastException&)
+        {
+            floatStreamThrew = true;
+        }
+
+        if (floatStreamThrew)
+        {
+            TEST_EXCEPTION(six::parseFloat(s));
+        }
+        else
+        {
+            TEST_ASSERT_EQ(six::parseFloat(s), floatExpected);
+        }
+    }
+
+    TEST_EXCEPTION(six::parseDouble(""));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testScientificMatchesStream);
+    TEST_CHECK(testGeneralMatchesStream);
+    TEST_CHECK(testRoundTrip);
+    TEST_CHECK(testParseMatchesStream);
+)
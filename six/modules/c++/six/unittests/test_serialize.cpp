@@ -25,6 +25,7 @@
 
 #include "TestCase.h"
 #include <six/Serialize.h>
+#include <six/MetadataSnapshot.h>
 
 template<typename T> T getRandomScalar()
 {
@@ -136,9 +137,101 @@ TEST_CASE(VectorSerialize)
     TEST_ASSERT_TRUE(testVector<double>(length, true));
 }
 
+// A snapshot of GeoInfos nested 'depth' deep, written field by field since
+// the archive won't write anything nested too deeply either
+static std::vector<std::byte> nestedGeoInfoSnapshot(size_t depth,
+                                                    size_t numChildren = 1)
+{
+    std::vector<std::byte> snapshot;
+    six::SnapshotArchive archive("GEOINFO", snapshot);
+    for (size_t ii = 0; ii < depth; ++ii)
+    {
+        std::string name = "level" + std::to_string(ii);
+        archive(name);
+        archive.count(numChildren);
+        archive.transfer(true);
+    }
+
+    std::string name = "leaf";
+    archive(name);
+    archive.count(0);
+    for (size_t ii = 0; ii <= depth; ++ii)
+    {
+        archive.count(0); // desc
+        archive.count(0); // geometryLatLon
+    }
+    return snapshot;
+}
+
+static six::GeoInfo readGeoInfo(const std::vector<std::byte>& snapshot)
+{
+    six::SnapshotArchive archive(
+            "GEOINFO",
+            std::span<const std::byte>(snapshot.data(), snapshot.size()));
+    six::GeoInfo geoInfo;
+    archive(geoInfo);
+    archive.finish();
+    return geoInfo;
+}
+
+TEST_CASE(SnapshotRoundTrip)
+{
+    six::GeoInfo expected;
+    expected.name = "parent";
+    expected.desc.push_back(six::Parameter(1.5));
+    expected.desc.back().setName("weight");
+    expected.geometryLatLon.push_back(six::LatLon(1.0, 2.0));
+    expected.geoInfos.push_back(
+            mem::ScopedCopyablePtr<six::GeoInfo>(new six::GeoInfo()));
+    expected.geoInfos.back()->name = "child";
+
+    std::vector<std::byte> snapshot;
+    six::SnapshotArchive archive("GEOINFO", snapshot);
+    archive(expected);
+    TEST_ASSERT_TRUE(readGeoInfo(snapshot) == expected);
+
+    // The identifier has to match
+    TEST_EXCEPTION(six::SnapshotArchive(
+            "DERIVED",
+            std::span<const std::byte>(snapshot.data(), snapshot.size())));
+
+    // Any truncation is caught, as are extra bytes
+    for (size_t size = 1; size < snapshot.size(); ++size)
+    {
+        const std::vector<std::byte> truncated(snapshot.begin(),
+                                               snapshot.begin() + size);
+        TEST_EXCEPTION(readGeoInfo(truncated));
+    }
+    snapshot.push_back(std::byte(0));
+    TEST_EXCEPTION(readGeoInfo(snapshot));
+}
+
+TEST_CASE(SnapshotNesting)
+{
+    const size_t depth = 10;
+    const six::GeoInfo geoInfo = readGeoInfo(nestedGeoInfoSnapshot(depth));
+    const six::GeoInfo* leaf = &geoInfo;
+    for (size_t ii = 0; ii < depth; ++ii)
+    {
+        TEST_ASSERT_EQ(leaf->geoInfos.size(), static_cast<size_t>(1));
+        leaf = leaf->geoInfos[0].get();
+    }
+    TEST_ASSERT_EQ(leaf->name, "leaf");
+
+    // Rather than recursing as deeply as the snapshot says
+    TEST_EXCEPTION(readGeoInfo(nestedGeoInfoSnapshot(
+            six::SnapshotArchive::MAX_DEPTH)));
+    TEST_EXCEPTION(readGeoInfo(nestedGeoInfoSnapshot(100000)));
+
+    // A count bigger than what's left is refused before it's allocated
+    TEST_EXCEPTION(readGeoInfo(nestedGeoInfoSnapshot(1, 0xffffffff)));
+}
+
 TEST_MAIN(
     srand(static_cast<unsigned int>(time(NULL)));
     TEST_CHECK(ScalarSerialize);
     TEST_CHECK(VectorSerialize);
     TEST_CHECK(StringSerialize);
+    TEST_CHECK(SnapshotRoundTrip);
+    TEST_CHECK(SnapshotNesting);
     )
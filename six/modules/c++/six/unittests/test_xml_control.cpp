@@ -20,8 +20,14 @@
  *
  */
 
+#include <fstream>
+#include <memory>
+#include <std/memory>
 #include <std/filesystem>
 
+#include <str/EncodedStringView.h>
+#include <six/BatchValidator.h>
+#include <six/SchemaValidatorCache.h>
 #include <six/XMLControl.h>
 #include <string>
 #include <vector>
@@ -216,6 +222,143 @@ TEST_CASE(test_six_toType)
 
 }
 
+TEST_CASE(testSchemaValidatorCache)
+{
+    namespace fs = std::filesystem;
+    const fs::path schemaDir =
+            fs::temp_directory_path() / "six_test_schema_validator_cache";
+    fs::create_directory(schemaDir);
+    const fs::path schemaPath = schemaDir / "example.xsd";
+    {
+        std::ofstream schema(schemaPath.string());
+        schema << "<?xml version=\"1.0\"?>\n"
+               << "<xs:schema xmlns:xs=\"http://www.w3.org/2001/XMLSchema\"\n"
+               << "           targetNamespace=\"urn:example.com\"\n"
+               << "           xmlns=\"urn:example.com\"\n"
+               << "           elementFormDefault=\"qualified\">\n"
+               << "  <xs:element name=\"root\">\n"
+               << "    <xs:complexType>\n"
+               << "      <xs:sequence>\n"
+               << "        <xs:element name=\"int\" type=\"xs:int\"/>\n"
+               << "      </xs:sequence>\n"
+               << "    </xs:complexType>\n"
+               << "  </xs:element>\n"
+               << "</xs:schema>\n";
+    }
+
+    const six::XmlLite xmlLite(xml::lite::Uri("urn:example.com"), false);
+    std::unique_ptr<xml::lite::Element> valid(xmlLite.newElement("root", nullptr));
+    xmlLite.createInt("int", 314, *valid);
+    std::unique_ptr<xml::lite::Element> invalid(xmlLite.newElement("root", nullptr));
+    xmlLite.createString("string", "abc", *invalid);
+
+    six::SchemaValidatorCache cache;
+    const std::vector<fs::path> schemaPaths{ schemaDir };
+    std::vector<xml::lite::ValidationInfo> errors;
+    TEST_ASSERT_TRUE(cache.validate(*valid, schemaPaths, errors));
+    TEST_ASSERT_TRUE(cache.validate(*valid, schemaPaths, errors));
+    TEST_ASSERT_TRUE(errors.empty());
+
+    // The schemas were only compiled once
+    TEST_ASSERT_EQ(cache.size(), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(cache.getNumValidators(schemaPaths), static_cast<size_t>(1));
+
+    TEST_ASSERT_FALSE(cache.validate(*invalid, schemaPaths, errors));
+    TEST_ASSERT_FALSE(errors.empty());
+    TEST_ASSERT_EQ(cache.getNumValidators(schemaPaths), static_cast<size_t>(1));
+
+    cache.clear();
+    TEST_ASSERT_EQ(cache.size(), static_cast<size_t>(0));
+
+    fs::remove(schemaPath);
+    fs::remove(schemaDir);
+}
+
+TEST_CASE(testBatchValidator)
+{
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "six_test_batch_validator";
+    fs::create_directory(dir);
+    const auto writeFile = [&](const std::string& name, const std::string& contents)
+    {
+        const fs::path path = dir / name;
+        std::ofstream(path.string()) << contents;
+        return path.string();
+    };
+
+    const std::string schemaPath = writeFile("example.xsd",
+            "<?xml version=\"1.0\"?>\n"
+            "<xs:schema xmlns:xs=\"http://www.w3.org/2001/XMLSchema\"\n"
+            "           targetNamespace=\"urn:example.com\"\n"
+            "           xmlns=\"urn:example.com\"\n"
+            "           elementFormDefault=\"qualified\">\n"
+            "  <xs:element name=\"root\">\n"
+            "    <xs:complexType>\n"
+            "      <xs:sequence>\n"
+            "        <xs:element name=\"int\" type=\"xs:int\"/>\n"
+            "      </xs:sequence>\n"
+            "    </xs:complexType>\n"
+            "  </xs:element>\n"
+            "</xs:schema>\n");
+    const std::string validXML =
+            "<?xml version=\"1.0\"?>\n"
+            "<root xmlns=\"urn:example.com\"><int>314</int></root>\n";
+    const std::string invalidXML =
+            "<?xml version=\"1.0\"?>\n"
+            "<root xmlns=\"urn:example.com\"><int>abc</int></root>\n";
+    const std::vector<std::string> pathnames{
+            writeFile("valid0.xml", validXML),
+            writeFile("invalid.xml", invalidXML),
+            writeFile("valid1.xml", "\n  " + validXML),
+            writeFile("text.txt", "not XML"),
+            (dir / "missing.xml").string() };
+
+    // The raw text is validated against the cached schemas
+    const std::vector<fs::path> schemaPaths{ schemaPath };
+    std::vector<xml::lite::ValidationInfo> errors;
+    TEST_ASSERT_TRUE(six::SchemaCache::getInstance().validate(
+            str::EncodedStringView::fromUtf8(validXML).u8string(), "valid",
+            schemaPaths, errors));
+    TEST_ASSERT_TRUE(errors.empty());
+    TEST_ASSERT_FALSE(six::SchemaCache::getInstance().validate(
+            str::EncodedStringView::fromUtf8(invalidXML).u8string(), "invalid",
+            schemaPaths, errors));
+    TEST_ASSERT_FALSE(errors.empty());
+
+    for (const size_t numThreads : { 1, 4 })
+    {
+        six::BatchValidator validator(schemaPaths, numThreads);
+        validator.addExtractor(std::make_unique<six::XMLFileDocumentExtractor>());
+        const std::vector<six::DocumentValidation> results =
+                validator.validate(pathnames);
+
+        // One result per file, in order
+        TEST_ASSERT_EQ(results.size(), pathnames.size());
+        for (size_t ii = 0; ii < results.size(); ++ii)
+        {
+            TEST_ASSERT_EQ(results[ii].pathname, pathnames[ii]);
+        }
+
+        TEST_ASSERT_TRUE(results[0].isValid());
+        TEST_ASSERT_EQ(results[0].getID(), pathnames[0] + "[0]");
+        TEST_ASSERT_FALSE(results[1].isValid());
+        TEST_ASSERT_TRUE(results[1].failure.empty());
+        TEST_ASSERT_FALSE(results[1].errors.empty());
+        TEST_ASSERT_TRUE(results[2].isValid());
+        TEST_ASSERT_EQ(results[3].failure, std::string("Unsupported file type"));
+        TEST_ASSERT_FALSE(results[4].failure.empty());
+    }
+
+    TEST_EXCEPTION(six::BatchValidator(std::vector<fs::path>(), 1));
+
+    for (const auto& pathname : pathnames)
+    {
+        fs::remove(pathname);
+    }
+    fs::remove(schemaPath);
+    fs::remove(dir);
+}
+
 TEST_MAIN(
     TEST_CHECK(loadCompiledSchemaPath);
     TEST_CHECK(respectGivenPaths);
@@ -223,6 +366,8 @@ TEST_MAIN(
     TEST_CHECK(ignoreEmptyEnvVariable);
     TEST_CHECK(dataTypeToString);
     TEST_CHECK(testXmlLiteAttributeClass);
+    TEST_CHECK(testSchemaValidatorCache);
+    TEST_CHECK(testBatchValidator);
 
     TEST_CHECK(test_six_toString);
     TEST_CHECK(test_six_toType);
@@ -31,7 +31,10 @@
  * @author Martina Schultz
  */
 
+#include <std/span>
+
 #include "Plugin.h"
+#include "RasterGM.h"
 
 #ifdef _WIN32
 # ifdef SIX_CSM_LIBRARY
@@ -212,6 +215,65 @@ public:
        const std::string& modelName,
        csm::WarningList* warnings) const;
 
+public: // Batch projection (SIX extension to the CSM API)
+    /**
+     * Converts many ground points to image space with any raster model.
+     * SIX sensor models use their batch groundToImage(), split across
+     * numThreads threads.  Other models fall back to calling
+     * groundToImage() on each point serially, since we can't know that
+     * they're safe to use from multiple threads.
+     *
+     * \param[in] model The sensor model to project with
+     * \param[in] groundPts Ground coordinates in meters
+     * \param[out] imagePts Image coordinates in pixels.  Must be the same
+     *     size as groundPts.
+     * \param[in] numThreads Number of threads to use for SIX models
+     *
+     * \throws csm::Error if the sizes don't match or a projection fails
+     */
+    static SIX_CSM_EXPORT_API void groundToImage(
+       const csm::RasterGM& model,
+       std::span<const csm::EcefCoord> groundPts,
+       std::span<csm::ImageCoord> imagePts,
+       size_t numThreads = 1);
+
+    //! Same as above but also propagates covariances
+    static SIX_CSM_EXPORT_API void groundToImage(
+       const csm::RasterGM& model,
+       std::span<const csm::EcefCoordCovar> groundPts,
+       std::span<csm::ImageCoordCovar> imagePts,
+       size_t numThreads = 1);
+
+    /**
+     * Converts many image points to ground space with any raster model.
+     * As with groundToImage(), only SIX sensor models are multithreaded.
+     *
+     * \param[in] model The sensor model to project with
+     * \param[in] imagePts Image lines and samples in pixels
+     * \param[in] height Height in meters measured with respect to the
+     *     WGS-84 ellipsoid
+     * \param[out] groundPts Ground coordinates in meters.  Must be the same
+     *     size as imagePts.
+     * \param[in] numThreads Number of threads to use for SIX models
+     *
+     * \throws csm::Error if the sizes don't match or a projection fails
+     */
+    static SIX_CSM_EXPORT_API void imageToGround(
+       const csm::RasterGM& model,
+       std::span<const csm::ImageCoord> imagePts,
+       double height,
+       std::span<csm::EcefCoord> groundPts,
+       size_t numThreads = 1);
+
+    //! Same as above but also propagates covariances
+    static SIX_CSM_EXPORT_API void imageToGround(
+       const csm::RasterGM& model,
+       std::span<const csm::ImageCoordCovar> imagePts,
+       double height,
+       double heightVariance,
+       std::span<csm::EcefCoordCovar> groundPts,
+       size_t numThreads = 1);
+
 private:
     // This special constructor is responsible for registering this plugin by
     // invoking the special "int" base class constructor. Since this is
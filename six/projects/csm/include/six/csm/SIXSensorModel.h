@@ -24,6 +24,7 @@
 #define __SIX_CSM_SIX_SENSOR_MODEL_H__
 
 #include <memory>
+#include <std/span>
 
 #include "RasterGM.h"
 #include "CorrelationModel.h"
@@ -595,6 +596,98 @@ public: // RasterGM methods
     double getCorrelationCoefficient(size_t cpGroupIndex,
                                      double deltaTime) const;
 
+public: // Batch methods (SIX extensions to the CSM API)
+    /**
+     * Converts many ground points to image space at once.  Gives the same
+     * results as calling groundToImage() on each point, but uses the
+     * batched scene projection and splits the points across threads.
+     *
+     * \param[in] groundPts Ground coordinates in meters
+     * \param[out] imagePts Image coordinates in pixels.  Must be the same
+     *     size as groundPts.
+     * \param[in] numThreads Number of threads to use
+     *
+     * \throws csm::Error if the sizes don't match or a projection fails
+     */
+    void groundToImage(std::span<const csm::EcefCoord> groundPts,
+                       std::span<csm::ImageCoord> imagePts,
+                       size_t numThreads = 1) const;
+
+    /**
+     * Same as above but also propagates each ground point's covariance.
+     * This is considerably more expensive than the overloading above, so
+     * only use it if the covariances are needed.
+     *
+     * \param[in] groundPts Ground coordinates in ECEF meters and
+     *     corresponding 3x3 covariances in ECEF meters squared
+     * \param[out] imagePts Image coordinates in pixels and corresponding
+     *     2x2 covariances in pixels squared.  Must be the same size as
+     *     groundPts.
+     * \param[in] numThreads Number of threads to use
+     *
+     * \throws csm::Error if the sizes don't match or a projection fails
+     */
+    void groundToImage(std::span<const csm::EcefCoordCovar> groundPts,
+                       std::span<csm::ImageCoordCovar> imagePts,
+                       size_t numThreads = 1) const;
+
+    /**
+     * Converts many image points to ground space at once.  Gives the same
+     * results as calling imageToGround() on each point, split across
+     * threads.
+     *
+     * \param[in] imagePts Image lines and samples in pixels
+     * \param[in] height Height in meters measured with respect to the
+     *     WGS-84 ellipsoid
+     * \param[out] groundPts Ground coordinates in meters.  Must be the same
+     *     size as imagePts.
+     * \param[in] numThreads Number of threads to use
+     *
+     * \throws csm::Error if the sizes don't match or a projection fails
+     */
+    void imageToGround(std::span<const csm::ImageCoord> imagePts,
+                       double height,
+                       std::span<csm::EcefCoord> groundPts,
+                       size_t numThreads = 1) const;
+
+    /**
+     * Same as above but also propagates each image point's covariance.
+     * This is considerably more expensive than the overloading above, so
+     * only use it if the covariances are needed.
+     *
+     * \param[in] imagePts Image lines and samples in pixels and
+     *     covariances in pixels squared
+     * \param[in] height Height in meters measured with respect to the
+     *     WGS-84 ellipsoid
+     * \param[in] heightVariance Height variance in meters
+     * \param[out] groundPts Ground coordinates with covariances.  Must be
+     *     the same size as imagePts.
+     * \param[in] numThreads Number of threads to use
+     *
+     * \throws csm::Error if the sizes don't match or a projection fails
+     */
+    void imageToGround(std::span<const csm::ImageCoordCovar> imagePts,
+                       double height,
+                       double heightVariance,
+                       std::span<csm::EcefCoordCovar> groundPts,
+                       size_t numThreads = 1) const;
+
+    /**
+     * Checks that the ground and image point spans passed to one of the
+     * batch methods are the same size.  Shared with SIXPlugin's batch
+     * methods for non-SIX models.
+     *
+     * \param[in] numGroundPts Number of ground points
+     * \param[in] numImagePts Number of image points
+     * \param[in] function Name of the calling function, for the error
+     *
+     * \throws csm::Error with INVALID_USE if the sizes don't match
+     */
+    static
+    void checkBatchSizes(size_t numGroundPts, size_t numImagePts,
+                         const std::string& function);
+
+
 public:
     // All remaining public methods throw csm::Error's that they're not
     // implemented
@@ -646,6 +739,22 @@ protected:
                                       double desiredPrecision,
                                       double* achievedPrecision) const;
 
+    csm::EcefCoord imageToGroundImpl(const csm::ImageCoord& imagePt,
+                                     double height) const;
+
+    // The covariance computations for the groundToImage() and
+    // imageToGround() overloadings, given the already projected point.
+    // These throw except::Exception's so they can be used from worker
+    // threads.
+    csm::ImageCoordCovar groundToImageCovar(
+            const csm::EcefCoordCovar& groundPt,
+            const csm::ImageCoord& imagePt) const;
+
+    csm::EcefCoordCovar imageToGroundCovar(const csm::ImageCoordCovar& imagePt,
+                                           const csm::EcefCoord& groundPt,
+                                           double height,
+                                           double heightVariance) const;
+
     static
     scene::Vector3 toVector3(const csm::EcefCoord& pt)
     {
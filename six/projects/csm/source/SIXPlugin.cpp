@@ -283,5 +283,94 @@ std::string SIXPlugin::convertISDToModelState(
             model(constructModelFromISD(imageSupportData, modelName, warnings));
     return model->getModelState();
 }
+
+void SIXPlugin::groundToImage(const csm::RasterGM& model,
+                              std::span<const csm::EcefCoord> groundPts,
+                              std::span<csm::ImageCoord> imagePts,
+                              size_t numThreads)
+{
+    const SIXSensorModel* const sixModel =
+            dynamic_cast<const SIXSensorModel*>(&model);
+    if (sixModel)
+    {
+        sixModel->groundToImage(groundPts, imagePts, numThreads);
+        return;
+    }
+
+    SIXSensorModel::checkBatchSizes(groundPts.size(), imagePts.size(),
+                                    "SIXPlugin::groundToImage");
+    for (size_t ii = 0; ii < groundPts.size(); ++ii)
+    {
+        imagePts[ii] = model.groundToImage(groundPts[ii]);
+    }
+}
+
+void SIXPlugin::groundToImage(const csm::RasterGM& model,
+                              std::span<const csm::EcefCoordCovar> groundPts,
+                              std::span<csm::ImageCoordCovar> imagePts,
+                              size_t numThreads)
+{
+    const SIXSensorModel* const sixModel =
+            dynamic_cast<const SIXSensorModel*>(&model);
+    if (sixModel)
+    {
+        sixModel->groundToImage(groundPts, imagePts, numThreads);
+        return;
+    }
+
+    SIXSensorModel::checkBatchSizes(groundPts.size(), imagePts.size(),
+                                    "SIXPlugin::groundToImage");
+    for (size_t ii = 0; ii < groundPts.size(); ++ii)
+    {
+        imagePts[ii] = model.groundToImage(groundPts[ii]);
+    }
+}
+
+void SIXPlugin::imageToGround(const csm::RasterGM& model,
+                              std::span<const csm::ImageCoord> imagePts,
+                              double height,
+                              std::span<csm::EcefCoord> groundPts,
+                              size_t numThreads)
+{
+    const SIXSensorModel* const sixModel =
+            dynamic_cast<const SIXSensorModel*>(&model);
+    if (sixModel)
+    {
+        sixModel->imageToGround(imagePts, height, groundPts, numThreads);
+        return;
+    }
+
+    SIXSensorModel::checkBatchSizes(groundPts.size(), imagePts.size(),
+                                    "SIXPlugin::imageToGround");
+    for (size_t ii = 0; ii < imagePts.size(); ++ii)
+    {
+        groundPts[ii] = model.imageToGround(imagePts[ii], height);
+    }
+}
+
+void SIXPlugin::imageToGround(const csm::RasterGM& model,
+                              std::span<const csm::ImageCoordCovar> imagePts,
+                              double height,
+                              double heightVariance,
+                              std::span<csm::EcefCoordCovar> groundPts,
+                              size_t numThreads)
+{
+    const SIXSensorModel* const sixModel =
+            dynamic_cast<const SIXSensorModel*>(&model);
+    if (sixModel)
+    {
+        sixModel->imageToGround(imagePts, height, heightVariance, groundPts,
+                                numThreads);
+        return;
+    }
+
+    SIXSensorModel::checkBatchSizes(groundPts.size(), imagePts.size(),
+                                    "SIXPlugin::imageToGround");
+    for (size_t ii = 0; ii < imagePts.size(); ++ii)
+    {
+        groundPts[ii] = model.imageToGround(imagePts[ii], height,
+                                            heightVariance);
+    }
+}
 }
 }
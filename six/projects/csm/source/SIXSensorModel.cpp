@@ -30,6 +30,7 @@
 #include <six/NITFReadControl.h>
 #include <six/csm/SIXSensorModel.h>
 #include <six/ErrorStatistics.h>
+#include <mt/Runnable1D.h>
 
 #undef min
 #undef max
@@ -686,41 +687,7 @@ csm::ImageCoordCovar SIXSensorModel::groundToImage(
         const csm::ImageCoord imagePt = groundToImageImpl(groundPt,
                                                           desiredPrecision,
                                                           achievedPrecision);
-        const scene::Vector3 scenePt(toVector3(groundPt));
-        types::RowCol<double> pixelPt(fromPixel(imagePt));
-        // m^2
-        // NOTE: See mSensorCovariance member variable definition in header
-        //       for why we're not computing the sensor covariance for this
-        //       point
-        const math::linear::MatrixMxN<3, 3> userCovar(groundPt.covariance);
-        const math::linear::MatrixMxN<2, 7> sensorPartials =
-                mProjection->sceneToImageSensorPartials(scenePt);
-        const math::linear::MatrixMxN<2, 3> imagePartials =
-                mProjection->sceneToImagePartials(scenePt);
-        const math::linear::MatrixMxN<2, 2> unmodeledCovar =
-                mProjection->getUnmodeledErrorCovariance(pixelPt);
-        const math::linear::MatrixMxN<2, 2> errorCovar =
-                unmodeledCovar +
-                (imagePartials * userCovar * imagePartials.transpose()) +
-                (sensorPartials * mSensorCovariance *
-                 sensorPartials.transpose());
-        csm::ImageCoordCovar csmErrorCovar;
-        types::RowCol<double> ss = getSampleSpacing();
-        csmErrorCovar.line = imagePt.line;
-        csmErrorCovar.samp = imagePt.samp;
-        csmErrorCovar.covariance[0] =
-                errorCovar[0][0] / (ss.row * ss.row);
-        csmErrorCovar.covariance[1] =
-                errorCovar[0][1] /
-                (ss.row *
-                 ss.col);
-        csmErrorCovar.covariance[2] =
-                errorCovar[1][0] /
-                (ss.row *
-                 ss.col);
-        csmErrorCovar.covariance[3] =
-                errorCovar[1][1] / (ss.col * ss.col);
-        return csmErrorCovar;
+        return groundToImageCovar(groundPt, imagePt);
     }
     catch (const except::Exception& ex)
     {
@@ -730,6 +697,47 @@ csm::ImageCoordCovar SIXSensorModel::groundToImage(
     }
 }
 
+csm::ImageCoordCovar SIXSensorModel::groundToImageCovar(
+        const csm::EcefCoordCovar& groundPt,
+        const csm::ImageCoord& imagePt) const
+{
+    const scene::Vector3 scenePt(toVector3(groundPt));
+    types::RowCol<double> pixelPt(fromPixel(imagePt));
+    // m^2
+    // NOTE: See mSensorCovariance member variable definition in header
+    //       for why we're not computing the sensor covariance for this
+    //       point
+    const math::linear::MatrixMxN<3, 3> userCovar(groundPt.covariance);
+    const math::linear::MatrixMxN<2, 7> sensorPartials =
+            mProjection->sceneToImageSensorPartials(scenePt);
+    const math::linear::MatrixMxN<2, 3> imagePartials =
+            mProjection->sceneToImagePartials(scenePt);
+    const math::linear::MatrixMxN<2, 2> unmodeledCovar =
+            mProjection->getUnmodeledErrorCovariance(pixelPt);
+    const math::linear::MatrixMxN<2, 2> errorCovar =
+            unmodeledCovar +
+            (imagePartials * userCovar * imagePartials.transpose()) +
+            (sensorPartials * mSensorCovariance *
+             sensorPartials.transpose());
+    csm::ImageCoordCovar csmErrorCovar;
+    types::RowCol<double> ss = getSampleSpacing();
+    csmErrorCovar.line = imagePt.line;
+    csmErrorCovar.samp = imagePt.samp;
+    csmErrorCovar.covariance[0] =
+            errorCovar[0][0] / (ss.row * ss.row);
+    csmErrorCovar.covariance[1] =
+            errorCovar[0][1] /
+            (ss.row *
+             ss.col);
+    csmErrorCovar.covariance[2] =
+            errorCovar[1][0] /
+            (ss.row *
+             ss.col);
+    csmErrorCovar.covariance[3] =
+            errorCovar[1][1] / (ss.col * ss.col);
+    return csmErrorCovar;
+}
+
 csm::EcefCoord SIXSensorModel::imageToGround(
         const csm::ImageCoord& imagePt,
         double height,
@@ -739,21 +747,14 @@ csm::EcefCoord SIXSensorModel::imageToGround(
 {
     try
     {
-        const types::RowCol<double> imagePtMeters = fromPixel(imagePt);
-
-        // TODO: imageToScene() supports specifying a height threshold in
-        //       meters but it's not obvious how to convert that to a desired
-        //       precision in pixels.  Likewise, not clear how to determine
-        //       the achieved precision in pixels afterwards.
-        const scene::Vector3 groundPt =
-                mProjection->imageToScene(imagePtMeters, height);
+        const csm::EcefCoord groundPt = imageToGroundImpl(imagePt, height);
 
         if (achievedPrecision)
         {
             *achievedPrecision = desiredPrecision;
         }
 
-        return toEcefCoord(groundPt);
+        return groundPt;
     }
     catch (const except::Exception& ex)
     {
@@ -763,6 +764,19 @@ csm::EcefCoord SIXSensorModel::imageToGround(
     }
 }
 
+csm::EcefCoord SIXSensorModel::imageToGroundImpl(
+        const csm::ImageCoord& imagePt,
+        double height) const
+{
+    const types::RowCol<double> imagePtMeters = fromPixel(imagePt);
+
+    // TODO: imageToScene() supports specifying a height threshold in
+    //       meters but it's not obvious how to convert that to a desired
+    //       precision in pixels.  Likewise, not clear how to determine
+    //       the achieved precision in pixels afterwards.
+    return toEcefCoord(mProjection->imageToScene(imagePtMeters, height));
+}
+
 csm::EcefCoordCovar SIXSensorModel::imageToGround(
         const csm::ImageCoordCovar& imagePt,
         double height,
@@ -771,84 +785,208 @@ csm::EcefCoordCovar SIXSensorModel::imageToGround(
         double* achievedPrecision,
         csm::WarningList* warnings) const
 {
+    const csm::EcefCoord groundPt = imageToGround(imagePt,
+                                                  height,
+                                                  desiredPrecision,
+                                                  achievedPrecision,
+                                                  warnings);
     try
     {
-        const csm::EcefCoord groundPt = imageToGround(imagePt,
-                                                      height,
-                                                      desiredPrecision,
-                                                      achievedPrecision,
-                                                      warnings);
-
-        const double a = scene::WGS84EllipsoidModel::EQUATORIAL_RADIUS_METERS;
-        const double b = scene::WGS84EllipsoidModel::POLAR_RADIUS_METERS;
-        const scene::Vector3 scenePt(toVector3(groundPt));
-        types::RowCol<double> pixelPt(fromPixel((csm::ImageCoord&) imagePt));
-
-        // NOTE: See mSensorCovariance member variable definition in header
-        //       for why we're not computing the sensor covariance for this
-        //       point
-        const math::linear::MatrixMxN<2, 2> userCovar(imagePt.covariance);
-        math::linear::MatrixMxN<2, 2> unmodeledCovar =
-                mProjection->getUnmodeledErrorCovariance(pixelPt);
-        math::linear::MatrixMxN<2, 3> groundPartials =
-                mProjection->sceneToImagePartials(scenePt);
-        math::linear::MatrixMxN<2, 7> sensorPartials =
-                mProjection->sceneToImageSensorPartials(scenePt);
-
-        math::linear::MatrixMxN<10, 10> fullCovar(0.0);
-        unmodeledCovar = unmodeledCovar + userCovar;
-        fullCovar.addInPlace(unmodeledCovar, 0, 0);
-        fullCovar[2][2] = heightVariance;
-        fullCovar.addInPlace(mSensorCovariance, 3, 3);
-        types::RowCol<double> ss = getSampleSpacing();
-        for (size_t ii = 0; ii < 3; ++ii)
+        return imageToGroundCovar(imagePt, groundPt, height, heightVariance);
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::imageToGround");
+    }
+}
+
+csm::EcefCoordCovar SIXSensorModel::imageToGroundCovar(
+        const csm::ImageCoordCovar& imagePt,
+        const csm::EcefCoord& groundPt,
+        double height,
+        double heightVariance) const
+{
+    const double a = scene::WGS84EllipsoidModel::EQUATORIAL_RADIUS_METERS;
+    const double b = scene::WGS84EllipsoidModel::POLAR_RADIUS_METERS;
+    const scene::Vector3 scenePt(toVector3(groundPt));
+    types::RowCol<double> pixelPt(fromPixel(imagePt));
+
+    // NOTE: See mSensorCovariance member variable definition in header
+    //       for why we're not computing the sensor covariance for this
+    //       point
+    const math::linear::MatrixMxN<2, 2> userCovar(imagePt.covariance);
+    math::linear::MatrixMxN<2, 2> unmodeledCovar =
+            mProjection->getUnmodeledErrorCovariance(pixelPt);
+    math::linear::MatrixMxN<2, 3> groundPartials =
+            mProjection->sceneToImagePartials(scenePt);
+    math::linear::MatrixMxN<2, 7> sensorPartials =
+            mProjection->sceneToImageSensorPartials(scenePt);
+
+    math::linear::MatrixMxN<10, 10> fullCovar(0.0);
+    unmodeledCovar = unmodeledCovar + userCovar;
+    fullCovar.addInPlace(unmodeledCovar, 0, 0);
+    fullCovar[2][2] = heightVariance;
+    fullCovar.addInPlace(mSensorCovariance, 3, 3);
+    types::RowCol<double> ss = getSampleSpacing();
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        groundPartials[0][ii] /= ss.row;
+        groundPartials[1][ii] /= ss.col;
+    }
+
+    for (size_t ii = 0; ii < 7; ++ii)
+    {
+        sensorPartials[0][ii] /= ss.row;
+        sensorPartials[1][ii] /= ss.col;
+    }
+
+    math::linear::MatrixMxN<3, 3> B(0.0);
+    B.addInPlace(groundPartials, 0, 0);
+    B[2][0] = 2 * groundPt.x / square(a + height);
+    B[2][1] = 2 * groundPt.y / square(a + height);
+    B[2][2] = 2 * groundPt.z / square(b + height);
+
+    math::linear::MatrixMxN<3, 10> A(0.0);
+    A[2][2] = -2.0 * ((square(groundPt.x) + square(groundPt.y)) /
+                      cube(a + height) +
+              square(groundPt.z) / cube(b + height));
+    A.addInPlace(sensorPartials, 0, 3);
+    A[0][0] = A[1][1] = 1.0;
+
+    const math::linear::MatrixMxN<3, 3> Q = A * fullCovar * A.transpose();
+
+    const math::linear::MatrixMxN<3, 3> Qinv = inverse(Q);
+
+    const math::linear::MatrixMxN<3, 3> imageToGroundCovarInv =
+            B.transpose() * Qinv * B;
+
+    const math::linear::MatrixMxN<3, 3> errorCovar =
+            inverse(imageToGroundCovarInv);
+
+    csm::EcefCoordCovar csmErrorCovar;
+    csmErrorCovar.x = groundPt.x;
+    csmErrorCovar.y = groundPt.y;
+    csmErrorCovar.z = groundPt.z;
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        for (size_t jj = 0; jj < 3; ++jj)
         {
-            groundPartials[0][ii] /= ss.row;
-            groundPartials[1][ii] /= ss.col;
+            csmErrorCovar.covariance[ii * 3 + jj] = errorCovar[ii][jj];
         }
+    }
 
-        for (size_t ii = 0; ii < 7; ++ii)
+    return csmErrorCovar;
+}
+
+void SIXSensorModel::groundToImage(std::span<const csm::EcefCoord> groundPts,
+                                   std::span<csm::ImageCoord> imagePts,
+                                   size_t numThreads) const
+{
+    checkBatchSizes(groundPts.size(), imagePts.size(),
+                    "SIXSensorModel::groundToImage");
+
+    try
+    {
+        std::vector<scene::Vector3> scenePts(groundPts.size());
+        for (size_t ii = 0; ii < groundPts.size(); ++ii)
         {
-            sensorPartials[0][ii] /= ss.row;
-            sensorPartials[1][ii] /= ss.col;
+            scenePts[ii] = toVector3(groundPts[ii]);
         }
 
-        math::linear::MatrixMxN<3, 3> B(0.0);
-        B.addInPlace(groundPartials, 0, 0);
-        B[2][0] = 2 * groundPt.x / square(a + height);
-        B[2][1] = 2 * groundPt.y / square(a + height);
-        B[2][2] = 2 * groundPt.z / square(b + height);
+        std::vector<types::RowCol<double> > imageGridPts(scenePts.size());
+        mProjection->sceneToImage(
+                std::span<const scene::Vector3>(scenePts.data(),
+                                                scenePts.size()),
+                std::span<types::RowCol<double> >(imageGridPts.data(),
+                                                  imageGridPts.size()),
+                std::span<double>(),
+                numThreads);
 
-        math::linear::MatrixMxN<3, 10> A(0.0);
-        A[2][2] = -2.0 * ((square(groundPt.x) + square(groundPt.y)) /
-                          cube(a + height) +
-                  square(groundPt.z) / cube(b + height));
-        A.addInPlace(sensorPartials, 0, 3);
-        A[0][0] = A[1][1] = 1.0;
-
-        const math::linear::MatrixMxN<3, 3> Q = A * fullCovar * A.transpose();
+        for (size_t ii = 0; ii < imageGridPts.size(); ++ii)
+        {
+            imagePts[ii] = toImageCoord(toPixel(imageGridPts[ii]));
+        }
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::groundToImage");
+    }
+}
 
-        const math::linear::MatrixMxN<3, 3> Qinv = inverse(Q);
+void SIXSensorModel::groundToImage(
+        std::span<const csm::EcefCoordCovar> groundPts,
+        std::span<csm::ImageCoordCovar> imagePts,
+        size_t numThreads) const
+{
+    checkBatchSizes(groundPts.size(), imagePts.size(),
+                    "SIXSensorModel::groundToImage");
 
-        const math::linear::MatrixMxN<3, 3> imageToGroundCovarInv =
-                B.transpose() * Qinv * B;
+    try
+    {
+        const auto op = [&](size_t ii)
+        {
+            const csm::ImageCoord imagePt =
+                    groundToImageImpl(groundPts[ii], 0.0, nullptr);
+            imagePts[ii] = groundToImageCovar(groundPts[ii], imagePt);
+        };
+        mt::run1D(groundPts.size(), numThreads, op);
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::groundToImage");
+    }
+}
 
-        const math::linear::MatrixMxN<3, 3> errorCovar =
-                inverse(imageToGroundCovarInv);
+void SIXSensorModel::imageToGround(std::span<const csm::ImageCoord> imagePts,
+                                   double height,
+                                   std::span<csm::EcefCoord> groundPts,
+                                   size_t numThreads) const
+{
+    checkBatchSizes(groundPts.size(), imagePts.size(),
+                    "SIXSensorModel::imageToGround");
 
-        csm::EcefCoordCovar csmErrorCovar;
-        csmErrorCovar.x = groundPt.x;
-        csmErrorCovar.y = groundPt.y;
-        csmErrorCovar.z = groundPt.z;
-        for (size_t ii = 0; ii < 3; ++ii)
+    try
+    {
+        const auto op = [&](size_t ii)
         {
-            for (size_t jj = 0; jj < 3; ++jj)
-            {
-                csmErrorCovar.covariance[ii * 3 + jj] = errorCovar[ii][jj];
-            }
-        }
+            groundPts[ii] = imageToGroundImpl(imagePts[ii], height);
+        };
+        mt::run1D(imagePts.size(), numThreads, op);
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::imageToGround");
+    }
+}
 
-        return csmErrorCovar;
+void SIXSensorModel::imageToGround(
+        std::span<const csm::ImageCoordCovar> imagePts,
+        double height,
+        double heightVariance,
+        std::span<csm::EcefCoordCovar> groundPts,
+        size_t numThreads) const
+{
+    checkBatchSizes(groundPts.size(), imagePts.size(),
+                    "SIXSensorModel::imageToGround");
+
+    try
+    {
+        const auto op = [&](size_t ii)
+        {
+            const csm::EcefCoord groundPt =
+                    imageToGroundImpl(imagePts[ii], height);
+            groundPts[ii] = imageToGroundCovar(imagePts[ii], groundPt,
+                                               height, heightVariance);
+        };
+        mt::run1D(imagePts.size(), numThreads, op);
     }
     catch (const except::Exception& ex)
     {
@@ -858,6 +996,19 @@ csm::EcefCoordCovar SIXSensorModel::imageToGround(
     }
 }
 
+void SIXSensorModel::checkBatchSizes(size_t numGroundPts,
+                                     size_t numImagePts,
+                                     const std::string& function)
+{
+    if (numGroundPts != numImagePts)
+    {
+        throw csm::Error(csm::Error::INVALID_USE,
+                         "Must have the same number of ground and image "
+                         "points",
+                         function);
+    }
+}
+
 csm::EcefLocus SIXSensorModel::imageToRemoteImagingLocus(
         const csm::ImageCoord& ,
         double ,
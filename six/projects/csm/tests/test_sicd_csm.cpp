@@ -19,8 +19,11 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include <std/filesystem>
 
@@ -30,12 +33,14 @@
 #include <six/Utilities.h>
 #include <six/sicd/ComplexXMLControl.h>
 #include <six/sicd/Utilities.h>
+#include <six/csm/SIXPlugin.h>
 #include "utilities.h"
 
 // CSM includes
 #include <RasterGM.h>
 #include <Plugin.h>
 #include <NitfIsd.h>
+#include <Error.h>
 
 namespace fs = std::filesystem;
 
@@ -97,6 +102,204 @@ private:
                 imageCoord.samp - offset);
     }
 
+    static double maxDifference(const csm::ImageCoord& lhs,
+                                const csm::ImageCoord& rhs)
+    {
+        return std::max(std::abs(lhs.line - rhs.line),
+                        std::abs(lhs.samp - rhs.samp));
+    }
+
+    static double maxDifference(const csm::EcefCoord& lhs,
+                                const csm::EcefCoord& rhs)
+    {
+        return std::max(std::abs(lhs.x - rhs.x),
+                        std::max(std::abs(lhs.y - rhs.y),
+                                 std::abs(lhs.z - rhs.z)));
+    }
+
+    static double maxDifference(const csm::ImageCoordCovar& lhs,
+                                const csm::ImageCoordCovar& rhs)
+    {
+        double diff = maxDifference(static_cast<const csm::ImageCoord&>(lhs),
+                                    static_cast<const csm::ImageCoord&>(rhs));
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            diff = std::max(diff, std::abs(lhs.covariance[ii] -
+                                           rhs.covariance[ii]));
+        }
+        return diff;
+    }
+
+    static double maxDifference(const csm::EcefCoordCovar& lhs,
+                                const csm::EcefCoordCovar& rhs)
+    {
+        double diff = maxDifference(static_cast<const csm::EcefCoord&>(lhs),
+                                    static_cast<const csm::EcefCoord&>(rhs));
+        for (size_t ii = 0; ii < 9; ++ii)
+        {
+            diff = std::max(diff, std::abs(lhs.covariance[ii] -
+                                           rhs.covariance[ii]));
+        }
+        return diff;
+    }
+
+    template <typename T>
+    static std::span<const T> inputSpan(const std::vector<T>& values)
+    {
+        return std::span<const T>(values.data(), values.size());
+    }
+
+    template <typename T>
+    static std::span<T> outputSpan(std::vector<T>& values)
+    {
+        return std::span<T>(values.data(), values.size());
+    }
+
+    template <typename T>
+    static bool checkBatch(const std::vector<T>& batch,
+                           const std::vector<T>& single,
+                           const std::string& name)
+    {
+        const double tolerance = 1e-6;
+        for (size_t ii = 0; ii < batch.size(); ++ii)
+        {
+            if (maxDifference(batch[ii], single[ii]) > tolerance)
+            {
+                std::cerr << "Batch " << name << " differs from single "
+                          << "point call at point " << ii << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename FunctionT>
+    static bool checkSizeMismatch(FunctionT function, const std::string& name)
+    {
+        try
+        {
+            function();
+        }
+        catch (const csm::Error& error)
+        {
+            if (error.getError() == csm::Error::INVALID_USE)
+            {
+                return true;
+            }
+        }
+        std::cerr << "Batch " << name << " didn't reject mismatched sizes\n";
+        return false;
+    }
+
+    // The SIXPlugin batch methods should give the same answers as calling
+    // the model one point at a time, however many threads they use
+    bool testBatch(const csm::RasterGM& model,
+                   const six::RowColInt& scpPixel, double height)
+    {
+        using six::CSM::SIXPlugin;
+
+        const double heightVariance = 4.0;
+        std::vector<csm::ImageCoord> imagePts;
+        std::vector<csm::ImageCoordCovar> imageCovarPts;
+        for (int row = -50; row <= 50; row += 25)
+        {
+            for (int col = -50; col <= 50; col += 25)
+            {
+                const double line = scpPixel.row + row + 0.5;
+                const double samp = scpPixel.col + col + 0.5;
+                imagePts.push_back(csm::ImageCoord(line, samp));
+                imageCovarPts.push_back(
+                        csm::ImageCoordCovar(line, samp, 1.0, 0.25, 2.0));
+            }
+        }
+
+        std::vector<csm::EcefCoord> groundPts;
+        std::vector<csm::EcefCoordCovar> groundCovarPts;
+        for (size_t ii = 0; ii < imagePts.size(); ++ii)
+        {
+            groundPts.push_back(model.imageToGround(imagePts[ii], height));
+            groundCovarPts.push_back(model.imageToGround(
+                    imageCovarPts[ii], height, heightVariance));
+        }
+
+        std::vector<csm::ImageCoord> projectedPts;
+        std::vector<csm::ImageCoordCovar> projectedCovarPts;
+        for (size_t ii = 0; ii < groundPts.size(); ++ii)
+        {
+            projectedPts.push_back(model.groundToImage(groundPts[ii]));
+            projectedCovarPts.push_back(
+                    model.groundToImage(groundCovarPts[ii]));
+        }
+
+        bool testPassed = true;
+        const size_t threadCounts[] = {1, 4};
+        for (size_t numThreads : threadCounts)
+        {
+            std::vector<csm::EcefCoord> batchGroundPts(imagePts.size());
+            SIXPlugin::imageToGround(model, inputSpan(imagePts), height,
+                                     outputSpan(batchGroundPts), numThreads);
+            testPassed = checkBatch(batchGroundPts, groundPts,
+                                    "imageToGround") && testPassed;
+
+            std::vector<csm::EcefCoordCovar> batchGroundCovarPts(
+                    imageCovarPts.size());
+            SIXPlugin::imageToGround(model, inputSpan(imageCovarPts), height,
+                                     heightVariance,
+                                     outputSpan(batchGroundCovarPts),
+                                     numThreads);
+            testPassed = checkBatch(batchGroundCovarPts, groundCovarPts,
+                                    "imageToGround with covariance") &&
+                    testPassed;
+
+            std::vector<csm::ImageCoord> batchImagePts(groundPts.size());
+            SIXPlugin::groundToImage(model, inputSpan(groundPts),
+                                     outputSpan(batchImagePts), numThreads);
+            testPassed = checkBatch(batchImagePts, projectedPts,
+                                    "groundToImage") && testPassed;
+
+            std::vector<csm::ImageCoordCovar> batchImageCovarPts(
+                    groundCovarPts.size());
+            SIXPlugin::groundToImage(model, inputSpan(groundCovarPts),
+                                     outputSpan(batchImageCovarPts),
+                                     numThreads);
+            testPassed = checkBatch(batchImageCovarPts, projectedCovarPts,
+                                    "groundToImage with covariance") &&
+                    testPassed;
+        }
+
+        // One output too few
+        std::vector<csm::EcefCoord> shortGroundPts(imagePts.size() - 1);
+        std::vector<csm::EcefCoordCovar> shortGroundCovarPts(
+                imageCovarPts.size() - 1);
+        std::vector<csm::ImageCoord> shortImagePts(groundPts.size() - 1);
+        std::vector<csm::ImageCoordCovar> shortImageCovarPts(
+                groundCovarPts.size() - 1);
+        testPassed = checkSizeMismatch([&]()
+                {
+                    SIXPlugin::imageToGround(model, inputSpan(imagePts),
+                                             height,
+                                             outputSpan(shortGroundPts));
+                }, "imageToGround") && testPassed;
+        testPassed = checkSizeMismatch([&]()
+                {
+                    SIXPlugin::imageToGround(model, inputSpan(imageCovarPts),
+                                             height, heightVariance,
+                                             outputSpan(shortGroundCovarPts));
+                }, "imageToGround with covariance") && testPassed;
+        testPassed = checkSizeMismatch([&]()
+                {
+                    SIXPlugin::groundToImage(model, inputSpan(groundPts),
+                                             outputSpan(shortImagePts));
+                }, "groundToImage") && testPassed;
+        testPassed = checkSizeMismatch([&]()
+                {
+                    SIXPlugin::groundToImage(model, inputSpan(groundCovarPts),
+                                             outputSpan(shortImageCovarPts));
+                }, "groundToImage with covariance") && testPassed;
+
+        return testPassed;
+    }
+
     bool testISD(const csm::Isd& isd)
     {
         bool testPassed = true;
@@ -177,6 +380,8 @@ private:
                     " away from scpPixel\n";
             testPassed = false;
         }
+
+        testPassed = testBatch(*model, scpPixel, height) && testPassed;
         return testPassed;
     }
 